@@ -61,6 +61,19 @@ extern "C" {
 #define TC_AES_BLOCK_SIZE (Nb*Nk)
 #define TC_AES_KEY_SIZE (Nb*Nk)
 
+/*
+ * TC_AES_TTABLE selects the AES encryption core:
+ *   1 -- (default) word-oriented rounds using a 1 KiB lookup table; several
+ *        times faster, but table lookups indexed by secret data can leak
+ *        through a data cache.
+ *   0 -- the byte-oriented implementation of FIPS 197, which uses only the
+ *        256-byte S-box.
+ * Both use the same key schedule.
+ */
+#ifndef TC_AES_TTABLE
+#define TC_AES_TTABLE 1
+#endif
+
 typedef struct tc_aes_key_sched_struct {
 	unsigned int words[Nb*(Nr+1)];
 } *TCAesKeySched_t;
@@ -93,6 +106,23 @@ int tc_aes128_set_encrypt_key(TCAesKeySched_t s, const uint8_t *k);
 int tc_aes_encrypt(uint8_t *out, const uint8_t *in, 
 		   const TCAesKeySched_t s);
 
+/**
+ *  @brief AES-128 Encryption of consecutive blocks
+ *  Encrypts nblocks 16-byte blocks of in buffer into out buffer under key
+ *              schedule s, checking the parameters once
+ *  @note Assumes s was initialized by aes_set_encrypt_key;
+ *              out and in point to nblocks * 16 byte buffers, which may be
+ *              the same buffer
+ *  @return  returns TC_CRYPTO_SUCCESS (1)
+ *           returns TC_CRYPTO_FAIL (0) if: out == NULL or in == NULL or s == NULL
+ *  @param out IN/OUT -- buffer to receive ciphertext blocks
+ *  @param in IN -- plaintext blocks to encrypt
+ *  @param nblocks IN -- number of blocks
+ *  @param s IN -- initialized AES key schedule
+ */
+int tc_aes_encrypt_blocks(uint8_t *out, const uint8_t *in,
+			  unsigned int nblocks, const TCAesKeySched_t s);
+
 /**
  *  @brief Set the AES-128 decryption key
  *  Uses key k to initialize s
@@ -85,6 +85,18 @@ extern "C" {
 #define uECC_RNG_MAX_TRIES 64
 #endif
 
+/*
+ * uECC_COMB_WIDTH selects how multiples of the generator are computed, for key
+ * generation, signing and the u1*G half of verification:
+ *   0 -- Montgomery ladder with co-Z coordinates (EccPoint_mult), no table.
+ *   5, 6, 7, 8 -- comb method with a table of 2^(w-1) precomputed points in
+ *        ecc_comb_table.c: 1, 2, 4 or 8 KiB of constant data. Wider combs do
+ *        fewer point doublings and additions.
+ */
+#ifndef uECC_COMB_WIDTH
+#define uECC_COMB_WIDTH 6
+#endif
+
 /* defining data types to store word and bit counts: */
 typedef int8_t wordcount_t;
 typedef int16_t bitcount_t;
@@ -303,6 +315,48 @@ void EccPoint_mult(uECC_word_t * result, const uECC_word_t * point,
 		   const uECC_word_t * scalar, const uECC_word_t * initial_Z,
 		   bitcount_t num_bits, uECC_Curve curve);
 
+#if uECC_COMB_WIDTH > 0
+/* Number of comb columns, so that uECC_COMB_WIDTH teeth span 256 bits: */
+#define uECC_COMB_COLUMNS ((256 + uECC_COMB_WIDTH - 1) / uECC_COMB_WIDTH)
+
+/* Precomputed points for the comb method, see ecc_comb_table.c: */
+extern const uECC_word_t
+uECC_secp256r1_comb[1 << (uECC_COMB_WIDTH - 1)][NUM_ECC_WORDS * 2];
+
+/*
+ * @brief Recodes a scalar into comb digits, in constant time. Digit i is odd,
+ * with its sign in bit 15, and stands for the point selected from the comb
+ * table times 2^i, so that scalar*G is the sum of all digits.
+ * @param digits OUT -- uECC_COMB_COLUMNS + 1 digits
+ * @param scalar IN -- scalar, 0 < scalar < curve->n
+ * @param curve IN -- elliptic curve
+ */
+void EccPoint_comb_recode(uint16_t *digits, const uECC_word_t *scalar,
+			  uECC_Curve curve);
+
+/*
+ * @brief Reads the affine point of a comb digit, in constant time: the whole
+ * table is read whatever the digit.
+ * @param point OUT -- point for the digit
+ * @param digit IN -- digit from EccPoint_comb_recode()
+ * @param curve IN -- elliptic curve
+ */
+void EccPoint_comb_select(uECC_word_t *point, uint16_t digit,
+			  uECC_Curve curve);
+
+/*
+ * @brief Fixed-base point multiplication scalar*G with the comb method. The
+ * sequence of operations and memory accesses does not depend on the scalar,
+ * and the projective coordinates are randomized when an RNG is set.
+ * @param result OUT -- scalar*G, or the point at infinity (0, 0) if an
+ * exceptional addition was met
+ * @param scalar IN -- scalar, 0 < scalar < curve->n
+ * @param curve IN -- elliptic curve
+ */
+void EccPoint_mult_base(uECC_word_t *result, const uECC_word_t *scalar,
+			uECC_Curve curve);
+#endif
+
 /*
  * @brief Constant-time comparison to zero - secure way to compare long integers
  * @param vli IN -- very long integer
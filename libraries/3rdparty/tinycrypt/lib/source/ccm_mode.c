@@ -58,6 +58,14 @@ int tc_ccm_config(TCCcmMode_t c, TCAesKeySched_t sched, uint8_t *nonce,
 	return TC_CRYPTO_SUCCESS;
 }
 
+/*
+ * Number of counter blocks encrypted in one call to tc_aes_encrypt_blocks by
+ * ccm_ctr_mode; the keystream buffer takes 16 bytes of stack per block.
+ */
+#ifndef TC_CCM_BATCH_BLOCKS
+#define TC_CCM_BATCH_BLOCKS 4
+#endif
+
 /**
  * Variation of CBC-MAC mode used in CCM.
  */
@@ -66,20 +74,28 @@ static void ccm_cbc_mac(uint8_t *T, const uint8_t *data, unsigned int dlen,
 {
 
 	unsigned int i;
+	unsigned int len;
 
 	if (flag > 0) {
 		T[0] ^= (uint8_t)(dlen >> 8);
 		T[1] ^= (uint8_t)(dlen);
-		dlen += 2; i = 2;
+		i = 2;
 	} else {
 		i = 0;
 	}
 
-	while (i < dlen) {
-		T[i++ % (Nb * Nk)] ^= *data++;
-		if (((i % (Nb * Nk)) == 0) || dlen == i) {
-			(void) tc_aes_encrypt(T, T, sched);
+	/* xor a block of data at a time into T, padding the last one with 0 */
+	while (dlen > 0) {
+		len = Nb * Nk - i;
+		if (len > dlen) {
+			len = dlen;
 		}
+		dlen -= len;
+		while (len-- > 0) {
+			T[i++] ^= *data++;
+		}
+		(void) tc_aes_encrypt(T, T, sched);
+		i = 0;
 	}
 }
 
@@ -94,9 +110,11 @@ static int ccm_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 			unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched)
 {
 
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	uint8_t buffer[TC_CCM_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
 	uint8_t nonce[TC_AES_BLOCK_SIZE];
 	uint16_t block_num;
+	unsigned int nblocks;
+	unsigned int len;
 	unsigned int i;
 
 	/* input sanity check: */
@@ -115,22 +133,38 @@ static int ccm_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 
 	/* select the last 2 bytes of the nonce to be incremented */
 	block_num = (uint16_t) ((nonce[14] << 8)|(nonce[15]));
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
+	while (inlen > 0) {
+		/* lay out the counter blocks of the next keystream bytes */
+		len = (inlen < sizeof(buffer)) ? inlen : sizeof(buffer);
+		nblocks = (len + TC_AES_BLOCK_SIZE - 1) / TC_AES_BLOCK_SIZE;
+		for (i = 0; i < nblocks; ++i) {
 			block_num++;
 			nonce[14] = (uint8_t)(block_num >> 8);
 			nonce[15] = (uint8_t)(block_num);
-			if (!tc_aes_encrypt(buffer, nonce, sched)) {
-				return TC_CRYPTO_FAIL;
-			}
+			(void) _copy(&buffer[i * TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE,
+				     nonce, sizeof(nonce));
 		}
+
+		/* encrypt them in place */
+		if (!tc_aes_encrypt_blocks(buffer, buffer, nblocks, sched)) {
+			return TC_CRYPTO_FAIL;
+		}
+
 		/* update the output */
-		*out++ = buffer[i % (TC_AES_BLOCK_SIZE)] ^ *in++;
+		for (i = 0; i < len; ++i) {
+			out[i] = buffer[i] ^ in[i];
+		}
+		out += len;
+		in += len;
+		inlen -= len;
 	}
 
 	/* update the counter */
 	ctr[14] = nonce[14]; ctr[15] = nonce[15];
 
+	/* zeroing out the keystream buffer */
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+
 	return TC_CRYPTO_SUCCESS;
 }
 
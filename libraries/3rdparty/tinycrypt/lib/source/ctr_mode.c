@@ -34,13 +34,23 @@
 #include <tinycrypt/ctr_mode.h>
 #include <tinycrypt/utils.h>
 
+/*
+ * Number of counter blocks encrypted in one call to tc_aes_encrypt_blocks;
+ * the keystream buffer takes 16 bytes of stack per block.
+ */
+#ifndef TC_CTR_BATCH_BLOCKS
+#define TC_CTR_BATCH_BLOCKS 4
+#endif
+
 int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 		unsigned int inlen, uint8_t *ctr, const TCAesKeySched_t sched)
 {
 
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
+	uint8_t buffer[TC_CTR_BATCH_BLOCKS * TC_AES_BLOCK_SIZE];
 	uint8_t nonce[TC_AES_BLOCK_SIZE];
 	unsigned int block_num;
+	unsigned int nblocks;
+	unsigned int len;
 	unsigned int i;
 
 	/* input sanity check: */
@@ -60,26 +70,40 @@ int tc_ctr_mode(uint8_t *out, unsigned int outlen, const uint8_t *in,
 	/* select the last 4 bytes of the nonce to be incremented */
 	block_num = (nonce[12] << 24) | (nonce[13] << 16) |
 		    (nonce[14] << 8) | (nonce[15]);
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
-			/* encrypt data using the current nonce */
-			if (tc_aes_encrypt(buffer, nonce, sched)) {
-				block_num++;
-				nonce[12] = (uint8_t)(block_num >> 24);
-				nonce[13] = (uint8_t)(block_num >> 16);
-				nonce[14] = (uint8_t)(block_num >> 8);
-				nonce[15] = (uint8_t)(block_num);
-			} else {
-				return TC_CRYPTO_FAIL;
-			}
+	while (inlen > 0) {
+		/* lay out the counter blocks of the next keystream bytes */
+		len = (inlen < sizeof(buffer)) ? inlen : sizeof(buffer);
+		nblocks = (len + TC_AES_BLOCK_SIZE - 1) / TC_AES_BLOCK_SIZE;
+		for (i = 0; i < nblocks; ++i) {
+			(void)_copy(&buffer[i * TC_AES_BLOCK_SIZE], TC_AES_BLOCK_SIZE,
+				    nonce, sizeof(nonce));
+			block_num++;
+			nonce[12] = (uint8_t)(block_num >> 24);
+			nonce[13] = (uint8_t)(block_num >> 16);
+			nonce[14] = (uint8_t)(block_num >> 8);
+			nonce[15] = (uint8_t)(block_num);
+		}
+
+		/* encrypt them in place */
+		if (!tc_aes_encrypt_blocks(buffer, buffer, nblocks, sched)) {
+			return TC_CRYPTO_FAIL;
 		}
+
 		/* update the output */
-		*out++ = buffer[i%(TC_AES_BLOCK_SIZE)] ^ *in++;
+		for (i = 0; i < len; ++i) {
+			out[i] = buffer[i] ^ in[i];
+		}
+		out += len;
+		in += len;
+		inlen -= len;
 	}
 
 	/* update the counter */
 	ctr[12] = nonce[12]; ctr[13] = nonce[13];
 	ctr[14] = nonce[14]; ctr[15] = nonce[15];
 
+	/* zeroing out the keystream buffer */
+	_set(buffer, TC_ZERO_BYTE, sizeof(buffer));
+
 	return TC_CRYPTO_SUCCESS;
 }
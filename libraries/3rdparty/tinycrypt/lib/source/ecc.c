@@ -788,11 +788,141 @@ uECC_word_t regularize_k(const uECC_word_t * const k, uECC_word_t *k0,
 	return carry;
 }
 
+#if uECC_COMB_WIDTH > 0
+
+#define COMB_SIGN 0x8000
+
+void EccPoint_comb_recode(uint16_t *digits, const uECC_word_t *scalar,
+			  uECC_Curve curve)
+{
+	uECC_word_t m[NUM_ECC_WORDS];
+	uECC_word_t even;
+	unsigned int i, j, bit;
+	uint16_t c, cc, adjust, sign;
+	wordcount_t num_words = curve->num_words;
+
+	/* The recoding needs an odd scalar: an even scalar k is replaced by n - k,
+	 * which is odd, and all digits are negated. */
+	even = !uECC_vli_testBit(scalar, 0);
+	uECC_vli_sub(m, curve->n, scalar, num_words);
+	for (i = 0; i < (unsigned int)num_words; ++i) {
+		m[i] = cond_set(m[i], scalar[i], even);
+	}
+
+	/* Bit j of digit i is bit i + j*d of the scalar: */
+	for (i = 0; i < uECC_COMB_COLUMNS; ++i) {
+		digits[i] = 0;
+		for (j = 0; j < uECC_COMB_WIDTH; ++j) {
+			bit = i + j * uECC_COMB_COLUMNS;
+			if (bit < (unsigned int)num_words * uECC_WORD_BITS) {
+				digits[i] |= (!!uECC_vli_testBit(m, bit)) << j;
+			}
+		}
+	}
+	digits[uECC_COMB_COLUMNS] = 0;
+
+	/* Make digits 1 to d odd, adding the carries from the previous digit. An
+	 * even digit gets the previous digit, which is odd, added to it, and the
+	 * previous digit is negated: 2^i * x + 2^(i-1) * y is
+	 * 2^i * (x + y) - 2^(i-1) * y. */
+	c = 0;
+	for (i = 1; i <= uECC_COMB_COLUMNS; ++i) {
+		cc = digits[i] & c;
+		digits[i] ^= c;
+		c = cc;
+
+		adjust = 1 - (digits[i] & 1);
+		c |= digits[i] & (digits[i - 1] * adjust);
+		digits[i] ^= digits[i - 1] * adjust;
+		digits[i - 1] |= adjust * COMB_SIGN;
+	}
+
+	sign = (uint16_t)(even * COMB_SIGN);
+	for (i = 0; i <= uECC_COMB_COLUMNS; ++i) {
+		digits[i] ^= sign;
+	}
+
+	uECC_vli_clear(m, num_words);
+}
+
+void EccPoint_comb_select(uECC_word_t *point, uint16_t digit,
+			  uECC_Curve curve)
+{
+	uECC_word_t y[NUM_ECC_WORDS];
+	uECC_word_t index = (digit & ~COMB_SIGN) >> 1;
+	uECC_word_t diff, mask;
+	wordcount_t num_words = curve->num_words;
+	unsigned int i, j;
+
+	uECC_vli_clear(point, num_words * 2);
+	for (i = 0; i < (1 << (uECC_COMB_WIDTH - 1)); ++i) {
+		/* mask is all ones for the entry of the digit, 0 otherwise: */
+		diff = i ^ index;
+		mask = ((diff | (0 - diff)) >> (uECC_WORD_BITS - 1)) - 1;
+		for (j = 0; j < (unsigned int)num_words * 2; ++j) {
+			point[j] = (point[j] & ~mask) |
+				   (uECC_secp256r1_comb[i][j] & mask);
+		}
+	}
+
+	/* Negative digits select -P = (x, p - y): */
+	uECC_vli_sub(y, curve->p, point + num_words, num_words);
+	mask = 0 - (uECC_word_t)(digit >> 15);
+	for (j = 0; j < (unsigned int)num_words; ++j) {
+		point[num_words + j] = (point[num_words + j] & ~mask) | (y[j] & mask);
+	}
+}
+
+void EccPoint_mult_base(uECC_word_t *result, const uECC_word_t *scalar,
+			uECC_Curve curve)
+{
+	uint16_t digits[uECC_COMB_COLUMNS + 1];
+	uECC_word_t tx[NUM_ECC_WORDS * 2];
+	uECC_word_t tz[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
+	wordcount_t num_words = curve->num_words;
+	unsigned int i;
+
+	EccPoint_comb_recode(digits, scalar, curve);
+
+	/* Start from the top digit, which is never zero, and randomize its
+	 * projective coordinates to blind the final inversion. */
+	EccPoint_comb_select(result, digits[uECC_COMB_COLUMNS], curve);
+	if (!uECC_generate_random_int(z, curve->p, num_words)) {
+		uECC_vli_clear(z, num_words);
+		z[0] = 1;
+	}
+	apply_z(result, result + num_words, z, curve);
+
+	for (i = uECC_COMB_COLUMNS; i > 0; --i) {
+		curve->double_jacobian(result, result + num_words, z, curve);
+
+		/* Co-Z addition of the affine point of the next digit: */
+		EccPoint_comb_select(tx, digits[i - 1], curve);
+		apply_z(tx, tx + num_words, z, curve);
+		uECC_vli_modSub(tz, result, tx, curve->p, num_words); /* Z = x2 - x1 */
+		XYcZ_add(tx, tx + num_words, result, result + num_words, curve);
+		uECC_vli_modMult_fast(z, z, tz, curve);
+	}
+
+	/* An exceptional addition (equal x) leaves z = 0, and (0, 0) here. */
+	uECC_vli_modInv(z, z, curve->p, num_words);
+	apply_z(result, result + num_words, z, curve);
+
+	/* erasing the digits, which reveal the scalar: */
+	memset(digits, 0, sizeof(digits));
+}
+
+#endif
+
 uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
 					uECC_word_t *private_key,
 					uECC_Curve curve)
 {
 
+#if uECC_COMB_WIDTH > 0
+	EccPoint_mult_base(result, private_key, curve);
+#else
 	uECC_word_t tmp1[NUM_ECC_WORDS];
  	uECC_word_t tmp2[NUM_ECC_WORDS];
 	uECC_word_t *p2[2] = {tmp1, tmp2};
@@ -803,6 +933,7 @@ uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
 	carry = regularize_k(private_key, tmp1, tmp2, curve);
 
 	EccPoint_mult(result, curve->G, p2[!carry], 0, curve->num_n_bits + 1, curve);
+#endif
 
 	if (EccPoint_isZero(result, curve)) {
 		return 0;
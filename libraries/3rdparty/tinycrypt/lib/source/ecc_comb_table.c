@@ -0,0 +1,1531 @@
+/* ecc_comb_table.c - TinyCrypt fixed-base comb table for the p-256 generator */
+
+/*
+ * Copyright (c) 2014, Kenneth MacKay
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Copyright (C) 2017 by Intel Corporation, All Rights Reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *    - Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *    - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ *    - Neither the name of Intel Corporation nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <tinycrypt/ecc.h>
+
+/*
+ * With uECC_COMB_WIDTH = w and d = uECC_COMB_COLUMNS, entry i is the affine
+ * point
+ *
+ *   G + i_0 * 2^d * G + i_1 * 2^(2d) * G + ... + i_(w-2) * 2^((w-1)d) * G
+ *
+ * where i_j is bit j of i, in the native word order of curve->G. The entries
+ * are the odd comb digits: digit 2i+1 selects entry i. Generated offline
+ * from the generator, affine addition and doubling over p.
+ */
+
+#if uECC_COMB_WIDTH == 5
+
+const uECC_word_t uECC_secp256r1_comb[16][NUM_ECC_WORDS * 2] = {
+	{
+		0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+		0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+		0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+		0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2
+	},
+	{
+		0x04bac870, 0xf7d24bb7, 0x3a23c6ab, 0x593a09a0,
+		0xf94c9d1d, 0xdfcc2358, 0x297bed02, 0x3cfa0f87,
+		0x40f26940, 0xce98a30b, 0x0248a8af, 0x62121c0d,
+		0x8309af9b, 0xa758aa80, 0x70be12c6, 0xe4e37694
+	},
+	{
+		0x86ef7d7d, 0xdd37e3ff, 0x088b86db, 0xf6d77c27,
+		0x254c5491, 0x28fe9a4f, 0x6df0fd5e, 0xd6690337,
+		0xaddad596, 0x9ff04992, 0x9e4373f9, 0xf3d1a7af,
+		0xdf074167, 0xa13e9578, 0xe6d13d22, 0x20e2a53c
+	},
+	{
+		0x525d6abf, 0xaebfd735, 0x96bea25a, 0xc302f8f4,
+		0x544920a4, 0xdb82b3ea, 0x02eadb2e, 0x621c75d1,
+		0x9ef485f0, 0x8939dc4c, 0x57c46d63, 0x225d03d8,
+		0x522d7f70, 0x4fdac96f, 0xb4fa649d, 0xd7c4a4fe
+	},
+	{
+		0xc0b9372a, 0x8bc659aa, 0xedd9583f, 0xf7659958,
+		0x8c267d88, 0x9f05f94a, 0xc99a739d, 0x00dc46e7,
+		0xdf55d0f2, 0x4af50a00, 0x8156bf6a, 0xb5eb202d,
+		0x5228c111, 0x40d1e3ab, 0x45793424, 0x0312a557
+	},
+	{
+		0x7eb8cfee, 0x8d9692f7, 0x0d8c013d, 0x05e3f223,
+		0x84e32e59, 0x76347a52, 0x15b0a1e5, 0x3c53e290,
+		0xfae798d4, 0x538b7da5, 0x00d23591, 0x1b9f1bd1,
+		0x9a08693f, 0x11a9f072, 0x140efeb3, 0xd30e7cda
+	},
+	{
+		0xf8e8f683, 0x6dfcf787, 0x3f7fbe90, 0x13d72b7a,
+		0x2df232cf, 0xfd426d94, 0x5fe39aad, 0xed84bb42,
+		0x732995fc, 0x023e67a1, 0x355430e3, 0x67dd0a8e,
+		0x97a1d703, 0x0cf83b61, 0x583c33f2, 0xa3233455
+	},
+	{
+		0x5f165d99, 0xcebbbc7b, 0x8a4eee61, 0x50cc51c1,
+		0x1b4d0d1f, 0xb31d2353, 0x66382ada, 0x95e18452,
+		0x0a839b5b, 0xacad4f81, 0x4142ff0f, 0xa0a2a96e,
+		0x1f4fa12f, 0x3eaa8289, 0x6b0fb8f3, 0x68d68c8f
+	},
+	{
+		0x51bbb3f1, 0x9311a269, 0x8d0f4f65, 0xe80f26bd,
+		0x6beccbb9, 0x9d3dc334, 0x101e5de4, 0x54e244d5,
+		0xf1b19e28, 0xb3ad4c6e, 0x58c2e3b7, 0x4334fbc0,
+		0x35df9c25, 0x19bd4107, 0xec106eb6, 0xd6bbec0e
+	},
+	{
+		0x3fefcfc8, 0xe8881a83, 0xb9b5290b, 0xaea3c9e0,
+		0x771e4688, 0x10b37ecd, 0xd4d021b6, 0xee0816a3,
+		0xb3a8caa1, 0x8e9929bf, 0xc105f2d1, 0x48915dcf,
+		0xdb49019f, 0x3a5fdf82, 0xad9006e1, 0xc4a438e3
+	},
+	{
+		0xe83ad2c9, 0x5d6dc503, 0xaed035be, 0xca9f7a1d,
+		0xcbd21e33, 0x552788ac, 0xe09cb9f0, 0x8699dd31,
+		0x329bf961, 0x38584196, 0xb82a5af9, 0x4cb20e96,
+		0xc72c78c1, 0x24199908, 0xe92859b7, 0x16e65484
+	},
+	{
+		0xdb3038dd, 0xa20a2c70, 0xe99d5c7c, 0x5f0b46d5,
+		0x4b600b83, 0xc9b97d37, 0x3df3245e, 0x186c7f79,
+		0x4f1ce57f, 0x2af72460, 0x91e2d8ed, 0x9249897f,
+		0x8d2ea797, 0x8139b36a, 0x9ab58913, 0x9c428db8
+	},
+	{
+		0x4be6458d, 0x1f1e4f3f, 0x595e6547, 0x5f72cc22,
+		0x271a93f1, 0x5bc5341e, 0x58a5f263, 0xc62e155c,
+		0x58ba7ff4, 0x5f6f845a, 0x7e36a6ad, 0x67e1f7dc,
+		0xeeaa4d04, 0xd33a7657, 0x18267e4e, 0xff9f2322
+	},
+	{
+		0xc7644c1d, 0xe33f0255, 0xbb9002d8, 0x4030ecc3,
+		0xf4646f9f, 0xa4486916, 0x959c44fa, 0x5e677d0c,
+		0xd88b9144, 0xe2e7d7d0, 0x6248f91f, 0x5d93a86f,
+		0x02993aea, 0xe33d0bd5, 0x3100d31e, 0x449f0ce6
+	},
+	{
+		0xfdaab256, 0x52df1588, 0x3127354c, 0x68c0cd44,
+		0xa591f853, 0x2a849471, 0x93d0cb92, 0xe4da88e9,
+		0x1639c624, 0x6d1ea35d, 0x263707ba, 0x60fe2a36,
+		0xd0f3bc51, 0x97fc50de, 0x10062e80, 0xf7fa4d15
+	},
+	{
+		0x5b696527, 0x2e75a266, 0x5a00169c, 0x1a2530b0,
+		0x4286fb42, 0x76c4c180, 0x8e831d5b, 0x825f0194,
+		0xef703739, 0xdbf0a11f, 0xce5b106a, 0x106f9bc4,
+		0x24111150, 0x61794c4f, 0xbc723a17, 0x435872fe
+	}
+};
+
+#elif uECC_COMB_WIDTH == 6
+
+const uECC_word_t uECC_secp256r1_comb[32][NUM_ECC_WORDS * 2] = {
+	{
+		0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+		0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+		0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+		0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2
+	},
+	{
+		0x5a1c3fb1, 0x59db167c, 0xbf318eb2, 0x98b3ce2a,
+		0xd2bc2fa6, 0x2df1c41e, 0x6ed1b2af, 0xefcc2c43,
+		0x97b25513, 0x17fe07f1, 0x3734a589, 0x46824533,
+		0xed34f543, 0xa5384a77, 0x8d9f3863, 0xf3684f9c
+	},
+	{
+		0x7318188e, 0xaec90264, 0xca167099, 0x410bec28,
+		0x099c202b, 0xbf664d2f, 0x55fa625c, 0x13ccca34,
+		0x05421c0c, 0xaa84c231, 0x6cdb0d71, 0x6b647521,
+		0xfb216a5e, 0xe90446b1, 0xaf46893d, 0x4b5ba5a5
+	},
+	{
+		0xcbdb1c78, 0xd3b22809, 0x30f6cda4, 0x5591c8eb,
+		0xbfe80f8b, 0xb6e28740, 0x40e7e7e7, 0x0f74342a,
+		0x351c51f2, 0xd2968e87, 0xf5e17b5e, 0x65c5c581,
+		0x9d994e2e, 0x6f58f02a, 0xf5c1ec07, 0x531c0b00
+	},
+	{
+		0x8b21aa51, 0x2b52c47d, 0x5a7e870d, 0x0f503629,
+		0x88b45127, 0xbaa92814, 0xc402e050, 0x27d6451e,
+		0x5567432d, 0x5c96ec14, 0x0f4150c7, 0xcdeb9829,
+		0xcdeef566, 0x5d91740c, 0x1be9e583, 0x2a58fa5e
+	},
+	{
+		0x2195a979, 0x73b7c550, 0xb8dd5813, 0x2d7ed474,
+		0xe104e9ac, 0xc0b9ecd2, 0xa2bd0ed8, 0xdc90d975,
+		0x4dd6eb2e, 0x9fb55203, 0xc01dfde8, 0x50d554bb,
+		0xf0977a30, 0x4cfd3277, 0x815374c4, 0xc87ce232
+	},
+	{
+		0x1703406d, 0xcb4dc35b, 0x75dac54c, 0x4fd3afc9,
+		0x29f02878, 0x112321eb, 0xad6b225f, 0xafb18d2f,
+		0xf1776a67, 0xddf58273, 0xf6b96c2f, 0x96889755,
+		0x22208ffb, 0x31a8d663, 0xfcca4877, 0x5ed81c10
+	},
+	{
+		0x336aaf40, 0x2dc61e1b, 0x4251f5b7, 0x897e87bd,
+		0x6511b370, 0x2fb32023, 0x2341f499, 0x460fa9cf,
+		0xcbaf01a7, 0x03e63b79, 0x44157434, 0x937e123f,
+		0x809e4a1a, 0x9d59226e, 0x41775e62, 0x18d6f63a
+	},
+	{
+		0x016476ea, 0xc6e4b6d0, 0xd4ec2510, 0x71b9a7e5,
+		0xcbe490d2, 0x1975b71e, 0xb52acd25, 0xdf6b472f,
+		0x784055eb, 0xf1738716, 0xb87d399e, 0xccc7b0b3,
+		0x1bb51119, 0x3c9a1337, 0xa88fd593, 0xb42639e1
+	},
+	{
+		0x20b4d697, 0x41e94206, 0x29fa0df9, 0xa10fd0d9,
+		0x76022c38, 0xf11eb0a7, 0xa5621c63, 0xffcb7ddc,
+		0x0927965a, 0x24e37b1b, 0xbd2c199e, 0x8d9fc102,
+		0x907f3f85, 0x862de75e, 0x5a9c778e, 0xd3985129
+	},
+	{
+		0xf119b8cc, 0x546a08e7, 0x8afc696a, 0x03b7d523,
+		0x459f70b4, 0x0a896132, 0xa86a9116, 0x57a46257,
+		0xbb314c65, 0xfaa56fef, 0x74795c6d, 0xf4e61f40,
+		0x437850d6, 0x1a3c5652, 0x6621ec11, 0x7c4b127d
+	},
+	{
+		0x56c8815e, 0xf41e0307, 0x7d37a2f1, 0xbaf647e3,
+		0xfefafbf5, 0x7791eb36, 0x35b7f606, 0x158262fb,
+		0x32dce9e5, 0xf6c32255, 0x361b4780, 0x6c7cd4ce,
+		0x3f85288f, 0xe5be5e70, 0xc98e624a, 0x4c281aa3
+	},
+	{
+		0x4d6a3def, 0x5b2911dd, 0xb96008f1, 0x4bedd07c,
+		0xe36e7d64, 0xee748a6f, 0x4bbf5cf4, 0xbfc49934,
+		0x8e74750f, 0x55c6f62d, 0x48919902, 0x22639f87,
+		0x958a248f, 0xfa01aa94, 0xed51aa40, 0x2743ae8a
+	},
+	{
+		0x86eb7815, 0x9cdda821, 0xce413265, 0x8c003612,
+		0x91b577f5, 0x8bce1fab, 0x488f730c, 0x0f3f29ff,
+		0xe6960d55, 0xebb08063, 0xaecbf467, 0x1a9699e2,
+		0x4ce5761b, 0x6b1564a4, 0x81382996, 0x08f00ea5
+	},
+	{
+		0x70514a21, 0x0d17ff39, 0xdadd80ee, 0xd2a7b5ba,
+		0x8126c8c4, 0x941e33c3, 0x1d57c1de, 0xb9e156d0,
+		0xea8105ad, 0x220d500d, 0x0202f3ae, 0x6a2aa462,
+		0x3dc96356, 0x450056ab, 0x452142c3, 0x506ab6aa
+	},
+	{
+		0xc05131cd, 0xf197735b, 0x22beb567, 0x05650768,
+		0xf7f55b1f, 0xdbf2b189, 0x132c2614, 0xaa144c82,
+		0xb3822251, 0xf41cbe14, 0xffd0afbe, 0xb1ce72b2,
+		0x844743fa, 0x01a14d18, 0x923739b8, 0xc1d89fe3
+	},
+	{
+		0x5f3f5b80, 0x12416a5c, 0xda522422, 0x58e903db,
+		0x4291867e, 0x18cc80f1, 0x7a152c2b, 0xb2035cf8,
+		0x95c80ede, 0x71125691, 0xaf97c5b0, 0xbfe02568,
+		0x8a14e493, 0x603e1dc5, 0x749680de, 0xf12f359c
+	},
+	{
+		0xfea77b0c, 0x40429d1b, 0x595e9a31, 0x4651a4dc,
+		0xe712693a, 0x8900aab1, 0x84bf612d, 0x90ea7767,
+		0x0d02f2b6, 0xbdd10425, 0xfb4d594f, 0xf5583bcc,
+		0x5ba7b6a1, 0x75754462, 0x101e86f4, 0xd1a321d3
+	},
+	{
+		0xe62da069, 0x6890b26c, 0x7c586265, 0xa5702319,
+		0x865672ab, 0xe64e19bf, 0xa07d9893, 0xa66503f5,
+		0x21fe4743, 0xe4deb7c0, 0x7d7100be, 0x3bae847d,
+		0xe17b1d29, 0x1769fca7, 0x320afc60, 0xadba60ec
+	},
+	{
+		0xc4e48158, 0xa3c9d614, 0xae8fc508, 0xb26b4a98,
+		0x38b68e18, 0x44ef8be0, 0xdb271fcd, 0xbe9cf596,
+		0x8e6f95ad, 0x737b653e, 0x9b9e4d0a, 0x73dbe6ff,
+		0xa4139f59, 0x4b772a8c, 0x66c67e8a, 0xa1f335e5
+	},
+	{
+		0xf77cf152, 0xc0b161fb, 0x8ce30043, 0x243c4fed,
+		0x050e20df, 0xb1b4a2d0, 0xc34999ae, 0x5a61a286,
+		0x70214eb7, 0x8c7baf68, 0xf2c261fe, 0x975bca7d,
+		0x1ed91ae8, 0x03c6df31, 0xa1380d38, 0xe8cfaaad
+	},
+	{
+		0x966d28dd, 0xc79e3178, 0x89f8a2c1, 0x67ba8686,
+		0x4acf8d42, 0xaf1f9c6d, 0xe0847f7d, 0x2d2b4273,
+		0x69130cec, 0x1d9e1a90, 0x9383e7b5, 0x95cb10fd,
+		0x44cc71ae, 0x73438a26, 0x1ee4ea49, 0x37eaeb10
+	},
+	{
+		0xd84a37de, 0x1c12b5cb, 0xc7b1ea1a, 0x56d66db4,
+		0x2ce31e9a, 0x852be420, 0xe40faf48, 0x17be9c2d,
+		0x38cc8797, 0x735b3ccb, 0x34b1093e, 0x1f8d9d80,
+		0xe75b81c0, 0xd8cc6e86, 0x3fdbe697, 0x6914bf94
+	},
+	{
+		0x00b16f35, 0x54b44d33, 0x002d5707, 0x59988ef3,
+		0xd0494f94, 0x256fe1eb, 0x7f710de4, 0xaef84169,
+		0x8bd49604, 0xca38fb1f, 0xbfa0b15c, 0xaec9daae,
+		0x642cf6dd, 0x1551365e, 0x160e8fff, 0x75b8b0fa
+	},
+	{
+		0xedab9cb9, 0x6033d113, 0xe69d45ee, 0x1df87ba3,
+		0xe4d65a03, 0x93436236, 0x3f98a508, 0x5893f6f9,
+		0xaad54fab, 0xb3832e15, 0x6bc7365e, 0x3277ff0d,
+		0x200c4fb8, 0xe8301118, 0xd4e9384d, 0x26e471bc
+	},
+	{
+		0xc52427d8, 0x3276c5a4, 0xf5a34b64, 0x66958243,
+		0xf36e0d92, 0x04166798, 0xc6e9e63f, 0x43e33927,
+		0xf0ca8d2b, 0x899aed76, 0x0af50dd8, 0x43b89cde,
+		0x5951e13b, 0x805ea21e, 0x28413043, 0xe210daa4
+	},
+	{
+		0x0758035b, 0xce46a165, 0xe070a0c9, 0xb33df1ad,
+		0x686934c9, 0xbf01fb38, 0xf0f16ed0, 0x1cba6257,
+		0xee93409c, 0xe538a9b6, 0x4a6b38da, 0xd82429a1,
+		0xa5c215b1, 0x1488770d, 0x891d7658, 0x4ade1f8e
+	},
+	{
+		0x27ade63f, 0xfe702b4b, 0xa105673a, 0x5df11a33,
+		0xa362b9ce, 0x0d33cb80, 0x855bb209, 0xa7bb42f5,
+		0xc95fe575, 0xfdcc6096, 0x2351dec6, 0xff0e08d7,
+		0xbb6a5b28, 0xa3323ff5, 0x89f7a2ab, 0x2caa2dae
+	},
+	{
+		0x2da7eb49, 0x2096d676, 0xfb775e41, 0x6e04768e,
+		0xaf24f76c, 0xc3349c3d, 0xde0c90f6, 0xe6db6cca,
+		0xa416fd87, 0x98aa01f5, 0x781ec427, 0x84c3270b,
+		0x021034b2, 0x37680f04, 0x654bf735, 0xeb90fe3c
+	},
+	{
+		0xb3571976, 0x8e35bf16, 0x346864e7, 0xe2eb0c63,
+		0x7e9b6c7f, 0x2b7b57e0, 0x70b35a98, 0x3157cf6f,
+		0x5ac49ea5, 0xfec24c14, 0x6b1a32ae, 0xc20c5690,
+		0x345fa335, 0xeaef7b4e, 0x4077475f, 0xb4c9655d
+	},
+	{
+		0xfcf866b9, 0xf3f4e3fe, 0xe18b0ad5, 0x152a0807,
+		0x1b9b2e7b, 0x2ec4c706, 0xdadd006f, 0x41d7e92b,
+		0x1d4b6ef7, 0xff0a8a79, 0xb2aa2f47, 0x02344dff,
+		0x357a0681, 0x1726d704, 0xc1bc85f4, 0x4ce6bb77
+	},
+	{
+		0xafcc2bef, 0xb9e437f4, 0x3ada2b53, 0x4f1fb2d6,
+		0xbb580c9a, 0xe6c0e12d, 0x33c7546d, 0x25183734,
+		0xbfd92fb9, 0xab12d90f, 0xa185ae46, 0x2cb9b9b3,
+		0x9ce6f49f, 0x2a0c7a7e, 0xb48f21f2, 0x531f307f
+	}
+};
+
+#elif uECC_COMB_WIDTH == 7
+
+const uECC_word_t uECC_secp256r1_comb[64][NUM_ECC_WORDS * 2] = {
+	{
+		0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+		0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+		0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+		0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2
+	},
+	{
+		0x66d4e2bc, 0x58bdfa8e, 0x9b1f858b, 0x8f77a569,
+		0xb6fb1070, 0xfeec5805, 0x9d64351f, 0x1cdf701e,
+		0x2783ba45, 0xba427042, 0xf7665b19, 0x54b09ce3,
+		0x8c656862, 0x0bca94aa, 0xc43c6b76, 0xc37d7f62
+	},
+	{
+		0x717a0611, 0x49f68919, 0x28f17701, 0x3976a296,
+		0x5df3cb83, 0x09cdeb9d, 0xcfb6448f, 0x183c55cc,
+		0x70efbce8, 0x1b6d1b3f, 0x167e6228, 0x79ff4484,
+		0xf6290b34, 0xfa41c36f, 0xe5b76b65, 0xeaef1249
+	},
+	{
+		0xa97ab1ec, 0xb41b1d2d, 0x83ceba2b, 0xb7917784,
+		0x8d2850de, 0x45fbec0d, 0x3a6376b1, 0x7a20b5fd,
+		0x685f8d97, 0xb2d21722, 0x22ee2184, 0xa073f8d6,
+		0x3f46a374, 0x97cc8951, 0x175fadad, 0x477f1d41
+	},
+	{
+		0xfc602827, 0x16305832, 0x55c1b372, 0x08e0b379,
+		0x2aa3a67b, 0x7dcb57f7, 0x4fb0f09a, 0x5ff1b63d,
+		0x1c854f7f, 0x370a4636, 0x2830f455, 0xd837f9a7,
+		0xa2d58ace, 0xaa0d33f2, 0xc490b3f0, 0x562e4757
+	},
+	{
+		0x79023d63, 0x8157fd7f, 0x056de78b, 0x7f9603bf,
+		0x214df921, 0x3790a889, 0x9a3a5a1a, 0xa20ccb8e,
+		0xf75787b1, 0x9beb594b, 0x86119c08, 0xdd806f4f,
+		0xd8071364, 0x6d3a51e8, 0x157a43aa, 0xfcaa5616
+	},
+	{
+		0x375c4aeb, 0x517cac57, 0x4ff16bd2, 0x352499bc,
+		0xb0d265e8, 0x2c1b1032, 0xf4174ea4, 0x2db3b36b,
+		0x3315c1a4, 0x626c820d, 0xf851dcc4, 0xc0e3ce26,
+		0x8e9ee4e8, 0x274f1dfc, 0xe6039e6e, 0x3030e74e
+	},
+	{
+		0x3488885f, 0xd7bb0d96, 0xd505f8f6, 0xbe034bef,
+		0x32acf6cc, 0x64cd8f6e, 0xab84b50f, 0x915f8e4c,
+		0x2dc91bd4, 0x0642ae38, 0xaa59ac9e, 0x966c989e,
+		0xfc41c571, 0x2d5eadc1, 0xef9d42cb, 0x43f8da79
+	},
+	{
+		0xca5e59ad, 0x276cb26d, 0x13041de1, 0xb688aafb,
+		0x143bcf73, 0x2f7d2235, 0x5977e774, 0xa91c7497,
+		0x2f9d1ac9, 0xf60def81, 0x86e16ee7, 0x0c67d5ea,
+		0x4730f8d1, 0x85dd2dd9, 0x3b61ef8a, 0xf59a5dd7
+	},
+	{
+		0x7595efcf, 0xacc48903, 0x6a99cfd4, 0x4a5b7171,
+		0xfedc0578, 0x85bbf7ed, 0xf5ec256b, 0x1db5d227,
+		0xffe44b30, 0x6ed1be54, 0x7c5e5a75, 0xb04d6820,
+		0x2aef51da, 0xa8fa90ca, 0x30239a66, 0x9f26c31d
+	},
+	{
+		0x80a1c3b9, 0xfbe83618, 0x1401c46d, 0x9f95b0ae,
+		0x4a76b0f7, 0x6c6a8cd0, 0x99159bdb, 0x5b246b29,
+		0x3aff0d3d, 0x6e68971a, 0xfbb6d2f9, 0x2b046407,
+		0x73ab7a26, 0xed8e3ff4, 0x9f05a12e, 0xb1cd0623
+	},
+	{
+		0x4440b2b4, 0x0f0d0ac3, 0xbc2466eb, 0x6e5babc4,
+		0x6e87ae5d, 0x75d997e5, 0xca353d97, 0x7b2a3707,
+		0xd2ef2f0d, 0x428039e7, 0xcc91e514, 0x48db0cf6,
+		0xa685b5f5, 0xe15faae7, 0xa42752cc, 0x71503b9e
+	},
+	{
+		0xfb261aa1, 0x2c69afa5, 0xd0c7a52c, 0xead7ebfe,
+		0xb646aa17, 0x3daa5f8c, 0x57a729fe, 0xd1f26b51,
+		0x4f4a595f, 0x2a8c2a34, 0x9369f6b9, 0x85c3e8ce,
+		0xd4c3b33d, 0x1f710903, 0x48fc1423, 0x48f60972
+	},
+	{
+		0xa28f8357, 0x84a6754d, 0xb1e5c11c, 0xa888dbcd,
+		0x14bc3317, 0x04f6d9b1, 0xddf0882e, 0x33f6e36f,
+		0xae7f395c, 0x51f4afb5, 0x52720c58, 0xc20ecf52,
+		0xdf7e9952, 0xd7311e4f, 0xdf4f8977, 0x9e193aa7
+	},
+	{
+		0x7dbcd045, 0xcc5c715c, 0x6ac5be08, 0xcb2a442f,
+		0x1a304fd3, 0x6fc337a4, 0xde391401, 0xbe2b31de,
+		0x4d3d27a8, 0x5204390d, 0x8e70b527, 0xfefc9aab,
+		0xc7df79df, 0x3f9b7392, 0x2c667970, 0x90eba9be
+	},
+	{
+		0xe76a12cc, 0x28a277c4, 0x3ec44c95, 0x53bfed84,
+		0x20359286, 0x2aed6811, 0x752e012e, 0x041d2ca5,
+		0x717476e9, 0x881723b2, 0xa64a3fe6, 0x60c9ef6e,
+		0x62dd41e9, 0x69f0a26e, 0xb74fbf79, 0x19d42e8c
+	},
+	{
+		0xa0d850bd, 0x021d982a, 0x684f68eb, 0xad607931,
+		0xddf6fdcd, 0x17c84c69, 0xeb3f4758, 0x653daef9,
+		0xef152b37, 0x3deaa6ab, 0xf69b2dab, 0xde7fdabe,
+		0x41754fa5, 0xdd7206b0, 0xf9e0180c, 0x2dc979f8
+	},
+	{
+		0xb98f8d22, 0xcaa9300d, 0xb24f88ec, 0x2e1dd47b,
+		0xb72a2a93, 0x9fdbff50, 0x5d9d5271, 0x8970f0d5,
+		0x7c42a345, 0x268f3bcc, 0xdf9f7224, 0xe4cc1179,
+		0x56abd051, 0x099ca8ca, 0x85b95353, 0x2fb9e599
+	},
+	{
+		0x31386b9a, 0x7432a568, 0x6b22f44b, 0x5eaa5d28,
+		0xbcec4dbf, 0xf12faa49, 0x93b62c32, 0x3d791330,
+		0x7caa6385, 0x211cc054, 0xc3144294, 0x7e56d9b4,
+		0x6ed5ebb8, 0x06792e13, 0xca8404b5, 0x692fdf6e
+	},
+	{
+		0xc047ec08, 0x93faa7b8, 0x2a564e48, 0x75d93a3c,
+		0x8e40783e, 0x775a5850, 0xa5723c39, 0x0ee8d540,
+		0xad05f672, 0xd65ac60e, 0x2f2ada52, 0x17148401,
+		0xa1935de7, 0xfd4c754f, 0x061a7c82, 0xffac4bd5
+	},
+	{
+		0x1a6fb1be, 0x3e9d81c0, 0x8653c8e3, 0xd9a803ed,
+		0x8e49efb2, 0x18c67e5a, 0xb9f2ac55, 0x9b3d25f7,
+		0xa2a90e50, 0x313ba23d, 0x810690bc, 0x1c09a37e,
+		0x18b63eda, 0x0fbe0345, 0x6496f26c, 0x36d4e308
+	},
+	{
+		0x49ebc3ed, 0x1245d890, 0xbfd91a7e, 0x3b98c994,
+		0x64ff8b35, 0xf35b885e, 0xf355ffec, 0x96660a48,
+		0x51bbf899, 0x247a9dae, 0x4f36401b, 0x16b0668b,
+		0xfc6d187c, 0xb213c88b, 0x7d325507, 0x5501f3e4
+	},
+	{
+		0x7b7d8dd2, 0xddd4eb0f, 0x5547dfd0, 0x3f78f6be,
+		0x604c7c2e, 0x3a6db541, 0x6f2f1d36, 0x10ca9a6f,
+		0x27afc848, 0x174de235, 0x85e89cd7, 0x7d7a044f,
+		0xed532118, 0x378042b8, 0x1f51fa9f, 0x1d119a38
+	},
+	{
+		0x2545c3f6, 0x01957c79, 0x59cc90d6, 0x4dd11bbe,
+		0x61ac362b, 0xae526077, 0xcdc0a72d, 0x0d0cd0c5,
+		0x9e4947d7, 0x71c841c9, 0xe05a7686, 0x5db7ea1a,
+		0x88bbda1e, 0xf2d51753, 0x110c6d73, 0xdd0da9aa
+	},
+	{
+		0x1f5d4f2e, 0x24bd92e1, 0xed3a7fe3, 0x33eed23d,
+		0x9921bcaa, 0x30ef3276, 0x6a190783, 0xfe1e1720,
+		0xd0b38fc1, 0xa74bbfca, 0x26238537, 0x6ad56fbd,
+		0xa24dce0d, 0x1453c53f, 0x572e13f3, 0xb8d66f8d
+	},
+	{
+		0x6ddba35b, 0x55135fa9, 0x0c99feba, 0x3c4793c2,
+		0x65cd5361, 0xa6984ded, 0x23f804fe, 0xc1e9df72,
+		0x34782a6f, 0x5161a44d, 0x8f580e37, 0xc2b44296,
+		0x677f245d, 0xbb2456ca, 0x6bcd8a73, 0xf8d4093f
+	},
+	{
+		0x80c658c5, 0xa9d5f262, 0xeda7045c, 0x71c15750,
+		0xc92a5ff3, 0x54f4299b, 0xe7fe3be8, 0x607d7c03,
+		0xe3354062, 0x1ea184fe, 0x665a39b1, 0x7d676238,
+		0x706292b1, 0x45280843, 0x12dad77f, 0xf5fb0200
+	},
+	{
+		0x75a86757, 0xe1101bf7, 0xc58780f2, 0x3f34b01c,
+		0x8a62312e, 0x0fd080f8, 0x693bcb40, 0xb0d3cc7e,
+		0x990247bb, 0xe63ba9c1, 0x6f1a0521, 0x097dd003,
+		0x4ba1cdf9, 0xba8e4a48, 0x7e38f247, 0xb8e2eb26
+	},
+	{
+		0x3e929ca8, 0x9cfcae87, 0xe8bd2f23, 0xf2da271f,
+		0x961d7e30, 0x04539fe3, 0x67d3492f, 0x0a20e7bf,
+		0xae6657c2, 0xb614ea24, 0x9a218f37, 0x9cce0ecf,
+		0x745fc317, 0xa549588d, 0x8f34fc73, 0xb3344364
+	},
+	{
+		0xae118bec, 0xca0bb384, 0x2d6ec371, 0x7e5efc7a,
+		0x931f7a75, 0x35ca3d70, 0x11152993, 0x972b1cec,
+		0xfe636b50, 0x4803e014, 0xbc38f77d, 0xa1519bcb,
+		0x7bea81ed, 0xdb75a829, 0xda4b0f60, 0x3f2043e5
+	},
+	{
+		0x2c206717, 0xc6b3f2ad, 0x75abd071, 0xf1692c26,
+		0x7394c19c, 0xbdd153de, 0x89285704, 0x447bcd3b,
+		0x34641e7f, 0x78da031d, 0xa80bc2d0, 0x8e6ae13b,
+		0x341942bb, 0x72648472, 0xd78b4f89, 0x57c7ce3e
+	},
+	{
+		0xd9fc1b22, 0xc0ba31a4, 0x13b372b4, 0x60a1ae4c,
+		0xcc798845, 0x7434dd76, 0x038a735d, 0xa7e388bf,
+		0x3405bc7d, 0x1124e44e, 0x3b79415d, 0x4386fe5f,
+		0xf54544e3, 0xc43dc6ff, 0x310f5380, 0x73ca7b06
+	},
+	{
+		0xf40e5465, 0x90a24801, 0x5d1db99e, 0x2f5a5536,
+		0x3bd54e4b, 0x2576a471, 0xd2f78e00, 0xe87dcf14,
+		0x66dafb79, 0x31278d3d, 0x9091c8ac, 0xa942cf12,
+		0x84b5b27b, 0x55c2d2b3, 0xab579fe1, 0x52d5cee6
+	},
+	{
+		0x6d6585d1, 0xa1a8ffd4, 0xabafa172, 0xa149e128,
+		0x78d9712a, 0x8f5b3ade, 0x0c2862cb, 0x9c70167c,
+		0xe2584aec, 0x6d636942, 0xc5dd4e2c, 0xc7aa1f93,
+		0x2d174b65, 0x5bfa8723, 0x522a96e4, 0x64ce6d36
+	},
+	{
+		0xd385a729, 0x6171553c, 0x5164c6ca, 0x7af92da5,
+		0x144a5c5a, 0xfbd0e439, 0x291576c1, 0x9744f27a,
+		0x5d955ed1, 0x607c6318, 0xce236be6, 0x5377113a,
+		0x2cf909d9, 0x9b19348d, 0x4f5ec18e, 0x71520cdd
+	},
+	{
+		0xd1b3bb5d, 0x45261e75, 0x8ddbdf10, 0x1a0627fe,
+		0x18a57e32, 0xc7197ac3, 0x2d326cca, 0xfce636d8,
+		0x2ea40061, 0xc54ac12a, 0x12f318c7, 0xb1fad885,
+		0x4f7d05f9, 0xea8bafee, 0x76cd5ba6, 0xf433b714
+	},
+	{
+		0x7d702e80, 0xec5e5cc7, 0xa8ef02d3, 0x310eefc5,
+		0x64f07b5b, 0xfc8455ac, 0x8c40a254, 0x49e1d826,
+		0xa0879d1e, 0x5c576ae2, 0xa25ec098, 0xec4e52da,
+		0x9adb6e80, 0xbbced3dd, 0x23c408d3, 0xbd41dfa2
+	},
+	{
+		0x30f0681b, 0x4c8b876b, 0x1b763543, 0x1b635ae9,
+		0xc125c12c, 0xb36c8605, 0xbca1ea11, 0x90cd1070,
+		0x32417470, 0xbbadcdb8, 0x67f527db, 0x0cdd185a,
+		0xa5b50054, 0x01f972bf, 0x5bee1982, 0x6006e987
+	},
+	{
+		0x58b1ff29, 0x92c6c46e, 0x05b0500b, 0x5c30d989,
+		0x3a9a0269, 0x268cb82b, 0x0743dd0a, 0xcb20f1d4,
+		0xf18f9a55, 0xc244224a, 0xc72b298a, 0x036e32bf,
+		0x56898e8e, 0x35b032e2, 0xbbaee0b2, 0x6c3c17df
+	},
+	{
+		0x12a99d2c, 0x5738fcae, 0xf9a6efa2, 0x4dcbf645,
+		0xe452f126, 0xc63dd4eb, 0x1bd2f110, 0x462cb8cf,
+		0xdf85cbf6, 0xcefdb215, 0xf24cd959, 0x06237fc5,
+		0x5720a5f7, 0xfe158f41, 0x7ba270a0, 0xc5c768fa
+	},
+	{
+		0x7f8c6a16, 0xbe3b93c7, 0x1e7eeb97, 0xa111691c,
+		0xf831c143, 0xc20662a7, 0x4bad54eb, 0xa8d5b128,
+		0x26e900b3, 0xf9e1d4c2, 0x0231b6b4, 0x8f58482e,
+		0x0b3c2fa3, 0xff6f737b, 0x1af5207e, 0x3592deba
+	},
+	{
+		0x48c60096, 0x929a3b15, 0x1ed1f604, 0x3a5e2845,
+		0xf6889ea7, 0x7c6a713e, 0xe7b579fc, 0x44544057,
+		0x4cdca524, 0x87130f8c, 0xaae8c04f, 0x41d1c96c,
+		0xa6033d7e, 0x3c1f415d, 0x5ae7dbd3, 0xfcd2940b
+	},
+	{
+		0x35b3656a, 0xd93f0276, 0xe6bc9a10, 0x74630cc7,
+		0xb932adab, 0xe82325c5, 0x420770af, 0xd82f31d9,
+		0xa5ece08c, 0x30b4df4b, 0x32f2aa4a, 0xa0b3b51e,
+		0x17249a2a, 0x2b3a3408, 0xa1e6fd40, 0x038f163a
+	},
+	{
+		0x5a1949b7, 0x42218368, 0xffa82c56, 0xbf74f78e,
+		0x4545dbf6, 0x57d63fae, 0x6b0cf9b6, 0xf1cf5892,
+		0x26087c01, 0xc2a0ad34, 0x0c930f68, 0xf4e4d1fe,
+		0xf763282c, 0x75e60572, 0xa3667f6f, 0x939e06ba
+	},
+	{
+		0x78d80ecb, 0x95cf1ca0, 0xd11127eb, 0x27ea1d59,
+		0x99300fc2, 0x96c89c5a, 0x02b3d55a, 0xa99e00e0,
+		0x84e7c072, 0x59e766fe, 0xbf72aba1, 0xdb5f4f67,
+		0xfb33097d, 0xd629057d, 0x24588385, 0xdff379e7
+	},
+	{
+		0xa8a370ef, 0x45226040, 0x7a8b955a, 0xf7104cec,
+		0x97124479, 0x5ab4cf5f, 0x73cfd499, 0xce0b469c,
+		0xe433e07b, 0xb51056c8, 0xa1d6e672, 0xc4a6379c,
+		0x45811df9, 0x9921fcea, 0xe2db10e5, 0x23997e13
+	},
+	{
+		0x57b77133, 0x3c6887d4, 0x1324f743, 0x5fc726c3,
+		0xb4416b49, 0x61e02b60, 0xf451d44f, 0xad9ecce8,
+		0x4d9af768, 0x7d8d52af, 0x33626482, 0x121b624c,
+		0x1f05a7a5, 0xbfbace13, 0x081513f6, 0x4c8cdb1e
+	},
+	{
+		0x4b5e7018, 0x2c185c89, 0x036c4cdb, 0x41d56ef8,
+		0xb9f6a6f7, 0xb278f0bd, 0xbf1e1d35, 0x81394fe4,
+		0x313ca827, 0x39eb6488, 0x89b397f4, 0x8542546d,
+		0x0c922ccb, 0xa50b02ab, 0x601067c0, 0x46c0e7ca
+	},
+	{
+		0xd5a60665, 0xb017c38a, 0x75e88ea6, 0xc9467b05,
+		0x6f7875f8, 0xa1f30d0f, 0xd4d52601, 0x6c509286,
+		0x1f2e45f0, 0xd1a5fb7c, 0x13401739, 0x5ff49a6b,
+		0x87fa69e2, 0x4a4c26bb, 0x6b6acc99, 0x214eaccb
+	},
+	{
+		0x925f1bcf, 0x99c02786, 0x5be1197f, 0x4c4f91f3,
+		0x65647440, 0x4d0a5377, 0x225a8b2c, 0xf4917bee,
+		0x759767c2, 0xfa755a6b, 0xd46f4804, 0x74ff7812,
+		0xcdeedfd4, 0x951140c7, 0x9380f1c5, 0x6d00e598
+	},
+	{
+		0x0bb76779, 0x1a20a370, 0x306978ed, 0x111ce0e1,
+		0x4ac022c4, 0x75948097, 0x43655cb0, 0xb645f91b,
+		0x12cd92b0, 0x5bcf539f, 0x3a757338, 0x2137a937,
+		0xe36ae9a7, 0xead461a2, 0x12cf530e, 0xe1a101da
+	},
+	{
+		0xcd528b04, 0xd5debc9a, 0x1b786569, 0x625f31b8,
+		0x9fa42b4d, 0x2d317967, 0xaebc9b0d, 0xc7ddc4ab,
+		0xb53cbc38, 0x315918e7, 0xccd2550e, 0xd5c518dd,
+		0xe5aa733c, 0x2ef47ccb, 0xc28e171e, 0xf300d8de
+	},
+	{
+		0xd5c95c8d, 0xd65c0764, 0x1721da03, 0xe11f8821,
+		0xb9760799, 0x4e9ecd19, 0x465e5431, 0x06b94ad8,
+		0x1bea72e0, 0xee764ddf, 0xb211aee1, 0x36462bd1,
+		0x2f36fb4e, 0x436d7a52, 0x652e7f00, 0xf755f660
+	},
+	{
+		0x2e769094, 0x51ad6c57, 0x28b20fbc, 0x4c90638f,
+		0x89b9b68d, 0xe55fbaf5, 0x7405f739, 0x31bb4fc1,
+		0x686f057e, 0xaa157461, 0x4ae16adf, 0x3b10a8b5,
+		0x07605f1b, 0xc3e983b1, 0x8d413930, 0xe3b13e08
+	},
+	{
+		0xa2d942a8, 0x85837648, 0xa22abe50, 0x84e0fa3f,
+		0x3f897130, 0x5bb2a97b, 0xc763182c, 0x6bfb07c6,
+		0xb1686c8f, 0x605895c6, 0x5279f0b4, 0x6014326c,
+		0x7051c4a1, 0x76e75141, 0x13f25022, 0xe69c8a36
+	},
+	{
+		0x18053678, 0x98bbe4b0, 0xf426f786, 0xcb297c10,
+		0x38ea1ef3, 0xb5841fa2, 0x4bb34022, 0xac1b6cb4,
+		0x4618e123, 0x6059f09f, 0xa66bf193, 0x62575192,
+		0x9af6d75d, 0xc529cf79, 0x1a4b66fb, 0xcab819ed
+	},
+	{
+		0x1da1b1d6, 0xcbd88b2e, 0xc27b1e7c, 0x7b87d24b,
+		0x0c3b0b1d, 0x3d774398, 0xf86a7731, 0x6910d00a,
+		0xdd8a50ac, 0xab22c0bc, 0x86d5b8b2, 0xa7111611,
+		0xccfb442d, 0x998e16b2, 0x1f29a772, 0x45e46a3c
+	},
+	{
+		0x2d16bcb7, 0x7a58240d, 0x735406f1, 0x1e919fc3,
+		0x66f42da8, 0xa7f9f8fe, 0x9a32bdd9, 0x8bb9df26,
+		0x2ee5701e, 0x66ceb32e, 0x3e6d2a65, 0x0b1c63fc,
+		0xa841114a, 0x919abf7b, 0x45b20c63, 0x1fc16320
+	},
+	{
+		0x70adc81c, 0xd1d20980, 0x960a6585, 0xc8b2dda7,
+		0x2e7b4dc2, 0xdd183c83, 0xa4664c88, 0xf656144f,
+		0x4e99242b, 0x66dd8d86, 0x78e0dd46, 0x9c9dee9d,
+		0x66760073, 0x2ca79436, 0x20d638ce, 0xe97e38b8
+	},
+	{
+		0xc6fb151a, 0x77d30c0e, 0x971ab9b7, 0x449f5e48,
+		0xe83d22e3, 0xcc748405, 0xb24ca275, 0x9162b379,
+		0x4b19fd36, 0xd2273139, 0xbda82a01, 0x070cc4b6,
+		0xc9747b7e, 0x669feb9a, 0xab9f91c0, 0x723a6967
+	},
+	{
+		0xb33cf553, 0xae2cf87d, 0xa6b4c27c, 0xc50cadda,
+		0xe95e0dec, 0xc534b887, 0xbd82cec7, 0xa2074157,
+		0xe247b7fa, 0xf3c96d24, 0xfd7dcb2e, 0x87f4fb64,
+		0x7d286ec2, 0x3fba3a3e, 0x91a9195b, 0x2a278df2
+	},
+	{
+		0x9b25d403, 0x6ac340a8, 0x0472f36e, 0xe42fcef6,
+		0xdcfaea04, 0xa70637cd, 0x7912171a, 0xa307fe97,
+		0x2fcd396f, 0xb9975a73, 0xa9019979, 0x875e1667,
+		0x0e736a92, 0x7be84994, 0x86c989fa, 0xd5ac8113
+	},
+	{
+		0xa9de6e6f, 0xe94ae5cc, 0xe02c002b, 0xa809c530,
+		0xd0bf0cf6, 0xf8613a85, 0x49b5056a, 0x07bbb3a0,
+		0x1cc0c289, 0x2f384bdc, 0x51776494, 0xf07e08ad,
+		0x979c0f51, 0x8544b598, 0x122d9076, 0x20404024
+	},
+	{
+		0xf303c9a3, 0xd32ef27d, 0xd7524e61, 0x7a11c23d,
+		0x6c1e9848, 0x5e02cec2, 0x60453fb4, 0xd032291f,
+		0x8b6266d9, 0x1be2de55, 0x5d2bcf0e, 0x36fbe423,
+		0xa79976d4, 0xf6820f29, 0xf6e30808, 0x9eda119e
+	}
+};
+
+#elif uECC_COMB_WIDTH == 8
+
+const uECC_word_t uECC_secp256r1_comb[128][NUM_ECC_WORDS * 2] = {
+	{
+		0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+		0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+		0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+		0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2
+	},
+	{
+		0x8101e6e4, 0x16fc51ff, 0xfccc3ac2, 0x830895e4,
+		0x4aa7358f, 0x608548c2, 0x0cedc02a, 0xe3579822,
+		0x52c392c3, 0xaad2b998, 0xc523e6ef, 0xf0570bed,
+		0x768a3299, 0xf3e4b396, 0x1f433a2d, 0x700f948e
+	},
+	{
+		0x097992af, 0x93391ce2, 0x0d35f1fa, 0xe96c98fd,
+		0x95e02789, 0xb257c0de, 0x89d6726f, 0x300a4bbc,
+		0xc08127a0, 0xaa54a291, 0xa9d806a5, 0x5bb1eead,
+		0xff1e3c6f, 0x7f1ddb25, 0xd09b4644, 0x72aac7e0
+	},
+	{
+		0xd945111e, 0x30368cb6, 0xf5c4ad42, 0x585a137e,
+		0xffea17c1, 0xc22c48c5, 0x958f1608, 0xa5ab9e10,
+		0x785b4ed9, 0xc34a47b8, 0x49a10f77, 0x46ed771c,
+		0xad0648f4, 0x629e17eb, 0x8b1aa09a, 0xd3ebc611
+	},
+	{
+		0xcc049786, 0xc761c1fe, 0x5e98c12d, 0x48f9c187,
+		0xfd208dfb, 0x00d1a0a5, 0xa0642197, 0x418d68de,
+		0x51b50759, 0x481eef55, 0xc16caad0, 0x17429c50,
+		0x2ef8d320, 0x43563962, 0xa5ba6dd4, 0x5d7b26f6
+	},
+	{
+		0xe38e3820, 0xc52c00ca, 0xdd561bec, 0x82d789a6,
+		0x74647ebe, 0x54a0fe52, 0xa7b5d4fb, 0x57f62eec,
+		0x48f81460, 0xaa60759d, 0xec356dce, 0x0d300594,
+		0xefea8f48, 0x60e9c067, 0x89bfe2ad, 0x5e5ff8bf
+	},
+	{
+		0xc6fae6d7, 0xbc499ee7, 0x7e1c792e, 0xeddf9c6c,
+		0x5bf70c35, 0xc9c6f541, 0x90422d81, 0x06f0afdb,
+		0x4dbc747a, 0x214f0ad0, 0xaf7ae617, 0x41a7cf1a,
+		0xdde64646, 0x7bab8955, 0x3f9804c4, 0x77f9e8f7
+	},
+	{
+		0xf2159928, 0xaf972b45, 0x4760c41e, 0xd86848c8,
+		0x6b47957b, 0x269843f1, 0x2086a46c, 0xe018aaa2,
+		0x99698420, 0x21a03322, 0x4fed7bb9, 0xd36d88b3,
+		0xba0dbc83, 0xf2fe8863, 0x7f10ee50, 0x383f4db0
+	},
+	{
+		0x2a1d367f, 0x13949c93, 0x1a0a11b7, 0xef7fbd2b,
+		0xb91dfc60, 0xddc6068b, 0x8a9c72ff, 0xef951932,
+		0x7376d8a8, 0x196035a7, 0x95ca1740, 0x23183b08,
+		0x022c219c, 0xc1ee9807, 0x7dbb2c9b, 0x611e9fc3
+	},
+	{
+		0xd94b1a05, 0x1f969276, 0xadf9e430, 0xca9b1154,
+		0x4b3cf7fb, 0x8930de36, 0xb9a7112b, 0x4ee298bb,
+		0xcaba1c4a, 0xc7551f59, 0xfb972962, 0x79a86b84,
+		0xb38a628c, 0xe47c8ac6, 0x463a6a4c, 0x2cbbf338
+	},
+	{
+		0xfc5cde01, 0xe48ecaff, 0x0d715f26, 0x7ccd84e7,
+		0xf43e4391, 0xa2e8f483, 0xb21141ea, 0xeb5d7745,
+		0x731a3479, 0xcac917e2, 0x2844b645, 0x85f22cfe,
+		0x58006cee, 0x0990e6a1, 0xdbecc17b, 0xeafd72eb
+	},
+	{
+		0x1a780592, 0x91ba25b5, 0x1500d337, 0xee59a574,
+		0x9288e474, 0xe36f1c44, 0xd85f6d65, 0xd3e89acc,
+		0xd8871d87, 0x0f5590ec, 0x92e2f47a, 0x565c81ca,
+		0x841fb007, 0x55942307, 0xa5dc1163, 0xa4f12b40
+	},
+	{
+		0xab0c3e88, 0x1fe36ffc, 0xba8303d2, 0xc2b3b386,
+		0xadc757ca, 0x72aabf6e, 0x5eec7013, 0x1240b6fd,
+		0x1a9310a3, 0x106308a8, 0x2c136832, 0xb9f4ab88,
+		0xf43cc68f, 0x48a48000, 0x214b70d9, 0xe54f16a7
+	},
+	{
+		0x52ffcef3, 0xbaf7d307, 0x9eec8a3e, 0x46b57e18,
+		0xf7ea3bdb, 0x77a91d71, 0x2bc76af7, 0x771f4575,
+		0xfce5c8b5, 0xd918b424, 0x53df5f8f, 0xef6a2851,
+		0x2615a6d0, 0xc375b434, 0x42161a6e, 0x32e41149
+	},
+	{
+		0x9ef0f09e, 0xea5d651d, 0xcad74dc7, 0x2fe6a994,
+		0x8003a37e, 0xa6c44b75, 0x8579357a, 0xdb525471,
+		0x2ed0f0b1, 0x8732a3e3, 0xb0bb5647, 0xbe207a55,
+		0x32d4eceb, 0x4335fde2, 0x72c4ad3e, 0x91b67e63
+	},
+	{
+		0x152b9a0e, 0x7ff55fc4, 0x8473875d, 0x3f68c71c,
+		0x57862556, 0xe52b3f50, 0x97b14c6e, 0xe3ddb10a,
+		0x68dba9f2, 0x36758574, 0xd269de87, 0xd1d4f5dd,
+		0x41c3def2, 0x57392917, 0x72836177, 0xd3b0f1bf
+	},
+	{
+		0x374e4457, 0x9bf49908, 0x5eecb703, 0x40bf984b,
+		0x68f1f6f1, 0x9b6f997e, 0x9d565a0c, 0x47b54b04,
+		0x69900111, 0x241301c3, 0x776f48bb, 0x4e2a6ea3,
+		0x0feb1cc1, 0x77368e75, 0x15a4a7df, 0xe7afea29
+	},
+	{
+		0xd961d446, 0x03220fb8, 0x0626c5d7, 0x176324e4,
+		0x722425cc, 0xd43b2ebc, 0x86dbc8f8, 0x29d6274e,
+		0xc08d73db, 0x58185a44, 0xe1239ea5, 0x9c8c1cbf,
+		0xbac64731, 0x2b1cfe87, 0xa5816948, 0x6c16b472
+	},
+	{
+		0xc60c4684, 0xd8218845, 0x0859a19e, 0x66a66447,
+		0x3ed6dfca, 0x9e18931e, 0x6fea0609, 0x3b5b03e6,
+		0xa9d7edbb, 0xd8bc19b5, 0x64477877, 0x95ffd112,
+		0xf35c8263, 0x2cd1ca07, 0x38e14ddc, 0x76f1e0c8
+	},
+	{
+		0x67429e4d, 0x8722658c, 0x0561f51e, 0xbe9522aa,
+		0xd9d59f46, 0x3d622057, 0x89ef69a2, 0x76e96b46,
+		0xb797faed, 0x16aa0650, 0x15ff8993, 0x75b78e22,
+		0x27f9fb88, 0x1575c0cb, 0xf705e319, 0xcf218959
+	},
+	{
+		0x87617f0e, 0xcf15dc9c, 0x6858d44b, 0x85b40dee,
+		0x121421de, 0xa96c9e4b, 0x05d45c5a, 0x191eb33a,
+		0x199cf43b, 0xc9c16e10, 0x28ee6e02, 0xf245c57b,
+		0x45e9654f, 0xf3eb80dd, 0x592282a1, 0x8a9365ff
+	},
+	{
+		0x7e0e3190, 0x44f65f50, 0xea3f501a, 0x1370d12f,
+		0x8c6615b0, 0xb8635f9a, 0xb3cd1c0f, 0xff29dc0f,
+		0x738114f6, 0x07f8a15d, 0xeecc62e3, 0x14def0ab,
+		0x09b8e6b6, 0x24dd6595, 0x3439a422, 0xc43831f3
+	},
+	{
+		0x60d54267, 0xa30935f7, 0x652f6cd5, 0x5c5093ba,
+		0x0b854da9, 0x8720d196, 0x2c10d86c, 0xf361d706,
+		0x723b99e4, 0xd11a3d27, 0x2f7d40c8, 0x8a18ce4b,
+		0xc3d3516d, 0x44bdb2fa, 0x6b183cfb, 0x2c990dbb
+	},
+	{
+		0xa52342b3, 0xaf31d989, 0xc03eb194, 0x918e1fb4,
+		0x6b6cb7b9, 0x303e35f0, 0xe062a8c2, 0x33fef524,
+		0x512e5bc0, 0x692a4fbe, 0xf5162c74, 0x067cfb0d,
+		0x20859bd2, 0x519ad6ff, 0xd84dbd4e, 0x0a5b4caa
+	},
+	{
+		0xd0a62b2c, 0x1fd07ab7, 0x9f776819, 0x31c6f056,
+		0x8edc0d13, 0xe0443b93, 0x63ae46a6, 0x1b9d594e,
+		0xc14453e5, 0x5ab358fc, 0x9a58ab51, 0xfb52863b,
+		0x01683cef, 0x473ab211, 0xed96c8e1, 0xed16ba54
+	},
+	{
+		0xfd943a71, 0xef977470, 0xef2d93e1, 0x2dbfbc52,
+		0x62b812a7, 0xfbe20b47, 0x3ef44b43, 0xa1547557,
+		0x89bc18d0, 0xf18068cb, 0xb7e40a72, 0xd0702163,
+		0x92efaf4f, 0xb5115ad4, 0x8c4b8a43, 0x384d5627
+	},
+	{
+		0x061457fe, 0xc877db08, 0xc6471595, 0x60eb5c88,
+		0x808ec0ed, 0x03ce1e41, 0xe27f462a, 0x4a014325,
+		0xa4fba4fc, 0x7961a1cd, 0x662743c7, 0x206d4beb,
+		0x41cda791, 0x47f12714, 0x2f381bb9, 0xb069f7e0
+	},
+	{
+		0x9b6d8676, 0x9a89a4cc, 0xad3055b9, 0xcbe46247,
+		0x6b4f6a92, 0x8a8c8b10, 0x570e8f0f, 0xd96633a7,
+		0xe8b04cc1, 0xd1fda6e8, 0x40ba4a72, 0x215d4ce6,
+		0xf64c3358, 0xd7533270, 0x9825b9fd, 0x4d144dea
+	},
+	{
+		0x253bcbf0, 0x0f8364c4, 0x03bb9180, 0xf26390c7,
+		0xad1e3bb3, 0x4ebccda4, 0x85a5d1eb, 0xb08c91a3,
+		0xb643475c, 0x60dc9158, 0x2ba0101b, 0x39bd97d6,
+		0xc502fbe0, 0x6fd29d96, 0x3158a73c, 0xb8fe20c1
+	},
+	{
+		0xa4f0c81b, 0x8821c701, 0x881d4342, 0xeaa11d49,
+		0x79a87eef, 0x346fab79, 0x39848086, 0xa9c3643e,
+		0xf6c6e053, 0xe040a053, 0xe1f9d4ba, 0x0d287400,
+		0xbd4aa53c, 0xa48cf15d, 0x11e94cef, 0x76cdf40c
+	},
+	{
+		0x2bc5c755, 0x8746f483, 0x775a0fe2, 0x3dc6f57f,
+		0x0f21c2c9, 0x87bccbe9, 0xeae51818, 0xdb93a6b1,
+		0xa87aa88a, 0xf5754a37, 0x73972e83, 0x2791bf54,
+		0xdeac962d, 0x65fe92b6, 0x5db3c2a5, 0x7675343a
+	},
+	{
+		0x18064104, 0x82480753, 0x0891878c, 0xf3c2f9c4,
+		0x29af296d, 0x1d6cbef1, 0x55b9ed41, 0xa57ddaa3,
+		0x903a1cdf, 0x4f47c7f1, 0x197db90d, 0x45057fcf,
+		0xca13fa12, 0xc125bb25, 0xd7f746df, 0x5bcfd6f3
+	},
+	{
+		0x677c8a3e, 0x2df48c04, 0x0203a56b, 0x74e02f08,
+		0xb8c7fedb, 0x31855f7d, 0x72c9ddad, 0x4e769e76,
+		0xb824bbb0, 0xa4c36165, 0x3b9122a5, 0xfb9ae16f,
+		0x06947281, 0x1ec00572, 0xde830663, 0x42b99082
+	},
+	{
+		0xfbcbc0c3, 0x490e66bc, 0x15065b98, 0xe8d7b164,
+		0x3e1a841c, 0xf2f80e3e, 0x7696fcf5, 0x62d4a49f,
+		0xf521f731, 0x86eddee7, 0x77305b14, 0x90337684,
+		0xf36fa83e, 0x56193ecb, 0xd347d332, 0xd18b33eb
+	},
+	{
+		0xc31a3573, 0x7f991ed2, 0xd54fb496, 0x5b82dd5b,
+		0x812ffcae, 0x595c5220, 0x716b1287, 0x0c88bc4d,
+		0x5f48aca8, 0x3a57bf63, 0xdf2564f3, 0x7c8181f4,
+		0x9c04e6aa, 0x18d1b5b3, 0xf3901dc6, 0xdd5ddea3
+	},
+	{
+		0x30076ed0, 0xdfa412e5, 0xece43efe, 0x90e7efc3,
+		0xe9c9c2a2, 0x7d021b57, 0xb498993d, 0xe3ddf1b7,
+		0x846b4d7e, 0x5b955c48, 0xae7c855e, 0x959131ad,
+		0x77227a7b, 0x8490e467, 0xa60ce85f, 0x283833a8
+	},
+	{
+		0x8c4150cc, 0x88bc6c8d, 0xad6c3923, 0x73758b21,
+		0x29928820, 0xd43a7503, 0x95ea9feb, 0x790ecf86,
+		0x1bfb5292, 0x59a580f7, 0x9f51de15, 0x0f7a900f,
+		0x9d6239f6, 0xf444c49a, 0xd87decf6, 0xe340d641
+	},
+	{
+		0xe872889a, 0x0dfab50a, 0x703913a8, 0xfab939d7,
+		0x16b20242, 0x4ebc7144, 0xd2f8bae8, 0x22bc5020,
+		0x9d713946, 0xabeaaae6, 0x3ef21012, 0x3c2cd39e,
+		0xaef98a9b, 0xac67692c, 0x78e64c2e, 0x616222e4
+	},
+	{
+		0xa15bbae6, 0x7549f1b1, 0x8ba6bbcf, 0xa9c4ebbc,
+		0x3ab26d77, 0xf3deb351, 0x7f94bbb6, 0xfd3bcf2d,
+		0x46fe3ddc, 0xfa8344d7, 0xd2f4fdab, 0xbad3e545,
+		0xf8de5d37, 0xba4ccb8e, 0xd97112db, 0xada514fe
+	},
+	{
+		0x1f70723f, 0xda398393, 0xb21ac825, 0x6cfe750a,
+		0xf4eb6e64, 0x92c6a768, 0x47c9e925, 0x4290db0b,
+		0x413464c5, 0xf9d2fb88, 0xc8971f1a, 0x64aa8ad3,
+		0xf2ebcd3c, 0x263bead1, 0x3374c163, 0xb5d01e33
+	},
+	{
+		0xa2582e7f, 0xd36b4789, 0x4ec39c28, 0x0d1a1014,
+		0xedbad7a0, 0x663c62c3, 0x6f461db9, 0x4052bf4b,
+		0x188d25eb, 0x235a27c3, 0x99bfcc5b, 0xe724f339,
+		0x71d70cc8, 0x862be6bd, 0x90b0fc61, 0xfecf4d51
+	},
+	{
+		0x00aef6e0, 0xf4b1ad53, 0x92448ec8, 0x51d353e9,
+		0x4f5f7050, 0xbda23624, 0x5172ddf2, 0x38641e4c,
+		0x0dafe306, 0xd076b5ae, 0x042f9b7f, 0xbaf02e13,
+		0x7bb9888d, 0xefb76553, 0xeee3a756, 0x28ac3017
+	},
+	{
+		0x0d1d78e5, 0x9615b511, 0x25c4744b, 0x66b0de32,
+		0x6aaf363a, 0x0a4a46fb, 0x84f7a21c, 0xb48e26b4,
+		0x21a01b2d, 0x06ebb0f6, 0x8b7b0f98, 0xc004e404,
+		0xfed6f668, 0x64131bcd, 0x4d4d3dab, 0xfac01540
+	},
+	{
+		0x8fa9f0a4, 0x62427d34, 0xa7621aa3, 0xef92aac0,
+		0x6bc20d7f, 0x9a3bfb57, 0x57add1cf, 0xe00f53af,
+		0x9a8e182b, 0xaa091420, 0x65870acd, 0x6dbadf70,
+		0x9e7fa3d9, 0x1873e2cb, 0xae5822e9, 0x15b8c5b7
+	},
+	{
+		0xa5d67e8a, 0x8d3e6d40, 0xa18b743b, 0xe139639f,
+		0x948e7dc2, 0x63749ea0, 0x526bde8f, 0xabd4c85f,
+		0x2d812dfe, 0x731da794, 0x67ed8673, 0x9a9c0ddd,
+		0xa83f2506, 0x63feba54, 0xf64a622e, 0x475baed2
+	},
+	{
+		0xbdd6fa57, 0xdde6c1b0, 0x6877584c, 0x64da38dc,
+		0x88a2ea3b, 0x5efd04d6, 0x8de94787, 0x5e12f389,
+		0x4c229e61, 0x822dc6f3, 0x32c58ce1, 0x0220a965,
+		0x12104d90, 0xbff58f54, 0x6f430c30, 0xcc9c71a8
+	},
+	{
+		0x5da65e89, 0xcea18fed, 0xb6030005, 0x89d02e3a,
+		0x16b45eab, 0x593303db, 0x40b36824, 0xf5d40404,
+		0xb6e6ca16, 0x8e62c398, 0xa0f8db73, 0xb6680f4a,
+		0x3735f704, 0xe2cb53ab, 0x005e4955, 0x90eaf4b0
+	},
+	{
+		0x1159f10e, 0x807d9af8, 0xb42511bc, 0xe05eff00,
+		0x61b05022, 0x2ee9f026, 0x29fb81a6, 0x3d45853a,
+		0xf75bc3a9, 0xa6b9c16e, 0x515a90e0, 0x82111a06,
+		0xedfc125e, 0x87211449, 0xa80a8311, 0x4e4de334
+	},
+	{
+		0x0236a83d, 0xe0052323, 0xcd9a2912, 0x1fb825a3,
+		0x3f92d724, 0x69479cbc, 0x38ec3ddd, 0x389eff26,
+		0x1eb367c1, 0xe9ffea6c, 0x91f3a0de, 0x113a50c5,
+		0xb7b0af9e, 0xcfd0310c, 0x31ea1ac9, 0x5e1b21c9
+	},
+	{
+		0x863def2f, 0x71db5c74, 0x86db595a, 0x46fc6cc6,
+		0xb0578f7c, 0x41a41f2a, 0x00c9bc26, 0x3af24209,
+		0xb3c9ab1a, 0x134233fd, 0xb6070f59, 0x7870f3a9,
+		0xdf2af343, 0x39b1f3b2, 0x4ab472ab, 0x6013da0e
+	},
+	{
+		0x901d3434, 0xe4269dbe, 0xfe90a0f6, 0x93b1c84f,
+		0xc4383c70, 0x9e0ab0cf, 0x9ef8f7f3, 0x94a875b9,
+		0x7bd07e21, 0x7c54e527, 0x24c1f8a1, 0x4426e751,
+		0xa59e4156, 0x88d04ff3, 0x2e3f9185, 0xca552076
+	},
+	{
+		0x0da1427c, 0x93eb1d71, 0x410e3f28, 0xb5f1a270,
+		0xa9325717, 0x7e9d484b, 0x576b2b28, 0xf883c4ab,
+		0x15b0cc94, 0x8471e075, 0x560fab54, 0xaee70132,
+		0xdd9dec7a, 0xb461efe8, 0x488ab1d0, 0x6086f208
+	},
+	{
+		0xb789034e, 0xa7f47395, 0xe3acd77c, 0x5378515c,
+		0xa20bcd3f, 0x29d692e0, 0x59e44b71, 0xbfd07180,
+		0x6733f199, 0x92cd3e15, 0x99f9141a, 0x43428c81,
+		0x07e9c6e8, 0x47e891ec, 0x75deaf04, 0x47103963
+	},
+	{
+		0x48c1555e, 0x886878ca, 0xaf70db2d, 0x5fb1fbc9,
+		0xb15fda95, 0xdffff48f, 0x8fb2fa61, 0xfd98525d,
+		0x57f0c9a8, 0x9a481e75, 0x27069783, 0x9bab3b2a,
+		0xa223c95e, 0x9569dffb, 0x0f6b2d61, 0x93840d78
+	},
+	{
+		0xbaf91228, 0x348857ea, 0x4ecb2af2, 0x892d0a81,
+		0x91e8b82b, 0x06136e7f, 0x495431ad, 0x0869ec0d,
+		0x2e051cdf, 0x54fa49c4, 0x823c9b51, 0xcb47adca,
+		0x265eb81a, 0x70a00076, 0x9b7675a0, 0x5572895c
+	},
+	{
+		0xe86e02ab, 0xf29fb08f, 0x0d5c06ca, 0xa8266dc1,
+		0x2f48f49f, 0x25d5e27d, 0xe6f31bb3, 0xa2ebf469,
+		0x0382a8eb, 0x86ae97d9, 0x363f04f7, 0xcb92f44b,
+		0x002d76f6, 0x391b9654, 0x4432235d, 0x27bebd8c
+	},
+	{
+		0xe529a049, 0xa2d545da, 0xc73a541a, 0xa581a768,
+		0xe0950a67, 0xafe88b1e, 0x52b8fcca, 0x62778f74,
+		0x0b8483fc, 0x44bb1bfa, 0x6e882c24, 0x5d727f5a,
+		0x553a776c, 0x4e4cbe60, 0x1ae91088, 0xe155b2f8
+	},
+	{
+		0x12c953e4, 0xa9f4f5c1, 0x2a6a470a, 0xfe518080,
+		0x0b17775b, 0x5455fbcb, 0xc1752bb7, 0x4f117894,
+		0x544a3be7, 0x5b5e49de, 0x22c3ec1c, 0x0dde356f,
+		0x01da56c9, 0xe26ae66a, 0x35ffd9dc, 0xab3b6155
+	},
+	{
+		0x59b21469, 0xca907bff, 0xc44627de, 0xecfda9fd,
+		0x5af99278, 0x8b32c8bb, 0x51c0a6fc, 0x2298506c,
+		0x9d7bfc5f, 0x2227244e, 0xbc8dcdbc, 0xd903a0c9,
+		0xa5809f67, 0x8916acec, 0x4c45bbd7, 0xfef3434a
+	},
+	{
+		0xbe224934, 0x07c6577e, 0x133b52f5, 0x0bd79c64,
+		0x26ea9a30, 0x6d440b9b, 0x8af95af2, 0xdc9823e4,
+		0x951a08eb, 0xf3dcb38a, 0xcd6f6b4f, 0xcaedc3a2,
+		0x55572efd, 0xb648efdb, 0x043c56dd, 0xb2656a22
+	},
+	{
+		0x530e8727, 0xc7e05f58, 0x88a132f3, 0xd41592d9,
+		0x4835f583, 0x7cb9b486, 0x8f603959, 0x0d5caba2,
+		0x7d850a76, 0xb97c361d, 0x0751fedf, 0x75d0638a,
+		0xeb862fbe, 0xad213d44, 0x597d997b, 0xcb814263
+	},
+	{
+		0xf8d734ca, 0x56131598, 0x32ab6115, 0xa90c803b,
+		0x294f6172, 0xf20b6904, 0x29bb4956, 0x9c4c8c6b,
+		0xa3443e3c, 0x72523cbc, 0x1aaf4a8f, 0x403fc2d5,
+		0xf99a6339, 0x264bcaa0, 0x6437cec7, 0xf837ca9f
+	},
+	{
+		0xa38218cf, 0xb7aeab38, 0xa9e0d3c4, 0x2b07aeb1,
+		0x47a4c94d, 0xf0d16be2, 0x91fd763c, 0x5af88695,
+		0x2a9da273, 0x053ab914, 0x61ebe016, 0x10d130ab,
+		0xd34e284a, 0x5099b9c8, 0x6ed4de65, 0xb21a4103
+	},
+	{
+		0xe6a868a0, 0x84b1e14b, 0x47bc1e4f, 0x7b98a2bb,
+		0xcc803733, 0x0e6df4e4, 0x7958e14d, 0xb751a536,
+		0x5b9871b7, 0xf925771b, 0xe16ed05e, 0xeffa615a,
+		0xc695ddd6, 0x3141411a, 0x61468d10, 0x91eb562a
+	},
+	{
+		0xc0c1ce9f, 0xfd4c1473, 0x7eda11d3, 0x27f187b9,
+		0xd9845057, 0x024cd871, 0xa174d4d3, 0xcf6b116f,
+		0xd279352f, 0xd300b23f, 0x23f12526, 0x364bc658,
+		0x2ab7b709, 0xc7908819, 0xb6bfc532, 0xc2de1fa1
+	},
+	{
+		0xd93f535c, 0x64549b3d, 0xa76e5bf3, 0x93978b4d,
+		0x5a01c10e, 0xe2b1f3ee, 0xa9d19ea8, 0x76f210af,
+		0xc4264d57, 0xf04aca7a, 0x483487ba, 0x9f989031,
+		0xe6280f91, 0x84132d01, 0xb3a040cf, 0xf34b31ce
+	},
+	{
+		0xcffcaf2d, 0xb535fd34, 0xa23b8b1b, 0x9c8838df,
+		0xe178f644, 0xb2fb47fd, 0xf5d8be2c, 0x201173f5,
+		0x9968eeee, 0x485e1c8d, 0xf856b514, 0x165d69ea,
+		0x756b5779, 0x17b6206c, 0xafe2ae9a, 0x8dac7611
+	},
+	{
+		0x08bdf594, 0xbc7bcc73, 0xa9178a0b, 0x8fec77f2,
+		0x949edfb7, 0x7bb27826, 0xf137d62f, 0x77b0d0c5,
+		0x88f8a9ea, 0x5add7b4b, 0x966cda49, 0x133edfbd,
+		0xeab66f18, 0x0189ca26, 0x55f452b1, 0x40c07b47
+	},
+	{
+		0xb34983b1, 0xfb5f7e26, 0xd3fbb145, 0x7e38e207,
+		0xaf71ed7f, 0xf608ee91, 0x686e5aea, 0x6d78f612,
+		0x607e751e, 0x2f9d2e63, 0x2748ba3b, 0x8607cb37,
+		0xf4fe56a9, 0x006f6d32, 0x6d242b89, 0x2980bd5a
+	},
+	{
+		0x3dba87e7, 0x6384ab74, 0xb78a63ac, 0xe8f20516,
+		0x03fa5c24, 0xc6d198de, 0xb50c2893, 0x7afb3d4f,
+		0x3a4cf320, 0xe4d418b9, 0x4faa9acc, 0xaac22a0e,
+		0x552c1f31, 0x08a7cc67, 0xd6668beb, 0x36009a3a
+	},
+	{
+		0xfaecb3e4, 0x1d348841, 0x0406e1ce, 0xe2e6d3b5,
+		0x87679b85, 0x504b9726, 0x78812b43, 0x25279d03,
+		0x56676779, 0x7e329009, 0xb002bcf5, 0xf0184a5b,
+		0xd630da82, 0x49e88336, 0xf08564a7, 0x92d01b0b
+	},
+	{
+		0xc9757170, 0xdbdeb29d, 0xcbf1b409, 0x55b5a898,
+		0xa4c0cbd2, 0x01b3dfd4, 0xd97e4324, 0x38611618,
+		0x57bee79e, 0xf3ea3774, 0xbc20e2c6, 0x60941f4e,
+		0x53c47b89, 0x21d8f508, 0xb8f41362, 0x7e7d03d3
+	},
+	{
+		0x339fe5ce, 0x045ef431, 0xd24c26d1, 0xef414a60,
+		0x661f3bbe, 0xc4151215, 0xa31d0a51, 0xca270c0b,
+		0x89d02271, 0x0bddc41d, 0x55b9ae92, 0x5da2412a,
+		0x1b6552cc, 0xe2a468e2, 0x29cbeee5, 0x0920500e
+	},
+	{
+		0x8c720a67, 0xbad5f61f, 0x16bfc3dd, 0x2c3c19bc,
+		0x65d64e56, 0x997d4265, 0x49504379, 0xab25034f,
+		0x1410392e, 0x1f6297f6, 0x12e86d68, 0xbef8d14a,
+		0x1dfbd10b, 0xd6405555, 0x0d44fbaa, 0x53cad2bd
+	},
+	{
+		0x66554187, 0x76f6c646, 0xd3bac858, 0xde2a1e0e,
+		0xca976e8b, 0xa81f6685, 0xf60c851c, 0x48a9d631,
+		0x336936e6, 0x95a81b38, 0xf7934cbd, 0x588c234f,
+		0x68db8031, 0x5603885c, 0x5c1a48c7, 0x9c777837
+	},
+	{
+		0x0ad2fe5c, 0xf426fe06, 0x9022c4cb, 0xb8746069,
+		0x403efce0, 0xa1f27672, 0x53e2cc9a, 0xc34b4a30,
+		0xd0e57d9f, 0x7e49b3ab, 0x13463806, 0x9906218b,
+		0x8bff74a6, 0x91a140b9, 0xe37c6ea3, 0x52de5611
+	},
+	{
+		0x519e0427, 0xdb84065d, 0xb863af57, 0xd69dda22,
+		0x6ad4bc18, 0x71bb07b4, 0xc29564f8, 0x41cdad11,
+		0x503cc09b, 0x7272b74c, 0x46ba501d, 0x72e4d2b6,
+		0x5033cca7, 0xf477717d, 0xf3df9d57, 0xfeeec42c
+	},
+	{
+		0xd34c847e, 0x8e6576bb, 0xd5de9a09, 0xccaeb5ee,
+		0xbf91842d, 0x604ca87d, 0x7de9e9ed, 0x363b9c74,
+		0x84919f51, 0x20e28af4, 0x7279a592, 0x8ea65e9c,
+		0xadec5331, 0x1df4b333, 0x0b1573df, 0x1b42a7c7
+	},
+	{
+		0x86af53ca, 0xe3cc6151, 0x609c485f, 0x3cbbe8d7,
+		0x2024de09, 0xed635088, 0x3ed70f65, 0x3b9b4f1c,
+		0x4e292129, 0x9c0b92e3, 0x137df53d, 0x4add5adc,
+		0xecdb4d15, 0x74bad233, 0x1a3d8634, 0x90610274
+	},
+	{
+		0x5dee2192, 0x20f89c80, 0x5cfb0642, 0x6919a925,
+		0xe8e3e133, 0x94a30525, 0x68585ed2, 0x66209c61,
+		0x6de12c85, 0x0c904364, 0xf0248824, 0xdac80d74,
+		0xf320f71f, 0x7b7fa943, 0xd5882c26, 0x0a244a2a
+	},
+	{
+		0xc6ee75b0, 0xa352a845, 0x4afafbab, 0x0d667013,
+		0x824a9c3f, 0xf2c9f8cc, 0x6671ea61, 0x1123ced9,
+		0xc4c0426b, 0xe2064c2b, 0x5dda8f0c, 0xae8a4ac7,
+		0x8b03f8d0, 0x4789d01e, 0x2fd8bec7, 0x6d8a6838
+	},
+	{
+		0xe418daad, 0x27326510, 0x625c8dda, 0x31c73944,
+		0x43030723, 0x32b46d0d, 0xcfd15d0c, 0x39a10292,
+		0x99961dea, 0x1ef74176, 0x175f71ee, 0xa0ba92f0,
+		0x08f50113, 0x33f788b2, 0x71a8271d, 0xfb83754a
+	},
+	{
+		0xbd26c6ae, 0x2c8ca159, 0xcccfc5a6, 0x843d7f20,
+		0x81fbacad, 0x03349ce1, 0x656b250f, 0xeb34ef6f,
+		0x0c299bce, 0x66e79036, 0x4ff14d30, 0xf50639f6,
+		0x1e49dd7a, 0x9b887542, 0xf0b88704, 0xa64bff59
+	},
+	{
+		0x03541f94, 0xb1a8e69a, 0x3dfed107, 0xce50f2c0,
+		0xedd8d48c, 0xe235cb04, 0xd14ff204, 0x06de6b81,
+		0xc4600a5e, 0x5ca05ca3, 0xdd87634b, 0x00aa7aa4,
+		0x4817fb86, 0xc00f85a4, 0xc3977369, 0xdad5c91c
+	},
+	{
+		0xb315365b, 0x0b25c598, 0xa33802f1, 0x4f9fbbf4,
+		0xdf1000b7, 0xf17bbaf7, 0x92ed176a, 0xd7f06111,
+		0xe9aed821, 0xe6d03f9e, 0xc3c2c608, 0x6479a7fb,
+		0x833fe7d0, 0x4d4ad114, 0x5dc730b9, 0x0633f165
+	},
+	{
+		0x8618edf1, 0x9cda05e2, 0xdbf91167, 0xd9bbbdf1,
+		0x5b3f7f24, 0x210e5999, 0x3290e994, 0x5556c6a3,
+		0xfd9d9264, 0xdfa4617f, 0xa4034316, 0x35f67e2c,
+		0xa6f5d2c1, 0xe732b3c2, 0xb6d666f1, 0x6384a08e
+	},
+	{
+		0x8939ca0b, 0xc5d60ab4, 0x9378f406, 0x95adebe4,
+		0x9718f642, 0x097b65a7, 0x8ea4a221, 0x93cb902b,
+		0x7b6d5fdb, 0xf072428c, 0xe51424d6, 0x7c4e4dbb,
+		0x2db584df, 0xeeea7c18, 0xe8141b67, 0xd3b0dc0a
+	},
+	{
+		0x289149a5, 0xea4c1463, 0xac879905, 0xf3fcccf2,
+		0xe13a9610, 0x2185dc73, 0xf3cf0208, 0xcd651aa7,
+		0x46927d66, 0xa481d874, 0x28198bba, 0x6a9a3c39,
+		0x3f54042d, 0xfc590faa, 0xb0ee6067, 0x10dd490f
+	},
+	{
+		0xd35d8953, 0x48ced071, 0x7e1eedbe, 0x867c3459,
+		0x1a074661, 0x36dc5ad7, 0x9e6861cb, 0x939ee1b7,
+		0x5b609c5b, 0x0e5e70eb, 0x28282282, 0xa8796969,
+		0x7ba8bb79, 0xc617bac6, 0x152dae15, 0x194a24f2
+	},
+	{
+		0xb852cdd7, 0x4511c44c, 0x975b995d, 0xeb6bf1dd,
+		0x572add8d, 0x2601f683, 0xd054b296, 0x21121447,
+		0x42cf0265, 0xf4f62401, 0xe3a79a2a, 0x6467317b,
+		0xaf927b35, 0xf04ed2d1, 0x6534b5a1, 0x8e96e1cf
+	},
+	{
+		0xf7158bea, 0x25b336a3, 0x27774720, 0x2c80a110,
+		0x0a0b4413, 0x14d2f6a4, 0x43d8d04a, 0x13a5bee3,
+		0xe4a44502, 0x93b68c5f, 0x364957b2, 0x5da5d14c,
+		0x26d8258c, 0x75168f8a, 0xeb43c098, 0xb455e8a4
+	},
+	{
+		0x0309488a, 0xf111b200, 0xed2e78be, 0x6dba1852,
+		0xc5f6a056, 0xa848d319, 0x8c4b59c2, 0xf1ae1709,
+		0x881bd57f, 0x757d507b, 0xed484551, 0xd7db6879,
+		0x8529cc2b, 0x0ce00c9c, 0xebd18ac3, 0xfb339802
+	},
+	{
+		0x19abcaf5, 0x9be634cc, 0x02919487, 0xc0eebac0,
+		0x3bd130b6, 0x9f1bfedd, 0x22d625c1, 0x24dab3a1,
+		0xb4206e3a, 0x46ab327c, 0x555042a3, 0x232d3373,
+		0x0eb9ea81, 0x8ddae1b5, 0xcb9f9e6d, 0xbe1cf505
+	},
+	{
+		0x455d0d81, 0x56643934, 0x73f8fcef, 0x10c24d59,
+		0xbb38a630, 0xa612c437, 0x92f1445e, 0x4ef9a80e,
+		0x1ee44719, 0xa9a648e2, 0x0d1dc166, 0x2f62feca,
+		0x97178ba3, 0x69c3d990, 0x9ff67325, 0xec8a3ad8
+	},
+	{
+		0xe746eaa6, 0x09d92a8e, 0x5c0b2593, 0xfe861385,
+		0x658b8eaf, 0x2696f3ff, 0x1a3c51e1, 0x896fcf1c,
+		0xfc538f16, 0x8d8e617e, 0x610922e6, 0x1cd3c38f,
+		0xd6eac1c9, 0x84c50345, 0xa4205d21, 0x61ff42c1
+	},
+	{
+		0x1d842031, 0x66d0eecb, 0xa5aedbc6, 0xafa9c66e,
+		0xfaad16d1, 0x67515b87, 0x15840989, 0xd827c8b4,
+		0xc8a420ed, 0x5e1b7bb1, 0xdc28e5bd, 0x8ea03cab,
+		0xd45188d7, 0xfc4d874f, 0xc22ecf90, 0x2f661c17
+	},
+	{
+		0xa37cfbfe, 0xdd8d54f8, 0xf8ffb4a9, 0x7b03cdfe,
+		0x24070df5, 0xca347052, 0x99bf4616, 0x0b659251,
+		0xee44254b, 0xce2e30d8, 0x415ba4f1, 0xa45c28fd,
+		0x5e8366aa, 0xcc31d2bf, 0x59b2f313, 0x8e249aeb
+	},
+	{
+		0x9361cf42, 0xa423dc88, 0xca111dd0, 0x25953391,
+		0x4509733e, 0xcd1bf722, 0x5e552eae, 0x62a8f8a7,
+		0x4dfb5704, 0xa6a1a79c, 0xa2abc546, 0x215f2de4,
+		0x4dcca7d6, 0xee3ede74, 0x493ed75f, 0xbbd935cd
+	},
+	{
+		0x8c935e5f, 0x3680071a, 0xf58543c1, 0x7d764e91,
+		0xee52df5e, 0x4db687f0, 0xfecf1d1d, 0x7ead1e20,
+		0x5fe9a684, 0x453cb994, 0xb65bb00a, 0x1ca6c43f,
+		0xd51630d5, 0x99039a8a, 0x97c7d645, 0x0ca741ed
+	},
+	{
+		0xc4268106, 0x0ea0ef30, 0x9827ed70, 0x9037b2f3,
+		0x583f6310, 0xc3db4e2f, 0x2ab10678, 0x10a3f54b,
+		0x706e16c5, 0x7097dd2b, 0xaf165242, 0xd4770a89,
+		0x370e1411, 0x9514515e, 0x0da518ef, 0xad237305
+	},
+	{
+		0x336f30c4, 0x5999001a, 0x504b641a, 0x4d8b3c3b,
+		0x31696b82, 0x3a1a5507, 0xe650fe2b, 0x605a5fd0,
+		0x4624ad94, 0xe45bcf34, 0x42ff1bcf, 0x360522e1,
+		0x0583b20b, 0x0ec6913b, 0xa3e4a361, 0x87004ddc
+	},
+	{
+		0x18ac6f86, 0x63dfc0b7, 0xd0531de8, 0xe2fb9537,
+		0xd0136ae3, 0x481eaf13, 0x8e4bd2f7, 0xe01af14a,
+		0x88f974ec, 0x49ee4f9f, 0x92aef323, 0xd764a4c6,
+		0x1e03afa9, 0x443cb43f, 0x736e1021, 0xc0c7bf9e
+	},
+	{
+		0x479f4bfe, 0x9b0d9abb, 0x5e3c4768, 0x3e790d21,
+		0x375c643c, 0xa3ad44cd, 0x6ac0dc43, 0x9dfbbb65,
+		0x55c762ec, 0xda6ffb79, 0xde78a5e1, 0x12294f31,
+		0x4d704863, 0x0ae22c68, 0x6c18c02e, 0x61114035
+	},
+	{
+		0xc7ab8183, 0x06750a2a, 0x97f4eb7b, 0x042dd3d6,
+		0x3d0efa7a, 0x4cc4d792, 0xd9793753, 0xff36e487,
+		0x4e06e132, 0x104dff63, 0x6d1706fe, 0x9773ae26,
+		0x3ffebb01, 0x97299181, 0xdfc694ff, 0x59006dc6
+	},
+	{
+		0x3df40f6f, 0xe6fad49d, 0xcca526f5, 0x885dd6df,
+		0x4a1807a1, 0xc0b00e7c, 0x3404d5a1, 0x3fecd70b,
+		0x6782d8d7, 0xe77bfe48, 0x7155ec7d, 0x54ab18c9,
+		0xb3202407, 0x77cdb71f, 0x67ba5604, 0x8441556c
+	},
+	{
+		0x05f4cc58, 0x75a1590c, 0xa69f58c8, 0x43f076bc,
+		0x79786c3a, 0x8ada939b, 0x95a50c0a, 0x3a758d61,
+		0xba2155ef, 0x22348461, 0xebfe41ad, 0x5985f593,
+		0x91fb5cf7, 0xadffad55, 0xe54e241c, 0xb8891adc
+	},
+	{
+		0x7f42a1bf, 0x26f1caf3, 0x82f27586, 0xcabd266e,
+		0x6af484f4, 0x0971375b, 0x0a43e6fa, 0xabf356cc,
+		0x91c5e0f8, 0xc7b50396, 0x3a8efac5, 0xbaf618fe,
+		0x15a2316f, 0xcb21fe99, 0x0f2635d3, 0x1565ca3b
+	},
+	{
+		0x7c092020, 0x954e5fa8, 0x99a7318d, 0x06591ec9,
+		0x6fc3ea5b, 0xc3506151, 0xda3e40c7, 0xcfb13598,
+		0x826f6eb1, 0xb447cc06, 0xcc4b15bb, 0xb9176be6,
+		0xc61599ec, 0x0204e321, 0x4e9fce6b, 0x66512cbd
+	},
+	{
+		0x012ddf9f, 0x2798852b, 0xbf4fcb96, 0xd5539be9,
+		0xb08c6b69, 0x198a79b9, 0xa37060d9, 0xe23bd3cb,
+		0x68a6a401, 0xcc7f52c9, 0x57091704, 0xdf697f4b,
+		0x7514abbe, 0xc429b0b8, 0x3212ca5b, 0x9dfd8b3f
+	},
+	{
+		0xabbfe286, 0x4af25ce1, 0xfcdeed1a, 0xa53341c7,
+		0xcd20e76d, 0xcb1d3464, 0x4ab23d35, 0x56decf3e,
+		0xe524aafb, 0xdd832027, 0x05a43863, 0xee102be5,
+		0xd463f935, 0xf9a6bffa, 0x44f43b95, 0xc49eae38
+	},
+	{
+		0xe7753698, 0x8d15f49d, 0x166245dd, 0xb1d6f20c,
+		0x92eea7b3, 0x998ac40b, 0x0c3c0922, 0xe5c81e0b,
+		0x85a9e76a, 0xf65ca633, 0x88a56acd, 0x2779b4b3,
+		0xeefb0c07, 0x405ba189, 0xa7d62d55, 0x6591e281
+	},
+	{
+		0xa47c229b, 0xf5a4aa87, 0x1136ee1b, 0x19dc19b9,
+		0x51e08c26, 0x1d5ded4c, 0x4f85d804, 0x41ab4614,
+		0x738106ca, 0xf02dd1d4, 0x2ab68aff, 0x20cc8ff4,
+		0x3c3ce367, 0xc1c053e7, 0x33f9e08d, 0x48517644
+	},
+	{
+		0xb792fbec, 0x587c5da0, 0xee9e8acb, 0x5986356b,
+		0x24e55c73, 0xfaa63b4d, 0x4c985649, 0xcefb8440,
+		0x540926df, 0x1c20fe34, 0x79c38de9, 0x6204487e,
+		0x5881270e, 0x7b5348a9, 0x0767a863, 0xa40c8baf
+	},
+	{
+		0x7fbef628, 0xc3c2b412, 0x0008abb4, 0xa69c7756,
+		0xdd3a1376, 0x3f52438e, 0x7688a086, 0x3a6f4c49,
+		0x126f5476, 0x8dca1641, 0x5e790b59, 0x7de645ce,
+		0x45125197, 0x5b51a327, 0xf79973fb, 0x796aba23
+	},
+	{
+		0xd347feca, 0x89eb1b96, 0xcda31e4a, 0xc8c78f4f,
+		0x9b5ebee5, 0x9948cc8c, 0x6f69b457, 0x56952543,
+		0xdaa7367a, 0x6a3b3ef7, 0x3eae86cd, 0x2becf2d4,
+		0x8a9bcb17, 0x663509a6, 0xbbbbc36e, 0xc670543e
+	},
+	{
+		0x9099b9c9, 0x4131bfd0, 0xeb850dda, 0x3bf11e70,
+		0xb34f5321, 0x422705c3, 0x082e4d79, 0x21ba3c52,
+		0xe427ebe9, 0x76a27c83, 0x5eeb87b8, 0x2e1d8cd4,
+		0x72955119, 0xecfaa6e5, 0x077cbc91, 0xa2d7916c
+	},
+	{
+		0xaf5cab24, 0x6fcde854, 0x467a04b7, 0xd4e8aa74,
+		0x7bcf3d2c, 0x14d14d59, 0xa0abcaae, 0xc56d84f7,
+		0xe9ec1dd7, 0x937608b1, 0x867114f6, 0xdf5054eb,
+		0x6ddf93a6, 0x6b013bc5, 0xdd3e48fc, 0x5bff4f05
+	},
+	{
+		0x7d6de321, 0x0bc91e66, 0x7469772e, 0xfae8dd8f,
+		0x4ef060b6, 0x61eaa825, 0xddb31399, 0xf46bad95,
+		0xc21213c9, 0x92708587, 0x7d09eb1c, 0x11d287d0,
+		0x6ea52f68, 0xa79815d8, 0xeddb10a7, 0xb54bb792
+	},
+	{
+		0x4b037401, 0xee0af6df, 0xf4b85d2d, 0x55cd3618,
+		0x493fb0dc, 0x4ea35646, 0x81bd0405, 0xadfceaf6,
+		0x5b1ddf0d, 0x342df99f, 0x605d3bb9, 0x2fe483a7,
+		0x639e33d9, 0xdaadd46a, 0x91623d28, 0x9b4daab1
+	},
+	{
+		0x0b89d4bd, 0x048df69b, 0xb70fba85, 0x222888ef,
+		0xcce017f6, 0x44a0c5f6, 0xc264855c, 0xebc469d8,
+		0xd7cb56bb, 0xb6420b9d, 0xea5f6aec, 0x24f72349,
+		0x86efe6a9, 0xe35956d8, 0x4b12634f, 0xbae5fb78
+	},
+	{
+		0x778189c5, 0xc0c38d52, 0xa201226f, 0x68f81bc5,
+		0x35e974ba, 0x890e8ba3, 0x9b23a1d3, 0xb6634418,
+		0xda3b7af3, 0x7cde9e81, 0x6ca457e4, 0xd7e854a2,
+		0x8e7a3d5e, 0x6d2992bc, 0xd1da4558, 0xc85b3262
+	},
+	{
+		0xde1300a9, 0x61f97d99, 0x83953873, 0x41841225,
+		0xdb0c465c, 0x9f249e32, 0xdc2447be, 0xefa5ceed,
+		0x6c191d51, 0x9ab30d9a, 0x9005b6a4, 0xdbf4dded,
+		0x00e670fe, 0x90bd6b03, 0xc8efd72e, 0x2b961781
+	},
+	{
+		0x39f81c9e, 0xe86e9a3d, 0x7783946a, 0xb47a9004,
+		0x541cb355, 0x72ba430f, 0xac3fdf37, 0x5b8ee3fa,
+		0x635ae687, 0xdf371fda, 0xd30bc7d3, 0x75429f37,
+		0x0a90fb23, 0xc0d58d9b, 0xac1d5e95, 0x59575436
+	},
+	{
+		0x05a0af19, 0x64777efc, 0x6292ac20, 0xc3cda2ed,
+		0x640d9419, 0xf25592e5, 0xb4bb2e1f, 0x5308b91d,
+		0xbf1444ce, 0xbc5d3721, 0xed42874a, 0xe4b6bd8c,
+		0xabae0290, 0x2d50b9af, 0x47c018ab, 0x6b64bf26
+	},
+	{
+		0x0c4a3b64, 0xe88f54d3, 0xce1c832d, 0xf7615b0d,
+		0x973d58fe, 0x2f67adb0, 0xc3cef173, 0xb2871e1c,
+		0x7a97569e, 0xed83d2a2, 0xab59d53a, 0xd11912b4,
+		0xa435918d, 0x10764c79, 0xef2764c3, 0xca537a69
+	},
+	{
+		0x06589232, 0x5a6fda9d, 0x560e6363, 0x967f03d6,
+		0x6176fe56, 0x8913e989, 0x543db0ef, 0xacb44d40,
+		0x8e895b40, 0xab0e252a, 0xd42959e6, 0xab32c974,
+		0x44a05ad1, 0xbc3f7e15, 0x6511572e, 0x65271ba1
+	},
+	{
+		0x37b6d3ee, 0x4f31f586, 0x74ac2be8, 0x4f6a0343,
+		0xc47589cc, 0x6cb479f4, 0xc8dea1b6, 0x34f06e15,
+		0x053e171b, 0xe091b4dd, 0x240fdd1f, 0x6989fd6d,
+		0x9ff2123f, 0xde25a063, 0x513a6da1, 0x0e04bcc9
+	},
+	{
+		0x564efa22, 0x2be3f5f5, 0x1ee27deb, 0xc5f4cef5,
+		0x0e25bd0d, 0x3b239e56, 0x9bf10706, 0xdaf3f4f1,
+		0x5b919a7d, 0x788294b5, 0xbf83cb15, 0x1bc79c9e,
+		0x1e312dcb, 0xe0642403, 0x051194cd, 0x7ffa38df
+	}
+};
+
+#elif uECC_COMB_WIDTH != 0
+#error "uECC_COMB_WIDTH must be 0, 5, 6, 7 or 8"
+#endif
@@ -103,12 +103,14 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 
 	uECC_word_t tmp[NUM_ECC_WORDS];
 	uECC_word_t s[NUM_ECC_WORDS];
-	uECC_word_t *k2[2] = {tmp, s};
 	uECC_word_t p[NUM_ECC_WORDS * 2];
-	uECC_word_t carry;
 	wordcount_t num_words = curve->num_words;
 	wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
+#if uECC_COMB_WIDTH == 0
+	uECC_word_t *k2[2] = {tmp, s};
+	uECC_word_t carry;
 	bitcount_t num_n_bits = curve->num_n_bits;
+#endif
 
 	/* Make sure 0 < k < curve_n */
   	if (uECC_vli_isZero(k, num_words) ||
@@ -116,8 +118,12 @@ int uECC_sign_with_k(const uint8_t *private_key, const uint8_t *message_hash,
 		return 0;
 	}
 
+#if uECC_COMB_WIDTH > 0
+	EccPoint_mult_base(p, k, curve);
+#else
 	carry = regularize_k(k, tmp, s, curve);
 	EccPoint_mult(p, curve->G, k2[!carry], 0, num_n_bits + 1, curve);
+#endif
 	if (uECC_vli_isZero(p, num_words)) {
 		return 0;
 	}
@@ -184,10 +190,116 @@ int uECC_sign(const uint8_t *private_key, const uint8_t *message_hash,
 	return 0;
 }
 
+#if uECC_COMB_WIDTH > 0
+/* Width of the signed digits of u2 in uECC_verify(), and number of odd
+ * multiples of the public key precomputed for them: Q, 3Q, 5Q, 7Q. */
+#define VERIFY_WNAF_WIDTH 4
+#define VERIFY_WNAF_POINTS (1 << (VERIFY_WNAF_WIDTH - 2))
+
+/* Recodes u into width-w NAF: digit i is 0 or odd, between -(2^(w-1) - 1) and
+ * 2^(w-1) - 1, and stands for digit * 2^i. Returns the number of digits.
+ * u is public, so this does not need to run in constant time. */
+static bitcount_t wnaf_recode(int8_t *naf, const uECC_word_t *u,
+			      wordcount_t num_words)
+{
+	bitcount_t num_bits = uECC_vli_numBits(u, num_words);
+	bitcount_t i = 0;
+	bitcount_t j;
+	int carry = 0;
+	int window;
+
+	while (i < num_bits || carry) {
+		if ((i < num_bits && uECC_vli_testBit(u, i)) == carry) {
+			naf[i++] = 0;
+			continue;
+		}
+
+		/* odd: take the next w bits, as a negative digit if the top one is
+		 * set, in which case 2^w is carried to the bits above */
+		window = carry;
+		for (j = 0; j < VERIFY_WNAF_WIDTH; ++j) {
+			if (i + j < num_bits && uECC_vli_testBit(u, i + j)) {
+				window += 1 << j;
+			}
+		}
+		carry = (window >> (VERIFY_WNAF_WIDTH - 1)) & 1;
+		naf[i] = (int8_t)(window - (carry << VERIFY_WNAF_WIDTH));
+		for (j = 1; j < VERIFY_WNAF_WIDTH; ++j) {
+			naf[i + j] = 0;
+		}
+		i += VERIFY_WNAF_WIDTH;
+	}
+	return i;
+}
+
+/* Computes the affine points Q, 3Q, 5Q, ... Each is 2Q added to the previous
+ * one with co-Z additions, which keep 2Q on the same Z, so that a single
+ * inversion gives the Z of every point. */
+static void wnaf_precompute(uECC_word_t table[][NUM_ECC_WORDS * 2],
+			    const uECC_word_t *point, uECC_Curve curve)
+{
+	uECC_word_t lambda[VERIFY_WNAF_POINTS][NUM_ECC_WORDS];
+	uECC_word_t dx[NUM_ECC_WORDS];
+	uECC_word_t dy[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
+	wordcount_t num_words = curve->num_words;
+	int i;
+
+	/* D = 2Q, in Z_0: */
+	uECC_vli_set(dx, point, num_words);
+	uECC_vli_set(dy, point + num_words, num_words);
+	uECC_vli_clear(z, num_words);
+	z[0] = 1;
+	curve->double_jacobian(dx, dy, z, curve);
+
+	/* table[i] = (2i + 1)Q, in Z_i = Z_(i-1) * lambda_i: */
+	uECC_vli_set(table[0], point, num_words * 2);
+	uECC_vli_set(table[1], point, num_words * 2);
+	apply_z(table[1], table[1] + num_words, z, curve);
+	for (i = 1; i < VERIFY_WNAF_POINTS; ++i) {
+		if (i > 1) {
+			uECC_vli_set(table[i], table[i - 1], num_words * 2);
+		}
+		uECC_vli_modSub(lambda[i], table[i], dx, curve->p, num_words);
+		XYcZ_add(dx, dy, table[i], table[i] + num_words, curve);
+		uECC_vli_modMult_fast(z, z, lambda[i], curve);
+	}
+
+	/* z = Z_(n-1); walk back with 1/Z_(i-1) = lambda_i / Z_i: */
+	uECC_vli_modInv(z, z, curve->p, num_words);
+	for (i = VERIFY_WNAF_POINTS - 1; i > 0; --i) {
+		apply_z(table[i], table[i] + num_words, z, curve);
+		uECC_vli_modMult_fast(z, z, lambda[i], curve);
+	}
+}
+
+/* Adds the affine point to (rx, ry, z), or sets it if empty is set. */
+static void add_affine(uECC_word_t *rx, uECC_word_t *ry, uECC_word_t *z,
+		       uECC_word_t *point, int *empty, uECC_Curve curve)
+{
+	uECC_word_t tz[NUM_ECC_WORDS];
+	wordcount_t num_words = curve->num_words;
+
+	if (*empty) {
+		uECC_vli_set(rx, point, num_words);
+		uECC_vli_set(ry, point + num_words, num_words);
+		uECC_vli_clear(z, num_words);
+		z[0] = 1;
+		*empty = 0;
+		return;
+	}
+
+	apply_z(point, point + num_words, z, curve);
+	uECC_vli_modSub(tz, rx, point, curve->p, num_words); /* Z = x2 - x1 */
+	XYcZ_add(point, point + num_words, rx, ry, curve);
+	uECC_vli_modMult_fast(z, z, tz, curve);
+}
+#else
 static bitcount_t smax(bitcount_t a, bitcount_t b)
 {
 	return (a > b ? a : b);
 }
+#endif
 
 int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 		unsigned hash_size, const uint8_t *signature,
@@ -196,16 +308,26 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 
 	uECC_word_t u1[NUM_ECC_WORDS], u2[NUM_ECC_WORDS];
 	uECC_word_t z[NUM_ECC_WORDS];
-	uECC_word_t sum[NUM_ECC_WORDS * 2];
 	uECC_word_t rx[NUM_ECC_WORDS];
 	uECC_word_t ry[NUM_ECC_WORDS];
+	bitcount_t i;
+#if uECC_COMB_WIDTH > 0
+	uECC_word_t table[VERIFY_WNAF_POINTS][NUM_ECC_WORDS * 2];
+	uECC_word_t point[NUM_ECC_WORDS * 2];
+	uint16_t digits[uECC_COMB_COLUMNS + 1];
+	int8_t naf[NUM_ECC_WORDS * uECC_WORD_BITS + VERIFY_WNAF_WIDTH];
+	bitcount_t num_digits;
+	int use_comb;
+	int empty;
+#else
+	uECC_word_t sum[NUM_ECC_WORDS * 2];
 	uECC_word_t tx[NUM_ECC_WORDS];
 	uECC_word_t ty[NUM_ECC_WORDS];
 	uECC_word_t tz[NUM_ECC_WORDS];
 	const uECC_word_t *points[4];
 	const uECC_word_t *point;
 	bitcount_t num_bits;
-	bitcount_t i;
+#endif
 
 	uECC_word_t _public[NUM_ECC_WORDS * 2];
 	uECC_word_t r[NUM_ECC_WORDS], s[NUM_ECC_WORDS];
@@ -240,6 +362,44 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 	uECC_vli_modMult(u1, u1, z, curve->n, num_n_words); /* u1 = e/s */
 	uECC_vli_modMult(u2, r, z, curve->n, num_n_words); /* u2 = r/s */
 
+#if uECC_COMB_WIDTH > 0
+	/* Calculate u1*G + u2*Q in one chain of doublings (Straus). The comb digits
+	 * of u1 are added in the last rounds, where the doublings left give them
+	 * their weight, and the wNAF digits of u2 use odd multiples of Q. */
+	use_comb = !uECC_vli_isZero(u1, num_n_words);
+	if (use_comb) {
+		EccPoint_comb_recode(digits, u1, curve);
+	}
+	num_digits = wnaf_recode(naf, u2, num_n_words);
+	wnaf_precompute(table, _public, curve);
+
+	i = num_digits - 1;
+	if (use_comb && i < uECC_COMB_COLUMNS) {
+		i = uECC_COMB_COLUMNS;
+	}
+	empty = 1;
+
+	for (; i >= 0; --i) {
+		if (!empty) {
+			curve->double_jacobian(rx, ry, z, curve);
+		}
+
+		if (use_comb && i <= uECC_COMB_COLUMNS) {
+			EccPoint_comb_select(point, digits[i], curve);
+			add_affine(rx, ry, z, point, &empty, curve);
+		}
+
+		if (i < num_digits && naf[i] != 0) {
+			uECC_vli_set(point, table[(naf[i] < 0 ? -naf[i] : naf[i]) >> 1],
+				     num_words * 2);
+			if (naf[i] < 0) {
+				uECC_vli_sub(point + num_words, curve->p, point + num_words,
+					     num_words);
+			}
+			add_affine(rx, ry, z, point, &empty, curve);
+		}
+	}
+#else
 	/* Calculate sum = G + Q. */
 	uECC_vli_set(sum, _public, num_words);
 	uECC_vli_set(sum + num_words, _public + num_words, num_words);
@@ -280,6 +440,7 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 			uECC_vli_modMult_fast(z, z, tz, curve);
 		}
   	}
+#endif
 
 	uECC_vli_modInv(z, z, curve->p, num_words); /* Z = 1/Z */
 	apply_z(rx, ry, z, curve);
@@ -39,6 +39,7 @@
  * - AES128 NIST encryption test
  * - AES128 NIST fixed-key and variable-text
  * - AES128 NIST variable-key and fixed-text
+ * - AES128 NIST SP 800-38a ECB blocks encrypted in place with one call
  */
 
 #include <tinycrypt/aes.h>
@@ -2036,6 +2037,59 @@ int test_4(void)
 	return result;
 }
 
+/*
+ * NIST SP 800-38a ECB-AES128 encryption, all blocks in place with one call.
+ */
+int test_5(void)
+{
+	int result = TC_PASS;
+	const uint8_t nist_key[NUM_OF_NIST_KEYS] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+	};
+	const uint8_t nist_input[4 * NUM_OF_NIST_KEYS] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+		0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+		0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+	};
+	const uint8_t expected[4 * NUM_OF_NIST_KEYS] = {
+		0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60,
+		0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97,
+		0xf5, 0xd3, 0xd5, 0x85, 0x03, 0xb9, 0x69, 0x9d,
+		0xe7, 0x85, 0x89, 0x5a, 0x96, 0xfd, 0xba, 0xaf,
+		0x43, 0xb1, 0xcd, 0x7f, 0x59, 0x8e, 0xce, 0x23,
+		0x88, 0x1b, 0x00, 0xe3, 0xed, 0x03, 0x06, 0x88,
+		0x7b, 0x0c, 0x78, 0x5e, 0x27, 0xe8, 0xad, 0x3f,
+		0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5d, 0xd4
+	};
+	struct tc_aes_key_sched_struct s;
+	uint8_t data[4 * NUM_OF_NIST_KEYS];
+
+	TC_PRINT("AES128 %s (NIST ECB blocks test):\n", __func__);
+
+	(void)tc_aes128_set_encrypt_key(&s, nist_key);
+	(void)memcpy(data, nist_input, sizeof(data));
+	if (tc_aes_encrypt_blocks(data, data, 4, &s) == 0) {
+		TC_ERROR("AES128 %s (NIST ECB blocks test) failed.\n",
+			 __func__);
+		result = TC_FAIL;
+		goto exitTest5;
+	}
+
+	result = check_result(5, expected, sizeof(expected), data,
+			      sizeof(data));
+
+exitTest5:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -2067,6 +2121,11 @@ int main(void)
 			 "failed.\n");
 		goto exitTest;
 	}
+	result = test_5();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("AES128 test #5 (NIST ECB blocks test) failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("All AES128 tests succeeded!\n");
 
@@ -36,6 +36,8 @@
 
   Scenarios tested include:
   - AES128 CTR mode encryption SP 800-38a tests
+  - AES128 CTR mode in place, over several keystream batches and a counter
+    wrap, against the block cipher applied to each counter
 */
 
 #include <tinycrypt/ctr_mode.h>
@@ -113,6 +115,66 @@ unsigned int test_1_and_2(void)
         return result;
 }
 
+/*
+ * CTR in place over a buffer longer than a keystream batch, not a multiple of
+ * the block size, and wrapping the 32-bit counter.
+ */
+unsigned int test_3(void)
+{
+        const uint8_t key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+		0x09, 0xcf, 0x4f, 0x3c
+        };
+        const uint8_t ctr_start[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0xff, 0xff, 0xff, 0xfd
+        };
+        const uint8_t ctr_end[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+		0x00, 0x00, 0x00, 0x04
+        };
+        struct tc_aes_key_sched_struct sched;
+        uint8_t ctr[16];
+        uint8_t block[16];
+        uint8_t data[103];
+        uint8_t expected[103];
+        unsigned int result = TC_PASS;
+        unsigned int i;
+
+        TC_PRINT("CTR test #3 (in place, several batches, counter wrap):\n");
+        (void)tc_aes128_set_encrypt_key(&sched, key);
+
+        (void)memcpy(ctr, ctr_start, sizeof(ctr));
+        for (i = 0; i < sizeof(data); ++i) {
+                data[i] = (uint8_t)(i * 7);
+                if ((i % TC_AES_BLOCK_SIZE) == 0) {
+                        (void)tc_aes_encrypt(block, ctr, &sched);
+                        if (++ctr[15] == 0 && ++ctr[14] == 0 && ++ctr[13] == 0) {
+                                ++ctr[12];
+                        }
+                }
+                expected[i] = data[i] ^ block[i % TC_AES_BLOCK_SIZE];
+        }
+
+        (void)memcpy(ctr, ctr_start, sizeof(ctr));
+        if (tc_ctr_mode(data, sizeof(data), data, sizeof(data), ctr,
+                        &sched) == 0) {
+                TC_ERROR("CTR test #3 failed in %s.\n", __func__);
+                result = TC_FAIL;
+                goto exitTest3;
+        }
+
+        result = check_result(3, expected, sizeof(expected), data, sizeof(data));
+        if (result == TC_PASS) {
+                result = check_result(3, ctr_end, sizeof(ctr_end), ctr,
+                                      sizeof(ctr));
+        }
+
+ exitTest3:
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -130,6 +192,12 @@ int main(void)
                 goto exitTest;
         }
 
+        result = test_3();
+        if (result == TC_FAIL) { /* terminate test */
+                TC_ERROR("CTR test #3 failed.\n");
+                goto exitTest;
+        }
+
         TC_PRINT("All CTR tests succeeded!\n");
 
  exitTest:
@@ -143,6 +143,14 @@ size_t IotNetworkAfr_Send( void * pConnection,
                            const uint8_t * pMessage,
                            size_t messageLength );
 
+/**
+ * @brief An implementation of #IotNetworkInterface_t::sendv for FreeRTOS
+ * Secure Sockets.
+ */
+size_t IotNetworkAfr_Sendv( void * pConnection,
+                            const IotNetworkSegment_t * pSegments,
+                            size_t segmentCount );
+
 /**
  * @brief An implementation of #IotNetworkInterface_t::receive for FreeRTOS
  * Secure Sockets.
@@ -0,0 +1,416 @@
+/*
+ * FreeRTOS Platform V1.1.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_metrics_histogram.c
+ * @brief Latency histograms and counters of the platform metrics component.
+ *
+ * The members of a histogram are updated with atomic operations, except for
+ * the 64-bit sum, which is updated in a critical section as short as one
+ * atomic operation. Recording a latency never blocks the task that measured it.
+ */
+
+/* The config header is always included first. */
+#include "iot_config.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Metrics include. */
+#include "platform/iot_metrics.h"
+
+#if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+
+/* FreeRTOS includes. */
+    #include "FreeRTOS.h"
+    #include "task.h"
+
+/* Atomics include. */
+    #include "iot_atomic.h"
+
+/**
+ * @brief The members of a histogram, updated with atomic operations.
+ */
+    typedef struct _metricsHistogram
+    {
+        uint32_t volatile count;                                     /**< @brief The number of latencies recorded. */
+        uint64_t volatile sumUs;                                     /**< @brief The sum of the latencies recorded. */
+        uint32_t volatile maxUs;                                     /**< @brief The largest latency recorded. */
+        uint32_t volatile pBuckets[ IOT_METRICS_HISTOGRAM_BUCKETS ]; /**< @brief The number of latencies in each bucket. */
+    } _metricsHistogram_t;
+
+/*------------------- Global Variables ------------------------*/
+
+/**
+ * @brief The histograms, indexed by #IotMetricsHistogram_t.
+ */
+    static _metricsHistogram_t _histograms[ IOT_METRICS_HISTOGRAM_COUNT ] = { 0 };
+
+/**
+ * @brief The counters, indexed by #IotMetricsCounter_t.
+ */
+    static uint32_t volatile _counters[ IOT_METRICS_COUNTER_COUNT ] = { 0 };
+
+/**
+ * @brief The names of the histograms, indexed by #IotMetricsHistogram_t.
+ */
+    static const char * const _pHistogramNames[ IOT_METRICS_HISTOGRAM_COUNT ] =
+    {
+        "mqtt_operation_us",
+        "taskpool_queue_wait_us",
+        "taskpool_run_us",
+        "tls_handshake_us",
+        "tls_send_us",
+        "tls_receive_us",
+        "https_request_send_us",
+        "https_response_wait_us",
+        "https_response_body_us",
+        "ota_block_us"
+    };
+
+/**
+ * @brief The names of the counters, indexed by #IotMetricsCounter_t.
+ */
+    static const char * const _pCounterNames[ IOT_METRICS_COUNTER_COUNT ] =
+    {
+        "mqtt_operation_failures",
+        "tls_handshake_failures",
+        "tls_sessions_resumed",
+        "https_request_failures",
+        "ota_duplicate_blocks",
+        "ota_requests_lost"
+    };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the bucket of a latency, which is the position of its highest
+ * set bit.
+ *
+ * @param[in] latencyUs The latency in microseconds.
+ *
+ * @return The index of the bucket.
+ */
+    static uint32_t _bucketIndex( uint32_t latencyUs )
+    {
+        uint32_t index = 0;
+        uint32_t shift = 16;
+
+        /* Binary search for the highest set bit. */
+        while( shift > 0U )
+        {
+            if( ( latencyUs >> shift ) != 0U )
+            {
+                latencyUs >>= shift;
+                index += shift;
+            }
+
+            shift >>= 1;
+        }
+
+        if( index >= ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS )
+        {
+            index = ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS - 1U;
+        }
+
+        return index;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the largest latency counted by a bucket.
+ *
+ * @param[in] index The index of the bucket.
+ *
+ * @return The largest latency in microseconds.
+ */
+    static uint32_t _bucketUpperBound( uint32_t index )
+    {
+        uint32_t upperBound = UINT32_MAX;
+
+        if( ( index < 31U ) && ( index < ( ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS - 1U ) ) )
+        {
+            upperBound = ( ( uint32_t ) 2U << index ) - 1U;
+        }
+
+        return upperBound;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotMetrics_RecordLatency( IotMetricsHistogram_t histogram,
+                                   uint32_t latencyUs )
+    {
+        _metricsHistogram_t * pHistogram = NULL;
+        uint32_t maxUs = 0;
+
+        if( ( uint32_t ) histogram < ( uint32_t ) IOT_METRICS_HISTOGRAM_COUNT )
+        {
+            pHistogram = &( _histograms[ histogram ] );
+
+            ( void ) Atomic_Increment_u32( &( pHistogram->pBuckets[ _bucketIndex( latencyUs ) ] ) );
+
+            /* A 32-bit sum would wrap after 71 minutes of latencies, and there
+             * is no 64-bit atomic addition. */
+            taskENTER_CRITICAL();
+            {
+                pHistogram->sumUs += latencyUs;
+            }
+            taskEXIT_CRITICAL();
+
+            ( void ) Atomic_Increment_u32( &( pHistogram->count ) );
+
+            /* Raise the maximum if this latency passed it. */
+            maxUs = pHistogram->maxUs;
+
+            while( ( latencyUs > maxUs ) &&
+                   ( Atomic_CompareAndSwap_u32( &( pHistogram->maxUs ),
+                                                latencyUs,
+                                                maxUs ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+            {
+                maxUs = pHistogram->maxUs;
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotMetrics_IncrementCounter( IotMetricsCounter_t counter )
+    {
+        if( ( uint32_t ) counter < ( uint32_t ) IOT_METRICS_COUNTER_COUNT )
+        {
+            ( void ) Atomic_Increment_u32( &( _counters[ counter ] ) );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool IotMetrics_GetHistogram( IotMetricsHistogram_t histogram,
+                                  IotMetricsHistogramData_t * pHistogram )
+    {
+        bool status = false;
+        uint32_t i = 0;
+
+        if( ( uint32_t ) histogram < ( uint32_t ) IOT_METRICS_HISTOGRAM_COUNT )
+        {
+            pHistogram->count = _histograms[ histogram ].count;
+
+            taskENTER_CRITICAL();
+            {
+                pHistogram->sumUs = _histograms[ histogram ].sumUs;
+            }
+            taskEXIT_CRITICAL();
+
+            pHistogram->maxUs = _histograms[ histogram ].maxUs;
+
+            for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS; i++ )
+            {
+                pHistogram->pBuckets[ i ] = _histograms[ histogram ].pBuckets[ i ];
+            }
+
+            status = true;
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    uint32_t IotMetrics_GetCounter( IotMetricsCounter_t counter )
+    {
+        uint32_t value = 0;
+
+        if( ( uint32_t ) counter < ( uint32_t ) IOT_METRICS_COUNTER_COUNT )
+        {
+            value = _counters[ counter ];
+        }
+
+        return value;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotMetrics_GetHistograms( void * pContext,
+                                   void ( * metricsCallback )( void *, const char *, const IotMetricsHistogramData_t * ) )
+    {
+        IotMetricsHistogramData_t histogram = { 0 };
+        uint32_t i = 0;
+
+        for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_COUNT; i++ )
+        {
+            ( void ) IotMetrics_GetHistogram( ( IotMetricsHistogram_t ) i, &histogram );
+
+            if( histogram.count > 0U )
+            {
+                metricsCallback( pContext, _pHistogramNames[ i ], &histogram );
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    uint32_t IotMetrics_Percentile( const IotMetricsHistogramData_t * pHistogram,
+                                    uint32_t percentile )
+    {
+        uint32_t latencyUs = 0;
+        uint32_t total = 0, rank = 0, seen = 0, i = 0;
+
+        /* The count is not used because it may not match the buckets of a
+         * histogram copied while a latency was being recorded. */
+        for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS; i++ )
+        {
+            total += pHistogram->pBuckets[ i ];
+        }
+
+        if( total > 0U )
+        {
+            if( percentile > 100U )
+            {
+                percentile = 100U;
+            }
+
+            /* Nearest rank, computed in 64 bits so that it cannot overflow. */
+            rank = ( uint32_t ) ( ( ( ( uint64_t ) total * percentile ) + 99U ) / 100U );
+
+            if( rank == 0U )
+            {
+                rank = 1U;
+            }
+
+            for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS; i++ )
+            {
+                seen += pHistogram->pBuckets[ i ];
+
+                if( seen >= rank )
+                {
+                    break;
+                }
+            }
+
+            latencyUs = _bucketUpperBound( i );
+
+            if( latencyUs > pHistogram->maxUs )
+            {
+                latencyUs = pHistogram->maxUs;
+            }
+        }
+
+        return latencyUs;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotMetrics_ResetHistograms( void )
+    {
+        uint32_t i = 0, j = 0;
+
+        for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_COUNT; i++ )
+        {
+            for( j = 0; j < ( uint32_t ) IOT_METRICS_HISTOGRAM_BUCKETS; j++ )
+            {
+                _histograms[ i ].pBuckets[ j ] = 0U;
+            }
+
+            _histograms[ i ].count = 0U;
+
+            taskENTER_CRITICAL();
+            {
+                _histograms[ i ].sumUs = 0U;
+            }
+            taskEXIT_CRITICAL();
+
+            _histograms[ i ].maxUs = 0U;
+        }
+
+        for( i = 0; i < ( uint32_t ) IOT_METRICS_COUNTER_COUNT; i++ )
+        {
+            _counters[ i ] = 0U;
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    size_t IotMetrics_PrintHistograms( char * pBuffer,
+                                       size_t bufferSize )
+    {
+        IotMetricsHistogramData_t histogram = { 0 };
+        size_t length = 0;
+        int lineLength = 0;
+        uint32_t i = 0;
+
+        if( bufferSize > 0U )
+        {
+            pBuffer[ 0 ] = '\0';
+
+            for( i = 0; i < ( uint32_t ) IOT_METRICS_HISTOGRAM_COUNT; i++ )
+            {
+                ( void ) IotMetrics_GetHistogram( ( IotMetricsHistogram_t ) i, &histogram );
+
+                if( histogram.count > 0U )
+                {
+                    lineLength = snprintf( pBuffer + length,
+                                           bufferSize - length,
+                                           "%s count=%lu p50<=%lu p99<=%lu max=%lu\r\n",
+                                           _pHistogramNames[ i ],
+                                           ( unsigned long ) histogram.count,
+                                           ( unsigned long ) IotMetrics_Percentile( &histogram, 50U ),
+                                           ( unsigned long ) IotMetrics_Percentile( &histogram, 99U ),
+                                           ( unsigned long ) histogram.maxUs );
+
+                    if( ( lineLength < 0 ) || ( ( size_t ) lineLength >= ( bufferSize - length ) ) )
+                    {
+                        /* Remove the partial line. */
+                        pBuffer[ length ] = '\0';
+                        break;
+                    }
+
+                    length += ( size_t ) lineLength;
+                }
+            }
+
+            for( i = 0; i < ( uint32_t ) IOT_METRICS_COUNTER_COUNT; i++ )
+            {
+                lineLength = snprintf( pBuffer + length,
+                                       bufferSize - length,
+                                       "%s=%lu\r\n",
+                                       _pCounterNames[ i ],
+                                       ( unsigned long ) _counters[ i ] );
+
+                if( ( lineLength < 0 ) || ( ( size_t ) lineLength >= ( bufferSize - length ) ) )
+                {
+                    pBuffer[ length ] = '\0';
+                    break;
+                }
+
+                length += ( size_t ) lineLength;
+            }
+        }
+
+        return length;
+    }
+
+#endif /* if IOT_METRICS_ENABLE_HISTOGRAMS == 1 */
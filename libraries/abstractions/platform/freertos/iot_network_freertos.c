@@ -65,6 +65,20 @@
     #define IOT_NETWORK_SOCKET_POLL_MS    ( 1000 )
 #endif
 
+/* Receive callbacks run in the Secure Sockets receive callback task instead of
+ * a task per connection. The Secure Sockets port must support
+ * SOCKETS_SO_WAKEUP_CALLBACK and must not call the wakeup callback again once
+ * it has been cleared. */
+#ifndef IOT_NETWORK_SHARED_RECEIVE_TASK
+    #define IOT_NETWORK_SHARED_RECEIVE_TASK    ( 0 )
+#endif
+
+/* The number of segments passed to a single call of SOCKETS_Sendv. Longer
+ * segment lists are sent in several calls. */
+#ifndef IOT_NETWORK_SENDV_MAX_SEGMENTS
+    #define IOT_NETWORK_SENDV_MAX_SEGMENTS    ( 4 )
+#endif
+
 /**
  * @brief The event group bit to set when a connection's socket is shut down.
  */
@@ -93,10 +107,24 @@ typedef struct _networkConnection
     void * pReceiveContext;                      /**< @brief The context for the receive callback. */
     bool bufferedByteValid;                      /**< @brief Used to determine if the buffered byte is valid. */
     uint8_t bufferedByte;                        /**< @brief A single byte buffered from a receive, since AFR Secure Sockets does not have poll(). */
+    #if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 )
+        struct _networkConnection * pNext;       /**< @brief Next connection waiting for socket wakeups. */
+    #endif
 } _networkConnection_t;
 
 /*-----------------------------------------------------------*/
 
+#if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 )
+
+/**
+ * @brief Connections with a receive callback, used to find the connection of a
+ * socket in the wakeup callback.
+ */
+    static _networkConnection_t * _pReceiveConnections = NULL;
+#endif
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief An #IotNetworkInterface_t that uses the functions in this file.
  */
@@ -108,7 +136,8 @@ const IotNetworkInterface_t IotNetworkAfr =
     .receive            = IotNetworkAfr_Receive,
     .receiveUpto        = IotNetworkAfr_ReceiveUpto,
     .close              = IotNetworkAfr_Close,
-    .destroy            = IotNetworkAfr_Destroy
+    .destroy            = IotNetworkAfr_Destroy,
+    .sendv              = IotNetworkAfr_Sendv
 };
 
 /*-----------------------------------------------------------*/
@@ -134,86 +163,216 @@ static void _destroyConnection( _networkConnection_t * pNetworkConnection )
 
 /*-----------------------------------------------------------*/
 
+#if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 0 )
+
 /**
  * @brief Task routine that waits on incoming network data.
  *
  * @param[in] pArgument The network connection.
  */
-static void _networkReceiveTask( void * pArgument )
-{
-    bool destroyConnection = false;
-    int32_t socketStatus = 0;
-    EventBits_t connectionFlags = 0;
+    static void _networkReceiveTask( void * pArgument )
+    {
+        bool destroyConnection = false;
+        int32_t socketStatus = 0;
+        EventBits_t connectionFlags = 0;
 
-    /* Cast network connection to the correct type. */
-    _networkConnection_t * pNetworkConnection = pArgument;
+        /* Cast network connection to the correct type. */
+        _networkConnection_t * pNetworkConnection = pArgument;
+
+        while( true )
+        {
+            /* No buffered byte should be in the connection. */
+            configASSERT( pNetworkConnection->bufferedByteValid == false );
+
+            /* Block and wait for 1 byte of data. This simulates the behavior of poll().
+             * THIS IS A TEMPORARY WORKAROUND AND DOES NOT PROVIDE THREAD-SAFETY AGAINST
+             * MULTIPLE CALLS OF RECEIVE. */
+            do
+            {
+                socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
+                                             &( pNetworkConnection->bufferedByte ),
+                                             1,
+                                             0 );
+
+                connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+
+                if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+                {
+                    socketStatus = SOCKETS_ECLOSED;
+                }
+
+                /* Check for timeout. Some ports return 0, some return EWOULDBLOCK. */
+            } while( ( socketStatus == 0 ) || ( socketStatus == SOCKETS_EWOULDBLOCK ) );
+
+            if( socketStatus <= 0 )
+            {
+                break;
+            }
+
+            pNetworkConnection->bufferedByteValid = true;
+
+            /* Invoke the network callback. */
+            pNetworkConnection->receiveCallback( pNetworkConnection,
+                                                 pNetworkConnection->pReceiveContext );
+
+            /* Check if the connection was destroyed by the receive callback. This
+             * does not need to be thread-safe because the destroy connection function
+             * may only be called once (per its API doc). */
+            connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+
+            if( ( connectionFlags & _FLAG_CONNECTION_DESTROYED ) == _FLAG_CONNECTION_DESTROYED )
+            {
+                destroyConnection = true;
+                break;
+            }
+        }
+
+        IotLogDebug( "Network receive task terminating." );
+
+        /* If necessary, destroy the network connection before exiting. */
+        if( destroyConnection == true )
+        {
+            _destroyConnection( pNetworkConnection );
+        }
+        else
+        {
+            /* Set the flag to indicate that the receive task has exited. */
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                         _FLAG_RECEIVE_TASK_EXITED );
+        }
 
-    while( true )
+        vTaskDelete( NULL );
+    }
+#endif /* if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 0 ) */
+
+/*-----------------------------------------------------------*/
+
+#if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 )
+
+/**
+ * @brief Stops socket wakeups for a connection.
+ *
+ * @param[in] pNetworkConnection The connection to stop.
+ */
+    static void _stopSocketWakeup( _networkConnection_t * pNetworkConnection )
     {
-        /* No buffered byte should be in the connection. */
-        configASSERT( pNetworkConnection->bufferedByteValid == false );
+        _networkConnection_t ** pLink = NULL;
+
+        /* Clearing the callback waits for a wakeup of the socket running in
+         * another task. */
+        ( void ) SOCKETS_SetSockOpt( pNetworkConnection->socket,
+                                     0,
+                                     SOCKETS_SO_WAKEUP_CALLBACK,
+                                     NULL,
+                                     0 );
 
-        /* Block and wait for 1 byte of data. This simulates the behavior of poll().
-         * THIS IS A TEMPORARY WORKAROUND AND DOES NOT PROVIDE THREAD-SAFETY AGAINST
-         * MULTIPLE CALLS OF RECEIVE. */
-        do
+        taskENTER_CRITICAL();
+
+        for( pLink = &_pReceiveConnections; *pLink != NULL; pLink = &( ( *pLink )->pNext ) )
         {
-            socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
-                                         &( pNetworkConnection->bufferedByte ),
-                                         1,
-                                         0 );
+            if( *pLink == pNetworkConnection )
+            {
+                *pLink = pNetworkConnection->pNext;
+                break;
+            }
+        }
 
-            connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+        taskEXIT_CRITICAL();
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Socket wakeup callback that invokes the network receive callback.
+ *
+ * This does the work of one iteration of #_networkReceiveTask, in the Secure
+ * Sockets receive callback task.
+ *
+ * @param[in] socket The socket with incoming data.
+ */
+    static void _networkSocketWakeup( Socket_t socket )
+    {
+        int32_t socketStatus = 0;
+        EventBits_t connectionFlags = 0;
+        _networkConnection_t * pNetworkConnection = NULL;
+
+        /* Find the connection of the socket. */
+        taskENTER_CRITICAL();
 
-            if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+        for( pNetworkConnection = _pReceiveConnections;
+             pNetworkConnection != NULL;
+             pNetworkConnection = pNetworkConnection->pNext )
+        {
+            if( pNetworkConnection->socket == socket )
             {
-                socketStatus = SOCKETS_ECLOSED;
+                break;
             }
+        }
 
-            /* Check for timeout. Some ports return 0, some return EWOULDBLOCK. */
-        } while( ( socketStatus == 0 ) || ( socketStatus == SOCKETS_EWOULDBLOCK ) );
+        taskEXIT_CRITICAL();
 
-        if( socketStatus <= 0 )
+        if( pNetworkConnection == NULL )
         {
-            break;
+            return;
+        }
+
+        /* No buffered byte should be in the connection. */
+        configASSERT( pNetworkConnection->bufferedByteValid == false );
+
+        /* The socket is readable, so this only waits for the rest of a TLS
+         * record. */
+        socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
+                                     &( pNetworkConnection->bufferedByte ),
+                                     1,
+                                     0 );
+
+        connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+
+        if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+        {
+            socketStatus = SOCKETS_ECLOSED;
+        }
+
+        /* Wait for the next wakeup on timeout. */
+        if( ( socketStatus == 0 ) || ( socketStatus == SOCKETS_EWOULDBLOCK ) )
+        {
+            return;
+        }
+
+        if( socketStatus < 0 )
+        {
+            IotLogDebug( "Network receive callback stopped." );
+
+            _stopSocketWakeup( pNetworkConnection );
+
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                         _FLAG_RECEIVE_TASK_EXITED );
+
+            return;
         }
 
         pNetworkConnection->bufferedByteValid = true;
 
-        /* Invoke the network callback. */
+        /* Invoke the network callback. The receive task handle is only set
+         * while the callback runs, so that destroying the connection from the
+         * callback is deferred to here. */
+        pNetworkConnection->receiveTask = xTaskGetCurrentTaskHandle();
         pNetworkConnection->receiveCallback( pNetworkConnection,
                                              pNetworkConnection->pReceiveContext );
+        pNetworkConnection->receiveTask = NULL;
 
-        /* Check if the connection was destroyed by the receive callback. This
-         * does not need to be thread-safe because the destroy connection function
-         * may only be called once (per its API doc). */
+        /* Check if the connection was destroyed by the receive callback. */
         connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
 
         if( ( connectionFlags & _FLAG_CONNECTION_DESTROYED ) == _FLAG_CONNECTION_DESTROYED )
         {
-            destroyConnection = true;
-            break;
+            _stopSocketWakeup( pNetworkConnection );
+            _destroyConnection( pNetworkConnection );
         }
     }
 
-    IotLogDebug( "Network receive task terminating." );
-
-    /* If necessary, destroy the network connection before exiting. */
-    if( destroyConnection == true )
-    {
-        _destroyConnection( pNetworkConnection );
-    }
-    else
-    {
-        /* Set the flag to indicate that the receive task has exited. */
-        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
-                                     _FLAG_RECEIVE_TASK_EXITED );
-    }
-
-    vTaskDelete( NULL );
-}
-
 /*-----------------------------------------------------------*/
+#endif /* if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 ) */
 
 /**
  * @brief Set up a secured TLS connection.
@@ -454,18 +613,38 @@ IotNetworkError_t IotNetworkAfr_SetReceiveCallback( void * pConnection,
     /* No flags should be set. */
     configASSERT( xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) ) == 0 );
 
-    /* Create task that waits for incoming data. */
-    if( xTaskCreate( _networkReceiveTask,
-                     "NetRecv",
-                     IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
-                     pNetworkConnection,
-                     IOT_NETWORK_RECEIVE_TASK_PRIORITY,
-                     &( pNetworkConnection->receiveTask ) ) != pdPASS )
-    {
-        IotLogError( "Failed to create network receive task." );
+    #if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 )
+        taskENTER_CRITICAL();
+        pNetworkConnection->pNext = _pReceiveConnections;
+        _pReceiveConnections = pNetworkConnection;
+        taskEXIT_CRITICAL();
+
+        /* Wait for incoming data in the shared receive callback task. */
+        if( SOCKETS_SetSockOpt( pNetworkConnection->socket,
+                                0,
+                                SOCKETS_SO_WAKEUP_CALLBACK,
+                                ( void * ) _networkSocketWakeup,
+                                sizeof( void * ) ) != SOCKETS_ERROR_NONE )
+        {
+            IotLogError( "Failed to set network receive callback." );
 
-        status = IOT_NETWORK_SYSTEM_ERROR;
-    }
+            _stopSocketWakeup( pNetworkConnection );
+            status = IOT_NETWORK_SYSTEM_ERROR;
+        }
+    #else
+        /* Create task that waits for incoming data. */
+        if( xTaskCreate( _networkReceiveTask,
+                         "NetRecv",
+                         IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
+                         pNetworkConnection,
+                         IOT_NETWORK_RECEIVE_TASK_PRIORITY,
+                         &( pNetworkConnection->receiveTask ) ) != pdPASS )
+        {
+            IotLogError( "Failed to create network receive task." );
+
+            status = IOT_NETWORK_SYSTEM_ERROR;
+        }
+    #endif /* if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 ) */
 
     return status;
 }
@@ -516,6 +695,90 @@ size_t IotNetworkAfr_Send( void * pConnection,
 
 /*-----------------------------------------------------------*/
 
+size_t IotNetworkAfr_Sendv( void * pConnection,
+                            const IotNetworkSegment_t * pSegments,
+                            size_t segmentCount )
+{
+    size_t bytesSent = 0U, bytesToSkip = 0U, bytesLeftInSegment = 0U;
+    size_t segmentIndex = 0U, segmentOffset = 0U, i = 0U, iovCount = 0U;
+    int32_t socketStatus = SOCKETS_ERROR_NONE;
+    SocketsIovec_t iov[ IOT_NETWORK_SENDV_MAX_SEGMENTS ];
+
+    /* Cast network connection to the correct type. */
+    _networkConnection_t * pNetworkConnection = ( _networkConnection_t * ) pConnection;
+
+    /* Only one thread at a time may send on the connection. Lock the socket
+     * mutex to prevent other threads from sending. */
+    if( xSemaphoreTake( ( QueueHandle_t ) &( pNetworkConnection->socketMutex ),
+                        portMAX_DELAY ) == pdTRUE )
+    {
+        while( segmentIndex < segmentCount )
+        {
+            /* Skip empty segments, so that the first buffer of the batch is
+             * the segment at segmentIndex. */
+            if( pSegments[ segmentIndex ].dataLength == 0U )
+            {
+                segmentIndex++;
+                continue;
+            }
+
+            /* Gather the unsent part of the next segments. Only the first of
+             * them may have been partially sent. */
+            iov[ 0 ].pvBase = pSegments[ segmentIndex ].pData + segmentOffset;
+            iov[ 0 ].xLength = pSegments[ segmentIndex ].dataLength - segmentOffset;
+            iovCount = 1U;
+
+            for( i = segmentIndex + 1U; ( i < segmentCount ) && ( iovCount < IOT_NETWORK_SENDV_MAX_SEGMENTS ); i++ )
+            {
+                iov[ iovCount ].pvBase = pSegments[ i ].pData;
+                iov[ iovCount ].xLength = pSegments[ i ].dataLength;
+                iovCount++;
+            }
+
+            socketStatus = SOCKETS_Sendv( pNetworkConnection->socket,
+                                          iov,
+                                          iovCount,
+                                          0 );
+
+            if( socketStatus > 0 )
+            {
+                bytesSent += ( size_t ) socketStatus;
+
+                /* Move past the bytes that were sent. */
+                bytesToSkip = ( size_t ) socketStatus;
+
+                while( bytesToSkip > 0U )
+                {
+                    bytesLeftInSegment = pSegments[ segmentIndex ].dataLength - segmentOffset;
+
+                    if( bytesToSkip < bytesLeftInSegment )
+                    {
+                        segmentOffset += bytesToSkip;
+                        bytesToSkip = 0U;
+                    }
+                    else
+                    {
+                        bytesToSkip -= bytesLeftInSegment;
+                        segmentIndex++;
+                        segmentOffset = 0U;
+                    }
+                }
+            }
+            else
+            {
+                IotLogError( "Error %ld while sending data.", ( long int ) socketStatus );
+                break;
+            }
+        }
+
+        xSemaphoreGive( ( QueueHandle_t ) &( pNetworkConnection->socketMutex ) );
+    }
+
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
 size_t IotNetworkAfr_Receive( void * pConnection,
                               uint8_t * pBuffer,
                               size_t bytesRequested )
@@ -671,15 +934,24 @@ IotNetworkError_t IotNetworkAfr_Destroy( void * pConnection )
     }
     else
     {
-        /* If a receive task was created, wait for it to exit. */
-        if( pNetworkConnection->receiveTask != NULL )
-        {
-            ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
-                                          _FLAG_RECEIVE_TASK_EXITED,
-                                          pdTRUE,
-                                          pdTRUE,
-                                          portMAX_DELAY );
-        }
+        #if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 )
+            /* Stop the socket wakeups. This waits for a receive callback
+             * running in another task. */
+            if( pNetworkConnection->receiveCallback != NULL )
+            {
+                _stopSocketWakeup( pNetworkConnection );
+            }
+        #else
+            /* If a receive task was created, wait for it to exit. */
+            if( pNetworkConnection->receiveTask != NULL )
+            {
+                ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                              _FLAG_RECEIVE_TASK_EXITED,
+                                              pdTRUE,
+                                              pdTRUE,
+                                              portMAX_DELAY );
+            }
+        #endif
 
         _destroyConnection( pNetworkConnection );
     }
@@ -27,8 +27,12 @@
  * @file iot_metrics.h
  * @brief Functions for retrieving [Device Defender](@ref defender) metrics.
  *
- * The functions in this header are only required by Device Defender. They do not
- * need to be implemented if Device Defender is not used.
+ * The connection functions in this header are only required by Device Defender.
+ * They do not need to be implemented if Device Defender is not used.
+ *
+ * The histogram functions record the latencies measured by the libraries when
+ * @ref IOT_METRICS_ENABLE_HISTOGRAMS is 1, so that they can be reported as
+ * Device Defender custom metrics or printed from a command line.
  */
 
 #ifndef IOT_METRICS_H_
@@ -39,10 +43,58 @@
 
 /* Standard includes. */
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /* Linear containers (lists and queues) include. */
 #include "iot_linear_containers.h"
 
+/* Platform types include. */
+#include "types/iot_platform_types.h"
+
+/**
+ * @brief Set this to 1 to record the latency histograms and counters of
+ * #IotMetricsHistogram_t and #IotMetricsCounter_t.
+ *
+ * When this is 0, the libraries do not measure anything and the histogram
+ * functions are not compiled.
+ */
+#ifndef IOT_METRICS_ENABLE_HISTOGRAMS
+    #define IOT_METRICS_ENABLE_HISTOGRAMS    0
+#endif
+
+/**
+ * @brief Get the timestamp used to measure latencies, in microseconds.
+ *
+ * The default is @ref platform_clock_function_gettimems multiplied by 1000, so
+ * it only has millisecond resolution: a latency under 1 ms is recorded as 0 or
+ * 1000 microseconds, and the buckets below 1 ms are not meaningful. Ports
+ * should define this in iot_config.h to read a microsecond timer or a cycle
+ * counter. The timestamp only needs to be monotonic modulo 2^32.
+ */
+#if ( IOT_METRICS_ENABLE_HISTOGRAMS == 1 ) && !defined( IotMetrics_GetTimestampUs )
+    #include "platform/iot_clock.h"
+    #define IotMetrics_GetTimestampUs()    ( ( uint32_t ) ( IotClock_GetTimeMs() * 1000ULL ) )
+#endif
+
+/**
+ * @brief Macros used by the libraries to measure latencies and count events.
+ *
+ * These compile to nothing when @ref IOT_METRICS_ENABLE_HISTOGRAMS is 0.
+ */
+/**@{ */
+#if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+    #define IOT_METRICS_TIMESTAMP()                       IotMetrics_GetTimestampUs()
+    #define IOT_METRICS_RECORD_SINCE( histogram, startUs ) \
+    IotMetrics_RecordLatency( ( histogram ), IotMetrics_GetTimestampUs() - ( startUs ) )
+    #define IOT_METRICS_COUNT( counter )                  IotMetrics_IncrementCounter( counter )
+#else
+    #define IOT_METRICS_TIMESTAMP()                       ( 0U )
+    #define IOT_METRICS_RECORD_SINCE( histogram, startUs )    ( ( void ) ( startUs ) )
+    #define IOT_METRICS_COUNT( counter )
+#endif
+/**@} */
+
 /**
  * @functions_page{platform_metrics,platform metrics component,Metrics}
  * @functions_brief{platform metrics component}
@@ -52,6 +104,22 @@
  * @function_brief{platform_metrics_function_cleanup}
  * - @function_name{platform_metrics_function_gettcpconnections}
  * @function_brief{platform_metrics_function_gettcpconnections}
+ * - @function_name{platform_metrics_function_recordlatency}
+ * @function_brief{platform_metrics_function_recordlatency}
+ * - @function_name{platform_metrics_function_incrementcounter}
+ * @function_brief{platform_metrics_function_incrementcounter}
+ * - @function_name{platform_metrics_function_gethistogram}
+ * @function_brief{platform_metrics_function_gethistogram}
+ * - @function_name{platform_metrics_function_getcounter}
+ * @function_brief{platform_metrics_function_getcounter}
+ * - @function_name{platform_metrics_function_gethistograms}
+ * @function_brief{platform_metrics_function_gethistograms}
+ * - @function_name{platform_metrics_function_percentile}
+ * @function_brief{platform_metrics_function_percentile}
+ * - @function_name{platform_metrics_function_resethistograms}
+ * @function_brief{platform_metrics_function_resethistograms}
+ * - @function_name{platform_metrics_function_printhistograms}
+ * @function_brief{platform_metrics_function_printhistograms}
  */
 
 /**
@@ -64,6 +132,30 @@
  * @function_page{IotMetrics_GetTcpConnections,platform_metrics,gettcpconnections}
  * @function_snippet{platform_metrics,gettcpconnections,this}
  * @copydoc IotMetrics_GetTcpConnections
+ * @function_page{IotMetrics_RecordLatency,platform_metrics,recordlatency}
+ * @function_snippet{platform_metrics,recordlatency,this}
+ * @copydoc IotMetrics_RecordLatency
+ * @function_page{IotMetrics_IncrementCounter,platform_metrics,incrementcounter}
+ * @function_snippet{platform_metrics,incrementcounter,this}
+ * @copydoc IotMetrics_IncrementCounter
+ * @function_page{IotMetrics_GetHistogram,platform_metrics,gethistogram}
+ * @function_snippet{platform_metrics,gethistogram,this}
+ * @copydoc IotMetrics_GetHistogram
+ * @function_page{IotMetrics_GetCounter,platform_metrics,getcounter}
+ * @function_snippet{platform_metrics,getcounter,this}
+ * @copydoc IotMetrics_GetCounter
+ * @function_page{IotMetrics_GetHistograms,platform_metrics,gethistograms}
+ * @function_snippet{platform_metrics,gethistograms,this}
+ * @copydoc IotMetrics_GetHistograms
+ * @function_page{IotMetrics_Percentile,platform_metrics,percentile}
+ * @function_snippet{platform_metrics,percentile,this}
+ * @copydoc IotMetrics_Percentile
+ * @function_page{IotMetrics_ResetHistograms,platform_metrics,resethistograms}
+ * @function_snippet{platform_metrics,resethistograms,this}
+ * @copydoc IotMetrics_ResetHistograms
+ * @function_page{IotMetrics_PrintHistograms,platform_metrics,printhistograms}
+ * @function_snippet{platform_metrics,printhistograms,this}
+ * @copydoc IotMetrics_PrintHistograms
  */
 
 /**
@@ -110,4 +202,117 @@ void IotMetrics_GetTcpConnections( void * pContext,
                                    void ( * metricsCallback )( void *, const IotListDouble_t * ) );
 /* @[declare_platform_metrics_gettcpconnections] */
 
+#if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+
+/**
+ * @brief Record a latency in a histogram.
+ *
+ * This function only uses atomic operations, so it may be called from any
+ * task without a lock.
+ *
+ * @param[in] histogram The histogram to update.
+ * @param[in] latencyUs The latency in microseconds.
+ */
+/* @[declare_platform_metrics_recordlatency] */
+    void IotMetrics_RecordLatency( IotMetricsHistogram_t histogram,
+                                   uint32_t latencyUs );
+/* @[declare_platform_metrics_recordlatency] */
+
+/**
+ * @brief Add one to a counter.
+ *
+ * This function only uses atomic operations, so it may be called from any
+ * task without a lock.
+ *
+ * @param[in] counter The counter to update.
+ */
+/* @[declare_platform_metrics_incrementcounter] */
+    void IotMetrics_IncrementCounter( IotMetricsCounter_t counter );
+/* @[declare_platform_metrics_incrementcounter] */
+
+/**
+ * @brief Copy a latency histogram.
+ *
+ * Latencies may be recorded while the histogram is copied, so the members of
+ * the copy may differ from each other by the latencies recorded meanwhile.
+ *
+ * @param[in] histogram The histogram to copy.
+ * @param[out] pHistogram Receives the copy.
+ *
+ * @return `true` if `histogram` is valid; `false` otherwise.
+ */
+/* @[declare_platform_metrics_gethistogram] */
+    bool IotMetrics_GetHistogram( IotMetricsHistogram_t histogram,
+                                  IotMetricsHistogramData_t * pHistogram );
+/* @[declare_platform_metrics_gethistogram] */
+
+/**
+ * @brief Read a counter.
+ *
+ * @param[in] counter The counter to read.
+ *
+ * @return The value of the counter; `0` if `counter` is not valid.
+ */
+/* @[declare_platform_metrics_getcounter] */
+    uint32_t IotMetrics_GetCounter( IotMetricsCounter_t counter );
+/* @[declare_platform_metrics_getcounter] */
+
+/**
+ * @brief Provide a copy of every histogram that has recorded a latency.
+ *
+ * @param[in] pContext Context passed as the first parameter of `metricsCallback`.
+ * @param[in] metricsCallback Called once for each histogram with its name and
+ * a copy of it. The copy should not be used after the callback returns.
+ */
+/* @[declare_platform_metrics_gethistograms] */
+    void IotMetrics_GetHistograms( void * pContext,
+                                   void ( * metricsCallback )( void *, const char *, const IotMetricsHistogramData_t * ) );
+/* @[declare_platform_metrics_gethistograms] */
+
+/**
+ * @brief Estimate a percentile of a latency histogram.
+ *
+ * The estimate is the upper bound of the bucket that holds the percentile,
+ * limited to the largest latency recorded.
+ *
+ * @param[in] pHistogram A histogram copied with @ref platform_metrics_function_gethistogram.
+ * @param[in] percentile The percentile, from 1 to 100.
+ *
+ * @return The estimated latency in microseconds; `0` if the histogram is empty.
+ */
+/* @[declare_platform_metrics_percentile] */
+    uint32_t IotMetrics_Percentile( const IotMetricsHistogramData_t * pHistogram,
+                                    uint32_t percentile );
+/* @[declare_platform_metrics_percentile] */
+
+/**
+ * @brief Clear all histograms and counters.
+ *
+ * Latencies recorded while this function runs may be partially cleared.
+ */
+/* @[declare_platform_metrics_resethistograms] */
+    void IotMetrics_ResetHistograms( void );
+/* @[declare_platform_metrics_resethistograms] */
+
+/**
+ * @brief Print the histograms and counters as text, one per line.
+ *
+ * Each histogram line has the histogram name, its count, its estimated 50th
+ * and 99th percentiles and its largest latency. Histograms that have not
+ * recorded a latency are skipped. Each counter line has the counter name and
+ * its value.
+ *
+ * @param[out] pBuffer Receives the NULL-terminated text.
+ * @param[in] bufferSize The size of `pBuffer`.
+ *
+ * @return The length of the text, excluding the NULL terminator. Lines that
+ * do not fit in `pBuffer` are left out.
+ */
+/* @[declare_platform_metrics_printhistograms] */
+    size_t IotMetrics_PrintHistograms( char * pBuffer,
+                                       size_t bufferSize );
+/* @[declare_platform_metrics_printhistograms] */
+
+#endif /* if IOT_METRICS_ENABLE_HISTOGRAMS == 1 */
+
 #endif /* ifndef IOT_METRICS_H_ */
@@ -67,6 +67,8 @@ typedef enum IotNetworkError
  * @function_brief{platform_network_function_setreceivecallback}
  * - @function_name{platform_network_function_send}
  * @function_brief{platform_network_function_send}
+ * - @function_name{platform_network_function_sendv}
+ * @function_brief{platform_network_function_sendv}
  * - @function_name{platform_network_function_receive}
  * @function_brief{platform_network_function_receive}
  * - @function_name{platform_network_function_receiveupto}
@@ -89,6 +91,9 @@ typedef enum IotNetworkError
  * @function_page{IotNetworkInterface_t::send,platform_network,send}
  * @function_snippet{platform_network,send,this}
  * @copydoc IotNetworkInterface_t::send
+ * @function_page{IotNetworkInterface_t::sendv,platform_network,sendv}
+ * @function_snippet{platform_network,sendv,this}
+ * @copydoc IotNetworkInterface_t::sendv
  * @function_page{IotNetworkInterface_t::receive,platform_network,receive}
  * @function_snippet{platform_network,receive,this}
  * @copydoc IotNetworkInterface_t::receive
@@ -121,6 +126,16 @@ typedef void ( * IotNetworkReceiveCallback_t )( void * pConnection,
                                                 void * pContext );
 /* @[declare_platform_network_receivecallback] */
 
+/**
+ * @ingroup platform_datatypes_paramstructs
+ * @brief A contiguous part of a message passed to @ref platform_network_function_sendv.
+ */
+typedef struct IotNetworkSegment
+{
+    const uint8_t * pData; /**< @brief Start of the segment. */
+    size_t dataLength;     /**< @brief Length of the segment. May be `0`. */
+} IotNetworkSegment_t;
+
 /**
  * @ingroup platform_datatypes_paramstructs
  * @brief Represents the functions of a network stack.
@@ -281,6 +296,31 @@ typedef struct IotNetworkInterface
     /* @[declare_platform_network_destroy] */
     IotNetworkError_t ( * destroy )( void * pConnection );
     /* @[declare_platform_network_destroy] */
+
+    /**
+     * @brief Send a message made of several segments over a connection.
+     *
+     * Attempts to transmit the segments in `pSegments` back to back, in order,
+     * across the connection represented by `pConnection`, as if they were one
+     * contiguous message passed to @ref platform_network_function_send. This
+     * lets a library send a serialized header followed by a caller's payload
+     * without first copying both into one buffer.
+     *
+     * This function is optional and may be `NULL`. Libraries must fall back to
+     * @ref platform_network_function_send when it is not set.
+     *
+     * @param[in] pConnection The connection used to send data, defined by the
+     * network stack.
+     * @param[in] pSegments The segments of the message to send.
+     * @param[in] segmentCount The number of segments in `pSegments`.
+     *
+     * @return The total number of bytes successfully sent, `0` on failure.
+     */
+    /* @[declare_platform_network_sendv] */
+    size_t ( * sendv )( void * pConnection,
+                        const IotNetworkSegment_t * pSegments,
+                        size_t segmentCount );
+    /* @[declare_platform_network_sendv] */
 } IotNetworkInterface_t;
 
 /**
@@ -155,4 +155,67 @@ typedef struct IotMetricsTcpConnection
     char pRemoteAddress[ IOT_METRICS_IP_ADDRESS_LENGTH ];
 } IotMetricsTcpConnection_t;
 
+/**
+ * @brief The number of buckets in a latency histogram.
+ *
+ * Bucket `n` counts latencies of at least 2^n and less than 2^(n+1)
+ * microseconds. Bucket 0 also counts latencies of 0, and the last bucket
+ * counts every latency above its lower bound. The default of 24 buckets
+ * resolves latencies up to about 8 seconds.
+ */
+#ifndef IOT_METRICS_HISTOGRAM_BUCKETS
+    #define IOT_METRICS_HISTOGRAM_BUCKETS    24
+#endif
+
+/**
+ * @brief The latencies measured by the libraries.
+ *
+ * Latencies are only measured when @ref IOT_METRICS_ENABLE_HISTOGRAMS is 1.
+ */
+typedef enum IotMetricsHistogram
+{
+    IOT_METRICS_MQTT_OPERATION = 0,  /**< @brief From the creation of an MQTT operation until the server acknowledges it. */
+    IOT_METRICS_TASKPOOL_QUEUE_WAIT, /**< @brief From scheduling a task pool job until a worker starts it. */
+    IOT_METRICS_TASKPOOL_RUN,        /**< @brief Running the callback of a task pool job. */
+    IOT_METRICS_TLS_HANDSHAKE,       /**< @brief A successful TLS handshake. */
+    IOT_METRICS_TLS_SEND,            /**< @brief Encrypting and sending data on a TLS connection. */
+    IOT_METRICS_TLS_RECEIVE,         /**< @brief Receiving and decrypting data on a TLS connection, including the wait for the data. */
+    IOT_METRICS_HTTPS_REQUEST_SEND,  /**< @brief Sending the headers and body of an HTTPS request. */
+    IOT_METRICS_HTTPS_RESPONSE_WAIT, /**< @brief From the end of an HTTPS request until its response headers are received. */
+    IOT_METRICS_HTTPS_RESPONSE_BODY, /**< @brief Receiving the body of an HTTPS response. */
+    IOT_METRICS_OTA_BLOCK,           /**< @brief From requesting an OTA block until it is received. */
+    IOT_METRICS_HISTOGRAM_COUNT      /**< @brief The number of histograms; not a histogram. */
+} IotMetricsHistogram_t;
+
+/**
+ * @brief The events counted by the libraries.
+ *
+ * Events are only counted when @ref IOT_METRICS_ENABLE_HISTOGRAMS is 1.
+ */
+typedef enum IotMetricsCounter
+{
+    IOT_METRICS_MQTT_OPERATION_FAILURES = 0, /**< @brief MQTT operations that completed with an error. */
+    IOT_METRICS_TLS_HANDSHAKE_FAILURES,      /**< @brief TLS handshakes that failed. */
+    IOT_METRICS_TLS_SESSIONS_RESUMED,        /**< @brief TLS handshakes that resumed a cached session. */
+    IOT_METRICS_HTTPS_REQUEST_FAILURES,      /**< @brief HTTPS requests that failed to send or receive. */
+    IOT_METRICS_OTA_DUPLICATE_BLOCKS,        /**< @brief OTA blocks received more than once. */
+    IOT_METRICS_OTA_REQUESTS_LOST,           /**< @brief OTA block requests that timed out without a response. */
+    IOT_METRICS_COUNTER_COUNT                /**< @brief The number of counters; not a counter. */
+} IotMetricsCounter_t;
+
+/**
+ * @brief A snapshot of a latency histogram, returned by
+ * @ref platform_metrics_function_gethistogram.
+ *
+ * The mean latency is `sumUs` divided by `count`. The sum is kept in 64 bits,
+ * so it does not wrap around in the life of a device.
+ */
+typedef struct IotMetricsHistogramData
+{
+    uint32_t count;                                    /**< @brief The number of latencies recorded. */
+    uint64_t sumUs;                                    /**< @brief The sum of the latencies recorded, in microseconds. */
+    uint32_t maxUs;                                    /**< @brief The largest latency recorded, in microseconds. */
+    uint32_t pBuckets[ IOT_METRICS_HISTOGRAM_BUCKETS ]; /**< @brief The number of latencies recorded in each bucket. */
+} IotMetricsHistogramData_t;
+
 #endif /* ifndef IOT_PLATFORM_TYPES_H_ */
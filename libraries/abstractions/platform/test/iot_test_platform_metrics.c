@@ -0,0 +1,213 @@
+/*
+ * FreeRTOS Platform V1.1.2
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_test_platform_metrics.c
+ * @brief Tests for the histogram functions in iot_metrics.h
+ */
+
+#include "iot_config.h"
+
+/* Test framework includes. */
+#include <string.h>
+#include "unity_fixture.h"
+
+#include "platform/iot_metrics.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Histogram used by these tests. No library records OTA block
+ * latencies while the tests run.
+ */
+#define TEST_HISTOGRAM    IOT_METRICS_OTA_BLOCK
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for Platform Metrics tests.
+ */
+TEST_GROUP( UTIL_Platform_Metrics );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for Platform Metrics tests.
+ */
+TEST_SETUP( UTIL_Platform_Metrics )
+{
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        IotMetrics_ResetHistograms();
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for Platform Metrics tests.
+ */
+TEST_TEAR_DOWN( UTIL_Platform_Metrics )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for Platform Metrics tests.
+ */
+TEST_GROUP_RUNNER( UTIL_Platform_Metrics )
+{
+    RUN_TEST_CASE( UTIL_Platform_Metrics, IotMetrics_RecordLatency );
+    RUN_TEST_CASE( UTIL_Platform_Metrics, IotMetrics_Percentile );
+    RUN_TEST_CASE( UTIL_Platform_Metrics, IotMetrics_Counters );
+    RUN_TEST_CASE( UTIL_Platform_Metrics, IotMetrics_PrintHistograms );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that latencies are counted in the bucket of their highest bit.
+ */
+TEST( UTIL_Platform_Metrics, IotMetrics_RecordLatency )
+{
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        IotMetricsHistogramData_t histogram = { 0 };
+
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 0 );
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 1 );
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 1023 );
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 1024 );
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, UINT32_MAX );
+
+        TEST_ASSERT_TRUE( IotMetrics_GetHistogram( TEST_HISTOGRAM, &histogram ) );
+        TEST_ASSERT_EQUAL_UINT32( 5, histogram.count );
+        TEST_ASSERT_EQUAL_UINT32( UINT32_MAX, histogram.maxUs );
+
+        /* The sum does not wrap around. */
+        TEST_ASSERT_TRUE( histogram.sumUs == ( ( uint64_t ) UINT32_MAX + 2048U ) );
+
+        TEST_ASSERT_EQUAL_UINT32( 2, histogram.pBuckets[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, histogram.pBuckets[ 9 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, histogram.pBuckets[ 10 ] );
+
+        /* Latencies above the last bucket are counted in it. */
+        TEST_ASSERT_EQUAL_UINT32( 1, histogram.pBuckets[ IOT_METRICS_HISTOGRAM_BUCKETS - 1 ] );
+
+        /* Invalid histograms are ignored. */
+        IotMetrics_RecordLatency( IOT_METRICS_HISTOGRAM_COUNT, 1 );
+        TEST_ASSERT_FALSE( IotMetrics_GetHistogram( IOT_METRICS_HISTOGRAM_COUNT, &histogram ) );
+    #else
+        TEST_IGNORE_MESSAGE( "IOT_METRICS_ENABLE_HISTOGRAMS is 0." );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that percentiles are the upper bounds of their buckets, limited
+ * to the largest latency.
+ */
+TEST( UTIL_Platform_Metrics, IotMetrics_Percentile )
+{
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        IotMetricsHistogramData_t histogram = { 0 };
+        uint32_t i = 0;
+
+        TEST_ASSERT_TRUE( IotMetrics_GetHistogram( TEST_HISTOGRAM, &histogram ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, IotMetrics_Percentile( &histogram, 50 ) );
+
+        for( i = 0; i < 98; i++ )
+        {
+            IotMetrics_RecordLatency( TEST_HISTOGRAM, 100 );
+        }
+
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 70000 );
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 80000 );
+
+        TEST_ASSERT_TRUE( IotMetrics_GetHistogram( TEST_HISTOGRAM, &histogram ) );
+        TEST_ASSERT_EQUAL_UINT32( 127, IotMetrics_Percentile( &histogram, 50 ) );
+        TEST_ASSERT_EQUAL_UINT32( 127, IotMetrics_Percentile( &histogram, 98 ) );
+        TEST_ASSERT_EQUAL_UINT32( 80000, IotMetrics_Percentile( &histogram, 99 ) );
+        TEST_ASSERT_EQUAL_UINT32( 80000, IotMetrics_Percentile( &histogram, 100 ) );
+    #else
+        TEST_IGNORE_MESSAGE( "IOT_METRICS_ENABLE_HISTOGRAMS is 0." );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test incrementing and resetting counters.
+ */
+TEST( UTIL_Platform_Metrics, IotMetrics_Counters )
+{
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        TEST_ASSERT_EQUAL_UINT32( 0, IotMetrics_GetCounter( IOT_METRICS_OTA_REQUESTS_LOST ) );
+
+        IotMetrics_IncrementCounter( IOT_METRICS_OTA_REQUESTS_LOST );
+        IotMetrics_IncrementCounter( IOT_METRICS_OTA_REQUESTS_LOST );
+        TEST_ASSERT_EQUAL_UINT32( 2, IotMetrics_GetCounter( IOT_METRICS_OTA_REQUESTS_LOST ) );
+
+        IotMetrics_ResetHistograms();
+        TEST_ASSERT_EQUAL_UINT32( 0, IotMetrics_GetCounter( IOT_METRICS_OTA_REQUESTS_LOST ) );
+
+        /* Invalid counters read as 0. */
+        IotMetrics_IncrementCounter( IOT_METRICS_COUNTER_COUNT );
+        TEST_ASSERT_EQUAL_UINT32( 0, IotMetrics_GetCounter( IOT_METRICS_COUNTER_COUNT ) );
+    #else
+        TEST_IGNORE_MESSAGE( "IOT_METRICS_ENABLE_HISTOGRAMS is 0." );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test printing the histograms, including into a buffer that is too
+ * small for all of them.
+ */
+TEST( UTIL_Platform_Metrics, IotMetrics_PrintHistograms )
+{
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        char buffer[ 1024 ] = { 0 };
+        size_t length = 0;
+
+        IotMetrics_RecordLatency( TEST_HISTOGRAM, 100 );
+        IotMetrics_IncrementCounter( IOT_METRICS_OTA_DUPLICATE_BLOCKS );
+
+        length = IotMetrics_PrintHistograms( buffer, sizeof( buffer ) );
+        TEST_ASSERT_EQUAL( length, strlen( buffer ) );
+        TEST_ASSERT_NOT_NULL( strstr( buffer, "ota_block_us count=1 p50<=100 p99<=100 max=100\r\n" ) );
+        TEST_ASSERT_NOT_NULL( strstr( buffer, "ota_duplicate_blocks=1\r\n" ) );
+
+        /* Lines that do not fit are left out whole. */
+        length = IotMetrics_PrintHistograms( buffer, 8 );
+        TEST_ASSERT_EQUAL( 0, length );
+        TEST_ASSERT_EQUAL( 0, strlen( buffer ) );
+    #else
+        TEST_IGNORE_MESSAGE( "IOT_METRICS_ENABLE_HISTOGRAMS is 0." );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
@@ -93,6 +93,8 @@ int mq_getattr( mqd_t mqdes,
  * overwritten by user.
  * @note mode argument is not supported.
  * @note Supported oflags: O_RDWR, O_CREAT, O_EXCL, and O_NONBLOCK.
+ * @note Creating a queue allocates the memory for all of its messages, about
+ * mq_maxmsg * mq_msgsize bytes, so that sending a message never allocates.
  *
  * @retval Message queue descriptor -- Upon successful completion
  * @retval (mqd_t) - 1 -- An error occurred. errno is also set.
@@ -155,8 +157,7 @@ ssize_t mq_receive( mqd_t mqdes,
  * <br>
  * EBADF - The mqdes argument is not a valid message queue descriptor open for writing.
  * <br>
- * EMSGSIZE - The specified message length, msg_len, exceeds the message size attribute of the message queue,
- * OR insufficient memory for the message to be sent.
+ * EMSGSIZE - The specified message length, msg_len, exceeds the message size attribute of the message queue.
  * <br>
  * ETIMEDOUT - The O_NONBLOCK flag was not set when the message queue was opened,
  * but the timeout expired before the message could be added to the queue.
@@ -214,8 +215,7 @@ ssize_t mq_timedreceive( mqd_t mqdes,
  * <br>
  * EBADF - The mqdes argument is not a valid message queue descriptor open for writing.
  * <br>
- * EMSGSIZE - The specified message length, msg_len, exceeds the message size attribute of the message queue,
- * OR insufficient memory for the message to be sent.
+ * EMSGSIZE - The specified message length, msg_len, exceeds the message size attribute of the message queue.
  * <br>
  * EINVAL - The process or thread would have blocked, and the abstime parameter specified a nanoseconds field
  * value less than zero or greater than or equal to 1000 million.
@@ -248,4 +248,110 @@ int mq_timedsend( mqd_t mqdes,
  */
 int mq_unlink( const char * name );
 
+/**
+ * @brief Borrow an empty message buffer of a message queue.
+ *
+ * This function is not part of POSIX. Together with mq_send_loan(),
+ * mq_receive_loan() and mq_return(), it passes messages without copying them:
+ * the sender writes the message in a buffer of the queue, and the receiver
+ * reads it from the same buffer. The buffer holds up to mq_msgsize bytes and
+ * is suitably aligned for any type.
+ *
+ * A loaned buffer counts against mq_maxmsg until it is sent with
+ * mq_send_loan() or given back with mq_return(). Loaned buffers must be
+ * given back before the queue is removed.
+ *
+ * @retval Pointer to the buffer - Upon successful completion.
+ * @retval NULL - An error occurred. errno is also set.
+ *
+ * @sideeffect Possible errno values
+ * <br>
+ * EBADF - The mqdes argument is not a valid message queue descriptor.
+ * <br>
+ * EINVAL - The process or thread would have blocked, and the abstime parameter specified a nanoseconds field
+ * value less than zero or greater than or equal to 1000 million.
+ * <br>
+ * ETIMEDOUT - The O_NONBLOCK flag was not set when the message queue was opened,
+ * but the timeout expired before a buffer was free.
+ * <br>
+ * EAGAIN - The O_NONBLOCK flag is set in the message queue description associated with mqdes,
+ * and the specified message queue is full.
+ */
+char * mq_loan( mqd_t mqdes,
+                const struct timespec * abstime );
+
+/**
+ * @brief Send a message written in a buffer borrowed with mq_loan().
+ *
+ * This function is not part of POSIX. It never blocks; the buffer is owned by
+ * the queue after a successful call. If the call fails, the caller still owns
+ * the buffer.
+ *
+ * @note msg_prio argument is not supported.
+ *
+ * @retval 0 - Upon successful completion.
+ * @retval -1 - An error occurred. errno is also set.
+ *
+ * @sideeffect Possible errno values
+ * <br>
+ * EBADF - The mqdes argument is not a valid message queue descriptor.
+ * <br>
+ * EINVAL - msg_ptr is not a buffer of the message queue currently on loan.
+ * <br>
+ * EMSGSIZE - The specified message length, msg_len, exceeds the message size attribute of the message queue.
+ */
+int mq_send_loan( mqd_t mqdes,
+                  char * msg_ptr,
+                  size_t msg_len,
+                  unsigned msg_prio );
+
+/**
+ * @brief Receive a message from a message queue without copying it.
+ *
+ * This function is not part of POSIX. On success, msg_ptr is set to the
+ * buffer of the queue holding the message. The caller owns the buffer and
+ * gives it back with mq_return(), or fills it and sends it with
+ * mq_send_loan().
+ *
+ * @note msg_prio argument is not supported.
+ *
+ * @retval The length of the selected message in bytes - Upon successful completion.
+ * The message is removed from the queue
+ * @retval -1 - An error occurred. errno is also set.
+ *
+ * @sideeffect Possible errno values
+ * <br>
+ * EBADF - The mqdes argument is not a valid message queue descriptor.
+ * <br>
+ * EINVAL - The process or thread would have blocked, and the abstime parameter specified a nanoseconds field value
+ * less than zero or greater than or equal to 1000 million.
+ * <br>
+ * ETIMEDOUT - The O_NONBLOCK flag was not set when the message queue was opened,
+ * but no message arrived on the queue before the specified timeout expired.
+ * <br>
+ * EAGAIN - O_NONBLOCK was set in the message description associated with mqdes, and the specified message queue is empty.
+ */
+ssize_t mq_receive_loan( mqd_t mqdes,
+                         char ** msg_ptr,
+                         unsigned * msg_prio,
+                         const struct timespec * abstime );
+
+/**
+ * @brief Give back a buffer of a message queue.
+ *
+ * This function is not part of POSIX. msg_ptr must come from mq_loan() or
+ * mq_receive_loan() on the same queue.
+ *
+ * @retval 0 - Upon successful completion.
+ * @retval -1 - An error occurred. errno is also set.
+ *
+ * @sideeffect Possible errno values
+ * <br>
+ * EBADF - The mqdes argument is not a valid message queue descriptor.
+ * <br>
+ * EINVAL - msg_ptr is not a buffer of the message queue currently on loan, e.g. it was already returned.
+ */
+int mq_return( mqd_t mqdes,
+               char * msg_ptr );
+
 #endif /* ifndef _FREERTOS_POSIX_MQUEUE_H_ */
@@ -42,6 +42,14 @@
 
 #undef _SECURE_SOCKETS_WRAPPER_NOT_REDEFINE
 
+/*
+ * The size of the buffer SOCKETS_Sendv() gathers consecutive small buffers in,
+ * so that they are sent as one TLS record. It is allocated on the stack.
+ */
+#ifndef socketsconfigSENDV_TLS_RECORD_BYTES
+    #define socketsconfigSENDV_TLS_RECORD_BYTES    ( 128 )
+#endif
+
 /* Internal context structure. */
 typedef struct SSOCKETContext
 {
@@ -278,6 +286,108 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 }
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxIov,
+                       size_t xIovCount,
+                       uint32_t ulFlags )
+{
+    int32_t lStatus = SOCKETS_ERROR_NONE;
+    int32_t lSent = 0;
+    size_t xIndex = 0;
+    size_t xLength;
+    const void * pvData;
+    uint8_t ucRecord[ socketsconfigSENDV_TLS_RECORD_BYTES ];
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket; /*lint !e9087 cast used for portability. */
+
+    if( ( xSocket != SOCKETS_INVALID_SOCKET ) &&
+        ( pxIov != NULL ) )
+    {
+        pxContext->xSendFlags = ( BaseType_t ) ulFlags;
+
+        /* FreeRTOS+TCP copies each buffer into the socket's stream buffer, so
+         * the buffers leave in as few segments as the window allows. */
+        while( xIndex < xIovCount )
+        {
+            if( pdTRUE == pxContext->xRequireTLS )
+            {
+                /* Gather consecutive small buffers, such as an MQTT fixed
+                 * header and topic, into one TLS record rather than a record
+                 * each. */
+                xLength = 0U;
+
+                while( ( xIndex < xIovCount ) &&
+                       ( pxIov[ xIndex ].xLength <= ( sizeof( ucRecord ) - xLength ) ) )
+                {
+                    if( pxIov[ xIndex ].xLength != 0U )
+                    {
+                        memcpy( &ucRecord[ xLength ], pxIov[ xIndex ].pvBase, pxIov[ xIndex ].xLength );
+                        xLength += pxIov[ xIndex ].xLength;
+                    }
+
+                    xIndex++;
+                }
+
+                if( xLength != 0U )
+                {
+                    pvData = ucRecord;
+                }
+                else if( xIndex < xIovCount )
+                {
+                    /* Too large to gather; it goes through the TLS pipe as is. */
+                    pvData = pxIov[ xIndex ].pvBase;
+                    xLength = pxIov[ xIndex ].xLength;
+                    xIndex++;
+                }
+                else
+                {
+                    /* Only empty buffers were left. */
+                    break;
+                }
+
+                lStatus = TLS_Send( pxContext->pvTLSContext, pvData, xLength );
+            }
+            else
+            {
+                pvData = pxIov[ xIndex ].pvBase;
+                xLength = pxIov[ xIndex ].xLength;
+                xIndex++;
+
+                if( xLength == 0U )
+                {
+                    continue;
+                }
+
+                lStatus = prvNetworkSend( pxContext, pvData, xLength );
+            }
+
+            if( lStatus < 0 )
+            {
+                break;
+            }
+
+            lSent += lStatus;
+
+            if( ( size_t ) lStatus != xLength )
+            {
+                break;
+            }
+        }
+
+        /* A short write hides an error that follows data already sent. */
+        if( ( lStatus >= 0 ) || ( lSent > 0 ) )
+        {
+            lStatus = lSent;
+        }
+    }
+    else
+    {
+        lStatus = SOCKETS_EINVAL;
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_SetSockOpt( Socket_t xSocket,
                             int32_t lLevel,
                             int32_t lOptionName,
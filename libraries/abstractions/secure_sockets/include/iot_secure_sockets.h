@@ -206,6 +206,16 @@ typedef struct SocketsSockaddr
     uint32_t ulAddress;     /**< IP Address. Convention is to call this sin_addr. */
 } SocketsSockaddr_t;
 
+/**
+ * @ingroup SecureSockets_datatypes_paramstructs
+ * @brief A buffer passed to SOCKETS_Sendv().
+ */
+typedef struct SocketsIovec
+{
+    const void * pvBase; /**< Start of the buffer. */
+    size_t xLength;      /**< Length of the buffer in bytes. May be 0. */
+} SocketsIovec_t;
+
 /**
  * @brief Well-known port numbers.
  */
@@ -386,6 +396,38 @@ int32_t SOCKETS_Send( Socket_t xSocket,
                       uint32_t ulFlags );
 /* @[declare_secure_sockets_send] */
 
+/**
+ * @brief Transmit several buffers to the remote socket.
+ *
+ * The buffers are sent back to back, in order, as if they had been copied into
+ * one buffer and passed to SOCKETS_Send(). The socket must have already been
+ * created using a call to SOCKETS_Socket() and connected to a remote socket
+ * using SOCKETS_Connect().
+ *
+ * On a TCP socket, the buffers are queued as one stream and leave in as few
+ * segments as the stack allows. On a TLS socket, consecutive buffers small
+ * enough to be copied together, such as an MQTT fixed header and topic, are
+ * sent as one TLS record; a larger buffer is sent as its own record(s).
+ *
+ * @param[in] xSocket The handle of the sending socket.
+ * @param[in] pxIov The buffers containing the data to be sent.
+ * @param[in] xIovCount The number of buffers in pxIov.
+ * @param[in] ulFlags Not currently used. Should be set to 0.
+ *
+ * @return
+ * * On success, the total number of bytes actually sent is returned. This may
+ *   be less than the total length of the buffers, in which case the data sent
+ *   is a prefix of the buffers.
+ * * If an error occurred before any data was sent, a negative value is returned.
+ *   @ref SocketsErrors
+ */
+/* @[declare_secure_sockets_sendv] */
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxIov,
+                       size_t xIovCount,
+                       uint32_t ulFlags );
+/* @[declare_secure_sockets_sendv] */
+
 /**
  * @brief Closes all or part of a full-duplex connection on the socket.
  *
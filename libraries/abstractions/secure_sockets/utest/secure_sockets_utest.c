@@ -24,6 +24,9 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "unity.h"
 
@@ -35,6 +38,7 @@
 #include "mock_sockets.h"
 #include "mock_portable.h"
 #include "mock_task.h"
+#include "mock_queue.h"
 #include "mock_iot_tls.h"
 #include "mock_iot_logging_task.h"
 #include "mock_dns.h"
@@ -55,7 +59,39 @@ static void initCallbacks();
 
 static uint16_t malloc_free_calls = 0;
 
+/* the receive callback mutex, used across the test and the task threads */
+static pthread_mutex_t rx_mutex;
+
 /* ==========================  CALLBACK FUNCTIONS =========================== */
+QueueHandle_t xQueueCreateMutexStatic_cb( const uint8_t ucQueueType,
+                                          StaticQueue_t * pxStaticQueue,
+                                          int numCalls )
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init( &attr );
+    pthread_mutexattr_settype( &attr, PTHREAD_MUTEX_RECURSIVE );
+    pthread_mutex_init( &rx_mutex, &attr );
+    pthread_mutexattr_destroy( &attr );
+
+    return ( QueueHandle_t ) pxStaticQueue;
+}
+
+BaseType_t xQueueTakeMutexRecursive_cb( QueueHandle_t xMutex,
+                                        TickType_t xTicksToWait,
+                                        int numCalls )
+{
+    pthread_mutex_lock( &rx_mutex );
+    return pdTRUE;
+}
+
+BaseType_t xQueueGiveMutexRecursive_cb( QueueHandle_t xMutex,
+                                        int numCalls )
+{
+    pthread_mutex_unlock( &rx_mutex );
+    return pdTRUE;
+}
+
 /*@null@*/ void * malloc_cb( size_t size,
                              int numCalls )
 {
@@ -130,6 +166,14 @@ static void initCallbacks( void )
 {
     pvPortMalloc_Stub( malloc_cb );
     vPortFree_Stub( free_cb );
+    xQueueCreateMutexStatic_Stub( xQueueCreateMutexStatic_cb );
+    xQueueTakeMutexRecursive_Stub( xQueueTakeMutexRecursive_cb );
+    xQueueGiveMutexRecursive_Stub( xQueueGiveMutexRecursive_cb );
+    vTaskSuspendAll_Ignore();
+    xTaskResumeAll_IgnoreAndReturn( pdFALSE );
+    xTaskGenericNotify_IgnoreAndReturn( pdPASS );
+    xTaskGetCurrentTaskHandle_IgnoreAndReturn( NULL );
+    vTaskDelay_Ignore();
 }
 
 /* helper function to uninitialize the commonly used callbacks */
@@ -314,6 +358,126 @@ void test_SecureSockets_send_not_connected( void )
     deinitSocket( so );
 }
 
+/* ======================  TESTING SOCKETS_Sendv  =========================== */
+
+#define SENDV_MAX_CALLS    ( 4 )
+
+static int sendv_flags[ SENDV_MAX_CALLS ];
+static size_t sendv_lengths[ SENDV_MAX_CALLS ];
+static unsigned char sendv_first_record[ BUFFER_LEN ];
+
+static ssize_t lwip_send_sendv_cb( int s,
+                                   const void * dataptr,
+                                   size_t size,
+                                   int flags,
+                                   int num_calls )
+{
+    TEST_ASSERT_LESS_THAN( SENDV_MAX_CALLS, num_calls );
+    sendv_flags[ num_calls ] = flags;
+    sendv_lengths[ num_calls ] = size;
+    return ( ssize_t ) size;
+}
+
+static BaseType_t TLS_Send_sendv_cb( void * pvContext,
+                                     const unsigned char * pucMsg,
+                                     size_t xMsgLength,
+                                     int num_calls )
+{
+    TEST_ASSERT_LESS_THAN( SENDV_MAX_CALLS, num_calls );
+    sendv_lengths[ num_calls ] = xMsgLength;
+
+    if( 0 == num_calls )
+    {
+        TEST_ASSERT_LESS_OR_EQUAL( BUFFER_LEN, xMsgLength );
+        memcpy( sendv_first_record, pucMsg, xMsgLength );
+    }
+
+    return ( BaseType_t ) xMsgLength;
+}
+
+/*!
+ * @brief Sendv with a trailing empty buffer on a normal socket
+ *
+ * @details The purpose of this testcase is to make sure MSG_MORE is cleared
+ *          on the last buffer holding data, not on a trailing empty one
+ */
+void test_SecureSockets_Sendv_trailing_empty_buffer( void )
+{
+    int32_t ret;
+    Socket_t so = create_normal_connection();
+    const char header[ 2 ] = { 0x30, 0x0b };
+    const char payload[ BUFFER_LEN ] = { 0 };
+    SocketsIovec_t iov[ 3 ] =
+    {
+        { header,  sizeof( header )  },
+        { payload, sizeof( payload ) },
+        { NULL,    0                 }
+    };
+
+    lwip_send_Stub( lwip_send_sendv_cb );
+    ret = SOCKETS_Sendv( so, iov, 3, 0 );
+    TEST_ASSERT_EQUAL_INT( sizeof( header ) + sizeof( payload ), ret );
+    TEST_ASSERT_EQUAL_INT( MSG_MORE, sendv_flags[ 0 ] );
+    TEST_ASSERT_EQUAL_INT( 0, sendv_flags[ 1 ] );
+    TEST_ASSERT_EQUAL_INT( sizeof( payload ), sendv_lengths[ 1 ] );
+    deinitSocket( so );
+}
+
+/*!
+ * @brief Sendv on a TLS socket
+ *
+ * @details The purpose of this testcase is to make sure small leading buffers
+ *          are sent as one TLS record, and a large buffer as its own record
+ */
+void test_SecureSockets_Sendv_tls_gathers_small_buffers( void )
+{
+    int32_t ret;
+    const char header[ 2 ] = { 0x30, 0x0b };
+    const char topic[ 5 ] = { 'a', '/', 'b', '/', 'c' };
+    const char payload[ 2 * BUFFER_LEN ] = { 0 };
+    SocketsIovec_t iov[ 4 ] =
+    {
+        { header,  sizeof( header )  },
+        { topic,   sizeof( topic )   },
+        { payload, sizeof( payload ) },
+        { NULL,    0                 }
+    };
+
+    Socket_t so = create_TLS_connection();
+
+    TLS_Send_Stub( TLS_Send_sendv_cb );
+    ret = SOCKETS_Sendv( so, iov, 4, 0 );
+    TEST_ASSERT_EQUAL_INT( sizeof( header ) + sizeof( topic ) + sizeof( payload ), ret );
+    TEST_ASSERT_EQUAL_INT( sizeof( header ) + sizeof( topic ), sendv_lengths[ 0 ] );
+    TEST_ASSERT_EQUAL_MEMORY( header, sendv_first_record, sizeof( header ) );
+    TEST_ASSERT_EQUAL_MEMORY( topic, &sendv_first_record[ sizeof( header ) ], sizeof( topic ) );
+    TEST_ASSERT_EQUAL_INT( sizeof( payload ), sendv_lengths[ 1 ] );
+    TLS_Cleanup_ExpectAnyArgs();
+    deinitSocket( so );
+}
+
+/*!
+ * @brief Sendv with a NULL buffer after a valid one
+ *
+ * @details The purpose of this testcase is to make sure SOCKETS_Sendv checks
+ *          every buffer before sending any of them
+ */
+void test_SecureSockets_Sendv_invalid_buffer( void )
+{
+    int32_t ret;
+    Socket_t so = create_normal_connection();
+    const char header[ 2 ] = { 0x30, 0x0b };
+    SocketsIovec_t iov[ 2 ] =
+    {
+        { header, sizeof( header ) },
+        { NULL,   BUFFER_LEN       }
+    };
+
+    ret = SOCKETS_Sendv( so, iov, 2, 0 );
+    TEST_ASSERT_EQUAL_INT( SOCKETS_EINVAL, ret );
+    deinitSocket( so );
+}
+
 /* =====================  TESTING SOCKETS_Socket  =========================== */
 
 /*!
@@ -1158,37 +1322,77 @@ void test_SecureSockets_SetsockOpt_nonblock_error( void )
     deinitSocket( so );
 }
 
+#define WAKE_SOCKET    ( 6 )
+
 static TaskHandle_t handle;
-static Socket_t s_so;
 static bool userCallback_called;
+static bool select_blocked;
 static struct event * callback_event;
+static struct event * release_event;
 static struct task * tsk;
 
 static void taskComplete_cb( Socket_t ctx )
 {
-    userCallback_called = true;
-    event_signal( callback_event );
+    if( !userCallback_called )
+    {
+        userCallback_called = true;
+        event_signal( callback_event );
+
+        /* Keep running until the test has used another socket. */
+        event_wait( release_event );
+    }
 }
 
-/* helper function to delete the thread created and free the handle */
-static void vTaskDelete_cb( TaskHandle_t task_handle,
-                            int num_calls )
+/* helper function to report the socket as readable once, and time out after */
+static int lwip_select_cb( int maxfdp1,
+                           fd_set * readset,
+                           fd_set * writeset,
+                           fd_set * exceptset,
+                           struct timeval * timeout,
+                           int num_calls )
+{
+    if( num_calls == 0 )
+    {
+        /* With the wake socket open, the task waits without a timeout. */
+        select_blocked = ( timeout == NULL ) && FD_ISSET( WAKE_SOCKET, readset );
+        FD_CLR( WAKE_SOCKET, readset );
+        FD_ZERO( exceptset );
+        return 1;
+    }
+
+    FD_ZERO( readset );
+    FD_ZERO( exceptset );
+    usleep( 1000 );
+    return 0;
+}
+
+/* helper function to end the receive callback task once no socket is left */
+static uint32_t ulTaskNotifyTake_cb( BaseType_t xClearCountOnExit,
+                                     TickType_t xTicksToWait,
+                                     int num_calls )
 {
-    free_cb( handle, 1 );
     task_kill( tsk );
+    return 0;
 }
 
 /* helper function to create a fake implementation of xTaskCreate */
-static long int xTaskCreate_cb2( TaskFunction_t pxTaskCode,
-                                 const char * const pcName,
-                                 const configSTACK_DEPTH_TYPE usStackDepth,
-                                 void * const pvParameters,
-                                 UBaseType_t uxPriority,
-                                 TaskHandle_t * const pxCreatedTask,
-                                 int num_of_calls )
+static long int xTaskCreate_cb( TaskFunction_t pxTaskCode,
+                                const char * const pcName,
+                                const configSTACK_DEPTH_TYPE usStackDepth,
+                                void * const pvParameters,
+                                UBaseType_t uxPriority,
+                                TaskHandle_t * const pxCreatedTask,
+                                int num_of_calls )
 {
-    lwip_select_IgnoreAndReturn( 1 );
-    vTaskDelete_Stub( vTaskDelete_cb );
+    lwip_select_Stub( lwip_select_cb );
+    ulTaskNotifyTake_Stub( ulTaskNotifyTake_cb );
+
+    /* The task opens the loopback socket that registrations wake it through. */
+    lwip_socket_ExpectAndReturn( AF_INET, SOCK_DGRAM, IPPROTO_UDP, WAKE_SOCKET );
+    lwip_bind_IgnoreAndReturn( 0 );
+    lwip_getsockname_IgnoreAndReturn( 0 );
+    lwip_sendto_IgnoreAndReturn( 1 );
+    lwip_recv_IgnoreAndReturn( 0 );
 
     handle = malloc_cb( sizeof( TaskHandle_t ), 1 );
     *pxCreatedTask = handle;
@@ -1205,65 +1409,25 @@ static long int xTaskCreate_cb2( TaskFunction_t pxTaskCode,
 }
 
 /*!
- * @brief test SetSockOpt sockets_so_wakeup_callback by registering a callback
- *        making sure it got called when an actifity occured on the socket
+ * @brief SetSockOpt SOCKETS_SO_WAKEUP_CALLBACK without a receive callback task
  *
- * The Purpose of this testcase is to make sure the asynchronous operation of
- * sockets is working as expected, the user callback is called when some
- * activity is available on the socket.
+ * The purpose of this testcase is to make sure registering a callback fails
+ * when the task calling the callbacks cannot be created.
  */
-void test_SecureSockets_SetSockOpt_wakeup_callback_socket_close( void )
+void test_SecureSockets_SetSockOpt_wakeup_callback_no_task( void )
 {
+    Socket_t so = SOCKETS_INVALID_SOCKET;
     int32_t ret;
-    void * option = &taskComplete_cb; /* user callback for socket event */
+    void * option = &taskComplete_cb;
 
-    s_so = SOCKETS_INVALID_SOCKET;
-    callback_event = event_create();
-
-    s_so = initSocket();
+    so = initSocket();
 
-    xTaskCreate_Stub( xTaskCreate_cb2 );
-    ret = SOCKETS_SetSockOpt( s_so, 0, SOCKETS_SO_WAKEUP_CALLBACK,
+    xTaskCreate_IgnoreAndReturn( pdFAIL );
+    ret = SOCKETS_SetSockOpt( so, 0, SOCKETS_SO_WAKEUP_CALLBACK,
                               option, sizeof( void * ) );
-    TEST_ASSERT_EQUAL_MESSAGE( SOCKETS_ERROR_NONE, ret,
-                               "set sock opt return error" );
-
-    /* wait for the callback ...to  deinitialize the socket */
-    event_wait( callback_event );
-    deinitSocket( s_so );
-    task_join( tsk );
-    event_delete( callback_event );
-}
+    TEST_ASSERT_EQUAL( SOCKETS_ENOMEM, ret );
 
-static long int xTaskCreate_cb( TaskFunction_t pxTaskCode,
-                                const char * const pcName,
-                                const configSTACK_DEPTH_TYPE usStackDepth,
-                                void * const pvParameters,
-                                UBaseType_t uxPriority,
-                                TaskHandle_t * const pxCreatedTask,
-                                int num_of_calls )
-{
-    handle = malloc_cb( sizeof( TaskHandle_t ), 1 );
-    *pxCreatedTask = handle;
-
-    fd_set read_fds;
-    fd_set read_fds2;
-    FD_ZERO( &read_fds );
-    FD_ZERO( &read_fds2 );
-
-    lwip_select_ExpectAndReturn( 6, &read_fds, &read_fds, &read_fds, NULL, 1 );
-    lwip_select_IgnoreArg_writeset();
-    lwip_select_IgnoreArg_exceptset();
-    lwip_select_IgnoreArg_maxfdp1();
-    lwip_select_IgnoreArg_readset();
-    lwip_select_ReturnMemThruPtr_readset( &read_fds2, sizeof( fd_set ) );
-
-    lwip_select_ExpectAnyArgsAndReturn( -1 );
-
-    vTaskDelete_Ignore();
-    pxTaskCode( pvParameters ); /* pvParameters the socket_t/ss_ctx */
-    /*return pdPASS; */
-    return pdFAIL;
+    deinitSocket( so );
 }
 
 /*!
@@ -1271,36 +1435,61 @@ static long int xTaskCreate_cb( TaskFunction_t pxTaskCode,
  *        making sure it got called when an actifity occured on the socket
  *
  * The Purpose of this testcase is to make sure the asynchronous operation of
- * sockets is working as expected, the user callback is called when some
- * activity is available on the socket.
+ * sockets is working as expected, the user callback is called from the shared
+ * receive callback task when some activity is available on the socket, that
+ * the task blocks in select until it is woken, that other sockets can be
+ * registered and unregistered while a callback runs, and that closing the
+ * socket unregisters it.
  */
 void test_SecureSockets_SetSockOpt_wakeup_callback( void )
 {
     Socket_t so = SOCKETS_INVALID_SOCKET;
+    Socket_t so2 = SOCKETS_INVALID_SOCKET;
     int32_t ret;
     void * option = &taskComplete_cb; /* user callback for socket event */
 
-    xTaskCreate_Stub( xTaskCreate_cb );
+    userCallback_called = false;
+    select_blocked = false;
+    callback_event = event_create();
+    release_event = event_create();
+
     so = initSocket();
 
+    xTaskCreate_Stub( xTaskCreate_cb );
     ret = SOCKETS_SetSockOpt( so, 0, SOCKETS_SO_WAKEUP_CALLBACK,
                               option, sizeof( void * ) );
     TEST_ASSERT_EQUAL( SOCKETS_ERROR_NONE, ret );
 
+    /* wait for the callback, and register and unregister another socket
+     * while it runs */
+    TEST_ASSERT_TRUE( event_wait( callback_event ) );
+
+    so2 = initSocket();
+    ret = SOCKETS_SetSockOpt( so2, 0, SOCKETS_SO_WAKEUP_CALLBACK,
+                              option, sizeof( void * ) );
+    TEST_ASSERT_EQUAL( SOCKETS_ERROR_NONE, ret );
+    ret = SOCKETS_SetSockOpt( so2, 0, SOCKETS_SO_WAKEUP_CALLBACK,
+                              NULL, 0 );
+    TEST_ASSERT_EQUAL( SOCKETS_ERROR_NONE, ret );
+    deinitSocket( so2 );
+
+    /* let the callback return, then close the socket so that the task ends */
+    event_signal( release_event );
     deinitSocket( so );
+    task_join( tsk );
+
     TEST_ASSERT_TRUE( userCallback_called );
-    userCallback_called = false;
+    TEST_ASSERT_TRUE( select_blocked );
+    event_delete( release_event );
+    event_delete( callback_event );
     free_cb( handle, 1 );
 }
 
 /*!
  * @brief SetSockOpt SOCKETS_SO_WAKEUP_CALLBACK
  *
- * The Purpose of this testcase is to
- *
- * @warning currently the clean functionality is not implemented,
- * but once implemented this test case will
- * probably fails until it is updated to test the new code
+ * The Purpose of this testcase is to make sure clearing the callback of a
+ * socket that has none succeeds.
  */
 void test_SecureSockets_SetSockOpt_wakeup_callback_clear( void )
 {
@@ -25,6 +25,7 @@
 
 /* Standard includes */
 #include <stdio.h>
+#include <string.h>
 
 /* Defender internal include. */
 #include "private/aws_iot_defender_internal.h"
@@ -48,6 +49,9 @@
 #define CONN_TAG            AwsIotDefenderInternal_SelectTag( "connections", "cs" )
 #define REMOTE_ADDR_TAG     AwsIotDefenderInternal_SelectTag( "remote_addr", "rad" )
 
+/* Largest CBOR header of a string, container or integer. */
+#define CBOR_HEADER_MAX_SIZE    ( 9U )
+
 /**
  * Structure to hold a metrics report.
  */
@@ -66,9 +70,24 @@ static _metricsReport_t _report =
     .size        = 0
 };
 
+/**
+ * Structure to hold the TCP connections metrics copied for a report.
+ */
+typedef struct _tcpConnectionsSnapshot
+{
+    size_t total;             /* Number of established connections. */
+    char * pRemoteAddresses;      /* NULL-terminated remote addresses, back to back. NULL if not reported. */
+    size_t remoteAddressSize;     /* Size of the remote addresses of the connections. */
+    size_t remoteAddressCapacity; /* Allocated size of pRemoteAddresses. */
+    bool allocationFailed;        /* Set if pRemoteAddresses could not be allocated. */
+} _tcpConnectionsSnapshot_t;
+
 /* Define a "snapshot" global array of metrics flag. */
 static uint32_t _metricsFlagSnapshot[ DEFENDER_METRICS_GROUP_COUNT ];
 
+/* Snapshot of the TCP connections, encoded without holding the metrics lock. */
+static _tcpConnectionsSnapshot_t _tcpConnectionsSnapshot = { 0 };
+
 /* Report id integer. */
 static uint64_t _AwsIotDefenderReportId = 0;
 
@@ -83,10 +102,18 @@ static void _assertSuccessOrBufferToSmall( IotSerializerError_t error );
 
 static void _copyMetricsFlag( void );
 
+static bool _copyMetrics( void );
+
+static void _freeMetricsSnapshot( void );
+
+static size_t _getReportSizeUpperBound( void );
+
 static void serializeReport( void );
 
-static void _serializeTcpConnections( void * param1,
-                                      const IotListDouble_t * pTcpConnectionsMetricsList );
+static void _copyTcpConnections( void * param1,
+                                 const IotListDouble_t * pTcpConnectionsMetricsList );
+
+static void _serializeTcpConnections( IotSerializerEncoderObject_t * pMetricsObject );
 
 #if DEBUG_CBOR_PRINT == 1
     static void _printReport();
@@ -144,17 +171,29 @@ bool AwsIotDefenderInternal_CreateReport( void )
     /* Generate report id based on current time. */
     _AwsIotDefenderReportId = IotClock_GetTimeMs();
 
-    /* Dry-run serialization to calculate the required size. */
-    serializeReport();
+    /* Copy the metrics, so that they are not locked while the report is encoded. */
+    if( _copyMetrics() )
+    {
+        /* The report size is bounded by the copied metrics, so the report can
+         * be encoded in one pass into a buffer of that size. */
+        dataSize = _getReportSizeUpperBound();
+        pReportBuffer = AwsIotDefender_MallocReport( dataSize * sizeof( uint8_t ) );
 
-    /* Get the calculated required size. */
-    dataSize = _pAwsIotDefenderEncoder->getExtraBufferSizeNeeded( pEncoderObject );
+        if( pReportBuffer == NULL )
+        {
+            /* Dry-run serialization to calculate the exact size, which may fit
+             * where the upper bound does not. */
+            serializeReport();
 
-    /* Clean the encoder object handle. */
-    _pAwsIotDefenderEncoder->destroy( pEncoderObject );
+            /* Get the calculated required size. */
+            dataSize = _pAwsIotDefenderEncoder->getExtraBufferSizeNeeded( pEncoderObject );
 
-    /* Allocate memory once. */
-    pReportBuffer = AwsIotDefender_MallocReport( dataSize * sizeof( uint8_t ) );
+            /* Clean the encoder object handle. */
+            _pAwsIotDefenderEncoder->destroy( pEncoderObject );
+
+            pReportBuffer = AwsIotDefender_MallocReport( dataSize * sizeof( uint8_t ) );
+        }
+    }
 
     if( pReportBuffer != NULL )
     {
@@ -174,6 +213,8 @@ bool AwsIotDefenderInternal_CreateReport( void )
         result = false;
     }
 
+    _freeMetricsSnapshot();
+
     return result;
 }
 
@@ -273,7 +314,7 @@ static void serializeReport( void )
             switch( i )
             {
                 case AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS:
-                    IotMetrics_GetTcpConnections( ( void * ) &metricsMap, _serializeTcpConnections );
+                    _serializeTcpConnections( &metricsMap );
                     break;
 
                 default:
@@ -307,11 +348,144 @@ static void _copyMetricsFlag( void )
 
 /*-----------------------------------------------------------*/
 
-static void _serializeTcpConnections( void * param1,
-                                      const IotListDouble_t * pTcpConnectionsMetricsList )
+static bool _copyMetrics( void )
+{
+    /* Only TCP connections are collected so far. */
+    if( _metricsFlagSnapshot[ AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS ] > 0 )
+    {
+        /* The first pass only sizes the remote addresses. The buffer is allocated
+         * without holding the metrics lock, then the addresses are copied;
+         * connections added in between trigger another pass. */
+        IotMetrics_GetTcpConnections( NULL, _copyTcpConnections );
+
+        while( ( _tcpConnectionsSnapshot.remoteAddressSize > _tcpConnectionsSnapshot.remoteAddressCapacity ) &&
+               ( _tcpConnectionsSnapshot.allocationFailed == false ) )
+        {
+            if( _tcpConnectionsSnapshot.pRemoteAddresses != NULL )
+            {
+                AwsIotDefender_FreeReport( _tcpConnectionsSnapshot.pRemoteAddresses );
+            }
+
+            _tcpConnectionsSnapshot.pRemoteAddresses = AwsIotDefender_MallocReport( _tcpConnectionsSnapshot.remoteAddressSize );
+
+            if( _tcpConnectionsSnapshot.pRemoteAddresses == NULL )
+            {
+                _tcpConnectionsSnapshot.remoteAddressCapacity = 0;
+                _tcpConnectionsSnapshot.allocationFailed = true;
+            }
+            else
+            {
+                _tcpConnectionsSnapshot.remoteAddressCapacity = _tcpConnectionsSnapshot.remoteAddressSize;
+
+                IotMetrics_GetTcpConnections( NULL, _copyTcpConnections );
+            }
+        }
+    }
+
+    return !_tcpConnectionsSnapshot.allocationFailed;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _freeMetricsSnapshot( void )
+{
+    if( _tcpConnectionsSnapshot.pRemoteAddresses != NULL )
+    {
+        AwsIotDefender_FreeReport( _tcpConnectionsSnapshot.pRemoteAddresses );
+    }
+
+    ( void ) memset( &_tcpConnectionsSnapshot, 0x00, sizeof( _tcpConnectionsSnapshot ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _getReportSizeUpperBound( void )
 {
-    IotSerializerEncoderObject_t * pMetricsObject = ( IotSerializerEncoderObject_t * ) param1;
+    /* Every key, string, container and integer is counted with the largest
+     * CBOR header. */
+    size_t size = CBOR_HEADER_MAX_SIZE +                                         /* report map */
+                  CBOR_HEADER_MAX_SIZE + strlen( HEADER_TAG ) +                  /* header key */
+                  CBOR_HEADER_MAX_SIZE +                                         /* header map */
+                  CBOR_HEADER_MAX_SIZE + strlen( REPORTID_TAG ) +                /* report_id key */
+                  CBOR_HEADER_MAX_SIZE +                                         /* report_id value */
+                  CBOR_HEADER_MAX_SIZE + strlen( VERSION_TAG ) +                 /* version key */
+                  CBOR_HEADER_MAX_SIZE + strlen( VERSION_1_0 ) +                 /* version value */
+                  CBOR_HEADER_MAX_SIZE + strlen( METRICS_TAG ) +                 /* metrics key */
+                  CBOR_HEADER_MAX_SIZE;                                          /* metrics map */
+
+    if( _metricsFlagSnapshot[ AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS ] > 0 )
+    {
+        size += CBOR_HEADER_MAX_SIZE + strlen( TCP_CONN_TAG ) +                  /* tcp_connections key */
+                CBOR_HEADER_MAX_SIZE +                                           /* tcp_connections map */
+                CBOR_HEADER_MAX_SIZE + strlen( EST_CONN_TAG ) +                  /* established_connections key */
+                CBOR_HEADER_MAX_SIZE +                                           /* established_connections map */
+                CBOR_HEADER_MAX_SIZE + strlen( CONN_TAG ) +                      /* connections key */
+                CBOR_HEADER_MAX_SIZE +                                           /* connections array */
+                CBOR_HEADER_MAX_SIZE + strlen( TOTAL_TAG ) +                     /* total key */
+                CBOR_HEADER_MAX_SIZE;                                            /* total value */
+
+        /* A map per connection, with the remote address if it is reported. */
+        size += _tcpConnectionsSnapshot.total * CBOR_HEADER_MAX_SIZE;
+
+        if( _tcpConnectionsSnapshot.pRemoteAddresses != NULL )
+        {
+            size += _tcpConnectionsSnapshot.total * ( 2U * CBOR_HEADER_MAX_SIZE + strlen( REMOTE_ADDR_TAG ) ) +
+                    _tcpConnectionsSnapshot.remoteAddressSize;
+        }
+    }
+
+    return size;
+}
+
+/*-----------------------------------------------------------*/
 
+static void _copyTcpConnections( void * param1,
+                                 const IotListDouble_t * pTcpConnectionsMetricsList )
+{
+    IotLink_t * pListIterator = NULL;
+    IotMetricsTcpConnection_t * pMetricsTcpConnection = NULL;
+    char * pRemoteAddress = NULL;
+
+    uint32_t tcpConnFlag = _metricsFlagSnapshot[ AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS ];
+
+    ( void ) param1;
+
+    /* This runs with the metrics lock held: only copy what the report needs, and
+     * never allocate. The remote addresses are copied only if they fit in the
+     * buffer allocated after the previous pass. */
+    _tcpConnectionsSnapshot.total = IotListDouble_Count( pTcpConnectionsMetricsList );
+    _tcpConnectionsSnapshot.remoteAddressSize = 0;
+
+    if( ( ( tcpConnFlag & AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS_ESTABLISHED_REMOTE_ADDR ) > 0 ) &&
+        ( ( tcpConnFlag & AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS_ESTABLISHED_CONNECTIONS ) > 0 ) &&
+        ( _tcpConnectionsSnapshot.total > 0 ) )
+    {
+        IotContainers_ForEach( pTcpConnectionsMetricsList, pListIterator )
+        {
+            pMetricsTcpConnection = IotLink_Container( IotMetricsTcpConnection_t, pListIterator, link );
+            _tcpConnectionsSnapshot.remoteAddressSize += pMetricsTcpConnection->addressLength + 1;
+        }
+
+        if( _tcpConnectionsSnapshot.remoteAddressSize <= _tcpConnectionsSnapshot.remoteAddressCapacity )
+        {
+            pRemoteAddress = _tcpConnectionsSnapshot.pRemoteAddresses;
+
+            IotContainers_ForEach( pTcpConnectionsMetricsList, pListIterator )
+            {
+                pMetricsTcpConnection = IotLink_Container( IotMetricsTcpConnection_t, pListIterator, link );
+
+                ( void ) memcpy( pRemoteAddress, pMetricsTcpConnection->pRemoteAddress, pMetricsTcpConnection->addressLength );
+                pRemoteAddress[ pMetricsTcpConnection->addressLength ] = '\0';
+                pRemoteAddress += pMetricsTcpConnection->addressLength + 1;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _serializeTcpConnections( IotSerializerEncoderObject_t * pMetricsObject )
+{
     AwsIotDefender_Assert( pMetricsObject != NULL );
 
     IotSerializerError_t serializerError = IOT_SERIALIZER_SUCCESS;
@@ -320,10 +494,10 @@ static void _serializeTcpConnections( void * param1,
     IotSerializerEncoderObject_t establishedMap = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
     IotSerializerEncoderObject_t connectionsArray = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_ARRAY;
 
-    IotLink_t * pListIterator = NULL;
-    IotMetricsTcpConnection_t * pMetricsTcpConnection = NULL;
+    const char * pRemoteAddress = _tcpConnectionsSnapshot.pRemoteAddresses;
+    size_t i = 0;
 
-    size_t total = IotListDouble_Count( pTcpConnectionsMetricsList );
+    size_t total = _tcpConnectionsSnapshot.total;
 
     uint32_t tcpConnFlag = _metricsFlagSnapshot[ AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS ];
 
@@ -364,7 +538,7 @@ static void _serializeTcpConnections( void * param1,
                                                                              total );
             assertNoError( serializerError );
 
-            IotContainers_ForEach( pTcpConnectionsMetricsList, pListIterator )
+            for( i = 0; i < total; i++ )
             {
                 IotSerializerEncoderObject_t connectionMap = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
 
@@ -377,11 +551,11 @@ static void _serializeTcpConnections( void * param1,
                 /* add remote address */
                 if( hasRemoteAddr )
                 {
-                    pMetricsTcpConnection = IotLink_Container( IotMetricsTcpConnection_t, pListIterator, link );
-
                     serializerError = _pAwsIotDefenderEncoder->appendKeyValue( &connectionMap, REMOTE_ADDR_TAG,
-                                                                               IotSerializer_ScalarTextString( pMetricsTcpConnection->pRemoteAddress ) );
+                                                                               IotSerializer_ScalarTextString( pRemoteAddress ) );
                     assertNoError( serializerError );
+
+                    pRemoteAddress += strlen( pRemoteAddress ) + 1;
                 }
 
                 serializerError = _pAwsIotDefenderEncoder->closeContainer( &connectionsArray, &connectionMap );
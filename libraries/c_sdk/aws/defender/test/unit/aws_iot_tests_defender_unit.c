@@ -57,6 +57,12 @@
  */
 #define AWS_IOT_DEFENDER_DEFAULT_INVALID_METRICS_GROUP    ( 10 )
 
+/**
+ * @brief Remote address of the TCP connection added to the metrics.
+ * Used by the CreateReport_with_TCP_connections unit test.
+ */
+#define TEST_REMOTE_ADDRESS                               "192.0.2.1:8883"
+
 /* Empty callback structure passed to startInfo. */
 static const AwsIotDefenderCallback_t _emptyCallback = { .function = NULL, .pCallbackContext = NULL };
 
@@ -67,8 +73,40 @@ static IotMqttConnection_t _mqttConnection = IOT_MQTT_CONNECTION_INITIALIZER;
 static AwsIotDefenderStartInfo_t _startInfo = AWS_IOT_DEFENDER_START_INFO_INITIALIZER;
 
 static bool _mockedMqttConnection = false;
+
+/* A TCP connection added to the metrics by the test. */
+static IotMetricsTcpConnection_t _testTcpConnection;
+
 /*------------------ Functions -----------------------------*/
 
+/* Metrics callback that adds the connection in pContext to the list. The list
+ * is only modified by the metrics library, but the test has no socket. */
+static void _addTcpConnection( void * pContext,
+                               const IotListDouble_t * pTcpConnectionsMetricsList )
+{
+    IotMetricsTcpConnection_t * pConnection = pContext;
+
+    IotListDouble_InsertTail( ( IotListDouble_t * ) pTcpConnectionsMetricsList, &( pConnection->link ) );
+}
+
+/* Metrics callback that removes the connection in pContext from the list. */
+static void _removeTcpConnection( void * pContext,
+                                  const IotListDouble_t * pTcpConnectionsMetricsList )
+{
+    IotMetricsTcpConnection_t * pConnection = pContext;
+
+    ( void ) pTcpConnectionsMetricsList;
+
+    IotListDouble_Remove( &( pConnection->link ) );
+}
+
+/* Metrics callback that counts the connections in the list. */
+static void _countTcpConnections( void * pContext,
+                                  const IotListDouble_t * pTcpConnectionsMetricsList )
+{
+    *( ( size_t * ) pContext ) = IotListDouble_Count( pTcpConnectionsMetricsList );
+}
+
 TEST_GROUP( Defender_Unit );
 
 TEST_SETUP( Defender_Unit )
@@ -183,6 +221,12 @@ TEST_GROUP_RUNNER( Defender_Unit )
      * Expectation: Start API return "already started" error
      */
     RUN_TEST_CASE( Defender_Unit, Start_should_return_err_if_already_started );
+    /*
+     * Setup: set all TCP connections metrics; add a TCP connection to the metrics
+     * Action: create a report
+     * Expectation: the report is encoded in one pass and lists the connection
+     */
+    RUN_TEST_CASE( Defender_Unit, CreateReport_with_TCP_connections );
 }
 
 TEST( Defender_Unit, SetMetrics_with_invalid_metrics_group )
@@ -299,3 +343,107 @@ TEST( Defender_Unit, SetPeriod_after_started )
 
     TEST_ASSERT_EQUAL( 2 * AWS_IOT_DEFENDER_DEFAULT_PERIOD_SECONDS, AwsIotDefender_GetPeriod() );
 }
+
+TEST( Defender_Unit, CreateReport_with_TCP_connections )
+{
+    size_t total = 0, i = 0, found = 0;
+    const uint8_t * pReport = NULL;
+    size_t reportSize = 0;
+    bool mutexCreated = false, connectionAdded = false, reportCreated = false;
+    IotSerializerDecoderObject_t reportObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t metricsObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t tcpConnObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t estConnObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t totalObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t connsObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderIterator_t connIterator = IOT_SERIALIZER_DECODER_ITERATOR_INITIALIZER;
+
+    TEST_ASSERT_EQUAL( AWS_IOT_DEFENDER_SUCCESS,
+                       AwsIotDefender_SetMetrics( AWS_IOT_DEFENDER_METRICS_TCP_CONNECTIONS,
+                                                  AWS_IOT_DEFENDER_METRICS_ALL ) );
+
+    /* Build the report without starting Defender, which would publish it. */
+    _pAwsIotDefenderEncoder = &_IotSerializerCborEncoder;
+    _pAwsIotDefenderDecoder = &_IotSerializerCborDecoder;
+
+    if( TEST_PROTECT() )
+    {
+        mutexCreated = IotMutex_Create( &_AwsIotDefenderMetrics.mutex, false );
+        TEST_ASSERT_TRUE( mutexCreated );
+
+        ( void ) memset( &_testTcpConnection, 0x00, sizeof( _testTcpConnection ) );
+        ( void ) strcpy( _testTcpConnection.pRemoteAddress, TEST_REMOTE_ADDRESS );
+        _testTcpConnection.addressLength = strlen( TEST_REMOTE_ADDRESS );
+
+        IotMetrics_GetTcpConnections( &_testTcpConnection, _addTcpConnection );
+        connectionAdded = true;
+        IotMetrics_GetTcpConnections( &total, _countTcpConnections );
+
+        reportCreated = AwsIotDefenderInternal_CreateReport();
+        TEST_ASSERT_TRUE( reportCreated );
+
+        pReport = AwsIotDefenderInternal_GetReportBuffer();
+        reportSize = AwsIotDefenderInternal_GetReportBufferSize();
+        TEST_ASSERT_NOT_NULL( pReport );
+        TEST_ASSERT_GREATER_THAN( 0, reportSize );
+
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->init( &reportObject, pReport, reportSize ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &reportObject, "metrics", &metricsObject ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &metricsObject, "tcp_connections", &tcpConnObject ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &tcpConnObject, "established_connections", &estConnObject ) );
+
+        /* Every connection is counted and listed. */
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &estConnObject, "total", &totalObject ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SCALAR_SIGNED_INT, totalObject.type );
+        TEST_ASSERT_EQUAL( total, totalObject.u.value.u.signedInt );
+
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &estConnObject, "connections", &connsObject ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_CONTAINER_ARRAY, connsObject.type );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->stepIn( &connsObject, &connIterator ) );
+
+        for( i = 0; i < total; i++ )
+        {
+            IotSerializerDecoderObject_t connMap = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+            IotSerializerDecoderObject_t remoteAddrObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+
+            TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->get( connIterator, &connMap ) );
+            TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->find( &connMap, "remote_addr", &remoteAddrObject ) );
+            TEST_ASSERT_EQUAL( IOT_SERIALIZER_SCALAR_TEXT_STRING, remoteAddrObject.type );
+
+            if( ( remoteAddrObject.u.value.u.string.length == strlen( TEST_REMOTE_ADDRESS ) ) &&
+                ( memcmp( remoteAddrObject.u.value.u.string.pString, TEST_REMOTE_ADDRESS, strlen( TEST_REMOTE_ADDRESS ) ) == 0 ) )
+            {
+                found++;
+            }
+
+            _pAwsIotDefenderDecoder->destroy( &connMap );
+            TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _pAwsIotDefenderDecoder->next( connIterator ) );
+        }
+
+        TEST_ASSERT_TRUE( _pAwsIotDefenderDecoder->isEndOfContainer( connIterator ) );
+        _pAwsIotDefenderDecoder->stepOut( connIterator, &connsObject );
+
+        TEST_ASSERT_EQUAL( 1, found );
+    }
+
+    _pAwsIotDefenderDecoder->destroy( &connsObject );
+    _pAwsIotDefenderDecoder->destroy( &estConnObject );
+    _pAwsIotDefenderDecoder->destroy( &tcpConnObject );
+    _pAwsIotDefenderDecoder->destroy( &metricsObject );
+    _pAwsIotDefenderDecoder->destroy( &reportObject );
+
+    if( reportCreated )
+    {
+        AwsIotDefenderInternal_DeleteReport();
+    }
+
+    if( connectionAdded )
+    {
+        IotMetrics_GetTcpConnections( &_testTcpConnection, _removeTcpConnection );
+    }
+
+    if( mutexCreated )
+    {
+        IotMutex_Destroy( &_AwsIotDefenderMetrics.mutex );
+    }
+}
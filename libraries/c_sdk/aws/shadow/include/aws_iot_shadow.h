@@ -68,6 +68,26 @@
  * @function_brief{shadow_function_removepersistentsubscriptions}
  * - @function_name{shadow_function_strerror}
  * @function_brief{shadow_function_strerror}
+ * - @function_name{shadow_function_stateinit}
+ * @function_brief{shadow_function_stateinit}
+ * - @function_name{shadow_function_statecleanup}
+ * @function_brief{shadow_function_statecleanup}
+ * - @function_name{shadow_function_statesetinteger}
+ * @function_brief{shadow_function_statesetinteger}
+ * - @function_name{shadow_function_statesetboolean}
+ * @function_brief{shadow_function_statesetboolean}
+ * - @function_name{shadow_function_statesetstring}
+ * @function_brief{shadow_function_statesetstring}
+ * - @function_name{shadow_function_stategetinteger}
+ * @function_brief{shadow_function_stategetinteger}
+ * - @function_name{shadow_function_stategetboolean}
+ * @function_brief{shadow_function_stategetboolean}
+ * - @function_name{shadow_function_stategetstring}
+ * @function_brief{shadow_function_stategetstring}
+ * - @function_name{shadow_function_statemergedelta}
+ * @function_brief{shadow_function_statemergedelta}
+ * - @function_name{shadow_function_statetimedupdate}
+ * @function_brief{shadow_function_statetimedupdate}
  */
 
 /**
@@ -110,6 +130,36 @@
  * @function_page{AwsIotShadow_strerror,shadow,strerror}
  * @function_snippet{shadow,strerror,this}
  * @copydoc AwsIotShadow_strerror
+ * @function_page{AwsIotShadowState_Init,shadow,stateinit}
+ * @function_snippet{shadow,stateinit,this}
+ * @copydoc AwsIotShadowState_Init
+ * @function_page{AwsIotShadowState_Cleanup,shadow,statecleanup}
+ * @function_snippet{shadow,statecleanup,this}
+ * @copydoc AwsIotShadowState_Cleanup
+ * @function_page{AwsIotShadowState_SetInteger,shadow,statesetinteger}
+ * @function_snippet{shadow,statesetinteger,this}
+ * @copydoc AwsIotShadowState_SetInteger
+ * @function_page{AwsIotShadowState_SetBoolean,shadow,statesetboolean}
+ * @function_snippet{shadow,statesetboolean,this}
+ * @copydoc AwsIotShadowState_SetBoolean
+ * @function_page{AwsIotShadowState_SetString,shadow,statesetstring}
+ * @function_snippet{shadow,statesetstring,this}
+ * @copydoc AwsIotShadowState_SetString
+ * @function_page{AwsIotShadowState_GetInteger,shadow,stategetinteger}
+ * @function_snippet{shadow,stategetinteger,this}
+ * @copydoc AwsIotShadowState_GetInteger
+ * @function_page{AwsIotShadowState_GetBoolean,shadow,stategetboolean}
+ * @function_snippet{shadow,stategetboolean,this}
+ * @copydoc AwsIotShadowState_GetBoolean
+ * @function_page{AwsIotShadowState_GetString,shadow,stategetstring}
+ * @function_snippet{shadow,stategetstring,this}
+ * @copydoc AwsIotShadowState_GetString
+ * @function_page{AwsIotShadowState_MergeDelta,shadow,statemergedelta}
+ * @function_snippet{shadow,statemergedelta,this}
+ * @copydoc AwsIotShadowState_MergeDelta
+ * @function_page{AwsIotShadowState_TimedUpdate,shadow,statetimedupdate}
+ * @function_snippet{shadow,statetimedupdate,this}
+ * @copydoc AwsIotShadowState_TimedUpdate
  */
 
 /**
@@ -922,4 +972,231 @@ AwsIotShadowError_t AwsIotShadow_RemovePersistentSubscriptions( IotMqttConnectio
 const char * AwsIotShadow_strerror( AwsIotShadowError_t status );
 /* @[declare_shadow_strerror] */
 
+/*------------------------ Shadow state store functions ---------------------*/
+
+/**
+ * @brief Initialize a Shadow state store.
+ *
+ * The members of `pState` up to #AwsIotShadowState_t.documentBufferSize must be
+ * set before calling this function. Every entry is reported by the first
+ * update of the state.
+ *
+ * @param[in] pState The state store to initialize.
+ *
+ * @return One of the following:
+ * - #AWS_IOT_SHADOW_SUCCESS
+ * - #AWS_IOT_SHADOW_BAD_PARAMETER
+ * - #AWS_IOT_SHADOW_NO_MEMORY
+ *
+ * <b>Example</b>
+ * @code{c}
+ * static char color[ 16 ];
+ * static IotJsonToken_t tokens[ 32 ];
+ * static char document[ 256 ];
+ *
+ * // "led": { "on": ..., "color": ... }, "temperature": ...
+ * static AwsIotShadowStateEntry_t entries[] =
+ * {
+ *     AWS_IOT_SHADOW_STATE_OBJECT_ENTRY( "led", AWS_IOT_SHADOW_STATE_NO_PARENT ),
+ *     AWS_IOT_SHADOW_STATE_BOOLEAN_ENTRY( "on", 0 ),
+ *     AWS_IOT_SHADOW_STATE_STRING_ENTRY( "color", 0, color ),
+ *     AWS_IOT_SHADOW_STATE_INTEGER_ENTRY( "temperature", AWS_IOT_SHADOW_STATE_NO_PARENT )
+ * };
+ *
+ * AwsIotShadowState_t state = AWS_IOT_SHADOW_STATE_INITIALIZER;
+ *
+ * state.pEntries = entries;
+ * state.entryCount = sizeof( entries ) / sizeof( entries[ 0 ] );
+ * state.pTokens = tokens;
+ * state.maxTokens = sizeof( tokens ) / sizeof( tokens[ 0 ] );
+ * state.pDocumentBuffer = document;
+ * state.documentBufferSize = sizeof( document );
+ *
+ * result = AwsIotShadowState_Init( &state );
+ * @endcode
+ */
+/* @[declare_shadow_stateinit] */
+AwsIotShadowError_t AwsIotShadowState_Init( AwsIotShadowState_t * pState );
+/* @[declare_shadow_stateinit] */
+
+/**
+ * @brief Free the resources of a Shadow state store.
+ *
+ * @param[in] pState A state store initialized by @ref shadow_function_stateinit.
+ */
+/* @[declare_shadow_statecleanup] */
+void AwsIotShadowState_Cleanup( AwsIotShadowState_t * pState );
+/* @[declare_shadow_statecleanup] */
+
+/**
+ * @brief Set the value of an integer entry of a Shadow state store.
+ *
+ * The entry is reported by the next update only if its value changes.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[in] value The new value.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER.
+ */
+/* @[declare_shadow_statesetinteger] */
+AwsIotShadowError_t AwsIotShadowState_SetInteger( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  int64_t value );
+/* @[declare_shadow_statesetinteger] */
+
+/**
+ * @brief Set the value of a boolean entry of a Shadow state store.
+ *
+ * The entry is reported by the next update only if its value changes.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[in] value The new value.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER.
+ */
+/* @[declare_shadow_statesetboolean] */
+AwsIotShadowError_t AwsIotShadowState_SetBoolean( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  bool value );
+/* @[declare_shadow_statesetboolean] */
+
+/**
+ * @brief Set the value of a string entry of a Shadow state store.
+ *
+ * The entry is reported by the next update only if its value changes.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[in] pValue The new value, escaped as in a JSON string.
+ * @param[in] valueLength Length of `pValue`. It must be less than the size of
+ * the buffer of the entry.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER.
+ */
+/* @[declare_shadow_statesetstring] */
+AwsIotShadowError_t AwsIotShadowState_SetString( AwsIotShadowState_t * pState,
+                                                 size_t entryIndex,
+                                                 const char * pValue,
+                                                 size_t valueLength );
+/* @[declare_shadow_statesetstring] */
+
+/**
+ * @brief Get the value of an integer entry of a Shadow state store.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[out] pValue Set to the value of the entry.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER.
+ */
+/* @[declare_shadow_stategetinteger] */
+AwsIotShadowError_t AwsIotShadowState_GetInteger( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  int64_t * pValue );
+/* @[declare_shadow_stategetinteger] */
+
+/**
+ * @brief Get the value of a boolean entry of a Shadow state store.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[out] pValue Set to the value of the entry.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER.
+ */
+/* @[declare_shadow_stategetboolean] */
+AwsIotShadowError_t AwsIotShadowState_GetBoolean( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  bool * pValue );
+/* @[declare_shadow_stategetboolean] */
+
+/**
+ * @brief Copy the value of a string entry of a Shadow state store.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry in #AwsIotShadowState_t.pEntries.
+ * @param[out] pBuffer Buffer to copy the value and a NULL terminator into.
+ * @param[in] bufferSize Size of `pBuffer`.
+ * @param[out] pValueLength Set to the length of the value. Optional; pass `NULL`
+ * to ignore.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_BAD_PARAMETER, which
+ * includes `pBuffer` being too small.
+ */
+/* @[declare_shadow_stategetstring] */
+AwsIotShadowError_t AwsIotShadowState_GetString( AwsIotShadowState_t * pState,
+                                                 size_t entryIndex,
+                                                 char * pBuffer,
+                                                 size_t bufferSize,
+                                                 size_t * pValueLength );
+/* @[declare_shadow_stategetstring] */
+
+/**
+ * @brief Merge a Shadow delta document into a Shadow state store.
+ *
+ * This function may be called from a [delta callback](@ref shadow_function_setdeltacallback)
+ * with the received document. The `desired` values in the delta are written
+ * into the matching entries, which are then reported by the next update to
+ * clear the delta. Keys without an entry, or whose value does not match the
+ * type of their entry, are ignored.
+ *
+ * Delta documents may be received out of order. A delta document whose
+ * `version` is not newer than the last merged one is ignored.
+ *
+ * @param[in] pState The state store.
+ * @param[in] pDeltaDocument The delta document.
+ * @param[in] deltaDocumentLength Length of `pDeltaDocument`.
+ * @param[out] pChangedCount Set to the number of entries whose value changed.
+ * Optional; pass `NULL` to ignore.
+ *
+ * @return One of the following:
+ * - #AWS_IOT_SHADOW_SUCCESS
+ * - #AWS_IOT_SHADOW_BAD_PARAMETER
+ * - #AWS_IOT_SHADOW_BAD_RESPONSE if the document could not be parsed, including
+ * having more tokens than #AwsIotShadowState_t.maxTokens.
+ */
+/* @[declare_shadow_statemergedelta] */
+AwsIotShadowError_t AwsIotShadowState_MergeDelta( AwsIotShadowState_t * pState,
+                                                  const char * pDeltaDocument,
+                                                  size_t deltaDocumentLength,
+                                                  size_t * pChangedCount );
+/* @[declare_shadow_statemergedelta] */
+
+/**
+ * @brief Report the changed entries of a Shadow state store with a timeout.
+ *
+ * This function sends a Shadow update whose `reported` state holds only the
+ * entries whose values differ from the ones the Shadow service last accepted.
+ * A value changed and then restored before an update is not reported. If no
+ * entry differs, it returns #AWS_IOT_SHADOW_SUCCESS without sending anything.
+ * If the update is not accepted, its entries are reported again by the next
+ * update.
+ *
+ * The document is written in #AwsIotShadowState_t.pDocumentBuffer, so updates
+ * of a state store are serialized: a call waits for the update in progress to
+ * complete. The entries may still be set, read and merged while an update is
+ * in progress.
+ *
+ * @param[in] mqttConnection The MQTT connection to use for Shadow update.
+ * @param[in] pState The state store.
+ * @param[in] pUpdateInfo Shadow document parameters. The members in
+ * `u.update` are ignored.
+ * @param[in] flags Flags which modify the behavior of this function. See
+ * @ref shadow_constants_flags.
+ * @param[in] timeoutMs If the Shadow service does not respond to the Shadow update
+ * within this timeout, this function returns #AWS_IOT_SHADOW_TIMEOUT.
+ *
+ * @return The same values as @ref shadow_function_timedupdate. If the document
+ * does not fit in #AwsIotShadowState_t.pDocumentBuffer, #AWS_IOT_SHADOW_NO_MEMORY.
+ */
+/* @[declare_shadow_statetimedupdate] */
+AwsIotShadowError_t AwsIotShadowState_TimedUpdate( IotMqttConnection_t mqttConnection,
+                                                   AwsIotShadowState_t * pState,
+                                                   const AwsIotShadowDocumentInfo_t * pUpdateInfo,
+                                                   uint32_t flags,
+                                                   uint32_t timeoutMs );
+/* @[declare_shadow_statetimedupdate] */
+
 #endif /* ifndef AWS_IOT_SHADOW_H_ */
@@ -340,6 +340,20 @@ typedef enum AwsIotShadowCallbackType
     AWS_IOT_SHADOW_UPDATED_CALLBACK /**< Callback invoked for an incoming message on a [Shadow updated](@ref shadow_function_setupdatedcallback) topic. */
 } AwsIotShadowCallbackType_t;
 
+/**
+ * @ingroup shadow_datatypes_enums
+ * @brief Types of the values in a Shadow state store.
+ *
+ * One of these values is placed in #AwsIotShadowStateEntry_t.type.
+ */
+typedef enum AwsIotShadowStateType
+{
+    AWS_IOT_SHADOW_STATE_OBJECT,  /**< A JSON object holding other entries. */
+    AWS_IOT_SHADOW_STATE_INTEGER, /**< A JSON integer. */
+    AWS_IOT_SHADOW_STATE_BOOLEAN, /**< A JSON `true` or `false`. */
+    AWS_IOT_SHADOW_STATE_STRING   /**< A JSON string, stored as it appears in JSON, without quotes. */
+} AwsIotShadowStateType_t;
+
 /*------------------------- Shadow parameter structs ------------------------*/
 
 /**
@@ -483,6 +497,100 @@ typedef struct AwsIotShadowDocumentInfo
     } u;                                  /**< @brief Valid member depends on operation type. */
 } AwsIotShadowDocumentInfo_t;
 
+/**
+ * @ingroup shadow_datatypes_paramstructs
+ * @brief A summary of a value of a Shadow state entry, kept to tell whether the
+ * value differs from the one last accepted by the Shadow service.
+ *
+ * Strings are summarized by their length and a 32-bit FNV-1a hash, so that a
+ * state store does not need a second buffer for each string entry. This type
+ * is private to the Shadow library.
+ */
+typedef union AwsIotShadowStateSummary
+{
+    int64_t integer;      /**< @brief Value of an integer entry. */
+    bool boolean;         /**< @brief Value of a boolean entry. */
+
+    struct
+    {
+        uint32_t hash;    /**< @brief Hash of the string. */
+        size_t length;    /**< @brief Length of the string. */
+    } string;             /**< @brief Summary of a string entry. */
+} AwsIotShadowStateSummary_t;
+
+/**
+ * @ingroup shadow_datatypes_paramstructs
+ * @brief A value in a Shadow state store.
+ *
+ * @paramfor @ref shadow_function_stateinit
+ *
+ * The entries of a state store form a tree of the keys under `state` in a
+ * Shadow document. An object entry must come before the entries it holds.
+ * Entries should be initialized with the entry initializers, such as
+ * #AWS_IOT_SHADOW_STATE_INTEGER_ENTRY.
+ */
+typedef struct AwsIotShadowStateEntry
+{
+    const char * pKey;            /**< @brief Key of the entry in its object. */
+    size_t keyLength;             /**< @brief Length of #AwsIotShadowStateEntry_t.pKey. */
+    int32_t parent;               /**< @brief Index of the object entry holding this entry, or #AWS_IOT_SHADOW_STATE_NO_PARENT. */
+    AwsIotShadowStateType_t type; /**< @brief Type of the value. */
+
+    union
+    {
+        int64_t integer;           /**< @brief Value of an integer entry. */
+        bool boolean;              /**< @brief Value of a boolean entry. */
+
+        struct
+        {
+            char * pBuffer;        /**< @brief Buffer holding the string, which is kept NULL-terminated. */
+            size_t bufferSize;     /**< @brief Size of pBuffer. */
+            size_t length;         /**< @brief Length of the string. */
+        } string;                  /**< @brief Value of a string entry. */
+    } u;                           /**< @brief Valid member depends on the type. */
+
+    uint32_t flags;                       /**< @brief Report status of the entry, set by the Shadow library. */
+    AwsIotShadowStateSummary_t accepted;  /**< @brief The value last accepted by the Shadow service, set by the Shadow library. */
+    AwsIotShadowStateSummary_t reporting; /**< @brief The value reported by the update in progress, set by the Shadow library. */
+} AwsIotShadowStateEntry_t;
+
+/**
+ * @ingroup shadow_datatypes_paramstructs
+ * @brief A device-side copy of the state of a Thing Shadow.
+ *
+ * @paramfor @ref shadow_function_stateinit, @ref shadow_function_statetimedupdate,
+ * @ref shadow_function_statemergedelta
+ *
+ * A state store tracks which of its entries differ from the values the Shadow
+ * service last accepted, so that an update only reports those entries. The
+ * members up to #AwsIotShadowState_t.documentBufferSize must be set before
+ * calling @ref shadow_function_stateinit; the others are private.
+ *
+ * @initializer{AwsIotShadowState_t,AWS_IOT_SHADOW_STATE_INITIALIZER}
+ */
+typedef struct AwsIotShadowState
+{
+    AwsIotShadowStateEntry_t * pEntries; /**< @brief The entries of the state. */
+    size_t entryCount;                   /**< @brief Number of entries in #AwsIotShadowState_t.pEntries. */
+
+    /**
+     * @brief Tokens to index incoming delta documents.
+     *
+     * Each key, value and object of a delta document takes a token, including
+     * its `metadata`. This is an array of `IotJsonToken_t`, declared in
+     * iot_json_utils.h.
+     */
+    struct IotJsonToken * pTokens;
+    size_t maxTokens;                    /**< @brief Number of tokens in #AwsIotShadowState_t.pTokens. */
+
+    char * pDocumentBuffer;              /**< @brief Buffer for the update documents of the state. */
+    size_t documentBufferSize;           /**< @brief Size of #AwsIotShadowState_t.pDocumentBuffer. */
+
+    uint32_t version;                    /**< @brief Version of the last merged delta document. */
+    IotMutex_t mutex;                    /**< @brief Protects the entries. */
+    IotMutex_t updateMutex;              /**< @brief Serializes updates and protects the document buffer. */
+} AwsIotShadowState_t;
+
 /*------------------------ Shadow defined constants -------------------------*/
 
 /**
@@ -541,8 +649,52 @@ typedef struct AwsIotShadowDocumentInfo
 #define AWS_IOT_SHADOW_CALLBACK_INFO_INITIALIZER    { 0 }        /**< @brief Initializer for #AwsIotShadowCallbackInfo_t. */
 #define AWS_IOT_SHADOW_DOCUMENT_INFO_INITIALIZER    { 0 }        /**< @brief Initializer for #AwsIotShadowDocumentInfo_t. */
 #define AWS_IOT_SHADOW_OPERATION_INITIALIZER        NULL         /**< @brief Initializer for #AwsIotShadowOperation_t. */
+#define AWS_IOT_SHADOW_STATE_INITIALIZER            { 0 }        /**< @brief Initializer for #AwsIotShadowState_t. */
 /* @[define_shadow_initializers] */
 
+/**
+ * @brief The parent of the entries at the top of a Shadow state store.
+ */
+#define AWS_IOT_SHADOW_STATE_NO_PARENT                     ( -1 )
+
+/**
+ * @brief Initializer for an object #AwsIotShadowStateEntry_t.
+ *
+ * @param[in] key The key of the entry, which must be a string literal.
+ * @param[in] parentIndex Index of the object entry holding this entry.
+ */
+#define AWS_IOT_SHADOW_STATE_OBJECT_ENTRY( key, parentIndex ) \
+    { .pKey = ( key ), .keyLength = sizeof( key ) - 1, .parent = ( parentIndex ), .type = AWS_IOT_SHADOW_STATE_OBJECT }
+
+/**
+ * @brief Initializer for an integer #AwsIotShadowStateEntry_t.
+ *
+ * @param[in] key The key of the entry, which must be a string literal.
+ * @param[in] parentIndex Index of the object entry holding this entry.
+ */
+#define AWS_IOT_SHADOW_STATE_INTEGER_ENTRY( key, parentIndex ) \
+    { .pKey = ( key ), .keyLength = sizeof( key ) - 1, .parent = ( parentIndex ), .type = AWS_IOT_SHADOW_STATE_INTEGER }
+
+/**
+ * @brief Initializer for a boolean #AwsIotShadowStateEntry_t.
+ *
+ * @param[in] key The key of the entry, which must be a string literal.
+ * @param[in] parentIndex Index of the object entry holding this entry.
+ */
+#define AWS_IOT_SHADOW_STATE_BOOLEAN_ENTRY( key, parentIndex ) \
+    { .pKey = ( key ), .keyLength = sizeof( key ) - 1, .parent = ( parentIndex ), .type = AWS_IOT_SHADOW_STATE_BOOLEAN }
+
+/**
+ * @brief Initializer for a string #AwsIotShadowStateEntry_t.
+ *
+ * @param[in] key The key of the entry, which must be a string literal.
+ * @param[in] parentIndex Index of the object entry holding this entry.
+ * @param[in] buffer A `char` array to hold the string.
+ */
+#define AWS_IOT_SHADOW_STATE_STRING_ENTRY( key, parentIndex, buffer )                                                  \
+    { .pKey = ( key ), .keyLength = sizeof( key ) - 1, .parent = ( parentIndex ), .type = AWS_IOT_SHADOW_STATE_STRING, \
+      .u.string = { .pBuffer = ( buffer ), .bufferSize = sizeof( buffer ) } }
+
 /**
  * @brief Allows the use of @ref shadow_function_wait for blocking until completion.
  *
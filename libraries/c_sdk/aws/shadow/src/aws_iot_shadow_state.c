@@ -0,0 +1,1242 @@
+/*
+ * FreeRTOS Shadow V2.2.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_iot_shadow_state.c
+ * @brief Implements the Shadow state store, which reports only the changes of
+ * a Shadow's state.
+ */
+
+/* The config header is always included first. */
+#include "iot_config.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Shadow internal include. */
+#include "private/aws_iot_shadow_internal.h"
+
+/* Platform clock include. */
+#include "platform/iot_clock.h"
+
+/* Platform threads include. */
+#include "platform/iot_threads.h"
+
+/* JSON utilities include. */
+#include "iot_json_utils.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The value of an entry differs from the one last accepted by the Shadow
+ * service, or was merged from a delta document.
+ */
+#define STATE_FLAG_CHANGED            ( 0x00000001UL )
+
+/**
+ * @brief The value of an entry is reported by the update in progress.
+ */
+#define STATE_FLAG_REPORTING          ( 0x00000002UL )
+
+/**
+ * @brief An object entry holds changed entries. Only valid while building an
+ * update document.
+ */
+#define STATE_FLAG_HOLDS_CHANGES      ( 0x00000004UL )
+
+/**
+ * @brief #AwsIotShadowStateEntry_t.accepted holds the value last accepted by
+ * the Shadow service.
+ */
+#define STATE_FLAG_ACCEPTED           ( 0x00000008UL )
+
+/**
+ * @brief The offset basis of the 32-bit FNV-1a hash of string values.
+ */
+#define FNV_OFFSET_BASIS              ( 2166136261UL )
+
+/**
+ * @brief The prime of the 32-bit FNV-1a hash of string values.
+ */
+#define FNV_PRIME                     ( 16777619UL )
+
+/**
+ * @brief The JSON key for the version of a delta document.
+ */
+#define DELTA_VERSION_KEY             "version"
+
+/**
+ * @brief The length of #DELTA_VERSION_KEY.
+ */
+#define DELTA_VERSION_KEY_LENGTH      ( sizeof( DELTA_VERSION_KEY ) - 1 )
+
+/**
+ * @brief The JSON key for the state of a delta document.
+ */
+#define DELTA_STATE_KEY               "state"
+
+/**
+ * @brief The length of #DELTA_STATE_KEY.
+ */
+#define DELTA_STATE_KEY_LENGTH        ( sizeof( DELTA_STATE_KEY ) - 1 )
+
+/**
+ * @brief The start of an update document, up to the reported state.
+ */
+#define UPDATE_DOCUMENT_START         "{\"state\":{\"reported\":"
+
+/**
+ * @brief The part of an update document between the reported state and the
+ * client token.
+ */
+#define UPDATE_DOCUMENT_CLIENT_TOKEN  "},\"" CLIENT_TOKEN_KEY "\":\""
+
+/**
+ * @brief The end of an update document, after the client token.
+ */
+#define UPDATE_DOCUMENT_END           "\"}"
+
+/**
+ * @brief Client tokens are generated from the clock modulo this value.
+ */
+#define CLIENT_TOKEN_MODULUS          ( 1000000ULL )
+
+/**
+ * @brief The maximum number of digits parsed for an integer value.
+ *
+ * Any 18-digit decimal number fits in an `int64_t`.
+ */
+#define MAX_INTEGER_DIGITS            ( 18 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Output of the update document of a state store.
+ */
+typedef struct _stateWriter
+{
+    char * pBuffer;    /**< @brief The document buffer. */
+    size_t bufferSize; /**< @brief Size of the document buffer. */
+    size_t length;     /**< @brief Length of the document written so far. */
+    bool overflow;     /**< @brief Whether the document did not fit in the buffer. */
+} _stateWriter_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the parameters of a function that accesses an entry.
+ *
+ * @param[in] pState The state store.
+ * @param[in] entryIndex Index of the entry.
+ * @param[in] type The expected type of the entry.
+ *
+ * @return `true` if the entry exists and has the expected type; `false` otherwise.
+ */
+static bool _validateEntry( const AwsIotShadowState_t * pState,
+                            size_t entryIndex,
+                            AwsIotShadowStateType_t type );
+
+/**
+ * @brief Summarize the value of an entry.
+ *
+ * @param[in] pEntry A non-object entry.
+ * @param[out] pSummary Set to the summary of the value.
+ */
+static void _summarize( const AwsIotShadowStateEntry_t * pEntry,
+                        AwsIotShadowStateSummary_t * pSummary );
+
+/**
+ * @brief Set or clear the changed flag of an entry by comparing its value with
+ * the one last accepted by the Shadow service.
+ *
+ * @param[in] pEntry A non-object entry.
+ */
+static void _refreshChanged( AwsIotShadowStateEntry_t * pEntry );
+
+/**
+ * @brief Set the value of an integer entry.
+ *
+ * @param[in] pEntry The entry.
+ * @param[in] value The new value.
+ *
+ * @return `true` if the value of the entry changed; `false` otherwise.
+ */
+static bool _setInteger( AwsIotShadowStateEntry_t * pEntry,
+                         int64_t value );
+
+/**
+ * @brief Set the value of a boolean entry.
+ *
+ * @param[in] pEntry The entry.
+ * @param[in] value The new value.
+ *
+ * @return `true` if the value of the entry changed; `false` otherwise.
+ */
+static bool _setBoolean( AwsIotShadowStateEntry_t * pEntry,
+                         bool value );
+
+/**
+ * @brief Set the value of a string entry.
+ *
+ * @param[in] pEntry The entry.
+ * @param[in] pValue The new value. Its length must be less than the buffer size
+ * of the entry.
+ * @param[in] valueLength Length of `pValue`.
+ *
+ * @return `true` if the value of the entry changed; `false` otherwise.
+ */
+static bool _setString( AwsIotShadowStateEntry_t * pEntry,
+                        const char * pValue,
+                        size_t valueLength );
+
+/**
+ * @brief Parse a JSON integer.
+ *
+ * @param[in] pValue The JSON value.
+ * @param[in] valueLength Length of `pValue`.
+ * @param[out] pInteger Set to the integer if parsed.
+ *
+ * @return `true` if `pValue` is an integer that fits in an `int64_t`; `false` otherwise.
+ */
+static bool _parseInteger( const char * pValue,
+                           size_t valueLength,
+                           int64_t * pInteger );
+
+/**
+ * @brief Merge an object of a delta document into the entries it holds.
+ *
+ * @param[in] pState The state store.
+ * @param[in] pIndex Index of the delta document.
+ * @param[in] parent Index of the object entry; #AWS_IOT_SHADOW_STATE_NO_PARENT
+ * for the `state` of the delta document.
+ * @param[in] objectToken Token of the object in the delta document.
+ *
+ * @return The number of entries whose value changed.
+ */
+static size_t _mergeObject( AwsIotShadowState_t * pState,
+                            const IotJsonIndex_t * pIndex,
+                            int32_t parent,
+                            size_t objectToken );
+
+/**
+ * @brief Write data to an update document.
+ *
+ * @param[in] pWriter The update document.
+ * @param[in] pData The data to write.
+ * @param[in] dataLength Length of `pData`.
+ */
+static void _write( _stateWriter_t * pWriter,
+                    const char * pData,
+                    size_t dataLength );
+
+/**
+ * @brief Write an integer to an update document.
+ *
+ * @param[in] pWriter The update document.
+ * @param[in] value The integer to write.
+ */
+static void _writeInteger( _stateWriter_t * pWriter,
+                           int64_t value );
+
+/**
+ * @brief Write the changed entries held by an object to an update document.
+ *
+ * @param[in] pState The state store.
+ * @param[in] pWriter The update document.
+ * @param[in] parent Index of the object entry; #AWS_IOT_SHADOW_STATE_NO_PARENT
+ * for the entries at the top of the state.
+ */
+static void _writeObject( const AwsIotShadowState_t * pState,
+                          _stateWriter_t * pWriter,
+                          int32_t parent );
+
+/**
+ * @brief Write the update document of the changed entries of a state store.
+ *
+ * The changed entries are marked as reporting if the document is written.
+ *
+ * @param[in] pState The state store.
+ * @param[out] pDocumentLength Set to the length of the document; 0 if no entry
+ * changed.
+ *
+ * @return #AWS_IOT_SHADOW_SUCCESS or #AWS_IOT_SHADOW_NO_MEMORY.
+ */
+static AwsIotShadowError_t _buildUpdate( AwsIotShadowState_t * pState,
+                                         size_t * pDocumentLength );
+
+/**
+ * @brief Complete the update of the entries marked as reporting.
+ *
+ * @param[in] pState The state store.
+ * @param[in] accepted Whether the Shadow service accepted the update. If so,
+ * the reported values become the accepted ones; if not, the entries are
+ * reported again by the next update.
+ */
+static void _completeUpdate( AwsIotShadowState_t * pState,
+                             bool accepted );
+
+/*-----------------------------------------------------------*/
+
+static bool _validateEntry( const AwsIotShadowState_t * pState,
+                            size_t entryIndex,
+                            AwsIotShadowStateType_t type )
+{
+    bool status = true;
+
+    if( pState == NULL )
+    {
+        IotLogError( "Shadow state cannot be NULL." );
+
+        status = false;
+    }
+    else if( entryIndex >= pState->entryCount )
+    {
+        IotLogError( "Shadow state entry %lu does not exist.",
+                     ( unsigned long ) entryIndex );
+
+        status = false;
+    }
+    else if( pState->pEntries[ entryIndex ].type != type )
+    {
+        IotLogError( "Shadow state entry %.*s does not have type %d.",
+                     pState->pEntries[ entryIndex ].keyLength,
+                     pState->pEntries[ entryIndex ].pKey,
+                     ( int ) type );
+
+        status = false;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _summarize( const AwsIotShadowStateEntry_t * pEntry,
+                        AwsIotShadowStateSummary_t * pSummary )
+{
+    size_t i = 0;
+
+    ( void ) memset( pSummary, 0x00, sizeof( AwsIotShadowStateSummary_t ) );
+
+    switch( pEntry->type )
+    {
+        case AWS_IOT_SHADOW_STATE_INTEGER:
+            pSummary->integer = pEntry->u.integer;
+            break;
+
+        case AWS_IOT_SHADOW_STATE_BOOLEAN:
+            pSummary->boolean = pEntry->u.boolean;
+            break;
+
+        case AWS_IOT_SHADOW_STATE_STRING:
+            pSummary->string.hash = FNV_OFFSET_BASIS;
+            pSummary->string.length = pEntry->u.string.length;
+
+            for( i = 0; i < pEntry->u.string.length; i++ )
+            {
+                pSummary->string.hash ^= ( uint8_t ) pEntry->u.string.pBuffer[ i ];
+                pSummary->string.hash *= FNV_PRIME;
+            }
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _refreshChanged( AwsIotShadowStateEntry_t * pEntry )
+{
+    bool changed = true;
+    AwsIotShadowStateSummary_t current;
+
+    if( ( pEntry->flags & STATE_FLAG_ACCEPTED ) != 0 )
+    {
+        _summarize( pEntry, &current );
+
+        switch( pEntry->type )
+        {
+            case AWS_IOT_SHADOW_STATE_INTEGER:
+                changed = ( current.integer != pEntry->accepted.integer );
+                break;
+
+            case AWS_IOT_SHADOW_STATE_BOOLEAN:
+                changed = ( current.boolean != pEntry->accepted.boolean );
+                break;
+
+            case AWS_IOT_SHADOW_STATE_STRING:
+                changed = ( current.string.length != pEntry->accepted.string.length ) ||
+                          ( current.string.hash != pEntry->accepted.string.hash );
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if( changed == true )
+    {
+        pEntry->flags |= STATE_FLAG_CHANGED;
+    }
+    else
+    {
+        pEntry->flags &= ~STATE_FLAG_CHANGED;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _setInteger( AwsIotShadowStateEntry_t * pEntry,
+                         int64_t value )
+{
+    bool changed = ( pEntry->u.integer != value );
+
+    if( changed == true )
+    {
+        pEntry->u.integer = value;
+        _refreshChanged( pEntry );
+    }
+
+    return changed;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _setBoolean( AwsIotShadowStateEntry_t * pEntry,
+                         bool value )
+{
+    bool changed = ( pEntry->u.boolean != value );
+
+    if( changed == true )
+    {
+        pEntry->u.boolean = value;
+        _refreshChanged( pEntry );
+    }
+
+    return changed;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _setString( AwsIotShadowStateEntry_t * pEntry,
+                        const char * pValue,
+                        size_t valueLength )
+{
+    bool changed = ( pEntry->u.string.length != valueLength ) ||
+                   ( memcmp( pEntry->u.string.pBuffer, pValue, valueLength ) != 0 );
+
+    AwsIotShadow_Assert( valueLength < pEntry->u.string.bufferSize );
+
+    if( changed == true )
+    {
+        ( void ) memcpy( pEntry->u.string.pBuffer, pValue, valueLength );
+        pEntry->u.string.pBuffer[ valueLength ] = '\0';
+        pEntry->u.string.length = valueLength;
+        _refreshChanged( pEntry );
+    }
+
+    return changed;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _parseInteger( const char * pValue,
+                           size_t valueLength,
+                           int64_t * pInteger )
+{
+    bool status = true;
+    bool negative = false;
+    size_t i = 0;
+    int64_t integer = 0;
+
+    if( ( valueLength > 0 ) && ( pValue[ 0 ] == '-' ) )
+    {
+        negative = true;
+        i++;
+    }
+
+    /* There must be at least one digit, and few enough not to overflow. */
+    if( ( i == valueLength ) || ( valueLength - i > MAX_INTEGER_DIGITS ) )
+    {
+        status = false;
+    }
+
+    for( ; ( status == true ) && ( i < valueLength ); i++ )
+    {
+        if( ( pValue[ i ] < '0' ) || ( pValue[ i ] > '9' ) )
+        {
+            /* Fractions and exponents are not integers. */
+            status = false;
+        }
+        else
+        {
+            integer = integer * 10 + ( pValue[ i ] - '0' );
+        }
+    }
+
+    if( status == true )
+    {
+        *pInteger = ( negative == true ) ? -integer : integer;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _mergeObject( AwsIotShadowState_t * pState,
+                            const IotJsonIndex_t * pIndex,
+                            int32_t parent,
+                            size_t objectToken )
+{
+    size_t changedCount = 0, i = 0, valueToken = 0, valueLength = 0;
+    bool merged = false, changed = false, booleanValue = false;
+    int64_t integerValue = 0;
+    const char * pValue = NULL;
+    AwsIotShadowStateEntry_t * pEntry = NULL;
+
+    /* An object entry comes before the entries it holds. */
+    for( i = ( size_t ) ( parent + 1 ); i < pState->entryCount; i++ )
+    {
+        pEntry = &( pState->pEntries[ i ] );
+
+        if( ( pEntry->parent != parent ) ||
+            ( IotJsonUtils_FindIndexedValue( pIndex,
+                                             objectToken,
+                                             pEntry->pKey,
+                                             pEntry->keyLength,
+                                             &valueToken ) == false ) )
+        {
+            continue;
+        }
+
+        pValue = pIndex->pJsonDocument + pIndex->pTokens[ valueToken ].start;
+        valueLength = pIndex->pTokens[ valueToken ].end - pIndex->pTokens[ valueToken ].start;
+        merged = false;
+        changed = false;
+
+        switch( pEntry->type )
+        {
+            case AWS_IOT_SHADOW_STATE_OBJECT:
+
+                if( pValue[ 0 ] == '{' )
+                {
+                    changedCount += _mergeObject( pState, pIndex, ( int32_t ) i, valueToken );
+                }
+
+                /* An object is reported through the entries it holds. */
+                merged = true;
+                break;
+
+            case AWS_IOT_SHADOW_STATE_INTEGER:
+
+                if( _parseInteger( pValue, valueLength, &integerValue ) == true )
+                {
+                    changed = _setInteger( pEntry, integerValue );
+                    merged = true;
+                }
+
+                break;
+
+            case AWS_IOT_SHADOW_STATE_BOOLEAN:
+
+                if( ( valueLength == 4 ) && ( strncmp( pValue, "true", 4 ) == 0 ) )
+                {
+                    booleanValue = true;
+                    merged = true;
+                }
+                else if( ( valueLength == 5 ) && ( strncmp( pValue, "false", 5 ) == 0 ) )
+                {
+                    booleanValue = false;
+                    merged = true;
+                }
+
+                if( merged == true )
+                {
+                    changed = _setBoolean( pEntry, booleanValue );
+                }
+
+                break;
+
+            case AWS_IOT_SHADOW_STATE_STRING:
+
+                /* Copy the string without its quotes. */
+                if( ( pValue[ 0 ] == '"' ) && ( valueLength - 2 < pEntry->u.string.bufferSize ) )
+                {
+                    changed = _setString( pEntry, pValue + 1, valueLength - 2 );
+                    merged = true;
+                }
+
+                break;
+
+            default:
+                break;
+        }
+
+        if( merged == false )
+        {
+            IotLogWarn( "Ignoring the value of %.*s in Shadow delta document.",
+                        pEntry->keyLength,
+                        pEntry->pKey );
+        }
+        else if( pEntry->type != AWS_IOT_SHADOW_STATE_OBJECT )
+        {
+            /* The delta means that the reported value held by the Shadow
+             * service differs from the desired one, so report the merged value
+             * even if it is the one last accepted. */
+            pEntry->flags = ( pEntry->flags & ~STATE_FLAG_ACCEPTED ) | STATE_FLAG_CHANGED;
+
+            if( changed == true )
+            {
+                changedCount++;
+            }
+        }
+    }
+
+    return changedCount;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _write( _stateWriter_t * pWriter,
+                    const char * pData,
+                    size_t dataLength )
+{
+    if( dataLength > pWriter->bufferSize - pWriter->length )
+    {
+        pWriter->overflow = true;
+    }
+
+    if( pWriter->overflow == false )
+    {
+        ( void ) memcpy( pWriter->pBuffer + pWriter->length, pData, dataLength );
+        pWriter->length += dataLength;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _writeInteger( _stateWriter_t * pWriter,
+                           int64_t value )
+{
+    /* Large enough for the digits and sign of any int64_t. */
+    char digits[ 20 ] = { 0 };
+    size_t digitIndex = sizeof( digits );
+    uint64_t magnitude = ( value < 0 ) ? ( 0ULL - ( uint64_t ) value ) : ( uint64_t ) value;
+
+    /* Convert the digits from the last one. */
+    do
+    {
+        digitIndex--;
+        digits[ digitIndex ] = ( char ) ( '0' + ( magnitude % 10ULL ) );
+        magnitude /= 10ULL;
+    } while( magnitude > 0ULL );
+
+    if( value < 0 )
+    {
+        digitIndex--;
+        digits[ digitIndex ] = '-';
+    }
+
+    _write( pWriter, digits + digitIndex, sizeof( digits ) - digitIndex );
+}
+
+/*-----------------------------------------------------------*/
+
+static void _writeObject( const AwsIotShadowState_t * pState,
+                          _stateWriter_t * pWriter,
+                          int32_t parent )
+{
+    size_t i = 0;
+    bool firstEntry = true;
+    const AwsIotShadowStateEntry_t * pEntry = NULL;
+
+    _write( pWriter, "{", 1 );
+
+    /* An object entry comes before the entries it holds. */
+    for( i = ( size_t ) ( parent + 1 ); ( i < pState->entryCount ) && ( pWriter->overflow == false ); i++ )
+    {
+        pEntry = &( pState->pEntries[ i ] );
+
+        if( ( pEntry->parent != parent ) ||
+            ( ( pEntry->flags & ( STATE_FLAG_CHANGED | STATE_FLAG_HOLDS_CHANGES ) ) == 0 ) )
+        {
+            continue;
+        }
+
+        if( firstEntry == false )
+        {
+            _write( pWriter, ",", 1 );
+        }
+
+        firstEntry = false;
+
+        _write( pWriter, "\"", 1 );
+        _write( pWriter, pEntry->pKey, pEntry->keyLength );
+        _write( pWriter, "\":", 2 );
+
+        switch( pEntry->type )
+        {
+            case AWS_IOT_SHADOW_STATE_OBJECT:
+                _writeObject( pState, pWriter, ( int32_t ) i );
+                break;
+
+            case AWS_IOT_SHADOW_STATE_INTEGER:
+                _writeInteger( pWriter, pEntry->u.integer );
+                break;
+
+            case AWS_IOT_SHADOW_STATE_BOOLEAN:
+
+                if( pEntry->u.boolean == true )
+                {
+                    _write( pWriter, "true", 4 );
+                }
+                else
+                {
+                    _write( pWriter, "false", 5 );
+                }
+
+                break;
+
+            default:
+                _write( pWriter, "\"", 1 );
+                _write( pWriter, pEntry->u.string.pBuffer, pEntry->u.string.length );
+                _write( pWriter, "\"", 1 );
+                break;
+        }
+    }
+
+    _write( pWriter, "}", 1 );
+}
+
+/*-----------------------------------------------------------*/
+
+static AwsIotShadowError_t _buildUpdate( AwsIotShadowState_t * pState,
+                                         size_t * pDocumentLength )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_SUCCESS;
+    size_t i = pState->entryCount;
+    bool changed = false;
+    AwsIotShadowStateEntry_t * pEntry = NULL;
+    _stateWriter_t writer = { 0 };
+
+    writer.pBuffer = pState->pDocumentBuffer;
+    writer.bufferSize = pState->documentBufferSize;
+
+    /* Clear the marks left on the objects by the previous update. */
+    while( i > 0 )
+    {
+        i--;
+        pEntry = &( pState->pEntries[ i ] );
+
+        if( pEntry->type == AWS_IOT_SHADOW_STATE_OBJECT )
+        {
+            pEntry->flags &= ~STATE_FLAG_HOLDS_CHANGES;
+        }
+    }
+
+    /* Mark the objects holding changed entries. Objects come before the entries
+     * they hold, so visiting the entries backwards marks nested objects before
+     * their parents. */
+    for( i = pState->entryCount; i > 0; i-- )
+    {
+        pEntry = &( pState->pEntries[ i - 1 ] );
+
+        if( ( pEntry->flags & ( STATE_FLAG_CHANGED | STATE_FLAG_HOLDS_CHANGES ) ) != 0 )
+        {
+            changed = true;
+
+            if( pEntry->parent != AWS_IOT_SHADOW_STATE_NO_PARENT )
+            {
+                pState->pEntries[ pEntry->parent ].flags |= STATE_FLAG_HOLDS_CHANGES;
+            }
+        }
+    }
+
+    if( changed == true )
+    {
+        _write( &writer, UPDATE_DOCUMENT_START, sizeof( UPDATE_DOCUMENT_START ) - 1 );
+        _writeObject( pState, &writer, AWS_IOT_SHADOW_STATE_NO_PARENT );
+        _write( &writer, UPDATE_DOCUMENT_CLIENT_TOKEN, sizeof( UPDATE_DOCUMENT_CLIENT_TOKEN ) - 1 );
+        _writeInteger( &writer, ( int64_t ) ( IotClock_GetTimeMs() % CLIENT_TOKEN_MODULUS ) );
+        _write( &writer, UPDATE_DOCUMENT_END, sizeof( UPDATE_DOCUMENT_END ) - 1 );
+
+        if( writer.overflow == true )
+        {
+            IotLogError( "Shadow state update document does not fit in %lu bytes.",
+                         ( unsigned long ) writer.bufferSize );
+
+            status = AWS_IOT_SHADOW_NO_MEMORY;
+        }
+        else
+        {
+            /* The changes written are now reported by this update. */
+            for( i = 0; i < pState->entryCount; i++ )
+            {
+                pEntry = &( pState->pEntries[ i ] );
+
+                if( ( pEntry->flags & STATE_FLAG_CHANGED ) != 0 )
+                {
+                    pEntry->flags = ( pEntry->flags & ~STATE_FLAG_CHANGED ) | STATE_FLAG_REPORTING;
+                    _summarize( pEntry, &( pEntry->reporting ) );
+                }
+            }
+        }
+    }
+
+    *pDocumentLength = ( status == AWS_IOT_SHADOW_SUCCESS ) ? writer.length : 0;
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _completeUpdate( AwsIotShadowState_t * pState,
+                             bool accepted )
+{
+    size_t i = 0;
+    AwsIotShadowStateEntry_t * pEntry = NULL;
+
+    for( i = 0; i < pState->entryCount; i++ )
+    {
+        pEntry = &( pState->pEntries[ i ] );
+
+        if( ( pEntry->flags & STATE_FLAG_REPORTING ) != 0 )
+        {
+            pEntry->flags &= ~STATE_FLAG_REPORTING;
+
+            if( accepted == true )
+            {
+                pEntry->accepted = pEntry->reporting;
+                pEntry->flags |= STATE_FLAG_ACCEPTED;
+            }
+
+            /* Entries set again while reporting are compared with the value
+             * now accepted; a rejected value is reported again. */
+            _refreshChanged( pEntry );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_Init( AwsIotShadowState_t * pState )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_SUCCESS;
+    size_t i = 0;
+    AwsIotShadowStateEntry_t * pEntry = NULL;
+
+    if( ( pState == NULL ) ||
+        ( pState->pEntries == NULL ) ||
+        ( pState->entryCount == 0 ) ||
+        ( pState->entryCount > ( size_t ) INT32_MAX ) ||
+        ( pState->pTokens == NULL ) ||
+        ( pState->maxTokens == 0 ) ||
+        ( pState->pDocumentBuffer == NULL ) )
+    {
+        IotLogError( "Shadow state must have entries, tokens and a document buffer." );
+
+        status = AWS_IOT_SHADOW_BAD_PARAMETER;
+    }
+
+    for( i = 0; ( status == AWS_IOT_SHADOW_SUCCESS ) && ( i < pState->entryCount ); i++ )
+    {
+        pEntry = &( pState->pEntries[ i ] );
+
+        if( ( pEntry->pKey == NULL ) || ( pEntry->keyLength == 0 ) )
+        {
+            IotLogError( "Shadow state entry %lu has no key.", ( unsigned long ) i );
+
+            status = AWS_IOT_SHADOW_BAD_PARAMETER;
+        }
+        else if( ( pEntry->parent != AWS_IOT_SHADOW_STATE_NO_PARENT ) &&
+                 ( ( pEntry->parent < 0 ) ||
+                   ( ( size_t ) pEntry->parent >= i ) ||
+                   ( pState->pEntries[ pEntry->parent ].type != AWS_IOT_SHADOW_STATE_OBJECT ) ) )
+        {
+            IotLogError( "The parent of Shadow state entry %.*s must be an object "
+                         "entry before it.",
+                         pEntry->keyLength,
+                         pEntry->pKey );
+
+            status = AWS_IOT_SHADOW_BAD_PARAMETER;
+        }
+        else if( ( pEntry->type == AWS_IOT_SHADOW_STATE_STRING ) &&
+                 ( ( pEntry->u.string.pBuffer == NULL ) ||
+                   ( pEntry->u.string.bufferSize == 0 ) ||
+                   ( memchr( pEntry->u.string.pBuffer, '\0', pEntry->u.string.bufferSize ) == NULL ) ) )
+        {
+            IotLogError( "The buffer of Shadow state entry %.*s must hold a "
+                         "NULL-terminated string.",
+                         pEntry->keyLength,
+                         pEntry->pKey );
+
+            status = AWS_IOT_SHADOW_BAD_PARAMETER;
+        }
+        else
+        {
+            if( pEntry->type == AWS_IOT_SHADOW_STATE_STRING )
+            {
+                pEntry->u.string.length = strlen( pEntry->u.string.pBuffer );
+            }
+
+            /* The first update reports every value. */
+            pEntry->flags = ( pEntry->type == AWS_IOT_SHADOW_STATE_OBJECT ) ? 0 : STATE_FLAG_CHANGED;
+        }
+    }
+
+    if( status == AWS_IOT_SHADOW_SUCCESS )
+    {
+        pState->version = 0;
+
+        if( IotMutex_Create( &( pState->mutex ), false ) == false )
+        {
+            IotLogError( "Failed to create Shadow state mutex." );
+
+            status = AWS_IOT_SHADOW_NO_MEMORY;
+        }
+        else if( IotMutex_Create( &( pState->updateMutex ), false ) == false )
+        {
+            IotLogError( "Failed to create Shadow state update mutex." );
+
+            IotMutex_Destroy( &( pState->mutex ) );
+            status = AWS_IOT_SHADOW_NO_MEMORY;
+        }
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void AwsIotShadowState_Cleanup( AwsIotShadowState_t * pState )
+{
+    IotMutex_Destroy( &( pState->updateMutex ) );
+    IotMutex_Destroy( &( pState->mutex ) );
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_SetInteger( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  int64_t value )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_INTEGER ) == true )
+    {
+        IotMutex_Lock( &( pState->mutex ) );
+        ( void ) _setInteger( &( pState->pEntries[ entryIndex ] ), value );
+        IotMutex_Unlock( &( pState->mutex ) );
+
+        status = AWS_IOT_SHADOW_SUCCESS;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_SetBoolean( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  bool value )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_BOOLEAN ) == true )
+    {
+        IotMutex_Lock( &( pState->mutex ) );
+        ( void ) _setBoolean( &( pState->pEntries[ entryIndex ] ), value );
+        IotMutex_Unlock( &( pState->mutex ) );
+
+        status = AWS_IOT_SHADOW_SUCCESS;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_SetString( AwsIotShadowState_t * pState,
+                                                 size_t entryIndex,
+                                                 const char * pValue,
+                                                 size_t valueLength )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_STRING ) == true )
+    {
+        if( ( pValue == NULL ) ||
+            ( valueLength >= pState->pEntries[ entryIndex ].u.string.bufferSize ) )
+        {
+            IotLogError( "String value does not fit in Shadow state entry %.*s.",
+                         pState->pEntries[ entryIndex ].keyLength,
+                         pState->pEntries[ entryIndex ].pKey );
+        }
+        else
+        {
+            IotMutex_Lock( &( pState->mutex ) );
+            ( void ) _setString( &( pState->pEntries[ entryIndex ] ), pValue, valueLength );
+            IotMutex_Unlock( &( pState->mutex ) );
+
+            status = AWS_IOT_SHADOW_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_GetInteger( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  int64_t * pValue )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_INTEGER ) == true )
+    {
+        IotMutex_Lock( &( pState->mutex ) );
+        *pValue = pState->pEntries[ entryIndex ].u.integer;
+        IotMutex_Unlock( &( pState->mutex ) );
+
+        status = AWS_IOT_SHADOW_SUCCESS;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_GetBoolean( AwsIotShadowState_t * pState,
+                                                  size_t entryIndex,
+                                                  bool * pValue )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_BOOLEAN ) == true )
+    {
+        IotMutex_Lock( &( pState->mutex ) );
+        *pValue = pState->pEntries[ entryIndex ].u.boolean;
+        IotMutex_Unlock( &( pState->mutex ) );
+
+        status = AWS_IOT_SHADOW_SUCCESS;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_GetString( AwsIotShadowState_t * pState,
+                                                 size_t entryIndex,
+                                                 char * pBuffer,
+                                                 size_t bufferSize,
+                                                 size_t * pValueLength )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_BAD_PARAMETER;
+    AwsIotShadowStateEntry_t * pEntry = NULL;
+
+    if( _validateEntry( pState, entryIndex, AWS_IOT_SHADOW_STATE_STRING ) == true )
+    {
+        pEntry = &( pState->pEntries[ entryIndex ] );
+
+        IotMutex_Lock( &( pState->mutex ) );
+
+        if( ( pBuffer != NULL ) && ( pEntry->u.string.length < bufferSize ) )
+        {
+            /* Copy the value and its NULL terminator. */
+            ( void ) memcpy( pBuffer, pEntry->u.string.pBuffer, pEntry->u.string.length + 1 );
+
+            if( pValueLength != NULL )
+            {
+                *pValueLength = pEntry->u.string.length;
+            }
+
+            status = AWS_IOT_SHADOW_SUCCESS;
+        }
+
+        IotMutex_Unlock( &( pState->mutex ) );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_MergeDelta( AwsIotShadowState_t * pState,
+                                                  const char * pDeltaDocument,
+                                                  size_t deltaDocumentLength,
+                                                  size_t * pChangedCount )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_SUCCESS;
+    size_t changedCount = 0, versionToken = 0, stateToken = 0;
+    int64_t version = 0;
+    IotJsonIndex_t index = { 0 };
+    const IotJsonToken_t * pToken = NULL;
+
+    if( ( pState == NULL ) || ( pDeltaDocument == NULL ) )
+    {
+        IotLogError( "Shadow state and delta document cannot be NULL." );
+
+        return AWS_IOT_SHADOW_BAD_PARAMETER;
+    }
+
+    IotMutex_Lock( &( pState->mutex ) );
+
+    /* Index the delta document once; every entry is then a lookup. */
+    if( IotJsonUtils_BuildIndex( &index,
+                                 pDeltaDocument,
+                                 deltaDocumentLength,
+                                 pState->pTokens,
+                                 pState->maxTokens ) == false )
+    {
+        IotLogError( "Failed to parse Shadow delta document. It may have more "
+                     "than %lu tokens.",
+                     ( unsigned long ) pState->maxTokens );
+
+        status = AWS_IOT_SHADOW_BAD_RESPONSE;
+    }
+
+    /* Ignore deltas older than the last one merged. */
+    if( ( status == AWS_IOT_SHADOW_SUCCESS ) &&
+        ( IotJsonUtils_FindIndexedValue( &index,
+                                         0,
+                                         DELTA_VERSION_KEY,
+                                         DELTA_VERSION_KEY_LENGTH,
+                                         &versionToken ) == true ) )
+    {
+        pToken = &( index.pTokens[ versionToken ] );
+
+        if( _parseInteger( pDeltaDocument + pToken->start,
+                           pToken->end - pToken->start,
+                           &version ) == true )
+        {
+            if( ( version >= 0 ) && ( version <= ( int64_t ) pState->version ) )
+            {
+                IotLogInfo( "Ignoring Shadow delta version %lu; version %lu was "
+                            "already merged.",
+                            ( unsigned long ) version,
+                            ( unsigned long ) pState->version );
+
+                status = AWS_IOT_SHADOW_STATUS_PENDING;
+            }
+            else
+            {
+                pState->version = ( uint32_t ) version;
+            }
+        }
+    }
+
+    if( ( status == AWS_IOT_SHADOW_SUCCESS ) &&
+        ( IotJsonUtils_FindIndexedValue( &index,
+                                         0,
+                                         DELTA_STATE_KEY,
+                                         DELTA_STATE_KEY_LENGTH,
+                                         &stateToken ) == true ) &&
+        ( pDeltaDocument[ index.pTokens[ stateToken ].start ] == '{' ) )
+    {
+        changedCount = _mergeObject( pState, &index, AWS_IOT_SHADOW_STATE_NO_PARENT, stateToken );
+    }
+
+    IotMutex_Unlock( &( pState->mutex ) );
+
+    /* A stale delta is not an error. */
+    if( status == AWS_IOT_SHADOW_STATUS_PENDING )
+    {
+        status = AWS_IOT_SHADOW_SUCCESS;
+    }
+
+    if( pChangedCount != NULL )
+    {
+        *pChangedCount = changedCount;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotShadowState_TimedUpdate( IotMqttConnection_t mqttConnection,
+                                                   AwsIotShadowState_t * pState,
+                                                   const AwsIotShadowDocumentInfo_t * pUpdateInfo,
+                                                   uint32_t flags,
+                                                   uint32_t timeoutMs )
+{
+    AwsIotShadowError_t status = AWS_IOT_SHADOW_SUCCESS;
+    size_t documentLength = 0;
+    AwsIotShadowDocumentInfo_t updateInfo = AWS_IOT_SHADOW_DOCUMENT_INFO_INITIALIZER;
+
+    if( ( pState == NULL ) || ( pUpdateInfo == NULL ) )
+    {
+        IotLogError( "Shadow state and update info cannot be NULL." );
+
+        return AWS_IOT_SHADOW_BAD_PARAMETER;
+    }
+
+    /* The document buffer is used until the update completes, so only one
+     * update runs at a time. The entries are not locked while waiting for the
+     * Shadow service, so that delta callbacks can merge into them. */
+    IotMutex_Lock( &( pState->updateMutex ) );
+
+    IotMutex_Lock( &( pState->mutex ) );
+    status = _buildUpdate( pState, &documentLength );
+    IotMutex_Unlock( &( pState->mutex ) );
+
+    if( ( status == AWS_IOT_SHADOW_SUCCESS ) && ( documentLength == 0 ) )
+    {
+        IotLogDebug( "Shadow state of %.*s has no changes to report.",
+                     pUpdateInfo->thingNameLength,
+                     pUpdateInfo->pThingName );
+    }
+    else if( status == AWS_IOT_SHADOW_SUCCESS )
+    {
+        updateInfo = *pUpdateInfo;
+        updateInfo.u.update.pUpdateDocument = pState->pDocumentBuffer;
+        updateInfo.u.update.updateDocumentLength = documentLength;
+
+        status = AwsIotShadow_TimedUpdate( mqttConnection,
+                                           &updateInfo,
+                                           flags,
+                                           timeoutMs );
+
+        IotMutex_Lock( &( pState->mutex ) );
+        _completeUpdate( pState, ( status == AWS_IOT_SHADOW_SUCCESS ) );
+        IotMutex_Unlock( &( pState->mutex ) );
+    }
+
+    IotMutex_Unlock( &( pState->updateMutex ) );
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Provide access to internal functions and variables if testing. */
+#if IOT_BUILD_TESTS == 1
+    #include "aws_iot_test_access_shadow_state.c"
+#endif
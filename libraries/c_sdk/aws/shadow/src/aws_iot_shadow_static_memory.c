@@ -83,30 +83,38 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { 0 };                          /**< @brief Shadow operation in-use flags. */
-    static _shadowOperation_t _pShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } }; /**< @brief Shadow operations. */
+    static uint32_t _pInUseShadowOperations[ IOT_STATIC_MEMORY_SLAB_WORDS( AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ) ] = { 0 }; /**< @brief Shadow operation in-use flags. */
+    static _shadowOperation_t _pShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } };            /**< @brief Shadow operations. */
 
-    static bool _pInUseShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ] = { 0 };                                    /**< @brief Shadow subscription in-use flags. */
-    static char _pShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ][ SHADOW_SUBSCRIPTION_SIZE ] = { { 0 } };         /**< @brief Shadow subscriptions. */
+    static uint32_t _pInUseShadowSubscriptions[ IOT_STATIC_MEMORY_SLAB_WORDS( AWS_IOT_SHADOW_SUBSCRIPTIONS ) ] = { 0 }; /**< @brief Shadow subscription in-use flags. */
+    static char _pShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ][ SHADOW_SUBSCRIPTION_SIZE ] = { { 0 } };          /**< @brief Shadow subscriptions. */
+
+/**
+ * @brief Allocator of Shadow operations.
+ */
+    static IotStaticMemorySlab_t _shadowOperationSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pShadowOperations,
+                                                                                            _pInUseShadowOperations,
+                                                                                            sizeof( _shadowOperation_t ),
+                                                                                            AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS );
+
+/**
+ * @brief Allocator of Shadow subscriptions.
+ */
+    static IotStaticMemorySlab_t _shadowSubscriptionSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pShadowSubscriptions,
+                                                                                               _pInUseShadowSubscriptions,
+                                                                                               SHADOW_SUBSCRIPTION_SIZE,
+                                                                                               AWS_IOT_SHADOW_SUBSCRIPTIONS );
 
 /*-----------------------------------------------------------*/
 
     void * AwsIotShadow_MallocOperation( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewOperation = NULL;
 
         /* Check size argument. */
         if( size == sizeof( _shadowOperation_t ) )
         {
-            /* Find a free Shadow operation. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseShadowOperations,
-                                                  AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS );
-
-            if( freeIndex != -1 )
-            {
-                pNewOperation = &( _pShadowOperations[ freeIndex ] );
-            }
+            pNewOperation = IotStaticMemory_SlabAllocate( &( _shadowOperationSlab ) );
         }
 
         return pNewOperation;
@@ -117,30 +125,18 @@
     void AwsIotShadow_FreeOperation( void * ptr )
     {
         /* Return the in-use Shadow operation. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pShadowOperations,
-                                     _pInUseShadowOperations,
-                                     AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS,
-                                     sizeof( _shadowOperation_t ) );
+        ( void ) IotStaticMemory_SlabFree( &( _shadowOperationSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * AwsIotShadow_MallocSubscription( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewSubscription = NULL;
 
         if( size <= SHADOW_SUBSCRIPTION_SIZE )
         {
-            /* Get the index of a free Shadow subscription. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseShadowSubscriptions,
-                                                  AWS_IOT_SHADOW_SUBSCRIPTIONS );
-
-            if( freeIndex != -1 )
-            {
-                pNewSubscription = &( _pShadowSubscriptions[ freeIndex ][ 0 ] );
-            }
+            pNewSubscription = IotStaticMemory_SlabAllocate( &( _shadowSubscriptionSlab ) );
         }
 
         return pNewSubscription;
@@ -151,11 +147,7 @@
     void AwsIotShadow_FreeSubscription( void * ptr )
     {
         /* Return the in-use Shadow subscription. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pShadowSubscriptions,
-                                     _pInUseShadowSubscriptions,
-                                     AWS_IOT_SHADOW_SUBSCRIPTIONS,
-                                     SHADOW_SUBSCRIPTION_SIZE );
+        ( void ) IotStaticMemory_SlabFree( &( _shadowSubscriptionSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
@@ -0,0 +1,54 @@
+/*
+ * FreeRTOS Shadow V2.2.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_iot_test_access_shadow_state.c
+ * @brief Provides access to the internal functions and variables of
+ * aws_iot_shadow_state.c
+ *
+ * This file should only be included at the bottom of aws_iot_shadow_state.c
+ * and never compiled by itself.
+ */
+
+/* Test access include. */
+#include "aws_iot_test_access_shadow.h"
+
+/*-----------------------------------------------------------*/
+
+AwsIotShadowError_t AwsIotTestShadow_buildUpdate( AwsIotShadowState_t * pState,
+                                                  size_t * pDocumentLength )
+{
+    return _buildUpdate( pState, pDocumentLength );
+}
+
+/*-----------------------------------------------------------*/
+
+void AwsIotTestShadow_completeUpdate( AwsIotShadowState_t * pState,
+                                      bool accepted )
+{
+    _completeUpdate( pState, accepted );
+}
+
+/*-----------------------------------------------------------*/
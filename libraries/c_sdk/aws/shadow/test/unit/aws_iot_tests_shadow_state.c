@@ -0,0 +1,499 @@
+/*
+ * FreeRTOS Shadow V2.2.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_iot_tests_shadow_state.c
+ * @brief Tests for the Shadow state store.
+ */
+
+/* The config header is always included first. */
+#include "iot_config.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Shadow include. */
+#include "aws_iot_shadow.h"
+
+/* JSON utilities include. */
+#include "iot_json_utils.h"
+
+/* Shadow test access include. */
+#include "aws_iot_test_access_shadow.h"
+
+/* Test framework includes. */
+#include "unity_fixture.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of tokens to index delta documents.
+ */
+#define TEST_TOKEN_COUNT            ( 32 )
+
+/**
+ * @brief The size of the update document buffer.
+ */
+#define TEST_DOCUMENT_BUFFER_SIZE   ( 256 )
+
+/**
+ * @brief The size of the string entry buffer.
+ */
+#define TEST_STRING_BUFFER_SIZE     ( 8 )
+
+/**
+ * @brief Indexes of the test entries.
+ */
+#define ENTRY_POWER                 ( 0 )
+#define ENTRY_LIGHT                 ( 1 )
+#define ENTRY_LIGHT_ON              ( 2 )
+#define ENTRY_LIGHT_COLOR           ( 3 )
+
+/**
+ * @brief The start of an update document, up to the reported state.
+ */
+#define UPDATE_DOCUMENT_START       "{\"state\":{\"reported\":"
+
+/**
+ * @brief The part of an update document after the reported state, up to the
+ * client token.
+ */
+#define UPDATE_DOCUMENT_END         "},\"clientToken\":\""
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Buffer of the string entry.
+ */
+static char _colorBuffer[ TEST_STRING_BUFFER_SIZE ] = "red";
+
+/**
+ * @brief The entries of the state under test.
+ */
+static AwsIotShadowStateEntry_t _entries[] =
+{
+    AWS_IOT_SHADOW_STATE_INTEGER_ENTRY( "power", AWS_IOT_SHADOW_STATE_NO_PARENT ),
+    AWS_IOT_SHADOW_STATE_OBJECT_ENTRY( "light", AWS_IOT_SHADOW_STATE_NO_PARENT ),
+    AWS_IOT_SHADOW_STATE_BOOLEAN_ENTRY( "on", ENTRY_LIGHT ),
+    AWS_IOT_SHADOW_STATE_STRING_ENTRY( "color", ENTRY_LIGHT, _colorBuffer )
+};
+
+/**
+ * @brief Tokens to index delta documents.
+ */
+static IotJsonToken_t _tokens[ TEST_TOKEN_COUNT ];
+
+/**
+ * @brief Buffer for update documents.
+ */
+static char _documentBuffer[ TEST_DOCUMENT_BUFFER_SIZE ];
+
+/**
+ * @brief The state under test.
+ */
+static AwsIotShadowState_t _state = AWS_IOT_SHADOW_STATE_INITIALIZER;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Wrapper for merging a delta document and checking the result.
+ */
+static void _mergeDelta( const char * pDeltaDocument,
+                         size_t expectedChangedCount )
+{
+    size_t changedCount = 0;
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS,
+                       AwsIotShadowState_MergeDelta( &_state,
+                                                     pDeltaDocument,
+                                                     strlen( pDeltaDocument ),
+                                                     &changedCount ) );
+    TEST_ASSERT_EQUAL( expectedChangedCount, changedCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Build an update document and check the reported state it holds.
+ *
+ * @param[in] pExpectedState The expected reported state; `NULL` if no update
+ * document should be built.
+ */
+static void _buildUpdate( const char * pExpectedState )
+{
+    size_t documentLength = 0, startLength = sizeof( UPDATE_DOCUMENT_START ) - 1,
+           stateLength = 0, endLength = sizeof( UPDATE_DOCUMENT_END ) - 1;
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotTestShadow_buildUpdate( &_state, &documentLength ) );
+
+    if( pExpectedState == NULL )
+    {
+        TEST_ASSERT_EQUAL( 0, documentLength );
+    }
+    else
+    {
+        /* The client token at the end of the document is not checked. */
+        stateLength = strlen( pExpectedState );
+        TEST_ASSERT_GREATER_THAN( startLength + stateLength + endLength, documentLength );
+        TEST_ASSERT_EQUAL_MEMORY( UPDATE_DOCUMENT_START, _documentBuffer, startLength );
+        TEST_ASSERT_EQUAL_MEMORY( pExpectedState, _documentBuffer + startLength, stateLength );
+        TEST_ASSERT_EQUAL_MEMORY( UPDATE_DOCUMENT_END, _documentBuffer + startLength + stateLength, endLength );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for Shadow state tests.
+ */
+TEST_GROUP( Shadow_Unit_State );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for Shadow state tests.
+ */
+TEST_SETUP( Shadow_Unit_State )
+{
+    ( void ) strcpy( _colorBuffer, "red" );
+    _entries[ ENTRY_POWER ].u.integer = 0;
+    _entries[ ENTRY_LIGHT_ON ].u.boolean = false;
+
+    _state.pEntries = _entries;
+    _state.entryCount = sizeof( _entries ) / sizeof( _entries[ 0 ] );
+    _state.pTokens = _tokens;
+    _state.maxTokens = TEST_TOKEN_COUNT;
+    _state.pDocumentBuffer = _documentBuffer;
+    _state.documentBufferSize = TEST_DOCUMENT_BUFFER_SIZE;
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_Init( &_state ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for Shadow state tests.
+ */
+TEST_TEAR_DOWN( Shadow_Unit_State )
+{
+    AwsIotShadowState_Cleanup( &_state );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for Shadow state tests.
+ */
+TEST_GROUP_RUNNER( Shadow_Unit_State )
+{
+    RUN_TEST_CASE( Shadow_Unit_State, InitInvalidEntries );
+    RUN_TEST_CASE( Shadow_Unit_State, SetGet );
+    RUN_TEST_CASE( Shadow_Unit_State, SetGetInvalid );
+    RUN_TEST_CASE( Shadow_Unit_State, MergeDelta );
+    RUN_TEST_CASE( Shadow_Unit_State, MergeDeltaStale );
+    RUN_TEST_CASE( Shadow_Unit_State, MergeDeltaInvalid );
+    RUN_TEST_CASE( Shadow_Unit_State, UpdateNoChanges );
+    RUN_TEST_CASE( Shadow_Unit_State, UpdateNestedObject );
+    RUN_TEST_CASE( Shadow_Unit_State, UpdateRejected );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a state with invalid entries is not initialized.
+ */
+TEST( Shadow_Unit_State, InitInvalidEntries )
+{
+    AwsIotShadowState_t state = _state;
+    AwsIotShadowStateEntry_t entries[ 2 ] =
+    {
+        AWS_IOT_SHADOW_STATE_BOOLEAN_ENTRY( "on", 1 ),
+        AWS_IOT_SHADOW_STATE_OBJECT_ENTRY( "light", AWS_IOT_SHADOW_STATE_NO_PARENT )
+    };
+    char unterminated[ 2 ] = { 'a', 'b' };
+
+    state.pEntries = entries;
+    state.entryCount = 2;
+
+    /* Parent after the entry. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_Init( &state ) );
+
+    /* Parent that is not an object. */
+    entries[ 1 ].type = AWS_IOT_SHADOW_STATE_INTEGER;
+    entries[ 1 ].parent = 0;
+    entries[ 0 ].parent = AWS_IOT_SHADOW_STATE_NO_PARENT;
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_Init( &state ) );
+
+    /* String that is not terminated. */
+    entries[ 1 ].type = AWS_IOT_SHADOW_STATE_STRING;
+    entries[ 1 ].parent = AWS_IOT_SHADOW_STATE_NO_PARENT;
+    entries[ 1 ].u.string.pBuffer = unterminated;
+    entries[ 1 ].u.string.bufferSize = sizeof( unterminated );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_Init( &state ) );
+
+    /* No tokens. */
+    state = _state;
+    state.pTokens = NULL;
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_Init( &state ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests setting and getting the values of entries.
+ */
+TEST( Shadow_Unit_State, SetGet )
+{
+    int64_t integer = 0;
+    bool boolean = false;
+    char string[ TEST_STRING_BUFFER_SIZE ] = { 0 };
+    size_t stringLength = 0;
+
+    /* Initial string value. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS,
+                       AwsIotShadowState_GetString( &_state, ENTRY_LIGHT_COLOR, string, sizeof( string ), &stringLength ) );
+    TEST_ASSERT_EQUAL( 3, stringLength );
+    TEST_ASSERT_EQUAL_STRING( "red", string );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, -1234567890123LL ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetInteger( &_state, ENTRY_POWER, &integer ) );
+    TEST_ASSERT_TRUE( integer == -1234567890123LL );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetBoolean( &_state, ENTRY_LIGHT_ON, true ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetBoolean( &_state, ENTRY_LIGHT_ON, &boolean ) );
+    TEST_ASSERT_TRUE( boolean );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "green", 5 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS,
+                       AwsIotShadowState_GetString( &_state, ENTRY_LIGHT_COLOR, string, sizeof( string ), &stringLength ) );
+    TEST_ASSERT_EQUAL( 5, stringLength );
+    TEST_ASSERT_EQUAL_STRING( "green", string );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests setting and getting entries with invalid parameters.
+ */
+TEST( Shadow_Unit_State, SetGetInvalid )
+{
+    int64_t integer = 0;
+    char string[ 4 ] = { 0 };
+
+    /* Entry that does not exist. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_SetInteger( &_state, 4, 1 ) );
+
+    /* Entry of another type. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_SetInteger( &_state, ENTRY_LIGHT_ON, 1 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER, AwsIotShadowState_GetInteger( &_state, ENTRY_LIGHT, &integer ) );
+
+    /* String that does not fit in the entry, with its NULL terminator. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER,
+                       AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "magenta!", 8 ) );
+
+    /* Buffer too small for the value. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "blue", 4 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_PARAMETER,
+                       AwsIotShadowState_GetString( &_state, ENTRY_LIGHT_COLOR, string, sizeof( string ), NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests merging delta documents into the state.
+ */
+TEST( Shadow_Unit_State, MergeDelta )
+{
+    int64_t integer = 0;
+    bool boolean = false;
+    char string[ TEST_STRING_BUFFER_SIZE ] = { 0 };
+
+    /* Nested values, with metadata and keys that are not entries. */
+    _mergeDelta( "{\"version\":10,\"timestamp\":1563988000,"
+                 "\"state\":{\"power\":42,\"light\":{\"on\":true,\"color\":\"blue\",\"level\":3}},"
+                 "\"metadata\":{\"power\":{\"timestamp\":1563988000}}}",
+                 3 );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetInteger( &_state, ENTRY_POWER, &integer ) );
+    TEST_ASSERT_TRUE( integer == 42 );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetBoolean( &_state, ENTRY_LIGHT_ON, &boolean ) );
+    TEST_ASSERT_TRUE( boolean );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS,
+                       AwsIotShadowState_GetString( &_state, ENTRY_LIGHT_COLOR, string, sizeof( string ), NULL ) );
+    TEST_ASSERT_EQUAL_STRING( "blue", string );
+
+    /* Values that did not change are not counted. */
+    _mergeDelta( "{\"version\":11,\"state\":{\"power\":42,\"light\":{\"on\":false}}}", 1 );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetBoolean( &_state, ENTRY_LIGHT_ON, &boolean ) );
+    TEST_ASSERT_FALSE( boolean );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that delta documents older than the last one merged are ignored.
+ */
+TEST( Shadow_Unit_State, MergeDeltaStale )
+{
+    int64_t integer = 0;
+
+    _mergeDelta( "{\"version\":20,\"state\":{\"power\":1}}", 1 );
+
+    /* Same and older versions. */
+    _mergeDelta( "{\"version\":20,\"state\":{\"power\":2}}", 0 );
+    _mergeDelta( "{\"version\":19,\"state\":{\"power\":3}}", 0 );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetInteger( &_state, ENTRY_POWER, &integer ) );
+    TEST_ASSERT_TRUE( integer == 1 );
+
+    /* Newer version. */
+    _mergeDelta( "{\"version\":21,\"state\":{\"power\":4}}", 1 );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests merging invalid delta documents and values.
+ */
+TEST( Shadow_Unit_State, MergeDeltaInvalid )
+{
+    int64_t integer = 0;
+    size_t changedCount = 0;
+    const char pMalformed[] = "{\"version\":1,\"state\":{\"power\":";
+
+    /* Values with the wrong type or that do not fit are ignored. */
+    _mergeDelta( "{\"version\":1,\"state\":{\"power\":1.5,\"light\":{\"on\":1,\"color\":\"magentas\"}}}", 0 );
+    _mergeDelta( "{\"version\":2,\"state\":{\"power\":12345678901234567890}}", 0 );
+    _mergeDelta( "{\"version\":3,\"state\":{\"light\":7}}", 0 );
+
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_GetInteger( &_state, ENTRY_POWER, &integer ) );
+    TEST_ASSERT_TRUE( integer == 0 );
+
+    /* Malformed document. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_BAD_RESPONSE,
+                       AwsIotShadowState_MergeDelta( &_state,
+                                                     pMalformed,
+                                                     sizeof( pMalformed ) - 1,
+                                                     &changedCount ) );
+    TEST_ASSERT_EQUAL( 0, changedCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that values equal to the ones last accepted are not reported.
+ */
+TEST( Shadow_Unit_State, UpdateNoChanges )
+{
+    /* The first update reports every value. */
+    _buildUpdate( "{\"power\":0,\"light\":{\"on\":false,\"color\":\"red\"}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( NULL );
+
+    /* Values set to the same value. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 0 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "red", 3 ) );
+    _buildUpdate( NULL );
+
+    /* Values changed and then restored before an update. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 5 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 0 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetBoolean( &_state, ENTRY_LIGHT_ON, true ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetBoolean( &_state, ENTRY_LIGHT_ON, false ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "blue", 4 ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "red", 3 ) );
+    _buildUpdate( NULL );
+
+    /* A merged value is reported even if it is the one last accepted. */
+    _mergeDelta( "{\"version\":1,\"state\":{\"power\":0}}", 0 );
+    _buildUpdate( "{\"power\":0}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that an update only holds the changed entries of a nested object.
+ */
+TEST( Shadow_Unit_State, UpdateNestedObject )
+{
+    _buildUpdate( "{\"power\":0,\"light\":{\"on\":false,\"color\":\"red\"}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+
+    /* One entry of the object. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "blue", 4 ) );
+    _buildUpdate( "{\"light\":{\"color\":\"blue\"}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+
+    /* Entries inside and outside the object. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetBoolean( &_state, ENTRY_LIGHT_ON, true ) );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 3 ) );
+    _buildUpdate( "{\"power\":3,\"light\":{\"on\":true}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+
+    /* An object whose entries did not change is not reported. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, -4 ) );
+    _buildUpdate( "{\"power\":-4}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that the values of a rejected update are reported again.
+ */
+TEST( Shadow_Unit_State, UpdateRejected )
+{
+    _buildUpdate( "{\"power\":0,\"light\":{\"on\":false,\"color\":\"red\"}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+
+    /* Rejected update. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 7 ) );
+    _buildUpdate( "{\"power\":7}" );
+    AwsIotTestShadow_completeUpdate( &_state, false );
+    _buildUpdate( "{\"power\":7}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( NULL );
+
+    /* Rejected update of a value restored to the one last accepted. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 8 ) );
+    _buildUpdate( "{\"power\":8}" );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetInteger( &_state, ENTRY_POWER, 7 ) );
+    AwsIotTestShadow_completeUpdate( &_state, false );
+    _buildUpdate( NULL );
+
+    /* Value set again while an accepted update was in progress. */
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "blue", 4 ) );
+    _buildUpdate( "{\"light\":{\"color\":\"blue\"}}" );
+    TEST_ASSERT_EQUAL( AWS_IOT_SHADOW_SUCCESS, AwsIotShadowState_SetString( &_state, ENTRY_LIGHT_COLOR, "green", 5 ) );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( "{\"light\":{\"color\":\"green\"}}" );
+    AwsIotTestShadow_completeUpdate( &_state, true );
+    _buildUpdate( NULL );
+}
+
+/*-----------------------------------------------------------*/
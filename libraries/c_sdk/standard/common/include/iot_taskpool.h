@@ -601,4 +601,62 @@ const char * IotTaskPool_strerror( IotTaskPoolError_t status );
     #define IOT_TASKPOOL_JOB_WAIT_TIMEOUT_MS    ( 60 * 1000UL )
 #endif
 
+/**
+ * @brief Set this to `1` to schedule jobs through bounded lock-free work queues.
+ *
+ * In this mode every worker has a home work queue, and @ref taskpool_function_schedule
+ * places jobs in the work queues without taking the task pool lock. Idle workers
+ * steal jobs from the work queues of other workers. The task pool lock is still
+ * used for deferred jobs, high priority jobs, cancellation and for growing or
+ * shrinking the task pool.
+ */
+#ifndef IOT_TASKPOOL_ENABLE_WORK_STEALING
+    #define IOT_TASKPOOL_ENABLE_WORK_STEALING    ( 0 )
+#endif
+
+/**
+ * @brief The number of work queues in a task pool when @ref IOT_TASKPOOL_ENABLE_WORK_STEALING
+ * is `1`. Workers are assigned to work queues in round-robin order.
+ */
+#ifndef IOT_TASKPOOL_WORK_QUEUES
+    #define IOT_TASKPOOL_WORK_QUEUES    ( 4UL )
+#endif
+
+/**
+ * @brief The number of jobs each work queue can hold. Must be a power of 2.
+ *
+ * Jobs that do not fit in any work queue are placed in the task pool dispatch queue.
+ */
+#ifndef IOT_TASKPOOL_WORK_QUEUE_LENGTH
+    #define IOT_TASKPOOL_WORK_QUEUE_LENGTH    ( 16UL )
+#endif
+
+/**
+ * @brief Set this to `1` to keep deferred jobs in a hierarchical timer wheel.
+ *
+ * By default deferred jobs are kept in a list sorted by expiration time, which makes
+ * @ref taskpool_function_scheduledeferred linear in the number of deferred jobs. The
+ * timer wheel schedules and cancels deferred jobs in constant time, does not allocate
+ * memory for them, and rounds expiration times up to @ref IOT_TASKPOOL_TIMER_WHEEL_TICK_MS.
+ */
+#ifndef IOT_TASKPOOL_ENABLE_TIMER_WHEEL
+    #define IOT_TASKPOOL_ENABLE_TIMER_WHEEL    ( 0 )
+#endif
+
+/**
+ * @brief The resolution of the timer wheel, in milliseconds.
+ */
+#ifndef IOT_TASKPOOL_TIMER_WHEEL_TICK_MS
+    #define IOT_TASKPOOL_TIMER_WHEEL_TICK_MS    ( 10UL )
+#endif
+
+/**
+ * @brief The number of levels of the timer wheel. Each level has 32 slots, so the
+ * wheel covers 32^levels ticks. Jobs deferred further than that are placed again
+ * when the last slot expires.
+ */
+#ifndef IOT_TASKPOOL_TIMER_WHEEL_LEVELS
+    #define IOT_TASKPOOL_TIMER_WHEEL_LEVELS    ( 4UL )
+#endif
+
 #endif /* ifndef IOT_TASKPOOL_H_ */
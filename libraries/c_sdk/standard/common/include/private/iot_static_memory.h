@@ -53,14 +53,73 @@
  * @function_brief{static_memory_function_findfree}
  * - @function_name{static_memory_function_returninuse}
  * @function_brief{static_memory_function_returninuse}
+ * - @function_name{static_memory_function_slaballocate}
+ * @function_brief{static_memory_function_slaballocate}
+ * - @function_name{static_memory_function_slabfree}
+ * @function_brief{static_memory_function_slabfree}
+ * - @function_name{static_memory_function_slabstatistics}
+ * @function_brief{static_memory_function_slabstatistics}
  * - @function_name{static_memory_function_messagebuffersize}
  * @function_brief{static_memory_function_messagebuffersize}
  * - @function_name{static_memory_function_mallocmessagebuffer}
  * @function_brief{static_memory_function_mallocmessagebuffer}
  * - @function_name{static_memory_function_freemessagebuffer}
  * @function_brief{static_memory_function_freemessagebuffer}
+ * - @function_name{static_memory_function_messagebufferstatistics}
+ * @function_brief{static_memory_function_messagebufferstatistics}
  */
 
+/**
+ * @brief The number of `uint32_t` words in the in-use bitmap of a slab of
+ * `elementCount` elements.
+ */
+    #define IOT_STATIC_MEMORY_SLAB_WORDS( elementCount )    ( ( ( elementCount ) + 31U ) / 32U )
+
+/**
+ * @brief Initializer for an #IotStaticMemorySlab_t.
+ *
+ * @param[in] pPool An array of `elementCount` elements of `elementSize` bytes.
+ * @param[in] pInUse An array of #IOT_STATIC_MEMORY_SLAB_WORDS( `elementCount` )
+ * `uint32_t`, zeroed at compile-time.
+ * @param[in] elementSize The size of one element of `pPool`.
+ * @param[in] elementCount The number of elements in `pPool`.
+ */
+    #define IOT_STATIC_MEMORY_SLAB_INITIALIZER( pPool, pInUse, elementSize, elementCount ) \
+    { ( pPool ), ( pInUse ), ( elementSize ), ( elementCount ), 0U, 0U, 0U, 0U }
+
+/**
+ * @brief A pool of fixed-size elements allocated from an in-use bitmap.
+ *
+ * Elements are allocated and freed with atomic operations on the bitmap, so a
+ * slab may be used from any task without a mutex. Initialize with
+ * #IOT_STATIC_MEMORY_SLAB_INITIALIZER; the members are not meant to be
+ * accessed directly.
+ */
+    typedef struct IotStaticMemorySlab
+    {
+        void * pPool;                     /**< @brief The elements of the slab. */
+        uint32_t volatile * pInUse;       /**< @brief One bit per element, set while the element is allocated. */
+        size_t elementSize;               /**< @brief The size of one element. */
+        size_t elementCount;              /**< @brief The number of elements in the slab. */
+        uint32_t volatile inUse;          /**< @brief The number of allocated elements. */
+        uint32_t volatile highWaterMark;  /**< @brief The largest value of `inUse` so far. */
+        uint32_t volatile failures;       /**< @brief The number of allocations that found no free element. */
+        uint32_t volatile fallbacks;      /**< @brief The number of message buffer allocations for this size class that a larger class served. */
+    } IotStaticMemorySlab_t;
+
+/**
+ * @brief Usage statistics of a slab, returned by @ref static_memory_function_slabstatistics.
+ */
+    typedef struct IotStaticMemoryStatistics
+    {
+        size_t elementSize;       /**< @brief The size of one element. */
+        size_t elementCount;      /**< @brief The number of elements. */
+        size_t inUse;             /**< @brief The number of elements currently allocated. */
+        size_t highWaterMark;     /**< @brief The largest number of elements allocated at once. */
+        size_t failures;          /**< @brief The number of allocations that failed because all elements were in use. */
+        size_t fallbacks;         /**< @brief The number of message buffer allocations that were served by a larger size class. Always `0` for other slabs. */
+    } IotStaticMemoryStatistics_t;
+
 /*----------------------- Initialization and cleanup ------------------------*/
 
 /**
@@ -212,6 +271,94 @@
                                       size_t elementSize );
 /* @[declare_static_memory_returninuse] */
 
+/*----------------------------- Slab allocation -----------------------------*/
+
+/**
+ * @function_page{IotStaticMemory_SlabAllocate,static_memory,slaballocate}
+ * @function_snippet{static_memory,slaballocate,this}
+ * @copydoc IotStaticMemory_SlabAllocate
+ * @function_page{IotStaticMemory_SlabFree,static_memory,slabfree}
+ * @function_snippet{static_memory,slabfree,this}
+ * @copydoc IotStaticMemory_SlabFree
+ * @function_page{IotStaticMemory_SlabStatistics,static_memory,slabstatistics}
+ * @function_snippet{static_memory,slabstatistics,this}
+ * @copydoc IotStaticMemory_SlabStatistics
+ */
+
+/**
+ * @brief Allocate an element of a slab.
+ *
+ * This function does not block. It is safe to call from several tasks at once
+ * on the same slab. The element is zeroed before it is returned.
+ *
+ * @param[in] pSlab The slab to allocate from.
+ *
+ * @return Pointer to a free element; `NULL` if all elements are in use.
+ *
+ * <b>Example</b>:
+ * @code{c}
+ * #define NUMBER_OF_OBJECTS    ...
+ * static uint32_t _pInUseObjects[ IOT_STATIC_MEMORY_SLAB_WORDS( NUMBER_OF_OBJECTS ) ] = { 0 };
+ * static object_t _pObjects[ NUMBER_OF_OBJECTS ] = { 0 };
+ * static IotStaticMemorySlab_t _objectSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pObjects,
+ *                                                                                _pInUseObjects,
+ *                                                                                sizeof( object_t ),
+ *                                                                                NUMBER_OF_OBJECTS );
+ *
+ * // The function to statically allocate objects. Must have the same signature
+ * // as malloc().
+ * void * Iot_MallocObject( size_t size )
+ * {
+ *     void * pNewObject = NULL;
+ *
+ *     if( size == sizeof( object_t ) )
+ *     {
+ *         pNewObject = IotStaticMemory_SlabAllocate( &_objectSlab );
+ *     }
+ *
+ *     return pNewObject;
+ * }
+ *
+ * // The function to free statically-allocated objects. Must have the same
+ * // signature as free().
+ * void Iot_FreeObject( void * ptr )
+ * {
+ *     ( void ) IotStaticMemory_SlabFree( &_objectSlab, ptr );
+ * }
+ * @endcode
+ */
+/* @[declare_static_memory_slaballocate] */
+    void * IotStaticMemory_SlabAllocate( IotStaticMemorySlab_t * pSlab );
+/* @[declare_static_memory_slaballocate] */
+
+/**
+ * @brief Return an element to its slab.
+ *
+ * Pointers that are not elements of `pSlab` are ignored, as are elements that
+ * are not allocated. When several tasks free the same element at once, only one
+ * of them returns it to the slab.
+ *
+ * @param[in] pSlab The slab that `ptr` was allocated from.
+ * @param[in] ptr Pointer to the element to free.
+ *
+ * @return `true` if `ptr` is an element of `pSlab`; `false` otherwise.
+ */
+/* @[declare_static_memory_slabfree] */
+    bool IotStaticMemory_SlabFree( IotStaticMemorySlab_t * pSlab,
+                                   void * ptr );
+/* @[declare_static_memory_slabfree] */
+
+/**
+ * @brief Read the usage statistics of a slab.
+ *
+ * @param[in] pSlab The slab to read.
+ * @param[out] pStatistics Set to the statistics of `pSlab`.
+ */
+/* @[declare_static_memory_slabstatistics] */
+    void IotStaticMemory_SlabStatistics( const IotStaticMemorySlab_t * pSlab,
+                                         IotStaticMemoryStatistics_t * pStatistics );
+/* @[declare_static_memory_slabstatistics] */
+
 /*------------------------ Message buffer management ------------------------*/
 
 /**
@@ -224,16 +371,20 @@
  * @function_page{Iot_FreeMessageBuffer,static_memory,freemessagebuffer}
  * @function_snippet{static_memory,freemessagebuffer,this}
  * @copydoc Iot_FreeMessageBuffer
+ * @function_page{Iot_MessageBufferStatistics,static_memory,messagebufferstatistics}
+ * @function_snippet{static_memory,messagebufferstatistics,this}
+ * @copydoc Iot_MessageBufferStatistics
  */
 
 /**
- * @brief Get the fixed size of a message buffer.
+ * @brief Get the size of the largest message buffer.
  *
  * The size of the message buffers are known at compile time, but it is a [constant]
  * (@ref IOT_MESSAGE_BUFFER_SIZE) that may not be visible to all source files.
  * This function allows other source files to know the size of a message buffer.
  *
- * @return The size, in bytes, of a single message buffer.
+ * @return The size, in bytes, of a single message buffer of the largest size
+ * class.
  */
 /* @[declare_static_memory_messagebuffersize] */
     size_t Iot_MessageBufferSize( void );
@@ -246,10 +397,18 @@
  * (http://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html)
  * for message buffers.
  *
+ * Message buffers come in three size classes, configured with
+ * `IOT_MESSAGE_BUFFER_SMALL_SIZE`, `IOT_MESSAGE_BUFFER_MEDIUM_SIZE` and
+ * @ref IOT_MESSAGE_BUFFER_SIZE. A buffer is taken from the smallest class that
+ * fits `size`, or from a larger class if all buffers of that class are in use.
+ * Such an allocation is counted in the `fallbacks` statistic of the class that
+ * fits `size`; an allocation that no class can serve is counted in its
+ * `failures` statistic.
+ *
  * @param[in] size Requested size for a message buffer.
  *
  * @return Pointer to the start of a message buffer. If the `size` argument is larger
- * than the [fixed size of a message buffer](@ref IOT_MESSAGE_BUFFER_SIZE)
+ * than the [largest message buffer](@ref IOT_MESSAGE_BUFFER_SIZE)
  * or no message buffers are available, `NULL` is returned.
  */
 /* @[declare_static_memory_mallocmessagebuffer] */
@@ -269,4 +428,18 @@
     void Iot_FreeMessageBuffer( void * ptr );
 /* @[declare_static_memory_freemessagebuffer] */
 
+/**
+ * @brief Read the usage statistics of a message buffer size class.
+ *
+ * @param[in] sizeClass `0` for the smallest message buffers, `1` for the medium
+ * ones and `2` for the largest ones.
+ * @param[out] pStatistics Set to the statistics of the size class.
+ *
+ * @return `true` if `sizeClass` is valid; `false` otherwise.
+ */
+/* @[declare_static_memory_messagebufferstatistics] */
+    bool Iot_MessageBufferStatistics( size_t sizeClass,
+                                      IotStaticMemoryStatistics_t * pStatistics );
+/* @[declare_static_memory_messagebufferstatistics] */
+
 #endif /* if !defined( IOT_STATIC_MEMORY_H_ ) && ( IOT_STATIC_MEMORY_ONLY == 1 ) */
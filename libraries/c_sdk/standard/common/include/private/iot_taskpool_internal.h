@@ -233,6 +233,70 @@ typedef struct _taskPoolCache
     uint32_t freeCount;       /**< @brief A counter to track the number of jobs in the cache. */
 } _taskPoolCache_t;
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/**
+ * @brief One slot of a task pool work queue.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+    typedef struct _taskPoolWorkSlot
+    {
+        volatile uint32_t sequence;          /**< @brief The queue position this slot is ready for. */
+        struct _taskPoolJob * volatile pJob; /**< @brief The job in this slot, or NULL if the job was taken or canceled. */
+    } _taskPoolWorkSlot_t;
+
+/**
+ * @brief A bounded, lock-free, multi-producer multi-consumer queue of jobs.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+    typedef struct _taskPoolWorkQueue
+    {
+        volatile uint32_t enqueuePosition;                            /**< @brief The next position to write to. */
+        volatile uint32_t dequeuePosition;                            /**< @brief The next position to read from. */
+        _taskPoolWorkSlot_t slots[ IOT_TASKPOOL_WORK_QUEUE_LENGTH ]; /**< @brief The job slots. */
+    } _taskPoolWorkQueue_t;
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+
+/**
+ * @brief The number of bits of a tick that index the slots of one timer wheel level.
+ */
+    #define TASKPOOL_TIMER_WHEEL_SLOT_BITS    ( 5UL )
+
+/**
+ * @brief The number of slots in each timer wheel level.
+ */
+    #define TASKPOOL_TIMER_WHEEL_SLOTS        ( 1UL << TASKPOOL_TIMER_WHEEL_SLOT_BITS )
+
+/**
+ * @brief A hierarchical timer wheel for deferred jobs.
+ *
+ * Level 0 holds the jobs expiring in the current run of 32 ticks, one slot per tick.
+ * Each higher level holds the jobs expiring in the current run of its 32 slots, each
+ * covering one full run of the level below. When a tick reaches a slot of a higher
+ * level, its jobs are placed again in the lower levels.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+    typedef struct _taskPoolTimerWheel
+    {
+        IotListDouble_t slots[ IOT_TASKPOOL_TIMER_WHEEL_LEVELS ][ TASKPOOL_TIMER_WHEEL_SLOTS ]; /**< @brief Deferred jobs, linked through their job link. */
+        uint32_t occupied[ IOT_TASKPOOL_TIMER_WHEEL_LEVELS ];                                   /**< @brief One bit per non-empty slot. */
+        uint64_t currentTick;                                                                    /**< @brief The next tick to process. */
+        uint64_t armedTick;                                                                      /**< @brief The tick the timer is armed for. */
+        uint32_t jobCount;                                                                       /**< @brief The number of jobs in the wheel. */
+    } _taskPoolTimerWheel_t;
+#endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
+
 /**
  * @brief The task pool data structure keeps track of the internal state and the signals for the dispatcher threads.
  * The task pool is a thread safe data structure.
@@ -256,6 +320,15 @@ typedef struct _taskPool
     IotSemaphore_t startStopSignal;  /**< @brief The synchronization object for threads to signal start and stop condition. */
     IotTimer_t timer;                /**< @brief The timer for deferred jobs. */
     IotMutex_t lock;                 /**< @brief The lock to protect the task pool data structure access. */
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+        _taskPoolTimerWheel_t timerWheel; /**< @brief The deferred jobs, replacing the timer events list. */
+    #endif
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        _taskPoolWorkQueue_t workQueues[ IOT_TASKPOOL_WORK_QUEUES ]; /**< @brief The lock-free work queues, one per worker slot. */
+        uint32_t nextWorkQueue;                                      /**< @brief The work queue the next job will be placed in. */
+        uint32_t nextWorkerQueue;                                    /**< @brief The home work queue of the next worker thread. */
+        uint32_t dispatchQueueLength;                                /**< @brief The number of jobs waiting in the dispatch queue. */
+    #endif
 } _taskPool_t;
 
 /**
@@ -272,6 +345,12 @@ typedef struct _taskPoolJob
     void * pUserContext;               /**< @brief The user provided context. */
     uint32_t flags;                    /**< @brief Internal flags. */
     IotTaskPoolJobStatus_t status;     /**< @brief The status for the job. */
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+        uint64_t expirationTime;       /**< @brief When a deferred job should be scheduled. */
+    #endif
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        uint32_t readyUs;              /**< @brief When the job was last scheduled, for #IOT_METRICS_TASKPOOL_QUEUE_WAIT. */
+    #endif
 } _taskPoolJob_t;
 
 /**
@@ -231,6 +231,12 @@ typedef struct IotTaskPoolJobStorage
     void * dummy3;                 /**< @brief Placeholder. */
     uint32_t dummy4;               /**< @brief Placeholder. */
     IotTaskPoolJobStatus_t status; /**< @brief Placeholder. */
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+        uint64_t dummy5;           /**< @brief Placeholder. */
+    #endif
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        uint32_t dummy6;           /**< @brief Placeholder. */
+    #endif
 } IotTaskPoolJobStorage_t;
 
 /**
@@ -43,6 +43,9 @@
 /* Platform layer includes. */
     #include "platform/iot_threads.h"
 
+/* Atomics include. */
+    #include "iot_atomic.h"
+
 /* Static memory include. */
     #include "private/iot_static_memory.h"
 
@@ -60,6 +63,18 @@
     #ifndef IOT_MESSAGE_BUFFER_SIZE
         #define IOT_MESSAGE_BUFFER_SIZE    ( 1024 )
     #endif
+    #ifndef IOT_MESSAGE_SMALL_BUFFERS
+        #define IOT_MESSAGE_SMALL_BUFFERS        ( 8 )
+    #endif
+    #ifndef IOT_MESSAGE_BUFFER_SMALL_SIZE
+        #define IOT_MESSAGE_BUFFER_SMALL_SIZE    ( 64 )
+    #endif
+    #ifndef IOT_MESSAGE_MEDIUM_BUFFERS
+        #define IOT_MESSAGE_MEDIUM_BUFFERS        ( 4 )
+    #endif
+    #ifndef IOT_MESSAGE_BUFFER_MEDIUM_SIZE
+        #define IOT_MESSAGE_BUFFER_MEDIUM_SIZE    ( 256 )
+    #endif
 /** @endcond */
 
 /* Validate static memory configuration settings. */
@@ -69,6 +84,29 @@
     #if IOT_MESSAGE_BUFFER_SIZE <= 0
         #error "IOT_MESSAGE_BUFFER_SIZE cannot be 0 or negative."
     #endif
+    #if IOT_MESSAGE_SMALL_BUFFERS < 0
+        #error "IOT_MESSAGE_SMALL_BUFFERS cannot be negative."
+    #endif
+    #if IOT_MESSAGE_MEDIUM_BUFFERS < 0
+        #error "IOT_MESSAGE_MEDIUM_BUFFERS cannot be negative."
+    #endif
+    #if ( IOT_MESSAGE_BUFFER_SMALL_SIZE <= 0 ) || ( IOT_MESSAGE_BUFFER_SMALL_SIZE > IOT_MESSAGE_BUFFER_MEDIUM_SIZE )
+        #error "IOT_MESSAGE_BUFFER_SMALL_SIZE must be positive and at most IOT_MESSAGE_BUFFER_MEDIUM_SIZE."
+    #endif
+    #if IOT_MESSAGE_BUFFER_MEDIUM_SIZE > IOT_MESSAGE_BUFFER_SIZE
+        #error "IOT_MESSAGE_BUFFER_MEDIUM_SIZE cannot be larger than IOT_MESSAGE_BUFFER_SIZE."
+    #endif
+
+/**
+ * @brief The number of message buffer size classes.
+ */
+    #define MESSAGE_BUFFER_CLASSES    ( 3 )
+
+/**
+ * @brief Declare the storage of a message buffer size class. A class may have
+ * no buffers, but C does not allow empty arrays.
+ */
+    #define MESSAGE_BUFFER_STORAGE( count )    ( ( ( count ) > 0 ) ? ( count ) : 1 )
 
 /*-----------------------------------------------------------*/
 
@@ -80,8 +118,55 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseMessageBuffers[ IOT_MESSAGE_BUFFERS ] = { 0 };                           /**< @brief Message buffer in-use flags. */
-    static char _pMessageBuffers[ IOT_MESSAGE_BUFFERS ][ IOT_MESSAGE_BUFFER_SIZE ] = { { 0 } }; /**< @brief Message buffers. */
+    static uint32_t _pInUseSmallMessageBuffers[ IOT_STATIC_MEMORY_SLAB_WORDS( MESSAGE_BUFFER_STORAGE( IOT_MESSAGE_SMALL_BUFFERS ) ) ] = { 0 }; /**< @brief Small message buffer in-use flags. */
+    static char _pSmallMessageBuffers[ MESSAGE_BUFFER_STORAGE( IOT_MESSAGE_SMALL_BUFFERS ) ][ IOT_MESSAGE_BUFFER_SMALL_SIZE ] = { { 0 } };     /**< @brief Small message buffers. */
+
+    static uint32_t _pInUseMediumMessageBuffers[ IOT_STATIC_MEMORY_SLAB_WORDS( MESSAGE_BUFFER_STORAGE( IOT_MESSAGE_MEDIUM_BUFFERS ) ) ] = { 0 }; /**< @brief Medium message buffer in-use flags. */
+    static char _pMediumMessageBuffers[ MESSAGE_BUFFER_STORAGE( IOT_MESSAGE_MEDIUM_BUFFERS ) ][ IOT_MESSAGE_BUFFER_MEDIUM_SIZE ] = { { 0 } };    /**< @brief Medium message buffers. */
+
+    static uint32_t _pInUseMessageBuffers[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_MESSAGE_BUFFERS ) ] = { 0 }; /**< @brief Message buffer in-use flags. */
+    static char _pMessageBuffers[ IOT_MESSAGE_BUFFERS ][ IOT_MESSAGE_BUFFER_SIZE ] = { { 0 } };           /**< @brief Message buffers. */
+
+/**
+ * @brief The message buffer size classes, from the smallest to the largest.
+ */
+    static IotStaticMemorySlab_t _pMessageBufferSlabs[ MESSAGE_BUFFER_CLASSES ] =
+    {
+        IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pSmallMessageBuffers,
+                                            _pInUseSmallMessageBuffers,
+                                            IOT_MESSAGE_BUFFER_SMALL_SIZE,
+                                            IOT_MESSAGE_SMALL_BUFFERS ),
+        IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pMediumMessageBuffers,
+                                            _pInUseMediumMessageBuffers,
+                                            IOT_MESSAGE_BUFFER_MEDIUM_SIZE,
+                                            IOT_MESSAGE_MEDIUM_BUFFERS ),
+        IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pMessageBuffers,
+                                            _pInUseMessageBuffers,
+                                            IOT_MESSAGE_BUFFER_SIZE,
+                                            IOT_MESSAGE_BUFFERS )
+    };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the in-use bits of a bitmap word that belong to elements of a slab.
+ *
+ * @param[in] pSlab The slab.
+ * @param[in] word Index of the bitmap word.
+ *
+ * @return A mask of the bits of `word` that map to an element.
+ */
+    static uint32_t _slabWordMask( const IotStaticMemorySlab_t * pSlab,
+                                   size_t word );
+
+/**
+ * @brief Allocate an element of a slab without counting a failure.
+ *
+ * @param[in] pSlab The slab to allocate from.
+ *
+ * @return Pointer to a zeroed element; `NULL` if all elements are in use.
+ */
+    static void * _slabClaim( IotStaticMemorySlab_t * pSlab );
 
 /*-----------------------------------------------------------*/
 
@@ -147,6 +232,141 @@
         IotMutex_Unlock( &( _mutex ) );
     }
 
+/*-----------------------------------------------------------*/
+
+    static uint32_t _slabWordMask( const IotStaticMemorySlab_t * pSlab,
+                                   size_t word )
+    {
+        uint32_t mask = UINT32_MAX;
+        size_t elementsInWord = pSlab->elementCount - ( word * 32U );
+
+        /* Only the last word may be partially used. */
+        if( elementsInWord < 32U )
+        {
+            mask = ( 1UL << elementsInWord ) - 1UL;
+        }
+
+        return mask;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void * _slabClaim( IotStaticMemorySlab_t * pSlab )
+    {
+        size_t word = 0, bit = 0;
+        uint32_t inUse = 0, mask = 0, inUseCount = 0, highWaterMark = 0;
+        void * pElement = NULL;
+
+        for( word = 0; ( word < IOT_STATIC_MEMORY_SLAB_WORDS( pSlab->elementCount ) ) && ( pElement == NULL ); word++ )
+        {
+            mask = _slabWordMask( pSlab, word );
+            inUse = pSlab->pInUse[ word ];
+
+            while( ( inUse & mask ) != mask )
+            {
+                /* Claim the lowest free element of this word. It is below the
+                 * end of the slab because the mask is contiguous from bit 0. */
+                for( bit = 0; ( inUse & ( 1UL << bit ) ) != 0UL; bit++ )
+                {
+                }
+
+                if( Atomic_CompareAndSwap_u32( &( pSlab->pInUse[ word ] ),
+                                               inUse | ( 1UL << bit ),
+                                               inUse ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+                {
+                    pElement = ( ( uint8_t * ) pSlab->pPool ) + ( ( ( word * 32U ) + bit ) * pSlab->elementSize );
+                    break;
+                }
+
+                /* Another task changed this word; retry with its new value. */
+                inUse = pSlab->pInUse[ word ];
+            }
+        }
+
+        if( pElement != NULL )
+        {
+            /* Clear the element here rather than in free, once this task owns it. */
+            ( void ) memset( pElement, 0x00, pSlab->elementSize );
+
+            inUseCount = Atomic_Increment_u32( &( pSlab->inUse ) ) + 1U;
+
+            /* Raise the high-water mark if this allocation passed it. */
+            highWaterMark = pSlab->highWaterMark;
+
+            while( ( inUseCount > highWaterMark ) &&
+                   ( Atomic_CompareAndSwap_u32( &( pSlab->highWaterMark ),
+                                                inUseCount,
+                                                highWaterMark ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+            {
+                highWaterMark = pSlab->highWaterMark;
+            }
+        }
+
+        return pElement;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void * IotStaticMemory_SlabAllocate( IotStaticMemorySlab_t * pSlab )
+    {
+        void * pElement = _slabClaim( pSlab );
+
+        if( pElement == NULL )
+        {
+            ( void ) Atomic_Increment_u32( &( pSlab->failures ) );
+        }
+
+        return pElement;
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool IotStaticMemory_SlabFree( IotStaticMemorySlab_t * pSlab,
+                                   void * ptr )
+    {
+        bool isElement = false;
+        uintptr_t poolStart = ( uintptr_t ) pSlab->pPool;
+        uintptr_t offset = 0;
+        size_t index = 0;
+        uint32_t bit = 0;
+
+        if( ( ( uintptr_t ) ptr >= poolStart ) &&
+            ( ( uintptr_t ) ptr < poolStart + ( pSlab->elementSize * pSlab->elementCount ) ) )
+        {
+            offset = ( uintptr_t ) ptr - poolStart;
+
+            if( ( offset % pSlab->elementSize ) == 0U )
+            {
+                isElement = true;
+                index = offset / pSlab->elementSize;
+                bit = 1UL << ( index % 32U );
+
+                /* Only the task that clears the bit returns the element. This
+                 * ignores elements that are not allocated, including a second
+                 * concurrent free of the same element. */
+                if( ( Atomic_AND_u32( &( pSlab->pInUse[ index / 32U ] ), ~bit ) & bit ) != 0UL )
+                {
+                    ( void ) Atomic_Decrement_u32( &( pSlab->inUse ) );
+                }
+            }
+        }
+
+        return isElement;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotStaticMemory_SlabStatistics( const IotStaticMemorySlab_t * pSlab,
+                                         IotStaticMemoryStatistics_t * pStatistics )
+    {
+        pStatistics->elementSize = pSlab->elementSize;
+        pStatistics->elementCount = pSlab->elementCount;
+        pStatistics->inUse = ( size_t ) pSlab->inUse;
+        pStatistics->highWaterMark = ( size_t ) pSlab->highWaterMark;
+        pStatistics->failures = ( size_t ) pSlab->failures;
+        pStatistics->fallbacks = ( size_t ) pSlab->fallbacks;
+    }
+
 /*-----------------------------------------------------------*/
 
     bool IotStaticMemory_Init( void )
@@ -172,19 +392,39 @@
 
     void * Iot_MallocMessageBuffer( size_t size )
     {
-        int32_t freeIndex = -1;
+        size_t sizeClass = 0, fitClass = MESSAGE_BUFFER_CLASSES;
         void * pNewBuffer = NULL;
 
-        /* Check that size is within the fixed message buffer size. */
-        if( size <= IOT_MESSAGE_BUFFER_SIZE )
+        /* Take a buffer from the smallest size class that fits. Fall back to the
+         * larger classes when all buffers of that class are in use. */
+        for( sizeClass = 0; ( sizeClass < MESSAGE_BUFFER_CLASSES ) && ( pNewBuffer == NULL ); sizeClass++ )
         {
-            /* Get the index of a free message buffer. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMessageBuffers,
-                                                  IOT_MESSAGE_BUFFERS );
+            if( size <= _pMessageBufferSlabs[ sizeClass ].elementSize )
+            {
+                if( fitClass == MESSAGE_BUFFER_CLASSES )
+                {
+                    fitClass = sizeClass;
+                }
+
+                pNewBuffer = _slabClaim( &( _pMessageBufferSlabs[ sizeClass ] ) );
+            }
+        }
 
-            if( freeIndex != -1 )
+        /* Account the allocation to the class that fits the request, so that a
+         * fallback is not mistaken for a failure of the larger class. */
+        if( fitClass < MESSAGE_BUFFER_CLASSES )
+        {
+            if( pNewBuffer == NULL )
+            {
+                ( void ) Atomic_Increment_u32( &( _pMessageBufferSlabs[ fitClass ].failures ) );
+            }
+            else if( ( sizeClass - 1U ) != fitClass )
             {
-                pNewBuffer = &( _pMessageBuffers[ freeIndex ][ 0 ] );
+                ( void ) Atomic_Increment_u32( &( _pMessageBufferSlabs[ fitClass ].fallbacks ) );
+            }
+            else
+            {
+                /* Served by the class that fits. */
             }
         }
 
@@ -195,12 +435,32 @@
 
     void Iot_FreeMessageBuffer( void * ptr )
     {
-        /* Return the in-use message buffer. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMessageBuffers,
-                                     _pInUseMessageBuffers,
-                                     IOT_MESSAGE_BUFFERS,
-                                     IOT_MESSAGE_BUFFER_SIZE );
+        size_t sizeClass = 0;
+
+        /* Return the in-use message buffer to the size class it belongs to. */
+        for( sizeClass = 0; sizeClass < MESSAGE_BUFFER_CLASSES; sizeClass++ )
+        {
+            if( IotStaticMemory_SlabFree( &( _pMessageBufferSlabs[ sizeClass ] ), ptr ) == true )
+            {
+                break;
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool Iot_MessageBufferStatistics( size_t sizeClass,
+                                      IotStaticMemoryStatistics_t * pStatistics )
+    {
+        bool status = false;
+
+        if( sizeClass < MESSAGE_BUFFER_CLASSES )
+        {
+            IotStaticMemory_SlabStatistics( &( _pMessageBufferSlabs[ sizeClass ] ), pStatistics );
+            status = true;
+        }
+
+        return status;
     }
 
 /*-----------------------------------------------------------*/
@@ -40,10 +40,16 @@
 /* Platform layer includes. */
 #include "platform/iot_threads.h"
 #include "platform/iot_clock.h"
+#include "platform/iot_metrics.h"
 
 /* Task pool internal include. */
 #include "private/iot_taskpool_internal.h"
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+    /* Atomics include. */
+    #include "iot_atomic.h"
+#endif
+
 /**
  * @brief Enter a critical section by locking a mutex.
  *
@@ -56,6 +62,18 @@
  */
 #define TASKPOOL_EXIT_CRITICAL()     IotMutex_Unlock( &( pTaskPool->lock ) )
 
+/**
+ * @brief Update the number of active jobs. Workers update it without the lock
+ * when scheduling through the work queues.
+ */
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+    #define TASKPOOL_INCREMENT_ACTIVE_JOBS()    ( void ) Atomic_Increment_u32( &( pTaskPool->activeJobs ) )
+    #define TASKPOOL_DECREMENT_ACTIVE_JOBS()    ( void ) Atomic_Decrement_u32( &( pTaskPool->activeJobs ) )
+#else
+    #define TASKPOOL_INCREMENT_ACTIVE_JOBS()    pTaskPool->activeJobs++
+    #define TASKPOOL_DECREMENT_ACTIVE_JOBS()    pTaskPool->activeJobs--
+#endif
+
 /**
  * @brief Maximum semaphore value for wait operations.
  */
@@ -135,16 +153,118 @@ static void _destroyJob( _taskPoolJob_t * const pJob );
  */
 static void _taskPoolWorker( void * pUserContext );
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/* -------------- Convenience functions to handle the lock-free work queues -------------- */
+
+/**
+ * Initializes all work queues of a task pool.
+ *
+ * @param[in] pTaskPool The task pool owning the work queues.
+ */
+    static void _initWorkQueues( _taskPool_t * const pTaskPool );
+
+/**
+ * Claims the slot at the end of a work queue without locking. Workers do not see
+ * the slot until it is published with _workQueuePublish.
+ *
+ * @param[in] pQueue The work queue to claim the slot in.
+ * @param[out] pPosition The queue position of the slot, to publish it with.
+ *
+ * @return The slot, or `NULL` if the work queue is full.
+ */
+    static _taskPoolWorkSlot_t * _workQueueClaim( _taskPoolWorkQueue_t * const pQueue,
+                                                  uint32_t * const pPosition );
+
+/**
+ * Hands a claimed slot to workers, with the job stored in it, if any.
+ *
+ * @param[in] pSlot The slot returned by _workQueueClaim.
+ * @param[in] position The queue position returned by _workQueueClaim.
+ */
+    static void _workQueuePublish( _taskPoolWorkSlot_t * const pSlot,
+                                   uint32_t position );
+
+/**
+ * Claims a slot in the first work queue with space, starting in round-robin order.
+ *
+ * @param[in] pTaskPool The task pool owning the work queues.
+ * @param[out] pPosition The queue position of the slot, to publish it with.
+ *
+ * @return The slot, or `NULL` if all work queues are full.
+ */
+    static _taskPoolWorkSlot_t * _claimWork( _taskPool_t * const pTaskPool,
+                                             uint32_t * const pPosition );
+
+/**
+ * Takes the oldest job out of a work queue without locking, and marks it as executing.
+ * Slots of canceled jobs are skipped.
+ *
+ * @param[in] pQueue The work queue to take the job from.
+ *
+ * @return The job, or `NULL` if the work queue is empty.
+ */
+    static _taskPoolJob_t * _workQueuePop( _taskPoolWorkQueue_t * const pQueue );
+
+/**
+ * Removes a job from whatever work queue holds it.
+ *
+ * @param[in] pTaskPool The task pool owning the work queues.
+ * @param[in] pJob The job to remove.
+ *
+ * @return `true` if the job was removed, `false` if a worker took it already.
+ */
+    static bool _workQueueRemove( _taskPool_t * const pTaskPool,
+                                  _taskPoolJob_t * const pJob );
+
+/**
+ * Places a job in the first work queue with space, starting in round-robin order.
+ *
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to place.
+ *
+ * @return `true` if the job was placed, `false` if all work queues are full.
+ */
+    static bool _enqueueWork( _taskPool_t * const pTaskPool,
+                              _taskPoolJob_t * const pJob );
+
+/**
+ * Finds the next job for a worker: high priority and overflow jobs in the dispatch
+ * queue first, then the worker home queue, then the work queues of the other workers.
+ *
+ * @param[in] pTaskPool The task pool to find the job in.
+ * @param[in] homeQueue The index of the home work queue of the calling worker.
+ *
+ * @return The job, already marked as executing, or `NULL` if there is none.
+ */
+    static _taskPoolJob_t * _dequeueWork( _taskPool_t * const pTaskPool,
+                                          uint32_t homeQueue );
+
+/**
+ * Schedules a job through the work queues without taking the task pool lock.
+ *
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to schedule.
+ *
+ * @return `true` if the job was scheduled, `false` if the job must be scheduled
+ * under the lock instead.
+ */
+    static bool _tryScheduleLockFree( _taskPool_t * const pTaskPool,
+                                      _taskPoolJob_t * const pJob );
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
 /* -------------- Convenience functions to handle timer events  -------------- */
 
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
+
 /**
  * Comparer for the time list.
  *
  * param[in] pTimerEventLink1 The link to the first timer event.
  * param[in] pTimerEventLink1 The link to the first timer event.
  */
-static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
-                                   const IotLink_t * const pTimerEventLink2 );
+    static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
+                                       const IotLink_t * const pTimerEventLink2 );
 
 /**
  * Reschedules the timer for handling deferred jobs to the next timeout.
@@ -152,8 +272,10 @@ static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
  * param[in] pTimer The timer to reschedule.
  * param[in] pFirstTimerEvent The timer event that carries the timeout and job information.
  */
-static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
-                                          _taskPoolTimerEvent_t * const pFirstTimerEvent );
+    static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
+                                              _taskPoolTimerEvent_t * const pFirstTimerEvent );
+
+#endif
 
 /**
  * The task pool timer procedure for scheduling deferred jobs.
@@ -162,6 +284,71 @@ static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
  */
 static void _timerThread( void * pArgument );
 
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+
+/**
+ * Initializes an empty timer wheel.
+ *
+ * param[in] pWheel The timer wheel to initialize.
+ */
+    static void _timerWheelInit( _taskPoolTimerWheel_t * const pWheel );
+
+/**
+ * Places a deferred job in the slot for its expiration time, relative to the current tick.
+ *
+ * param[in] pWheel The timer wheel to place the job in.
+ * param[in] pJob The job to place. Its expiration time must be set.
+ */
+    static void _timerWheelPlace( _taskPoolTimerWheel_t * const pWheel,
+                                  _taskPoolJob_t * const pJob );
+
+/**
+ * Adds a deferred job to the timer wheel, and re-arms the timer if the job expires first.
+ *
+ * param[in] pTaskPool The task pool owning the timer wheel.
+ * param[in] pJob The job to add. Its expiration time must be set.
+ */
+    static void _timerWheelInsert( _taskPool_t * const pTaskPool,
+                                   _taskPoolJob_t * const pJob );
+
+/**
+ * Removes a deferred job from the timer wheel.
+ *
+ * param[in] pWheel The timer wheel holding the job.
+ * param[in] pJob The job to remove.
+ */
+    static void _timerWheelRemove( _taskPoolTimerWheel_t * const pWheel,
+                                   _taskPoolJob_t * const pJob );
+
+/**
+ * Finds the first tick at which the timer wheel has jobs to schedule or to place again.
+ *
+ * param[in] pWheel The timer wheel.
+ *
+ * @return The tick, or `UINT64_MAX` if the timer wheel is empty.
+ */
+    static uint64_t _timerWheelNextTick( const _taskPoolTimerWheel_t * const pWheel );
+
+/**
+ * Processes one tick: places again the jobs of the higher level slots reached at this
+ * tick, then schedules all jobs in the level 0 slot.
+ *
+ * param[in] pTaskPool The task pool owning the timer wheel.
+ * param[in] tick The tick to process.
+ * param[in] now The current time.
+ */
+    static void _timerWheelExpire( _taskPool_t * const pTaskPool,
+                                   uint64_t tick,
+                                   uint64_t now );
+
+/**
+ * Arms the task pool timer for the next tick with jobs.
+ *
+ * param[in] pTaskPool The task pool owning the timer wheel.
+ */
+    static void _timerWheelArm( _taskPool_t * const pTaskPool );
+#endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
+
 /* -------------- Convenience functions to create/initialize/destroy the task pool -------------- */
 
 /**
@@ -230,6 +417,8 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
                                              _taskPoolJob_t * const pJob,
                                              uint32_t flags );
 
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
+
 /**
  * Matches a deferred job in the timer queue with its timer event wrapper.
  *
@@ -237,8 +426,10 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
  * @param[in] pMatch A pointer to the job to match.
  *
  */
-static bool _matchJobByPointer( const IotLink_t * const pLink,
-                                void * pMatch );
+    static bool _matchJobByPointer( const IotLink_t * const pLink,
+                                    void * pMatch );
+
+#endif
 
 /**
  * Tries to cancel a job.
@@ -379,49 +570,104 @@ IotTaskPoolError_t IotTaskPool_Destroy( IotTaskPool_t taskPoolHandle )
             }
         } while( pItemLink );
 
-        /* (2) Clear the timer queue. */
-        {
-            _taskPoolTimerEvent_t * pTimerEvent;
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            /* Also clear the work queues. */
+            for( count = 0; count < IOT_TASKPOOL_WORK_QUEUES; ++count )
+            {
+                _taskPoolJob_t * pJob = _workQueuePop( &pTaskPool->workQueues[ count ] );
 
-            /* A deferred job may have fired already. Since deferred jobs will go through the same mutex
-             * the shutdown sequence is holding at this stage, there is no risk for race conditions. Yet, we
-             * need to let the deferred job to destroy the task pool. */
+                while( pJob != NULL )
+                {
+                    _destroyJob( pJob );
 
-            pItemLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
+                    pJob = _workQueuePop( &pTaskPool->workQueues[ count ] );
+                }
+            }
 
-            if( pItemLink != NULL )
+            pTaskPool->dispatchQueueLength = 0;
+        #endif
+
+        #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
+            /* (2) Clear the timer queue. */
             {
-                uint64_t now = IotClock_GetTimeMs();
+                _taskPoolTimerEvent_t * pTimerEvent;
+
+                /* A deferred job may have fired already. Since deferred jobs will go through the same mutex
+                 * the shutdown sequence is holding at this stage, there is no risk for race conditions. Yet, we
+                 * need to let the deferred job to destroy the task pool. */
+
+                pItemLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
 
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
+                if( pItemLink != NULL )
+                {
+                    uint64_t now = IotClock_GetTimeMs();
+
+                    pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
+
+                    if( pTimerEvent->expirationTime <= now )
+                    {
+                        IotLogDebug( "Shutdown will be deferred to the timer thread" );
+
+                        /* Timer may have fired already! Let the timer thread destroy
+                         * complete the taskpool destruction sequence. */
+                        completeShutdown = false;
+                    }
+
+                    /* Remove all timers from the timeout list. */
+                    for( ; ; )
+                    {
+                        pItemLink = IotListDouble_RemoveHead( &pTaskPool->timerEventsList );
+
+                        if( pItemLink == NULL )
+                        {
+                            break;
+                        }
+
+                        pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
+
+                        _destroyJob( pTimerEvent->pJob );
+
+                        IotTaskPool_FreeTimerEvent( pTimerEvent );
+                    }
+                }
+            }
+        #else /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0 */
+            /* (2) Clear the timer wheel. */
+            {
+                uint32_t level, slot;
 
-                if( pTimerEvent->expirationTime <= now )
+                /* Timer may have fired already! Let the timer thread complete the taskpool destruction sequence. */
+                if( ( pTaskPool->timerWheel.jobCount > 0UL ) &&
+                    ( ( pTaskPool->timerWheel.armedTick * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS ) <= IotClock_GetTimeMs() ) )
                 {
                     IotLogDebug( "Shutdown will be deferred to the timer thread" );
 
-                    /* Timer may have fired already! Let the timer thread destroy
-                     * complete the taskpool destruction sequence. */
                     completeShutdown = false;
                 }
 
-                /* Remove all timers from the timeout list. */
-                for( ; ; )
+                for( level = 0; level < IOT_TASKPOOL_TIMER_WHEEL_LEVELS; ++level )
                 {
-                    pItemLink = IotListDouble_RemoveHead( &pTaskPool->timerEventsList );
-
-                    if( pItemLink == NULL )
+                    for( slot = 0; slot < TASKPOOL_TIMER_WHEEL_SLOTS; ++slot )
                     {
-                        break;
-                    }
+                        for( ; ; )
+                        {
+                            pItemLink = IotListDouble_RemoveHead( &pTaskPool->timerWheel.slots[ level ][ slot ] );
 
-                    pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
+                            if( pItemLink == NULL )
+                            {
+                                break;
+                            }
 
-                    _destroyJob( pTimerEvent->pJob );
+                            _destroyJob( IotLink_Container( _taskPoolJob_t, pItemLink, link ) );
+                        }
+                    }
 
-                    IotTaskPool_FreeTimerEvent( pTimerEvent );
+                    pTaskPool->timerWheel.occupied[ level ] = 0;
                 }
+
+                pTaskPool->timerWheel.jobCount = 0;
             }
-        }
+        #endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0 */
 
         /* (3) Clear the job cache. */
         do
@@ -705,6 +951,17 @@ IotTaskPoolError_t IotTaskPool_Schedule( IotTaskPool_t taskPoolHandle,
 
     pTaskPool = ( _taskPool_t * ) taskPoolHandle;
 
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        /* Normal priority jobs that are not queued anywhere skip the lock. */
+        if( flags == 0UL )
+        {
+            if( _tryScheduleLockFree( pTaskPool, pJob ) == true )
+            {
+                TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_SUCCESS );
+            }
+        }
+    #endif
+
     TASKPOOL_ENTER_CRITICAL();
     {
         /* Bail out early if this task pool is shutting down. */
@@ -761,46 +1018,55 @@ IotTaskPoolError_t IotTaskPool_ScheduleDeferred( IotTaskPool_t taskPoolHandle,
         /* If all safety checks completed, proceed. */
         if( TASKPOOL_SUCCEEDED( _trySafeExtraction( pTaskPool, pJob, false ) ) )
         {
-            IotLink_t * pTimerEventLink;
-            uint64_t now;
+            #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
+                IotLink_t * pTimerEventLink;
+                uint64_t now;
 
-            _taskPoolTimerEvent_t * pTimerEvent = ( _taskPoolTimerEvent_t * ) IotTaskPool_MallocTimerEvent( sizeof( _taskPoolTimerEvent_t ) );
+                _taskPoolTimerEvent_t * pTimerEvent = ( _taskPoolTimerEvent_t * ) IotTaskPool_MallocTimerEvent( sizeof( _taskPoolTimerEvent_t ) );
 
-            if( pTimerEvent == NULL )
-            {
-                TASKPOOL_EXIT_CRITICAL();
+                if( pTimerEvent == NULL )
+                {
+                    TASKPOOL_EXIT_CRITICAL();
 
-                TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_NO_MEMORY );
-            }
+                    TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_NO_MEMORY );
+                }
 
-            memset( pTimerEvent, 0x00, sizeof( _taskPoolTimerEvent_t ) );
+                memset( pTimerEvent, 0x00, sizeof( _taskPoolTimerEvent_t ) );
 
-            now = IotClock_GetTimeMs();
+                now = IotClock_GetTimeMs();
 
-            pTimerEvent->link.pNext = NULL;
-            pTimerEvent->link.pPrevious = NULL;
-            pTimerEvent->expirationTime = now + timeMs;
-            pTimerEvent->pJob = ( _taskPoolJob_t * ) pJob;
+                pTimerEvent->link.pNext = NULL;
+                pTimerEvent->link.pPrevious = NULL;
+                pTimerEvent->expirationTime = now + timeMs;
+                pTimerEvent->pJob = ( _taskPoolJob_t * ) pJob;
 
-            /* Append the timer event to the timer list. */
-            IotListDouble_InsertSorted( &pTaskPool->timerEventsList, &pTimerEvent->link, _timerEventCompare );
+                /* Append the timer event to the timer list. */
+                IotListDouble_InsertSorted( &pTaskPool->timerEventsList, &pTimerEvent->link, _timerEventCompare );
 
-            /* Update the job status to 'scheduled'. */
-            pJob->status = IOT_TASKPOOL_STATUS_DEFERRED;
+                /* Update the job status to 'scheduled'. */
+                pJob->status = IOT_TASKPOOL_STATUS_DEFERRED;
 
-            /* Peek the first event in the timer event list. There must be at least one,
-             * since we just inserted it. */
-            pTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-            IotTaskPool_Assert( pTimerEventLink != NULL );
+                /* Peek the first event in the timer event list. There must be at least one,
+                 * since we just inserted it. */
+                pTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
+                IotTaskPool_Assert( pTimerEventLink != NULL );
 
-            /* If the event we inserted is at the front of the queue, then
-             * we need to reschedule the underlying timer. */
-            if( pTimerEventLink == &pTimerEvent->link )
-            {
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link );
+                /* If the event we inserted is at the front of the queue, then
+                 * we need to reschedule the underlying timer. */
+                if( pTimerEventLink == &pTimerEvent->link )
+                {
+                    pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link );
 
-                _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
-            }
+                    _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
+                }
+            #else
+                pJob->expirationTime = IotClock_GetTimeMs() + timeMs;
+
+                /* Update the job status to 'deferred'. */
+                pJob->status = IOT_TASKPOOL_STATUS_DEFERRED;
+
+                _timerWheelInsert( pTaskPool, pJob );
+            #endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0 */
         }
         else
         {
@@ -972,6 +1238,14 @@ static IotTaskPoolError_t _initTaskPoolControlStructures( const IotTaskPoolInfo_
 
     _initJobsCache( &pTaskPool->jobsCache );
 
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+        _timerWheelInit( &pTaskPool->timerWheel );
+    #endif
+
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        _initWorkQueues( pTaskPool );
+    #endif
+
     /* Initialize the semaphore to ensure all threads have started. */
     if( IotSemaphore_Create( &pTaskPool->startStopSignal, 0, TASKPOOL_MAX_SEM_VALUE ) == true )
     {
@@ -1123,12 +1397,15 @@ static void _destroyTaskPool( _taskPool_t * const pTaskPool )
 
 /* ---------------------------------------------------------------------------------------------- */
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0
+
 static void _taskPoolWorker( void * pUserContext )
 {
     IotTaskPool_Assert( pUserContext != NULL );
 
     IotTaskPoolRoutine_t userCallback = NULL;
     bool running = true;
+    uint32_t runStartUs = 0;
 
     /* Extract pTaskPool pointer from context. */
     _taskPool_t * pTaskPool = ( _taskPool_t * ) pUserContext;
@@ -1236,8 +1513,18 @@ static void _taskPoolWorker( void * pUserContext )
                 IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) == false );
                 IotTaskPool_Assert( userCallback != NULL );
 
+                #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+                    IOT_METRICS_RECORD_SINCE( IOT_METRICS_TASKPOOL_QUEUE_WAIT, pJob->readyUs );
+                #endif
+
+                /* The callback may free or reschedule the job, so only
+                 * the start time is kept to measure it. */
+                runStartUs = IOT_METRICS_TIMESTAMP();
+
                 userCallback( pTaskPool, pJob, pJob->pUserContext );
 
+                IOT_METRICS_RECORD_SINCE( IOT_METRICS_TASKPOOL_RUN, runStartUs );
+
                 /* This job is finished, clear its pointer. */
                 pJob = NULL;
                 userCallback = NULL;
@@ -1254,7 +1541,7 @@ static void _taskPoolWorker( void * pUserContext )
             TASKPOOL_ENTER_CRITICAL();
             {
                 /* Update the number of busy threads, so new requests can be served by creating new threads, up to maxThreads. */
-                pTaskPool->activeJobs--;
+                TASKPOOL_DECREMENT_ACTIVE_JOBS();
 
                 /* Try and dequeue the next job in the dispatch queue. */
                 IotLink_t * pItem = NULL;
@@ -1284,6 +1571,139 @@ static void _taskPoolWorker( void * pUserContext )
     } while( running == true );
 }
 
+#else /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0 */
+
+static void _taskPoolWorker( void * pUserContext )
+{
+    IotTaskPool_Assert( pUserContext != NULL );
+
+    bool running = true;
+    uint32_t runStartUs = 0;
+
+    /* Extract pTaskPool pointer from context. */
+    _taskPool_t * pTaskPool = ( _taskPool_t * ) pUserContext;
+
+    /* Workers are assigned a home work queue in round-robin order. */
+    uint32_t homeQueue = Atomic_Increment_u32( &pTaskPool->nextWorkerQueue ) % IOT_TASKPOOL_WORK_QUEUES;
+
+    /* Signal that this worker completed initialization and it is ready to receive notifications. */
+    IotSemaphore_Post( &pTaskPool->startStopSignal );
+
+    /* OUTER LOOP: it controls the lifetime of the worker thread, exactly as when jobs
+     * are dispatched through the dispatch queue only. */
+    do
+    {
+        bool jobAvailable;
+        _taskPoolJob_t * pJob = NULL;
+
+        /* Wait on incoming notifications. If waiting on the semaphore return with timeout, then
+         * it means that this thread should consider shutting down for the task pool to fold back
+         * to its minimum number of threads. */
+        jobAvailable = IotSemaphore_TimedWait( &pTaskPool->dispatchSignal, IOT_TASKPOOL_JOB_WAIT_TIMEOUT_MS );
+
+        /* The lock is only needed to update the number of active threads, that is on shutdown,
+         * when the 'max threads' quota was exceeded, or after a timeout. */
+        if( ( jobAvailable == false ) ||
+            ( _IsShutdownStarted( pTaskPool ) == true ) ||
+            ( pTaskPool->activeThreads > pTaskPool->maxThreads ) )
+        {
+            TASKPOOL_ENTER_CRITICAL();
+            {
+                /* If the exit condition is verified, update the number of active threads and exit the loop. */
+                if( _IsShutdownStarted( pTaskPool ) )
+                {
+                    IotLogDebug( "Worker thread exiting because shutdown condition was set." );
+
+                    /* Decrease the number of active threads. */
+                    pTaskPool->activeThreads--;
+
+                    TASKPOOL_EXIT_CRITICAL();
+
+                    /* Signal that this worker is exiting. */
+                    IotSemaphore_Post( &pTaskPool->startStopSignal );
+
+                    /* On shutdown, abandon the OUTER LOOP immediately. */
+                    break;
+                }
+
+                /* Check if this thread needs to exit because 'max threads' quota was exceeded.
+                 * In that case, let it run once, so high priority jobs can still be served. */
+                if( pTaskPool->activeThreads > pTaskPool->maxThreads )
+                {
+                    IotLogDebug( "Worker thread will exit because maximum quota was exceeded." );
+
+                    /* Decrease the number of active threads pro-actively. */
+                    pTaskPool->activeThreads--;
+
+                    /* Mark this thread as dead. */
+                    running = false;
+                }
+                /* Check if this thread needs to exit because the worker woke up after a timeout. */
+                else if( ( jobAvailable == false ) && ( pTaskPool->activeThreads > pTaskPool->minThreads ) )
+                {
+                    IotLogDebug( "Worker will exit because task pool is shrinking." );
+
+                    /* Decrease the number of active threads pro-actively. */
+                    pTaskPool->activeThreads--;
+
+                    /* Mark this thread as dead. */
+                    running = false;
+                }
+                else
+                {
+                    /* Nothing to do. */
+                }
+            }
+            TASKPOOL_EXIT_CRITICAL();
+        }
+
+        /* Only look for a job if waiting did not timed out. */
+        if( jobAvailable == true )
+        {
+            pJob = _dequeueWork( pTaskPool, homeQueue );
+        }
+
+        /* INNER LOOP: it controls the execution of jobs: the exit condition is the lack of a job to execute. */
+        while( pJob != NULL )
+        {
+            IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) == false );
+            IotTaskPool_Assert( pJob->userCallback != NULL );
+
+            #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+                IOT_METRICS_RECORD_SINCE( IOT_METRICS_TASKPOOL_QUEUE_WAIT, pJob->readyUs );
+            #endif
+
+            /* The callback may free or reschedule the job, so only the start
+             * time is kept to measure it. */
+            runStartUs = IOT_METRICS_TIMESTAMP();
+
+            /* Process the job by invoking the associated callback with the user context.
+             * This task pool thread will not be available until the user callback returns. */
+            pJob->userCallback( pTaskPool, pJob, pJob->pUserContext );
+
+            IOT_METRICS_RECORD_SINCE( IOT_METRICS_TASKPOOL_RUN, runStartUs );
+
+            /* This job is finished, clear its pointer. */
+            pJob = NULL;
+
+            /* If this thread exceeded the quota, then let it terminate. */
+            if( running == false )
+            {
+                /* Abandon the INNER LOOP. Execution will tranfer back to the OUTER LOOP condition. */
+                break;
+            }
+
+            /* Update the number of busy threads, so new requests can be served by creating new threads, up to maxThreads. */
+            TASKPOOL_DECREMENT_ACTIVE_JOBS();
+
+            /* Try and take the next job, stealing from other workers if the home work queue is empty. */
+            pJob = _dequeueWork( pTaskPool, homeQueue );
+        }
+    } while( running == true );
+}
+
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0 */
+
 /* ---------------------------------------------------------------------------------------------- */
 
 static void _initJobsCache( _taskPoolCache_t * const pCache )
@@ -1438,8 +1858,12 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
     /* Update the job status to 'scheduled'. */
     pJob->status = IOT_TASKPOOL_STATUS_SCHEDULED;
 
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        pJob->readyUs = IOT_METRICS_TIMESTAMP();
+    #endif
+
     /* Update the number of active jobs optimistically, so new requests can be served by creating new threads. */
-    pTaskPool->activeJobs++;
+    TASKPOOL_INCREMENT_ACTIVE_JOBS();
 
     /* If all threads are busy, try and create a new one. Failing to create a new thread
      * only has performance implications on correctly executing the scheduled job.
@@ -1505,10 +1929,24 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
             IotLogDebug( "High priority job: placing job at the head of the queue." );
 
             IotDeQueue_EnqueueHead( &pTaskPool->dispatchQueue, &pJob->link );
+
+            #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                pTaskPool->dispatchQueueLength++;
+            #endif
         }
         else
         {
-            IotDeQueue_EnqueueTail( &pTaskPool->dispatchQueue, &pJob->link );
+            #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                /* Jobs only wait in the dispatch queue when all work queues are full. */
+                if( _enqueueWork( pTaskPool, pJob ) == false )
+                {
+                    IotDeQueue_EnqueueTail( &pTaskPool->dispatchQueue, &pJob->link );
+
+                    pTaskPool->dispatchQueueLength++;
+                }
+            #else
+                IotDeQueue_EnqueueTail( &pTaskPool->dispatchQueue, &pJob->link );
+            #endif
         }
 
         /* Signal a worker to pick up the job. */
@@ -1521,7 +1959,7 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
         IotTaskPool_Assert( mustGrow == true );
 
         /* Revert updating the number of active jobs. */
-        pTaskPool->activeJobs--;
+        TASKPOOL_DECREMENT_ACTIVE_JOBS();
     }
 
     TASKPOOL_FUNCTION_CLEANUP_END();
@@ -1529,20 +1967,24 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
 
 /*-----------------------------------------------------------*/
 
-static bool _matchJobByPointer( const IotLink_t * const pLink,
-                                void * pMatch )
-{
-    const _taskPoolJob_t * const pJob = ( _taskPoolJob_t * ) pMatch;
-
-    const _taskPoolTimerEvent_t * const pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
 
-    if( pJob == pTimerEvent->pJob )
+    static bool _matchJobByPointer( const IotLink_t * const pLink,
+                                    void * pMatch )
     {
-        return true;
+        const _taskPoolJob_t * const pJob = ( _taskPoolJob_t * ) pMatch;
+
+        const _taskPoolTimerEvent_t * const pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+
+        if( pJob == pTimerEvent->pJob )
+        {
+            return true;
+        }
+
+        return false;
     }
 
-    return false;
-}
+#endif
 
 /*-----------------------------------------------------------*/
 
@@ -1578,6 +2020,23 @@ static IotTaskPoolError_t _tryCancelInternal( _taskPool_t * const pTaskPool,
             break;
     }
 
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+        /* A scheduled job that is not in the dispatch queue is in a work queue, unless a
+         * worker took it already, in which case the job is executing. */
+        if( ( currentStatus == IOT_TASKPOOL_STATUS_SCHEDULED ) &&
+            ( IotLink_IsLinked( &pJob->link ) == false ) )
+        {
+            if( _workQueueRemove( pTaskPool, pJob ) == false )
+            {
+                IotLogWarn( "Attempt to cancel a job that is already executing." );
+
+                currentStatus = IOT_TASKPOOL_STATUS_COMPLETED;
+                cancelable = false;
+            }
+        }
+    #endif
+
     /* Update the returned status to the current status of the job. */
     if( pStatus != NULL )
     {
@@ -1597,47 +2056,63 @@ static IotTaskPoolError_t _tryCancelInternal( _taskPool_t * const pTaskPool,
          * queue and signal any waiting threads. */
         if( currentStatus == IOT_TASKPOOL_STATUS_SCHEDULED )
         {
-            /* A scheduled work items must be in the dispatch queue. */
-            IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
+            #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                /* Jobs removed from a work queue are not linked anywhere. */
+                if( IotLink_IsLinked( &pJob->link ) )
+                {
+                    IotDeQueue_Remove( &pJob->link );
+
+                    pTaskPool->dispatchQueueLength--;
+                }
+            #else
+                /* A scheduled work items must be in the dispatch queue. */
+                IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
 
-            IotDeQueue_Remove( &pJob->link );
+                IotDeQueue_Remove( &pJob->link );
+            #endif
         }
 
         /* If the job current status is 'deferred' then the job has to be pending
          * in the timeouts queue. */
         else if( currentStatus == IOT_TASKPOOL_STATUS_DEFERRED )
         {
-            /* Find the timer event associated with the current job. There MUST be one, hence assert if not. */
-            IotLink_t * pTimerEventLink = IotListDouble_FindFirstMatch( &pTaskPool->timerEventsList, NULL, _matchJobByPointer, pJob );
-            IotTaskPool_Assert( pTimerEventLink != NULL );
-
-            if( pTimerEventLink != NULL )
-            {
-                bool shouldReschedule = false;
-
-                /* If the job being cancelled was at the head of the timeouts queue, then we need to reschedule the timer
-                 * with the next job timeout */
-                IotLink_t * pHeadLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-
-                if( pHeadLink == pTimerEventLink )
+            #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+                /* The job is linked in the timer wheel slot it expires in. The timer is not
+                 * re-armed, it will find nothing to do when it fires. */
+                _timerWheelRemove( &pTaskPool->timerWheel, pJob );
+            #else
+                /* Find the timer event associated with the current job. There MUST be one, hence assert if not. */
+                IotLink_t * pTimerEventLink = IotListDouble_FindFirstMatch( &pTaskPool->timerEventsList, NULL, _matchJobByPointer, pJob );
+                IotTaskPool_Assert( pTimerEventLink != NULL );
+
+                if( pTimerEventLink != NULL )
                 {
-                    shouldReschedule = true;
-                }
+                    bool shouldReschedule = false;
 
-                /* Remove the timer event associated with the canceled job and free the associated memory. */
-                IotListDouble_Remove( pTimerEventLink );
-                IotTaskPool_FreeTimerEvent( IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link ) );
+                    /* If the job being cancelled was at the head of the timeouts queue, then we need to reschedule the timer
+                     * with the next job timeout */
+                    IotLink_t * pHeadLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
 
-                if( shouldReschedule )
-                {
-                    IotLink_t * pNextTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
+                    if( pHeadLink == pTimerEventLink )
+                    {
+                        shouldReschedule = true;
+                    }
+
+                    /* Remove the timer event associated with the canceled job and free the associated memory. */
+                    IotListDouble_Remove( pTimerEventLink );
+                    IotTaskPool_FreeTimerEvent( IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link ) );
 
-                    if( pNextTimerEventLink != NULL )
+                    if( shouldReschedule )
                     {
-                        _rescheduleDeferredJobsTimer( &pTaskPool->timer, IotLink_Container( _taskPoolTimerEvent_t, pNextTimerEventLink, link ) );
+                        IotLink_t * pNextTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
+
+                        if( pNextTimerEventLink != NULL )
+                        {
+                            _rescheduleDeferredJobsTimer( &pTaskPool->timer, IotLink_Container( _taskPoolTimerEvent_t, pNextTimerEventLink, link ) );
+                        }
                     }
                 }
-            }
+            #endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
         }
         else
         {
@@ -1706,61 +2181,68 @@ static IotTaskPoolError_t _trySafeExtraction( _taskPool_t * const pTaskPool,
 
 /*-----------------------------------------------------------*/
 
-static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
-                                   const IotLink_t * const pTimerEventLink2 )
-{
-    const _taskPoolTimerEvent_t * const pTimerEvent1 = IotLink_Container( _taskPoolTimerEvent_t,
-                                                                          pTimerEventLink1,
-                                                                          link );
-    const _taskPoolTimerEvent_t * const pTimerEvent2 = IotLink_Container( _taskPoolTimerEvent_t,
-                                                                          pTimerEventLink2,
-                                                                          link );
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
 
-    if( pTimerEvent1->expirationTime < pTimerEvent2->expirationTime )
+    static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
+                                       const IotLink_t * const pTimerEventLink2 )
     {
-        return -1;
-    }
+        const _taskPoolTimerEvent_t * const pTimerEvent1 = IotLink_Container( _taskPoolTimerEvent_t,
+                                                                              pTimerEventLink1,
+                                                                              link );
+        const _taskPoolTimerEvent_t * const pTimerEvent2 = IotLink_Container( _taskPoolTimerEvent_t,
+                                                                              pTimerEventLink2,
+                                                                              link );
+
+        if( pTimerEvent1->expirationTime < pTimerEvent2->expirationTime )
+        {
+            return -1;
+        }
 
-    if( pTimerEvent1->expirationTime > pTimerEvent2->expirationTime )
-    {
-        return 1;
-    }
+        if( pTimerEvent1->expirationTime > pTimerEvent2->expirationTime )
+        {
+            return 1;
+        }
 
-    return 0;
-}
+        return 0;
+    }
 
-/*-----------------------------------------------------------*/
+    /*-----------------------------------------------------------*/
 
-static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
-                                          _taskPoolTimerEvent_t * const pFirstTimerEvent )
-{
-    uint64_t delta = 0;
-    uint64_t now = IotClock_GetTimeMs();
-
-    if( pFirstTimerEvent->expirationTime > now )
+    static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
+                                              _taskPoolTimerEvent_t * const pFirstTimerEvent )
     {
-        delta = pFirstTimerEvent->expirationTime - now;
-    }
+        uint64_t delta = 0;
+        uint64_t now = IotClock_GetTimeMs();
 
-    if( delta < TASKPOOL_JOB_RESCHEDULE_DELAY_MS )
-    {
-        delta = TASKPOOL_JOB_RESCHEDULE_DELAY_MS; /* The job will be late... */
-    }
+        if( pFirstTimerEvent->expirationTime > now )
+        {
+            delta = pFirstTimerEvent->expirationTime - now;
+        }
 
-    IotTaskPool_Assert( delta > 0 );
+        if( delta < TASKPOOL_JOB_RESCHEDULE_DELAY_MS )
+        {
+            delta = TASKPOOL_JOB_RESCHEDULE_DELAY_MS; /* The job will be late... */
+        }
 
-    if( IotClock_TimerArm( pTimer, ( uint32_t ) delta, 0 ) == false )
-    {
-        IotLogWarn( "Failed to re-arm timer for task pool" );
+        IotTaskPool_Assert( delta > 0 );
+
+        if( IotClock_TimerArm( pTimer, ( uint32_t ) delta, 0 ) == false )
+        {
+            IotLogWarn( "Failed to re-arm timer for task pool" );
+        }
     }
-}
+
+#endif
 
 /*-----------------------------------------------------------*/
 
 static void _timerThread( void * pArgument )
 {
     _taskPool_t * pTaskPool = ( _taskPool_t * ) pArgument;
-    _taskPoolTimerEvent_t * pTimerEvent = NULL;
+
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 0
+        _taskPoolTimerEvent_t * pTimerEvent = NULL;
+    #endif
 
     IotLogDebug( "Timer thread started for task pool %p.", pTaskPool );
 
@@ -1783,53 +2265,642 @@ static void _timerThread( void * pArgument )
             return;
         }
 
-        /* Dispatch all deferred job whose timer expired, then reset the timer for the next
-         * job down the line. */
-        for( ; ; )
-        {
-            /* Peek the first event in the timer event list. */
-            IotLink_t * pLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-
-            /* Check if the timer misfired for any reason.  */
-            if( pLink != NULL )
+        #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
             {
-                /* Record the current time. */
                 uint64_t now = IotClock_GetTimeMs();
+                uint64_t tick = _timerWheelNextTick( &pTaskPool->timerWheel );
+
+                /* Dispatch all deferred jobs whose tick expired in one pass, skipping the ticks
+                 * without jobs, then arm the timer for the next tick with jobs. */
+                while( tick <= ( now / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS ) )
+                {
+                    _timerWheelExpire( pTaskPool, tick, now );
+
+                    tick = _timerWheelNextTick( &pTaskPool->timerWheel );
+                }
 
-                /* Extract the job from its envelope. */
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+                _timerWheelArm( pTaskPool );
+            }
+        #else /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
+            /* Dispatch all deferred job whose timer expired, then reset the timer for the next
+             * job down the line. */
+            for( ; ; )
+            {
+                /* Peek the first event in the timer event list. */
+                IotLink_t * pLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
 
-                /* Check if the first event should be processed now. */
-                if( pTimerEvent->expirationTime <= now )
+                /* Check if the timer misfired for any reason.  */
+                if( pLink != NULL )
                 {
-                    /*  Remove the timer event for immediate processing. */
-                    IotListDouble_Remove( &( pTimerEvent->link ) );
+                    /* Record the current time. */
+                    uint64_t now = IotClock_GetTimeMs();
+
+                    /* Extract the job from its envelope. */
+                    pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+
+                    /* Check if the first event should be processed now. */
+                    if( pTimerEvent->expirationTime <= now )
+                    {
+                        /*  Remove the timer event for immediate processing. */
+                        IotListDouble_Remove( &( pTimerEvent->link ) );
+                    }
+                    else
+                    {
+                        /* The first element in the timer queue shouldn't be processed yet.
+                         * Arm the timer for when it should be processed and leave altogether. */
+                        _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
+
+                        break;
+                    }
                 }
+                /* If there are no timer events to process, terminate this thread. */
                 else
                 {
-                    /* The first element in the timer queue shouldn't be processed yet.
-                     * Arm the timer for when it should be processed and leave altogether. */
-                    _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
+                    IotLogDebug( "No further timer events to process. Exiting timer thread." );
 
                     break;
                 }
+
+                IotLogDebug( "Scheduling job from timer event." );
+
+                /* Queue the job associated with the received timer event. */
+                ( void ) _scheduleInternal( pTaskPool, pTimerEvent->pJob, 0 );
+
+                /* Free the timer event. */
+                IotTaskPool_FreeTimerEvent( pTimerEvent );
+            }
+        #endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
+    }
+    TASKPOOL_EXIT_CRITICAL();
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+    static void _initWorkQueues( _taskPool_t * const pTaskPool )
+    {
+        uint32_t queue, slot;
+
+        /* Work queue slots must be addressable with a mask. */
+        IotTaskPool_Assert( ( IOT_TASKPOOL_WORK_QUEUE_LENGTH & ( IOT_TASKPOOL_WORK_QUEUE_LENGTH - 1UL ) ) == 0UL );
+
+        for( queue = 0; queue < IOT_TASKPOOL_WORK_QUEUES; queue++ )
+        {
+            _taskPoolWorkQueue_t * pQueue = &pTaskPool->workQueues[ queue ];
+
+            pQueue->enqueuePosition = 0;
+            pQueue->dequeuePosition = 0;
+
+            /* Each slot is ready to be written at its own position. */
+            for( slot = 0; slot < IOT_TASKPOOL_WORK_QUEUE_LENGTH; slot++ )
+            {
+                pQueue->slots[ slot ].sequence = slot;
+                pQueue->slots[ slot ].pJob = NULL;
+            }
+        }
+
+        pTaskPool->nextWorkQueue = 0;
+        pTaskPool->nextWorkerQueue = 0;
+        pTaskPool->dispatchQueueLength = 0;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static _taskPoolWorkSlot_t * _workQueueClaim( _taskPoolWorkQueue_t * const pQueue,
+                                                  uint32_t * const pPosition )
+    {
+        _taskPoolWorkSlot_t * pClaimed = NULL;
+        uint32_t position = pQueue->enqueuePosition;
+
+        /* Claim the slot at the enqueue position. A slot is free when its sequence
+         * matches the position, and still holds an unread job when it lags behind. */
+        for( ; ; )
+        {
+            _taskPoolWorkSlot_t * pSlot = &pQueue->slots[ position & ( IOT_TASKPOOL_WORK_QUEUE_LENGTH - 1UL ) ];
+            int32_t lag = ( int32_t ) ( pSlot->sequence - position );
+
+            if( lag == 0 )
+            {
+                if( Atomic_CompareAndSwap_u32( &pQueue->enqueuePosition, position + 1UL, position ) == 1U )
+                {
+                    pClaimed = pSlot;
+                    *pPosition = position;
+
+                    break;
+                }
+            }
+            else if( lag < 0 )
+            {
+                /* The work queue is full. */
+                break;
             }
-            /* If there are no timer events to process, terminate this thread. */
             else
             {
-                IotLogDebug( "No further timer events to process. Exiting timer thread." );
+                /* Nothing to do. */
+            }
+
+            /* Another producer claimed the slot, retry at the new position. */
+            position = pQueue->enqueuePosition;
+        }
+
+        return pClaimed;
+    }
+
+/*-----------------------------------------------------------*/
 
+    static void _workQueuePublish( _taskPoolWorkSlot_t * const pSlot,
+                                   uint32_t position )
+    {
+        /* Make the slot readable by consumers. */
+        ( void ) Atomic_CompareAndSwap_u32( &pSlot->sequence, position + 1UL, position );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static _taskPoolJob_t * _workQueuePop( _taskPoolWorkQueue_t * const pQueue )
+    {
+        _taskPoolJob_t * pJob = NULL;
+        uint32_t position = pQueue->dequeuePosition;
+
+        /* Canceled jobs leave empty slots behind, keep going until a job or the end of the queue. */
+        while( pJob == NULL )
+        {
+            _taskPoolWorkSlot_t * pSlot = &pQueue->slots[ position & ( IOT_TASKPOOL_WORK_QUEUE_LENGTH - 1UL ) ];
+            int32_t lag = ( int32_t ) ( pSlot->sequence - ( position + 1UL ) );
+
+            if( lag == 0 )
+            {
+                if( Atomic_CompareAndSwap_u32( &pQueue->dequeuePosition, position + 1UL, position ) == 1U )
+                {
+                    /* Taking the job out of the slot is what decides between this worker and a
+                     * concurrent cancellation. */
+                    pJob = ( _taskPoolJob_t * ) Atomic_SwapPointers_p32( ( void * volatile * ) &pSlot->pJob, NULL );
+
+                    /* Hand the slot back to producers for the next lap. */
+                    ( void ) Atomic_CompareAndSwap_u32( &pSlot->sequence,
+                                                        position + IOT_TASKPOOL_WORK_QUEUE_LENGTH,
+                                                        position + 1UL );
+
+                    if( pJob != NULL )
+                    {
+                        /* Update status to 'executing'. */
+                        pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
+                    }
+                }
+            }
+            else if( lag < 0 )
+            {
+                /* The work queue is empty. */
                 break;
             }
+            else
+            {
+                /* Nothing to do. */
+            }
+
+            position = pQueue->dequeuePosition;
+        }
 
-            IotLogDebug( "Scheduling job from timer event." );
+        return pJob;
+    }
 
-            /* Queue the job associated with the received timer event. */
-            ( void ) _scheduleInternal( pTaskPool, pTimerEvent->pJob, 0 );
+/*-----------------------------------------------------------*/
 
-            /* Free the timer event. */
-            IotTaskPool_FreeTimerEvent( pTimerEvent );
+    static bool _workQueueRemove( _taskPool_t * const pTaskPool,
+                                  _taskPoolJob_t * const pJob )
+    {
+        bool removed = false;
+        uint32_t queue, slot;
+
+        for( queue = 0; ( removed == false ) && ( queue < IOT_TASKPOOL_WORK_QUEUES ); queue++ )
+        {
+            _taskPoolWorkQueue_t * pQueue = &pTaskPool->workQueues[ queue ];
+
+            for( slot = 0; slot < IOT_TASKPOOL_WORK_QUEUE_LENGTH; slot++ )
+            {
+                /* Leave an empty slot behind, workers skip it. */
+                if( Atomic_CompareAndSwapPointers_p32( ( void * volatile * ) &pQueue->slots[ slot ].pJob,
+                                                       NULL,
+                                                       ( void * ) pJob ) == 1U )
+                {
+                    removed = true;
+
+                    break;
+                }
+            }
         }
+
+        return removed;
     }
-    TASKPOOL_EXIT_CRITICAL();
-}
+
+/*-----------------------------------------------------------*/
+
+    static _taskPoolWorkSlot_t * _claimWork( _taskPool_t * const pTaskPool,
+                                             uint32_t * const pPosition )
+    {
+        _taskPoolWorkSlot_t * pSlot = NULL;
+        uint32_t count;
+        uint32_t first = Atomic_Increment_u32( &pTaskPool->nextWorkQueue );
+
+        for( count = 0; ( pSlot == NULL ) && ( count < IOT_TASKPOOL_WORK_QUEUES ); count++ )
+        {
+            pSlot = _workQueueClaim( &pTaskPool->workQueues[ ( first + count ) % IOT_TASKPOOL_WORK_QUEUES ], pPosition );
+        }
+
+        return pSlot;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool _enqueueWork( _taskPool_t * const pTaskPool,
+                              _taskPoolJob_t * const pJob )
+    {
+        uint32_t position = 0;
+        _taskPoolWorkSlot_t * pSlot = _claimWork( pTaskPool, &position );
+
+        if( pSlot != NULL )
+        {
+            pSlot->pJob = pJob;
+
+            _workQueuePublish( pSlot, position );
+        }
+
+        return( pSlot != NULL );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static _taskPoolJob_t * _dequeueWork( _taskPool_t * const pTaskPool,
+                                          uint32_t homeQueue )
+    {
+        _taskPoolJob_t * pJob = NULL;
+        uint32_t count;
+
+        /* High priority jobs, and jobs that did not fit in the work queues, wait in the
+         * dispatch queue. Only take the lock when there is any. */
+        if( pTaskPool->dispatchQueueLength > 0UL )
+        {
+            TASKPOOL_ENTER_CRITICAL();
+            {
+                IotLink_t * pItem = IotDeQueue_DequeueHead( &pTaskPool->dispatchQueue );
+
+                if( pItem != NULL )
+                {
+                    pTaskPool->dispatchQueueLength--;
+
+                    pJob = IotLink_Container( _taskPoolJob_t, pItem, link );
+
+                    /* Update status to 'executing'. */
+                    pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
+                }
+            }
+            TASKPOOL_EXIT_CRITICAL();
+        }
+
+        /* Then the home work queue first, and steal from the other work queues when it is empty. */
+        for( count = 0; ( pJob == NULL ) && ( count < IOT_TASKPOOL_WORK_QUEUES ); count++ )
+        {
+            pJob = _workQueuePop( &pTaskPool->workQueues[ ( homeQueue + count ) % IOT_TASKPOOL_WORK_QUEUES ] );
+        }
+
+        return pJob;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool _tryScheduleLockFree( _taskPool_t * const pTaskPool,
+                                      _taskPoolJob_t * const pJob )
+    {
+        bool scheduled = false;
+        uint32_t currentStatus = ( uint32_t ) pJob->status;
+
+        /* Only jobs that are not queued anywhere can skip the lock: scheduled and deferred jobs
+         * must be canceled first, and cached jobs must be extracted from the cache. Growing the
+         * task pool when all workers are busy also needs the lock. */
+        if( ( _IsShutdownStarted( pTaskPool ) == false ) &&
+            ( ( currentStatus == ( uint32_t ) IOT_TASKPOOL_STATUS_READY ) ||
+              ( currentStatus == ( uint32_t ) IOT_TASKPOOL_STATUS_CANCELED ) ) &&
+            ( IotLink_IsLinked( &pJob->link ) == false ) &&
+            ( ( pTaskPool->activeJobs < pTaskPool->activeThreads ) ||
+              ( pTaskPool->activeThreads >= pTaskPool->maxThreads ) ) )
+        {
+            uint32_t position = 0;
+            _taskPoolWorkSlot_t * pSlot = _claimWork( pTaskPool, &position );
+
+            /* When all work queues are full, let the job go to the dispatch queue. */
+            if( pSlot != NULL )
+            {
+                /* Store the job in its slot before it is marked 'scheduled': a cancellation
+                 * that sees the status must find the job in a work queue. Workers do not read
+                 * the slot until it is published. */
+                ( void ) Atomic_SwapPointers_p32( ( void * volatile * ) &pSlot->pJob, pJob );
+
+                TASKPOOL_INCREMENT_ACTIVE_JOBS();
+
+                /* Update the job status to 'scheduled', unless another thread got to the job first. */
+                if( Atomic_CompareAndSwap_u32( ( uint32_t volatile * ) &pJob->status,
+                                               ( uint32_t ) IOT_TASKPOOL_STATUS_SCHEDULED,
+                                               currentStatus ) == 1U )
+                {
+                    scheduled = true;
+                }
+                else
+                {
+                    TASKPOOL_DECREMENT_ACTIVE_JOBS();
+
+                    /* Leave an empty slot behind, workers skip it. */
+                    ( void ) Atomic_CompareAndSwapPointers_p32( ( void * volatile * ) &pSlot->pJob,
+                                                                NULL,
+                                                                ( void * ) pJob );
+                }
+
+                _workQueuePublish( pSlot, position );
+
+                if( scheduled == true )
+                {
+                    /* Signal a worker to pick up the job. */
+                    IotSemaphore_Post( &pTaskPool->dispatchSignal );
+                }
+            }
+        }
+
+        return scheduled;
+    }
+
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
+/* ---------------------------------------------------------------------------------------------- */
+
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+
+    static void _timerWheelInit( _taskPoolTimerWheel_t * const pWheel )
+    {
+        uint32_t level, slot;
+
+        for( level = 0; level < IOT_TASKPOOL_TIMER_WHEEL_LEVELS; level++ )
+        {
+            for( slot = 0; slot < TASKPOOL_TIMER_WHEEL_SLOTS; slot++ )
+            {
+                IotListDouble_Create( &pWheel->slots[ level ][ slot ] );
+            }
+
+            pWheel->occupied[ level ] = 0;
+        }
+
+        pWheel->currentTick = 0;
+        pWheel->armedTick = UINT64_MAX;
+        pWheel->jobCount = 0;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _timerWheelPlace( _taskPoolTimerWheel_t * const pWheel,
+                                  _taskPoolJob_t * const pJob )
+    {
+        uint32_t level = 0;
+        uint32_t slot;
+        uint64_t lastTick;
+
+        /* Round up, so that jobs never expire early. */
+        uint64_t expirationTick = ( pJob->expirationTime + IOT_TASKPOOL_TIMER_WHEEL_TICK_MS - 1ULL ) / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+
+        /* Jobs that expired already go in the next tick to process. */
+        if( expirationTick < pWheel->currentTick )
+        {
+            expirationTick = pWheel->currentTick;
+        }
+
+        /* Jobs beyond the last tick covered by the wheel wait there, and are placed
+         * again when that tick is processed. */
+        lastTick = pWheel->currentTick |
+                   ( ( 1ULL << ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * IOT_TASKPOOL_TIMER_WHEEL_LEVELS ) ) - 1ULL );
+
+        if( expirationTick > lastTick )
+        {
+            expirationTick = lastTick;
+        }
+
+        /* Use the lowest level whose current run of slots contains the expiration tick. */
+        while( ( expirationTick >> ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * ( level + 1UL ) ) ) !=
+               ( pWheel->currentTick >> ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * ( level + 1UL ) ) ) )
+        {
+            level++;
+        }
+
+        IotTaskPool_Assert( level < IOT_TASKPOOL_TIMER_WHEEL_LEVELS );
+
+        slot = ( uint32_t ) ( expirationTick >> ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * level ) ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1UL );
+
+        IotListDouble_InsertTail( &pWheel->slots[ level ][ slot ], &pJob->link );
+
+        pWheel->occupied[ level ] |= ( 1UL << slot );
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _timerWheelInsert( _taskPool_t * const pTaskPool,
+                                   _taskPoolJob_t * const pJob )
+    {
+        _taskPoolTimerWheel_t * pWheel = &pTaskPool->timerWheel;
+
+        /* An empty wheel may have been idle for a long time, restart it from now
+         * rather than processing all the ticks it missed. */
+        if( pWheel->jobCount == 0UL )
+        {
+            pWheel->currentTick = IotClock_GetTimeMs() / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+        }
+
+        _timerWheelPlace( pWheel, pJob );
+
+        pWheel->jobCount++;
+
+        /* Only re-arm the timer if this job expires before the tick it is armed for. */
+        if( _timerWheelNextTick( pWheel ) < pWheel->armedTick )
+        {
+            _timerWheelArm( pTaskPool );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _timerWheelRemove( _taskPoolTimerWheel_t * const pWheel,
+                                   _taskPoolJob_t * const pJob )
+    {
+        IotLink_t * pPrevious = pJob->link.pPrevious;
+
+        IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
+
+        IotListDouble_Remove( &pJob->link );
+
+        pWheel->jobCount--;
+
+        /* If the slot is now empty, the previous link is the slot list itself. */
+        if( pPrevious->pNext == pPrevious )
+        {
+            uint32_t index = ( uint32_t ) ( pPrevious - &pWheel->slots[ 0 ][ 0 ] );
+
+            pWheel->occupied[ index / TASKPOOL_TIMER_WHEEL_SLOTS ] &= ~( 1UL << ( index % TASKPOOL_TIMER_WHEEL_SLOTS ) );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint64_t _timerWheelNextTick( const _taskPoolTimerWheel_t * const pWheel )
+    {
+        uint64_t nextTick = UINT64_MAX;
+        uint32_t level;
+
+        for( level = 0; ( pWheel->jobCount > 0UL ) && ( level < IOT_TASKPOOL_TIMER_WHEEL_LEVELS ); level++ )
+        {
+            uint32_t shift = TASKPOOL_TIMER_WHEEL_SLOT_BITS * level;
+            uint32_t slot = ( uint32_t ) ( pWheel->currentTick >> shift ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1UL );
+            uint32_t pending;
+
+            /* The slot at the current position of a higher level was processed already,
+             * unless the current tick is exactly where it starts. */
+            if( ( level > 0UL ) && ( ( pWheel->currentTick & ( ( 1ULL << shift ) - 1ULL ) ) != 0ULL ) )
+            {
+                slot++;
+            }
+
+            if( slot < TASKPOOL_TIMER_WHEEL_SLOTS )
+            {
+                pending = pWheel->occupied[ level ] & ~( ( 1UL << slot ) - 1UL );
+
+                if( pending != 0UL )
+                {
+                    uint64_t tick;
+
+                    /* Find the first pending slot. */
+                    while( ( pending & ( 1UL << slot ) ) == 0UL )
+                    {
+                        slot++;
+                    }
+
+                    tick = ( ( pWheel->currentTick >> ( shift + TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) << ( shift + TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) |
+                           ( ( uint64_t ) slot << shift );
+
+                    if( tick < nextTick )
+                    {
+                        nextTick = tick;
+                    }
+                }
+            }
+        }
+
+        return nextTick;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _timerWheelExpire( _taskPool_t * const pTaskPool,
+                                   uint64_t tick,
+                                   uint64_t now )
+    {
+        _taskPoolTimerWheel_t * pWheel = &pTaskPool->timerWheel;
+        IotListDouble_t expired;
+        IotLink_t * pLink;
+        uint32_t level, slot;
+
+        pWheel->currentTick = tick;
+
+        /* Place again the jobs of every higher level slot that starts at this tick, top
+         * level first, so jobs can move down more than one level in this tick. */
+        for( level = IOT_TASKPOOL_TIMER_WHEEL_LEVELS - 1UL; level > 0UL; level-- )
+        {
+            if( ( tick & ( ( 1ULL << ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * level ) ) - 1ULL ) ) == 0ULL )
+            {
+                slot = ( uint32_t ) ( tick >> ( TASKPOOL_TIMER_WHEEL_SLOT_BITS * level ) ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1UL );
+
+                pWheel->occupied[ level ] &= ~( 1UL << slot );
+
+                for( ; ; )
+                {
+                    pLink = IotListDouble_RemoveHead( &pWheel->slots[ level ][ slot ] );
+
+                    if( pLink == NULL )
+                    {
+                        break;
+                    }
+
+                    _timerWheelPlace( pWheel, IotLink_Container( _taskPoolJob_t, pLink, link ) );
+                }
+            }
+        }
+
+        /* Take all jobs of the level 0 slot at once, then move the wheel past this tick
+         * before scheduling them, so that jobs placed again land in a later tick. */
+        slot = ( uint32_t ) tick & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1UL );
+
+        IotListDouble_Create( &expired );
+
+        if( IotListDouble_IsEmpty( &pWheel->slots[ 0 ][ slot ] ) == false )
+        {
+            expired.pNext = pWheel->slots[ 0 ][ slot ].pNext;
+            expired.pPrevious = pWheel->slots[ 0 ][ slot ].pPrevious;
+            expired.pNext->pPrevious = &expired;
+            expired.pPrevious->pNext = &expired;
+
+            IotListDouble_Create( &pWheel->slots[ 0 ][ slot ] );
+        }
+
+        pWheel->occupied[ 0 ] &= ~( 1UL << slot );
+        pWheel->currentTick = tick + 1ULL;
+
+        for( ; ; )
+        {
+            _taskPoolJob_t * pJob;
+
+            pLink = IotListDouble_RemoveHead( &expired );
+
+            if( pLink == NULL )
+            {
+                break;
+            }
+
+            pJob = IotLink_Container( _taskPoolJob_t, pLink, link );
+
+            /* Jobs beyond the range of the wheel reach this slot before they expire. */
+            if( pJob->expirationTime <= now )
+            {
+                pWheel->jobCount--;
+
+                IotLogDebug( "Scheduling job from timer wheel." );
+
+                ( void ) _scheduleInternal( pTaskPool, pJob, 0 );
+            }
+            else
+            {
+                _timerWheelPlace( pWheel, pJob );
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _timerWheelArm( _taskPool_t * const pTaskPool )
+    {
+        uint64_t now, expirationTime;
+        uint64_t delta = TASKPOOL_JOB_RESCHEDULE_DELAY_MS;
+
+        pTaskPool->timerWheel.armedTick = _timerWheelNextTick( &pTaskPool->timerWheel );
+
+        if( pTaskPool->timerWheel.armedTick != UINT64_MAX )
+        {
+            now = IotClock_GetTimeMs();
+            expirationTime = pTaskPool->timerWheel.armedTick * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+
+            if( expirationTime > ( now + TASKPOOL_JOB_RESCHEDULE_DELAY_MS ) )
+            {
+                delta = expirationTime - now;
+            }
+
+            if( IotClock_TimerArm( &pTaskPool->timer, ( uint32_t ) delta, 0 ) == false )
+            {
+                IotLogWarn( "Failed to re-arm timer for task pool" );
+            }
+        }
+    }
+
+#endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
@@ -73,6 +73,29 @@ typedef struct JobBlockingUserContext
     IotSemaphore_t block;  /**< @brief A synch object to wait on. */
 } JobBlockingUserContext_t;
 
+/**
+ * @brief Context for a thread that schedules and cancels jobs concurrently with other threads.
+ */
+typedef struct JobProducerContext
+{
+    IotTaskPool_t taskPool;    /**< @brief The task pool to schedule jobs with. */
+    IotTaskPoolJob_t * pJobs;  /**< @brief The jobs this thread owns. */
+    uint32_t jobCount;         /**< @brief The number of jobs this thread owns. */
+    uint32_t canceled;         /**< @brief The number of jobs this thread canceled successfully. */
+    uint32_t errors;           /**< @brief The number of unexpected task pool errors. */
+    IotSemaphore_t * pDone;    /**< @brief Signaled when this thread is done. */
+} JobProducerContext_t;
+
+/**
+ * @brief Context for a deferred job that records when it executed.
+ */
+typedef struct JobDeferredContext
+{
+    JobUserContext_t * pUserContext; /**< @brief The counter of executed jobs. */
+    uint64_t deadline;               /**< @brief The earliest time the job may execute. */
+    uint64_t executedAt;             /**< @brief The time the job executed. */
+} JobDeferredContext_t;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -124,6 +147,14 @@ TEST_GROUP_RUNNER( Common_Unit_Task_Pool )
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ReSchedule );
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ReScheduleDeferred );
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_CancelTasks );
+    RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ConcurrentProducers );
+    RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ScheduleDeferredNotEarly );
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_WorkStealingCancelRace );
+    #endif
+    #if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+        RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_TimerWheelWrapAndCancel );
+    #endif
 }
 
 /*-----------------------------------------------------------*/
@@ -349,6 +380,96 @@ static void BlankExecution( IotTaskPool_t pTaskPool,
     TEST_ASSERT( ( error == IOT_TASKPOOL_SUCCESS ) || ( error == IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS ) );
 }
 
+/**
+ * @brief A callback that records when it executed.
+ */
+static void ExecutionRecordTimeCb( IotTaskPool_t pTaskPool,
+                                   IotTaskPoolJob_t pJob,
+                                   void * pContext )
+{
+    JobDeferredContext_t * pDeferredContext = ( JobDeferredContext_t * ) pContext;
+
+    ( void ) pTaskPool;
+    ( void ) pJob;
+
+    pDeferredContext->executedAt = IotClock_GetTimeMs();
+
+    IotMutex_Lock( &pDeferredContext->pUserContext->lock );
+    pDeferredContext->pUserContext->counter++;
+    IotMutex_Unlock( &pDeferredContext->pUserContext->lock );
+}
+
+/**
+ * @brief A thread that schedules all its jobs, then tries and cancels every other one.
+ */
+static void ProducerThread( void * pArgument )
+{
+    uint32_t count;
+    JobProducerContext_t * pContext = ( JobProducerContext_t * ) pArgument;
+
+    for( count = 0; count < pContext->jobCount; ++count )
+    {
+        if( IotTaskPool_Schedule( pContext->taskPool, pContext->pJobs[ count ], 0 ) != IOT_TASKPOOL_SUCCESS )
+        {
+            pContext->errors++;
+        }
+    }
+
+    for( count = 0; count < pContext->jobCount; count += 2 )
+    {
+        switch( IotTaskPool_TryCancel( pContext->taskPool, pContext->pJobs[ count ], NULL ) )
+        {
+            case IOT_TASKPOOL_SUCCESS:
+                pContext->canceled++;
+                break;
+
+            case IOT_TASKPOOL_CANCEL_FAILED: /* OK, the job is executing. */
+                break;
+
+            default:
+                pContext->errors++;
+                break;
+        }
+    }
+
+    IotSemaphore_Post( pContext->pDone );
+}
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/**
+ * @brief A callback that counts how many times its job executed.
+ */
+    static void ExecutionCountCb( IotTaskPool_t pTaskPool,
+                                  IotTaskPoolJob_t pJob,
+                                  void * pContext )
+    {
+        ( void ) pTaskPool;
+        ( void ) pJob;
+
+        ( *( ( volatile uint32_t * ) pContext ) )++;
+    }
+
+/**
+ * @brief A thread that schedules all its jobs, as fast as it can.
+ */
+    static void SchedulerThread( void * pArgument )
+    {
+        uint32_t count;
+        JobProducerContext_t * pContext = ( JobProducerContext_t * ) pArgument;
+
+        for( count = 0; count < pContext->jobCount; ++count )
+        {
+            if( IotTaskPool_Schedule( pContext->taskPool, pContext->pJobs[ count ], 0 ) != IOT_TASKPOOL_SUCCESS )
+            {
+                pContext->errors++;
+            }
+        }
+
+        IotSemaphore_Post( pContext->pDone );
+    }
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
 /* ---------------------------------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------------------------------- */
 /* ---------------------------------------------------------------------------------------------- */
@@ -1853,3 +1974,416 @@ TEST( Common_Unit_Task_Pool, ScheduleTasks_CancelTasks )
 }
 
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief Number of threads scheduling jobs concurrently.
+ */
+#define TEST_TASKPOOL_PRODUCERS    ( 4 )
+
+/**
+ * @brief Test scheduling and canceling jobs from several threads at the same time.
+ */
+TEST( Common_Unit_Task_Pool, ScheduleTasks_ConcurrentProducers )
+{
+    uint32_t count, maxJobs, jobsPerProducer;
+    uint32_t canceled = 0;
+    IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+    const IotTaskPoolInfo_t tpInfo = { .minThreads = 2, .maxThreads = 3, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+    IotSemaphore_t done;
+    JobProducerContext_t producers[ TEST_TASKPOOL_PRODUCERS ];
+
+    JobUserContext_t userContext;
+
+    memset( &userContext, 0, sizeof( JobUserContext_t ) );
+    memset( producers, 0, sizeof( producers ) );
+
+    /* In static memory mode, only the recyclable job limit may be allocated. */
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        maxJobs = IOT_TASKPOOL_JOBS_RECYCLE_LIMIT;
+        IotTaskPoolJobStorage_t jobsStorage[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+        IotTaskPoolJob_t jobs[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+    #else
+        maxJobs = TEST_TASKPOOL_ITERATIONS;
+        IotTaskPoolJobStorage_t jobsStorage[ TEST_TASKPOOL_ITERATIONS ];
+        IotTaskPoolJob_t jobs[ TEST_TASKPOOL_ITERATIONS ];
+    #endif
+
+    jobsPerProducer = maxJobs / TEST_TASKPOOL_PRODUCERS;
+
+    /* Initialize user context. */
+    TEST_ASSERT( IotMutex_Create( &userContext.lock, false ) );
+    TEST_ASSERT( IotSemaphore_Create( &done, 0, TEST_TASKPOOL_PRODUCERS ) );
+
+    TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    if( TEST_PROTECT() )
+    {
+        for( count = 0; count < jobsPerProducer * TEST_TASKPOOL_PRODUCERS; ++count )
+        {
+            TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionWithoutDestroyCb, &userContext, &jobsStorage[ count ], &jobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+        }
+
+        /* Start all producers, each one owning a slice of the jobs. */
+        for( count = 0; count < TEST_TASKPOOL_PRODUCERS; ++count )
+        {
+            producers[ count ].taskPool = taskPool;
+            producers[ count ].pJobs = &jobs[ count * jobsPerProducer ];
+            producers[ count ].jobCount = jobsPerProducer;
+            producers[ count ].pDone = &done;
+
+            TEST_ASSERT( Iot_CreateDetachedThread( ProducerThread, &producers[ count ], IOT_THREAD_DEFAULT_PRIORITY, IOT_THREAD_DEFAULT_STACK_SIZE ) );
+        }
+
+        for( count = 0; count < TEST_TASKPOOL_PRODUCERS; ++count )
+        {
+            IotSemaphore_Wait( &done );
+        }
+
+        for( count = 0; count < TEST_TASKPOOL_PRODUCERS; ++count )
+        {
+            TEST_ASSERT( producers[ count ].errors == 0 );
+
+            canceled += producers[ count ].canceled;
+        }
+
+        /* Wait until all jobs that were not canceled are executed. */
+        while( true )
+        {
+            IotClock_SleepMs( 50 );
+
+            IotMutex_Lock( &userContext.lock );
+
+            if( userContext.counter == ( ( jobsPerProducer * TEST_TASKPOOL_PRODUCERS ) - canceled ) )
+            {
+                IotMutex_Unlock( &userContext.lock );
+
+                break;
+            }
+
+            IotMutex_Unlock( &userContext.lock );
+        }
+
+        /* Canceled jobs must never execute. */
+        IotClock_SleepMs( 2 * TEST_TASKPOOL_WORK_ITEM_DURATION_MAX );
+
+        TEST_ASSERT( userContext.counter == ( ( jobsPerProducer * TEST_TASKPOOL_PRODUCERS ) - canceled ) );
+    }
+
+    TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    /* Destroy user context. */
+    IotSemaphore_Destroy( &done );
+    IotMutex_Destroy( &userContext.lock );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Number of deferred jobs in the deferred timing test.
+ */
+#define TEST_TASKPOOL_DEFERRED_JOBS    ( 16 )
+
+/**
+ * @brief Test that deferred jobs, scheduled out of order and over a wide range of
+ * delays, never execute before their deadline.
+ */
+TEST( Common_Unit_Task_Pool, ScheduleTasks_ScheduleDeferredNotEarly )
+{
+    uint32_t count;
+    IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+    const IotTaskPoolInfo_t tpInfo = { .minThreads = 2, .maxThreads = 3, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+    IotTaskPoolJobStorage_t jobsStorage[ TEST_TASKPOOL_DEFERRED_JOBS ];
+    IotTaskPoolJob_t jobs[ TEST_TASKPOOL_DEFERRED_JOBS ];
+    JobDeferredContext_t deferredContexts[ TEST_TASKPOOL_DEFERRED_JOBS ];
+
+    JobUserContext_t userContext;
+
+    memset( &userContext, 0, sizeof( JobUserContext_t ) );
+    memset( deferredContexts, 0, sizeof( deferredContexts ) );
+
+    /* Initialize user context. */
+    TEST_ASSERT( IotMutex_Create( &userContext.lock, false ) );
+
+    TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    if( TEST_PROTECT() )
+    {
+        for( count = 0; count < TEST_TASKPOOL_DEFERRED_JOBS; ++count )
+        {
+            /* Alternate short and long delays, from a few milliseconds to over a second. */
+            uint32_t delayMs = ( ( count % 2 ) == 0 ) ? ( 1 + ( count * 3 ) ) : ( 100 * count );
+
+            deferredContexts[ count ].pUserContext = &userContext;
+            deferredContexts[ count ].deadline = IotClock_GetTimeMs() + delayMs;
+
+            TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionRecordTimeCb, &deferredContexts[ count ], &jobsStorage[ count ], &jobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( IotTaskPool_ScheduleDeferred( taskPool, jobs[ count ], delayMs ) == IOT_TASKPOOL_SUCCESS );
+        }
+
+        /* Wait until all callbacks are executed. */
+        while( true )
+        {
+            IotClock_SleepMs( 50 );
+
+            IotMutex_Lock( &userContext.lock );
+
+            if( userContext.counter == TEST_TASKPOOL_DEFERRED_JOBS )
+            {
+                IotMutex_Unlock( &userContext.lock );
+
+                break;
+            }
+
+            IotMutex_Unlock( &userContext.lock );
+        }
+
+        for( count = 0; count < TEST_TASKPOOL_DEFERRED_JOBS; ++count )
+        {
+            TEST_ASSERT( deferredContexts[ count ].executedAt >= deferredContexts[ count ].deadline );
+        }
+    }
+
+    TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    /* Destroy user context. */
+    IotMutex_Destroy( &userContext.lock );
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/**
+ * @brief Test canceling jobs the moment they are scheduled through the work queues.
+ *
+ * A job is marked 'scheduled' before a worker can take it out of its work queue, so
+ * a cancellation may run in between. A successful cancellation must keep the job from
+ * executing, and a failed one must mean the job executes exactly once.
+ */
+    TEST( Common_Unit_Task_Pool, ScheduleTasks_WorkStealingCancelRace )
+    {
+        uint32_t count, maxJobs;
+        uint32_t canceled = 0, executed = 0;
+        IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+        const IotTaskPoolInfo_t tpInfo = { .minThreads = 2, .maxThreads = 3, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+        IotSemaphore_t done;
+        JobProducerContext_t scheduler;
+        IotTaskPoolJobStatus_t status;
+
+        /* In static memory mode, only the recyclable job limit may be allocated. */
+        #if IOT_STATIC_MEMORY_ONLY == 1
+            maxJobs = IOT_TASKPOOL_JOBS_RECYCLE_LIMIT;
+            IotTaskPoolJobStorage_t jobsStorage[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+            IotTaskPoolJob_t jobs[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+            volatile uint32_t executions[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+            bool wasCanceled[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ];
+        #else
+            maxJobs = TEST_TASKPOOL_ITERATIONS;
+            IotTaskPoolJobStorage_t jobsStorage[ TEST_TASKPOOL_ITERATIONS ];
+            IotTaskPoolJob_t jobs[ TEST_TASKPOOL_ITERATIONS ];
+            volatile uint32_t executions[ TEST_TASKPOOL_ITERATIONS ];
+            bool wasCanceled[ TEST_TASKPOOL_ITERATIONS ];
+        #endif
+
+        memset( &scheduler, 0, sizeof( scheduler ) );
+        memset( ( void * ) executions, 0, sizeof( executions ) );
+        memset( wasCanceled, 0, sizeof( wasCanceled ) );
+
+        TEST_ASSERT( IotSemaphore_Create( &done, 0, 1 ) );
+
+        TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+        if( TEST_PROTECT() )
+        {
+            for( count = 0; count < maxJobs; ++count )
+            {
+                TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionCountCb, ( void * ) &executions[ count ], &jobsStorage[ count ], &jobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+            }
+
+            scheduler.taskPool = taskPool;
+            scheduler.pJobs = jobs;
+            scheduler.jobCount = maxJobs;
+            scheduler.pDone = &done;
+
+            TEST_ASSERT( Iot_CreateDetachedThread( SchedulerThread, &scheduler, IOT_THREAD_DEFAULT_PRIORITY, IOT_THREAD_DEFAULT_STACK_SIZE ) );
+
+            /* Cancel each job as soon as it leaves the 'ready' state. */
+            for( count = 0; count < maxJobs; ++count )
+            {
+                do
+                {
+                    TEST_ASSERT( IotTaskPool_GetStatus( taskPool, jobs[ count ], &status ) == IOT_TASKPOOL_SUCCESS );
+                } while( ( status == IOT_TASKPOOL_STATUS_READY ) && ( scheduler.errors == 0 ) );
+
+                switch( IotTaskPool_TryCancel( taskPool, jobs[ count ], &status ) )
+                {
+                    case IOT_TASKPOOL_SUCCESS:
+                        wasCanceled[ count ] = true;
+                        canceled++;
+                        break;
+
+                    case IOT_TASKPOOL_CANCEL_FAILED:
+                        TEST_ASSERT( status == IOT_TASKPOOL_STATUS_COMPLETED );
+                        break;
+
+                    default:
+                        TEST_FAIL();
+                        break;
+                }
+            }
+
+            IotSemaphore_Wait( &done );
+
+            TEST_ASSERT( scheduler.errors == 0 );
+
+            /* Wait until all jobs that were not canceled are executed. */
+            while( executed < ( maxJobs - canceled ) )
+            {
+                IotClock_SleepMs( 50 );
+
+                for( executed = 0, count = 0; count < maxJobs; ++count )
+                {
+                    executed += executions[ count ];
+                }
+            }
+
+            /* Canceled jobs must never execute, the others exactly once. */
+            IotClock_SleepMs( 2 * TEST_TASKPOOL_WORK_ITEM_DURATION_MAX );
+
+            for( count = 0; count < maxJobs; ++count )
+            {
+                TEST_ASSERT_EQUAL_UINT32( ( wasCanceled[ count ] == true ) ? 0U : 1U, executions[ count ] );
+            }
+        }
+
+        TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+        IotSemaphore_Destroy( &done );
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
+#if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1
+
+/**
+ * @brief Number of deferred jobs in the timer wheel test.
+ */
+    #define TEST_TASKPOOL_WHEEL_JOBS    ( 8 )
+
+/**
+ * @brief Test deferred jobs that cross the runs of the timer wheel levels, and
+ * cancel some of them before and after they move down a level.
+ *
+ * Even jobs execute, odd jobs are canceled.
+ */
+    TEST( Common_Unit_Task_Pool, ScheduleTasks_TimerWheelWrapAndCancel )
+    {
+        uint32_t count;
+        uint32_t canceled = 0;
+        IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+        const IotTaskPoolInfo_t tpInfo = { .minThreads = 2, .maxThreads = 3, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+        IotTaskPoolJobStorage_t jobsStorage[ TEST_TASKPOOL_WHEEL_JOBS ];
+        IotTaskPoolJob_t jobs[ TEST_TASKPOOL_WHEEL_JOBS ];
+        JobDeferredContext_t deferredContexts[ TEST_TASKPOOL_WHEEL_JOBS ];
+        IotTaskPoolJobStatus_t status;
+
+        /* Delays in wheel ticks: within level 0, across its run into level 1, across
+         * the run of level 1 into level 2. */
+        const uint32_t delayTicks[ TEST_TASKPOOL_WHEEL_JOBS ] =
+        {
+            1,
+            TASKPOOL_TIMER_WHEEL_SLOTS - 1UL,
+            TASKPOOL_TIMER_WHEEL_SLOTS + 1UL,
+            ( 2UL * TASKPOOL_TIMER_WHEEL_SLOTS ) + 12UL,
+            ( TASKPOOL_TIMER_WHEEL_SLOTS * TASKPOOL_TIMER_WHEEL_SLOTS ) - 1UL,
+            ( TASKPOOL_TIMER_WHEEL_SLOTS * TASKPOOL_TIMER_WHEEL_SLOTS ) + 7UL,
+            ( TASKPOOL_TIMER_WHEEL_SLOTS * TASKPOOL_TIMER_WHEEL_SLOTS ) + 9UL,
+            TASKPOOL_TIMER_WHEEL_SLOTS / 2UL
+        };
+
+        JobUserContext_t userContext;
+
+        memset( &userContext, 0, sizeof( JobUserContext_t ) );
+        memset( deferredContexts, 0, sizeof( deferredContexts ) );
+
+        /* Initialize user context. */
+        TEST_ASSERT( IotMutex_Create( &userContext.lock, false ) );
+
+        TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+        if( TEST_PROTECT() )
+        {
+            for( count = 0; count < TEST_TASKPOOL_WHEEL_JOBS; ++count )
+            {
+                uint32_t delayMs = delayTicks[ count ] * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+
+                deferredContexts[ count ].pUserContext = &userContext;
+                deferredContexts[ count ].deadline = IotClock_GetTimeMs() + delayMs;
+
+                TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionRecordTimeCb, &deferredContexts[ count ], &jobsStorage[ count ], &jobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+                TEST_ASSERT( IotTaskPool_ScheduleDeferred( taskPool, jobs[ count ], delayMs ) == IOT_TASKPOOL_SUCCESS );
+            }
+
+            /* Cancel two jobs while they are in the level they were placed in. */
+            TEST_ASSERT( IotTaskPool_TryCancel( taskPool, jobs[ 1 ], &status ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( status == IOT_TASKPOOL_STATUS_DEFERRED );
+            TEST_ASSERT( IotTaskPool_TryCancel( taskPool, jobs[ 7 ], &status ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( status == IOT_TASKPOOL_STATUS_DEFERRED );
+
+            /* Cancel one job after it moved down from level 1 to level 0, and one
+             * that is still in level 2. */
+            IotClock_SleepMs( 2UL * TASKPOOL_TIMER_WHEEL_SLOTS * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS );
+
+            TEST_ASSERT( IotTaskPool_TryCancel( taskPool, jobs[ 3 ], &status ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( status == IOT_TASKPOOL_STATUS_DEFERRED );
+            TEST_ASSERT( IotTaskPool_TryCancel( taskPool, jobs[ 5 ], &status ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( status == IOT_TASKPOOL_STATUS_DEFERRED );
+
+            canceled = 4;
+
+            /* Wait until all jobs that were not canceled are executed. */
+            while( true )
+            {
+                IotClock_SleepMs( 50 );
+
+                IotMutex_Lock( &userContext.lock );
+
+                if( userContext.counter == ( TEST_TASKPOOL_WHEEL_JOBS - canceled ) )
+                {
+                    IotMutex_Unlock( &userContext.lock );
+
+                    break;
+                }
+
+                IotMutex_Unlock( &userContext.lock );
+            }
+
+            /* The last job expires after all canceled ones, so they had their chance to execute. */
+            IotClock_SleepMs( 2UL * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS );
+
+            TEST_ASSERT( userContext.counter == ( TEST_TASKPOOL_WHEEL_JOBS - canceled ) );
+
+            for( count = 0; count < TEST_TASKPOOL_WHEEL_JOBS; ++count )
+            {
+                if( ( count % 2 ) == 0 )
+                {
+                    TEST_ASSERT( deferredContexts[ count ].executedAt >= deferredContexts[ count ].deadline );
+                }
+                else
+                {
+                    TEST_ASSERT( deferredContexts[ count ].executedAt == 0 );
+                }
+            }
+        }
+
+        TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+        /* Destroy user context. */
+        IotMutex_Destroy( &userContext.lock );
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if IOT_TASKPOOL_ENABLE_TIMER_WHEEL == 1 */
@@ -0,0 +1,548 @@
+/*
+ * FreeRTOS Common V1.2.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_static_memory_utest.c
+ * @brief Unit tests of the static memory slabs, the message buffer size classes
+ * and the library allocators built on them.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "unity.h"
+
+#include "iot_static_memory_utest_config.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "mock_iot_threads.h"
+
+/* Static memory include. */
+#include "private/iot_static_memory.h"
+
+/* Library internal includes, for the allocators and the size of their objects. */
+#include "private/iot_mqtt_internal.h"
+#include "private/aws_iot_shadow_internal.h"
+#include "private/iot_taskpool_internal.h"
+#include "iot_serializer.h"
+#include "cbor.h"
+
+/* The number of elements of the slab under test; more than one bitmap word. */
+#define TEST_SLAB_ELEMENTS        ( 33 )
+
+/* The size of an element of the slab under test. */
+#define TEST_SLAB_ELEMENT_SIZE    ( 16 )
+
+/* The largest number of elements of a library allocator under test. */
+#define MAX_ALLOCATOR_ELEMENTS    ( 2 )
+
+/* The message buffer size classes, from the smallest to the largest. */
+#define MESSAGE_BUFFER_CLASSES    ( 3 )
+#define SMALL_CLASS               ( 0 )
+#define MEDIUM_CLASS              ( 1 )
+#define LARGE_CLASS               ( 2 )
+
+/* The CBOR value allocated by the serializer, which is private to
+ * iot_serializer_static_memory.c. */
+typedef struct _cborValueWrapper
+{
+    CborValue cborValue;
+    bool isOutermost;
+} _cborValueWrapper_t;
+
+/* The slab under test. */
+static uint32_t _pInUseTestElements[ IOT_STATIC_MEMORY_SLAB_WORDS( TEST_SLAB_ELEMENTS ) ];
+static uint8_t _pTestElements[ TEST_SLAB_ELEMENTS ][ TEST_SLAB_ELEMENT_SIZE ];
+static IotStaticMemorySlab_t _testSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pTestElements,
+                                                                             _pInUseTestElements,
+                                                                             TEST_SLAB_ELEMENT_SIZE,
+                                                                             TEST_SLAB_ELEMENTS );
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    IotStaticMemorySlab_t emptySlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pTestElements,
+                                                                          _pInUseTestElements,
+                                                                          TEST_SLAB_ELEMENT_SIZE,
+                                                                          TEST_SLAB_ELEMENTS );
+
+    ( void ) memset( _pInUseTestElements, 0x00, sizeof( _pInUseTestElements ) );
+    ( void ) memset( _pTestElements, 0xa5, sizeof( _pTestElements ) );
+    _testSlab = emptySlab;
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/* The tests are single-threaded, nothing to protect the atomics from. */
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+/**
+ * @brief Check that a block of memory is zeroed.
+ */
+static void prvAssertZeroed( const void * pBuffer,
+                             size_t size )
+{
+    size_t i = 0;
+
+    for( i = 0; i < size; i++ )
+    {
+        TEST_ASSERT_EQUAL_HEX8( 0, ( ( const uint8_t * ) pBuffer )[ i ] );
+    }
+}
+
+/**
+ * @brief Check an allocator that serves objects of exactly one size.
+ *
+ * All objects of the allocator must be free when this is called, and are free
+ * again when it returns.
+ */
+static void prvTestFixedSizeAllocator( void * ( *pMalloc )( size_t ),
+                                       void ( * pFree )( void * ),
+                                       size_t size,
+                                       size_t count )
+{
+    void * pObjects[ MAX_ALLOCATOR_ELEMENTS ] = { NULL };
+    void * pObject = NULL;
+    size_t i = 0;
+
+    TEST_ASSERT_TRUE( count <= MAX_ALLOCATOR_ELEMENTS );
+
+    /* Other sizes are for other allocators. */
+    TEST_ASSERT_NULL( pMalloc( size - 1U ) );
+    TEST_ASSERT_NULL( pMalloc( size + 1U ) );
+
+    for( i = 0; i < count; i++ )
+    {
+        pObjects[ i ] = pMalloc( size );
+        TEST_ASSERT_NOT_NULL( pObjects[ i ] );
+        prvAssertZeroed( pObjects[ i ], size );
+        ( void ) memset( pObjects[ i ], 0xa5, size );
+    }
+
+    TEST_ASSERT_NULL( pMalloc( size ) );
+
+    /* A freed object is allocated again, cleared. */
+    pFree( pObjects[ 0 ] );
+    pObject = pMalloc( size );
+    TEST_ASSERT_EQUAL_PTR( pObjects[ 0 ], pObject );
+    prvAssertZeroed( pObject, size );
+
+    /* Pointers that the allocator did not return are ignored. */
+    pFree( &pObject );
+
+    for( i = 0; i < count; i++ )
+    {
+        pFree( pObjects[ i ] );
+    }
+}
+
+/**
+ * @brief Check an allocator that serves objects up to a maximum size.
+ *
+ * All objects of the allocator must be free when this is called, and are free
+ * again when it returns.
+ */
+static void prvTestMaximumSizeAllocator( void * ( *pMalloc )( size_t ),
+                                         void ( * pFree )( void * ),
+                                         size_t maximumSize,
+                                         size_t count )
+{
+    void * pObjects[ MAX_ALLOCATOR_ELEMENTS ] = { NULL };
+    size_t i = 0;
+
+    TEST_ASSERT_TRUE( count <= MAX_ALLOCATOR_ELEMENTS );
+
+    TEST_ASSERT_NULL( pMalloc( maximumSize + 1U ) );
+
+    for( i = 0; i < count; i++ )
+    {
+        pObjects[ i ] = pMalloc( ( i == 0U ) ? 1U : maximumSize );
+        TEST_ASSERT_NOT_NULL( pObjects[ i ] );
+        prvAssertZeroed( pObjects[ i ], maximumSize );
+    }
+
+    TEST_ASSERT_NULL( pMalloc( 1U ) );
+
+    for( i = 0; i < count; i++ )
+    {
+        pFree( pObjects[ i ] );
+    }
+
+    TEST_ASSERT_EQUAL_PTR( pObjects[ 0 ], pMalloc( maximumSize ) );
+    pFree( pObjects[ 0 ] );
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Every element of a slab is allocated once, then allocation fails and
+ * is counted as a failure.
+ */
+void test_SlabAllocate_Exhaustion( void )
+{
+    void * pElements[ TEST_SLAB_ELEMENTS ] = { NULL };
+    IotStaticMemoryStatistics_t statistics = { 0 };
+    size_t i = 0, j = 0;
+
+    for( i = 0; i < TEST_SLAB_ELEMENTS; i++ )
+    {
+        pElements[ i ] = IotStaticMemory_SlabAllocate( &_testSlab );
+
+        TEST_ASSERT_NOT_NULL( pElements[ i ] );
+        TEST_ASSERT_TRUE( ( uint8_t * ) pElements[ i ] >= &_pTestElements[ 0 ][ 0 ] );
+        TEST_ASSERT_TRUE( ( uint8_t * ) pElements[ i ] <= &_pTestElements[ TEST_SLAB_ELEMENTS - 1 ][ 0 ] );
+        prvAssertZeroed( pElements[ i ], TEST_SLAB_ELEMENT_SIZE );
+
+        for( j = 0; j < i; j++ )
+        {
+            TEST_ASSERT_NOT_EQUAL( pElements[ j ], pElements[ i ] );
+        }
+    }
+
+    TEST_ASSERT_NULL( IotStaticMemory_SlabAllocate( &_testSlab ) );
+    TEST_ASSERT_NULL( IotStaticMemory_SlabAllocate( &_testSlab ) );
+
+    IotStaticMemory_SlabStatistics( &_testSlab, &statistics );
+    TEST_ASSERT_EQUAL( TEST_SLAB_ELEMENT_SIZE, statistics.elementSize );
+    TEST_ASSERT_EQUAL( TEST_SLAB_ELEMENTS, statistics.elementCount );
+    TEST_ASSERT_EQUAL( TEST_SLAB_ELEMENTS, statistics.inUse );
+    TEST_ASSERT_EQUAL( TEST_SLAB_ELEMENTS, statistics.highWaterMark );
+    TEST_ASSERT_EQUAL( 2, statistics.failures );
+    TEST_ASSERT_EQUAL( 0, statistics.fallbacks );
+
+    /* The last element, in the second bitmap word, is allocated again once freed. */
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pElements[ TEST_SLAB_ELEMENTS - 1 ] ) );
+    TEST_ASSERT_EQUAL_PTR( pElements[ TEST_SLAB_ELEMENTS - 1 ], IotStaticMemory_SlabAllocate( &_testSlab ) );
+}
+
+/**
+ * @brief The high-water mark keeps the largest number of elements allocated at
+ * once.
+ */
+void test_SlabAllocate_HighWaterMark( void )
+{
+    void * pElements[ 3 ] = { NULL };
+    IotStaticMemoryStatistics_t statistics = { 0 };
+    size_t i = 0;
+
+    for( i = 0; i < 3U; i++ )
+    {
+        pElements[ i ] = IotStaticMemory_SlabAllocate( &_testSlab );
+        TEST_ASSERT_NOT_NULL( pElements[ i ] );
+    }
+
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pElements[ 0 ] ) );
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pElements[ 1 ] ) );
+
+    /* The lowest free element is allocated first. */
+    TEST_ASSERT_EQUAL_PTR( pElements[ 0 ], IotStaticMemory_SlabAllocate( &_testSlab ) );
+
+    IotStaticMemory_SlabStatistics( &_testSlab, &statistics );
+    TEST_ASSERT_EQUAL( 2, statistics.inUse );
+    TEST_ASSERT_EQUAL( 3, statistics.highWaterMark );
+    TEST_ASSERT_EQUAL( 0, statistics.failures );
+}
+
+/**
+ * @brief A freed element is cleared before it is allocated again.
+ */
+void test_SlabAllocate_Zeroed( void )
+{
+    void * pElement = IotStaticMemory_SlabAllocate( &_testSlab );
+
+    TEST_ASSERT_NOT_NULL( pElement );
+    prvAssertZeroed( pElement, TEST_SLAB_ELEMENT_SIZE );
+
+    ( void ) memset( pElement, 0x5a, TEST_SLAB_ELEMENT_SIZE );
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pElement ) );
+
+    TEST_ASSERT_EQUAL_PTR( pElement, IotStaticMemory_SlabAllocate( &_testSlab ) );
+    prvAssertZeroed( pElement, TEST_SLAB_ELEMENT_SIZE );
+}
+
+/**
+ * @brief Pointers that are not elements of the slab are not freed.
+ */
+void test_SlabFree_NotAnElement( void )
+{
+    uint8_t * pElement = IotStaticMemory_SlabAllocate( &_testSlab );
+    uint8_t other[ TEST_SLAB_ELEMENT_SIZE ] = { 0 };
+    IotStaticMemoryStatistics_t statistics = { 0 };
+
+    TEST_ASSERT_NOT_NULL( pElement );
+
+    TEST_ASSERT_FALSE( IotStaticMemory_SlabFree( &_testSlab, NULL ) );
+    TEST_ASSERT_FALSE( IotStaticMemory_SlabFree( &_testSlab, other ) );
+    TEST_ASSERT_FALSE( IotStaticMemory_SlabFree( &_testSlab, pElement + 1 ) );
+    TEST_ASSERT_FALSE( IotStaticMemory_SlabFree( &_testSlab, &_pTestElements[ TEST_SLAB_ELEMENTS - 1 ][ TEST_SLAB_ELEMENT_SIZE - 1 ] + 1 ) );
+
+    /* An element that is not allocated is ignored. */
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, &_pTestElements[ 1 ][ 0 ] ) );
+
+    IotStaticMemory_SlabStatistics( &_testSlab, &statistics );
+    TEST_ASSERT_EQUAL( 1, statistics.inUse );
+    TEST_ASSERT_EQUAL_HEX32( 0x1, _pInUseTestElements[ 0 ] );
+}
+
+/**
+ * @brief An element freed twice is returned to the slab once.
+ */
+void test_SlabFree_Twice( void )
+{
+    void * pFirst = IotStaticMemory_SlabAllocate( &_testSlab );
+    void * pSecond = IotStaticMemory_SlabAllocate( &_testSlab );
+    IotStaticMemoryStatistics_t statistics = { 0 };
+
+    TEST_ASSERT_NOT_NULL( pFirst );
+    TEST_ASSERT_NOT_NULL( pSecond );
+
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pFirst ) );
+    TEST_ASSERT_TRUE( IotStaticMemory_SlabFree( &_testSlab, pFirst ) );
+
+    IotStaticMemory_SlabStatistics( &_testSlab, &statistics );
+    TEST_ASSERT_EQUAL( 1, statistics.inUse );
+
+    /* The first element is allocated again, the second never was freed. */
+    TEST_ASSERT_EQUAL_PTR( pFirst, IotStaticMemory_SlabAllocate( &_testSlab ) );
+    IotStaticMemory_SlabStatistics( &_testSlab, &statistics );
+    TEST_ASSERT_EQUAL( 2, statistics.inUse );
+    TEST_ASSERT_EQUAL_HEX32( 0x3, _pInUseTestElements[ 0 ] );
+}
+
+/**
+ * @brief Message buffers are taken from the smallest size class that fits.
+ */
+void test_MessageBuffer_SizeClassRouting( void )
+{
+    const size_t pSizes[ MESSAGE_BUFFER_CLASSES ] =
+    {
+        IOT_MESSAGE_BUFFER_SMALL_SIZE,
+        IOT_MESSAGE_BUFFER_MEDIUM_SIZE,
+        IOT_MESSAGE_BUFFER_SIZE
+    };
+    void * pBuffer = NULL;
+    IotStaticMemoryStatistics_t statistics = { 0 };
+    size_t sizeClass = 0, otherClass = 0;
+
+    TEST_ASSERT_EQUAL( IOT_MESSAGE_BUFFER_SIZE, Iot_MessageBufferSize() );
+
+    for( sizeClass = 0; sizeClass < MESSAGE_BUFFER_CLASSES; sizeClass++ )
+    {
+        TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( sizeClass, &statistics ) );
+        TEST_ASSERT_EQUAL( pSizes[ sizeClass ], statistics.elementSize );
+
+        /* Both the smallest and the largest size that fit the class. */
+        pBuffer = Iot_MallocMessageBuffer( ( sizeClass == 0U ) ? 1U : pSizes[ sizeClass - 1U ] + 1U );
+        TEST_ASSERT_NOT_NULL( pBuffer );
+        Iot_FreeMessageBuffer( pBuffer );
+
+        pBuffer = Iot_MallocMessageBuffer( pSizes[ sizeClass ] );
+        TEST_ASSERT_NOT_NULL( pBuffer );
+        prvAssertZeroed( pBuffer, pSizes[ sizeClass ] );
+
+        for( otherClass = 0; otherClass < MESSAGE_BUFFER_CLASSES; otherClass++ )
+        {
+            TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( otherClass, &statistics ) );
+            TEST_ASSERT_EQUAL( ( otherClass == sizeClass ) ? 1 : 0, statistics.inUse );
+            TEST_ASSERT_EQUAL( 0, statistics.fallbacks );
+        }
+
+        Iot_FreeMessageBuffer( pBuffer );
+        TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( sizeClass, &statistics ) );
+        TEST_ASSERT_EQUAL( 0, statistics.inUse );
+    }
+
+    /* No class fits; nothing is counted. */
+    TEST_ASSERT_NULL( Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SIZE + 1 ) );
+
+    for( sizeClass = 0; sizeClass < MESSAGE_BUFFER_CLASSES; sizeClass++ )
+    {
+        TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( sizeClass, &statistics ) );
+        TEST_ASSERT_EQUAL( 0, statistics.failures );
+    }
+
+    TEST_ASSERT_FALSE( Iot_MessageBufferStatistics( MESSAGE_BUFFER_CLASSES, &statistics ) );
+}
+
+/**
+ * @brief A request served by a larger class is counted as a fallback of the
+ * class that fits it, and a request that no class can serve as its failure.
+ */
+void test_MessageBuffer_Fallback( void )
+{
+    void * pSmall[ IOT_MESSAGE_SMALL_BUFFERS ] = { NULL };
+    void * pMedium = NULL, * pLarge = NULL;
+    IotStaticMemoryStatistics_t small = { 0 }, medium = { 0 }, large = { 0 };
+    size_t i = 0;
+
+    for( i = 0; i < IOT_MESSAGE_SMALL_BUFFERS; i++ )
+    {
+        pSmall[ i ] = Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SMALL_SIZE );
+        TEST_ASSERT_NOT_NULL( pSmall[ i ] );
+    }
+
+    /* The small class is exhausted; the medium and then the large class serve
+     * small requests. */
+    pMedium = Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SMALL_SIZE );
+    pLarge = Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SMALL_SIZE );
+    TEST_ASSERT_NOT_NULL( pMedium );
+    TEST_ASSERT_NOT_NULL( pLarge );
+    prvAssertZeroed( pLarge, IOT_MESSAGE_BUFFER_SIZE );
+
+    TEST_ASSERT_NULL( Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SMALL_SIZE ) );
+    TEST_ASSERT_NULL( Iot_MallocMessageBuffer( IOT_MESSAGE_BUFFER_SIZE ) );
+
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( SMALL_CLASS, &small ) );
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( MEDIUM_CLASS, &medium ) );
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( LARGE_CLASS, &large ) );
+
+    TEST_ASSERT_EQUAL( IOT_MESSAGE_SMALL_BUFFERS, small.inUse );
+    TEST_ASSERT_EQUAL( 2, small.fallbacks );
+    TEST_ASSERT_EQUAL( 1, small.failures );
+    TEST_ASSERT_EQUAL( 1, medium.inUse );
+    TEST_ASSERT_EQUAL( 0, medium.fallbacks );
+    TEST_ASSERT_EQUAL( 0, medium.failures );
+    TEST_ASSERT_EQUAL( 1, large.inUse );
+    TEST_ASSERT_EQUAL( 0, large.fallbacks );
+    TEST_ASSERT_EQUAL( 1, large.failures );
+
+    /* Each buffer returns to its own class. */
+    Iot_FreeMessageBuffer( pLarge );
+    Iot_FreeMessageBuffer( pMedium );
+
+    for( i = 0; i < IOT_MESSAGE_SMALL_BUFFERS; i++ )
+    {
+        Iot_FreeMessageBuffer( pSmall[ i ] );
+    }
+
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( SMALL_CLASS, &small ) );
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( MEDIUM_CLASS, &medium ) );
+    TEST_ASSERT_TRUE( Iot_MessageBufferStatistics( LARGE_CLASS, &large ) );
+    TEST_ASSERT_EQUAL( 0, small.inUse );
+    TEST_ASSERT_EQUAL( 0, medium.inUse );
+    TEST_ASSERT_EQUAL( 0, large.inUse );
+    TEST_ASSERT_EQUAL( IOT_MESSAGE_SMALL_BUFFERS, small.highWaterMark );
+}
+
+/**
+ * @brief The MQTT allocators serve their objects from slabs.
+ */
+void test_MqttAllocators( void )
+{
+    prvTestFixedSizeAllocator( IotMqtt_MallocConnection,
+                               IotMqtt_FreeConnection,
+                               sizeof( _mqttConnection_t ),
+                               IOT_MQTT_CONNECTIONS );
+    prvTestFixedSizeAllocator( IotMqtt_MallocOperation,
+                               IotMqtt_FreeOperation,
+                               sizeof( _mqttOperation_t ),
+                               IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS );
+    prvTestMaximumSizeAllocator( IotMqtt_MallocSubscription,
+                                 IotMqtt_FreeSubscription,
+                                 sizeof( _mqttSubscription_t ) + AWS_IOT_MQTT_SERVER_MAX_TOPIC_LENGTH,
+                                 IOT_MQTT_SUBSCRIPTIONS );
+}
+
+/**
+ * @brief The Shadow allocators serve their objects from slabs.
+ */
+void test_ShadowAllocators( void )
+{
+    prvTestFixedSizeAllocator( AwsIotShadow_MallocOperation,
+                               AwsIotShadow_FreeOperation,
+                               sizeof( _shadowOperation_t ),
+                               AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS );
+    prvTestMaximumSizeAllocator( AwsIotShadow_MallocSubscription,
+                                 AwsIotShadow_FreeSubscription,
+                                 sizeof( _shadowSubscription_t ) + MAX_THING_NAME_LENGTH,
+                                 AWS_IOT_SHADOW_SUBSCRIPTIONS );
+}
+
+/**
+ * @brief The task pool allocators serve their objects from slabs.
+ */
+void test_TaskPoolAllocators( void )
+{
+    prvTestFixedSizeAllocator( IotTaskPool_MallocTaskPool,
+                               IotTaskPool_FreeTaskPool,
+                               sizeof( _taskPool_t ),
+                               IOT_TASKPOOLS );
+    prvTestFixedSizeAllocator( IotTaskPool_MallocJob,
+                               IotTaskPool_FreeJob,
+                               sizeof( _taskPoolJob_t ),
+                               IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
+    prvTestFixedSizeAllocator( IotTaskPool_MallocTimerEvent,
+                               IotTaskPool_FreeTimerEvent,
+                               sizeof( _taskPoolTimerEvent_t ),
+                               IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
+}
+
+/**
+ * @brief The serializer allocators serve their objects from slabs.
+ */
+void test_SerializerAllocators( void )
+{
+    prvTestFixedSizeAllocator( IotSerializer_MallocCborEncoder,
+                               IotSerializer_FreeCborEncoder,
+                               sizeof( CborEncoder ),
+                               IOT_SERIALIZER_CBOR_ENCODERS );
+    prvTestFixedSizeAllocator( IotSerializer_MallocCborParser,
+                               IotSerializer_FreeCborParser,
+                               sizeof( CborParser ),
+                               IOT_SERIALIZER_CBOR_PARSERS );
+    prvTestFixedSizeAllocator( IotSerializer_MallocCborValue,
+                               IotSerializer_FreeCborValue,
+                               sizeof( _cborValueWrapper_t ),
+                               IOT_SERIALIZER_CBOR_VALUES );
+    prvTestFixedSizeAllocator( IotSerializer_MallocDecoderObject,
+                               IotSerializer_FreeDecoderObject,
+                               sizeof( IotSerializerDecoderObject_t ),
+                               IOT_SERIALIZER_DECODER_OBJECTS );
+}
@@ -0,0 +1,59 @@
+/*
+ * FreeRTOS Common V1.2.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_static_memory_utest_config.h
+ * @brief Configuration of the static memory allocators under test, included
+ * ahead of the static memory sources and the test.
+ */
+
+#ifndef IOT_STATIC_MEMORY_UTEST_CONFIG_H_
+#define IOT_STATIC_MEMORY_UTEST_CONFIG_H_
+
+/* Build the static memory allocators. */
+#define IOT_STATIC_MEMORY_ONLY                       ( 1 )
+
+/* Message buffer size classes that are quick to exhaust. */
+#define IOT_MESSAGE_BUFFER_SMALL_SIZE                ( 64 )
+#define IOT_MESSAGE_SMALL_BUFFERS                    ( 2 )
+#define IOT_MESSAGE_BUFFER_MEDIUM_SIZE               ( 256 )
+#define IOT_MESSAGE_MEDIUM_BUFFERS                   ( 1 )
+#define IOT_MESSAGE_BUFFER_SIZE                      ( 1024 )
+#define IOT_MESSAGE_BUFFERS                          ( 1 )
+
+/* Library objects. */
+#define IOT_MQTT_CONNECTIONS                         ( 1 )
+#define IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS          ( 2 )
+#define IOT_MQTT_SUBSCRIPTIONS                       ( 2 )
+#define AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS    ( 2 )
+#define AWS_IOT_SHADOW_SUBSCRIPTIONS                 ( 2 )
+#define IOT_TASKPOOLS                                ( 1 )
+#define IOT_TASKPOOL_JOBS_RECYCLE_LIMIT              ( 2UL )
+#define IOT_SERIALIZER_CBOR_ENCODERS                 ( 2 )
+#define IOT_SERIALIZER_CBOR_PARSERS                  ( 2 )
+#define IOT_SERIALIZER_CBOR_VALUES                   ( 2 )
+#define IOT_SERIALIZER_DECODER_OBJECTS               ( 2 )
+
+#endif /* ifndef IOT_STATIC_MEMORY_UTEST_CONFIG_H_ */
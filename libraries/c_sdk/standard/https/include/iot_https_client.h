@@ -70,6 +70,8 @@
  * @function_brief{https_client_function_readheader}
  * - @function_name{https_client_function_readresponsebody}
  * @function_brief{https_client_function_readresponsebody}
+ * - @function_name{https_client_function_readresponsebodyzerocopy}
+ * @function_brief{https_client_function_readresponsebodyzerocopy}
  */
 
 /**
@@ -118,6 +120,9 @@
  * @page https_client_function_readresponsebody IotHttpsClient_ReadResponseBody
  * @snippet this declare_https_client_readresponsebody
  * @copydoc IotHttpsClient_ReadResponseBody
+ * @page https_client_function_readresponsebodyzerocopy IotHttpsClient_ReadResponseBodyZeroCopy
+ * @snippet this declare_https_client_readresponsebodyzerocopy
+ * @copydoc IotHttpsClient_ReadResponseBodyZeroCopy
  */
 
 
@@ -895,4 +900,55 @@ IotHttpsReturnCode_t IotHttpsClient_ReadResponseBody( IotHttpsResponseHandle_t r
                                                       uint32_t * pLen );
 /* @[declare_https_client_readresponsebody] */
 
+/**
+ * @brief Read the HTTPS response body from the network without copying it to an application buffer.
+ *
+ * This is the zero-copy counterpart of @ref https_client_function_readresponsebody. Instead of copying the body into a
+ * buffer provided by the application, the body is received into the space left in #IotHttpsResponseInfo_t.userBuffer
+ * after the response headers, and a slice of that space is lent to the application. Body that was received along with
+ * the headers is lent first, directly from where it was received.
+ *
+ * This is intended to be used with an asynchronous response, this is to be invoked during the
+ * #IotHttpsClientCallbacks_t.readReadyCallback. The slice returned is only valid until this function is called again
+ * or until the #IotHttpsClientCallbacks_t.readReadyCallback returns, whichever happens first. The
+ * #IotHttpsClientCallbacks_t.readReadyCallback is invoked again for as long as there is more response body.
+ * <b> Example Asynchronous Code </b>
+ * @code{c}
+ * void applicationDefined_readReadyCallback(void * pPrivData, IotHttpsResponseHandle_t handle, IotHttpsReturnCode_t rc, uint16_t status)
+ * {
+ *      ...
+ *      const uint8_t * pSlice = NULL;
+ *      uint32_t len = 0;
+ *      if( IotHttpsClient_ReadResponseBodyZeroCopy(handle, &pSlice, &len) == IOT_HTTPS_OK )
+ *      {
+ *          STORE_DATA(pSlice, len);
+ *      }
+ *      ...
+ * }
+ * @endcode
+ *
+ * A chunk encoded body is stripped of its chunk headers in place in the response user buffer, so only the chunk
+ * data is lent to the application.
+ *
+ * The larger the space after the headers in #IotHttpsResponseInfo_t.userBuffer, the larger the slices lent.
+ * See #responseUserBufferMinimumSize for information about sizing the #IotHttpsResponseInfo_t.userBuffer.
+ *
+ * @param[in] respHandle - Unique handle representing the HTTPS response.
+ * @param[out] pBody - Set to the start of the response body slice. This is NULL if no body was read.
+ * @param[out] pLen - Set to the length of the response body slice.
+ *
+ * @return One of the following:
+ * - #IOT_HTTPS_OK if the response body slice was successfully retrieved.
+ * - #IOT_HTTPS_INVALID_PARAMETER if there are NULL parameters or if the response is a synchronous type.
+ * - #IOT_HTTPS_INSUFFICIENT_MEMORY if the response headers left no space in #IotHttpsResponseInfo_t.userBuffer
+ * to receive the body into.
+ * - #IOT_HTTPS_NETWORK_ERROR if there was an error receiving the data on the network.
+ * - #IOT_HTTPS_PARSING_ERROR if there was an error parsing the HTTP response.
+ */
+/* @[declare_https_client_readresponsebodyzerocopy] */
+IotHttpsReturnCode_t IotHttpsClient_ReadResponseBodyZeroCopy( IotHttpsResponseHandle_t respHandle,
+                                                              const uint8_t ** pBody,
+                                                              uint32_t * pLen );
+/* @[declare_https_client_readresponsebodyzerocopy] */
+
 #endif /* IOT_HTTPS_CLIENT_ */
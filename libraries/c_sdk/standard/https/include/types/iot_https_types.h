@@ -163,6 +163,11 @@ extern const uint32_t responseUserBufferMinimumSize;
  * connectionInfo.userBuffer.pBuffer = connectionUserBuffer;
  * @endcode
  *
+ * Any space in the buffer beyond this minimum size is used by the connection to drain the network of response data
+ * that the application did not read, instead of the buffer shared by all connections of size
+ * @ref IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE. If @ref IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE is configured to 0, the shared buffer is
+ * not allocated and the buffer assigned by the application must be larger than this size.
+ *
  * By the application providing the memory for the internal context, no memory is needed to be allocated internally to
  * the library for the internal context. The application has control over the memory allocation related to the request,
  * response, and connection.
@@ -819,7 +819,7 @@ static int _httpParserOnBodyCallback( http_parser * pHttpParser,
          * readReadyCallback(), we can pass the body into the body buffer provided right away. */
         if( pHttpsResponse->pBodyCurInHeaderBuf != ( uint8_t * ) pLoc )
         {
-            memcpy( pHttpsResponse->pBodyCurInHeaderBuf, pLoc, length );
+            memmove( pHttpsResponse->pBodyCurInHeaderBuf, pLoc, length );
         }
 
         pHttpsResponse->pBodyCurInHeaderBuf += length;
@@ -861,9 +861,10 @@ static int _httpParserOnBodyCallback( http_parser * pHttpParser,
              * body buffer. */
             if( ( pHttpsResponse->pBodyCur + length ) <= pHttpsResponse->pBodyEnd )
             {
+                /* The chunk data moves up over the chunk header in the same buffer, so the regions may overlap. */
                 if( pHttpsResponse->pBodyCur != ( uint8_t * ) pLoc )
                 {
-                    memcpy( pHttpsResponse->pBodyCur, pLoc, length );
+                    memmove( pHttpsResponse->pBodyCur, pLoc, length );
                 }
 
                 pHttpsResponse->pBodyCur += length;
@@ -1097,6 +1098,7 @@ static void _networkReceiveCallback( void * pNetworkConnection,
     _httpsRequest_t * pNextHttpsRequest = NULL;
     IotLink_t * pQItem = NULL;
     bool fatalDisconnect = false;
+    uint32_t bodyStartUs = 0;
 
     /* The network connection is already in the connection context. */
     ( void ) pNetworkConnection;
@@ -1184,6 +1186,12 @@ static void _networkReceiveCallback( void * pNetworkConnection,
         /* It is not error if the headers did not all fit into the buffer. */
     }
 
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        IOT_METRICS_RECORD_SINCE( IOT_METRICS_HTTPS_RESPONSE_WAIT, pCurrentHttpsResponse->reqSentUs );
+    #endif
+
+    bodyStartUs = IOT_METRICS_TIMESTAMP();
+
     /* Receive the body. */
     if( pCurrentHttpsResponse->isAsync )
     {
@@ -1229,6 +1237,8 @@ static void _networkReceiveCallback( void * pNetworkConnection,
         HTTPS_GOTO_CLEANUP();
     }
 
+    IOT_METRICS_RECORD_SINCE( IOT_METRICS_HTTPS_RESPONSE_BODY, bodyStartUs );
+
     IOT_FUNCTION_CLEANUP_BEGIN();
 
     /* Disconnect and return in the event of an out-of-order response. If a response is received out of order
@@ -1251,6 +1261,11 @@ static void _networkReceiveCallback( void * pNetworkConnection,
     /* Report errors back to the application. */
     if( HTTPS_FAILED( status ) )
     {
+        if( status != IOT_HTTPS_RECEIVE_ABORT )
+        {
+            IOT_METRICS_COUNT( IOT_METRICS_HTTPS_REQUEST_FAILURES );
+        }
+
         if( pCurrentHttpsResponse->isAsync && pCurrentHttpsResponse->pCallbacks->errorCallback )
         {
             pCurrentHttpsResponse->pCallbacks->errorCallback( pCurrentHttpsResponse->pUserPrivData, NULL, pCurrentHttpsResponse, status );
@@ -1408,6 +1423,15 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
                                          ( *pConnInfo ).userBuffer.bufferLen,
                                          connectionUserBufferMinimumSize );
 
+    /* Without the shared flush buffer, the network is flushed into the space after the context in the user buffer. */
+    #if IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE == 0
+        HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pConnInfo->userBuffer.bufferLen > connectionUserBufferMinimumSize,
+                                             IOT_HTTPS_INSUFFICIENT_MEMORY,
+                                             "Buffer size leaves no space to flush the network into. User buffer size: %d, required minimum size; %d.",
+                                             ( *pConnInfo ).userBuffer.bufferLen,
+                                             connectionUserBufferMinimumSize + 1 );
+    #endif
+
     /* Make sure that the server address does not exceed the maximum permitted length. */
     HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pConnInfo->addressLen <= IOT_HTTPS_MAX_HOST_NAME_LENGTH,
                                          IOT_HTTPS_INVALID_PARAMETER,
@@ -1434,6 +1458,19 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
     IotDeQueue_Create( &( pHttpsConnection->reqQ ) );
     IotDeQueue_Create( &( pHttpsConnection->respQ ) );
 
+    /* The rest of the user buffer after the connection context is this connection's own space to flush the network
+     * into. */
+    if( pConnInfo->userBuffer.bufferLen > connectionUserBufferMinimumSize )
+    {
+        pHttpsConnection->pFlushBuffer = pConnInfo->userBuffer.pBuffer + connectionUserBufferMinimumSize;
+        pHttpsConnection->flushBufferLen = pConnInfo->userBuffer.bufferLen - connectionUserBufferMinimumSize;
+    }
+    else
+    {
+        pHttpsConnection->pFlushBuffer = NULL;
+        pHttpsConnection->flushBufferLen = 0;
+    }
+
     /* This timeout is used to wait for a response on the connection as well as
      * for the timeout for the connect operation. */
     if( pConnInfo->timeout == 0 )
@@ -1884,7 +1921,11 @@ static IotHttpsReturnCode_t _flushHttpsNetworkData( _httpsConnection_t * pHttpsC
 {
     HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
 
-    static uint8_t flushBuffer[ IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE ] = { 0 };
+    #if IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE > 0
+        static uint8_t flushBuffer[ IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE ] = { 0 };
+    #endif
+    uint8_t * pFlushBuffer = pHttpsConnection->pFlushBuffer;
+    size_t flushBufferLen = pHttpsConnection->flushBufferLen;
     const char * pHttpParserErrorDescription = NULL;
     IotHttpsReturnCode_t parserStatus = IOT_HTTPS_OK;
     IotHttpsReturnCode_t networkStatus = IOT_HTTPS_OK;
@@ -1893,15 +1934,26 @@ static IotHttpsReturnCode_t _flushHttpsNetworkData( _httpsConnection_t * pHttpsC
     /* Disable -Wunused-but-set-variable for local variables used for logging. */
     ( void ) pHttpParserErrorDescription;
 
+    /* Flush into the space the connection has in its user buffer. The buffer shared by all connections is only used
+     * when the connection user buffer has no space beyond the context. _createHttpsConnection() guarantees there is
+     * space when the shared buffer is configured out. */
+    #if IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE > 0
+        if( pFlushBuffer == NULL )
+        {
+            pFlushBuffer = flushBuffer;
+            flushBufferLen = IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE;
+        }
+    #endif
+
     /* Even if there is not body, the parser state will become body complete after the headers finish. */
     while( pHttpsResponse->parserState < PARSER_STATE_BODY_COMPLETE )
     {
         IotLogDebug( "Now clearing the rest of the response data on the socket. " );
-        networkStatus = _networkRecv( pHttpsConnection, flushBuffer, IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE, &numBytesRecv );
+        networkStatus = _networkRecv( pHttpsConnection, pFlushBuffer, flushBufferLen, &numBytesRecv );
 
         /* Run this through the parser so that we can get the end of the HTTP message, instead of simply timing out the socket to stop.
          * If we relied on the socket timeout to stop reading the network socket, then the server may close the connection. */
-        parserStatus = _parseHttpsMessage( &( pHttpsResponse->httpParserInfo ), ( char * ) flushBuffer, numBytesRecv );
+        parserStatus = _parseHttpsMessage( &( pHttpsResponse->httpParserInfo ), ( char * ) pFlushBuffer, numBytesRecv );
 
         if( HTTPS_FAILED( parserStatus ) )
         {
@@ -1950,6 +2002,7 @@ static IotHttpsReturnCode_t _sendHttpsHeadersAndBody( _httpsConnection_t * pHttp
     NetworkContext_t networkContext;
     char pHttpsMinimalMockedResponse[ FAST_MACRO_STRLEN( HTTPS_MINIMAL_MOCKED_RESPONSE ) + 1 ] = HTTPS_MINIMAL_MOCKED_RESPONSE;
     uint32_t sendFlags = 0;
+    uint32_t startUs = IOT_METRICS_TIMESTAMP();
 
     coreHttpRequestHeaders.pBuffer = pHttpsRequest->pHeaders;
     coreHttpRequestHeaders.bufferLen = ( size_t ) ( pHttpsRequest->pHeadersEnd - pHttpsRequest->pHeaders );
@@ -1981,6 +2034,14 @@ static IotHttpsReturnCode_t _sendHttpsHeadersAndBody( _httpsConnection_t * pHttp
         HTTPS_GOTO_CLEANUP();
     }
 
+    IOT_METRICS_RECORD_SINCE( IOT_METRICS_HTTPS_REQUEST_SEND, startUs );
+
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        /* The response cannot be received before reqFinishedSending is set
+         * after this function returns, so this is not racing with it. */
+        pHttpsRequest->pHttpsResponse->reqSentUs = IOT_METRICS_TIMESTAMP();
+    #endif
+
     HTTPS_FUNCTION_EXIT_NO_CLEANUP();
 }
 
@@ -2075,6 +2136,11 @@ static void _sendHttpsRequest( _httpsRequest_t * pHttpsRequest )
 
     if( HTTPS_FAILED( status ) )
     {
+        if( status != IOT_HTTPS_SEND_ABORT )
+        {
+            IOT_METRICS_COUNT( IOT_METRICS_HTTPS_REQUEST_FAILURES );
+        }
+
         /* If the headers or body failed to send, then there should be no response expected from the server. */
         /* Cancel the response incase there is a response from the server. */
         _cancelResponse( pHttpsResponse );
@@ -3174,6 +3240,72 @@ IotHttpsReturnCode_t IotHttpsClient_ReadResponseBody( IotHttpsResponseHandle_t r
 
 /*-----------------------------------------------------------*/
 
+IotHttpsReturnCode_t IotHttpsClient_ReadResponseBodyZeroCopy( IotHttpsResponseHandle_t respHandle,
+                                                              const uint8_t ** pBody,
+                                                              uint32_t * pLen )
+{
+    HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
+
+    uint8_t * pWindow = NULL;
+
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( respHandle );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pBody );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pLen );
+    HTTPS_ON_ARG_ERROR_GOTO_CLEANUP( respHandle->isAsync );
+
+    *pBody = NULL;
+    *pLen = 0;
+
+    /* Body received into the header buffer together with the headers is lent first, from where the parser left it.
+     * Any chunk headers were already removed from it in _httpParserOnBodyCallback(). */
+    if( respHandle->pBodyCurInHeaderBuf > respHandle->pBodyInHeaderBuf )
+    {
+        *pBody = respHandle->pBodyInHeaderBuf;
+        *pLen = respHandle->pBodyCurInHeaderBuf - respHandle->pBodyInHeaderBuf;
+        respHandle->pBodyInHeaderBuf = respHandle->pBodyCurInHeaderBuf;
+        HTTPS_GOTO_CLEANUP();
+    }
+
+    if( respHandle->parserState < PARSER_STATE_BODY_COMPLETE )
+    {
+        /* The rest of the response user buffer after the headers is the body buffer. The body in the header buffer
+         * was already lent in a previous call, so it is safe to overwrite it. */
+        pWindow = respHandle->pHeadersCur;
+
+        HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( respHandle->pHeadersEnd > pWindow,
+                                             IOT_HTTPS_INSUFFICIENT_MEMORY,
+                                             "There is no space left after the headers in the response user buffer %p to "
+                                             "receive the body into.",
+                                             respHandle );
+
+        respHandle->pBody = pWindow;
+        respHandle->pBodyCur = pWindow;
+        respHandle->pBodyEnd = respHandle->pHeadersEnd;
+
+        status = _receiveHttpsBody( respHandle->pHttpsConnection, respHandle );
+
+        if( HTTPS_FAILED( status ) )
+        {
+            IotLogError( "Failed to receive the HTTP response body on the network. Error code: %d.", status );
+            HTTPS_GOTO_CLEANUP();
+        }
+
+        *pBody = pWindow;
+        *pLen = respHandle->pBodyCur - pWindow;
+    }
+
+    HTTPS_FUNCTION_CLEANUP_BEGIN();
+
+    if( respHandle != NULL )
+    {
+        respHandle->bodyRxStatus = status;
+    }
+
+    HTTPS_FUNCTION_CLEANUP_END();
+}
+
+/*-----------------------------------------------------------*/
+
 IotHttpsReturnCode_t IotHttpsClient_CancelRequestAsync( IotHttpsRequestHandle_t reqHandle )
 {
     HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
@@ -53,6 +53,7 @@
 /* Platform layer includes. */
 #include "platform/iot_threads.h"
 #include "platform/iot_network.h"
+#include "platform/iot_metrics.h"
 
 /* Error handling include. */
 #include "private/iot_error.h"
@@ -437,6 +438,8 @@ typedef struct _httpsConnection
     IotMutex_t connectionMutex; /**< @brief Mutex protecting operations on this entire connection context. */
     IotDeQueue_t reqQ;          /**< @brief The queue for the requests that are not finished yet. */
     IotDeQueue_t respQ;         /**< @brief The queue for the responses that are waiting to be processed. */
+    uint8_t * pFlushBuffer;     /**< @brief Space in the connection user buffer after this context to flush the network into. NULL if there is none. */
+    uint32_t flushBufferLen;    /**< @brief The length of the space at pFlushBuffer. */
 } _httpsConnection_t;
 
 /**
@@ -501,6 +504,9 @@ typedef struct _httpsResponse
     IotHttpsClientCallbacks_t * pCallbacks; /**< @brief Pointer to the asynchronous request callbacks. */
     void * pUserPrivData;                   /**< @brief User private data to hand back in the asynchronous callbacks for context. */
     bool isNonPersistent;                   /**< @brief Non-persistent flag to indicate closing the connection immediately after receiving the response. */
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        uint32_t reqSentUs;                 /**< @brief When the request finished sending, for #IOT_METRICS_HTTPS_RESPONSE_WAIT. */
+    #endif
 } _httpsResponse_t;
 
 /**
@@ -79,6 +79,7 @@ typedef struct _asyncVerificationParams
      * request verification starts at 0 or 'a'.
      */
     uint8_t readReadyCallbackCountPerResponse[ HTTPS_TEST_MAX_ASYNC_REQUESTS ];
+    uint32_t zeroCopyBodyLength; /**< @brief The total length of the response body lent by IotHttpsClient_ReadResponseBodyZeroCopy(). */
 } _asyncVerificationParams_t;
 
 /*-----------------------------------------------------------*/
@@ -658,6 +659,39 @@ static void _readReadyCallbackThatCancels( void * pPrivData,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Asynchronous #IotHttpsClientCallbacks_t.readReadyCallback implementation that reads the body without copying.
+ */
+static void _readReadyCallbackZeroCopy( void * pPrivData,
+                                        IotHttpsResponseHandle_t respHandle,
+                                        IotHttpsReturnCode_t rc,
+                                        uint16_t status )
+{
+    /* Disable unused parameter warning. */
+    ( void ) rc;
+    ( void ) status;
+
+    IotHttpsReturnCode_t returnCode;
+    const uint8_t * pBody = NULL;
+    uint32_t bodyLen = 0;
+    _asyncVerificationParams_t * verifParams = ( _asyncVerificationParams_t * ) pPrivData;
+
+    returnCode = IotHttpsClient_ReadResponseBodyZeroCopy( respHandle, &pBody, &bodyLen );
+
+    /* The slice lent must lie in the response user buffer and continue the body from where the last slice ended. */
+    if( ( returnCode == IOT_HTTPS_OK ) && ( bodyLen > 0 ) )
+    {
+        TEST_ASSERT_TRUE( pBody > ( const uint8_t * ) respHandle );
+        TEST_ASSERT_TRUE( ( pBody + bodyLen ) <= ( ( const uint8_t * ) respHandle + HTTPS_TEST_RESP_USER_BUFFER_SIZE ) );
+        _verifyHttpResponseBody( bodyLen, ( uint8_t * ) pBody, verifParams->zeroCopyBodyLength );
+        verifParams->zeroCopyBodyLength += bodyLen;
+    }
+
+    verifParams->readReadyCallbackCount++;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test group for HTTPS Client Async Unit tests.
  */
@@ -749,6 +783,7 @@ TEST_GROUP_RUNNER( HTTPS_Client_Unit_Async )
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsFirstIgnoresPresentResponseBody );
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsOneGetsCancelled );
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncChunkedResponse );
+    RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncZeroCopyBody );
 }
 
 /*-----------------------------------------------------------*/
@@ -2092,3 +2127,52 @@ TEST( HTTPS_Client_Unit_Async, SendAsyncChunkedResponse )
     TEST_ASSERT_EQUAL( 0, _verifParams.connectionClosedCallbackCount );
     TEST_ASSERT_EQUAL( 0, _verifParams.errorCallbackCount );
 }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test reading an asynchronous response body with IotHttpsClient_ReadResponseBodyZeroCopy().
+ */
+TEST( HTTPS_Client_Unit_Async, SendAsyncZeroCopyBody )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsRequestHandle_t reqHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsResponseHandle_t respHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    int headerLength = 0;
+    int bodyLength = 0;
+
+    _networkInterface.send = _networkSendSuccess;
+    _networkInterface.receiveUpto = _networkReceiveSuccess;
+    _networkInterface.close = _networkCloseSuccess;
+    _networkInterface.destroy = _networkDestroySuccess;
+
+    connHandle = _getConnHandle();
+    TEST_ASSERT_NOT_NULL( connHandle );
+    _asyncInfoBase.callbacks.readReadyCallback = _readReadyCallbackZeroCopy;
+    reqHandle = _getReqHandle( &( _pAsyncReqInfos[ 0 ] ) );
+    TEST_ASSERT_NOT_NULL( reqHandle );
+
+    _verifParams.numRequestsTotal = 1;
+    _verifParams.numRequestsLeft = 1;
+
+    /* Generate a response message where part of the body is received with the headers and the rest of the body needs
+     * several more slices of the space left after the headers in the response user buffer. */
+    headerLength = HTTPS_TEST_RESP_HEADER_BUFFER_LENGTH / 2;
+    bodyLength = HTTPS_TEST_RESP_HEADER_BUFFER_LENGTH * 2;
+    _generateHttpResponseMessage( headerLength, bodyLength );
+
+    returnCode = IotHttpsClient_SendAsync( connHandle, reqHandle, &respHandle, &( _pAsyncRespInfos[ 0 ] ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+
+    /* Wait on the async request to finish. */
+    TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( _verifParams.completeSem ), HTTPS_TEST_ASYNC_TIMEOUT_MS ) );
+
+    /* If we made it here, then we indeed finished. Verify all of the parameters. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, _verifParams.returnCode[ 0 ] );
+    TEST_ASSERT_EQUAL( bodyLength, _verifParams.zeroCopyBodyLength );
+    TEST_ASSERT_GREATER_THAN( 2, _verifParams.readReadyCallbackCount );
+    TEST_ASSERT_EQUAL( 1, _verifParams.responseCompleteCallbackCount );
+    TEST_ASSERT_EQUAL( 0, _verifParams.connectionClosedCallbackCount );
+    TEST_ASSERT_EQUAL( 0, _verifParams.errorCallbackCount );
+}
@@ -635,10 +635,17 @@ IotMqttError_t IotMqtt_TimedUnsubscribe( IotMqttConnection_t mqttConnection,
  * of QoS), it will return one of:
  * - #IOT_MQTT_BAD_PARAMETER
  * - #IOT_MQTT_NO_MEMORY
+ * - #IOT_MQTT_TIMEOUT (QoS 1 only, if `IOT_MQTT_MAX_INFLIGHT_PUBLISHES` is set
+ * and no place in the in-flight window was freed within `IOT_MQTT_INFLIGHT_WAIT_MS`).
  *
  * @note The parameters `pCallbackInfo` and `pPublishOperation` should only be used for QoS
  * 1 publishes. For QoS 0, they should both be `NULL`.
  *
+ * @note If `IOT_MQTT_ENABLE_TRANSMIT_COALESCING` is `1`, a QoS 0 publish
+ * returns #IOT_MQTT_SUCCESS once its packet is in the transmit queue of the
+ * connection, which is written shortly after. Use @ref mqtt_function_timedpublish
+ * to return only once the packet is written.
+ *
  * @see @ref mqtt_function_timedpublish for a blocking variant of this function.
  *
  * <b>Example</b>
@@ -699,6 +706,9 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
  * mqtt_function_publish followed by @ref mqtt_function_wait. See @ref
  * mqtt_function_publish for more information about the MQTT PUBLISH operation.
  *
+ * A QoS 0 PUBLISH is written to the network before this function returns, even
+ * if `IOT_MQTT_ENABLE_TRANSMIT_COALESCING` is `1`.
+ *
  * @attention QoS 2 messages are currently unsupported. Only 0 or 1 are valid
  * for message QoS.
  *
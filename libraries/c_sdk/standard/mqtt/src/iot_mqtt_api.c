@@ -337,6 +337,10 @@ static _mqttConnection_t * _createMqttConnection( bool awsIotMqttMode,
     _mqttConnection_t * pMqttConnection = NULL;
     bool referencesMutexCreated = false;
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        bool inFlightSemaphoreCreated = false;
+    #endif
+
     /* Allocate memory for the new MQTT connection. */
     pMqttConnection = IotMqtt_MallocConnection( sizeof( _mqttConnection_t ) );
 
@@ -377,6 +381,34 @@ static _mqttConnection_t * _createMqttConnection( bool awsIotMqttMode,
     IotListDouble_Create( &( pMqttConnection->pendingProcessing ) );
     IotListDouble_Create( &( pMqttConnection->pendingResponse ) );
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        /* Create the semaphore counting free places in the in-flight window. */
+        inFlightSemaphoreCreated = IotSemaphore_Create( &( pMqttConnection->inFlightSemaphore ),
+                                                        IOT_MQTT_MAX_INFLIGHT_PUBLISHES,
+                                                        IOT_MQTT_MAX_INFLIGHT_PUBLISHES );
+
+        if( inFlightSemaphoreCreated == false )
+        {
+            IotLogError( "Failed to create in-flight semaphore for new connection." );
+
+            IOT_SET_AND_GOTO_CLEANUP( false );
+        }
+    #endif
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        /* Create the task pool job that sends the transmit queue. Creating a
+         * pre-allocated job should never fail. */
+        if( IotTaskPool_CreateJob( _IotMqtt_ProcessTransmitFlush,
+                                   pMqttConnection,
+                                   &( pMqttConnection->transmitFlushJobStorage ),
+                                   &( pMqttConnection->transmitFlushJob ) ) != IOT_TASKPOOL_SUCCESS )
+        {
+            IotLogError( "Failed to create transmit flush job for new connection." );
+
+            IotMqtt_Assert( false );
+        }
+    #endif
+
     /* AWS IoT service limits set minimum and maximum values for keep-alive interval.
      * Adjust the user-provided keep-alive interval based on these requirements. */
     if( awsIotMqttMode == true )
@@ -436,6 +468,13 @@ static _mqttConnection_t * _createMqttConnection( bool awsIotMqttMode,
             EMPTY_ELSE_MARKER;
         }
 
+        #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+            if( inFlightSemaphoreCreated == true )
+            {
+                IotSemaphore_Destroy( &( pMqttConnection->inFlightSemaphore ) );
+            }
+        #endif
+
         if( pMqttConnection != NULL )
         {
             IotMqtt_FreeConnection( pMqttConnection );
@@ -544,6 +583,10 @@ static void _destroyMqttConnection( _mqttConnection_t * pMqttConnection )
     /* Destroy mutexes. */
     IotMutex_Destroy( &( pMqttConnection->referencesMutex ) );
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        IotSemaphore_Destroy( &( pMqttConnection->inFlightSemaphore ) );
+    #endif
+
     if( contextIndex != -1 )
     {
         IotMutex_Delete( &( connToContext[ contextIndex ].contextMutex ) );
@@ -859,8 +902,14 @@ static int32_t transportSend( NetworkContext_t * pNetworkContext,
     IotMqtt_Assert( pNetworkContext != NULL );
     IotMqtt_Assert( pMessage != NULL );
 
-    /* Sending the bytes on the network using Network Interface. */
-    bytesSend = pNetworkContext->pNetworkInterface->send( pNetworkContext->pNetworkConnection, ( const uint8_t * ) pMessage, bytesToSend );
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        /* Callers of the MQTT LTS API hold the context mutex, which protects
+         * the transmit queue. */
+        bytesSend = _IotMqtt_TransmitQueueSend( pNetworkContext, ( const uint8_t * ) pMessage, bytesToSend );
+    #else
+        /* Sending the bytes on the network using Network Interface. */
+        bytesSend = pNetworkContext->pNetworkInterface->send( pNetworkContext->pNetworkConnection, ( const uint8_t * ) pMessage, bytesToSend );
+    #endif
 
     if( bytesSend <= 0 )
     {
@@ -1704,6 +1753,30 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
         EMPTY_ELSE_MARKER;
     }
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        /* Wait for a response to free a place in the in-flight window. */
+        if( pPublishInfo->qos != IOT_MQTT_QOS_0 )
+        {
+            if( IotSemaphore_TimedWait( &( mqttConnection->inFlightSemaphore ),
+                                        IOT_MQTT_INFLIGHT_WAIT_MS ) == false )
+            {
+                IotLogError( "(MQTT connection %p) In-flight window of %d PUBLISH messages "
+                             "stayed full for %lu ms.",
+                             mqttConnection,
+                             IOT_MQTT_MAX_INFLIGHT_PUBLISHES,
+                             ( unsigned long ) IOT_MQTT_INFLIGHT_WAIT_MS );
+
+                IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_TIMEOUT );
+            }
+
+            pOperation->u.operation.inFlight = true;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+    #endif /* if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0 */
+
     /* Set the reference, if provided. */
     if( pPublishInfo->qos != IOT_MQTT_QOS_0 )
     {
@@ -1835,6 +1908,15 @@ IotMqttError_t IotMqtt_TimedPublish( IotMqttConnection_t mqttConnection,
             EMPTY_ELSE_MARKER;
         }
     }
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        /* A QoS 0 PUBLISH may still be in the transmit queue. Write it before
+         * returning, so that success means that it was sent. */
+        else if( status == IOT_MQTT_SUCCESS )
+        {
+            status = _IotMqtt_managedFlush( mqttConnection );
+        }
+    #endif
     else
     {
         EMPTY_ELSE_MARKER;
@@ -48,6 +48,381 @@ extern _connContext_t connToContext[ MAX_NO_OF_MQTT_CONNECTIONS ];
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Send a QoS 0 PUBLISH packet with #IotNetworkInterface_t::sendv.
+ *
+ * Only the fixed and variable header are serialized, into the network buffer of
+ * the MQTT context. The payload is sent from the caller's buffer.
+ *
+ * @param[in] contextIndex Index of the MQTT context of the connection.
+ * @param[in] pPublishInfo The QoS 0 PUBLISH to send.
+ *
+ * @return #MQTTSuccess, #MQTTBadParameter, #MQTTNoMemory or #MQTTSendFailed.
+ */
+static MQTTStatus_t _sendPublishInPlace( int8_t contextIndex,
+                                         const MQTTPublishInfo_t * pPublishInfo );
+
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief Send the transmit queue of a connection followed by some data.
+ *
+ * The caller must hold the context mutex. The queue is empty afterwards.
+ *
+ * @param[in] pNetworkContext Network context of the connection.
+ * @param[in] pData Data to send after the queue. May be `NULL`.
+ * @param[in] dataLength Length of `pData`.
+ *
+ * @return `true` if the queue and the data were sent; `false` otherwise.
+ */
+    static bool _sendTransmitQueue( NetworkContext_t * pNetworkContext,
+                                    const uint8_t * pData,
+                                    size_t dataLength );
+
+/**
+ * @brief Schedule the job that sends the transmit queue of a connection, unless
+ * it is already scheduled.
+ *
+ * If the job cannot be scheduled, the queue is sent at once.
+ *
+ * @param[in] mqttConnection The MQTT connection to be used.
+ */
+    static void _scheduleTransmitFlush( IotMqttConnection_t mqttConnection );
+#endif /* if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1 */
+
+/*-----------------------------------------------------------*/
+
+static MQTTStatus_t _sendPublishInPlace( int8_t contextIndex,
+                                         const MQTTPublishInfo_t * pPublishInfo )
+{
+    MQTTStatus_t managedMqttStatus = MQTTBadParameter;
+    MQTTContext_t * pContext = &( connToContext[ contextIndex ].context );
+    NetworkContext_t * pNetworkContext = &( connToContext[ contextIndex ].networkContext );
+    size_t remainingLength = 0, packetSize = 0, headerSize = 0, segmentCount = 0, queuedLength = 0;
+    IotNetworkSegment_t segments[ 3 ];
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        _mqttTransmitQueue_t * pQueue = &( pNetworkContext->transmitQueue );
+
+        /* Packets queued before this PUBLISH are sent in the same write. */
+        queuedLength = pQueue->length;
+
+        if( queuedLength > 0U )
+        {
+            segments[ segmentCount ].pData = pQueue->buffer;
+            segments[ segmentCount ].dataLength = queuedLength;
+            segmentCount++;
+        }
+    #endif
+
+    managedMqttStatus = MQTT_GetPublishPacketSize( pPublishInfo, &remainingLength, &packetSize );
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        if( pQueue->failed == true )
+        {
+            managedMqttStatus = MQTTSendFailed;
+        }
+    #endif
+
+    if( managedMqttStatus == MQTTSuccess )
+    {
+        /* A QoS 0 PUBLISH does not carry a packet identifier. */
+        managedMqttStatus = MQTT_SerializePublishHeader( pPublishInfo,
+                                                         0,
+                                                         remainingLength,
+                                                         &( pContext->networkBuffer ),
+                                                         &headerSize );
+    }
+
+    if( managedMqttStatus == MQTTSuccess )
+    {
+        segments[ segmentCount ].pData = pContext->networkBuffer.pBuffer;
+        segments[ segmentCount ].dataLength = headerSize;
+        segmentCount++;
+
+        if( pPublishInfo->payloadLength > 0U )
+        {
+            segments[ segmentCount ].pData = ( const uint8_t * ) pPublishInfo->pPayload;
+            segments[ segmentCount ].dataLength = pPublishInfo->payloadLength;
+            segmentCount++;
+        }
+
+        if( pNetworkContext->pNetworkInterface->sendv( pNetworkContext->pNetworkConnection,
+                                                       segments,
+                                                       segmentCount ) != queuedLength + headerSize + pPublishInfo->payloadLength )
+        {
+            managedMqttStatus = MQTTSendFailed;
+        }
+        else
+        {
+            /* Keep the keep-alive bookkeeping of the context as MQTT_Publish would. */
+            pContext->lastPacketTime = pContext->getTime();
+        }
+
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            pQueue->length = 0U;
+            pQueue->failed = ( managedMqttStatus != MQTTSuccess );
+        #endif
+    }
+
+    return managedMqttStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+    static bool _sendTransmitQueue( NetworkContext_t * pNetworkContext,
+                                    const uint8_t * pData,
+                                    size_t dataLength )
+    {
+        _mqttTransmitQueue_t * pQueue = &( pNetworkContext->transmitQueue );
+        const IotNetworkInterface_t * pNetworkInterface = pNetworkContext->pNetworkInterface;
+        IotNetworkSegment_t segments[ 2 ];
+        size_t segmentCount = 0, segmentIndex = 0, totalLength = 0, bytesSent = 0, segmentSent = 0;
+
+        if( pQueue->length > 0U )
+        {
+            segments[ segmentCount ].pData = pQueue->buffer;
+            segments[ segmentCount ].dataLength = pQueue->length;
+            segmentCount++;
+        }
+
+        if( dataLength > 0U )
+        {
+            segments[ segmentCount ].pData = pData;
+            segments[ segmentCount ].dataLength = dataLength;
+            segmentCount++;
+        }
+
+        totalLength = pQueue->length + dataLength;
+
+        if( pQueue->failed == true )
+        {
+            /* Packets queued after a failed write cannot be delivered in order. */
+            IotLogDebug( "Dropping %lu bytes queued on a failed network connection.",
+                         ( unsigned long ) totalLength );
+        }
+        else if( ( segmentCount == 2U ) && ( pNetworkInterface->sendv != NULL ) )
+        {
+            bytesSent = pNetworkInterface->sendv( pNetworkContext->pNetworkConnection,
+                                                  segments,
+                                                  segmentCount );
+        }
+        else
+        {
+            for( segmentIndex = 0; segmentIndex < segmentCount; segmentIndex++ )
+            {
+                segmentSent = pNetworkInterface->send( pNetworkContext->pNetworkConnection,
+                                                       segments[ segmentIndex ].pData,
+                                                       segments[ segmentIndex ].dataLength );
+                bytesSent += segmentSent;
+
+                if( segmentSent != segments[ segmentIndex ].dataLength )
+                {
+                    break;
+                }
+            }
+        }
+
+        if( bytesSent != totalLength )
+        {
+            IotLogError( "Failed to send %lu queued and %lu new bytes on the network.",
+                         ( unsigned long ) pQueue->length,
+                         ( unsigned long ) dataLength );
+
+            pQueue->failed = true;
+        }
+
+        pQueue->length = 0U;
+
+        return( pQueue->failed == false );
+    }
+
+/*-----------------------------------------------------------*/
+
+    IotMqttError_t _IotMqtt_managedFlush( IotMqttConnection_t mqttConnection )
+    {
+        IotMqttError_t status = IOT_MQTT_BAD_PARAMETER;
+        int8_t contextIndex = _IotMqtt_getContextIndexFromConnection( mqttConnection );
+
+        if( contextIndex < 0 )
+        {
+            IotLogError( "(MQTT connection %p) MQTT Context is not set for this MQTT Connection.",
+                         mqttConnection );
+        }
+        else if( IotMutex_TakeRecursive( &( connToContext[ contextIndex ].contextMutex ) ) == false )
+        {
+            status = IOT_MQTT_TIMEOUT;
+        }
+        else
+        {
+            if( _sendTransmitQueue( &( connToContext[ contextIndex ].networkContext ), NULL, 0 ) == true )
+            {
+                status = IOT_MQTT_SUCCESS;
+            }
+            else
+            {
+                status = IOT_MQTT_NETWORK_ERROR;
+            }
+
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _scheduleTransmitFlush( IotMqttConnection_t mqttConnection )
+    {
+        bool flushNow = false;
+
+        IotMutex_Lock( &( mqttConnection->referencesMutex ) );
+
+        /* The flush job references the connection until it runs. */
+        if( ( mqttConnection->transmitFlushScheduled == false ) &&
+            ( _IotMqtt_IncrementConnectionReferences( mqttConnection ) == true ) )
+        {
+            if( IotTaskPool_Schedule( IOT_SYSTEM_TASKPOOL,
+                                      mqttConnection->transmitFlushJob,
+                                      0 ) == IOT_TASKPOOL_SUCCESS )
+            {
+                mqttConnection->transmitFlushScheduled = true;
+            }
+            else
+            {
+                IotLogWarn( "(MQTT connection %p) Failed to schedule transmit flush job. "
+                            "Sending transmit queue now.",
+                            mqttConnection );
+
+                /* The reference was taken by this function and the caller still
+                 * holds one, so this cannot destroy the connection. */
+                ( mqttConnection->references )--;
+                flushNow = true;
+            }
+        }
+
+        IotMutex_Unlock( &( mqttConnection->referencesMutex ) );
+
+        if( flushNow == true )
+        {
+            ( void ) _IotMqtt_managedFlush( mqttConnection );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    int32_t _IotMqtt_TransmitQueueSend( NetworkContext_t * pNetworkContext,
+                                        const uint8_t * pData,
+                                        size_t dataLength )
+    {
+        int32_t bytesSent = -1;
+        _mqttTransmitQueue_t * pQueue = &( pNetworkContext->transmitQueue );
+
+        if( pQueue->failed == true )
+        {
+            IotLogError( "Network connection %p failed to send earlier packets.",
+                         pNetworkContext->pNetworkConnection );
+        }
+        else if( ( pQueue->coalesce == true ) &&
+                 ( dataLength <= IOT_MQTT_TRANSMIT_QUEUE_SIZE - pQueue->length ) )
+        {
+            ( void ) memcpy( pQueue->buffer + pQueue->length, pData, dataLength );
+            pQueue->length += dataLength;
+
+            bytesSent = ( int32_t ) dataLength;
+        }
+        else if( _sendTransmitQueue( pNetworkContext, pData, dataLength ) == true )
+        {
+            bytesSent = ( int32_t ) dataLength;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        return bytesSent;
+    }
+
+/*-----------------------------------------------------------*/
+
+    size_t _IotMqtt_managedSendCoalesced( IotMqttConnection_t mqttConnection,
+                                          const uint8_t * pPacket,
+                                          size_t packetSize )
+    {
+        size_t bytesSent = 0;
+        bool queued = false;
+        int8_t contextIndex = _IotMqtt_getContextIndexFromConnection( mqttConnection );
+        _mqttTransmitQueue_t * pQueue = NULL;
+
+        if( contextIndex < 0 )
+        {
+            IotLogError( "(MQTT connection %p) MQTT Context is not set for this MQTT Connection.",
+                         mqttConnection );
+        }
+        else if( IotMutex_TakeRecursive( &( connToContext[ contextIndex ].contextMutex ) ) == true )
+        {
+            pQueue = &( connToContext[ contextIndex ].networkContext.transmitQueue );
+
+            pQueue->coalesce = true;
+
+            if( _IotMqtt_TransmitQueueSend( &( connToContext[ contextIndex ].networkContext ),
+                                            pPacket,
+                                            packetSize ) == ( int32_t ) packetSize )
+            {
+                bytesSent = packetSize;
+            }
+
+            pQueue->coalesce = false;
+            queued = ( pQueue->length > 0U );
+
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        if( queued == true )
+        {
+            _scheduleTransmitFlush( mqttConnection );
+        }
+
+        return bytesSent;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void _IotMqtt_ProcessTransmitFlush( IotTaskPool_t pTaskPool,
+                                        IotTaskPoolJob_t pFlushJob,
+                                        void * pContext )
+    {
+        _mqttConnection_t * pMqttConnection = ( _mqttConnection_t * ) pContext;
+
+        /* The task pool and job parameters are not used when asserts are disabled. */
+        ( void ) pTaskPool;
+        ( void ) pFlushJob;
+        IotMqtt_Assert( pTaskPool == IOT_SYSTEM_TASKPOOL );
+        IotMqtt_Assert( pFlushJob == pMqttConnection->transmitFlushJob );
+
+        /* Packets queued from now on need another flush. */
+        IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
+        pMqttConnection->transmitFlushScheduled = false;
+        IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+
+        IotLogDebug( "(MQTT connection %p) Sending transmit queue.", pMqttConnection );
+
+        ( void ) _IotMqtt_managedFlush( pMqttConnection );
+
+        /* Release the reference taken when this job was scheduled. */
+        _IotMqtt_DecrementConnectionReferences( pMqttConnection );
+    }
+
+#endif /* if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1 */
+
+/*-----------------------------------------------------------*/
+
 IotMqttError_t _IotMqtt_managedDisconnect( IotMqttConnection_t mqttConnection )
 {
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_BAD_PARAMETER );
@@ -249,6 +624,11 @@ IotMqttError_t _IotMqtt_managedPublish( IotMqttConnection_t mqttConnection,
     MQTTStatus_t managedMqttStatus = MQTTBadParameter;
     uint16_t packetId = 0;
     MQTTPublishInfo_t publishInfo;
+    bool sendInPlace = false;
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        bool queued = false;
+    #endif
 
     IotMqtt_Assert( mqttConnection != NULL );
     IotMqtt_Assert( pOperation != NULL );
@@ -280,8 +660,34 @@ IotMqttError_t _IotMqtt_managedPublish( IotMqttConnection_t mqttConnection,
             IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_TIMEOUT );
         }
 
-        /* Calling MQTT LTS API for sending the PUBLISH packet on the network. */
-        managedMqttStatus = MQTT_Publish( &( connToContext[ contextIndex ].context ), &publishInfo, packetId );
+        sendInPlace = ( publishInfo.qos == MQTTQoS0 ) &&
+                      ( connToContext[ contextIndex ].networkContext.pNetworkInterface->sendv != NULL );
+
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            /* Payloads that fit in the transmit queue are coalesced instead. */
+            sendInPlace = sendInPlace && ( publishInfo.payloadLength >= IOT_MQTT_TRANSMIT_QUEUE_SIZE );
+        #endif
+
+        if( sendInPlace == true )
+        {
+            /* A QoS 0 PUBLISH leaves no state in the MQTT context, so send the
+             * serialized header and the caller's payload without copying. */
+            managedMqttStatus = _sendPublishInPlace( contextIndex, &publishInfo );
+        }
+        else
+        {
+            #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+                connToContext[ contextIndex ].networkContext.transmitQueue.coalesce = true;
+            #endif
+
+            /* Calling MQTT LTS API for sending the PUBLISH packet on the network. */
+            managedMqttStatus = MQTT_Publish( &( connToContext[ contextIndex ].context ), &publishInfo, packetId );
+
+            #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+                connToContext[ contextIndex ].networkContext.transmitQueue.coalesce = false;
+                queued = ( connToContext[ contextIndex ].networkContext.transmitQueue.length > 0U );
+            #endif
+        }
 
         if( IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) ) == false )
         {
@@ -291,6 +697,14 @@ IotMqttError_t _IotMqtt_managedPublish( IotMqttConnection_t mqttConnection,
 
         /* Converting the status code. */
         status = convertReturnCode( managedMqttStatus );
+
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            /* Send the queued PUBLISH soon, unless more packets join it first. */
+            if( queued == true )
+            {
+                _scheduleTransmitFlush( mqttConnection );
+            }
+        #endif
     }
     else
     {
@@ -315,9 +729,33 @@ IotMqttError_t _IotMqtt_managedPing( IotMqttConnection_t mqttConnection )
 
     if( contextIndex >= 0 )
     {
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            bool queued = false;
+
+            /* The transmit queue is protected by the context mutex. */
+            if( IotMutex_TakeRecursive( &( connToContext[ contextIndex ].contextMutex ) ) == false )
+            {
+                return IOT_MQTT_TIMEOUT;
+            }
+
+            connToContext[ contextIndex ].networkContext.transmitQueue.coalesce = true;
+        #endif
+
         /* Calling MQTT LTS API for sending the PINGREQ packet on the network. */
         managedMqttStatus = MQTT_Ping( &( connToContext[ contextIndex ].context ) );
 
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            connToContext[ contextIndex ].networkContext.transmitQueue.coalesce = false;
+            queued = ( connToContext[ contextIndex ].networkContext.transmitQueue.length > 0U );
+
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+
+            if( queued == true )
+            {
+                _scheduleTransmitFlush( mqttConnection );
+            }
+        #endif
+
         /* Converting the status code. */
         status = convertReturnCode( managedMqttStatus );
     }
@@ -109,6 +109,74 @@ static void _flushPacket( void * pNetworkConnection,
                           const _mqttConnection_t * pMqttConnection,
                           size_t length );
 
+#if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+
+/**
+ * @brief Check if an MQTT connection can use its receive buffer.
+ *
+ * The receive buffer requires a `receiveUpto` function in the network interface
+ * and cannot be used with packet type or remaining length overrides, which read
+ * directly from the network.
+ *
+ * @param[in] pMqttConnection The MQTT connection to check.
+ *
+ * @return `true` if the buffered receive path may be used; `false` otherwise.
+ */
+    static bool _bufferedReceiveSupported( const _mqttConnection_t * pMqttConnection );
+
+/**
+ * @brief Move unprocessed data to the front of the receive buffer and read as
+ * much data as is available from the network into the free space.
+ *
+ * @param[in] pNetworkConnection Network connection to use for receive.
+ * @param[in] pMqttConnection The associated MQTT connection.
+ * @param[in] pContext The context holding the receive buffer.
+ *
+ * @return The number of bytes added to the receive buffer.
+ */
+    static size_t _fillReceiveBuffer( void * pNetworkConnection,
+                                      const _mqttConnection_t * pMqttConnection,
+                                      _connContext_t * pContext );
+
+/**
+ * @brief Receive and process a packet that does not fit in the receive buffer.
+ *
+ * The part of the packet already in the receive buffer is copied into a newly
+ * allocated buffer and the rest is received directly into it.
+ *
+ * @param[in] pNetworkConnection Network connection to use for receive.
+ * @param[in] pMqttConnection The associated MQTT connection.
+ * @param[in] pContext The context holding the receive buffer.
+ * @param[in] headerLength Size of the packet's fixed header.
+ * @param[in] remainingLength The packet's remaining length.
+ *
+ * @return Any status returned by #_deserializeIncomingPacket, #IOT_MQTT_NO_MEMORY,
+ * or #IOT_MQTT_BAD_RESPONSE.
+ */
+    static IotMqttError_t _processOversizedPacket( void * pNetworkConnection,
+                                                   _mqttConnection_t * pMqttConnection,
+                                                   _connContext_t * pContext,
+                                                   size_t headerLength,
+                                                   size_t remainingLength );
+
+/**
+ * @brief Read available data into the receive buffer and process every
+ * complete packet in it.
+ *
+ * Incomplete packets are left in the receive buffer for the next call.
+ *
+ * @param[in] pNetworkConnection Network connection to use for receive.
+ * @param[in] pMqttConnection The associated MQTT connection.
+ * @param[in] pContext The context holding the receive buffer.
+ *
+ * @return #IOT_MQTT_BAD_RESPONSE if the connection should be closed; otherwise,
+ * the status of the last packet processed.
+ */
+    static IotMqttError_t _processReceiveBuffer( void * pNetworkConnection,
+                                                 _mqttConnection_t * pMqttConnection,
+                                                 _connContext_t * pContext );
+#endif /* if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1 */
+
 /*-----------------------------------------------------------*/
 
 static bool _incomingPacketValid( uint8_t packetType )
@@ -287,6 +355,10 @@ static IotMqttError_t _deserializeIncomingPacket( _mqttConnection_t * pMqttConne
     MQTTPublishState_t publishRecordState = MQTTStateNull;
     int8_t contextIndex = -1;
 
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        uint8_t * pReceivedData = NULL;
+    #endif
+
     /* Deserializer function. */
     IotMqttError_t ( * deserialize )( _mqttPacket_t * ) = NULL;
 
@@ -345,6 +417,39 @@ static IotMqttError_t _deserializeIncomingPacket( _mqttConnection_t * pMqttConne
         case MQTT_PACKET_TYPE_PUBLISH:
             IotLogDebug( "(MQTT connection %p) PUBLISH in data stream.", pMqttConnection );
 
+            #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+
+                /* The receive buffer is reused once this packet is processed,
+                 * but subscription callbacks run later on the task pool, where
+                 * they may block on other MQTT operations. Copy the PUBLISH out
+                 * of the receive buffer. */
+                if( ( pIncomingPacket->borrowed == true ) &&
+                    ( pIncomingPacket->remainingLength > 0 ) )
+                {
+                    pReceivedData = IotMqtt_MallocMessage( pIncomingPacket->remainingLength );
+
+                    if( pReceivedData == NULL )
+                    {
+                        IotLogWarn( "Failed to allocate memory for incoming PUBLISH." );
+                        status = IOT_MQTT_NO_MEMORY;
+
+                        break;
+                    }
+                    else
+                    {
+                        ( void ) memcpy( pReceivedData,
+                                         pIncomingPacket->pRemainingData,
+                                         pIncomingPacket->remainingLength );
+                        pIncomingPacket->pRemainingData = pReceivedData;
+                        pIncomingPacket->borrowed = false;
+                    }
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            #endif /* if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1 */
+
             /* Allocate memory to handle the incoming PUBLISH. */
             pOperation = IotMqtt_MallocOperation( sizeof( _mqttOperation_t ) );
 
@@ -768,9 +873,16 @@ static void _sendPuback( _mqttConnection_t * pMqttConnection,
     }
     else
     {
-        bytesSent = pMqttConnection->pNetworkInterface->send( pMqttConnection->pNetworkConnection,
-                                                              pPuback,
-                                                              pubackSize );
+        #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+            /* Acknowledgements of a burst of PUBLISH messages share a write. */
+            bytesSent = _IotMqtt_managedSendCoalesced( pMqttConnection,
+                                                       pPuback,
+                                                       pubackSize );
+        #else
+            bytesSent = pMqttConnection->pNetworkInterface->send( pMqttConnection->pNetworkConnection,
+                                                                  pPuback,
+                                                                  pubackSize );
+        #endif
 
         if( bytesSent != pubackSize )
         {
@@ -809,6 +921,315 @@ static void _flushPacket( void * pNetworkConnection,
 
 /*-----------------------------------------------------------*/
 
+#if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+
+    static bool _bufferedReceiveSupported( const _mqttConnection_t * pMqttConnection )
+    {
+        bool status = ( pMqttConnection->pNetworkInterface->receiveUpto != NULL );
+
+        #if IOT_MQTT_ENABLE_SERIALIZER_OVERRIDES == 1
+            if( pMqttConnection->pSerializer != NULL )
+            {
+                if( ( pMqttConnection->pSerializer->getPacketType != NULL ) ||
+                    ( pMqttConnection->pSerializer->getRemainingLength != NULL ) )
+                {
+                    status = false;
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        #endif /* if IOT_MQTT_ENABLE_SERIALIZER_OVERRIDES == 1 */
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static size_t _fillReceiveBuffer( void * pNetworkConnection,
+                                      const _mqttConnection_t * pMqttConnection,
+                                      _connContext_t * pContext )
+    {
+        size_t bytesReceived = 0;
+        size_t bytesBuffered = pContext->receiveTail - pContext->receiveHead;
+
+        /* Keep any partial packet at the start of the buffer so that every
+         * packet is contiguous once it is complete. */
+        if( pContext->receiveHead > 0 )
+        {
+            if( bytesBuffered > 0 )
+            {
+                ( void ) memmove( pContext->receiveBuffer,
+                                  pContext->receiveBuffer + pContext->receiveHead,
+                                  bytesBuffered );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
+            pContext->receiveHead = 0;
+            pContext->receiveTail = bytesBuffered;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        if( pContext->receiveTail < IOT_MQTT_RECEIVE_BUFFER_SIZE )
+        {
+            bytesReceived = pMqttConnection->pNetworkInterface->receiveUpto( pNetworkConnection,
+                                                                             pContext->receiveBuffer + pContext->receiveTail,
+                                                                             IOT_MQTT_RECEIVE_BUFFER_SIZE - pContext->receiveTail );
+
+            pContext->receiveTail += bytesReceived;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        return bytesReceived;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static IotMqttError_t _processOversizedPacket( void * pNetworkConnection,
+                                                   _mqttConnection_t * pMqttConnection,
+                                                   _connContext_t * pContext,
+                                                   size_t headerLength,
+                                                   size_t remainingLength )
+    {
+        IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
+        _mqttPacket_t incomingPacket = { .u.pMqttConnection = NULL };
+        size_t bytesBuffered = pContext->receiveTail - pContext->receiveHead - headerLength;
+        size_t bytesLeft = remainingLength - bytesBuffered, bytesToFlush = 0;
+
+        /* The packet does not fit in the receive buffer, so whatever is buffered
+         * is all part of this packet. */
+        IotMqtt_Assert( bytesBuffered < remainingLength );
+
+        incomingPacket.type = pContext->receiveBuffer[ pContext->receiveHead ];
+        incomingPacket.remainingLength = remainingLength;
+        incomingPacket.pRemainingData = IotMqtt_MallocMessage( remainingLength );
+
+        if( incomingPacket.pRemainingData == NULL )
+        {
+            IotLogError( "(MQTT connection %p) Failed to allocate buffer of length "
+                         "%lu for incoming packet type %lu.",
+                         pMqttConnection,
+                         ( unsigned long ) remainingLength,
+                         ( unsigned long ) incomingPacket.type );
+
+            /* Discard the rest of the packet, using the receive buffer as scratch space. */
+            pContext->receiveHead = 0;
+            pContext->receiveTail = 0;
+
+            while( bytesLeft > 0 )
+            {
+                bytesToFlush = ( bytesLeft < IOT_MQTT_RECEIVE_BUFFER_SIZE ) ? bytesLeft : IOT_MQTT_RECEIVE_BUFFER_SIZE;
+
+                if( pMqttConnection->pNetworkInterface->receive( pNetworkConnection,
+                                                                 pContext->receiveBuffer,
+                                                                 bytesToFlush ) != bytesToFlush )
+                {
+                    break;
+                }
+                else
+                {
+                    bytesLeft -= bytesToFlush;
+                }
+            }
+
+            IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_NO_MEMORY );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        /* Copy the buffered part of the packet, then receive the rest directly. */
+        ( void ) memcpy( incomingPacket.pRemainingData,
+                         pContext->receiveBuffer + pContext->receiveHead + headerLength,
+                         bytesBuffered );
+        pContext->receiveHead = 0;
+        pContext->receiveTail = 0;
+
+        if( pMqttConnection->pNetworkInterface->receive( pNetworkConnection,
+                                                         incomingPacket.pRemainingData + bytesBuffered,
+                                                         bytesLeft ) != bytesLeft )
+        {
+            IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_BAD_RESPONSE );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        status = _deserializeIncomingPacket( pMqttConnection, &incomingPacket );
+
+        IOT_FUNCTION_CLEANUP_BEGIN();
+
+        /* Free the packet unless it was handed to an incoming PUBLISH. */
+        if( incomingPacket.pRemainingData != NULL )
+        {
+            IotMqtt_FreeMessage( incomingPacket.pRemainingData );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        IOT_FUNCTION_CLEANUP_END();
+    }
+
+/*-----------------------------------------------------------*/
+
+    static IotMqttError_t _processReceiveBuffer( void * pNetworkConnection,
+                                                 _mqttConnection_t * pMqttConnection,
+                                                 _connContext_t * pContext )
+    {
+        IotMqttError_t status = IOT_MQTT_SUCCESS;
+        _mqttPacket_t incomingPacket = { .u.pMqttConnection = NULL };
+        size_t bytesReceived = 0, bytesBuffered = 0, headerLength = 0, remainingLength = 0;
+        uint8_t * pPacket = NULL;
+
+        /* Receiving nothing is not an error: a TLS connection calls back for
+         * records that carry no application data, such as handshake and alert
+         * records, or part of a record. Whatever is buffered waits for the next
+         * callback. A closed connection is reported by the close callback. */
+        ( void ) _fillReceiveBuffer( pNetworkConnection, pMqttConnection, pContext );
+
+        while( ( status != IOT_MQTT_BAD_RESPONSE ) &&
+               ( pContext->receiveTail > pContext->receiveHead ) )
+        {
+            pPacket = pContext->receiveBuffer + pContext->receiveHead;
+            bytesBuffered = pContext->receiveTail - pContext->receiveHead;
+
+            /* Check that the incoming packet type is valid. */
+            if( _incomingPacketValid( pPacket[ 0 ] ) == false )
+            {
+                IotLogError( "(MQTT connection %p) Unknown packet type %02x received.",
+                             pMqttConnection,
+                             pPacket[ 0 ] );
+
+                status = IOT_MQTT_BAD_RESPONSE;
+                break;
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
+            /* Decode the remaining length in place. */
+            remainingLength = _IotMqtt_DecodeRemainingLength( pPacket + 1,
+                                                              bytesBuffered - 1,
+                                                              &headerLength );
+
+            if( headerLength == 0 )
+            {
+                /* The fixed header is incomplete. */
+                remainingLength = 0;
+            }
+            else if( remainingLength == MQTT_REMAINING_LENGTH_INVALID )
+            {
+                status = IOT_MQTT_BAD_RESPONSE;
+                break;
+            }
+            else
+            {
+                /* Account for the packet type byte. */
+                headerLength++;
+            }
+
+            if( ( headerLength != 0 ) &&
+                ( headerLength + remainingLength > IOT_MQTT_RECEIVE_BUFFER_SIZE ) )
+            {
+                status = _processOversizedPacket( pNetworkConnection,
+                                                  pMqttConnection,
+                                                  pContext,
+                                                  headerLength,
+                                                  remainingLength );
+            }
+            else if( ( headerLength == 0 ) ||
+                     ( headerLength + remainingLength > bytesBuffered ) )
+            {
+                /* Wait for the rest of the packet. Only read again now if the
+                 * last read filled the buffer, since more data is likely pending;
+                 * otherwise the next receive callback will deliver it. */
+                if( pContext->receiveTail == IOT_MQTT_RECEIVE_BUFFER_SIZE )
+                {
+                    bytesReceived = _fillReceiveBuffer( pNetworkConnection, pMqttConnection, pContext );
+
+                    if( bytesReceived == 0 )
+                    {
+                        break;
+                    }
+                    else
+                    {
+                        EMPTY_ELSE_MARKER;
+                    }
+                }
+                else
+                {
+                    break;
+                }
+            }
+            else
+            {
+                /* Deserialize the complete packet in place. */
+                incomingPacket.u.pMqttConnection = NULL;
+                incomingPacket.type = pPacket[ 0 ];
+                incomingPacket.remainingLength = remainingLength;
+                incomingPacket.pRemainingData = ( remainingLength > 0 ) ? ( pPacket + headerLength ) : NULL;
+                incomingPacket.packetIdentifier = 0;
+                incomingPacket.borrowed = true;
+
+                pContext->receiveHead += headerLength + remainingLength;
+
+                status = _deserializeIncomingPacket( pMqttConnection, &incomingPacket );
+
+                /* Free a PUBLISH copied out of the receive buffer unless it
+                 * was handed to the task pool. */
+                if( ( incomingPacket.borrowed == false ) &&
+                    ( incomingPacket.pRemainingData != NULL ) )
+                {
+                    IotMqtt_FreeMessage( incomingPacket.pRemainingData );
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            }
+        }
+
+        /* Nothing buffered is usable after a bad response. */
+        if( status == IOT_MQTT_BAD_RESPONSE )
+        {
+            pContext->receiveHead = 0;
+            pContext->receiveTail = 0;
+        }
+        else if( pContext->receiveHead == pContext->receiveTail )
+        {
+            pContext->receiveHead = 0;
+            pContext->receiveTail = 0;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        return status;
+    }
+#endif /* if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1 */
+
+/*-----------------------------------------------------------*/
+
 bool _IotMqtt_GetNextByte( void * pNetworkConnection,
                            const IotNetworkInterface_t * pNetworkInterface,
                            uint8_t * pIncomingByte )
@@ -949,34 +1370,59 @@ void IotMqtt_ReceiveCallback( void * pNetworkConnection,
     IotMqttError_t status = IOT_MQTT_SUCCESS;
     _mqttPacket_t incomingPacket = { .u.pMqttConnection = NULL };
 
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        int8_t contextIndex = -1;
+    #endif
+
     /* Cast context to correct type. */
     _mqttConnection_t * pMqttConnection = ( _mqttConnection_t * ) pReceiveContext;
 
-    /* Read an MQTT packet from the network. */
-    status = _getIncomingPacket( pNetworkConnection,
-                                 pMqttConnection,
-                                 &incomingPacket );
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        if( _bufferedReceiveSupported( pMqttConnection ) == true )
+        {
+            contextIndex = _IotMqtt_getContextIndexFromConnection( pMqttConnection );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
 
-    if( status == IOT_MQTT_SUCCESS )
+        if( contextIndex >= 0 )
+        {
+            /* Read and process every complete packet available. */
+            status = _processReceiveBuffer( pNetworkConnection,
+                                            pMqttConnection,
+                                            &( connToContext[ contextIndex ] ) );
+        }
+        else
+    #endif /* if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1 */
     {
-        /* Deserialize the received packet. */
-        status = _deserializeIncomingPacket( pMqttConnection,
-                                             &incomingPacket );
+        /* Read an MQTT packet from the network. */
+        status = _getIncomingPacket( pNetworkConnection,
+                                     pMqttConnection,
+                                     &incomingPacket );
 
-        /* Free any buffers allocated for the MQTT packet. */
-        if( incomingPacket.pRemainingData != NULL )
+        if( status == IOT_MQTT_SUCCESS )
         {
-            IotMqtt_FreeMessage( incomingPacket.pRemainingData );
+            /* Deserialize the received packet. */
+            status = _deserializeIncomingPacket( pMqttConnection,
+                                                 &incomingPacket );
+
+            /* Free any buffers allocated for the MQTT packet. */
+            if( incomingPacket.pRemainingData != NULL )
+            {
+                IotMqtt_FreeMessage( incomingPacket.pRemainingData );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
         }
         else
         {
             EMPTY_ELSE_MARKER;
         }
     }
-    else
-    {
-        EMPTY_ELSE_MARKER;
-    }
 
     /* Close the network connection on a bad response. */
     if( status == IOT_MQTT_BAD_RESPONSE )
@@ -387,6 +387,10 @@ IotMqttError_t _IotMqtt_CreateOperation( _mqttConnection_t * pMqttConnection,
         pOperation->u.operation.jobReference = 1;
         pOperation->u.operation.flags = flags;
         pOperation->u.operation.status = IOT_MQTT_STATUS_PENDING;
+
+        #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+            pOperation->u.operation.startUs = IOT_METRICS_TIMESTAMP();
+        #endif
     }
 
     /* Check if the waitable flag is set. If it is, create a semaphore to
@@ -588,6 +592,11 @@ void _IotMqtt_DestroyOperation( _mqttOperation_t * pOperation )
 
     IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        /* A PUBLISH that did not complete still holds its place. */
+        _IotMqtt_ReleaseInFlight( pOperation );
+    #endif
+
     /* Free any allocated MQTT packet. */
     if( pOperation->u.operation.pMqttPacket != NULL )
     {
@@ -1395,6 +1404,23 @@ void _IotMqtt_Notify( _mqttOperation_t * pOperation )
     /* Check if operation is waitable. */
     bool waitable = ( pOperation->u.operation.flags & IOT_MQTT_FLAG_WAITABLE ) == IOT_MQTT_FLAG_WAITABLE;
 
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        /* A completed PUBLISH no longer counts against the in-flight window. */
+        _IotMqtt_ReleaseInFlight( pOperation );
+    #endif
+
+    #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+        /* Only operations acknowledged by the server have a round trip. */
+        if( pOperation->u.operation.status == IOT_MQTT_SUCCESS )
+        {
+            IOT_METRICS_RECORD_SINCE( IOT_METRICS_MQTT_OPERATION, pOperation->u.operation.startUs );
+        }
+        else
+        {
+            IOT_METRICS_COUNT( IOT_METRICS_MQTT_OPERATION_FAILURES );
+        }
+    #endif
+
     /* Remove any lingering subscriptions if a SUBSCRIBE failed. Rejected
      * subscriptions are removed by the deserializer, so not removed here. */
     if( pOperation->u.operation.type == IOT_MQTT_SUBSCRIBE )
@@ -1512,6 +1538,32 @@ void _IotMqtt_Notify( _mqttOperation_t * pOperation )
 
 /*-----------------------------------------------------------*/
 
+#if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+
+    void _IotMqtt_ReleaseInFlight( _mqttOperation_t * pOperation )
+    {
+        bool inFlight = false;
+        _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
+
+        if( pOperation->incomingPublish == false )
+        {
+            /* Notify and destroy may both release an operation; only the first does. */
+            IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
+            inFlight = pOperation->u.operation.inFlight;
+            pOperation->u.operation.inFlight = false;
+            IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+        }
+
+        if( inFlight == true )
+        {
+            IotSemaphore_Post( &( pMqttConnection->inFlightSemaphore ) );
+        }
+    }
+
+#endif /* if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0 */
+
+/*-----------------------------------------------------------*/
+
 void _IotMqtt_FreePacket( uint8_t * pPacket )
 {
     uint8_t packetType;
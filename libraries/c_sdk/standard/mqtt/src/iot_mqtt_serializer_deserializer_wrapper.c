@@ -203,6 +203,60 @@ size_t _IotMqtt_GetRemainingLength( void * pNetworkConnection,
 
 /*-----------------------------------------------------------*/
 
+size_t _IotMqtt_DecodeRemainingLength( const uint8_t * pBuffer,
+                                       size_t bufferLength,
+                                       size_t * pBytesDecoded )
+{
+    uint8_t encodedByte = 0;
+    size_t remainingLength = 0, multiplier = 1, bytesDecoded = 0;
+
+    /* Same algorithm as _IotMqtt_GetRemainingLength, but reading from memory. */
+    do
+    {
+        if( multiplier > 2097152 ) /* 128 ^ 3 */
+        {
+            remainingLength = MQTT_REMAINING_LENGTH_INVALID;
+            break;
+        }
+        else if( bytesDecoded == bufferLength )
+        {
+            /* The rest of the encoding has not been received yet. */
+            bytesDecoded = 0;
+            break;
+        }
+        else
+        {
+            encodedByte = pBuffer[ bytesDecoded ];
+            remainingLength += ( encodedByte & 0x7F ) * multiplier;
+            multiplier *= 128;
+            bytesDecoded++;
+        }
+    } while( ( encodedByte & 0x80 ) != 0 );
+
+    /* Check that the decoded remaining length conforms to the MQTT specification. */
+    if( ( bytesDecoded != 0 ) && ( remainingLength != MQTT_REMAINING_LENGTH_INVALID ) )
+    {
+        if( bytesDecoded != _remainingLengthEncodedSize( remainingLength ) )
+        {
+            remainingLength = MQTT_REMAINING_LENGTH_INVALID;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    *pBytesDecoded = bytesDecoded;
+
+    return remainingLength;
+}
+
+/*-----------------------------------------------------------*/
+
 /* Connect Serialize Wrapper. */
 IotMqttError_t _IotMqtt_connectSerializeWrapper( const IotMqttConnectInfo_t * pConnectInfo,
                                                  uint8_t ** pConnectPacket,
@@ -89,33 +89,49 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseMqttConnections[ IOT_MQTT_CONNECTIONS ] = { 0 };                                      /**< @brief MQTT connection in-use flags. */
-    static _mqttConnection_t _pMqttConnections[ IOT_MQTT_CONNECTIONS ] = { { 0 } };                          /**< @brief MQTT connections. */
+    static uint32_t _pInUseMqttConnections[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_MQTT_CONNECTIONS ) ] = { 0 }; /**< @brief MQTT connection in-use flags. */
+    static _mqttConnection_t _pMqttConnections[ IOT_MQTT_CONNECTIONS ] = { { 0 } };                         /**< @brief MQTT connections. */
 
-    static bool _pInUseMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { 0 };                        /**< @brief MQTT operation in-use flags. */
-    static _mqttOperation_t _pMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } }; /**< @brief MQTT operations. */
+    static uint32_t _pInUseMqttOperations[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ) ] = { 0 }; /**< @brief MQTT operation in-use flags. */
+    static _mqttOperation_t _pMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } };              /**< @brief MQTT operations. */
 
-    static bool _pInUseMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ] = { 0 };                                  /**< @brief MQTT subscription in-use flags. */
-    static char _pMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ][ MQTT_SUBSCRIPTION_SIZE ] = { { 0 } };         /**< @brief MQTT subscriptions. */
+    static uint32_t _pInUseMqttSubscriptions[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_MQTT_SUBSCRIPTIONS ) ] = { 0 }; /**< @brief MQTT subscription in-use flags. */
+    static char _pMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ][ MQTT_SUBSCRIPTION_SIZE ] = { { 0 } };            /**< @brief MQTT subscriptions. */
+
+/**
+ * @brief Allocator of MQTT connections.
+ */
+    static IotStaticMemorySlab_t _mqttConnectionSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pMqttConnections,
+                                                                                           _pInUseMqttConnections,
+                                                                                           sizeof( _mqttConnection_t ),
+                                                                                           IOT_MQTT_CONNECTIONS );
+
+/**
+ * @brief Allocator of MQTT operations.
+ */
+    static IotStaticMemorySlab_t _mqttOperationSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pMqttOperations,
+                                                                                          _pInUseMqttOperations,
+                                                                                          sizeof( _mqttOperation_t ),
+                                                                                          IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS );
+
+/**
+ * @brief Allocator of MQTT subscriptions.
+ */
+    static IotStaticMemorySlab_t _mqttSubscriptionSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _pMqttSubscriptions,
+                                                                                             _pInUseMqttSubscriptions,
+                                                                                             MQTT_SUBSCRIPTION_SIZE,
+                                                                                             IOT_MQTT_SUBSCRIPTIONS );
 
 /*-----------------------------------------------------------*/
 
     void * IotMqtt_MallocConnection( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewConnection = NULL;
 
         /* Check size argument. */
         if( size == sizeof( _mqttConnection_t ) )
         {
-            /* Find a free MQTT connection. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttConnections,
-                                                  IOT_MQTT_CONNECTIONS );
-
-            if( freeIndex != -1 )
-            {
-                pNewConnection = &( _pMqttConnections[ freeIndex ] );
-            }
+            pNewConnection = IotStaticMemory_SlabAllocate( &( _mqttConnectionSlab ) );
         }
 
         return pNewConnection;
@@ -126,31 +142,19 @@
     void IotMqtt_FreeConnection( void * ptr )
     {
         /* Return the in-use MQTT connection. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttConnections,
-                                     _pInUseMqttConnections,
-                                     IOT_MQTT_CONNECTIONS,
-                                     sizeof( _mqttConnection_t ) );
+        ( void ) IotStaticMemory_SlabFree( &( _mqttConnectionSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * IotMqtt_MallocOperation( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewOperation = NULL;
 
         /* Check size argument. */
         if( size == sizeof( _mqttOperation_t ) )
         {
-            /* Find a free MQTT operation. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttOperations,
-                                                  IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS );
-
-            if( freeIndex != -1 )
-            {
-                pNewOperation = &( _pMqttOperations[ freeIndex ] );
-            }
+            pNewOperation = IotStaticMemory_SlabAllocate( &( _mqttOperationSlab ) );
         }
 
         return pNewOperation;
@@ -161,30 +165,18 @@
     void IotMqtt_FreeOperation( void * ptr )
     {
         /* Return the in-use MQTT operation. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttOperations,
-                                     _pInUseMqttOperations,
-                                     IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS,
-                                     sizeof( _mqttOperation_t ) );
+        ( void ) IotStaticMemory_SlabFree( &( _mqttOperationSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * IotMqtt_MallocSubscription( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewSubscription = NULL;
 
         if( size <= MQTT_SUBSCRIPTION_SIZE )
         {
-            /* Get the index of a free MQTT subscription. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttSubscriptions,
-                                                  IOT_MQTT_SUBSCRIPTIONS );
-
-            if( freeIndex != -1 )
-            {
-                pNewSubscription = &( _pMqttSubscriptions[ freeIndex ][ 0 ] );
-            }
+            pNewSubscription = IotStaticMemory_SlabAllocate( &( _mqttSubscriptionSlab ) );
         }
 
         return pNewSubscription;
@@ -195,11 +187,7 @@
     void IotMqtt_FreeSubscription( void * ptr )
     {
         /* Return the in-use MQTT subscription. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttSubscriptions,
-                                     _pInUseMqttSubscriptions,
-                                     IOT_MQTT_SUBSCRIPTIONS,
-                                     MQTT_SUBSCRIPTION_SIZE );
+        ( void ) IotStaticMemory_SlabFree( &( _mqttSubscriptionSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
@@ -117,6 +117,21 @@ IotMqttError_t _IotMqtt_AddSubscriptions( _mqttConnection_t * pMqttConnection,
                         ( void ) memcpy( connToContext[ contextIndex ].subscriptionArray[ index ].pTopicFilter,
                                          pSubscriptionList[ i ].pTopicFilter,
                                          ( size_t ) ( pSubscriptionList[ i ].topicFilterLength ) );
+
+                        #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+                            if( IotMqtt_IndexSubscription( connToContext[ contextIndex ].subscriptionArray, index ) == false )
+                            {
+                                /* Free the subscription, as it cannot be matched. */
+                                connToContext[ contextIndex ].subscriptionArray[ index ].topicFilterLength = 0;
+                                IotMqtt_FreeMessage( pTopicFilter );
+
+                                status = IOT_MQTT_NO_MEMORY;
+                                IotLogError( "(MQTT connection %p) Subscription trie is full. "
+                                             "Consider updating the IOT_MQTT_SUBSCRIPTION_TRIE_NODES config to resolve the issue. ",
+                                             pMqttConnection );
+                                break;
+                            }
+                        #endif
                     }
                     else
                     {
@@ -248,7 +263,7 @@ void _IotMqtt_InvokeSubscriptionCallback( _mqttConnection_t * pMqttConnection,
                 if( pSubscription->references == 0 )
                 {
                     /* Free the subscription by setting the topicfilterlength to 0. */
-                    pSubscription->topicFilterLength = 0;
+                    ( void ) IotMqtt_RemoveSubscription( connToContext[ contextIndex ].subscriptionArray, index );
                 }
             }
 
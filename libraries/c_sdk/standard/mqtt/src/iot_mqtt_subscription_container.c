@@ -66,6 +66,205 @@ static bool _packetMatch( _mqttSubscription_t * pSubscription,
 static bool _topicMatch( _mqttSubscription_t * pSubscription,
                          void * pMatch );
 
+/**
+ * @brief Find the end of a topic level.
+ *
+ * @param[in] pTopic Topic name or topic filter.
+ * @param[in] topicLength Length of `pTopic`.
+ * @param[in] levelStart Offset of the first character of the level.
+ *
+ * @return Offset of the '/' after the level, or `topicLength` for the last level.
+ */
+static uint16_t _levelEnd( const char * pTopic,
+                           uint16_t topicLength,
+                           uint16_t levelStart );
+
+/**
+ * @brief Hash a topic level for the topic-filter trie.
+ *
+ * @param[in] pLevel The topic level.
+ * @param[in] levelLength Length of `pLevel`.
+ *
+ * @return 16-bit hash of the level.
+ */
+static uint16_t _levelHash( const char * pLevel,
+                            uint16_t levelLength );
+
+/**
+ * @brief Get the hash table bucket of a trie node's child.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] parent The parent of the child.
+ * @param[in] levelHash Hash of the level of the child.
+ *
+ * @return The node that heads the bucket.
+ */
+static uint16_t _trieBucket( const _mqttTopicTrie_t * pTrie,
+                             uint16_t parent,
+                             uint16_t levelHash );
+
+/**
+ * @brief Remove a trie node from its hash table bucket, if it is in one.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] node The node to remove.
+ */
+static void _trieRemoveFromBucket( const _mqttTopicTrie_t * pTrie,
+                                   uint16_t node );
+
+/**
+ * @brief Find the child of a trie node for a topic level.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] parent The node whose children are searched.
+ * @param[in] pLevel The topic level.
+ * @param[in] levelLength Length of `pLevel`.
+ * @param[in] wildcards Whether the levels `+` and `#` select the wildcard
+ * children. Pass `true` for topic filters and `false` for topic names.
+ *
+ * @return The child node; `0` if there is none.
+ */
+static uint16_t _trieFindChild( const _mqttTopicTrie_t * pTrie,
+                                uint16_t parent,
+                                const char * pLevel,
+                                uint16_t levelLength,
+                                bool wildcards );
+
+/**
+ * @brief Find the trie node where a topic filter ends.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] pTopicFilter The topic filter.
+ * @param[in] topicFilterLength Length of `pTopicFilter`.
+ *
+ * @return The node for the last level of `pTopicFilter`; `0` if the trie does
+ * not contain every level.
+ */
+static uint16_t _trieFindFilter( const _mqttTopicTrie_t * pTrie,
+                                 const char * pTopicFilter,
+                                 uint16_t topicFilterLength );
+
+/**
+ * @brief Allocate and link a trie node for a level of a topic filter.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] parent The parent of the new node.
+ * @param[in] subscriptionIndex The subscription whose topic filter contains the level.
+ * @param[in] levelStart Offset of the level in the topic filter.
+ * @param[in] levelEnd Offset of the end of the level in the topic filter.
+ *
+ * @return The new node. The caller must have checked that a node is free.
+ */
+static uint16_t _trieAddNode( const _mqttTopicTrie_t * pTrie,
+                              uint16_t parent,
+                              uint16_t subscriptionIndex,
+                              uint16_t levelStart,
+                              uint16_t levelEnd );
+
+/**
+ * @brief Unlink a trie node from its parent.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] parent The parent of `child`.
+ * @param[in] child The node to unlink.
+ */
+static void _trieUnlink( const _mqttTopicTrie_t * pTrie,
+                         uint16_t parent,
+                         uint16_t child );
+
+/**
+ * @brief Find a subscription whose topic filter ends at or below a trie node.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] node A node with a positive reference count.
+ *
+ * @return Index of the subscription.
+ */
+static uint16_t _trieFindOwner( const _mqttTopicTrie_t * pTrie,
+                                uint16_t node );
+
+/**
+ * @brief Record a trie match in a bitmap.
+ *
+ * @param[in] subscription The `subscription` member of a trie node.
+ * @param[out] pMatches Bitmap of matching subscriptions.
+ * @param[in,out] pMatchCount Number of bits set in `pMatches`.
+ */
+static void _trieSetMatch( uint16_t subscription,
+                           uint32_t * pMatches,
+                           size_t * pMatchCount );
+
+/**
+ * @brief Match one level of a topic name against the children of a trie node.
+ *
+ * Recurses once per topic level, so the depth of the recursion is bounded by
+ * the number of levels in the longest indexed topic filter.
+ *
+ * @param[in] pTrie The topic-filter trie.
+ * @param[in] node The node matching the previous levels of the topic name.
+ * @param[in] pTopicName The topic name.
+ * @param[in] topicNameLength Length of `pTopicName`.
+ * @param[in] levelStart Offset of the level to match.
+ * @param[out] pMatches Bitmap of matching subscriptions.
+ * @param[in,out] pMatchCount Number of bits set in `pMatches`.
+ */
+static void _trieMatchLevel( const _mqttTopicTrie_t * pTrie,
+                             uint16_t node,
+                             const char * pTopicName,
+                             uint16_t topicNameLength,
+                             uint16_t levelStart,
+                             uint32_t * pMatches,
+                             size_t * pMatchCount );
+
+#if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+
+/**
+ * @brief Get the topic-filter trie of the connection that owns a subscription array.
+ *
+ * @param[in] pSubscriptionArray Subscription array.
+ * @param[out] pTrie Set to the trie of the connection.
+ *
+ * @return The context of the connection that owns `pSubscriptionArray`; `NULL`
+ * if it belongs to no connection.
+ */
+    static _connContext_t * _getTrie( const _mqttSubscription_t * pSubscriptionArray,
+                                      _mqttTopicTrie_t * pTrie );
+
+/**
+ * @brief Find the first matching subscription using a topic-filter trie.
+ *
+ * Wildcard matches are found by walking the trie once and are cached in
+ * `pMatch`. Calling again with a later `startIndex` reads the cache, unless
+ * the trie has changed since.
+ *
+ * @param[in] pTrie The trie of a connection.
+ * @param[in] generation Generation of the trie, see #_connContext_t.subscriptionTrieGeneration.
+ * @param[in] startIndex First subscription to consider.
+ * @param[in,out] pMatch Contains the parameters used for matching the subscription.
+ *
+ * @return Index of the first matching subscription at or after `startIndex`;
+ * `-1` if there is none.
+ */
+    static int8_t _findFirstIndexedMatch( const _mqttTopicTrie_t * pTrie,
+                                          uint32_t generation,
+                                          int8_t startIndex,
+                                          _topicMatchParams_t * pMatch );
+
+/**
+ * @brief Remove a subscription from the topic-filter trie of its connection.
+ *
+ * @param[in] pSubscriptionArray Subscription array.
+ * @param[in] index Index of the subscription to remove.
+ */
+    static void _unindexSubscription( const _mqttSubscription_t * pSubscriptionArray,
+                                      int8_t index );
+
+/*-----------------------------------------------------------*/
+
+/* Using initialized connToContext variable. */
+    extern _connContext_t connToContext[ MAX_NO_OF_MQTT_CONNECTIONS ];
+#endif /* if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1 */
+
 /*-----------------------------------------------------------*/
 
 static bool _packetMatch( _mqttSubscription_t * pSubscription,
@@ -228,6 +427,439 @@ static bool _topicMatch( _mqttSubscription_t * pSubscription,
 
 /*-----------------------------------------------------------*/
 
+static uint16_t _levelEnd( const char * pTopic,
+                           uint16_t topicLength,
+                           uint16_t levelStart )
+{
+    uint16_t levelEnd = levelStart;
+
+    while( ( levelEnd < topicLength ) && ( pTopic[ levelEnd ] != '/' ) )
+    {
+        levelEnd++;
+    }
+
+    return levelEnd;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _levelHash( const char * pLevel,
+                            uint16_t levelLength )
+{
+    uint16_t i = 0;
+    uint32_t hash = 2166136261UL;
+
+    /* FNV-1a, folded to 16 bits. */
+    for( i = 0; i < levelLength; i++ )
+    {
+        hash ^= ( uint8_t ) pLevel[ i ];
+        hash *= 16777619UL;
+    }
+
+    return ( uint16_t ) ( ( hash >> 16 ) ^ ( hash & 0xffffUL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _trieBucket( const _mqttTopicTrie_t * pTrie,
+                             uint16_t parent,
+                             uint16_t levelHash )
+{
+    return ( uint16_t ) ( ( ( ( uint32_t ) parent * 31UL ) + levelHash ) % pTrie->nodeCount );
+}
+
+/*-----------------------------------------------------------*/
+
+static void _trieRemoveFromBucket( const _mqttTopicTrie_t * pTrie,
+                                   uint16_t node )
+{
+    _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+    uint16_t * pLink = &( pNodes[ _trieBucket( pTrie, pNodes[ node ].parent, pNodes[ node ].levelHash ) ].bucketHead );
+
+    /* Wildcard nodes are not in any bucket, so the end of the chain may be reached. */
+    while( ( *pLink != 0U ) && ( *pLink != node ) )
+    {
+        pLink = &( pNodes[ *pLink ].bucketNext );
+    }
+
+    if( *pLink == node )
+    {
+        *pLink = pNodes[ node ].bucketNext;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _trieFindChild( const _mqttTopicTrie_t * pTrie,
+                                uint16_t parent,
+                                const char * pLevel,
+                                uint16_t levelLength,
+                                bool wildcards )
+{
+    const _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+    const _mqttTopicTrieNode_t * pChild = NULL;
+    uint16_t child = 0, levelHash = 0;
+
+    if( ( wildcards == true ) && ( levelLength == 1U ) && ( pLevel[ 0 ] == '+' ) )
+    {
+        child = pNodes[ parent ].plusChild;
+    }
+    else if( ( wildcards == true ) && ( levelLength == 1U ) && ( pLevel[ 0 ] == '#' ) )
+    {
+        child = pNodes[ parent ].hashChild;
+    }
+    else
+    {
+        levelHash = _levelHash( pLevel, levelLength );
+        child = pNodes[ _trieBucket( pTrie, parent, levelHash ) ].bucketHead;
+
+        while( child != 0U )
+        {
+            pChild = &( pNodes[ child ] );
+
+            if( ( pChild->parent == parent ) &&
+                ( pChild->levelHash == levelHash ) &&
+                ( pChild->levelLength == levelLength ) &&
+                ( memcmp( &( pTrie->pSubscriptionArray[ pChild->labelOwner ].pTopicFilter[ pChild->levelOffset ] ),
+                          pLevel,
+                          levelLength ) == 0 ) )
+            {
+                break;
+            }
+
+            child = pChild->bucketNext;
+        }
+    }
+
+    return child;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _trieFindFilter( const _mqttTopicTrie_t * pTrie,
+                                 const char * pTopicFilter,
+                                 uint16_t topicFilterLength )
+{
+    uint16_t node = 0, levelStart = 0, levelEnd = 0;
+
+    do
+    {
+        levelEnd = _levelEnd( pTopicFilter, topicFilterLength, levelStart );
+        node = _trieFindChild( pTrie,
+                               node,
+                               &( pTopicFilter[ levelStart ] ),
+                               ( uint16_t ) ( levelEnd - levelStart ),
+                               true );
+        levelStart = ( uint16_t ) ( levelEnd + 1U );
+    } while( ( node != 0U ) && ( levelEnd < topicFilterLength ) );
+
+    return node;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _trieAddNode( const _mqttTopicTrie_t * pTrie,
+                              uint16_t parent,
+                              uint16_t subscriptionIndex,
+                              uint16_t levelStart,
+                              uint16_t levelEnd )
+{
+    _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+    const char * pLevel = &( pTrie->pSubscriptionArray[ subscriptionIndex ].pTopicFilter[ levelStart ] );
+    uint16_t levelLength = ( uint16_t ) ( levelEnd - levelStart );
+    uint16_t node = 1, bucket = 0, bucketHead = 0;
+
+    /* Find a free node. Node 0 is the root and is never free. */
+    while( ( node < pTrie->nodeCount ) && ( pNodes[ node ].references != 0U ) )
+    {
+        node++;
+    }
+
+    IotMqtt_Assert( node < pTrie->nodeCount );
+
+    /* Clear the node, keeping the bucket it heads. */
+    bucketHead = pNodes[ node ].bucketHead;
+    ( void ) memset( &( pNodes[ node ] ), 0x00, sizeof( _mqttTopicTrieNode_t ) );
+    pNodes[ node ].bucketHead = bucketHead;
+
+    pNodes[ node ].parent = parent;
+    pNodes[ node ].labelOwner = subscriptionIndex;
+    pNodes[ node ].levelOffset = levelStart;
+    pNodes[ node ].levelLength = levelLength;
+    pNodes[ node ].levelHash = _levelHash( pLevel, levelLength );
+
+    /* Link the node to its parent. */
+    if( ( levelLength == 1U ) && ( pLevel[ 0 ] == '+' ) )
+    {
+        pNodes[ parent ].plusChild = node;
+    }
+    else if( ( levelLength == 1U ) && ( pLevel[ 0 ] == '#' ) )
+    {
+        pNodes[ parent ].hashChild = node;
+    }
+    else
+    {
+        pNodes[ node ].nextSibling = pNodes[ parent ].firstChild;
+        pNodes[ parent ].firstChild = node;
+
+        bucket = _trieBucket( pTrie, parent, pNodes[ node ].levelHash );
+        pNodes[ node ].bucketNext = pNodes[ bucket ].bucketHead;
+        pNodes[ bucket ].bucketHead = node;
+    }
+
+    return node;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _trieUnlink( const _mqttTopicTrie_t * pTrie,
+                         uint16_t parent,
+                         uint16_t child )
+{
+    _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+    uint16_t previous = 0;
+
+    if( pNodes[ parent ].plusChild == child )
+    {
+        pNodes[ parent ].plusChild = 0;
+    }
+    else if( pNodes[ parent ].hashChild == child )
+    {
+        pNodes[ parent ].hashChild = 0;
+    }
+    else if( pNodes[ parent ].firstChild == child )
+    {
+        pNodes[ parent ].firstChild = pNodes[ child ].nextSibling;
+    }
+    else
+    {
+        previous = pNodes[ parent ].firstChild;
+
+        while( pNodes[ previous ].nextSibling != child )
+        {
+            previous = pNodes[ previous ].nextSibling;
+            IotMqtt_Assert( previous != 0U );
+        }
+
+        pNodes[ previous ].nextSibling = pNodes[ child ].nextSibling;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t _trieFindOwner( const _mqttTopicTrie_t * pTrie,
+                                uint16_t node )
+{
+    const _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+
+    /* Every linked node has a topic filter ending at or below it, so following
+     * any child eventually reaches one. */
+    while( pNodes[ node ].subscription == 0U )
+    {
+        if( pNodes[ node ].firstChild != 0U )
+        {
+            node = pNodes[ node ].firstChild;
+        }
+        else if( pNodes[ node ].plusChild != 0U )
+        {
+            node = pNodes[ node ].plusChild;
+        }
+        else
+        {
+            IotMqtt_Assert( pNodes[ node ].hashChild != 0U );
+            node = pNodes[ node ].hashChild;
+        }
+    }
+
+    return ( uint16_t ) ( pNodes[ node ].subscription - 1U );
+}
+
+/*-----------------------------------------------------------*/
+
+static void _trieSetMatch( uint16_t subscription,
+                           uint32_t * pMatches,
+                           size_t * pMatchCount )
+{
+    uint16_t index = 0;
+
+    if( subscription != 0U )
+    {
+        index = ( uint16_t ) ( subscription - 1U );
+
+        if( ( pMatches[ index / 32U ] & ( 1UL << ( index % 32U ) ) ) == 0UL )
+        {
+            pMatches[ index / 32U ] |= ( 1UL << ( index % 32U ) );
+            ( *pMatchCount )++;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _trieMatchLevel( const _mqttTopicTrie_t * pTrie,
+                             uint16_t node,
+                             const char * pTopicName,
+                             uint16_t topicNameLength,
+                             uint16_t levelStart,
+                             uint32_t * pMatches,
+                             size_t * pMatchCount )
+{
+    const _mqttTopicTrieNode_t * pNodes = pTrie->pNodes;
+    uint16_t levelEnd = _levelEnd( pTopicName, topicNameLength, levelStart );
+    uint16_t children[ 2 ] = { 0 };
+    size_t i = 0;
+
+    /* A "#" child matches this level and all levels after it. */
+    if( pNodes[ node ].hashChild != 0U )
+    {
+        _trieSetMatch( pNodes[ pNodes[ node ].hashChild ].subscription, pMatches, pMatchCount );
+    }
+
+    /* This level matches a child with the same level and the "+" child. */
+    children[ 0 ] = _trieFindChild( pTrie,
+                                    node,
+                                    &( pTopicName[ levelStart ] ),
+                                    ( uint16_t ) ( levelEnd - levelStart ),
+                                    false );
+    children[ 1 ] = pNodes[ node ].plusChild;
+
+    for( i = 0; i < 2U; i++ )
+    {
+        if( children[ i ] == 0U )
+        {
+            continue;
+        }
+
+        if( levelEnd == topicNameLength )
+        {
+            /* This is the last level of the topic name. It matches a topic filter
+             * ending at the child, and filter "sport/#" also matches "sport"
+             * since # includes the parent level. */
+            _trieSetMatch( pNodes[ children[ i ] ].subscription, pMatches, pMatchCount );
+
+            if( pNodes[ children[ i ] ].hashChild != 0U )
+            {
+                _trieSetMatch( pNodes[ pNodes[ children[ i ] ].hashChild ].subscription, pMatches, pMatchCount );
+            }
+        }
+        else
+        {
+            _trieMatchLevel( pTrie,
+                             children[ i ],
+                             pTopicName,
+                             topicNameLength,
+                             ( uint16_t ) ( levelEnd + 1U ),
+                             pMatches,
+                             pMatchCount );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+
+    static _connContext_t * _getTrie( const _mqttSubscription_t * pSubscriptionArray,
+                                      _mqttTopicTrie_t * pTrie )
+    {
+        _connContext_t * pContext = NULL;
+        size_t i = 0;
+
+        for( i = 0; i < MAX_NO_OF_MQTT_CONNECTIONS; i++ )
+        {
+            if( connToContext[ i ].subscriptionArray == pSubscriptionArray )
+            {
+                pTrie->pNodes = connToContext[ i ].subscriptionTrie;
+                pTrie->nodeCount = IOT_MQTT_SUBSCRIPTION_TRIE_NODES;
+                pTrie->pSubscriptionArray = pSubscriptionArray;
+                pContext = &( connToContext[ i ] );
+                break;
+            }
+        }
+
+        return pContext;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static int8_t _findFirstIndexedMatch( const _mqttTopicTrie_t * pTrie,
+                                          uint32_t generation,
+                                          int8_t startIndex,
+                                          _topicMatchParams_t * pMatch )
+    {
+        int32_t index = -1;
+
+        if( pMatch->exactMatchOnly == true )
+        {
+            index = IotMqtt_TopicTrieFind( pTrie, pMatch->pTopicName, pMatch->topicNameLength );
+
+            if( index < startIndex )
+            {
+                index = -1;
+            }
+        }
+        else
+        {
+            /* Callers find every match by calling again from the next index with
+             * the same parameters, so the trie is walked on the first call only.
+             * The subscription mutex is released between calls, so walk it again
+             * if it changed meanwhile. */
+            if( ( startIndex == 0 ) ||
+                ( pMatch->matchesValid == false ) ||
+                ( pMatch->matchesGeneration != generation ) )
+            {
+                ( void ) memset( pMatch->matches, 0x00, sizeof( pMatch->matches ) );
+                ( void ) IotMqtt_TopicTrieMatch( pTrie, pMatch->pTopicName, pMatch->topicNameLength, pMatch->matches );
+                pMatch->matchesGeneration = generation;
+                pMatch->matchesValid = true;
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
+            index = startIndex;
+
+            while( ( index < MAX_NO_OF_MQTT_SUBSCRIPTIONS ) &&
+                   ( ( pMatch->matches[ index / 32 ] & ( 1UL << ( index % 32 ) ) ) == 0UL ) )
+            {
+                index++;
+            }
+
+            if( index == MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+            {
+                index = -1;
+            }
+        }
+
+        return ( int8_t ) index;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _unindexSubscription( const _mqttSubscription_t * pSubscriptionArray,
+                                      int8_t index )
+    {
+        _mqttTopicTrie_t trie = { 0 };
+        _connContext_t * pContext = NULL;
+
+        /* Free subscriptions are not in the trie. */
+        if( pSubscriptionArray[ index ].topicFilterLength != 0U )
+        {
+            pContext = _getTrie( pSubscriptionArray, &trie );
+
+            if( pContext != NULL )
+            {
+                IotMqtt_TopicTrieRemove( &trie, ( uint16_t ) index );
+                pContext->subscriptionTrieGeneration++;
+            }
+        }
+    }
+
+#endif /* if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1 */
+
+/*-----------------------------------------------------------*/
+
 int8_t IotMqtt_GetFreeIndexInSubscriptionArray( _mqttSubscription_t * pSubscriptionArray )
 {
     /* The shim supports only upto 128 subscriptions as the implementation uses 8 bit index. */
@@ -268,6 +900,10 @@ bool IotMqtt_RemoveSubscription( _mqttSubscription_t * pSubscriptionArray,
     /* Remove the subscription from the subscription array. */
     if( deleteIndex != -1 )
     {
+        #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+            _unindexSubscription( pSubscriptionArray, deleteIndex );
+        #endif
+
         /* Using topicFilterLength as a unique parameter to free index and make it available for other subscriptions. */
         pSubscriptionArray[ deleteIndex ].topicFilterLength = 0;
         status = true;
@@ -296,6 +932,10 @@ void IotMqtt_RemoveAllMatches( _mqttSubscription_t * pSubscriptionArray,
             /* Removing the subscription if it matches the given params. */
             if( _packetMatch( &( pSubscriptionArray[ index ] ), pMatch ) == true )
             {
+                #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+                    _unindexSubscription( pSubscriptionArray, ( int8_t ) index );
+                #endif
+
                 /* Using topicFilterLength as a unique parameter to free index and make it available for other subscriptions.
                  * As topicFilterLength will be non zero for the currently used subscriptions. */
                 pSubscriptionArray[ index ].topicFilterLength = 0;
@@ -303,6 +943,10 @@ void IotMqtt_RemoveAllMatches( _mqttSubscription_t * pSubscriptionArray,
         }
         else
         {
+            #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+                _unindexSubscription( pSubscriptionArray, ( int8_t ) index );
+            #endif
+
             pSubscriptionArray[ index ].topicFilterLength = 0;
 
             pSubscriptionArray[ index ].unsubscribed = true;
@@ -318,28 +962,298 @@ int8_t IotMqtt_FindFirstMatch( _mqttSubscription_t * pSubscriptionArray,
                                int8_t startIndex,
                                _topicMatchParams_t * pMatch )
 {
+    bool indexed = false;
+
     /* This function must not be called with a NULL pSubscriptionArray parameter. */
     IotMqtt_Assert( pSubscriptionArray != NULL );
     IotMqtt_Assert( startIndex >= 0 );
 
-    /* Finding the first Match. */
-    while( startIndex < MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+    #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+        {
+            _mqttTopicTrie_t trie = { 0 };
+            const _connContext_t * pContext = NULL;
+
+            /* Use the trie of the connection that owns this array. */
+            pContext = _getTrie( pSubscriptionArray, &trie );
+            indexed = ( pContext != NULL );
+
+            if( indexed == true )
+            {
+                startIndex = _findFirstIndexedMatch( &trie,
+                                                     pContext->subscriptionTrieGeneration,
+                                                     startIndex,
+                                                     pMatch );
+            }
+        }
+    #endif
+
+    if( indexed == false )
     {
-        /* Check whether the subscription match the given params. */
-        if( _topicMatch( &( pSubscriptionArray[ startIndex ] ), pMatch ) == true )
+        /* Finding the first Match. */
+        while( startIndex < MAX_NO_OF_MQTT_SUBSCRIPTIONS )
         {
-            break;
+            /* Check whether the subscription match the given params. */
+            if( _topicMatch( &( pSubscriptionArray[ startIndex ] ), pMatch ) == true )
+            {
+                break;
+            }
+
+            startIndex++;
+        }
+
+        if( startIndex == MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+        {
+            startIndex = -1;
+        }
+    }
+
+    return startIndex;
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+
+    bool IotMqtt_IndexSubscription( _mqttSubscription_t * pSubscriptionArray,
+                                    int8_t index )
+    {
+        bool status = true;
+        _mqttTopicTrie_t trie = { 0 };
+        _connContext_t * pContext = NULL;
+
+        IotMqtt_Assert( pSubscriptionArray != NULL );
+        IotMqtt_Assert( index > -1 && index < MAX_NO_OF_MQTT_SUBSCRIPTIONS );
+
+        pContext = _getTrie( pSubscriptionArray, &trie );
+
+        if( pContext != NULL )
+        {
+            status = IotMqtt_TopicTrieInsert( &trie, ( uint16_t ) index );
+            pContext->subscriptionTrieGeneration++;
+        }
+
+        return status;
+    }
+
+#endif /* if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1 */
+
+/*-----------------------------------------------------------*/
+
+bool IotMqtt_TopicTrieInsert( const _mqttTopicTrie_t * pTrie,
+                              uint16_t subscriptionIndex )
+{
+    bool status = true;
+    _mqttTopicTrieNode_t * pNodes = NULL;
+    const char * pTopicFilter = NULL;
+    uint16_t topicFilterLength = 0, levelStart = 0, levelEnd = 0;
+    uint16_t node = 0, child = 0;
+    size_t i = 0, missingLevels = 0, freeNodes = 0;
+
+    IotMqtt_Assert( pTrie != NULL );
+    IotMqtt_Assert( ( pTrie->nodeCount > 0U ) && ( pTrie->nodeCount <= UINT16_MAX ) );
+    IotMqtt_Assert( subscriptionIndex < UINT16_MAX );
+
+    pNodes = pTrie->pNodes;
+    pTopicFilter = pTrie->pSubscriptionArray[ subscriptionIndex ].pTopicFilter;
+    topicFilterLength = pTrie->pSubscriptionArray[ subscriptionIndex ].topicFilterLength;
+
+    /* Count the levels of the topic filter that are not in the trie. */
+    do
+    {
+        levelEnd = _levelEnd( pTopicFilter, topicFilterLength, levelStart );
+
+        if( missingLevels == 0U )
+        {
+            child = _trieFindChild( pTrie,
+                                    node,
+                                    &( pTopicFilter[ levelStart ] ),
+                                    ( uint16_t ) ( levelEnd - levelStart ),
+                                    true );
+
+            if( child == 0U )
+            {
+                missingLevels = 1;
+            }
+            else
+            {
+                node = child;
+            }
         }
+        else
+        {
+            missingLevels++;
+        }
+
+        levelStart = ( uint16_t ) ( levelEnd + 1U );
+    } while( levelEnd < topicFilterLength );
 
-        startIndex++;
+    /* Check that there are enough free nodes before changing the trie. */
+    for( i = 1; ( i < pTrie->nodeCount ) && ( freeNodes < missingLevels ); i++ )
+    {
+        if( pNodes[ i ].references == 0U )
+        {
+            freeNodes++;
+        }
     }
 
-    if( startIndex == MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+    if( freeNodes < missingLevels )
     {
-        startIndex = -1;
+        status = false;
     }
+    else
+    {
+        /* Walk the topic filter again, adding the missing levels and
+         * referencing every node on its path. */
+        node = 0;
+        levelStart = 0;
 
-    return startIndex;
+        do
+        {
+            levelEnd = _levelEnd( pTopicFilter, topicFilterLength, levelStart );
+            child = _trieFindChild( pTrie,
+                                    node,
+                                    &( pTopicFilter[ levelStart ] ),
+                                    ( uint16_t ) ( levelEnd - levelStart ),
+                                    true );
+
+            if( child == 0U )
+            {
+                child = _trieAddNode( pTrie, node, subscriptionIndex, levelStart, levelEnd );
+            }
+
+            pNodes[ child ].references++;
+            node = child;
+            levelStart = ( uint16_t ) ( levelEnd + 1U );
+        } while( levelEnd < topicFilterLength );
+
+        /* Topic filters are unique in a subscription array. */
+        IotMqtt_Assert( pNodes[ node ].subscription == 0U );
+        pNodes[ node ].subscription = ( uint16_t ) ( subscriptionIndex + 1U );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotMqtt_TopicTrieRemove( const _mqttTopicTrie_t * pTrie,
+                              uint16_t subscriptionIndex )
+{
+    _mqttTopicTrieNode_t * pNodes = NULL;
+    const char * pTopicFilter = NULL;
+    uint16_t topicFilterLength = 0, levelStart = 0, levelEnd = 0;
+    uint16_t node = 0, parent = 0;
+    bool unlinked = false;
+
+    IotMqtt_Assert( pTrie != NULL );
+
+    pNodes = pTrie->pNodes;
+    pTopicFilter = pTrie->pSubscriptionArray[ subscriptionIndex ].pTopicFilter;
+    topicFilterLength = pTrie->pSubscriptionArray[ subscriptionIndex ].topicFilterLength;
+
+    node = _trieFindFilter( pTrie, pTopicFilter, topicFilterLength );
+
+    /* Only remove the topic filter if it was added for this subscription. */
+    if( ( node != 0U ) && ( pNodes[ node ].subscription == ( uint16_t ) ( subscriptionIndex + 1U ) ) )
+    {
+        pNodes[ node ].subscription = 0;
+
+        /* Release the nodes on the path of the topic filter. The first node
+         * that becomes free is unlinked from its parent, which also frees the
+         * nodes below it. Every free node leaves the hash table. */
+        do
+        {
+            levelEnd = _levelEnd( pTopicFilter, topicFilterLength, levelStart );
+            node = _trieFindChild( pTrie,
+                                   parent,
+                                   &( pTopicFilter[ levelStart ] ),
+                                   ( uint16_t ) ( levelEnd - levelStart ),
+                                   true );
+            IotMqtt_Assert( ( node != 0U ) && ( pNodes[ node ].references > 0U ) );
+
+            pNodes[ node ].references--;
+
+            if( pNodes[ node ].references == 0U )
+            {
+                if( unlinked == false )
+                {
+                    _trieUnlink( pTrie, parent, node );
+                    unlinked = true;
+                }
+
+                _trieRemoveFromBucket( pTrie, node );
+            }
+
+            parent = node;
+            levelStart = ( uint16_t ) ( levelEnd + 1U );
+        } while( levelEnd < topicFilterLength );
+
+        /* The levels of nodes still in use may point into the topic filter
+         * being removed. Point them into another topic filter below them. */
+        parent = 0;
+        levelStart = 0;
+
+        do
+        {
+            levelEnd = _levelEnd( pTopicFilter, topicFilterLength, levelStart );
+            node = _trieFindChild( pTrie,
+                                   parent,
+                                   &( pTopicFilter[ levelStart ] ),
+                                   ( uint16_t ) ( levelEnd - levelStart ),
+                                   true );
+
+            if( node != 0U )
+            {
+                if( pNodes[ node ].labelOwner == subscriptionIndex )
+                {
+                    pNodes[ node ].labelOwner = _trieFindOwner( pTrie, node );
+                }
+            }
+
+            parent = node;
+            levelStart = ( uint16_t ) ( levelEnd + 1U );
+        } while( ( node != 0U ) && ( levelEnd < topicFilterLength ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+int32_t IotMqtt_TopicTrieFind( const _mqttTopicTrie_t * pTrie,
+                               const char * pTopicFilter,
+                               uint16_t topicFilterLength )
+{
+    int32_t index = -1;
+    uint16_t node = 0;
+
+    IotMqtt_Assert( pTrie != NULL );
+    IotMqtt_Assert( pTopicFilter != NULL );
+
+    node = _trieFindFilter( pTrie, pTopicFilter, topicFilterLength );
+
+    if( node != 0U )
+    {
+        index = ( int32_t ) pTrie->pNodes[ node ].subscription - 1;
+    }
+
+    return index;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t IotMqtt_TopicTrieMatch( const _mqttTopicTrie_t * pTrie,
+                               const char * pTopicName,
+                               uint16_t topicNameLength,
+                               uint32_t * pMatches )
+{
+    size_t matchCount = 0;
+
+    IotMqtt_Assert( pTrie != NULL );
+    IotMqtt_Assert( pTopicName != NULL );
+    IotMqtt_Assert( pMatches != NULL );
+
+    _trieMatchLevel( pTrie, 0, pTopicName, topicNameLength, 0, pMatches, &matchCount );
+
+    return matchCount;
 }
 
 /*-----------------------------------------------------------*/
@@ -44,6 +44,9 @@
 /* Task pool include. */
 #include "iot_taskpool.h"
 
+/* Platform metrics include. */
+#include "platform/iot_metrics.h"
+
 /* MQTT LTS library includes. */
 #include "core_mqtt_serializer.h"
 #include "core_mqtt.h"
@@ -268,6 +271,41 @@
     #define MAX_NO_OF_MQTT_SUBSCRIPTIONS    ( 10 )
 #endif
 
+/**
+ * @brief Index subscriptions in a topic-filter trie.
+ *
+ * When enabled, each connection keeps its subscribed topic filters in a trie
+ * with one node per topic level and separate children for the `+` and `#`
+ * wildcards. Incoming PUBLISH messages are matched by walking the trie one
+ * topic level at a time, so the cost of a match depends on the depth of the
+ * topic name rather than on the number of subscriptions.
+ *
+ * @note With this enabled, only subscriptions added through
+ * #_IotMqtt_AddSubscriptions are matched.
+ */
+#ifndef IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE
+    #define IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE    ( 0 )
+#endif
+
+/**
+ * @brief Number of nodes in each connection's subscription trie when
+ * @ref IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE is `1`.
+ *
+ * The trie uses one node for its root and one for every topic level that is
+ * not shared with another subscribed topic filter. The default allows four
+ * unshared levels per subscription. A subscription that does not fit fails
+ * with #IOT_MQTT_NO_MEMORY.
+ */
+#ifndef IOT_MQTT_SUBSCRIPTION_TRIE_NODES
+    #define IOT_MQTT_SUBSCRIPTION_TRIE_NODES    ( ( MAX_NO_OF_MQTT_SUBSCRIPTIONS * 4 ) + 1 )
+#endif
+
+/**
+ * @brief Number of `uint32_t` words in a bitmap with one bit per subscription,
+ * as filled by #IotMqtt_TopicTrieMatch.
+ */
+#define IOT_MQTT_TOPIC_TRIE_BITMAP_WORDS( subscriptionCount )    ( ( ( subscriptionCount ) + 31U ) / 32U )
+
 /**
  * @brief Static buffer size provided to MQTT LTS API.
  * This buffer will be used to send the packets on the network.
@@ -276,6 +314,86 @@
 #ifndef NETWORK_BUFFER_SIZE
     #define NETWORK_BUFFER_SIZE    ( 1024U )
 #endif
+
+/**
+ * @brief Enable the buffered receive path.
+ *
+ * When enabled, each connection reads incoming data in chunks into
+ * #_connContext_t.receiveBuffer and parses fixed headers in place instead of
+ * reading the packet type and remaining length one byte at a time. Packets
+ * that fit in the buffer are deserialized without allocating, except incoming
+ * PUBLISH messages: they are copied out of the buffer so that their
+ * subscription callbacks still run on the task pool, where they may block on
+ * other MQTT operations.
+ */
+#ifndef IOT_MQTT_ENABLE_BUFFERED_RECEIVE
+    #define IOT_MQTT_ENABLE_BUFFERED_RECEIVE    ( 0 )
+#endif
+
+/**
+ * @brief Size of the per-connection receive buffer used when
+ * @ref IOT_MQTT_ENABLE_BUFFERED_RECEIVE is `1`.
+ *
+ * Packets larger than this are still received, but into a buffer allocated
+ * with #IotMqtt_MallocMessage.
+ */
+#ifndef IOT_MQTT_RECEIVE_BUFFER_SIZE
+    #define IOT_MQTT_RECEIVE_BUFFER_SIZE    ( 2048U )
+#endif
+
+/**
+ * @brief Coalesce small outgoing packets into one network write.
+ *
+ * When enabled, PUBLISH, PUBACK and PINGREQ packets are appended to a
+ * per-connection transmit queue instead of being sent one by one. A task pool
+ * job sends the queue in one write once the sending thread returns, so that
+ * packets sent in a burst share TLS records and TCP segments. Other packets
+ * are sent at once, together with the packets queued before them.
+ *
+ * @note A packet that was queued is reported as sent, so a QoS 0
+ * @ref mqtt_function_publish may return before its PUBLISH is written. A QoS 0
+ * @ref mqtt_function_timedpublish writes the queue before it returns. If the
+ * write of the queue fails, the next packet sent on the connection fails.
+ */
+#ifndef IOT_MQTT_ENABLE_TRANSMIT_COALESCING
+    #define IOT_MQTT_ENABLE_TRANSMIT_COALESCING    ( 0 )
+#endif
+
+/**
+ * @brief Size of the per-connection transmit queue used when
+ * @ref IOT_MQTT_ENABLE_TRANSMIT_COALESCING is `1`.
+ *
+ * This bounds how much is sent in one write. The default fits in one
+ * 1460-byte TCP segment with the overhead of an AES-GCM TLS record. Packets
+ * larger than the queue are sent directly, after the packets queued before
+ * them.
+ */
+#ifndef IOT_MQTT_TRANSMIT_QUEUE_SIZE
+    #define IOT_MQTT_TRANSMIT_QUEUE_SIZE    ( 1400U )
+#endif
+
+/**
+ * @brief Maximum number of QoS 1 and QoS 2 PUBLISH messages awaiting a
+ * response on each connection, or `0` for no limit.
+ *
+ * When the window is full, @ref mqtt_function_publishasync waits up to
+ * @ref IOT_MQTT_INFLIGHT_WAIT_MS for a response to free a place, then fails
+ * with #IOT_MQTT_TIMEOUT.
+ *
+ * @note A PUBLISH that is sent from a subscription callback running on the
+ * network receive thread cannot be freed a place by a response while it waits.
+ */
+#ifndef IOT_MQTT_MAX_INFLIGHT_PUBLISHES
+    #define IOT_MQTT_MAX_INFLIGHT_PUBLISHES    ( 0 )
+#endif
+
+/**
+ * @brief How long @ref mqtt_function_publishasync waits for a place in a full
+ * in-flight window. Only used when @ref IOT_MQTT_MAX_INFLIGHT_PUBLISHES is not `0`.
+ */
+#ifndef IOT_MQTT_INFLIGHT_WAIT_MS
+    #define IOT_MQTT_INFLIGHT_WAIT_MS    ( IOT_MQTT_RESPONSE_WAIT_MS )
+#endif
 /*---------------------- MQTT internal data structures ----------------------*/
 
 /**
@@ -307,8 +425,34 @@ typedef struct _mqttConnection
     IotTaskPoolJob_t keepAliveJob;               /**< @brief Task pool job for processing this connection's keep-alive. */
     uint8_t * pPingreqPacket;                    /**< @brief An MQTT PINGREQ packet, allocated if keep-alive is active. */
     size_t pingreqPacketSize;                    /**< @brief The size of an allocated PINGREQ packet. */
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        IotTaskPoolJobStorage_t transmitFlushJobStorage; /**< @brief Task pool job for sending this connection's transmit queue. */
+        IotTaskPoolJob_t transmitFlushJob;               /**< @brief Task pool job for sending this connection's transmit queue. */
+        bool transmitFlushScheduled;                     /**< @brief Whether the transmit flush job is scheduled. Protected by the references mutex. */
+    #endif
+
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        IotSemaphore_t inFlightSemaphore; /**< @brief Counts the free places in the window of PUBLISH messages awaiting a response. */
+    #endif
 } _mqttConnection_t;
 
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief Outgoing packets waiting to be sent in one network write.
+ *
+ * Protected by the context mutex of the connection.
+ */
+    typedef struct _mqttTransmitQueue
+    {
+        uint8_t buffer[ IOT_MQTT_TRANSMIT_QUEUE_SIZE ]; /**< @brief The queued packets. */
+        size_t length;                                  /**< @brief Length of the queued packets. */
+        bool coalesce;                                  /**< @brief Whether the packet being sent may be queued. */
+        bool failed;                                    /**< @brief Whether a write of the queue failed. */
+    } _mqttTransmitQueue_t;
+#endif
+
 /**
  * @brief Defining the structure for network context used for sending the packets on the network.
  * The declaration of the structure is mentioned in the transport_interface.h file.
@@ -317,6 +461,10 @@ struct NetworkContext
 {
     void * pNetworkConnection;                       /**< @brief The network connection used for sending packets on the network. */
     const IotNetworkInterface_t * pNetworkInterface; /**< @brief The network interface used to send packets on the network using the above network connection. */
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        _mqttTransmitQueue_t transmitQueue; /**< @brief Outgoing packets waiting to be sent. */
+    #endif
 };
 
 /**
@@ -351,6 +499,45 @@ typedef struct _mqttSubscription
     char * pTopicFilter;            /**< @brief The subscription topic filter. */
 } _mqttSubscription_t;
 
+/**
+ * @brief A node in a topic-filter trie, representing one level of one or more
+ * subscribed topic filters.
+ *
+ * Node 0 is the root of the trie. A link of 0 means "no node" and a node with
+ * no references is free, so a zero-filled node array is an empty trie.
+ *
+ * Children that are not wildcards are also kept in a hash table keyed by their
+ * parent and level, so a child is found without scanning its siblings. The
+ * table has one bucket per node, and each bucket is headed in the node with
+ * the same index.
+ */
+typedef struct _mqttTopicTrieNode
+{
+    uint16_t references;   /**< @brief Number of indexed topic filters that end at or below this node; 0 if the node is free. */
+    uint16_t subscription; /**< @brief One more than the index of the subscription whose topic filter ends at this node; 0 if none. */
+    uint16_t labelOwner;   /**< @brief Index of a subscription whose topic filter contains the level of this node. */
+    uint16_t levelOffset;  /**< @brief Offset of the level of this node in the topic filter of `labelOwner`. */
+    uint16_t levelLength;  /**< @brief Length of the level of this node. */
+    uint16_t levelHash;    /**< @brief Hash of the level of this node, compared before the level itself. */
+    uint16_t firstChild;   /**< @brief First child of this node that is not a wildcard. */
+    uint16_t nextSibling;  /**< @brief Next child of the parent of this node that is not a wildcard. */
+    uint16_t plusChild;    /**< @brief Child for the single-level wildcard `+`. */
+    uint16_t hashChild;    /**< @brief Child for the multi-level wildcard `#`. */
+    uint16_t parent;       /**< @brief Parent of this node. */
+    uint16_t bucketNext;   /**< @brief Next node in the hash table bucket of this node. */
+    uint16_t bucketHead;   /**< @brief First node in the hash table bucket with the index of this node, whether or not this node is free. */
+} _mqttTopicTrieNode_t;
+
+/**
+ * @brief A topic-filter trie indexing the topic filters of a subscription array.
+ */
+typedef struct _mqttTopicTrie
+{
+    _mqttTopicTrieNode_t * pNodes;                  /**< @brief Node pool. Element 0 is the root. */
+    size_t nodeCount;                               /**< @brief Number of elements in `pNodes`. */
+    const _mqttSubscription_t * pSubscriptionArray; /**< @brief The subscriptions whose topic filters are indexed. */
+} _mqttTopicTrie_t;
+
 /**
  * @brief Internal structure representing a single MQTT operation, such as
  * CONNECT, SUBSCRIBE, PUBLISH, etc.
@@ -398,6 +585,14 @@ typedef struct _mqttOperation
                 uint32_t limit;
                 uint32_t nextPeriod;
             } retry;
+
+            #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+                bool inFlight; /**< @brief Whether this PUBLISH holds a place in the in-flight window. Protected by the references mutex. */
+            #endif
+
+            #if IOT_METRICS_ENABLE_HISTOGRAMS == 1
+                uint32_t startUs; /**< @brief When this operation was created, for #IOT_METRICS_MQTT_OPERATION. */
+            #endif
         } operation;
 
         /* If incomingPublish is true, this struct is valid. */
@@ -436,6 +631,10 @@ typedef struct _mqttPacket
     size_t remainingLength;    /**< @brief (Input) Length of the remaining data in the MQTT packet. */
     uint16_t packetIdentifier; /**< @brief (Output) MQTT packet identifier. */
     uint8_t type;              /**< @brief (Input) A value identifying the packet type. */
+
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        bool borrowed;         /**< @brief (Input) Whether `pRemainingData` points into the connection's receive buffer and must not be freed or kept. */
+    #endif
 } _mqttPacket_t;
 
 /**
@@ -454,6 +653,17 @@ typedef struct connContextMapping
     _mqttSubscription_t subscriptionArray[ MAX_NO_OF_MQTT_SUBSCRIPTIONS ]; /**< @brief Holds subscriptions associated with this connection. */
     StaticSemaphore_t subscriptionMutexStorage;                            /**< @brief Static storage for Mutex for synchronization of subscription list. */
     SemaphoreHandle_t subscriptionMutex;                                   /**< @brief Grants exclusive access to the subscription list. */
+
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        uint8_t receiveBuffer[ IOT_MQTT_RECEIVE_BUFFER_SIZE ]; /**< @brief Data read from the network that has not been processed yet. Only accessed from the receive callback. */
+        size_t receiveHead;                                    /**< @brief Offset of the first unprocessed byte in #_connContext_t.receiveBuffer. */
+        size_t receiveTail;                                    /**< @brief Offset one past the last valid byte in #_connContext_t.receiveBuffer. */
+    #endif
+
+    #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+        _mqttTopicTrieNode_t subscriptionTrie[ IOT_MQTT_SUBSCRIPTION_TRIE_NODES ]; /**< @brief Topic-filter trie over #_connContext_t.subscriptionArray. Protected by the subscription mutex. */
+        uint32_t subscriptionTrieGeneration;                                       /**< @brief Incremented whenever #_connContext_t.subscriptionTrie changes, so that cached matches are found again. */
+    #endif
 } _connContext_t;
 
 /**
@@ -464,6 +674,12 @@ typedef struct _topicMatchParams
     const char * pTopicName;  /**< @brief The topic name to parse. */
     uint16_t topicNameLength; /**< @brief Length of #_topicMatchParams_t.pTopicName. */
     bool exactMatchOnly;      /**< @brief Whether to allow wildcards or require exact matches. */
+
+    #if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+        uint32_t matches[ IOT_MQTT_TOPIC_TRIE_BITMAP_WORDS( MAX_NO_OF_MQTT_SUBSCRIPTIONS ) ]; /**< @brief Subscriptions matching the topic name, kept between calls to #IotMqtt_FindFirstMatch. */
+        uint32_t matchesGeneration;                                                       /**< @brief Value of #_connContext_t.subscriptionTrieGeneration when `matches` was filled. */
+        bool matchesValid;                                                                /**< @brief Whether `matches` was filled. */
+    #endif
 } _topicMatchParams_t;
 
 /**
@@ -553,6 +769,22 @@ uint8_t _IotMqtt_GetPacketType( void * pNetworkConnection,
 size_t _IotMqtt_GetRemainingLength( void * pNetworkConnection,
                                     const IotNetworkInterface_t * pNetworkInterface );
 
+/**
+ * @brief Decode the remaining length of a fixed header that is already in memory.
+ *
+ * @param[in] pBuffer The encoded remaining length, i.e. the byte after the
+ * packet type.
+ * @param[in] bufferLength Number of valid bytes at `pBuffer`.
+ * @param[out] pBytesDecoded Set to the size of the encoded remaining length,
+ * or `0` if `pBuffer` does not yet hold the complete encoding.
+ *
+ * @return The remaining length; #MQTT_REMAINING_LENGTH_INVALID on error. The
+ * return value is only meaningful when `*pBytesDecoded` is nonzero.
+ */
+size_t _IotMqtt_DecodeRemainingLength( const uint8_t * pBuffer,
+                                       size_t bufferLength,
+                                       size_t * pBytesDecoded );
+
 
 
 /**
@@ -705,6 +937,18 @@ _mqttOperation_t * _IotMqtt_FindOperation( _mqttConnection_t * pMqttConnection,
  */
 void _IotMqtt_Notify( _mqttOperation_t * pOperation );
 
+#if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+
+/**
+ * @brief Free the place of a PUBLISH in the in-flight window of its connection.
+ *
+ * Does nothing if the operation does not hold a place.
+ *
+ * @param[in] pOperation The MQTT operation which completed.
+ */
+    void _IotMqtt_ReleaseInFlight( _mqttOperation_t * pOperation );
+#endif
+
 /*----------------- MQTT subscription management functions ------------------*/
 
 /**
@@ -1108,6 +1352,62 @@ IotMqttError_t _IotMqtt_managedUnsubscribe( IotMqttConnection_t mqttConnection,
  */
 IotMqttError_t _IotMqtt_managedPing( IotMqttConnection_t mqttConnection );
 
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief Send data through the transmit queue of a connection.
+ *
+ * The caller must hold the context mutex. If the data may be coalesced and fits,
+ * it is appended to the queue. Otherwise, the queue and the data are sent in
+ * one vectored write.
+ *
+ * @param[in] pNetworkContext Network context of the connection.
+ * @param[in] pData The data to send.
+ * @param[in] dataLength Length of `pData`.
+ *
+ * @return `dataLength` if the data was queued or sent; `-1` otherwise.
+ */
+    int32_t _IotMqtt_TransmitQueueSend( NetworkContext_t * pNetworkContext,
+                                        const uint8_t * pData,
+                                        size_t dataLength );
+
+/**
+ * @brief Queue a serialized packet that may be coalesced, such as a PUBACK.
+ *
+ * @param[in] mqttConnection The MQTT connection to be used.
+ * @param[in] pPacket The serialized packet.
+ * @param[in] packetSize Size of `pPacket`.
+ *
+ * @return `packetSize` if the packet was queued or sent; `0` otherwise.
+ */
+    size_t _IotMqtt_managedSendCoalesced( IotMqttConnection_t mqttConnection,
+                                          const uint8_t * pPacket,
+                                          size_t packetSize );
+
+/**
+ * @brief Send the transmit queue of a connection now.
+ *
+ * @param[in] mqttConnection The MQTT connection to be used.
+ *
+ * @return #IOT_MQTT_SUCCESS if the queue was sent or empty;
+ * #IOT_MQTT_NETWORK_ERROR if the write of the queue, or of an earlier one,
+ * failed; #IOT_MQTT_BAD_PARAMETER if the connection has no MQTT context;
+ * #IOT_MQTT_TIMEOUT if the context mutex could not be taken.
+ */
+    IotMqttError_t _IotMqtt_managedFlush( IotMqttConnection_t mqttConnection );
+
+/**
+ * @brief Task pool routine that sends the transmit queue of a connection.
+ *
+ * @param[in] pTaskPool Pointer to the system task pool.
+ * @param[in] pFlushJob Pointer to the connection's transmit flush job.
+ * @param[in] pContext Pointer to an MQTT connection, passed as an opaque context.
+ */
+    void _IotMqtt_ProcessTransmitFlush( IotTaskPool_t pTaskPool,
+                                        IotTaskPoolJob_t pFlushJob,
+                                        void * pContext );
+#endif /* if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1 */
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -1168,6 +1468,77 @@ int8_t IotMqtt_FindFirstMatch( _mqttSubscription_t * pSubscriptionArray,
                                int8_t startIndex,
                                _topicMatchParams_t * pMatch );
 
+#if IOT_MQTT_ENABLE_SUBSCRIPTION_TRIE == 1
+
+    /**
+     * @brief Add a subscription to the topic-filter trie of its connection.
+     *
+     * @param[in] pSubscriptionArray Subscription array of an MQTT connection.
+     * @param[in] index Index of the subscription to add. Its topic filter must be set.
+     *
+     * @return `true` if the subscription was added; `false` if the trie is full.
+     */
+    bool IotMqtt_IndexSubscription( _mqttSubscription_t * pSubscriptionArray,
+                                    int8_t index );
+#endif
+
+/**
+ * @brief Add the topic filter of a subscription to a topic-filter trie.
+ *
+ * @param[in] pTrie The trie to update.
+ * @param[in] subscriptionIndex Index of the subscription in `pTrie->pSubscriptionArray`.
+ * No other indexed subscription may have the same topic filter.
+ *
+ * @return `true` if the topic filter was added; `false` if there are not enough
+ * free nodes.
+ */
+bool IotMqtt_TopicTrieInsert( const _mqttTopicTrie_t * pTrie,
+                              uint16_t subscriptionIndex );
+
+/**
+ * @brief Remove the topic filter of a subscription from a topic-filter trie.
+ *
+ * Nothing is removed if the subscription is not indexed by the trie.
+ *
+ * @param[in] pTrie The trie to update.
+ * @param[in] subscriptionIndex Index of the subscription in `pTrie->pSubscriptionArray`.
+ * Its topic filter must not have changed since it was added.
+ */
+void IotMqtt_TopicTrieRemove( const _mqttTopicTrie_t * pTrie,
+                              uint16_t subscriptionIndex );
+
+/**
+ * @brief Find the subscription with the given topic filter in a topic-filter trie.
+ *
+ * Wildcards in `pTopicFilter` only match the same wildcards.
+ *
+ * @param[in] pTrie The trie to search.
+ * @param[in] pTopicFilter The topic filter to find.
+ * @param[in] topicFilterLength Length of `pTopicFilter`.
+ *
+ * @return Index of the subscription; `-1` if no subscription has this topic filter.
+ */
+int32_t IotMqtt_TopicTrieFind( const _mqttTopicTrie_t * pTrie,
+                               const char * pTopicFilter,
+                               uint16_t topicFilterLength );
+
+/**
+ * @brief Find all the subscriptions in a topic-filter trie whose topic filters
+ * match a topic name.
+ *
+ * @param[in] pTrie The trie to search.
+ * @param[in] pTopicName The topic name of a PUBLISH.
+ * @param[in] topicNameLength Length of `pTopicName`.
+ * @param[out] pMatches Bitmap of #IOT_MQTT_TOPIC_TRIE_BITMAP_WORDS words. The bit
+ * of each matching subscription is set; other bits are left unchanged.
+ *
+ * @return The number of matching subscriptions.
+ */
+size_t IotMqtt_TopicTrieMatch( const _mqttTopicTrie_t * pTrie,
+                               const char * pTopicName,
+                               uint16_t topicNameLength,
+                               uint32_t * pMatches );
+
 /*-----------------------------------Mutexes Wrappers--------------------------------------------*/
 
 /**
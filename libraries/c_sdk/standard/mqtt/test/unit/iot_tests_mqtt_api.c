@@ -191,6 +191,29 @@ static IotNetworkInterface_t _networkInterface = { 0 };
  */
 static char pKeepAliveStatus[ KEEP_ALIVE_PERIODIC_STATUS_LENGTH ] = { 0 };
 
+/**
+ * @brief The last payload segment passed to #_sendvSuccess.
+ */
+static const uint8_t * _pSendvPayload = NULL;
+
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief Counts the network writes of #_sendCount and #_sendvCount.
+ */
+    static int32_t _writeCount = 0;
+
+/**
+ * @brief Counts the bytes written by #_sendCount and #_sendvCount.
+ */
+    static size_t _writeBytes = 0;
+
+/**
+ * @brief Counts the bytes passed to #transportSend.
+ */
+    static size_t _transportBytes = 0;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Using initialized connToContext variable. */
@@ -306,6 +329,69 @@ static size_t _sendSuccess( void * pSendContext,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief A vectored send function that always "succeeds". Records the payload
+ * segment of a PUBLISH.
+ */
+static size_t _sendvSuccess( void * pSendContext,
+                             const IotNetworkSegment_t * pSegments,
+                             size_t segmentCount )
+{
+    size_t i = 0, bytesSent = 0;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) pSendContext;
+
+    /* The first segment is the serialized header. */
+    _pSendvPayload = ( segmentCount > 1 ) ? pSegments[ 1 ].pData : NULL;
+
+    for( i = 0; i < segmentCount; i++ )
+    {
+        bytesSent += pSegments[ i ].dataLength;
+    }
+
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief A send function that counts the writes made on the network. May
+ * report that it was invoked through a semaphore.
+ */
+    static size_t _sendCount( void * pSendContext,
+                              const uint8_t * pMessage,
+                              size_t messageLength )
+    {
+        _writeCount++;
+        _writeBytes += messageLength;
+
+        return _sendSuccess( pSendContext, pMessage, messageLength );
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A vectored send function that counts the writes made on the network.
+ */
+    static size_t _sendvCount( void * pSendContext,
+                               const IotNetworkSegment_t * pSegments,
+                               size_t segmentCount )
+    {
+        size_t bytesSent = _sendvSuccess( pSendContext, pSegments, segmentCount );
+
+        _writeCount++;
+        _writeBytes += bytesSent;
+
+        return bytesSent;
+    }
+
+/*-----------------------------------------------------------*/
+
+#endif /* if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1 */
+
 /**
  * @brief A send function for PINGREQ that responds with a PINGRESP.
  */
@@ -566,8 +652,14 @@ static int32_t transportSend( NetworkContext_t * pNetworkContext,
     IotMqtt_Assert( pNetworkContext != NULL );
     IotMqtt_Assert( pMessage != NULL );
 
-    /* Sending the bytes on the network using Network Interface. */
-    bytesSent = pNetworkContext->pNetworkInterface->send( pNetworkContext->pNetworkConnection, ( const uint8_t * ) pMessage, bytesToSend );
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        /* Send through the transmit queue, as the transport send of the library does. */
+        _transportBytes += bytesToSend;
+        bytesSent = _IotMqtt_TransmitQueueSend( pNetworkContext, ( const uint8_t * ) pMessage, bytesToSend );
+    #else
+        /* Sending the bytes on the network using Network Interface. */
+        bytesSent = pNetworkContext->pNetworkInterface->send( pNetworkContext->pNetworkConnection, ( const uint8_t * ) pMessage, bytesToSend );
+    #endif
 
     if( bytesSent < 0 )
     {
@@ -847,7 +939,15 @@ TEST_GROUP_RUNNER( MQTT_Unit_API )
     RUN_TEST_CASE( MQTT_Unit_API, DisconnectMallocFail );
     RUN_TEST_CASE( MQTT_Unit_API, PublishQoS0Parameters );
     RUN_TEST_CASE( MQTT_Unit_API, PublishQoS0MallocFail );
+    RUN_TEST_CASE( MQTT_Unit_API, PublishQoS0Sendv );
     RUN_TEST_CASE( MQTT_Unit_API, PublishQoS1 );
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        RUN_TEST_CASE( MQTT_Unit_API, PublishCoalesced );
+        RUN_TEST_CASE( MQTT_Unit_API, PublishCoalescedQueueFull );
+    #endif
+    #if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+        RUN_TEST_CASE( MQTT_Unit_API, PublishInFlightWindow );
+    #endif
     RUN_TEST_CASE( MQTT_Unit_API, SubscribeUnsubscribeParameters );
     RUN_TEST_CASE( MQTT_Unit_API, SubscribeMallocFail );
     RUN_TEST_CASE( MQTT_Unit_API, UnsubscribeMallocFail );
@@ -1321,6 +1421,55 @@ TEST( MQTT_Unit_API, PublishQoS0MallocFail )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Tests that a QoS 0 @ref mqtt_function_publish sends the caller's payload
+ * in place when the network interface provides vectored send.
+ */
+TEST( MQTT_Unit_API, PublishQoS0Sendv )
+{
+    IotMqttError_t status = IOT_MQTT_STATUS_PENDING;
+    IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+
+    #if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+        /* Payloads that fit in the transmit queue are coalesced instead. */
+        static const uint8_t pPayload[ IOT_MQTT_TRANSMIT_QUEUE_SIZE ] = { 0 };
+    #else
+        static const uint8_t pPayload[] = "payload";
+    #endif
+
+    /* Initialize parameters. */
+    _networkInterface.send = _sendSuccess;
+    _networkInterface.sendv = _sendvSuccess;
+    _pSendvPayload = NULL;
+
+    /* Create a new MQTT connection. */
+    _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                         &_networkInfo,
+                                                         0 );
+    TEST_ASSERT_NOT_NULL( _pMqttConnection );
+
+    /* Set the MQTT Context for the new MQTT Connection*/
+    TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _setContext( _pMqttConnection, transportSend ) );
+
+    /* Set the necessary members of publish info. */
+    publishInfo.pTopicName = TEST_TOPIC_NAME;
+    publishInfo.topicNameLength = TEST_TOPIC_NAME_LENGTH;
+    publishInfo.pPayload = pPayload;
+    publishInfo.payloadLength = ( uint32_t ) sizeof( pPayload );
+
+    if( TEST_PROTECT() )
+    {
+        /* The payload must be passed to the network without being copied. */
+        status = IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL );
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, status );
+        TEST_ASSERT_EQUAL_PTR( pPayload, _pSendvPayload );
+    }
+
+    IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Tests the behavior of @ref mqtt_function_publish (QoS 1) with various
  * invalid parameters. Also tests the behavior of @ref mqtt_function_publish
@@ -1402,6 +1551,221 @@ TEST( MQTT_Unit_API, PublishQoS1 )
 
 /*-----------------------------------------------------------*/
 
+#if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1
+
+/**
+ * @brief Tests that PUBLISH packets sent in a burst are written in one write
+ * once the sending thread releases the connection, and that a QoS 0
+ * @ref mqtt_function_timedpublish writes its packet before returning.
+ */
+    TEST( MQTT_Unit_API, PublishCoalesced )
+    {
+        int32_t i = 0;
+        int8_t contextIndex = -1;
+        bool contextLocked = false;
+        IotSemaphore_t writeSem;
+        IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+        _mqttTransmitQueue_t * pQueue = NULL;
+
+        /* Initialize parameters. */
+        _networkInterface.send = _sendCount;
+        _networkInterface.sendv = _sendvCount;
+        _writeCount = 0;
+        _writeBytes = 0;
+        _transportBytes = 0;
+        TEST_ASSERT_EQUAL_INT( true, IotSemaphore_Create( &writeSem, 0, 10 ) );
+
+        /* Create a new MQTT connection that posts to the semaphore on writes. */
+        _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                             &_networkInfo,
+                                                             0 );
+        TEST_ASSERT_NOT_NULL( _pMqttConnection );
+        _pMqttConnection->pNetworkConnection = &writeSem;
+
+        /* Set the MQTT Context for the new MQTT Connection*/
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _setContext( _pMqttConnection, transportSend ) );
+        contextIndex = _IotMqtt_getContextIndexFromConnection( _pMqttConnection );
+        pQueue = &( connToContext[ contextIndex ].networkContext.transmitQueue );
+
+        publishInfo.pTopicName = TEST_TOPIC_NAME;
+        publishInfo.topicNameLength = TEST_TOPIC_NAME_LENGTH;
+        publishInfo.pPayload = "payload";
+        publishInfo.payloadLength = 7;
+
+        if( TEST_PROTECT() )
+        {
+            /* Hold the context so that the flush job waits for the whole burst. */
+            contextLocked = IotMutex_TakeRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+            TEST_ASSERT_EQUAL_INT( true, contextLocked );
+
+            for( i = 0; i < 3; i++ )
+            {
+                TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+            }
+
+            /* The packets are queued, not written. */
+            TEST_ASSERT_EQUAL( 0, _writeCount );
+            TEST_ASSERT_EQUAL( _transportBytes, pQueue->length );
+
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+            contextLocked = false;
+
+            /* The flush job writes the burst at once. */
+            TEST_ASSERT_EQUAL_INT( true, IotSemaphore_TimedWait( &writeSem, TIMEOUT_MS ) );
+            TEST_ASSERT_EQUAL( 1, _writeCount );
+            TEST_ASSERT_EQUAL( _transportBytes, _writeBytes );
+
+            /* A QoS 0 TimedPublish does not leave its packet queued. */
+            TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, IotMqtt_TimedPublish( _pMqttConnection, &publishInfo, 0, TIMEOUT_MS ) );
+            TEST_ASSERT_EQUAL( 0, pQueue->length );
+            TEST_ASSERT_EQUAL( 2, _writeCount );
+            TEST_ASSERT_EQUAL( _transportBytes, _writeBytes );
+        }
+
+        if( contextLocked == true )
+        {
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+        }
+
+        IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+        IotSemaphore_Destroy( &writeSem );
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a packet that does not fit in the transmit queue is written
+ * at once, in the same write as the packets queued before it.
+ */
+    TEST( MQTT_Unit_API, PublishCoalescedQueueFull )
+    {
+        int8_t contextIndex = -1;
+        bool contextLocked = false;
+        IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+        _mqttTransmitQueue_t * pQueue = NULL;
+
+        /* Two of these payloads fit in the queue, but not three. */
+        static const uint8_t pPayload[ ( IOT_MQTT_TRANSMIT_QUEUE_SIZE * 2U ) / 5U ] = { 0 };
+
+        /* Initialize parameters. */
+        _networkInterface.send = _sendCount;
+        _networkInterface.sendv = _sendvCount;
+        _writeCount = 0;
+        _writeBytes = 0;
+        _transportBytes = 0;
+
+        /* Create a new MQTT connection. */
+        _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                             &_networkInfo,
+                                                             0 );
+        TEST_ASSERT_NOT_NULL( _pMqttConnection );
+
+        /* Set the MQTT Context for the new MQTT Connection*/
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _setContext( _pMqttConnection, transportSend ) );
+        contextIndex = _IotMqtt_getContextIndexFromConnection( _pMqttConnection );
+        pQueue = &( connToContext[ contextIndex ].networkContext.transmitQueue );
+
+        publishInfo.pTopicName = TEST_TOPIC_NAME;
+        publishInfo.topicNameLength = TEST_TOPIC_NAME_LENGTH;
+        publishInfo.pPayload = pPayload;
+        publishInfo.payloadLength = ( uint32_t ) sizeof( pPayload );
+
+        if( TEST_PROTECT() )
+        {
+            /* Hold the context so that the flush job does not write the queue. */
+            contextLocked = IotMutex_TakeRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+            TEST_ASSERT_EQUAL_INT( true, contextLocked );
+
+            TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+            TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+            TEST_ASSERT_EQUAL( 0, _writeCount );
+            TEST_ASSERT_EQUAL( _transportBytes, pQueue->length );
+
+            /* The third payload is written with the queue in one vectored write. */
+            TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+            TEST_ASSERT_EQUAL( 1, _writeCount );
+            TEST_ASSERT_EQUAL( 0, pQueue->length );
+            TEST_ASSERT_EQUAL( _transportBytes, _writeBytes );
+            TEST_ASSERT_EQUAL_PTR( pPayload, _pSendvPayload );
+        }
+
+        if( contextLocked == true )
+        {
+            ( void ) IotMutex_GiveRecursive( &( connToContext[ contextIndex ].contextMutex ) );
+        }
+
+        IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+    }
+
+#endif /* if IOT_MQTT_ENABLE_TRANSMIT_COALESCING == 1 */
+
+/*-----------------------------------------------------------*/
+
+#if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0
+
+/**
+ * @brief Allowance for a timed wait that ends on an earlier clock tick.
+ */
+    #define CLOCK_TICK_SLACK_MS    ( 10U )
+
+/**
+ * @brief Tests that @ref mqtt_function_publish waits for a place in a full
+ * in-flight window, and times out if none is freed.
+ */
+    TEST( MQTT_Unit_API, PublishInFlightWindow )
+    {
+        int32_t i = 0;
+        uint64_t startTime = 0;
+        IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+        IotMqttOperation_t pPublishOperation[ IOT_MQTT_MAX_INFLIGHT_PUBLISHES ] = { IOT_MQTT_OPERATION_INITIALIZER };
+
+        /* Initialize parameters. */
+        _networkInterface.send = _sendSuccess;
+
+        /* Create a new MQTT connection. */
+        _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                             &_networkInfo,
+                                                             0 );
+        TEST_ASSERT_NOT_NULL( _pMqttConnection );
+
+        /* Set the MQTT Context for the new MQTT Connection*/
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _setContext( _pMqttConnection, transportSend ) );
+
+        publishInfo.qos = IOT_MQTT_QOS_1;
+        publishInfo.pTopicName = TEST_TOPIC_NAME;
+        publishInfo.topicNameLength = TEST_TOPIC_NAME_LENGTH;
+
+        if( TEST_PROTECT() )
+        {
+            /* Fill the window. No PUBACK is received, so the PUBLISH messages stay in flight. */
+            for( i = 0; i < IOT_MQTT_MAX_INFLIGHT_PUBLISHES; i++ )
+            {
+                TEST_ASSERT_EQUAL( IOT_MQTT_STATUS_PENDING,
+                                   IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, &( pPublishOperation[ i ] ) ) );
+            }
+
+            /* A PUBLISH into a full window times out. */
+            startTime = IotClock_GetTimeMs();
+            TEST_ASSERT_EQUAL( IOT_MQTT_TIMEOUT,
+                               IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+            TEST_ASSERT_TRUE( IotClock_GetTimeMs() - startTime + CLOCK_TICK_SLACK_MS >= IOT_MQTT_INFLIGHT_WAIT_MS );
+
+            /* A completed PUBLISH frees its place, which the timed-out PUBLISH
+             * did not take. */
+            _IotMqtt_ReleaseInFlight( pPublishOperation[ 0 ] );
+            TEST_ASSERT_EQUAL( IOT_MQTT_STATUS_PENDING,
+                               IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, &( pPublishOperation[ 0 ] ) ) );
+            TEST_ASSERT_EQUAL( IOT_MQTT_TIMEOUT,
+                               IotMqtt_Publish( _pMqttConnection, &publishInfo, 0, NULL, NULL ) );
+        }
+
+        IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+    }
+
+#endif /* if IOT_MQTT_MAX_INFLIGHT_PUBLISHES > 0 */
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Tests that duplicate QoS 1 PUBLISH packets are different from the
  * original.
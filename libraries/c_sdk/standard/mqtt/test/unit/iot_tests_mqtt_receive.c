@@ -482,6 +482,22 @@ static size_t _receive( void * pConnection,
 
 /*-----------------------------------------------------------*/
 
+#if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+
+/**
+ * @brief Simulates a network receiveUpto function.
+ */
+    static size_t _receiveUpto( void * pConnection,
+                                uint8_t * pBuffer,
+                                size_t bufferSize )
+    {
+        /* The simulated network returns whatever data is available. */
+        return _receive( pConnection, pBuffer, bufferSize );
+    }
+#endif
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief A network close function that reports if it was invoked.
  */
@@ -801,6 +817,9 @@ TEST_GROUP_RUNNER( MQTT_Unit_Receive )
     RUN_TEST_CASE( MQTT_Unit_Receive, UnsubackValid );
     RUN_TEST_CASE( MQTT_Unit_Receive, UnsubackInvalid );
     RUN_TEST_CASE( MQTT_Unit_Receive, Pingresp );
+    #if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+        RUN_TEST_CASE( MQTT_Unit_Receive, BufferedReceive );
+    #endif
 }
 
 /*-----------------------------------------------------------*/
@@ -1940,3 +1959,108 @@ TEST( MQTT_Unit_Receive, Pingresp )
 }
 
 /*-----------------------------------------------------------*/
+
+#if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1
+
+/**
+ * @brief Tests that the buffered receive path processes several packets read
+ * in one chunk, and keeps a partial packet until the rest of it arrives, also
+ * across callbacks that receive nothing.
+ */
+    TEST( MQTT_Unit_Receive, BufferedReceive )
+    {
+        IotSemaphore_t invokeCount;
+        _receiveContext_t receiveContext = { 0 };
+        int8_t contextIndex = _IotMqtt_getContextIndexFromConnection( _pMqttConnection );
+        const IotMqttSerializer_t * pSerializer = _pMqttConnection->pSerializer;
+        uint8_t pStream[ sizeof( _pPingrespTemplate ) + sizeof( _pPublishTemplate ) + sizeof( _pPingrespTemplate ) ] = { 0 };
+        const size_t publishOffset = sizeof( _pPingrespTemplate );
+        const size_t splitOffset = publishOffset + ( sizeof( _pPublishTemplate ) / 2 );
+
+        TEST_ASSERT_NOT_EQUAL( -1, contextIndex );
+        TEST_ASSERT_EQUAL_INT( true, IotSemaphore_Create( &invokeCount, 0, 2 ) );
+
+        /* Packet type and remaining length overrides disable the buffered path. */
+        _pMqttConnection->pSerializer = NULL;
+        _networkInterface.receiveUpto = _receiveUpto;
+        ( connToContext[ contextIndex ].subscriptionArray[ 0 ] ).callback.pCallbackContext = &invokeCount;
+
+        /* A PINGRESP, a QoS 0 PUBLISH and another PINGRESP back to back. */
+        ( void ) memcpy( pStream, _pPingrespTemplate, sizeof( _pPingrespTemplate ) );
+        ( void ) memcpy( pStream + publishOffset, _pPublishTemplate, sizeof( _pPublishTemplate ) );
+        ( void ) memcpy( pStream + publishOffset + sizeof( _pPublishTemplate ),
+                         _pPingrespTemplate,
+                         sizeof( _pPingrespTemplate ) );
+
+        /* All packets are processed by a single receive callback. The PUBLISH
+         * is copied out of the receive buffer and its callback runs on the
+         * task pool. */
+        {
+            receiveContext.pData = pStream;
+            receiveContext.dataLength = sizeof( pStream );
+            receiveContext.dataIndex = 0;
+
+            IotMqtt_ReceiveCallback( &receiveContext, _pMqttConnection );
+
+            TEST_ASSERT_EQUAL( sizeof( pStream ), receiveContext.dataIndex );
+            TEST_ASSERT_EQUAL( 0, connToContext[ contextIndex ].receiveTail );
+            TEST_ASSERT_EQUAL_INT( true, IotSemaphore_TimedWait( &invokeCount,
+                                                                 PUBLISH_CALLBACK_TIMEOUT ) );
+        }
+
+        /* A PUBLISH split across two receive callbacks is processed once complete. */
+        {
+            receiveContext.pData = pStream;
+            receiveContext.dataLength = splitOffset;
+            receiveContext.dataIndex = 0;
+
+            IotMqtt_ReceiveCallback( &receiveContext, _pMqttConnection );
+
+            TEST_ASSERT_EQUAL( 0, IotSemaphore_GetCount( &invokeCount ) );
+            TEST_ASSERT_EQUAL( splitOffset - publishOffset,
+                               connToContext[ contextIndex ].receiveTail - connToContext[ contextIndex ].receiveHead );
+
+            /* A callback that receives nothing, as TLS makes for records with
+             * no application data, keeps the connection and the partial packet. */
+            IotMqtt_ReceiveCallback( &receiveContext, _pMqttConnection );
+
+            TEST_ASSERT_EQUAL_INT( false, _networkCloseCalled );
+            TEST_ASSERT_EQUAL_INT( false, _disconnectCallbackCalled );
+            TEST_ASSERT_EQUAL( 0, IotSemaphore_GetCount( &invokeCount ) );
+            TEST_ASSERT_EQUAL( splitOffset - publishOffset,
+                               connToContext[ contextIndex ].receiveTail - connToContext[ contextIndex ].receiveHead );
+
+            receiveContext.dataLength = sizeof( pStream );
+
+            IotMqtt_ReceiveCallback( &receiveContext, _pMqttConnection );
+
+            TEST_ASSERT_EQUAL( 0, connToContext[ contextIndex ].receiveTail );
+            TEST_ASSERT_EQUAL_INT( true, IotSemaphore_TimedWait( &invokeCount,
+                                                                 PUBLISH_CALLBACK_TIMEOUT ) );
+        }
+
+        /* An invalid packet type closes the connection. */
+        {
+            pStream[ 0 ] = 0x00;
+            receiveContext.pData = pStream;
+            receiveContext.dataLength = sizeof( pStream );
+            receiveContext.dataIndex = 0;
+
+            IotMqtt_ReceiveCallback( &receiveContext, _pMqttConnection );
+
+            TEST_ASSERT_EQUAL_INT( true, _networkCloseCalled );
+            TEST_ASSERT_EQUAL_INT( true, _disconnectCallbackCalled );
+            TEST_ASSERT_EQUAL( 0, connToContext[ contextIndex ].receiveTail );
+        }
+
+        IotSemaphore_Destroy( &invokeCount );
+
+        /* Restore the overrides; the tear down checks that they were used. */
+        _networkInterface.receiveUpto = NULL;
+        _pMqttConnection->pSerializer = pSerializer;
+        _getPacketTypeCalled = true;
+        _getRemainingLengthCalled = true;
+    }
+#endif /* if IOT_MQTT_ENABLE_BUFFERED_RECEIVE == 1 */
+
+/*-----------------------------------------------------------*/
@@ -106,6 +106,32 @@ extern _connContext_t connToContext[ MAX_NO_OF_MQTT_CONNECTIONS ];
  */
 #define TOPIC_FILTER_MATCH_MAX_LENGTH    ( 32 )
 
+/*
+ * Constants relating to the topic-filter trie tests.
+ */
+#define TRIE_FILTER_COUNT    ( 8 )  /**< @brief Number of subscriptions in the trie test. */
+#define TRIE_NODE_COUNT      ( 24 ) /**< @brief Number of nodes in the trie test. */
+
+/**
+ * @brief Macro to check the subscriptions of a topic-filter trie that match a
+ * topic name.
+ *
+ * @param[in] topicNameString The topic name to check.
+ * @param[in] expectedMatches Bitmap of the subscriptions expected to match.
+ *
+ * @note This macro may only be used when a #_mqttTopicTrie_t named trie is in scope.
+ */
+#define TEST_TRIE_MATCH( topicNameString, expectedMatches )                                  \
+    {                                                                                        \
+        uint32_t _matches[ IOT_MQTT_TOPIC_TRIE_BITMAP_WORDS( TRIE_FILTER_COUNT ) ] = { 0 };  \
+                                                                                             \
+        ( void ) IotMqtt_TopicTrieMatch( &trie,                                              \
+                                         topicNameString,                                    \
+                                         ( uint16_t ) strlen( topicNameString ),             \
+                                         _matches );                                         \
+        TEST_ASSERT_EQUAL_HEX32( expectedMatches, _matches[ 0 ] );                           \
+    }
+
 /**
  * @brief Macro to check a single topic name against a topic filter.
  *
@@ -600,6 +626,7 @@ TEST_GROUP_RUNNER( MQTT_Unit_Subscription )
     RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionReferences );
     RUN_TEST_CASE( MQTT_Unit_Subscription, TopicFilterMatchTrue );
     RUN_TEST_CASE( MQTT_Unit_Subscription, TopicFilterMatchFalse );
+    RUN_TEST_CASE( MQTT_Unit_Subscription, TopicTrie );
 }
 
 /*-----------------------------------------------------------*/
@@ -1284,3 +1311,111 @@ TEST( MQTT_Unit_Subscription, TopicFilterMatchFalse )
 }
 
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests adding, finding, matching, and removing topic filters in a
+ * topic-filter trie.
+ */
+TEST( MQTT_Unit_Subscription, TopicTrie )
+{
+    static const char * const pTopicFilters[] =
+    {
+        "/aws/+",         /* 0 */
+        "aws/+/shadow/#", /* 1 */
+        "aws/iot/#",      /* 2 */
+        "#",              /* 3 */
+        "aws/iot",        /* 4 */
+        "+/+",            /* 5 */
+        "aws//+"          /* 6 */
+    };
+    const size_t topicFilterCount = sizeof( pTopicFilters ) / sizeof( pTopicFilters[ 0 ] );
+    char topicFilterBuffers[ TRIE_FILTER_COUNT ][ TOPIC_FILTER_MATCH_MAX_LENGTH ] = { { 0 } };
+    _mqttSubscription_t subscriptions[ TRIE_FILTER_COUNT ] = { 0 };
+    _mqttTopicTrieNode_t nodes[ TRIE_NODE_COUNT ] = { 0 };
+    _mqttTopicTrie_t trie = { 0 };
+    _mqttTopicTrie_t fullTrie = { 0 };
+    size_t i = 0;
+
+    trie.pNodes = nodes;
+    trie.nodeCount = TRIE_NODE_COUNT;
+    trie.pSubscriptionArray = subscriptions;
+
+    for( i = 0; i < topicFilterCount; i++ )
+    {
+        subscriptions[ i ].pTopicFilter = topicFilterBuffers[ i ];
+        subscriptions[ i ].topicFilterLength = ( uint16_t ) snprintf( topicFilterBuffers[ i ],
+                                                                      TOPIC_FILTER_MATCH_MAX_LENGTH,
+                                                                      "%s",
+                                                                      pTopicFilters[ i ] );
+        TEST_ASSERT_TRUE( IotMqtt_TopicTrieInsert( &trie, ( uint16_t ) i ) );
+    }
+
+    /* Topic filters are found exactly, including wildcards. */
+    for( i = 0; i < topicFilterCount; i++ )
+    {
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) i,
+                                 IotMqtt_TopicTrieFind( &trie,
+                                                        pTopicFilters[ i ],
+                                                        ( uint16_t ) strlen( pTopicFilters[ i ] ) ) );
+    }
+
+    TEST_ASSERT_EQUAL_INT32( -1, IotMqtt_TopicTrieFind( &trie, "aws/+/shadow", 12 ) );
+    TEST_ASSERT_EQUAL_INT32( -1, IotMqtt_TopicTrieFind( &trie, "aws/thing", 9 ) );
+
+    /* Wildcard matching. */
+    TEST_TRIE_MATCH( "aws/iot", 0x3c );
+    TEST_TRIE_MATCH( "/aws/iot", 0x09 );
+    TEST_TRIE_MATCH( "aws/iot/shadow/thing", 0x0e );
+    TEST_TRIE_MATCH( "aws/thing/shadow", 0x0a );
+    TEST_TRIE_MATCH( "aws//iot", 0x48 );
+    TEST_TRIE_MATCH( "aws/", 0x28 );
+    TEST_TRIE_MATCH( "sport", 0x08 );
+
+    /* A topic filter that does not fit in the free nodes is not added. */
+    fullTrie = trie;
+    fullTrie.nodeCount = 2;
+    subscriptions[ 7 ].pTopicFilter = topicFilterBuffers[ 7 ];
+    subscriptions[ 7 ].topicFilterLength = ( uint16_t ) snprintf( topicFilterBuffers[ 7 ],
+                                                                  TOPIC_FILTER_MATCH_MAX_LENGTH,
+                                                                  "sport/tennis" );
+    TEST_ASSERT_FALSE( IotMqtt_TopicTrieInsert( &fullTrie, 7 ) );
+    TEST_ASSERT_EQUAL_INT32( -1, IotMqtt_TopicTrieFind( &trie, "sport/tennis", 12 ) );
+    TEST_TRIE_MATCH( "sport/tennis", 0x28 );
+
+    /* Remove topic filters, then overwrite them. The trie must no longer
+     * reference their memory, even for levels shared with other filters. */
+    IotMqtt_TopicTrieRemove( &trie, 1 );
+    IotMqtt_TopicTrieRemove( &trie, 3 );
+    IotMqtt_TopicTrieRemove( &trie, 4 );
+    ( void ) memset( topicFilterBuffers[ 1 ], 'x', subscriptions[ 1 ].topicFilterLength );
+    ( void ) memset( topicFilterBuffers[ 3 ], 'x', subscriptions[ 3 ].topicFilterLength );
+    ( void ) memset( topicFilterBuffers[ 4 ], 'x', subscriptions[ 4 ].topicFilterLength );
+
+    TEST_TRIE_MATCH( "aws/iot", 0x24 );
+    TEST_TRIE_MATCH( "aws/iot/shadow/thing", 0x04 );
+    TEST_TRIE_MATCH( "aws/thing/shadow", 0x00 );
+    TEST_TRIE_MATCH( "aws//iot", 0x40 );
+    TEST_ASSERT_EQUAL_INT32( 2, IotMqtt_TopicTrieFind( &trie, "aws/iot/#", 9 ) );
+
+    /* Removing a subscription that is not in the trie does nothing. */
+    IotMqtt_TopicTrieRemove( &trie, 7 );
+    TEST_TRIE_MATCH( "aws/iot", 0x24 );
+
+    /* Removing every topic filter frees every node. */
+    IotMqtt_TopicTrieRemove( &trie, 0 );
+    IotMqtt_TopicTrieRemove( &trie, 2 );
+    IotMqtt_TopicTrieRemove( &trie, 5 );
+    IotMqtt_TopicTrieRemove( &trie, 6 );
+    TEST_TRIE_MATCH( "aws/iot", 0x00 );
+
+    for( i = 0; i < TRIE_NODE_COUNT; i++ )
+    {
+        TEST_ASSERT_EQUAL_UINT16( 0, nodes[ i ].references );
+    }
+
+    TEST_ASSERT_EQUAL_UINT16( 0, nodes[ 0 ].firstChild );
+    TEST_ASSERT_EQUAL_UINT16( 0, nodes[ 0 ].plusChild );
+    TEST_ASSERT_EQUAL_UINT16( 0, nodes[ 0 ].hashChild );
+}
+
+/*-----------------------------------------------------------*/
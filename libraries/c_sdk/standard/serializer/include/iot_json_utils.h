@@ -34,6 +34,34 @@
 /* Standard includes. */
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A token of a JSON document in a structural index.
+ *
+ * The tokens of a document are stored in document order, so a container is
+ * followed by its children and a map key by its value.
+ */
+typedef struct IotJsonToken
+{
+    uint32_t start;   /**< @brief Offset of the first character of the token. */
+    uint32_t end;     /**< @brief Offset one past the token, including closing quotes and brackets. */
+    uint32_t next;    /**< @brief Index of the token following this token and its children. */
+    uint32_t keyHash; /**< @brief Hash of the characters of a map key; 0 for other tokens. */
+} IotJsonToken_t;
+
+/**
+ * @brief A structural index of a JSON document, built by @ref IotJsonUtils_BuildIndex.
+ *
+ * Token 0 is the outermost object or array of the document.
+ */
+typedef struct IotJsonIndex
+{
+    const char * pJsonDocument; /**< @brief The indexed document. */
+    size_t jsonDocumentLength;  /**< @brief Length of the indexed document. */
+    IotJsonToken_t * pTokens;   /**< @brief Tokens of the document, in an array supplied by the caller. */
+    size_t tokenCount;          /**< @brief Number of tokens in the document. */
+} IotJsonIndex_t;
 
 bool IotJsonUtils_FindJsonValue( const char * pJsonDocument,
                                  size_t jsonDocumentLength,
@@ -42,4 +70,47 @@ bool IotJsonUtils_FindJsonValue( const char * pJsonDocument,
                                  const char ** pJsonValue,
                                  size_t * pJsonValueLength );
 
+/**
+ * @brief Index the tokens of a JSON document in one pass.
+ *
+ * The document is scanned a word at a time for quotes, brackets and delimiters.
+ * Once built, keys are looked up with @ref IotJsonUtils_FindIndexedValue without
+ * scanning the document again.
+ *
+ * @param[out] pIndex The index to build.
+ * @param[in] pJsonDocument The JSON document, which must start with an object or array.
+ * @param[in] jsonDocumentLength Length of pJsonDocument. Characters after the
+ * outermost object or array are ignored.
+ * @param[in] pTokens Array to hold the tokens of the document.
+ * @param[in] maxTokens Number of elements in pTokens.
+ *
+ * @return `true` if the document was indexed; `false` if it is malformed or
+ * has more than maxTokens tokens.
+ */
+bool IotJsonUtils_BuildIndex( IotJsonIndex_t * pIndex,
+                              const char * pJsonDocument,
+                              size_t jsonDocumentLength,
+                              IotJsonToken_t * pTokens,
+                              size_t maxTokens );
+
+/**
+ * @brief Find the value of a key in an object of an indexed JSON document.
+ *
+ * Only the keys of the given object are searched, not those of nested objects.
+ *
+ * @param[in] pIndex Index built by @ref IotJsonUtils_BuildIndex.
+ * @param[in] objectToken Index of the token of the object to search.
+ * @param[in] pJsonKey The key to find.
+ * @param[in] jsonKeyLength Length of pJsonKey.
+ * @param[out] pValueToken Set to the index of the token of the value if found.
+ * The value starts at `pIndex->pJsonDocument + pIndex->pTokens[ *pValueToken ].start`.
+ *
+ * @return `true` if the key was found; `false` otherwise.
+ */
+bool IotJsonUtils_FindIndexedValue( const IotJsonIndex_t * pIndex,
+                                    size_t objectToken,
+                                    const char * pJsonKey,
+                                    size_t jsonKeyLength,
+                                    size_t * pValueToken );
+
 #endif /* ifndef IOT_JSON_UTILS_H_ */
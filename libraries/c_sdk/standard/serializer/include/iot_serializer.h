@@ -40,6 +40,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* JSON utilities include. */
+#include "iot_json_utils.h"
+
 #if IOT_SERIALIZER_ENABLE_ASSERTS == 1
     #ifndef IotSerializer_Assert
         #include <assert.h>
@@ -453,4 +456,30 @@ extern IotSerializerEncodeInterface_t _IotSerializerJsonEncoder;
 
 extern IotSerializerDecodeInterface_t _IotSerializerJsonDecoder;
 
+/**
+ * @brief Initialize a JSON decoder object and index the structure of the document.
+ *
+ * Once the document is indexed, `find`, `stepIn`, `next` and `get` of
+ * #_IotSerializerJsonDecoder look up the index instead of parsing the document
+ * again. This pays off when many keys are looked up in the same document. If the
+ * document has more tokens than maxTokens, the decoder object is initialized as
+ * with `init`, without an index.
+ *
+ * @param[out] pDecoderObject Pointer to the decoder object allocated by user.
+ * @param[in] pDataBuffer Pointer to the buffer containing data to be decoded.
+ * @param[in] maxSize Maximum length of the buffer containing data to be decoded.
+ * @param[out] pIndex Index to build. It must remain valid until all the decoder
+ * objects of the document are destroyed.
+ * @param[in] pTokens Array to hold the tokens of the document, allocated by user.
+ * Each string, number, literal and container of the document takes a token.
+ * @param[in] maxTokens Number of elements in pTokens.
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+IotSerializerError_t IotSerializer_JsonDecoderInitIndexed( IotSerializerDecoderObject_t * pDecoderObject,
+                                                           const uint8_t * pDataBuffer,
+                                                           size_t maxSize,
+                                                           IotJsonIndex_t * pIndex,
+                                                           IotJsonToken_t * pTokens,
+                                                           size_t maxTokens );
+
 #endif /* ifndef IOT_SERIALIZER_H_ */
@@ -37,6 +37,61 @@
 /* JSON utilities include. */
 #include "iot_json_utils.h"
 
+/**
+ * @brief Marks the parent of the outermost container while building an index.
+ */
+#define JSON_INDEX_NO_TOKEN    ( UINT32_MAX )
+
+/**
+ * @brief Word-at-a-time byte tests, with a 32-bit word.
+ *
+ * These are exact: a word tests non-zero if and only if one of its bytes matches.
+ */
+#define JSON_WORD_ONES                 ( 0x01010101UL )
+#define JSON_WORD_HIGHS                ( 0x80808080UL )
+#define JSON_WORD_HAS_ZERO( word )     ( ( ( word ) - JSON_WORD_ONES ) & ~( word ) & JSON_WORD_HIGHS )
+#define JSON_WORD_HAS_BYTE( word, c )  JSON_WORD_HAS_ZERO( ( word ) ^ ( JSON_WORD_ONES * ( uint8_t ) ( c ) ) )
+#define JSON_WORD_HAS_LESS( word, n )  ( ( ( word ) - ( JSON_WORD_ONES * ( n ) ) ) & ~( word ) & JSON_WORD_HIGHS )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the closing quote of a JSON string.
+ *
+ * @param[in] pJsonDocument The JSON document.
+ * @param[in] jsonDocumentLength Length of the document.
+ * @param[in] offset Offset of the first character after the opening quote.
+ *
+ * @return Offset of the closing quote; jsonDocumentLength if there is none.
+ */
+static size_t _findStringEnd( const char * pJsonDocument,
+                              size_t jsonDocumentLength,
+                              size_t offset );
+
+/**
+ * @brief Find the end of a JSON number, boolean or null.
+ *
+ * @param[in] pJsonDocument The JSON document.
+ * @param[in] jsonDocumentLength Length of the document.
+ * @param[in] offset Offset of the first character of the value.
+ *
+ * @return Offset one past the value.
+ */
+static size_t _findPrimitiveEnd( const char * pJsonDocument,
+                                 size_t jsonDocumentLength,
+                                 size_t offset );
+
+/**
+ * @brief Hash the characters of a JSON key.
+ *
+ * @param[in] pKey The key, without quotes.
+ * @param[in] keyLength Length of the key.
+ *
+ * @return FNV-1a hash of the key.
+ */
+static uint32_t _hashKey( const char * pKey,
+                          size_t keyLength );
+
 /*-----------------------------------------------------------*/
 
 bool IotJsonUtils_FindJsonValue( const char * pJsonDocument,
@@ -258,3 +313,310 @@ bool IotJsonUtils_FindJsonValue( const char * pJsonDocument,
 }
 
 /*-----------------------------------------------------------*/
+
+static size_t _findStringEnd( const char * pJsonDocument,
+                              size_t jsonDocumentLength,
+                              size_t offset )
+{
+    uint32_t word = 0;
+
+    while( offset < jsonDocumentLength )
+    {
+        /* Skip the characters of the string that are neither a quote nor an escape,
+         * a word at a time. */
+        while( offset + sizeof( word ) <= jsonDocumentLength )
+        {
+            ( void ) memcpy( &word, pJsonDocument + offset, sizeof( word ) );
+
+            if( ( JSON_WORD_HAS_BYTE( word, '\"' ) | JSON_WORD_HAS_BYTE( word, '\\' ) ) != 0 )
+            {
+                break;
+            }
+
+            offset += sizeof( word );
+        }
+
+        /* Find the quote or escape in the word. */
+        while( ( offset < jsonDocumentLength ) &&
+               ( pJsonDocument[ offset ] != '\"' ) &&
+               ( pJsonDocument[ offset ] != '\\' ) )
+        {
+            offset++;
+        }
+
+        if( ( offset < jsonDocumentLength ) && ( pJsonDocument[ offset ] == '\\' ) )
+        {
+            /* Skip the escape and the escaped character. */
+            offset += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return ( offset < jsonDocumentLength ) ? offset : jsonDocumentLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _findPrimitiveEnd( const char * pJsonDocument,
+                                 size_t jsonDocumentLength,
+                                 size_t offset )
+{
+    uint32_t word = 0;
+
+    /* A primitive ends with a delimiter, a closing bracket or whitespace. */
+    while( offset + sizeof( word ) <= jsonDocumentLength )
+    {
+        ( void ) memcpy( &word, pJsonDocument + offset, sizeof( word ) );
+
+        if( ( JSON_WORD_HAS_BYTE( word, ',' ) |
+              JSON_WORD_HAS_BYTE( word, '}' ) |
+              JSON_WORD_HAS_BYTE( word, ']' ) |
+              JSON_WORD_HAS_LESS( word, 0x21UL ) ) != 0 )
+        {
+            break;
+        }
+
+        offset += sizeof( word );
+    }
+
+    while( ( offset < jsonDocumentLength ) &&
+           ( pJsonDocument[ offset ] != ',' ) &&
+           ( pJsonDocument[ offset ] != '}' ) &&
+           ( pJsonDocument[ offset ] != ']' ) &&
+           ( ( uint8_t ) pJsonDocument[ offset ] > ( uint8_t ) ' ' ) )
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t _hashKey( const char * pKey,
+                          size_t keyLength )
+{
+    uint32_t hash = 2166136261UL;
+    size_t i = 0;
+
+    for( i = 0; i < keyLength; i++ )
+    {
+        hash ^= ( uint8_t ) pKey[ i ];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotJsonUtils_BuildIndex( IotJsonIndex_t * pIndex,
+                              const char * pJsonDocument,
+                              size_t jsonDocumentLength,
+                              IotJsonToken_t * pTokens,
+                              size_t maxTokens )
+{
+    bool status = true, complete = false, expectKey = false;
+    size_t i = 0, tokenCount = 0;
+    uint32_t openToken = JSON_INDEX_NO_TOKEN, parentToken = 0;
+    char closeCharacter = '\0';
+    IotJsonToken_t * pToken = NULL;
+
+    /* Offsets are stored in 32 bits. */
+    if( jsonDocumentLength >= JSON_INDEX_NO_TOKEN )
+    {
+        status = false;
+    }
+
+    while( ( status == true ) && ( complete == false ) && ( i < jsonDocumentLength ) )
+    {
+        switch( pJsonDocument[ i ] )
+        {
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+            case ':':
+                i++;
+                break;
+
+            case ',':
+                /* In an object, a key follows a comma. */
+                expectKey = ( openToken != JSON_INDEX_NO_TOKEN ) &&
+                            ( pJsonDocument[ pTokens[ openToken ].start ] == '{' );
+                i++;
+                break;
+
+            case '{':
+            case '[':
+
+                if( tokenCount == maxTokens )
+                {
+                    status = false;
+                }
+                else
+                {
+                    /* While a container is open, its next token links to its parent. */
+                    pToken = &( pTokens[ tokenCount ] );
+                    pToken->start = ( uint32_t ) i;
+                    pToken->keyHash = 0;
+                    pToken->next = openToken;
+                    openToken = ( uint32_t ) tokenCount;
+                    tokenCount++;
+
+                    expectKey = ( pJsonDocument[ i ] == '{' );
+                    i++;
+                }
+
+                break;
+
+            case '}':
+            case ']':
+
+                if( openToken != JSON_INDEX_NO_TOKEN )
+                {
+                    closeCharacter = ( pJsonDocument[ pTokens[ openToken ].start ] == '{' ) ? '}' : ']';
+                }
+
+                if( ( openToken == JSON_INDEX_NO_TOKEN ) || ( pJsonDocument[ i ] != closeCharacter ) )
+                {
+                    status = false;
+                }
+                else
+                {
+                    /* Close the container; its next token is the one after its children. */
+                    pToken = &( pTokens[ openToken ] );
+                    parentToken = pToken->next;
+                    pToken->end = ( uint32_t ) ( i + 1 );
+                    pToken->next = ( uint32_t ) tokenCount;
+                    openToken = parentToken;
+
+                    expectKey = false;
+                    complete = ( openToken == JSON_INDEX_NO_TOKEN );
+                    i++;
+                }
+
+                break;
+
+            default:
+
+                /* The document must start with an object or array. */
+                if( ( openToken == JSON_INDEX_NO_TOKEN ) || ( tokenCount == maxTokens ) )
+                {
+                    status = false;
+                }
+                else
+                {
+                    pToken = &( pTokens[ tokenCount ] );
+                    pToken->start = ( uint32_t ) i;
+                    pToken->keyHash = 0;
+                    pToken->next = ( uint32_t ) ( tokenCount + 1 );
+                    tokenCount++;
+
+                    if( pJsonDocument[ i ] == '\"' )
+                    {
+                        i = _findStringEnd( pJsonDocument, jsonDocumentLength, i + 1 );
+
+                        if( i == jsonDocumentLength )
+                        {
+                            /* Unterminated string. */
+                            status = false;
+                        }
+                        else
+                        {
+                            /* Skip the closing quote. */
+                            i++;
+
+                            if( expectKey == true )
+                            {
+                                pToken->keyHash = _hashKey( pJsonDocument + pToken->start + 1,
+                                                            i - pToken->start - 2 );
+                            }
+                        }
+                    }
+                    else
+                    {
+                        i = _findPrimitiveEnd( pJsonDocument, jsonDocumentLength, i );
+                    }
+
+                    pToken->end = ( uint32_t ) i;
+                    expectKey = false;
+                }
+
+                break;
+        }
+    }
+
+    if( ( status == true ) && ( complete == true ) )
+    {
+        pIndex->pJsonDocument = pJsonDocument;
+        pIndex->jsonDocumentLength = jsonDocumentLength;
+        pIndex->pTokens = pTokens;
+        pIndex->tokenCount = tokenCount;
+    }
+    else
+    {
+        status = false;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotJsonUtils_FindIndexedValue( const IotJsonIndex_t * pIndex,
+                                    size_t objectToken,
+                                    const char * pJsonKey,
+                                    size_t jsonKeyLength,
+                                    size_t * pValueToken )
+{
+    bool found = false;
+    const IotJsonToken_t * pTokens = pIndex->pTokens;
+    const IotJsonToken_t * pKeyToken = NULL;
+    size_t keyToken = objectToken + 1, valueToken = 0, endToken = 0;
+    uint32_t keyHash = _hashKey( pJsonKey, jsonKeyLength );
+
+    if( ( objectToken < pIndex->tokenCount ) &&
+        ( pIndex->pJsonDocument[ pTokens[ objectToken ].start ] == '{' ) )
+    {
+        endToken = pTokens[ objectToken ].next;
+
+        /* Visit the keys of the object, skipping over the values. */
+        while( ( found == false ) && ( keyToken < endToken ) )
+        {
+            pKeyToken = &( pTokens[ keyToken ] );
+            valueToken = pKeyToken->next;
+
+            if( valueToken >= endToken )
+            {
+                /* A key without a value. */
+                break;
+            }
+
+            if( ( pKeyToken->keyHash == keyHash ) &&
+                ( pKeyToken->end - pKeyToken->start == jsonKeyLength + 2 ) &&
+                ( strncmp( pIndex->pJsonDocument + pKeyToken->start + 1,
+                           pJsonKey,
+                           jsonKeyLength ) == 0 ) )
+            {
+                found = true;
+
+                if( pValueToken != NULL )
+                {
+                    *pValueToken = valueToken;
+                }
+            }
+            else
+            {
+                keyToken = pTokens[ valueToken ].next;
+            }
+        }
+    }
+
+    return found;
+}
+
+/*-----------------------------------------------------------*/
@@ -90,34 +90,59 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _inUseCborEncoders[ IOT_SERIALIZER_CBOR_ENCODERS ] = { 0 };
+    static uint32_t _inUseCborEncoders[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_SERIALIZER_CBOR_ENCODERS ) ] = { 0 };
     static CborEncoder _cborEncoders[ IOT_SERIALIZER_CBOR_ENCODERS ] = { { .data = { 0 } } };
 
-    static bool _inUseCborParsers[ IOT_SERIALIZER_CBOR_PARSERS ] = { 0 };
+    static uint32_t _inUseCborParsers[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_SERIALIZER_CBOR_PARSERS ) ] = { 0 };
     static CborParser _cborParsers[ IOT_SERIALIZER_CBOR_PARSERS ] = { { 0 } };
 
-    static bool _inUseCborValues[ IOT_SERIALIZER_CBOR_VALUES ] = { 0 };
+    static uint32_t _inUseCborValues[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_SERIALIZER_CBOR_VALUES ) ] = { 0 };
     static _cborValueWrapper_t _cborValues[ IOT_SERIALIZER_CBOR_VALUES ] = { { .isOutermost = false } };
 
-    static bool _inUseDecoderObjects[ IOT_SERIALIZER_DECODER_OBJECTS ] = { 0 };
+    static uint32_t _inUseDecoderObjects[ IOT_STATIC_MEMORY_SLAB_WORDS( IOT_SERIALIZER_DECODER_OBJECTS ) ] = { 0 };
     static IotSerializerDecoderObject_t _decoderObjects[ IOT_SERIALIZER_DECODER_OBJECTS ] = { { 0 } };
 
+/**
+ * @brief Allocator of CBOR encoders.
+ */
+    static IotStaticMemorySlab_t _cborEncoderSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _cborEncoders,
+                                                                                        _inUseCborEncoders,
+                                                                                        sizeof( CborEncoder ),
+                                                                                        IOT_SERIALIZER_CBOR_ENCODERS );
+
+/**
+ * @brief Allocator of CBOR parsers.
+ */
+    static IotStaticMemorySlab_t _cborParserSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _cborParsers,
+                                                                                       _inUseCborParsers,
+                                                                                       sizeof( CborParser ),
+                                                                                       IOT_SERIALIZER_CBOR_PARSERS );
+
+/**
+ * @brief Allocator of CBOR values.
+ */
+    static IotStaticMemorySlab_t _cborValueSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _cborValues,
+                                                                                      _inUseCborValues,
+                                                                                      sizeof( _cborValueWrapper_t ),
+                                                                                      IOT_SERIALIZER_CBOR_VALUES );
+
+/**
+ * @brief Allocator of decoder objects.
+ */
+    static IotStaticMemorySlab_t _decoderObjectSlab = IOT_STATIC_MEMORY_SLAB_INITIALIZER( _decoderObjects,
+                                                                                          _inUseDecoderObjects,
+                                                                                          sizeof( IotSerializerDecoderObject_t ),
+                                                                                          IOT_SERIALIZER_DECODER_OBJECTS );
+
 /*-----------------------------------------------------------*/
 
     void * IotSerializer_MallocCborEncoder( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewCborEncoder = NULL;
 
         if( size == sizeof( CborEncoder ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborEncoders,
-                                                  IOT_SERIALIZER_CBOR_ENCODERS );
-
-            if( freeIndex != -1 )
-            {
-                pNewCborEncoder = &( _cborEncoders[ freeIndex ] );
-            }
+            pNewCborEncoder = IotStaticMemory_SlabAllocate( &( _cborEncoderSlab ) );
         }
 
         return pNewCborEncoder;
@@ -127,29 +152,18 @@
 
     void IotSerializer_FreeCborEncoder( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborEncoders,
-                                     _inUseCborEncoders,
-                                     IOT_SERIALIZER_CBOR_ENCODERS,
-                                     sizeof( CborEncoder ) );
+        ( void ) IotStaticMemory_SlabFree( &( _cborEncoderSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * IotSerializer_MallocCborParser( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewCborParser = NULL;
 
         if( size == sizeof( CborParser ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborParsers,
-                                                  IOT_SERIALIZER_CBOR_PARSERS );
-
-            if( freeIndex != -1 )
-            {
-                pNewCborParser = &( _cborParsers[ freeIndex ] );
-            }
+            pNewCborParser = IotStaticMemory_SlabAllocate( &( _cborParserSlab ) );
         }
 
         return pNewCborParser;
@@ -159,29 +173,18 @@
 
     void IotSerializer_FreeCborParser( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborParsers,
-                                     _inUseCborParsers,
-                                     IOT_SERIALIZER_CBOR_PARSERS,
-                                     sizeof( CborParser ) );
+        ( void ) IotStaticMemory_SlabFree( &( _cborParserSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * IotSerializer_MallocCborValue( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewCborValue = NULL;
 
         if( size == sizeof( _cborValueWrapper_t ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborValues,
-                                                  IOT_SERIALIZER_CBOR_VALUES );
-
-            if( freeIndex != -1 )
-            {
-                pNewCborValue = &( _cborValues[ freeIndex ] );
-            }
+            pNewCborValue = IotStaticMemory_SlabAllocate( &( _cborValueSlab ) );
         }
 
         return pNewCborValue;
@@ -191,29 +194,18 @@
 
     void IotSerializer_FreeCborValue( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborValues,
-                                     _inUseCborValues,
-                                     IOT_SERIALIZER_CBOR_VALUES,
-                                     sizeof( _cborValueWrapper_t ) );
+        ( void ) IotStaticMemory_SlabFree( &( _cborValueSlab ), ptr );
     }
 
 /*-----------------------------------------------------------*/
 
     void * IotSerializer_MallocDecoderObject( size_t size )
     {
-        int32_t freeIndex = -1;
         void * pNewDecoderObject = NULL;
 
         if( size == sizeof( IotSerializerDecoderObject_t ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseDecoderObjects,
-                                                  IOT_SERIALIZER_DECODER_OBJECTS );
-
-            if( freeIndex != -1 )
-            {
-                pNewDecoderObject = &( _decoderObjects[ freeIndex ] );
-            }
+            pNewDecoderObject = IotStaticMemory_SlabAllocate( &( _decoderObjectSlab ) );
         }
 
         return pNewDecoderObject;
@@ -223,11 +215,7 @@
 
     void IotSerializer_FreeDecoderObject( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _decoderObjects,
-                                     _inUseDecoderObjects,
-                                     IOT_SERIALIZER_DECODER_OBJECTS,
-                                     sizeof( IotSerializerDecoderObject_t ) );
+        ( void ) IotStaticMemory_SlabFree( &( _decoderObjectSlab ), ptr );
     }
 
 #endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
@@ -101,6 +101,9 @@ typedef struct _jsonContainer
 {
     const char * pStart;
     size_t length;
+    const IotJsonIndex_t * pIndex; /* Structural index of the document; NULL if not indexed. */
+    size_t token;                  /* Token of the container, or the current token of an iterator. */
+    size_t endToken;               /* Token following the children of the container. */
 } _jsonContainer_t;
 
 /*-----------------------------------------------------------*/
@@ -166,6 +169,9 @@ static _jsonContainer_t * _createContainer( const char * pBuffer,
     {
         pContainer->pStart = pBuffer;
         pContainer->length = length;
+        pContainer->pIndex = NULL;
+        pContainer->token = 0;
+        pContainer->endToken = 0;
     }
 
     return pContainer;
@@ -173,6 +179,50 @@ static _jsonContainer_t * _createContainer( const char * pBuffer,
 
 /*-----------------------------------------------------------*/
 
+static _jsonContainer_t * _createIndexedContainer( const IotJsonIndex_t * pIndex,
+                                                   size_t token )
+{
+    const IotJsonToken_t * pToken = &( pIndex->pTokens[ token ] );
+
+    /* Like a parsed container, start past the opening character and include the closing one. */
+    _jsonContainer_t * pContainer = _createContainer( pIndex->pJsonDocument + pToken->start + 1,
+                                                      pToken->end - pToken->start - 1 );
+
+    if( pContainer != NULL )
+    {
+        pContainer->pIndex = pIndex;
+        pContainer->token = token;
+        pContainer->endToken = pToken->next;
+    }
+
+    return pContainer;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _moveIndexedIterator( _jsonContainer_t * pIterator,
+                                  size_t token )
+{
+    /* The iterator always extends to the end of its container. */
+    const char * pEnd = pIterator->pStart + pIterator->length;
+
+    pIterator->token = token;
+
+    if( token < pIterator->endToken )
+    {
+        pIterator->pStart = pIterator->pIndex->pJsonDocument + pIterator->pIndex->pTokens[ token ].start;
+    }
+    else
+    {
+        /* Past the last child, point at the closing character of the container. */
+        pIterator->pStart = pEnd - 1;
+    }
+
+    pIterator->length = ( size_t ) ( pEnd - pIterator->pStart );
+}
+
+/*-----------------------------------------------------------*/
+
 static void _skipWhiteSpacesAndDelimeters( const char * pBuffer,
                                            const size_t bufLength,
                                            size_t * pOffset )
@@ -536,6 +586,61 @@ static IotSerializerError_t _findKeyValue( _jsonContainer_t * pObject,
     return ret;
 }
 
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _parseIndexedTokenValue( const IotJsonIndex_t * pIndex,
+                                                     size_t token,
+                                                     IotSerializerDecoderObject_t * pValue )
+{
+    const IotJsonToken_t * pToken = &( pIndex->pTokens[ token ] );
+    size_t offset = pToken->start;
+    IotSerializerDataType_t tokenType = _getTokenType( pIndex->pJsonDocument, offset );
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    switch( tokenType )
+    {
+        case IOT_SERIALIZER_CONTAINER_MAP:
+        case IOT_SERIALIZER_CONTAINER_ARRAY:
+
+            /* The extent of a container is known from the index, no need to parse it. */
+            if( pValue != NULL )
+            {
+                pValue->type = tokenType;
+                pValue->u.pHandle = _createIndexedContainer( pIndex, token );
+
+                if( pValue->u.pHandle == NULL )
+                {
+                    error = IOT_SERIALIZER_OUT_OF_MEMORY;
+                }
+            }
+
+            break;
+
+        default:
+            error = parseTokenValue( pIndex->pJsonDocument, pToken->end, &offset, tokenType, pValue );
+            break;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _findIndexedKeyValue( _jsonContainer_t * pObject,
+                                                  const char * pKey,
+                                                  size_t keyLength,
+                                                  IotSerializerDecoderObject_t * pValue )
+{
+    size_t valueToken = 0;
+    IotSerializerError_t ret = IOT_SERIALIZER_NOT_FOUND;
+
+    if( IotJsonUtils_FindIndexedValue( pObject->pIndex, pObject->token, pKey, keyLength, &valueToken ) )
+    {
+        ret = _parseIndexedTokenValue( pObject->pIndex, valueToken, pValue );
+    }
+
+    return ret;
+}
 
 /*-----------------------------------------------------------*/
 
@@ -578,6 +683,38 @@ static IotSerializerError_t _init( IotSerializerDecoderObject_t * pDecoderObject
     return error;
 }
 
+/*-----------------------------------------------------------*/
+
+IotSerializerError_t IotSerializer_JsonDecoderInitIndexed( IotSerializerDecoderObject_t * pDecoderObject,
+                                                           const uint8_t * pDataBuffer,
+                                                           size_t maxSize,
+                                                           IotJsonIndex_t * pIndex,
+                                                           IotJsonToken_t * pTokens,
+                                                           size_t maxTokens )
+{
+    _jsonContainer_t * pContainer;
+    IotSerializerError_t error = _init( pDecoderObject, pDataBuffer, maxSize );
+
+    if( error == IOT_SERIALIZER_SUCCESS )
+    {
+        pContainer = ( _jsonContainer_t * ) pDecoderObject->u.pHandle;
+
+        /* The root container starts past the first character of the document. If the
+         * document cannot be indexed, the decoder parses it as it goes instead. */
+        if( IotJsonUtils_BuildIndex( pIndex,
+                                     ( const char * ) pDataBuffer,
+                                     pContainer->length + 1,
+                                     pTokens,
+                                     maxTokens ) )
+        {
+            pContainer->pIndex = pIndex;
+            pContainer->token = 0;
+            pContainer->endToken = pTokens[ 0 ].next;
+        }
+    }
+
+    return error;
+}
 
 /*-----------------------------------------------------------*/
 
@@ -591,11 +728,23 @@ static IotSerializerError_t _find( IotSerializerDecoderObject_t * pDecoderObject
     if( pDecoderObject->type == IOT_SERIALIZER_CONTAINER_MAP )
     {
         pContainer = ( _jsonContainer_t * ) pDecoderObject->u.pHandle;
-        error = _findKeyValue(
-            pContainer,
-            pKey,
-            strlen( pKey ),
-            pValueObject );
+
+        if( pContainer->pIndex != NULL )
+        {
+            error = _findIndexedKeyValue(
+                pContainer,
+                pKey,
+                strlen( pKey ),
+                pValueObject );
+        }
+        else
+        {
+            error = _findKeyValue(
+                pContainer,
+                pKey,
+                strlen( pKey ),
+                pValueObject );
+        }
     }
     else
     {
@@ -611,7 +760,7 @@ static IotSerializerError_t _stepIn( IotSerializerDecoderObject_t * pDecoderObje
                                      IotSerializerDecoderIterator_t * pIterator )
 {
     IotSerializerDecoderObject_t * pNewObject;
-    _jsonContainer_t * pContainer, * pNewContainer;
+    _jsonContainer_t * pContainer, * pNewContainer = NULL;
     size_t offset = 0;
     IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
 
@@ -619,17 +768,32 @@ static IotSerializerError_t _stepIn( IotSerializerDecoderObject_t * pDecoderObje
     {
         pContainer = pDecoderObject->u.pHandle;
 
-        _skipWhiteSpacesAndDelimeters( pContainer->pStart, pContainer->length, &offset );
+        if( pContainer->pIndex != NULL )
+        {
+            /* Start the iterator at the first child of the container. */
+            pNewContainer = _createIndexedContainer( pContainer->pIndex, pContainer->token );
 
-        if( offset >= pContainer->length )
+            if( pNewContainer != NULL )
+            {
+                _moveIndexedIterator( pNewContainer, pContainer->token + 1 );
+            }
+        }
+        else
         {
-            error = IOT_SERIALIZER_INTERNAL_FAILURE;
+            _skipWhiteSpacesAndDelimeters( pContainer->pStart, pContainer->length, &offset );
+
+            if( offset >= pContainer->length )
+            {
+                error = IOT_SERIALIZER_INTERNAL_FAILURE;
+            }
+            else
+            {
+                pNewContainer = _createContainer( ( pContainer->pStart + offset ), pContainer->length - offset );
+            }
         }
 
         if( error == IOT_SERIALIZER_SUCCESS )
         {
-            pNewContainer = _createContainer( ( pContainer->pStart + offset ), pContainer->length - offset );
-
             if( pNewContainer != NULL )
             {
                 pNewObject = pvPortMalloc( sizeof( IotSerializerDecoderObject_t ) );
@@ -718,7 +882,11 @@ static IotSerializerError_t _get( IotSerializerDecoderIterator_t iterator,
         pContainer = _castDecoderIteratorToJsonContainer( iterator );
         type = _getTokenType( pContainer->pStart, offset );
 
-        if( type != IOT_SERIALIZER_UNDEFINED )
+        if( ( pContainer->pIndex != NULL ) && ( pContainer->token < pContainer->endToken ) )
+        {
+            error = _parseIndexedTokenValue( pContainer->pIndex, pContainer->token, pValueObject );
+        }
+        else if( type != IOT_SERIALIZER_UNDEFINED )
         {
             parseTokenValue( pContainer->pStart, pContainer->length, &offset, type, pValueObject );
 
@@ -754,17 +922,33 @@ static IotSerializerError_t _next( IotSerializerDecoderIterator_t iterator )
     if( _isValidContainer( pObject ) )
     {
         pContainer = pObject->u.pHandle;
-        type = _getTokenType( pContainer->pStart, offset );
-        parseTokenValue( pContainer->pStart, pContainer->length, &offset, type, NULL );
-        _skipWhiteSpacesAndDelimeters( pContainer->pStart, pContainer->length, &offset );
 
-        if( offset < pContainer->length )
+        if( pContainer->pIndex != NULL )
         {
-            pContainer->pStart += offset;
+            /* Skip the current token and its children. */
+            if( pContainer->token < pContainer->endToken )
+            {
+                _moveIndexedIterator( pContainer, pContainer->pIndex->pTokens[ pContainer->token ].next );
+            }
+            else
+            {
+                error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+            }
         }
         else
         {
-            error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+            type = _getTokenType( pContainer->pStart, offset );
+            parseTokenValue( pContainer->pStart, pContainer->length, &offset, type, NULL );
+            _skipWhiteSpacesAndDelimeters( pContainer->pStart, pContainer->length, &offset );
+
+            if( offset < pContainer->length )
+            {
+                pContainer->pStart += offset;
+            }
+            else
+            {
+                error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+            }
         }
     }
     else
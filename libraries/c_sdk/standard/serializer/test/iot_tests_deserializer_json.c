@@ -50,6 +50,12 @@ static const uint8_t test_data[] =
 
 static const uint16_t test_data_length = sizeof( test_data ) / sizeof( test_data[ 0 ] );
 
+/* Number of tokens in test_data. */
+#define TEST_DATA_TOKEN_COUNT    ( 38 )
+
+static IotJsonIndex_t jsonIndex;
+static IotJsonToken_t jsonTokens[ TEST_DATA_TOKEN_COUNT ];
+
 TEST_GROUP( Serializer_Unit_JSON_deserialize );
 
 TEST_SETUP( Serializer_Unit_JSON_deserialize )
@@ -76,6 +82,9 @@ TEST_GROUP_RUNNER( Serializer_Unit_JSON_deserialize )
     RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, find_key_object_value );
     RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, find_key_array_of_objects_value );
     RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, find_nested_key_array_of_objects_value );
+    RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, find_key_indexed );
+    RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, iterate_array_indexed );
+    RUN_TEST_CASE( Serializer_Unit_JSON_deserialize, index_too_small );
 }
 
 TEST( Serializer_Unit_JSON_deserialize, find_key_string_value )
@@ -121,3 +130,94 @@ TEST( Serializer_Unit_JSON_deserialize, find_nested_key_array_of_objects_value )
 
     _decoder.destroy( &nestedObject );
 }
+
+TEST( Serializer_Unit_JSON_deserialize, find_key_indexed )
+{
+    const char id[] = "ABC123";
+    IotSerializerDecoderObject_t indexedObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t nestedObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS,
+                       IotSerializer_JsonDecoderInitIndexed( &indexedObject, test_data, test_data_length,
+                                                             &jsonIndex, jsonTokens, TEST_DATA_TOKEN_COUNT ) );
+    TEST_ASSERT_EQUAL( TEST_DATA_TOKEN_COUNT, jsonIndex.tokenCount );
+
+    /* Keys of nested objects are not keys of the root object. */
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_NOT_FOUND, _decoder.find( &indexedObject, "id", &childObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_NOT_FOUND, _decoder.find( &indexedObject, "nam", &childObject ) );
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &indexedObject, "number", &childObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SCALAR_SIGNED_INT, childObject.type );
+    TEST_ASSERT_EQUAL( 3, childObject.u.value.u.signedInt );
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &indexedObject, "related", &nestedObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_CONTAINER_MAP, nestedObject.type );
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &nestedObject, "id", &childObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SCALAR_TEXT_STRING, childObject.type );
+    TEST_ASSERT_EQUAL( strlen( id ), childObject.u.value.u.string.length );
+    TEST_ASSERT_EQUAL( 0, strncmp( ( const char * ) childObject.u.value.u.string.pString, id, strlen( id ) ) );
+
+    _decoder.destroy( &nestedObject );
+    _decoder.destroy( &indexedObject );
+}
+
+TEST( Serializer_Unit_JSON_deserialize, iterate_array_indexed )
+{
+    const char * names[] = { "xQueue", "pvItemToQueue", "xTicksToWait" };
+    IotSerializerDecoderObject_t indexedObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t arrayObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t elementObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t valueObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderIterator_t iterator = IOT_SERIALIZER_DECODER_ITERATOR_INITIALIZER;
+    size_t count = 0;
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS,
+                       IotSerializer_JsonDecoderInitIndexed( &indexedObject, test_data, test_data_length,
+                                                             &jsonIndex, jsonTokens, TEST_DATA_TOKEN_COUNT ) );
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &indexedObject, "parameters", &arrayObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_CONTAINER_ARRAY, arrayObject.type );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.stepIn( &arrayObject, &iterator ) );
+
+    while( !_decoder.isEndOfContainer( iterator ) )
+    {
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.get( iterator, &elementObject ) );
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_CONTAINER_MAP, elementObject.type );
+
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &elementObject, "name", &valueObject ) );
+        TEST_ASSERT_EQUAL( strlen( names[ count ] ), valueObject.u.value.u.string.length );
+        TEST_ASSERT_EQUAL( 0, strncmp( ( const char * ) valueObject.u.value.u.string.pString,
+                                       names[ count ],
+                                       strlen( names[ count ] ) ) );
+
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &elementObject, "index", &valueObject ) );
+        TEST_ASSERT_EQUAL( ( int64_t ) ( count + 1 ), valueObject.u.value.u.signedInt );
+
+        _decoder.destroy( &elementObject );
+        count++;
+
+        TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.next( iterator ) );
+    }
+
+    TEST_ASSERT_EQUAL( 3, count );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.stepOut( iterator, &arrayObject ) );
+
+    _decoder.destroy( &arrayObject );
+    _decoder.destroy( &indexedObject );
+}
+
+TEST( Serializer_Unit_JSON_deserialize, index_too_small )
+{
+    IotSerializerDecoderObject_t indexedObject = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+
+    /* The document is decoded without an index. */
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS,
+                       IotSerializer_JsonDecoderInitIndexed( &indexedObject, test_data, test_data_length,
+                                                             &jsonIndex, jsonTokens, TEST_DATA_TOKEN_COUNT - 1 ) );
+
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_SUCCESS, _decoder.find( &indexedObject, "returns", &childObject ) );
+    TEST_ASSERT_EQUAL( IOT_SERIALIZER_CONTAINER_MAP, childObject.type );
+
+    _decoder.destroy( &indexedObject );
+}
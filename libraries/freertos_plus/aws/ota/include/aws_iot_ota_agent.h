@@ -361,6 +361,50 @@ typedef int16_t (* pxOTAPALWriteBlockCallback_t)( OTA_FileContext_t * const C,
                                                   uint8_t * const pacData,
                                                   uint32_t iBlockSize );
 
+/**
+ * @ingroup ota_datatypes_functionpointers
+ * @brief OTA Save Checkpoint callback function typedef.
+ *
+ * The user may register a callback function when initializing the OTA Agent. This
+ * callback is used to override how the checkpoint of a download is saved. It is only
+ * used if otaconfigRESUME_DOWNLOAD is 1.
+ *
+ * @param[in] C File context of the download
+ * @param[in] pucData Checkpoint to save, or NULL to erase the saved checkpoint
+ * @param[in] ulSize Size of the checkpoint in bytes
+ */
+typedef OTA_Err_t (* pxOTAPALSaveCheckpointCallback_t)( OTA_FileContext_t * const C,
+                                                        const uint8_t * pucData,
+                                                        uint32_t ulSize );
+
+/**
+ * @ingroup ota_datatypes_functionpointers
+ * @brief OTA Load Checkpoint callback function typedef.
+ *
+ * The user may register a callback function when initializing the OTA Agent. This
+ * callback is used to override how the checkpoint of a download is loaded. It is only
+ * used if otaconfigRESUME_DOWNLOAD is 1.
+ *
+ * @param[in] C File context of the download
+ * @param[out] pucData Buffer receiving the checkpoint
+ * @param[in] ulSize Size of the buffer in bytes
+ */
+typedef OTA_Err_t (* pxOTAPALLoadCheckpointCallback_t)( OTA_FileContext_t * const C,
+                                                        uint8_t * const pucData,
+                                                        uint32_t ulSize );
+
+/**
+ * @ingroup ota_datatypes_functionpointers
+ * @brief OTA Resume File for Receive callback function typedef.
+ *
+ * The user may register a callback function when initializing the OTA Agent. This
+ * callback is used to override how the file of an interrupted download is reopened.
+ * It is only used if otaconfigRESUME_DOWNLOAD is 1.
+ *
+ * @param[in] C File context of the download
+ */
+typedef OTA_Err_t (* pxOTAPALResumeFileForRxCallback_t)( OTA_FileContext_t * const C );
+
 /**
  * @ingroup ota_datatypes_functionpointers
  * @brief Custom Job callback function typedef.
@@ -424,6 +468,11 @@ typedef struct OTA_FileContext
     uint32_t ulUpdaterVersion;  /*!< Used by OTA self-test detection, the version of FW that did the update. */
     bool bIsInSelfTest;         /*!< True if the job is in self test mode. */
     uint8_t * pucProtocols;     /*!< Authorization scheme. */
+    void * pvSigVerifyContext;  /*!< Signature verification context hashed as blocks arrive, or NULL. Owned by the PAL once the file is closed. */
+    uint32_t ulSignedSize;      /*!< Number of bytes from the start of the file covered by the signature. The PAL may lower it in xCreateFileForRx. */
+    uint32_t ulHashedBlocks;    /*!< Number of blocks, from the start of the file, added to the signature verification context. */
+    uint32_t ulReorderMask;     /*!< Slots of the reorder buffer holding a block waiting to be hashed. */
+    uint8_t * pucReorderBlocks; /*!< Out of order blocks waiting for the blocks before them to be hashed. */
 } OTA_FileContext_t;
 
 /**
@@ -455,6 +504,9 @@ typedef struct
     pxOTAPALWriteBlockCallback_t xWriteBlock;                       /* OTA Write Block callback pointer */
     pxOTACompleteCallback_t xCompleteCallback;                      /* OTA Job Completed callback pointer */
     pxOTACustomJobCallback_t xCustomJobCallback;                    /* OTA Custom Job callback pointer */
+    pxOTAPALSaveCheckpointCallback_t xSaveCheckpoint;               /* OTA Save Checkpoint callback pointer */
+    pxOTAPALLoadCheckpointCallback_t xLoadCheckpoint;               /* OTA Load Checkpoint callback pointer */
+    pxOTAPALResumeFileForRxCallback_t xResumeFileForRx;             /* OTA Resume File for Receive callback pointer */
 } OTA_PAL_Callbacks_t;
 
 
@@ -517,6 +569,7 @@ typedef struct
 #define kOTA_Err_EventQueueSendFailed    0x2c000000UL     /*!< Posting event message to the event queue failed. */
 #define kOTA_Err_InvalidDataProtocol     0x2d000000UL     /*!< Job does not have a valid protocol for data transfer. */
 #define kOTA_Err_OTAAgentStopped         0x2e000000UL     /*!< Returned when operations are performed that requires OTA Agent running & its stopped. */
+#define kOTA_Err_CheckpointFailed        0x2f000000UL     /*!< The PAL failed to save or load the download checkpoint. */
 /* @[define_ota_err_codes] */
 
 /* @[define_ota_err_code_helpers] */
@@ -59,6 +59,14 @@
 /* OTA interface includes. */
 #include "aws_iot_ota_interface.h"
 
+/* Platform metrics includes. */
+#include "platform/iot_metrics.h"
+
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+    /* Crypto includes. */
+    #include "iot_crypto.h"
+#endif
+
 /* OTA event handler definiton. */
 
 typedef OTA_Err_t ( * OTAEventHandler_t )( OTA_EventData_t * pxEventMsg );
@@ -151,6 +159,74 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
                                           uint32_t ulMsgSize,
                                           OTA_Err_t * pxCloseResult );
 
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+
+/* Start hashing the file for its signature check as blocks are ingested. */
+
+    static void prvStreamVerifyStart( OTA_FileContext_t * const C );
+
+/* Add the next block of the file to the signature verification context. */
+
+    static void prvStreamVerifyUpdate( OTA_FileContext_t * const C,
+                                       const uint8_t * pucData );
+
+/* Hash an ingested block, or hold it until the blocks before it are hashed. */
+
+    static void prvStreamVerifyBlock( OTA_FileContext_t * const C,
+                                      uint32_t ulBlockIndex,
+                                      const uint8_t * pucPayload,
+                                      uint32_t ulBlockSize );
+
+/* Stop hashing the file and free the resources used to do so. */
+
+    static void prvStreamVerifyStop( OTA_FileContext_t * const C );
+#endif
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+
+/* Save the received blocks and the signature verification state of the file through the PAL. */
+
+    static void prvCheckpointSave( OTA_FileContext_t * const C );
+
+/* Reopen the file of an interrupted download if the checkpoint saved through the PAL matches it. */
+
+    static bool prvCheckpointRestore( OTA_FileContext_t * const C,
+                                      uint32_t ulBitmapLen );
+
+/* Hash what identifies the file of the job, to match a checkpoint with the file it was saved for. */
+
+    static uint32_t prvCheckpointFileHash( const OTA_FileContext_t * C );
+
+/* Add a byte array to a FNV-1a hash. */
+
+    static uint32_t prvCheckpointHash( uint32_t ulHash,
+                                       const uint8_t * pucData,
+                                       uint32_t ulSize );
+#endif
+
+/* Account for a newly received block in the window of block requests in flight. */
+
+static void prvPipelineBlockReceived( OTA_AgentContext_t * pxAgentCtx,
+                                      uint32_t ulBlockIndex );
+
+/* Drop all block requests in flight after the request timer expired without progress. */
+
+static void prvPipelineTimeout( OTA_AgentContext_t * pxAgentCtx );
+
+/* Check if there is room in the window to request more of the missing blocks. */
+
+static bool prvPipelineWantsRequest( const OTA_AgentContext_t * pxAgentCtx );
+
+/* Find the block request in flight that covers a block, or NULL if the block is not requested. */
+
+static OTA_BlockRange_t * prvPipelineFindRange( OTA_Pipeline_t * pxPipeline,
+                                                uint32_t ulBlockIndex );
+
+/* Drop a block request in flight. Returns true if this is a new loss for the window. */
+
+static bool prvPipelineDrop( OTA_Pipeline_t * pxPipeline,
+                             OTA_BlockRange_t * pxRange );
+
 /* Called to update the filecontext structure from the job. */
 
 static OTA_FileContext_t * prvGetFileContextFromJob( const char * pcRawMsg,
@@ -251,6 +327,7 @@ static OTA_Err_t prvInSelfTestHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvInitFileHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvProcessDataHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvRequestDataHandler( OTA_EventData_t * pxEventData );
+static OTA_Err_t prvRequestDataTimeoutHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvShutdownHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvCloseFileHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvUserAbortHandler( OTA_EventData_t * pxEventData );
@@ -258,6 +335,18 @@ static OTA_Err_t prvSuspendHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvResumeHandler( OTA_EventData_t * pxEventData );
 static OTA_Err_t prvJobNotificationHandler( OTA_EventData_t * pxEventData );
 
+/* The checkpoint functions of the PAL are only provided by ports that resume downloads. */
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+    #define OTA_PAL_SAVE_CHECKPOINT_DEFAULT       prvPAL_SaveCheckpoint
+    #define OTA_PAL_LOAD_CHECKPOINT_DEFAULT       prvPAL_LoadCheckpoint
+    #define OTA_PAL_RESUME_FILE_FOR_RX_DEFAULT    prvPAL_ResumeFileForRx
+#else
+    #define OTA_PAL_SAVE_CHECKPOINT_DEFAULT       NULL
+    #define OTA_PAL_LOAD_CHECKPOINT_DEFAULT       NULL
+    #define OTA_PAL_RESUME_FILE_FOR_RX_DEFAULT    NULL
+#endif
+
 /* OTA default callback initializer. */
 
 #define OTA_JOB_CALLBACK_DEFAULT_INITIALIZER                           \
@@ -271,7 +360,10 @@ static OTA_Err_t prvJobNotificationHandler( OTA_EventData_t * pxEventData );
         .xSetPlatformImageState = prvPAL_DefaultSetPlatformImageState, \
         .xWriteBlock = prvPAL_WriteBlock,                              \
         .xCompleteCallback = prvDefaultOTACompleteCallback,            \
-        .xCustomJobCallback = prvDefaultCustomJobCallback              \
+        .xCustomJobCallback = prvDefaultCustomJobCallback,             \
+        .xSaveCheckpoint = OTA_PAL_SAVE_CHECKPOINT_DEFAULT,            \
+        .xLoadCheckpoint = OTA_PAL_LOAD_CHECKPOINT_DEFAULT,            \
+        .xResumeFileForRx = OTA_PAL_RESUME_FILE_FOR_RX_DEFAULT         \
     }
 
 /* This is THE OTA agent context and initialization state. */
@@ -291,7 +383,8 @@ static OTA_AgentContext_t xOTA_Agent =
     .xOTA_EventQueue               = NULL,
     .eImageState                   = eOTA_ImageState_Unknown,
     .xPALCallbacks                 = OTA_JOB_CALLBACK_DEFAULT_INITIALIZER,
-    .ulNumOfBlocksToReceive        = 1,
+    .xPipeline                     = { { { 0 } } },
+    .ulCheckpointBlocks            = 0,
     .xStatistics                   = { 0 },
     .xOTA_ThreadSafetyMutex        = NULL,
     .ulRequestMomentum             = 0
@@ -299,26 +392,26 @@ static OTA_AgentContext_t xOTA_Agent =
 
 static OTAStateTableEntry_t OTATransitionTable[] =
 {
-    /*STATE ,                              EVENT ,                               ACTION ,               NEXT STATE                         */
-    { eOTA_AgentState_Ready,               eOTA_AgentEvent_Start,               prvStartHandler,           eOTA_AgentState_RequestingJob       },
-    { eOTA_AgentState_RequestingJob,       eOTA_AgentEvent_RequestJobDocument,  prvRequestJobHandler,      eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_RequestingJob,       eOTA_AgentEvent_RequestTimer,        prvRequestJobHandler,      eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_WaitingForJob,       eOTA_AgentEvent_ReceivedJobDocument, prvProcessJobHandler,      eOTA_AgentState_CreatingFile        },
-    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_StartSelfTest,       prvInSelfTestHandler,      eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_CreateFile,          prvInitFileHandler,        eOTA_AgentState_RequestingFileBlock },
-    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_RequestTimer,        prvInitFileHandler,        eOTA_AgentState_RequestingFileBlock },
-    { eOTA_AgentState_RequestingFileBlock, eOTA_AgentEvent_RequestFileBlock,    prvRequestDataHandler,     eOTA_AgentState_WaitingForFileBlock },
-    { eOTA_AgentState_RequestingFileBlock, eOTA_AgentEvent_RequestTimer,        prvRequestDataHandler,     eOTA_AgentState_WaitingForFileBlock },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_ReceivedFileBlock,   prvProcessDataHandler,     eOTA_AgentState_WaitingForFileBlock },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestTimer,        prvRequestDataHandler,     eOTA_AgentState_WaitingForFileBlock },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestFileBlock,    prvRequestDataHandler,     eOTA_AgentState_WaitingForFileBlock },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestJobDocument,  prvRequestJobHandler,      eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_ReceivedJobDocument, prvJobNotificationHandler, eOTA_AgentState_RequestingJob       },
-    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_CloseFile,           prvCloseFileHandler,       eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_Suspended,           eOTA_AgentEvent_Resume,              prvResumeHandler,          eOTA_AgentState_RequestingJob       },
-    { eOTA_AgentState_All,                 eOTA_AgentEvent_Suspend,             prvSuspendHandler,         eOTA_AgentState_Suspended           },
-    { eOTA_AgentState_All,                 eOTA_AgentEvent_UserAbort,           prvUserAbortHandler,       eOTA_AgentState_WaitingForJob       },
-    { eOTA_AgentState_All,                 eOTA_AgentEvent_Shutdown,            prvShutdownHandler,        eOTA_AgentState_ShuttingDown        },
+    /*STATE ,                              EVENT ,                               ACTION ,                  NEXT STATE                         */
+    { eOTA_AgentState_Ready,               eOTA_AgentEvent_Start,               prvStartHandler,              eOTA_AgentState_RequestingJob       },
+    { eOTA_AgentState_RequestingJob,       eOTA_AgentEvent_RequestJobDocument,  prvRequestJobHandler,         eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_RequestingJob,       eOTA_AgentEvent_RequestTimer,        prvRequestJobHandler,         eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_WaitingForJob,       eOTA_AgentEvent_ReceivedJobDocument, prvProcessJobHandler,         eOTA_AgentState_CreatingFile        },
+    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_StartSelfTest,       prvInSelfTestHandler,         eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_CreateFile,          prvInitFileHandler,           eOTA_AgentState_RequestingFileBlock },
+    { eOTA_AgentState_CreatingFile,        eOTA_AgentEvent_RequestTimer,        prvInitFileHandler,           eOTA_AgentState_RequestingFileBlock },
+    { eOTA_AgentState_RequestingFileBlock, eOTA_AgentEvent_RequestFileBlock,    prvRequestDataHandler,        eOTA_AgentState_WaitingForFileBlock },
+    { eOTA_AgentState_RequestingFileBlock, eOTA_AgentEvent_RequestTimer,        prvRequestDataTimeoutHandler, eOTA_AgentState_WaitingForFileBlock },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_ReceivedFileBlock,   prvProcessDataHandler,        eOTA_AgentState_WaitingForFileBlock },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestTimer,        prvRequestDataTimeoutHandler, eOTA_AgentState_WaitingForFileBlock },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestFileBlock,    prvRequestDataHandler,        eOTA_AgentState_WaitingForFileBlock },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_RequestJobDocument,  prvRequestJobHandler,         eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_ReceivedJobDocument, prvJobNotificationHandler,    eOTA_AgentState_RequestingJob       },
+    { eOTA_AgentState_WaitingForFileBlock, eOTA_AgentEvent_CloseFile,           prvCloseFileHandler,          eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_Suspended,           eOTA_AgentEvent_Resume,              prvResumeHandler,             eOTA_AgentState_RequestingJob       },
+    { eOTA_AgentState_All,                 eOTA_AgentEvent_Suspend,             prvSuspendHandler,            eOTA_AgentState_Suspended           },
+    { eOTA_AgentState_All,                 eOTA_AgentEvent_UserAbort,           prvUserAbortHandler,          eOTA_AgentState_WaitingForJob       },
+    { eOTA_AgentState_All,                 eOTA_AgentEvent_Shutdown,            prvShutdownHandler,           eOTA_AgentState_ShuttingDown        },
 };
 
 static const char * pcOTA_AgentState_Strings[ eOTA_AgentState_All ] =
@@ -786,6 +879,33 @@ static void prvSetPALCallbacks( const OTA_PAL_Callbacks_t * pxCallbacks )
     {
         xOTA_Agent.xPALCallbacks.xCustomJobCallback = prvDefaultCustomJobCallback;
     }
+
+    if( pxCallbacks->xSaveCheckpoint != NULL )
+    {
+        xOTA_Agent.xPALCallbacks.xSaveCheckpoint = pxCallbacks->xSaveCheckpoint;
+    }
+    else
+    {
+        xOTA_Agent.xPALCallbacks.xSaveCheckpoint = OTA_PAL_SAVE_CHECKPOINT_DEFAULT;
+    }
+
+    if( pxCallbacks->xLoadCheckpoint != NULL )
+    {
+        xOTA_Agent.xPALCallbacks.xLoadCheckpoint = pxCallbacks->xLoadCheckpoint;
+    }
+    else
+    {
+        xOTA_Agent.xPALCallbacks.xLoadCheckpoint = OTA_PAL_LOAD_CHECKPOINT_DEFAULT;
+    }
+
+    if( pxCallbacks->xResumeFileForRx != NULL )
+    {
+        xOTA_Agent.xPALCallbacks.xResumeFileForRx = pxCallbacks->xResumeFileForRx;
+    }
+    else
+    {
+        xOTA_Agent.xPALCallbacks.xResumeFileForRx = OTA_PAL_RESUME_FILE_FOR_RX_DEFAULT;
+    }
 }
 
 static OTA_Err_t prvStartHandler( OTA_EventData_t * pxEventData )
@@ -1098,6 +1218,14 @@ static OTA_Err_t prvRequestDataHandler( OTA_EventData_t * pxEventData )
     return xErr;
 }
 
+static OTA_Err_t prvRequestDataTimeoutHandler( OTA_EventData_t * pxEventData )
+{
+    /* No block arrived within the request wait time, so whatever is still in flight is lost. */
+    prvPipelineTimeout( &xOTA_Agent );
+
+    return prvRequestDataHandler( pxEventData );
+}
+
 static OTA_Err_t prvProcessDataHandler( OTA_EventData_t * pxEventData )
 {
     DEFINE_OTA_METHOD_NAME( "prvProcessDataMessage" );
@@ -1204,11 +1332,9 @@ static OTA_Err_t prvProcessDataHandler( OTA_EventData_t * pxEventData )
             }
         }
 
-        if( xOTA_Agent.ulNumOfBlocksToReceive > 1U )
-        {
-            xOTA_Agent.ulNumOfBlocksToReceive--;
-        }
-        else
+        /* Request more blocks as soon as there is room in the window, so the next request is on
+         * its way before the blocks already requested are drained. */
+        if( prvPipelineWantsRequest( &xOTA_Agent ) )
         {
             prvStartRequestTimer( otaconfigFILE_REQUEST_WAIT_MS );
 
@@ -1473,6 +1599,10 @@ static void prvOTA_FreeContext( OTA_FileContext_t * const C )
             vPortFree( C->pucProtocols ); /* Free the pucProtocols string memory. */
             C->pucProtocols = NULL;
         }
+
+        #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+            prvStreamVerifyStop( C ); /* Free the signature verification context, unless the PAL took it. */
+        #endif
     }
 }
 
@@ -2346,6 +2476,7 @@ static OTA_FileContext_t * prvGetFileContextFromJob( const char * pcRawMsg,
     OTA_Err_t xErr = kOTA_Err_Uninitialized;
 
     bool bUpdateJob = false;
+    bool bResumed = false;
 
     /* Populate an OTA file context from the OTA job document. */
 
@@ -2393,9 +2524,30 @@ static OTA_FileContext_t * prvGetFileContextFromJob( const char * pcRawMsg,
             }
 
             pstUpdateFile->ulBlocksRemaining = ulNumBlocks; /* Initialize our blocks remaining counter. */
+            pstUpdateFile->ulSignedSize = pstUpdateFile->ulFileSize;  /* The whole file is signed unless the PAL says otherwise. */
+            xOTA_Agent.ulCheckpointBlocks = 0U;
+
+            #if ( otaconfigRESUME_DOWNLOAD == 1U )
+                /* Continue an interrupted download of this file if there is a checkpoint for it. */
+                bResumed = prvCheckpointRestore( pstUpdateFile, ulBitmapLen );
+            #endif
 
-            /* Create/Open the OTA file on the file system. */
-            xErr = xOTA_Agent.xPALCallbacks.xCreateFileForRx( pstUpdateFile );
+            if( bResumed == true )
+            {
+                xErr = kOTA_Err_None;
+            }
+            else
+            {
+                /* Create/Open the OTA file on the file system. */
+                xErr = xOTA_Agent.xPALCallbacks.xCreateFileForRx( pstUpdateFile );
+
+                #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+                    if( xErr == kOTA_Err_None )
+                    {
+                        prvStreamVerifyStart( pstUpdateFile );
+                    }
+                #endif
+            }
 
             if( xErr != kOTA_Err_None )
             {
@@ -2543,6 +2695,7 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
 
                 eIngestResult = eIngest_Result_Duplicate_Continue;
                 *pxCloseResult = kOTA_Err_None; /* This is a success path. */
+                IOT_METRICS_COUNT( IOT_METRICS_OTA_DUPLICATE_BLOCKS );
             }
         }
         else
@@ -2568,6 +2721,12 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
             {
                 C->pucRxBlockBitmap[ ulByte ] &= ~ucBitMask; /* Mark this block as received in our bitmap. */
                 C->ulBlocksRemaining--;
+                prvPipelineBlockReceived( &xOTA_Agent, ulBlockIndex );
+
+                #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+                    prvStreamVerifyBlock( C, ulBlockIndex, pucPayload, ulBlockSize );
+                #endif
+
                 eIngestResult = eIngest_Result_Accepted_Continue;
                 *pxCloseResult = kOTA_Err_None;
             }
@@ -2590,6 +2749,23 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
             vPortFree( C->pucRxBlockBitmap ); /* Free the bitmap now that we're done with the download. */
             C->pucRxBlockBitmap = NULL;
 
+            #if ( otaconfigRESUME_DOWNLOAD == 1U )
+                /* The download can't be resumed past this point, whatever the result of the close. */
+                ( void ) xOTA_Agent.xPALCallbacks.xSaveCheckpoint( C, NULL, 0U );
+            #endif
+
+            #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+
+                /* All blocks have been ingested, so the whole signed part of the file should have been
+                 * hashed. If not, leave the signature check to the PAL. */
+                if( ( C->pvSigVerifyContext != NULL ) &&
+                    ( ( ( uint64_t ) C->ulHashedBlocks * OTA_FILE_BLOCK_SIZE ) < C->ulSignedSize ) )
+                {
+                    OTA_LOG_L1( "[%s] Warning: Streaming signature verification is incomplete.\r\n", OTA_METHOD_NAME );
+                    prvStreamVerifyStop( C );
+                }
+            #endif
+
             if( C->pucFile != NULL )
             {
                 *pxCloseResult = xOTA_Agent.xPALCallbacks.xCloseFile( C );
@@ -2629,12 +2805,776 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
         else
         {
             OTA_LOG_L1( "[%s] Remaining: %u\r\n", OTA_METHOD_NAME, C->ulBlocksRemaining );
+
+            #if ( otaconfigRESUME_DOWNLOAD == 1U )
+                xOTA_Agent.ulCheckpointBlocks++;
+
+                if( xOTA_Agent.ulCheckpointBlocks >= otaconfigCHECKPOINT_INTERVAL_BLOCKS )
+                {
+                    prvCheckpointSave( C );
+                    xOTA_Agent.ulCheckpointBlocks = 0U;
+                }
+            #endif
         }
     }
 
     return eIngestResult;
 }
 
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+
+/*
+ * prvStreamVerifyStart
+ *
+ * Start the signature verification of a file that is about to be received. The signature key name
+ * (e.g. "sig-sha256-ecdsa") tells which algorithms the PAL verifies the signature with. If the
+ * verification can't be started, the PAL checks the signature of the whole file on close instead.
+ */
+    static void prvStreamVerifyStart( OTA_FileContext_t * const C )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvStreamVerifyStart" );
+
+        BaseType_t xHashAlgorithm = cryptoHASH_ALGORITHM_SHA256;
+        BaseType_t xAsymmetricAlgorithm = cryptoASYMMETRIC_ALGORITHM_ECDSA;
+
+        if( strstr( cOTA_JSON_FileSignatureKey, "sha1" ) != NULL )
+        {
+            xHashAlgorithm = cryptoHASH_ALGORITHM_SHA1;
+        }
+
+        if( strstr( cOTA_JSON_FileSignatureKey, "rsa" ) != NULL )
+        {
+            xAsymmetricAlgorithm = cryptoASYMMETRIC_ALGORITHM_RSA;
+        }
+
+        /* Drop any verification left from a previous use of the context. */
+        prvStreamVerifyStop( C );
+        C->ulHashedBlocks = 0U;
+
+        if( CRYPTO_SignatureVerificationStart( &C->pvSigVerifyContext, xAsymmetricAlgorithm, xHashAlgorithm ) == pdFALSE )
+        {
+            OTA_LOG_L1( "[%s] Warning: Unable to start streaming signature verification.\r\n", OTA_METHOD_NAME );
+            C->pvSigVerifyContext = NULL;
+        }
+        else
+        {
+            /* If this fails, only blocks that arrive in order can be hashed. */
+            C->pucReorderBlocks = ( uint8_t * ) pvPortMalloc( otaconfigSTREAMING_REORDER_BLOCKS * OTA_FILE_BLOCK_SIZE ); /*lint !e9079 FreeRTOS malloc port returns void*. */
+        }
+    }
+
+/*
+ * prvStreamVerifyUpdate
+ *
+ * Add the next block of the file to the signature verification context. Only the first ulSignedSize
+ * bytes of the file are covered by the signature.
+ */
+    static void prvStreamVerifyUpdate( OTA_FileContext_t * const C,
+                                       const uint8_t * pucData )
+    {
+        uint32_t ulOffset = C->ulHashedBlocks * OTA_FILE_BLOCK_SIZE;
+        uint32_t ulLength = 0;
+
+        if( ulOffset < C->ulSignedSize )
+        {
+            ulLength = C->ulSignedSize - ulOffset;
+
+            if( ulLength > OTA_FILE_BLOCK_SIZE )
+            {
+                ulLength = OTA_FILE_BLOCK_SIZE;
+            }
+
+            CRYPTO_SignatureVerificationUpdate( C->pvSigVerifyContext, pucData, ulLength );
+        }
+
+        C->ulHashedBlocks++;
+    }
+
+/*
+ * prvStreamVerifyBlock
+ *
+ * A block of the file was written. If it is the next block to hash, hash it along with any blocks
+ * after it held in the reorder buffer. A block that arrives early is copied to the reorder buffer,
+ * which holds the otaconfigSTREAMING_REORDER_BLOCKS blocks following the next one to hash, each in
+ * the slot of its index modulo the buffer size. If a block arrives even earlier, streaming
+ * verification is abandoned and the PAL checks the signature of the whole file on close.
+ */
+    static void prvStreamVerifyBlock( OTA_FileContext_t * const C,
+                                      uint32_t ulBlockIndex,
+                                      const uint8_t * pucPayload,
+                                      uint32_t ulBlockSize )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvStreamVerifyBlock" );
+
+        uint32_t ulSlot = 0;
+
+        if( C->pvSigVerifyContext != NULL )
+        {
+            if( ulBlockIndex == C->ulHashedBlocks )
+            {
+                prvStreamVerifyUpdate( C, pucPayload );
+
+                /* Hash the blocks that were waiting for this one. */
+                ulSlot = C->ulHashedBlocks % otaconfigSTREAMING_REORDER_BLOCKS;
+
+                while( ( C->ulReorderMask & ( 1UL << ulSlot ) ) != 0U )
+                {
+                    C->ulReorderMask &= ~( 1UL << ulSlot );
+                    prvStreamVerifyUpdate( C, &C->pucReorderBlocks[ ulSlot * OTA_FILE_BLOCK_SIZE ] );
+                    ulSlot = C->ulHashedBlocks % otaconfigSTREAMING_REORDER_BLOCKS;
+                }
+            }
+            else if( ( C->pucReorderBlocks != NULL ) &&
+                     ( ulBlockIndex > C->ulHashedBlocks ) &&
+                     ( ( ulBlockIndex - C->ulHashedBlocks ) <= otaconfigSTREAMING_REORDER_BLOCKS ) )
+            {
+                ulSlot = ulBlockIndex % otaconfigSTREAMING_REORDER_BLOCKS;
+                ( void ) memcpy( &C->pucReorderBlocks[ ulSlot * OTA_FILE_BLOCK_SIZE ], pucPayload, ulBlockSize );
+                C->ulReorderMask |= 1UL << ulSlot;
+            }
+            else
+            {
+                OTA_LOG_L1( "[%s] Block %u is outside the reorder window, the signature will be checked on close.\r\n",
+                            OTA_METHOD_NAME,
+                            ulBlockIndex );
+                prvStreamVerifyStop( C );
+            }
+        }
+    }
+
+/*
+ * prvStreamVerifyStop
+ *
+ * Free the signature verification context and the reorder buffer. The context is freed by calling
+ * CRYPTO_SignatureVerificationFinal() without a certificate or signature.
+ */
+    static void prvStreamVerifyStop( OTA_FileContext_t * const C )
+    {
+        if( C->pvSigVerifyContext != NULL )
+        {
+            ( void ) CRYPTO_SignatureVerificationFinal( C->pvSigVerifyContext, NULL, 0, NULL, 0 );
+            C->pvSigVerifyContext = NULL;
+        }
+
+        if( C->pucReorderBlocks != NULL )
+        {
+            vPortFree( C->pucReorderBlocks );
+            C->pucReorderBlocks = NULL;
+        }
+
+        C->ulReorderMask = 0U;
+    }
+
+#endif /* if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U ) */
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+
+/*
+ * prvCheckpointSave
+ *
+ * Save a checkpoint of the download through the PAL: the block bitmap and the signature verification
+ * state. The blocks held in the reorder buffer are not in the saved hash, so they are recorded as
+ * missing and received again if the download is resumed. The checkpoint ends with a hash of its
+ * content so that one partly written before a reset is not used.
+ */
+    static void prvCheckpointSave( OTA_FileContext_t * const C )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvCheckpointSave" );
+
+        OTA_Checkpoint_t xHeader = { 0 };
+        uint8_t * pucCheckpoint = NULL;
+        uint8_t * pucBitmap = NULL;
+        uint32_t ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
+        uint32_t ulSize = 0;
+        OTA_Err_t xErr = kOTA_Err_None;
+
+        xHeader.ulMagic = OTA_CHECKPOINT_MAGIC;
+        xHeader.ulFileHash = prvCheckpointFileHash( C );
+        xHeader.ulBitmapLen = ( ulNumBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
+
+        #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+            if( C->pvSigVerifyContext != NULL )
+            {
+                xHeader.ulHashedBlocks = C->ulHashedBlocks;
+                xHeader.ulHashStateLen = ( uint32_t ) CRYPTO_SignatureVerificationStateSize();
+            }
+        #endif
+
+        ulSize = sizeof( OTA_Checkpoint_t ) + xHeader.ulBitmapLen + xHeader.ulHashStateLen;
+        pucCheckpoint = ( uint8_t * ) pvPortMalloc( ulSize ); /*lint !e9079 FreeRTOS malloc port returns void*. */
+
+        if( pucCheckpoint == NULL )
+        {
+            xErr = kOTA_Err_OutOfMemory;
+        }
+        else
+        {
+            pucBitmap = &pucCheckpoint[ sizeof( OTA_Checkpoint_t ) ];
+            ( void ) memcpy( pucBitmap, C->pucRxBlockBitmap, xHeader.ulBitmapLen );
+
+            #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+                if( xHeader.ulHashStateLen > 0U )
+                {
+                    uint32_t ulIndex;
+                    uint32_t ulBlock;
+
+                    for( ulIndex = 1U; ulIndex <= otaconfigSTREAMING_REORDER_BLOCKS; ulIndex++ )
+                    {
+                        ulBlock = C->ulHashedBlocks + ulIndex;
+
+                        if( ( C->ulReorderMask & ( 1UL << ( ulBlock % otaconfigSTREAMING_REORDER_BLOCKS ) ) ) != 0U )
+                        {
+                            pucBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] |= ( uint8_t ) ( 1U << ( ulBlock % BITS_PER_BYTE ) );
+                        }
+                    }
+
+                    if( CRYPTO_SignatureVerificationSave( C->pvSigVerifyContext,
+                                                          &pucBitmap[ xHeader.ulBitmapLen ],
+                                                          xHeader.ulHashStateLen ) == pdFALSE )
+                    {
+                        xErr = kOTA_Err_CheckpointFailed;
+                    }
+                }
+            #endif /* if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U ) */
+
+            if( xErr == kOTA_Err_None )
+            {
+                ( void ) memcpy( pucCheckpoint, &xHeader, sizeof( xHeader ) );
+                xHeader.ulChecksum = prvCheckpointHash( OTA_CHECKPOINT_HASH_BASIS, pucCheckpoint, ulSize );
+                ( void ) memcpy( pucCheckpoint, &xHeader, sizeof( xHeader ) );
+
+                xErr = xOTA_Agent.xPALCallbacks.xSaveCheckpoint( C, pucCheckpoint, ulSize );
+            }
+
+            vPortFree( pucCheckpoint );
+        }
+
+        if( xErr != kOTA_Err_None )
+        {
+            OTA_LOG_L1( "[%s] Warning: Unable to save a checkpoint of the download (0x%08x).\r\n", OTA_METHOD_NAME, xErr );
+        }
+        else
+        {
+            OTA_LOG_L1( "[%s] Saved a checkpoint of the download, %u blocks remaining.\r\n", OTA_METHOD_NAME, C->ulBlocksRemaining );
+        }
+    }
+
+/*
+ * prvCheckpointRestore
+ *
+ * Load the checkpoint saved through the PAL and, if it is complete and was saved for this file, let
+ * the PAL reopen the file without erasing it and continue with the blocks still missing. Otherwise,
+ * the checkpoint is erased and the file is received from the start.
+ */
+    static bool prvCheckpointRestore( OTA_FileContext_t * const C,
+                                      uint32_t ulBitmapLen )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvCheckpointRestore" );
+
+        OTA_Checkpoint_t xHeader = { 0 };
+        uint8_t * pucCheckpoint = NULL;
+        uint8_t * pucBitmap = NULL;
+        uint8_t * pucRxBlockBitmap = C->pucRxBlockBitmap;
+        uint32_t ulNumBlocks = C->ulBlocksRemaining;
+        uint32_t ulHashStateLen = 0U;
+        uint32_t ulChecksum = 0U;
+        uint32_t ulIndex = 0U;
+        uint8_t ucByte = 0U;
+        bool bResumed = false;
+
+        #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+            ulHashStateLen = ( uint32_t ) CRYPTO_SignatureVerificationStateSize();
+        #endif
+
+        pucCheckpoint = ( uint8_t * ) pvPortMalloc( sizeof( OTA_Checkpoint_t ) + ulBitmapLen + ulHashStateLen ); /*lint !e9079 FreeRTOS malloc port returns void*. */
+
+        if( ( pucCheckpoint != NULL ) &&
+            ( xOTA_Agent.xPALCallbacks.xLoadCheckpoint( C, pucCheckpoint, sizeof( OTA_Checkpoint_t ) + ulBitmapLen + ulHashStateLen ) == kOTA_Err_None ) )
+        {
+            ( void ) memcpy( &xHeader, pucCheckpoint, sizeof( xHeader ) );
+
+            if( ( xHeader.ulMagic == OTA_CHECKPOINT_MAGIC ) &&
+                ( xHeader.ulFileHash == prvCheckpointFileHash( C ) ) &&
+                ( xHeader.ulBitmapLen == ulBitmapLen ) &&
+                ( ( xHeader.ulHashStateLen == 0U ) || ( xHeader.ulHashStateLen == ulHashStateLen ) ) )
+            {
+                /* The checksum was computed with the checksum field cleared. */
+                ulChecksum = xHeader.ulChecksum;
+                xHeader.ulChecksum = 0U;
+                ( void ) memcpy( pucCheckpoint, &xHeader, sizeof( xHeader ) );
+
+                bResumed = ( ulChecksum == prvCheckpointHash( OTA_CHECKPOINT_HASH_BASIS,
+                                                              pucCheckpoint,
+                                                              sizeof( OTA_Checkpoint_t ) + ulBitmapLen + xHeader.ulHashStateLen ) );
+            }
+        }
+
+        if( bResumed == true )
+        {
+            /* Count the blocks still missing. Blocks out of the range of the file stay marked as received. */
+            pucBitmap = &pucCheckpoint[ sizeof( OTA_Checkpoint_t ) ];
+            C->ulBlocksRemaining = 0U;
+
+            for( ulIndex = 0U; ulIndex < ulBitmapLen; ulIndex++ )
+            {
+                pucBitmap[ ulIndex ] &= pucRxBlockBitmap[ ulIndex ];
+
+                for( ucByte = pucBitmap[ ulIndex ]; ucByte != 0U; ucByte >>= 1U )
+                {
+                    C->ulBlocksRemaining += ( uint32_t ) ucByte & 1U;
+                }
+            }
+
+            /* Let the PAL reopen the file with the blocks of the checkpoint. */
+            C->pucRxBlockBitmap = pucBitmap;
+            bResumed = ( C->ulBlocksRemaining > 0U ) && ( xOTA_Agent.xPALCallbacks.xResumeFileForRx( C ) == kOTA_Err_None );
+            C->pucRxBlockBitmap = pucRxBlockBitmap;
+
+            if( bResumed == true )
+            {
+                ( void ) memcpy( pucRxBlockBitmap, pucBitmap, ulBitmapLen );
+            }
+            else
+            {
+                C->ulBlocksRemaining = ulNumBlocks;
+            }
+        }
+
+        #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+            if( ( bResumed == true ) && ( xHeader.ulHashStateLen > 0U ) )
+            {
+                prvStreamVerifyStop( C );
+
+                if( CRYPTO_SignatureVerificationRestore( &C->pvSigVerifyContext,
+                                                         &pucBitmap[ ulBitmapLen ],
+                                                         ulHashStateLen ) == pdFALSE )
+                {
+                    OTA_LOG_L1( "[%s] Warning: Unable to restore streaming signature verification.\r\n", OTA_METHOD_NAME );
+                    C->pvSigVerifyContext = NULL;
+                }
+                else
+                {
+                    C->ulHashedBlocks = xHeader.ulHashedBlocks;
+                    C->pucReorderBlocks = ( uint8_t * ) pvPortMalloc( otaconfigSTREAMING_REORDER_BLOCKS * OTA_FILE_BLOCK_SIZE ); /*lint !e9079 FreeRTOS malloc port returns void*. */
+                }
+            }
+        #endif
+
+        if( pucCheckpoint != NULL )
+        {
+            vPortFree( pucCheckpoint );
+        }
+
+        if( bResumed == true )
+        {
+            OTA_LOG_L1( "[%s] Resuming the download, %u blocks remaining.\r\n", OTA_METHOD_NAME, C->ulBlocksRemaining );
+        }
+        else
+        {
+            /* Drop the checkpoint of any other download, the file is received from the start. */
+            ( void ) xOTA_Agent.xPALCallbacks.xSaveCheckpoint( C, NULL, 0U );
+        }
+
+        return bResumed;
+    }
+
+/*
+ * prvCheckpointFileHash
+ *
+ * Hash the job name, stream name, file ID, size and signature of the file.
+ */
+    static uint32_t prvCheckpointFileHash( const OTA_FileContext_t * C )
+    {
+        uint32_t ulHash = OTA_CHECKPOINT_HASH_BASIS;
+
+        if( C->pucJobName != NULL )
+        {
+            ulHash = prvCheckpointHash( ulHash, C->pucJobName, ( uint32_t ) strlen( ( const char * ) C->pucJobName ) );
+        }
+
+        if( C->pucStreamName != NULL )
+        {
+            ulHash = prvCheckpointHash( ulHash, C->pucStreamName, ( uint32_t ) strlen( ( const char * ) C->pucStreamName ) );
+        }
+
+        ulHash = prvCheckpointHash( ulHash, ( const uint8_t * ) &C->ulServerFileID, sizeof( C->ulServerFileID ) );
+        ulHash = prvCheckpointHash( ulHash, ( const uint8_t * ) &C->ulFileSize, sizeof( C->ulFileSize ) );
+
+        if( ( C->pxSignature != NULL ) && ( C->pxSignature->usSize <= kOTA_MaxSignatureSize ) )
+        {
+            ulHash = prvCheckpointHash( ulHash, C->pxSignature->ucData, C->pxSignature->usSize );
+        }
+
+        return ulHash;
+    }
+
+/*
+ * prvCheckpointHash
+ *
+ * 32 bit FNV-1a hash. Start with OTA_CHECKPOINT_HASH_BASIS.
+ */
+    static uint32_t prvCheckpointHash( uint32_t ulHash,
+                                       const uint8_t * pucData,
+                                       uint32_t ulSize )
+    {
+        uint32_t ulIndex;
+
+        for( ulIndex = 0U; ulIndex < ulSize; ulIndex++ )
+        {
+            ulHash ^= pucData[ ulIndex ];
+            ulHash *= 16777619UL; /* FNV prime. */
+        }
+
+        return ulHash;
+    }
+
+#endif /* if ( otaconfigRESUME_DOWNLOAD == 1U ) */
+
+/*
+ * prvOTAPipelineReset
+ *
+ * Forget the block requests in flight and start with a window of a single request.
+ */
+void prvOTAPipelineReset( OTA_AgentContext_t * pxAgentCtx,
+                          uint32_t ulMaxRanges,
+                          uint32_t ulMaxRangeBlocks )
+{
+    OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+
+    ( void ) memset( pxPipeline, 0, sizeof( OTA_Pipeline_t ) );
+
+    pxPipeline->ulMaxRanges = ulMaxRanges;
+
+    if( pxPipeline->ulMaxRanges > otaconfigMAX_REQUESTS_IN_FLIGHT )
+    {
+        pxPipeline->ulMaxRanges = otaconfigMAX_REQUESTS_IN_FLIGHT;
+    }
+    else if( pxPipeline->ulMaxRanges == 0U )
+    {
+        pxPipeline->ulMaxRanges = 1U;
+    }
+    else
+    {
+        /* The data plane limit is within the configured one. */
+    }
+
+    pxPipeline->ulMaxRangeBlocks = ( ulMaxRangeBlocks > 0U ) ? ulMaxRangeBlocks : 1U;
+    pxPipeline->ulWindow = pxPipeline->ulMaxRangeBlocks;
+}
+
+/*
+ * prvOTAPipelineReserve
+ *
+ * Start the span at the first missing block that is not requested yet and extend it until it holds
+ * as many missing blocks as the window and the data plane allow, or it reaches a span in flight.
+ */
+uint32_t prvOTAPipelineReserve( OTA_AgentContext_t * pxAgentCtx,
+                                bool bContiguous,
+                                uint32_t * pulFirstBlock,
+                                uint32_t * pulEndBlock )
+{
+    OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+    OTA_FileContext_t * C = &pxAgentCtx->pxOTA_Files[ pxAgentCtx->ulFileIndex ];
+    OTA_BlockRange_t * pxFree = NULL;
+    OTA_BlockRange_t * pxRange = NULL;
+    uint32_t ulIndex = 0;
+    uint32_t ulNumBlocks = 0;
+    uint32_t ulBudget = 0;
+    uint32_t ulBlock = 0;
+    uint32_t ulFirst = 0;
+    uint32_t ulCount = 0;
+    bool bMissing = false;
+
+    if( ( C->pucRxBlockBitmap != NULL ) && ( pxPipeline->ulInFlight < pxPipeline->ulWindow ) )
+    {
+        for( ulIndex = 0; ulIndex < pxPipeline->ulMaxRanges; ulIndex++ )
+        {
+            if( pxPipeline->xRanges[ ulIndex ].ulOutstanding == 0U )
+            {
+                pxFree = &pxPipeline->xRanges[ ulIndex ];
+                break;
+            }
+        }
+    }
+
+    if( pxFree != NULL )
+    {
+        ulBudget = pxPipeline->ulWindow - pxPipeline->ulInFlight;
+
+        if( ulBudget > pxPipeline->ulMaxRangeBlocks )
+        {
+            ulBudget = pxPipeline->ulMaxRangeBlocks;
+        }
+
+        ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
+
+        /* Find the first missing block that is not requested yet. */
+        while( ulBlock < ulNumBlocks )
+        {
+            pxRange = prvPipelineFindRange( pxPipeline, ulBlock );
+
+            if( pxRange != NULL )
+            {
+                ulBlock = pxRange->ulEndBlock;
+            }
+            else if( ( C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) != 0U )
+            {
+                break;
+            }
+            else
+            {
+                ulBlock++;
+            }
+        }
+
+        ulFirst = ulBlock;
+
+        while( ( ulBlock < ulNumBlocks ) && ( ulCount < ulBudget ) && ( prvPipelineFindRange( pxPipeline, ulBlock ) == NULL ) )
+        {
+            bMissing = ( C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) != 0U;
+
+            if( bMissing )
+            {
+                ulCount++;
+            }
+            else if( bContiguous )
+            {
+                break;
+            }
+            else
+            {
+                /* Received blocks inside the span are not requested again. */
+            }
+
+            ulBlock++;
+        }
+
+        if( ulCount > 0U )
+        {
+            pxFree->ulFirstBlock = ulFirst;
+            pxFree->ulEndBlock = ulBlock;
+            pxFree->ulRequested = ulCount;
+            pxFree->ulOutstanding = ulCount;
+            pxFree->ulSequence = pxPipeline->ulNextSequence++;
+            pxFree->xSentTime = xTaskGetTickCount();
+            pxPipeline->ulInFlight += ulCount;
+
+            *pulFirstBlock = ulFirst;
+            *pulEndBlock = ulBlock;
+        }
+    }
+
+    return ulCount;
+}
+
+/*
+ * prvOTAPipelineCancel
+ *
+ * The request for the span was never sent, so giving it back is not a loss.
+ */
+void prvOTAPipelineCancel( OTA_AgentContext_t * pxAgentCtx,
+                           uint32_t ulFirstBlock )
+{
+    OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+    OTA_BlockRange_t * pxRange = prvPipelineFindRange( pxPipeline, ulFirstBlock );
+
+    if( pxRange != NULL )
+    {
+        pxPipeline->ulInFlight -= pxRange->ulOutstanding;
+        pxRange->ulOutstanding = 0U;
+    }
+}
+
+/*
+ * prvPipelineBlockReceived
+ *
+ * The first block of a request gives a round trip time sample. The streaming service answers the
+ * requests in the order they were sent, so when a block of a request arrives, the blocks still
+ * outstanding from older requests were lost. Those are released to be requested again and the
+ * window is halved. When a request completes without loss, the window grows by half of it, unless
+ * the round trip time is more than twice the smallest one seen. That means requests are already
+ * queueing behind each other and a larger window would not make the transfer any faster.
+ */
+static void prvPipelineBlockReceived( OTA_AgentContext_t * pxAgentCtx,
+                                      uint32_t ulBlockIndex )
+{
+    OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+    OTA_BlockRange_t * pxRange = prvPipelineFindRange( pxPipeline, ulBlockIndex );
+    OTA_BlockRange_t * pxOlder = NULL;
+    TickType_t xRTT = 0;
+    uint32_t ulIndex = 0;
+    uint32_t ulMaxWindow = 0;
+    bool bLost = false;
+
+    /* Blocks of requests that were already dropped are not accounted for. */
+    if( pxRange != NULL )
+    {
+        #if ( IOT_METRICS_ENABLE_HISTOGRAMS == 1 )
+            IotMetrics_RecordLatency( IOT_METRICS_OTA_BLOCK,
+                                      ( uint32_t ) ( ( ( uint64_t ) ( xTaskGetTickCount() - pxRange->xSentTime ) * 1000000U ) /
+                                                     configTICK_RATE_HZ ) );
+        #endif
+
+        if( pxRange->ulOutstanding == pxRange->ulRequested )
+        {
+            xRTT = xTaskGetTickCount() - pxRange->xSentTime;
+
+            if( ( pxPipeline->xMinRTT == 0U ) || ( xRTT < pxPipeline->xMinRTT ) )
+            {
+                pxPipeline->xMinRTT = xRTT;
+            }
+
+            if( pxPipeline->xSmoothedRTT == 0U )
+            {
+                pxPipeline->xSmoothedRTT = xRTT;
+            }
+            else
+            {
+                pxPipeline->xSmoothedRTT = ( ( 7U * pxPipeline->xSmoothedRTT ) + xRTT ) / 8U;
+            }
+        }
+
+        pxRange->ulOutstanding--;
+        pxPipeline->ulInFlight--;
+
+        for( ulIndex = 0; ulIndex < pxPipeline->ulMaxRanges; ulIndex++ )
+        {
+            pxOlder = &pxPipeline->xRanges[ ulIndex ];
+
+            if( ( pxOlder->ulOutstanding > 0U ) &&
+                ( ( int32_t ) ( pxOlder->ulSequence - pxRange->ulSequence ) < 0 ) )
+            {
+                bLost = prvPipelineDrop( pxPipeline, pxOlder ) || bLost;
+            }
+        }
+
+        if( bLost )
+        {
+            pxPipeline->ulWindow = ( pxPipeline->ulWindow > 1U ) ? ( pxPipeline->ulWindow / 2U ) : 1U;
+        }
+        else if( ( pxRange->ulOutstanding == 0U ) &&
+                 ( pxPipeline->xSmoothedRTT <= ( 2U * pxPipeline->xMinRTT ) ) )
+        {
+            ulMaxWindow = pxPipeline->ulMaxRanges * pxPipeline->ulMaxRangeBlocks;
+            pxPipeline->ulWindow += ( pxRange->ulRequested > 1U ) ? ( pxRange->ulRequested / 2U ) : 1U;
+
+            if( pxPipeline->ulWindow > ulMaxWindow )
+            {
+                pxPipeline->ulWindow = ulMaxWindow;
+            }
+        }
+        else
+        {
+            /* Keep the window as it is. */
+        }
+    }
+}
+
+/*
+ * prvPipelineTimeout
+ *
+ * Every request in flight is dropped so its missing blocks are requested again, and the window is
+ * halved unless the loss was already accounted for.
+ */
+static void prvPipelineTimeout( OTA_AgentContext_t * pxAgentCtx )
+{
+    OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+    uint32_t ulIndex = 0;
+    bool bLost = false;
+
+    for( ulIndex = 0; ulIndex < pxPipeline->ulMaxRanges; ulIndex++ )
+    {
+        if( pxPipeline->xRanges[ ulIndex ].ulOutstanding > 0U )
+        {
+            bLost = prvPipelineDrop( pxPipeline, &pxPipeline->xRanges[ ulIndex ] ) || bLost;
+        }
+    }
+
+    if( bLost )
+    {
+        pxPipeline->ulWindow = ( pxPipeline->ulWindow > 1U ) ? ( pxPipeline->ulWindow / 2U ) : 1U;
+    }
+}
+
+/*
+ * prvPipelineWantsRequest
+ *
+ * Ask for more blocks once there is a free request slot and at least half a request worth of room
+ * in the window, as long as some missing blocks are not requested yet.
+ */
+static bool prvPipelineWantsRequest( const OTA_AgentContext_t * pxAgentCtx )
+{
+    const OTA_Pipeline_t * pxPipeline = &pxAgentCtx->xPipeline;
+    const OTA_FileContext_t * C = &pxAgentCtx->pxOTA_Files[ pxAgentCtx->ulFileIndex ];
+    uint32_t ulActive = 0;
+    uint32_t ulIndex = 0;
+    uint32_t ulThreshold = 0;
+
+    for( ulIndex = 0; ulIndex < pxPipeline->ulMaxRanges; ulIndex++ )
+    {
+        if( pxPipeline->xRanges[ ulIndex ].ulOutstanding > 0U )
+        {
+            ulActive++;
+        }
+    }
+
+    ulThreshold = ( pxPipeline->ulWindow < pxPipeline->ulMaxRangeBlocks ) ? pxPipeline->ulWindow : pxPipeline->ulMaxRangeBlocks;
+    ulThreshold = ( ulThreshold > 1U ) ? ( ulThreshold / 2U ) : 1U;
+
+    return ( ulActive < pxPipeline->ulMaxRanges ) &&
+           ( C->ulBlocksRemaining > pxPipeline->ulInFlight ) &&
+           ( ( pxPipeline->ulInFlight + ulThreshold ) <= pxPipeline->ulWindow );
+}
+
+/*
+ * prvPipelineFindRange
+ *
+ * Spans of requests in flight never overlap, so at most one of them covers the block.
+ */
+static OTA_BlockRange_t * prvPipelineFindRange( OTA_Pipeline_t * pxPipeline,
+                                                uint32_t ulBlockIndex )
+{
+    OTA_BlockRange_t * pxRange = NULL;
+    uint32_t ulIndex = 0;
+
+    for( ulIndex = 0; ulIndex < pxPipeline->ulMaxRanges; ulIndex++ )
+    {
+        if( ( pxPipeline->xRanges[ ulIndex ].ulOutstanding > 0U ) &&
+            ( ulBlockIndex >= pxPipeline->xRanges[ ulIndex ].ulFirstBlock ) &&
+            ( ulBlockIndex < pxPipeline->xRanges[ ulIndex ].ulEndBlock ) )
+        {
+            pxRange = &pxPipeline->xRanges[ ulIndex ];
+            break;
+        }
+    }
+
+    return pxRange;
+}
+
+/*
+ * prvPipelineDrop
+ *
+ * Losses of requests sent before the last time the window was halved are part of the same loss
+ * event, so they don't shrink the window again.
+ */
+static bool prvPipelineDrop( OTA_Pipeline_t * pxPipeline,
+                             OTA_BlockRange_t * pxRange )
+{
+    bool bNewLoss = ( int32_t ) ( pxRange->ulSequence - pxPipeline->ulRecoverSequence ) >= 0;
+
+    IOT_METRICS_COUNT( IOT_METRICS_OTA_REQUESTS_LOST );
+
+    pxPipeline->ulInFlight -= pxRange->ulOutstanding;
+    pxRange->ulOutstanding = 0U;
+
+    if( bNewLoss )
+    {
+        pxPipeline->ulRecoverSequence = pxPipeline->ulNextSequence;
+    }
+
+    return bNewLoss;
+}
+
 /*
  * Clean up after the OTA process is done. Possibly free memory for re-use.
  */
@@ -56,6 +56,43 @@
     #define OTA_NUM_MSG_Q_ENTRIES    20U                   /* Maximum number of entries in the OTA message queue. */
 #endif
 
+/* Streaming signature verification. When enabled, the agent hashes the file as its blocks are
+ * ingested and the PAL only finalizes the signature on close, instead of reading the file back.
+ * The hash covers the received bytes, so a PAL that enables it must fail xWriteBlock when the
+ * data read back from flash differs from what was written. */
+#ifndef otaconfigSTREAMING_SIGNATURE_VERIFICATION
+    #define otaconfigSTREAMING_SIGNATURE_VERIFICATION    0U
+#endif
+#ifndef otaconfigSTREAMING_REORDER_BLOCKS
+    #define otaconfigSTREAMING_REORDER_BLOCKS            4U /* Out of order blocks held in RAM until the blocks before them arrive. */
+#endif
+#if ( otaconfigSTREAMING_REORDER_BLOCKS < 1U ) || ( otaconfigSTREAMING_REORDER_BLOCKS > 32U )
+    #error "otaconfigSTREAMING_REORDER_BLOCKS must be between 1 and 32."
+#endif
+
+/* Pipelined block requests. The data plane keeps up to this many block requests outstanding and
+ * sends the next one before the previous one is drained, so the link is not idle for a round trip
+ * between requests. 1 keeps a single request in flight. */
+#ifndef otaconfigMAX_REQUESTS_IN_FLIGHT
+    #define otaconfigMAX_REQUESTS_IN_FLIGHT    1U
+#endif
+#if ( otaconfigMAX_REQUESTS_IN_FLIGHT < 1U )
+    #error "otaconfigMAX_REQUESTS_IN_FLIGHT must be at least 1."
+#endif
+
+/* Resumable downloads. When enabled, the agent periodically saves the received block bitmap and the
+ * streaming signature verification state through the PAL, so that a download interrupted by a reset
+ * continues with the missing blocks instead of starting over. */
+#ifndef otaconfigRESUME_DOWNLOAD
+    #define otaconfigRESUME_DOWNLOAD               0U
+#endif
+#ifndef otaconfigCHECKPOINT_INTERVAL_BLOCKS
+    #define otaconfigCHECKPOINT_INTERVAL_BLOCKS    32U /* Blocks received between two saved checkpoints. */
+#endif
+#if ( otaconfigCHECKPOINT_INTERVAL_BLOCKS < 1U )
+    #error "otaconfigCHECKPOINT_INTERVAL_BLOCKS must be at least 1."
+#endif
+
 /* Job document parser constants. */
 #define OTA_MAX_JSON_TOKENS         64U                                                                         /* Number of JSON tokens supported in a single parser call. */
 #define OTA_MAX_JSON_STR_LEN        256U                                                                        /* Limit our JSON string compares to something small to avoid going into the weeds. */
@@ -238,6 +275,51 @@ typedef struct ota_agent_statistics
     uint32_t ulOTA_PacketsDropped;   /* Number of OTA packets dropped due to congestion. */
 } OTA_AgentStatistics_t;
 
+/* A span of file blocks asked for in a single data plane request. */
+
+typedef struct
+{
+    uint32_t ulFirstBlock;  /* Index of the first block of the span. */
+    uint32_t ulEndBlock;    /* Index one past the last block of the span. */
+    uint32_t ulRequested;   /* Number of missing blocks of the span that were requested. */
+    uint32_t ulOutstanding; /* Requested blocks not received yet. The range is free when this is 0. */
+    uint32_t ulSequence;    /* Order in which the request was sent. */
+    TickType_t xSentTime;   /* Tick count when the request was sent. */
+} OTA_BlockRange_t;
+
+/* The window of block requests kept in flight by the data plane. The window size is in blocks. It
+ * grows while requests complete without loss and the round trip time stays close to the smallest
+ * one seen, and it is halved when blocks are lost. */
+
+typedef struct
+{
+    OTA_BlockRange_t xRanges[ otaconfigMAX_REQUESTS_IN_FLIGHT ]; /* Requests in flight. */
+    uint32_t ulMaxRanges;                                        /* Number of requests the data plane can keep in flight. */
+    uint32_t ulMaxRangeBlocks;                                   /* Number of blocks the data plane can ask for in one request. */
+    uint32_t ulWindow;                                           /* Current window size in blocks. */
+    uint32_t ulInFlight;                                         /* Blocks requested and not received yet. */
+    uint32_t ulNextSequence;                                     /* Sequence number of the next request. */
+    uint32_t ulRecoverSequence;                                  /* Losses in requests older than this were already accounted for. */
+    TickType_t xSmoothedRTT;                                     /* Smoothed time from a request to its first block. */
+    TickType_t xMinRTT;                                          /* Smallest time from a request to its first block. */
+} OTA_Pipeline_t;
+
+/* The header of a download checkpoint saved through the PAL. It is followed by the block bitmap of
+ * the file and by the signature verification state, if any. */
+
+#define OTA_CHECKPOINT_MAGIC         0x4f544143UL /* Marks a saved checkpoint ("OTAC"). */
+#define OTA_CHECKPOINT_HASH_BASIS    0x811c9dc5UL /* FNV-1a offset basis of the checkpoint hashes. */
+
+typedef struct
+{
+    uint32_t ulMagic;        /* OTA_CHECKPOINT_MAGIC. */
+    uint32_t ulChecksum;     /* Hash of the rest of the checkpoint, to detect a partly written one. */
+    uint32_t ulFileHash;     /* Hash of the job name, stream, file ID, size and signature of the file. */
+    uint32_t ulBitmapLen;    /* Bytes of block bitmap following the header. */
+    uint32_t ulHashedBlocks; /* Blocks of the file added to the saved signature verification state. */
+    uint32_t ulHashStateLen; /* Bytes of signature verification state following the bitmap, or 0. */
+} OTA_Checkpoint_t;
+
 /* The OTA agent is a singleton today. The structure keeps it nice and organized. */
 
 typedef struct ota_agent_context
@@ -256,7 +338,8 @@ typedef struct ota_agent_context
     QueueHandle_t xOTA_EventQueue;                          /* Event queue for communicating with the OTA Agent task. */
     OTA_ImageState_t eImageState;                           /* The current application image state. */
     OTA_PAL_Callbacks_t xPALCallbacks;                      /* Variable to store PAL callbacks */
-    uint32_t ulNumOfBlocksToReceive;                        /* Number of data blocks to receive per data request. */
+    OTA_Pipeline_t xPipeline;                               /* Window of data block requests in flight. */
+    uint32_t ulCheckpointBlocks;                            /* Blocks received since the last download checkpoint. */
     OTA_AgentStatistics_t xStatistics;                      /* The OTA agent statistics block. */
     SemaphoreHandle_t xOTA_ThreadSafetyMutex;               /* Mutex used to ensure thread safety while managing data buffers. */
     uint32_t ulRequestMomentum;                             /* The number of requests sent before a response was received. */
@@ -287,6 +370,34 @@ OTA_EventData_t * prvOTAEventBufferGet( void );
  */
 void prvOTAEventBufferFree( OTA_EventData_t * const pxBuffer );
 
+/*
+ * Reset the window of data block requests for a new file transfer.
+ *
+ * ulMaxRanges is the number of requests the data plane can keep in flight and ulMaxRangeBlocks the
+ * number of blocks it can ask for in a single request.
+ */
+void prvOTAPipelineReset( OTA_AgentContext_t * pxAgentCtx,
+                          uint32_t ulMaxRanges,
+                          uint32_t ulMaxRangeBlocks );
+
+/*
+ * Reserve the next span of missing blocks that is not already requested.
+ *
+ * Returns the number of missing blocks in [*pulFirstBlock, *pulEndBlock), or 0 if the window is
+ * full or every missing block is already requested. If bContiguous is true the span only holds
+ * missing blocks. A reserved span must be sent, or given back with prvOTAPipelineCancel.
+ */
+uint32_t prvOTAPipelineReserve( OTA_AgentContext_t * pxAgentCtx,
+                                bool bContiguous,
+                                uint32_t * pulFirstBlock,
+                                uint32_t * pulEndBlock );
+
+/*
+ * Give back a span reserved by prvOTAPipelineReserve that could not be requested.
+ */
+void prvOTAPipelineCancel( OTA_AgentContext_t * pxAgentCtx,
+                           uint32_t ulFirstBlock );
+
 /*
  * Signal event to the OTA Agent task.
  *
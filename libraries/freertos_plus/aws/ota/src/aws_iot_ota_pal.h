@@ -196,4 +196,55 @@ OTA_Err_t prvPAL_SetPlatformImageState( OTA_ImageState_t eState );
  */
 OTA_PAL_ImageState_t prvPAL_GetPlatformImageState( void );
 
+/**
+ * @brief Save a checkpoint of the download in progress to non-volatile memory.
+ *
+ * Only used if otaconfigRESUME_DOWNLOAD is 1. The checkpoint is opaque to the PAL and replaces the
+ * previously saved one. Calling with a NULL pucData and a zero ulSize erases the saved checkpoint.
+ *
+ * @note The blocks recorded as received in the checkpoint have been written with prvPAL_WriteBlock()
+ * before this function is called, so they must be in non-volatile memory when it returns.
+ *
+ * @param[in] C OTA file context information.
+ * @param[in] pucData Pointer to the checkpoint.
+ * @param[in] ulSize Size of the checkpoint in bytes.
+ *
+ * @return kOTA_Err_None on success, or kOTA_Err_CheckpointFailed if the checkpoint could not be saved
+ * (e.g. it is larger than the space the platform reserves for it).
+ */
+OTA_Err_t prvPAL_SaveCheckpoint( OTA_FileContext_t * const C,
+                                 const uint8_t * pucData,
+                                 uint32_t ulSize );
+
+/**
+ * @brief Load the checkpoint saved by prvPAL_SaveCheckpoint().
+ *
+ * Only used if otaconfigRESUME_DOWNLOAD is 1. The OTA agent validates the checkpoint, so the PAL may
+ * return whatever is in its storage, including a partly written checkpoint.
+ *
+ * @param[in] C OTA file context information.
+ * @param[out] pucData Buffer receiving the checkpoint.
+ * @param[in] ulSize Size of the buffer in bytes. It may be larger than the saved checkpoint.
+ *
+ * @return kOTA_Err_None if data was loaded, or kOTA_Err_CheckpointFailed if there is nothing to load.
+ */
+OTA_Err_t prvPAL_LoadCheckpoint( OTA_FileContext_t * const C,
+                                 uint8_t * const pucData,
+                                 uint32_t ulSize );
+
+/**
+ * @brief Reopen the receive file of an interrupted download without erasing it.
+ *
+ * Only used if otaconfigRESUME_DOWNLOAD is 1. This is called instead of prvPAL_CreateFileForRx()
+ * when a checkpoint matching the file of the job was found. C->pucRxBlockBitmap and
+ * C->ulBlocksRemaining describe the blocks already written. The PAL may mark blocks as missing again
+ * if it can't resume from them, updating both.
+ *
+ * @param[in] C OTA file context information.
+ *
+ * @return kOTA_Err_None if the file was reopened, or an error code as for prvPAL_CreateFileForRx(),
+ * in which case the OTA agent creates the file again.
+ */
+OTA_Err_t prvPAL_ResumeFileForRx( OTA_FileContext_t * const C );
+
 #endif /* ifndef _AWS_OTA_PAL_H_ */
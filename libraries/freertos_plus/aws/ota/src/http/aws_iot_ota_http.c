@@ -29,6 +29,10 @@
 #include <string.h>
 #include <stdio.h>
 
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
 /* Error handling from C-SDK. */
 #include "private/iot_error.h"
 
@@ -131,6 +135,14 @@
  */
 #define HTTP_HEADER_CONNECTION_VALUE_MAX_LEN    ( sizeof( "keep-alive" ) )
 
+/**
+ * Blocks of a range are handed to the OTA agent as they are read. When all OTA data buffers are in
+ * use, reading the response waits up to HTTP_BUFFER_WAIT_TIMEOUT_MS for the agent to free one,
+ * checking every HTTP_BUFFER_WAIT_INTERVAL_MS, before the block is dropped.
+ */
+#define HTTP_BUFFER_WAIT_TIMEOUT_MS             1000
+#define HTTP_BUFFER_WAIT_INTERVAL_MS            10
+
 /* Struct for HTTP callback data. */
 typedef struct _httpCallbackData
 {
@@ -198,8 +210,11 @@ typedef struct _httpDownloader
     _httpRequest_t httpRequest;           /* HTTP request data. */
     _httpResponse_t httpResponse;         /* HTTP response data. */
     _httpCallbackData_t httpCallbackData; /* Data used in the HTTP callback. */
-    uint32_t currBlock;                   /* Current requesting block in bitmap. */
-    uint32_t currBlockSize;               /* Size of current requesting block. */
+    uint32_t currBlock;                   /* Block of the current range being received. */
+    uint32_t currBlockSize;               /* Size of the block being received. */
+    uint32_t currBlockReceived;           /* Bytes of the block being received that are in the body buffer. */
+    uint32_t endBlock;                    /* Block one past the end of the current range. */
+    uint32_t rangeLength;                 /* Length in bytes of the current range. */
 } _httpDownloader_t;
 
 /* Global HTTP downloader instance. */
@@ -285,9 +300,10 @@ static void _httpFreeBuffers()
     }
 }
 
-/* Process the HTTP response body, copy to another buffer and signal OTA agent the file block
- * download is complete. */
+/* Copy a file block read from the HTTP response to an OTA data buffer, after the index of the
+ * block, and signal OTA agent the file block download is complete. */
 static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
+                                      uint32_t blockIndex,
                                       uint8_t * pHTTPResponseBody,
                                       uint32_t bufferSize )
 {
@@ -295,12 +311,23 @@ static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
 
     OTA_EventData_t * pMessage;
     OTA_EventMsg_t eventMsg = { 0 };
+    uint32_t waitTime = 0;
 
     pAgentCtx->xStatistics.ulOTA_PacketsReceived++;
 
-    /* Try to get OTA data buffer. */
+    /* Try to get OTA data buffer. The rest of the range is still to be read from the network, so
+     * rather wait for the OTA agent to free a buffer than drop the block. */
     pMessage = prvOTAEventBufferGet();
 
+    while( ( pMessage == NULL ) &&
+           ( waitTime < HTTP_BUFFER_WAIT_TIMEOUT_MS ) &&
+           ( _httpDownloader.state != OTA_HTTP_STOPPED ) )
+    {
+        vTaskDelay( pdMS_TO_TICKS( HTTP_BUFFER_WAIT_INTERVAL_MS ) );
+        waitTime += HTTP_BUFFER_WAIT_INTERVAL_MS;
+        pMessage = prvOTAEventBufferGet();
+    }
+
     if( pMessage == NULL )
     {
         pAgentCtx->xStatistics.ulOTA_PacketsDropped++;
@@ -308,14 +335,40 @@ static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
     }
     else
     {
-        pMessage->ulDataLength = bufferSize;
+        pMessage->ulDataLength = sizeof( blockIndex ) + bufferSize;
 
-        memcpy( pMessage->ucData, pHTTPResponseBody, pMessage->ulDataLength );
+        memcpy( pMessage->ucData, &blockIndex, sizeof( blockIndex ) );
+        memcpy( pMessage->ucData + sizeof( blockIndex ), pHTTPResponseBody, bufferSize );
         eventMsg.xEventId = eOTA_AgentEvent_ReceivedFileBlock;
         eventMsg.pxEventData = pMessage;
-        /* Send job document received event. */
-        OTA_SignalEvent( &eventMsg );
+
+        /* Send file block received event. */
+        if( !OTA_SignalEvent( &eventMsg ) )
+        {
+            pAgentCtx->xStatistics.ulOTA_PacketsDropped++;
+            prvOTAEventBufferFree( pMessage );
+        }
+    }
+}
+
+/* Size of the next block to read from the current range, 0 at the end of the range. */
+static uint32_t _httpNextBlockSize( void )
+{
+    uint32_t blockSize = 0;
+    uint32_t fileSize = 0;
+
+    if( _httpDownloader.currBlock < _httpDownloader.endBlock )
+    {
+        fileSize = _httpDownloader.pAgentCtx->pxOTA_Files[ _httpDownloader.pAgentCtx->ulFileIndex ].ulFileSize;
+        blockSize = fileSize - ( _httpDownloader.currBlock * OTA_FILE_BLOCK_SIZE );
+
+        if( blockSize > OTA_FILE_BLOCK_SIZE )
+        {
+            blockSize = OTA_FILE_BLOCK_SIZE;
+        }
     }
+
+    return blockSize;
 }
 
 /* Error handler for HTTP response code. */
@@ -443,6 +496,9 @@ static void _httpReadReadyCallback( void * pPrivateData,
     /* Buffer to read the "Connection" field in HTTP header. */
     char connectionValueStr[ HTTP_HEADER_CONNECTION_VALUE_MAX_LEN ] = { 0 };
 
+    /* This callback is invoked until the whole body is read, the header is only checked the first time. */
+    bool firstRead = false;
+
     /* Bail out if this callback is invoked after http downloader stopped. */
     if( _httpDownloader.state == OTA_HTTP_STOPPED )
     {
@@ -450,80 +506,118 @@ static void _httpReadReadyCallback( void * pPrivateData,
         return;
     }
 
-    /* A response is received from the server, setting the state to processing response. */
-    _httpDownloader.state = OTA_HTTP_PROCESSING_RESPONSE;
+    if( _httpDownloader.state != OTA_HTTP_PROCESSING_RESPONSE )
+    {
+        /* A response is received from the server, setting the state to processing response. */
+        _httpDownloader.state = OTA_HTTP_PROCESSING_RESPONSE;
+        firstRead = true;
 
-    /* Read the data from the network. */
-    responseBodyLength = HTTPS_RESPONSE_BODY_BUFFER_SIZE;
-    httpsStatus = IotHttpsClient_ReadResponseBody( responseHandle,
-                                                   pResponseBodyBuffer,
-                                                   &responseBodyLength );
+        /* The HTTP response should be partial content with response code 206. */
+        if( responseStatus != IOT_HTTPS_STATUS_PARTIAL_CONTENT )
+        {
+            IotLogError( "Expect a HTTP partial response, but received code %d", responseStatus );
+
+            /* Read the error message from the server. */
+            responseBodyLength = HTTPS_RESPONSE_BODY_BUFFER_SIZE;
+            ( void ) IotHttpsClient_ReadResponseBody( responseHandle,
+                                                      pResponseBodyBuffer,
+                                                      &responseBodyLength );
+            _httpErrorHandler( responseStatus );
+            OTA_GOTO_CLEANUP();
+        }
 
-    if( httpsStatus != IOT_HTTPS_OK )
-    {
-        IotLogError( "Failed to read the response body. Error code: %d.", httpsStatus );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-        OTA_GOTO_CLEANUP();
+        /* Read the "Content-Length" field from HTTP header. */
+        httpsStatus = IotHttpsClient_ReadContentLength( responseHandle, &contentLength );
+
+        if( ( httpsStatus != IOT_HTTPS_OK ) || ( contentLength == 0 ) )
+        {
+            IotLogError( "Failed to retrieve the Content-Length from the response. " );
+            _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+            OTA_GOTO_CLEANUP();
+        }
+
+        /* Check if the value of "Content-Length" matches what we have requested. */
+        if( contentLength != _httpDownloader.rangeLength )
+        {
+            IotLogError( "Content-Length value in HTTP header does not match what we requested. " );
+            _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+            OTA_GOTO_CLEANUP();
+        }
     }
 
-    /* The HTTP response should be partial content with response code 206. */
-    if( responseStatus != IOT_HTTPS_STATUS_PARTIAL_CONTENT )
+    if( _httpDownloader.currBlockReceived == _httpDownloader.currBlockSize )
     {
-        IotLogError( "Expect a HTTP partial response, but received code %d", responseStatus );
-        _httpErrorHandler( responseStatus );
+        IotLogError( "Received more data than the requested range." );
+        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
         OTA_GOTO_CLEANUP();
     }
 
-    /* Read the "Content-Length" field from HTTP header. */
-    httpsStatus = IotHttpsClient_ReadContentLength( responseHandle, &contentLength );
+    /* Read the rest of the current block from the network. */
+    responseBodyLength = _httpDownloader.currBlockSize - _httpDownloader.currBlockReceived;
+    httpsStatus = IotHttpsClient_ReadResponseBody( responseHandle,
+                                                   pResponseBodyBuffer + _httpDownloader.currBlockReceived,
+                                                   &responseBodyLength );
 
-    if( ( httpsStatus != IOT_HTTPS_OK ) || ( contentLength == 0 ) )
+    if( httpsStatus != IOT_HTTPS_OK )
     {
-        IotLogError( "Failed to retrieve the Content-Length from the response. " );
+        IotLogError( "Failed to read the response body. Error code: %d.", httpsStatus );
         _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
         OTA_GOTO_CLEANUP();
     }
 
-    /* Check if the value of "Content-Length" matches what we have requested. */
-    if( contentLength != _httpDownloader.currBlockSize )
+    _httpDownloader.currBlockReceived += responseBodyLength;
+
+    /* Hand the block to the OTA agent once it is complete and move on to the next one. The last
+     * block of the range is handed over when the response is complete. */
+    if( ( _httpDownloader.currBlockReceived == _httpDownloader.currBlockSize ) &&
+        ( ( _httpDownloader.currBlock + 1 ) < _httpDownloader.endBlock ) )
     {
-        IotLogError( "Content-Length value in HTTP header does not match what we requested. " );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-        OTA_GOTO_CLEANUP();
+        _httpProcessResponseBody( _httpDownloader.pAgentCtx,
+                                  _httpDownloader.currBlock,
+                                  pResponseBodyBuffer,
+                                  _httpDownloader.currBlockSize );
+
+        _httpDownloader.currBlock += 1;
+        _httpDownloader.currBlockReceived = 0;
+        _httpDownloader.currBlockSize = _httpNextBlockSize();
     }
 
     OTA_FUNCTION_CLEANUP_BEGIN();
 
     /* The connection could be closed by S3 after 100 requests, so we need to check the value
      * of the "Connection" filed in HTTP header to see if we need to reconnect. */
-    memset( connectionValueStr, 0, sizeof( connectionValueStr ) );
-    httpsStatus = IotHttpsClient_ReadHeader( responseHandle,
-                                             "Connection",
-                                             sizeof( "Connection" ) - 1,
-                                             connectionValueStr,
-                                             sizeof( connectionValueStr ) );
-
-    /* Check if there is any other error besides not found when parsing the http header. */
-    if( ( httpsStatus != IOT_HTTPS_OK ) && ( httpsStatus != IOT_HTTPS_NOT_FOUND ) )
-    {
-        IotLogError( "Failed to read header Connection. Error code: %d.", httpsStatus );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-    }
-    else
+    if( firstRead )
     {
-        /* Check if the server returns a response with connection field set to "close". */
-        if( strncmp( "close", connectionValueStr, sizeof( "close" ) ) == 0 )
+        memset( connectionValueStr, 0, sizeof( connectionValueStr ) );
+        httpsStatus = IotHttpsClient_ReadHeader( responseHandle,
+                                                 "Connection",
+                                                 sizeof( "Connection" ) - 1,
+                                                 connectionValueStr,
+                                                 sizeof( connectionValueStr ) );
+
+        /* Check if there is any other error besides not found when parsing the http header. */
+        if( ( httpsStatus != IOT_HTTPS_OK ) && ( httpsStatus != IOT_HTTPS_NOT_FOUND ) )
+        {
+            IotLogError( "Failed to read header Connection. Error code: %d.", httpsStatus );
+            _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+        }
+        else
         {
-            IotLogInfo( "Connection has been closed by the HTTP server, reconnect in next request." );
-            _httpDownloader.err = OTA_HTTP_ERR_NEED_RECONNECT;
+            /* Check if the server returns a response with connection field set to "close". */
+            if( strncmp( "close", connectionValueStr, sizeof( "close" ) ) == 0 )
+            {
+                IotLogInfo( "Connection has been closed by the HTTP server, reconnect in next request." );
+                _httpDownloader.err = OTA_HTTP_ERR_NEED_RECONNECT;
+            }
         }
     }
 
     /* Cancel receiving the response in case of error, _httpErrorCallback will be invoked next.
      * If the HTTP error is IOT_HTTPS_NETWORK_ERROR, the connection will then be closed by the HTTP
      * client, followed by invoking _httpConnectionClosedCallback and _httpResponseCompleteCallback.
-     * In other cases, only _httpResponseCompleteCallback will be invoked. */
-    if( _httpDownloader.err != OTA_HTTP_ERR_NONE )
+     * In other cases, only _httpResponseCompleteCallback will be invoked. A server that closes the
+     * connection still sends the whole range first, so keep reading it. */
+    if( ( _httpDownloader.err != OTA_HTTP_ERR_NONE ) && ( _httpDownloader.err != OTA_HTTP_ERR_NEED_RECONNECT ) )
     {
         IotHttpsClient_CancelResponseAsync( responseHandle );
     }
@@ -553,15 +647,33 @@ static void _httpResponseCompleteCallback( void * pPrivateData,
         return;
     }
 
+    /* Reset the state to idle, the downloader is ready for the next range. */
+    _httpDownloader.state = OTA_HTTP_IDLE;
+
+    /* Hand the last block of the range to the OTA agent now, so it does not request the next range
+     * while this response is still being processed. */
+    if( ( ( _httpDownloader.err == OTA_HTTP_ERR_NONE ) || ( _httpDownloader.err == OTA_HTTP_ERR_NEED_RECONNECT ) ) &&
+        ( ( _httpDownloader.currBlock + 1 ) == _httpDownloader.endBlock ) &&
+        ( _httpDownloader.currBlockReceived == _httpDownloader.currBlockSize ) )
+    {
+        _httpProcessResponseBody( _httpDownloader.pAgentCtx,
+                                  _httpDownloader.currBlock,
+                                  pResponseBodyBuffer,
+                                  _httpDownloader.currBlockSize );
+
+        _httpDownloader.currBlock += 1;
+        _httpDownloader.currBlockReceived = 0;
+    }
+
     if( _httpDownloader.err == OTA_HTTP_ERR_NONE )
     {
-        _httpProcessResponseBody( _httpDownloader.pAgentCtx, pResponseBodyBuffer, _httpDownloader.currBlockSize );
+        if( _httpDownloader.currBlock != _httpDownloader.endBlock )
+        {
+            IotLogError( "Range ended at block %d before block %d.", _httpDownloader.currBlock, _httpDownloader.endBlock );
+        }
     }
     else
     {
-        /* Reset the state to idle when current download fails. */
-        _httpDownloader.state = OTA_HTTP_IDLE;
-
         switch( _httpDownloader.err )
         {
             case OTA_HTTP_ERR_NEED_RECONNECT:
@@ -901,7 +1013,8 @@ static _httpErr _requestDataBlockPreCheck()
             status = OTA_HTTP_ERR_NEED_RECONNECT;
         }
     }
-    else if( _httpDownloader.state == OTA_HTTP_WAITING_RESPONSE )
+    else if( ( _httpDownloader.state == OTA_HTTP_WAITING_RESPONSE ) ||
+             ( _httpDownloader.state == OTA_HTTP_PROCESSING_RESPONSE ) )
     {
         IotLogInfo( "Still waiting for a response from the server after request timeout. Assuming "
                     "the connection is closed by the server, reconnecting..." );
@@ -1034,6 +1147,10 @@ OTA_Err_t _AwsIotOTA_InitFileTransfer_HTTP( OTA_AgentContext_t * pAgentCtx )
         OTA_GOTO_CLEANUP();
     }
 
+    /* The HTTP client sends the requests of a connection one after the other, so only one range
+     * is requested at a time. The request window sets how many blocks the range holds. */
+    prvOTAPipelineReset( pAgentCtx, 1U, otaconfigMAX_NUM_BLOCKS_REQUEST );
+
     /* Exit directly if everything succeed. */
     IotLogInfo( "Start requesting %u bytes from HTTP server.", ( unsigned int ) httpFileSize );
 
@@ -1071,6 +1188,11 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
     uint32_t rangeEnd = 0;
     int numWritten = 0;
 
+    /* Blocks reserved in the OTA agent request window for this range. */
+    uint32_t firstBlock = 0;
+    uint32_t endBlock = 0;
+    uint32_t blockCount = 0;
+
     /* File context from OTA agent. */
     OTA_FileContext_t * fileContext = &( pAgentCtx->pxOTA_Files[ pAgentCtx->ulFileIndex ] );
 
@@ -1091,22 +1213,31 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
         OTA_GOTO_CLEANUP();
     }
 
-    /* Set number of blocks to request to 1. */
-    pAgentCtx->ulNumOfBlocksToReceive = 1;
+    /* Reserve the next run of missing blocks, there is nothing to do if they are all requested. */
+    blockCount = prvOTAPipelineReserve( pAgentCtx, true, &firstBlock, &endBlock );
 
-    /* Calculate ranges. */
-    rangeStart = _httpDownloader.currBlock * OTA_FILE_BLOCK_SIZE;
-
-    if( fileContext->ulBlocksRemaining == 1 )
+    if( blockCount == 0 )
     {
-        rangeEnd = fileContext->ulFileSize - 1;
+        _httpDownloader.state = OTA_HTTP_IDLE;
+        OTA_GOTO_CLEANUP();
     }
-    else
+
+    /* Calculate ranges. */
+    rangeStart = firstBlock * OTA_FILE_BLOCK_SIZE;
+    rangeEnd = endBlock * OTA_FILE_BLOCK_SIZE;
+
+    if( rangeEnd > fileContext->ulFileSize )
     {
-        rangeEnd = rangeStart + OTA_FILE_BLOCK_SIZE - 1;
+        rangeEnd = fileContext->ulFileSize;
     }
 
-    _httpDownloader.currBlockSize = rangeEnd - rangeStart + 1;
+    rangeEnd -= 1;
+
+    _httpDownloader.currBlock = firstBlock;
+    _httpDownloader.endBlock = endBlock;
+    _httpDownloader.rangeLength = rangeEnd - rangeStart + 1;
+    _httpDownloader.currBlockReceived = 0;
+    _httpDownloader.currBlockSize = _httpNextBlockSize();
 
     /* Creating the "range" field in HTTP header. */
     numWritten = snprintf( _httpDownloader.httpCallbackData.pRangeValueStr,
@@ -1133,7 +1264,7 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
     }
 
     /* Send the request asynchronously. Receiving is handled in a callback. */
-    IotLogInfo( "Sending HTTP request to download block %d.", _httpDownloader.currBlock );
+    IotLogInfo( "Sending HTTP request to download blocks %d-%d.", firstBlock, endBlock - 1 );
     httpsStatus = IotHttpsClient_SendAsync( pConnection->connectionHandle,
                                             pRequest->requestHandle,
                                             &pResponse->responseHandle,
@@ -1152,6 +1283,11 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
     if( status != kOTA_Err_None )
     {
         _httpDownloader.state = OTA_HTTP_IDLE;
+
+        if( blockCount > 0 )
+        {
+            prvOTAPipelineCancel( pAgentCtx, firstBlock );
+        }
     }
 
     OTA_FUNCTION_CLEANUP_END();
@@ -1169,20 +1305,29 @@ OTA_Err_t _AwsIotOTA_DecodeFileBlock_HTTP( uint8_t * pMessageBuffer,
 {
     IotLogDebug( "Invoking _AwsIotOTA_DecodeFileBlock_HTTP" );
 
-    /* Unused parameters. */
-    ( void ) messageSize;
+    /* Return status. */
+    OTA_Err_t status = kOTA_Err_None;
 
-    *pPayload = pMessageBuffer;
-    *pFileId = 0;
-    *pBlockId = _httpDownloader.currBlock;
-    *pBlockSize = _httpDownloader.currBlockSize;
-    *pPayloadSize = _httpDownloader.currBlockSize;
+    /* Index of the block, stored in front of it by _httpProcessResponseBody. */
+    uint32_t blockIndex = 0;
 
-    /* Current block is processed, set the file block to next one and the state to idle. */
-    _httpDownloader.state = OTA_HTTP_IDLE;
-    _httpDownloader.currBlock += 1;
+    if( messageSize <= sizeof( blockIndex ) )
+    {
+        IotLogError( "File block message of %d bytes is too short.", messageSize );
+        status = kOTA_Err_GenericIngestError;
+    }
+    else
+    {
+        memcpy( &blockIndex, pMessageBuffer, sizeof( blockIndex ) );
 
-    return kOTA_Err_None;
+        *pPayload = pMessageBuffer + sizeof( blockIndex );
+        *pFileId = 0;
+        *pBlockId = ( int32_t ) blockIndex;
+        *pBlockSize = ( int32_t ) ( messageSize - sizeof( blockIndex ) );
+        *pPayloadSize = messageSize - sizeof( blockIndex );
+    }
+
+    return status;
 }
 
 
@@ -1211,6 +1356,9 @@ OTA_Err_t _AwsIotOTA_CleanupData_HTTP( OTA_AgentContext_t * pAgentCtx )
     _httpDownloader.err = OTA_HTTP_ERR_NONE;
     _httpDownloader.currBlock = 0;
     _httpDownloader.currBlockSize = 0;
+    _httpDownloader.currBlockReceived = 0;
+    _httpDownloader.endBlock = 0;
+    _httpDownloader.rangeLength = 0;
 
     if( _httpDownloader.pAgentCtx->eState == eOTA_AgentState_ShuttingDown )
     {
@@ -775,6 +775,10 @@ OTA_Err_t prvInitFileTransfer_Mqtt( OTA_AgentContext_t * pxAgentCtx )
     IotMqttSubscription_t xOTAUpdateDataSubscription;
     const OTA_FileContext_t * pFileContext = &( pxAgentCtx->pxOTA_Files[ pxAgentCtx->ulFileIndex ] );
 
+    /* The streaming service answers each get stream request on its own, so several of them can be
+     * kept in flight. */
+    prvOTAPipelineReset( pxAgentCtx, otaconfigMAX_REQUESTS_IN_FLIGHT, otaconfigMAX_NUM_BLOCKS_REQUEST );
+
     memset( &xOTAUpdateDataSubscription, 0, sizeof( xOTAUpdateDataSubscription ) );
     xOTAUpdateDataSubscription.qos = IOT_MQTT_QOS_0;
     xOTAUpdateDataSubscription.pTopicFilter = ( const char * ) pcOTA_RxStreamTopic;
@@ -811,7 +815,9 @@ OTA_Err_t prvInitFileTransfer_Mqtt( OTA_AgentContext_t * pxAgentCtx )
 }
 
 /*
- * Request file block by publishing to the get stream topic.
+ * Request file blocks by publishing to the get stream topic. A request is published for every span
+ * of missing blocks the request window has room for. Each request carries the receive bitmap with
+ * only the blocks of its span set, so requests in flight never ask for the same block twice.
  */
 OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
 {
@@ -821,49 +827,32 @@ OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
     uint32_t ulNumBlocks, ulBitmapLen;
     uint32_t ulMsgSizeToPublish = 0;
     uint32_t ulTopicLen = 0;
+    uint32_t ulRequestBlocks = 0;
+    uint32_t ulFirstBlock = 0;
+    uint32_t ulEndBlock = 0;
+    uint32_t ulBlock = 0;
+    uint8_t ucBitMask = 0;
     IotMqttError_t eResult = IOT_MQTT_STATUS_PENDING;
     OTA_Err_t xErr = kOTA_Err_Uninitialized;
     char pcMsg[ OTA_REQUEST_MSG_MAX_SIZE ];
     char pcTopicBuffer[ OTA_MAX_TOPIC_LEN ];
+    uint8_t pucRequestBitmap[ OTA_MAX_BLOCK_BITMAP_SIZE ];
 
     /*
      * Get the current file context.
      */
     OTA_FileContext_t * C = &( pxAgentCtx->pxOTA_Files[ pxAgentCtx->ulFileIndex ] );
 
-    /* Reset number of blocks requested. */
-    pxAgentCtx->ulNumOfBlocksToReceive = otaconfigMAX_NUM_BLOCKS_REQUEST;
+    ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
+    ulBitmapLen = ( ulNumBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
 
-    if( C != NULL )
+    if( ulBitmapLen > sizeof( pucRequestBitmap ) )
     {
-        ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
-        ulBitmapLen = ( ulNumBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
-
-        if( pdTRUE == OTA_CBOR_Encode_GetStreamRequestMessage(
-                ( uint8_t * ) pcMsg,
-                sizeof( pcMsg ),
-                &xMsgSizeFromStream,
-                OTA_CLIENT_TOKEN,
-                ( int32_t ) C->ulServerFileID,
-                ( int32_t ) ( OTA_FILE_BLOCK_SIZE & 0x7fffffffUL ), /* Mask to keep lint happy. It's still a constant. */
-                0,
-                C->pucRxBlockBitmap,
-                ulBitmapLen,
-                otaconfigMAX_NUM_BLOCKS_REQUEST ) )
-        {
-            xErr = kOTA_Err_None;
-        }
-        else
-        {
-            OTA_LOG_L1( "[%s] CBOR encode failed.\r\n", OTA_METHOD_NAME );
-            xErr = kOTA_Err_FailedToEncodeCBOR;
-        }
+        OTA_LOG_L1( "[%s] Block bitmap of %u bytes is too large.\r\n", OTA_METHOD_NAME, ulBitmapLen );
+        xErr = kOTA_Err_FailedToEncodeCBOR;
     }
-
-    if( xErr == kOTA_Err_None )
+    else
     {
-        ulMsgSizeToPublish = ( uint32_t ) xMsgSizeFromStream;
-
         /* Try to build the dynamic data REQUEST topic to publish to. */
         ulTopicLen = ( uint32_t ) snprintf( pcTopicBuffer, /*lint -e586 Intentionally using snprintf. */
                                             sizeof( pcTopicBuffer ),
@@ -883,25 +872,65 @@ OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
         }
     }
 
-    if( xErr == kOTA_Err_None )
+    while( xErr == kOTA_Err_None )
     {
-        eResult = prvPublishMessage(
-            pxAgentCtx,
-            pcTopicBuffer,
-            ( uint16_t ) ulTopicLen,
-            &pcMsg[ 0 ],
-            ulMsgSizeToPublish,
-            IOT_MQTT_QOS_0 );
+        ulRequestBlocks = prvOTAPipelineReserve( pxAgentCtx, false, &ulFirstBlock, &ulEndBlock );
 
-        if( eResult != IOT_MQTT_SUCCESS )
+        if( ulRequestBlocks == 0U )
         {
-            OTA_LOG_L1( "[%s] Failed: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
-            xErr = kOTA_Err_PublishFailed;
+            /* The window is full or every missing block is already requested. */
+            break;
+        }
+
+        ( void ) memset( pucRequestBitmap, 0, ulBitmapLen );
+
+        for( ulBlock = ulFirstBlock; ulBlock < ulEndBlock; ulBlock++ )
+        {
+            ucBitMask = ( uint8_t ) ( 1U << ( ulBlock % BITS_PER_BYTE ) );
+            pucRequestBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] |= C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ucBitMask;
+        }
+
+        if( pdTRUE == OTA_CBOR_Encode_GetStreamRequestMessage(
+                ( uint8_t * ) pcMsg,
+                sizeof( pcMsg ),
+                &xMsgSizeFromStream,
+                OTA_CLIENT_TOKEN,
+                ( int32_t ) C->ulServerFileID,
+                ( int32_t ) ( OTA_FILE_BLOCK_SIZE & 0x7fffffffUL ), /* Mask to keep lint happy. It's still a constant. */
+                0,
+                pucRequestBitmap,
+                ulBitmapLen,
+                ( int32_t ) ulRequestBlocks ) )
+        {
+            ulMsgSizeToPublish = ( uint32_t ) xMsgSizeFromStream;
+
+            eResult = prvPublishMessage(
+                pxAgentCtx,
+                pcTopicBuffer,
+                ( uint16_t ) ulTopicLen,
+                &pcMsg[ 0 ],
+                ulMsgSizeToPublish,
+                IOT_MQTT_QOS_0 );
+
+            if( eResult != IOT_MQTT_SUCCESS )
+            {
+                OTA_LOG_L1( "[%s] Failed: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
+                xErr = kOTA_Err_PublishFailed;
+            }
+            else
+            {
+                OTA_LOG_L1( "[%s] OK: %s, blocks %u-%u\r\n", OTA_METHOD_NAME, pcTopicBuffer, ulFirstBlock, ulEndBlock - 1U );
+            }
         }
         else
         {
-            OTA_LOG_L1( "[%s] OK: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
-            xErr = kOTA_Err_None;
+            OTA_LOG_L1( "[%s] CBOR encode failed.\r\n", OTA_METHOD_NAME );
+            xErr = kOTA_Err_FailedToEncodeCBOR;
+        }
+
+        if( xErr != kOTA_Err_None )
+        {
+            prvOTAPipelineCancel( pxAgentCtx, ulFirstBlock );
         }
     }
 
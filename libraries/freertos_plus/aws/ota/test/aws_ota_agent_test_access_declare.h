@@ -54,4 +54,29 @@ DocParseErr_t TEST_OTA_prvParseJSONbyModel( const char * pcJSON,
 
 void TEST_OTA_prvSetDataInterfaceMQTT();
 
+void TEST_OTA_prvSetPALCallbacks( const OTA_PAL_Callbacks_t * pxCallbacks );
+
+void TEST_OTA_prvPipelineBlockReceived( OTA_AgentContext_t * pxAgentCtx,
+                                        uint32_t ulBlockIndex );
+
+void TEST_OTA_prvPipelineTimeout( OTA_AgentContext_t * pxAgentCtx );
+
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+    void TEST_OTA_prvStreamVerifyStart( OTA_FileContext_t * const C );
+
+    void TEST_OTA_prvStreamVerifyBlock( OTA_FileContext_t * const C,
+                                        uint32_t ulBlockIndex,
+                                        const uint8_t * pucPayload,
+                                        uint32_t ulBlockSize );
+
+    void TEST_OTA_prvStreamVerifyStop( OTA_FileContext_t * const C );
+#endif
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+    void TEST_OTA_prvCheckpointSave( OTA_FileContext_t * const C );
+
+    bool TEST_OTA_prvCheckpointRestore( OTA_FileContext_t * const C,
+                                        uint32_t ulBitmapLen );
+#endif
+
 #endif /* ifndef _AWS_OTA_AGENT_TEST_ACCESS_DECLARE_H_ */
@@ -76,4 +76,69 @@ void TEST_OTA_prvSetDataInterfaceMQTT()
     prvSetDataInterface( &xOTA_DataInterface, ( const uint8_t * ) "MQTT" );
 }
 
+/*-----------------------------------------------------------*/
+
+void TEST_OTA_prvSetPALCallbacks( const OTA_PAL_Callbacks_t * pxCallbacks )
+{
+    prvSetPALCallbacks( pxCallbacks );
+}
+
+/*-----------------------------------------------------------*/
+
+void TEST_OTA_prvPipelineBlockReceived( OTA_AgentContext_t * pxAgentCtx,
+                                        uint32_t ulBlockIndex )
+{
+    prvPipelineBlockReceived( pxAgentCtx, ulBlockIndex );
+}
+
+/*-----------------------------------------------------------*/
+
+void TEST_OTA_prvPipelineTimeout( OTA_AgentContext_t * pxAgentCtx )
+{
+    prvPipelineTimeout( pxAgentCtx );
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+    void TEST_OTA_prvStreamVerifyStart( OTA_FileContext_t * const C )
+    {
+        prvStreamVerifyStart( C );
+    }
+
+/*-----------------------------------------------------------*/
+
+    void TEST_OTA_prvStreamVerifyBlock( OTA_FileContext_t * const C,
+                                        uint32_t ulBlockIndex,
+                                        const uint8_t * pucPayload,
+                                        uint32_t ulBlockSize )
+    {
+        prvStreamVerifyBlock( C, ulBlockIndex, pucPayload, ulBlockSize );
+    }
+
+/*-----------------------------------------------------------*/
+
+    void TEST_OTA_prvStreamVerifyStop( OTA_FileContext_t * const C )
+    {
+        prvStreamVerifyStop( C );
+    }
+#endif /* if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U ) */
+
+/*-----------------------------------------------------------*/
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+    void TEST_OTA_prvCheckpointSave( OTA_FileContext_t * const C )
+    {
+        prvCheckpointSave( C );
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool TEST_OTA_prvCheckpointRestore( OTA_FileContext_t * const C,
+                                        uint32_t ulBitmapLen )
+    {
+        return prvCheckpointRestore( C, ulBitmapLen );
+    }
+#endif /* if ( otaconfigRESUME_DOWNLOAD == 1U ) */
+
 #endif /* _AWS_OTA_AGENT_TEST_ACCESS_DEFINE_H_ */
@@ -235,6 +235,15 @@ TEST_GROUP_RUNNER( Full_OTA_AGENT )
     RUN_TEST_CASE( Full_OTA_AGENT, OTA_GetStatistics_BeforeInit );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJobDocFromJSONandPrvOTA_Close );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJSONbyModel_Errors );
+    #if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+        RUN_TEST_CASE( Full_OTA_AGENT, prvStreamVerifyBlock_ReorderWindow );
+    #endif
+    #if ( otaconfigMAX_REQUESTS_IN_FLIGHT >= 2U )
+        RUN_TEST_CASE( Full_OTA_AGENT, prvOTAPipeline_WindowAndLoss );
+    #endif
+    #if ( otaconfigRESUME_DOWNLOAD == 1U )
+        RUN_TEST_CASE( Full_OTA_AGENT, prvCheckpoint_SaveAndResume );
+    #endif
 }
 
 TEST( Full_OTA_AGENT, OTA_SetImageState_AbortBeforeInit )
@@ -494,3 +503,255 @@ TEST( Full_OTA_AGENT, prvParseJSONbyModel_Errors )
     /* Shut down the OTA Agent. */
     ( void ) OTA_AgentShutdown( otatestSHUTDOWN_WAIT );
 }
+
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+    TEST( Full_OTA_AGENT, prvStreamVerifyBlock_ReorderWindow )
+    {
+        static uint8_t ucBlock[ OTA_FILE_BLOCK_SIZE ];
+        OTA_FileContext_t xFile;
+        uint32_t ulBlockIndex = 0;
+
+        memset( &xFile, 0, sizeof( xFile ) );
+        memset( ucBlock, 0xA5, sizeof( ucBlock ) );
+        xFile.ulFileSize = ( ( otaconfigSTREAMING_REORDER_BLOCKS + 4U ) * OTA_FILE_BLOCK_SIZE ) + 10U;
+        xFile.ulSignedSize = xFile.ulFileSize;
+
+        TEST_OTA_prvStreamVerifyStart( &xFile );
+
+        if( TEST_PROTECT() )
+        {
+            TEST_ASSERT_NOT_NULL( xFile.pvSigVerifyContext );
+            TEST_ASSERT_NOT_NULL( xFile.pucReorderBlocks );
+
+            /* Blocks ahead of the next one to hash are held back. */
+            for( ulBlockIndex = 1; ulBlockIndex <= otaconfigSTREAMING_REORDER_BLOCKS; ulBlockIndex++ )
+            {
+                TEST_OTA_prvStreamVerifyBlock( &xFile, ulBlockIndex, ucBlock, OTA_FILE_BLOCK_SIZE );
+            }
+
+            TEST_ASSERT_EQUAL( 0, xFile.ulHashedBlocks );
+            TEST_ASSERT_NOT_EQUAL( 0, xFile.ulReorderMask );
+
+            /* The missing block releases all the blocks waiting for it. */
+            TEST_OTA_prvStreamVerifyBlock( &xFile, 0, ucBlock, OTA_FILE_BLOCK_SIZE );
+            TEST_ASSERT_EQUAL( otaconfigSTREAMING_REORDER_BLOCKS + 1U, xFile.ulHashedBlocks );
+            TEST_ASSERT_EQUAL( 0, xFile.ulReorderMask );
+            TEST_ASSERT_NOT_NULL( xFile.pvSigVerifyContext );
+
+            /* A block beyond the reorder window abandons streaming verification. */
+            ulBlockIndex = xFile.ulHashedBlocks + otaconfigSTREAMING_REORDER_BLOCKS + 1U;
+            TEST_OTA_prvStreamVerifyBlock( &xFile, ulBlockIndex, ucBlock, OTA_FILE_BLOCK_SIZE );
+            TEST_ASSERT_NULL( xFile.pvSigVerifyContext );
+            TEST_ASSERT_NULL( xFile.pucReorderBlocks );
+        }
+
+        TEST_OTA_prvStreamVerifyStop( &xFile );
+    }
+#endif /* if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U ) */
+
+#if ( otaconfigMAX_REQUESTS_IN_FLIGHT >= 2U )
+
+/**
+ * @brief Mark a block as received in the file bitmap and the request window, as the agent does
+ * when it ingests the block.
+ */
+    static void prvPipelineReceive( OTA_AgentContext_t * pxAgentCtx,
+                                    uint32_t ulBlockIndex )
+    {
+        pxAgentCtx->pxOTA_Files[ 0 ].pucRxBlockBitmap[ ulBlockIndex / 8U ] &= ~( 1U << ( ulBlockIndex % 8U ) );
+        pxAgentCtx->pxOTA_Files[ 0 ].ulBlocksRemaining--;
+        TEST_OTA_prvPipelineBlockReceived( pxAgentCtx, ulBlockIndex );
+    }
+
+    TEST( Full_OTA_AGENT, prvOTAPipeline_WindowAndLoss )
+    {
+        static OTA_AgentContext_t xAgent;
+        uint8_t ucBitmap[ 2 ];
+        uint32_t ulFirstBlock = 0;
+        uint32_t ulEndBlock = 0;
+        uint32_t ulBlockIndex = 0;
+
+        /* A file of 16 blocks, none of them received. */
+        memset( &xAgent, 0, sizeof( xAgent ) );
+        memset( ucBitmap, OTA_ERASED_BLOCKS_VAL, sizeof( ucBitmap ) );
+        xAgent.pxOTA_Files[ 0 ].ulFileSize = 16U * OTA_FILE_BLOCK_SIZE;
+        xAgent.pxOTA_Files[ 0 ].ulBlocksRemaining = 16U;
+        xAgent.pxOTA_Files[ 0 ].pucRxBlockBitmap = ucBitmap;
+
+        /* The window starts at a single request of 4 blocks. */
+        prvOTAPipelineReset( &xAgent, 2U, 4U );
+        TEST_ASSERT_EQUAL_UINT32( 4, prvOTAPipelineReserve( &xAgent, false, &ulFirstBlock, &ulEndBlock ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 4, ulEndBlock );
+        TEST_ASSERT_EQUAL_UINT32( 0, prvOTAPipelineReserve( &xAgent, false, &ulFirstBlock, &ulEndBlock ) );
+
+        /* Completing the request without loss grows the window by half of it. */
+        for( ulBlockIndex = 0; ulBlockIndex < 4U; ulBlockIndex++ )
+        {
+            prvPipelineReceive( &xAgent, ulBlockIndex );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( 0, xAgent.xPipeline.ulInFlight );
+        TEST_ASSERT_EQUAL_UINT32( 6, xAgent.xPipeline.ulWindow );
+
+        /* Two requests are now kept in flight, the second one with the rest of the window. */
+        TEST_ASSERT_EQUAL_UINT32( 4, prvOTAPipelineReserve( &xAgent, false, &ulFirstBlock, &ulEndBlock ) );
+        TEST_ASSERT_EQUAL_UINT32( 4, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 2, prvOTAPipelineReserve( &xAgent, false, &ulFirstBlock, &ulEndBlock ) );
+        TEST_ASSERT_EQUAL_UINT32( 8, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 10, ulEndBlock );
+
+        /* A block of the second request means the first one lost its blocks. They are released and
+         * the window is halved. */
+        prvPipelineReceive( &xAgent, 8U );
+        TEST_ASSERT_EQUAL_UINT32( 1, xAgent.xPipeline.ulInFlight );
+        TEST_ASSERT_EQUAL_UINT32( 3, xAgent.xPipeline.ulWindow );
+
+        /* The lost blocks are requested again, skipping the one still in flight. */
+        TEST_ASSERT_EQUAL_UINT32( 2, prvOTAPipelineReserve( &xAgent, false, &ulFirstBlock, &ulEndBlock ) );
+        TEST_ASSERT_EQUAL_UINT32( 4, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 6, ulEndBlock );
+
+        /* A request that could not be sent is given back without shrinking the window. */
+        prvOTAPipelineCancel( &xAgent, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 1, xAgent.xPipeline.ulInFlight );
+        TEST_ASSERT_EQUAL_UINT32( 3, xAgent.xPipeline.ulWindow );
+
+        /* Contiguous spans stop at the first block already received. */
+        prvPipelineReceive( &xAgent, 5U );
+        TEST_ASSERT_EQUAL_UINT32( 1, prvOTAPipelineReserve( &xAgent, true, &ulFirstBlock, &ulEndBlock ) );
+        TEST_ASSERT_EQUAL_UINT32( 4, ulFirstBlock );
+        TEST_ASSERT_EQUAL_UINT32( 5, ulEndBlock );
+
+        /* A timeout drops every request in flight and halves the window once. */
+        TEST_OTA_prvPipelineTimeout( &xAgent );
+        TEST_ASSERT_EQUAL_UINT32( 0, xAgent.xPipeline.ulInFlight );
+        TEST_ASSERT_EQUAL_UINT32( 1, xAgent.xPipeline.ulWindow );
+    }
+#endif /* if ( otaconfigMAX_REQUESTS_IN_FLIGHT >= 2U ) */
+
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+
+/**
+ * @brief Checkpoint storage of the PAL callbacks below.
+ */
+    static uint8_t ucCheckpoint[ 512 ];
+    static uint32_t ulCheckpointSize = 0;
+    static uint32_t ulResumeCount = 0;
+
+    static OTA_Err_t prvTestSaveCheckpoint( OTA_FileContext_t * const C,
+                                            const uint8_t * pucData,
+                                            uint32_t ulSize )
+    {
+        OTA_Err_t xErr = kOTA_Err_None;
+
+        ( void ) C;
+
+        if( ulSize > sizeof( ucCheckpoint ) )
+        {
+            xErr = kOTA_Err_CheckpointFailed;
+        }
+        else
+        {
+            if( pucData != NULL )
+            {
+                memcpy( ucCheckpoint, pucData, ulSize );
+            }
+
+            ulCheckpointSize = ulSize;
+        }
+
+        return xErr;
+    }
+
+    static OTA_Err_t prvTestLoadCheckpoint( OTA_FileContext_t * const C,
+                                            uint8_t * const pucData,
+                                            uint32_t ulSize )
+    {
+        OTA_Err_t xErr = kOTA_Err_CheckpointFailed;
+
+        ( void ) C;
+
+        if( ulCheckpointSize > 0U )
+        {
+            memcpy( pucData, ucCheckpoint, ( ulSize < ulCheckpointSize ) ? ulSize : ulCheckpointSize );
+            xErr = kOTA_Err_None;
+        }
+
+        return xErr;
+    }
+
+    static OTA_Err_t prvTestResumeFileForRx( OTA_FileContext_t * const C )
+    {
+        ( void ) C;
+        ulResumeCount++;
+
+        return kOTA_Err_None;
+    }
+
+    TEST( Full_OTA_AGENT, prvCheckpoint_SaveAndResume )
+    {
+        static const OTA_PAL_Callbacks_t xDefaultCallbacks = { 0 };
+        OTA_PAL_Callbacks_t xCallbacks = { 0 };
+        OTA_FileContext_t xFile;
+        /* A file of 20 blocks: every block is missing, the bits past the end of the file are clear. */
+        const uint8_t ucAllMissing[ 3 ] = { 0xff, 0xff, 0x0f };
+        /* Blocks 0 to 4 and 9 received. */
+        const uint8_t ucReceived[ 3 ] = { 0xe0, 0xfd, 0x0f };
+        uint8_t ucBitmap[ 3 ];
+
+        xCallbacks.xSaveCheckpoint = prvTestSaveCheckpoint;
+        xCallbacks.xLoadCheckpoint = prvTestLoadCheckpoint;
+        xCallbacks.xResumeFileForRx = prvTestResumeFileForRx;
+        TEST_OTA_prvSetPALCallbacks( &xCallbacks );
+
+        ulCheckpointSize = 0;
+        ulResumeCount = 0;
+        memset( &xFile, 0, sizeof( xFile ) );
+        xFile.pucJobName = ( uint8_t * ) "checkpoint-job";
+        xFile.pucStreamName = ( uint8_t * ) otatestSTREAM_NAME;
+        xFile.ulFileSize = ( 19U * OTA_FILE_BLOCK_SIZE ) + 1U;
+        xFile.pucRxBlockBitmap = ucBitmap;
+
+        if( TEST_PROTECT() )
+        {
+            /* Save the download after 6 blocks, through the registered callback. */
+            memcpy( ucBitmap, ucReceived, sizeof( ucBitmap ) );
+            xFile.ulBlocksRemaining = 14U;
+            TEST_OTA_prvCheckpointSave( &xFile );
+            TEST_ASSERT_NOT_EQUAL( 0, ulCheckpointSize );
+
+            /* After a reset, the same file resumes with the blocks that were missing. */
+            memcpy( ucBitmap, ucAllMissing, sizeof( ucBitmap ) );
+            xFile.ulBlocksRemaining = 20U;
+            TEST_ASSERT_TRUE( TEST_OTA_prvCheckpointRestore( &xFile, sizeof( ucBitmap ) ) );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulResumeCount );
+            TEST_ASSERT_EQUAL_UINT32( 14, xFile.ulBlocksRemaining );
+            TEST_ASSERT_EQUAL_MEMORY( ucReceived, ucBitmap, sizeof( ucBitmap ) );
+
+            /* A damaged checkpoint is erased and the file is received from the start. */
+            ucCheckpoint[ ulCheckpointSize - 1U ] ^= 0x01U;
+            memcpy( ucBitmap, ucAllMissing, sizeof( ucBitmap ) );
+            xFile.ulBlocksRemaining = 20U;
+            TEST_ASSERT_FALSE( TEST_OTA_prvCheckpointRestore( &xFile, sizeof( ucBitmap ) ) );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulResumeCount );
+            TEST_ASSERT_EQUAL_UINT32( 20, xFile.ulBlocksRemaining );
+            TEST_ASSERT_EQUAL_MEMORY( ucAllMissing, ucBitmap, sizeof( ucBitmap ) );
+            TEST_ASSERT_EQUAL_UINT32( 0, ulCheckpointSize );
+
+            /* The checkpoint of another job is not used. */
+            memcpy( ucBitmap, ucReceived, sizeof( ucBitmap ) );
+            xFile.ulBlocksRemaining = 14U;
+            TEST_OTA_prvCheckpointSave( &xFile );
+            xFile.pucJobName = ( uint8_t * ) "another-job";
+            memcpy( ucBitmap, ucAllMissing, sizeof( ucBitmap ) );
+            xFile.ulBlocksRemaining = 20U;
+            TEST_ASSERT_FALSE( TEST_OTA_prvCheckpointRestore( &xFile, sizeof( ucBitmap ) ) );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulResumeCount );
+            TEST_ASSERT_EQUAL_UINT32( 20, xFile.ulBlocksRemaining );
+        }
+
+        /* Go back to the callbacks of the platform. */
+        TEST_OTA_prvSetPALCallbacks( &xDefaultCallbacks );
+    }
+#endif /* if ( otaconfigRESUME_DOWNLOAD == 1U ) */
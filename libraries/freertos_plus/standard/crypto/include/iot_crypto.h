@@ -81,6 +81,44 @@ void CRYPTO_SignatureVerificationUpdate( void * pvContext,
                                          const uint8_t * pucData,
                                          size_t xDataLength );
 
+/**
+ * @brief Returns the size of the state saved by CRYPTO_SignatureVerificationSave().
+ *
+ * @return Size in bytes of the saved state of a signature verification context.
+ */
+size_t CRYPTO_SignatureVerificationStateSize( void );
+
+/**
+ * @brief Saves the state of an in-progress hash, so that it can be continued later,
+ * for example after a reset.
+ *
+ * The state is only meaningful to the same firmware that saved it.
+ *
+ * @param[in] pvContext Opaque context structure.
+ * @param[out] pucState Buffer receiving the state.
+ * @param[in] xStateLength Length in bytes of the buffer, at least
+ * CRYPTO_SignatureVerificationStateSize().
+ *
+ * @return pdTRUE if the state was saved, or pdFALSE otherwise.
+ */
+BaseType_t CRYPTO_SignatureVerificationSave( void * pvContext,
+                                             uint8_t * pucState,
+                                             size_t xStateLength );
+
+/**
+ * @brief Creates a signature verification context from a state saved by
+ * CRYPTO_SignatureVerificationSave().
+ *
+ * @param[out] ppvContext Opaque context structure.
+ * @param[in] pucState Saved state.
+ * @param[in] xStateLength Length in bytes of the saved state.
+ *
+ * @return pdTRUE if the context was restored, or pdFALSE otherwise.
+ */
+BaseType_t CRYPTO_SignatureVerificationRestore( void ** ppvContext,
+                                                const uint8_t * pucState,
+                                                size_t xStateLength );
+
 /**
  * @brief Verifies a digital signature computation using the public key from the
  * specified certificate.
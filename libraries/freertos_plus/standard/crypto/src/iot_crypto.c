@@ -328,6 +328,72 @@ void CRYPTO_SignatureVerificationUpdate( void * pvContext,
     }
 }
 
+/**
+ * @brief Returns the size of a saved signature verification state.
+ */
+size_t CRYPTO_SignatureVerificationStateSize( void )
+{
+    return sizeof( SignatureVerificationState_t );
+}
+
+/**
+ * @brief Saves an in-progress hash. The hash contexts hold no pointers, so the
+ * context structure is saved as is.
+ */
+BaseType_t CRYPTO_SignatureVerificationSave( void * pvContext,
+                                             uint8_t * pucState,
+                                             size_t xStateLength )
+{
+    BaseType_t xResult = pdFALSE;
+
+    if( ( pvContext != NULL ) &&
+        ( pucState != NULL ) &&
+        ( xStateLength >= sizeof( SignatureVerificationState_t ) ) )
+    {
+        ( void ) memcpy( pucState, pvContext, sizeof( SignatureVerificationState_t ) );
+        xResult = pdTRUE;
+    }
+
+    return xResult;
+}
+
+/**
+ * @brief Creates a signature verification context from a saved hash.
+ */
+BaseType_t CRYPTO_SignatureVerificationRestore( void ** ppvContext,
+                                                const uint8_t * pucState,
+                                                size_t xStateLength )
+{
+    BaseType_t xResult = pdFALSE;
+    SignatureVerificationState_t * pxCtx = NULL;
+
+    if( ( pucState != NULL ) &&
+        ( xStateLength == sizeof( SignatureVerificationState_t ) ) )
+    {
+        pxCtx = ( SignatureVerificationStatePtr_t ) pvPortMalloc( sizeof( *pxCtx ) ); /*lint !e9087 Allow casting void* to other types. */
+    }
+
+    if( pxCtx != NULL )
+    {
+        ( void ) memcpy( pxCtx, pucState, sizeof( SignatureVerificationState_t ) );
+
+        if( ( ( pxCtx->xHashAlgorithm == cryptoHASH_ALGORITHM_SHA1 ) ||
+              ( pxCtx->xHashAlgorithm == cryptoHASH_ALGORITHM_SHA256 ) ) &&
+            ( ( pxCtx->xAsymmetricAlgorithm == cryptoASYMMETRIC_ALGORITHM_RSA ) ||
+              ( pxCtx->xAsymmetricAlgorithm == cryptoASYMMETRIC_ALGORITHM_ECDSA ) ) )
+        {
+            *ppvContext = pxCtx;
+            xResult = pdTRUE;
+        }
+        else
+        {
+            vPortFree( pxCtx );
+        }
+    }
+
+    return xResult;
+}
+
 /**
  * @brief Performs signature verification on a cryptographic hash.
  */
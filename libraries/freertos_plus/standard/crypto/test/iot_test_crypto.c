@@ -25,6 +25,7 @@
 
 /* Standard includes. */
 #include <stdint.h>
+#include <string.h>
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
@@ -49,6 +50,7 @@ TEST_TEAR_DOWN( Full_CRYPTO )
 TEST_GROUP_RUNNER( Full_CRYPTO )
 {
     RUN_TEST_CASE( Full_CRYPTO, VerifySignatureTestVectors );
+    RUN_TEST_CASE( Full_CRYPTO, SaveAndRestoreVerificationState );
 }
 
 TEST( Full_CRYPTO, VerifySignatureTestVectors )
@@ -281,3 +283,65 @@ TEST( Full_CRYPTO, VerifySignatureTestVectors )
     TEST_ASSERT_FALSE( xResult );
     /** @}*/
 }
+
+TEST( Full_CRYPTO, SaveAndRestoreVerificationState )
+{
+    BaseType_t xResult = pdFALSE;
+    void * pvContext = NULL;
+    void * pvRestoredContext = NULL;
+    uint8_t * pucState = NULL;
+    uint8_t * pucRestoredState = NULL;
+    size_t xStateSize = CRYPTO_SignatureVerificationStateSize();
+    uint8_t ucData[ 300 ] = { 0 };
+    size_t i = 0;
+
+    for( i = 0; i < sizeof( ucData ); i++ )
+    {
+        ucData[ i ] = ( uint8_t ) i;
+    }
+
+    pucState = pvPortMalloc( xStateSize );
+    pucRestoredState = pvPortMalloc( xStateSize );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_NOT_NULL( pucState );
+        TEST_ASSERT_NOT_NULL( pucRestoredState );
+
+        xResult = CRYPTO_SignatureVerificationStart( &pvContext,
+                                                     cryptoASYMMETRIC_ALGORITHM_ECDSA,
+                                                     cryptoHASH_ALGORITHM_SHA256 );
+        TEST_ASSERT_TRUE( xResult );
+
+        /* Save the state part way through a block and reject buffers that are too small. */
+        CRYPTO_SignatureVerificationUpdate( pvContext, ucData, 100 );
+        TEST_ASSERT_FALSE( CRYPTO_SignatureVerificationSave( pvContext, pucState, xStateSize - 1 ) );
+        TEST_ASSERT_TRUE( CRYPTO_SignatureVerificationSave( pvContext, pucState, xStateSize ) );
+
+        /* The saved state must have the exact size. */
+        TEST_ASSERT_FALSE( CRYPTO_SignatureVerificationRestore( &pvRestoredContext, pucState, xStateSize - 1 ) );
+        TEST_ASSERT_NULL( pvRestoredContext );
+        TEST_ASSERT_TRUE( CRYPTO_SignatureVerificationRestore( &pvRestoredContext, pucState, xStateSize ) );
+        TEST_ASSERT_NOT_NULL( pvRestoredContext );
+
+        /* Continuing both contexts with the same data must leave them in the same state. */
+        CRYPTO_SignatureVerificationUpdate( pvContext, &ucData[ 100 ], sizeof( ucData ) - 100 );
+        CRYPTO_SignatureVerificationUpdate( pvRestoredContext, &ucData[ 100 ], sizeof( ucData ) - 100 );
+        TEST_ASSERT_TRUE( CRYPTO_SignatureVerificationSave( pvContext, pucState, xStateSize ) );
+        TEST_ASSERT_TRUE( CRYPTO_SignatureVerificationSave( pvRestoredContext, pucRestoredState, xStateSize ) );
+        TEST_ASSERT_EQUAL_MEMORY( pucState, pucRestoredState, xStateSize );
+
+        /* A state that does not name a known algorithm is rejected. */
+        ( void ) memset( pucRestoredState, 0xff, xStateSize );
+        ( void ) CRYPTO_SignatureVerificationFinal( pvRestoredContext, NULL, 0, NULL, 0 );
+        pvRestoredContext = NULL;
+        TEST_ASSERT_FALSE( CRYPTO_SignatureVerificationRestore( &pvRestoredContext, pucRestoredState, xStateSize ) );
+        TEST_ASSERT_NULL( pvRestoredContext );
+    }
+
+    /* Final frees the contexts. */
+    ( void ) CRYPTO_SignatureVerificationFinal( pvContext, NULL, 0, NULL, 0 );
+    ( void ) CRYPTO_SignatureVerificationFinal( pvRestoredContext, NULL, 0, NULL, 0 );
+    vPortFree( pucState );
+    vPortFree( pucRestoredState );
+}
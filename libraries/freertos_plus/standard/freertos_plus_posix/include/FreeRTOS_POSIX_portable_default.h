@@ -60,6 +60,10 @@
 #ifndef posixconfigMQ_MAX_SIZE
     #define posixconfigMQ_MAX_SIZE    128 /**< Maximum size (in bytes) of each message. */
 #endif
+
+#ifndef posixconfigMQ_DESCRIPTOR_CACHE_SIZE
+    #define posixconfigMQ_DESCRIPTOR_CACHE_SIZE    8 /**< Number of open mq descriptors that send and receive find without locking the mq list. 0 to disable. */
+#endif
 /**@} */
 
 /**
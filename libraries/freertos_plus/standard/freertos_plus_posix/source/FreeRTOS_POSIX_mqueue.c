@@ -29,6 +29,7 @@
  */
 
 /* C standard library includes. */
+#include <stdint.h>
 #include <string.h>
 
 /* FreeRTOS+POSIX includes. */
@@ -38,12 +39,17 @@
 #include "FreeRTOS_POSIX/mqueue.h"
 #include "FreeRTOS_POSIX/utils.h"
 
+/**
+ * @brief Round a size up to a multiple of portBYTE_ALIGNMENT.
+ */
+#define mqALIGN_SIZE( xSize )    ( ( ( size_t ) ( xSize ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
 /**
  * @brief Element of the FreeRTOS queues that store mq data.
  */
 typedef struct QueueElement
 {
-    char * pcData;    /**< Data in queue. Type char* to match msg_ptr. */
+    char * pcData;    /**< Message slot holding the data. Type char* to match msg_ptr. */
     size_t xDataSize; /**< Size of data pointed by pcData. */
 } QueueElement_t;
 
@@ -52,11 +58,20 @@ typedef struct QueueElement
  *
  * FreeRTOS isn't guaranteed to have a file-like abstraction, so message
  * queues in this implementation are stored as a linked list (in RAM).
+ *
+ * The memory for all messages of a queue is allocated with the queue: the
+ * element is followed by mq_maxmsg slots of xSlotSize bytes, then by a bitmap
+ * with one bit per slot. A slot is either in xFreeSlots, holding a message in
+ * xQueue, or loaned to the application; its bit is set only while it is loaned.
  */
 typedef struct QueueListElement
 {
     Link_t xLink;              /**< Pointer to the next element in the list. */
     QueueHandle_t xQueue;      /**< FreeRTOS queue handle. */
+    QueueHandle_t xFreeSlots;  /**< FreeRTOS queue of the message slots not in use. */
+    char * pcMessageSlab;      /**< First message slot. */
+    uint8_t * pucLoanedSlots;  /**< Bitmap of the message slots loaned to the application. */
+    size_t xSlotSize;          /**< Size of a message slot; mq_msgsize rounded up to portBYTE_ALIGNMENT. */
     size_t xOpenDescriptors;   /**< Number of threads that have opened this queue. */
     char * pcName;             /**< Null-terminated queue name. */
     struct mq_attr xAttr;      /**< Queue attibutes. */
@@ -118,6 +133,92 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
                                       const char * const pcName,
                                       mqd_t xMessageQueueDescriptor );
 
+/**
+ * @brief Get the queue of a descriptor for sending or receiving.
+ *
+ * Looks in the descriptor cache first, then in the queue list. Queues found
+ * in the list are added to the cache.
+ *
+ * @param[in] xMessageQueueDescriptor The queue descriptor.
+ *
+ * @return The queue, or NULL if the descriptor is not valid.
+ */
+static QueueListElement_t * prvLookupDescriptor( mqd_t xMessageQueueDescriptor );
+
+/**
+ * @brief Remove a queue from the descriptor cache.
+ *
+ * Must be called with xQueueListMutex held, when the queue is removed from
+ * the queue list.
+ *
+ * @param[in] pxMessageQueue The queue to remove.
+ *
+ * @return nothing
+ */
+static void prvForgetDescriptor( const QueueListElement_t * const pxMessageQueue );
+
+/**
+ * @brief Check that a pointer is the start of a message slot of a queue.
+ *
+ * @param[in] pxMessageQueue The queue.
+ * @param[in] pcSlot The pointer to check.
+ *
+ * @return pdTRUE if pcSlot is a message slot of the queue; pdFALSE otherwise.
+ */
+static BaseType_t prvIsMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                    const char * const pcSlot );
+
+/**
+ * @brief Mark a message slot as loaned to the application.
+ *
+ * @param[in] pxMessageQueue The queue.
+ * @param[in] pcSlot The message slot being loaned.
+ *
+ * @return nothing
+ */
+static void prvLoanMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                const char * const pcSlot );
+
+/**
+ * @brief Take back a message slot loaned to the application.
+ *
+ * Clears the loan, so a slot cannot be sent or returned twice.
+ *
+ * @param[in] pxMessageQueue The queue.
+ * @param[in] pcSlot The message slot to take back.
+ *
+ * @return pdTRUE if pcSlot is a message slot of the queue that is on loan;
+ * pdFALSE otherwise.
+ */
+static BaseType_t prvReclaimMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                         const char * const pcSlot );
+
+/**
+ * @brief Take a free message slot, blocking until abstime if there is none.
+ *
+ * @param[in] pxMessageQueue The queue.
+ * @param[in] pxAbsoluteTimeout The absolute timeout, or NULL to block forever.
+ * @param[out] ppcSlot The message slot taken.
+ *
+ * @return 0 if successful; otherwise, the errno value of the failure.
+ */
+static int prvTakeMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                               const struct timespec * const pxAbsoluteTimeout,
+                               char ** ppcSlot );
+
+/**
+ * @brief Receive a message, blocking until abstime if the queue is empty.
+ *
+ * @param[in] pxMessageQueue The queue.
+ * @param[in] pxAbsoluteTimeout The absolute timeout, or NULL to block forever.
+ * @param[out] pxReceiveData The message received.
+ *
+ * @return 0 if successful; otherwise, the errno value of the failure.
+ */
+static int prvReceiveMessage( const QueueListElement_t * const pxMessageQueue,
+                              const struct timespec * const pxAbsoluteTimeout,
+                              QueueElement_t * pxReceiveData );
+
 /**
  * @brief Initialize the queue list.
  *
@@ -149,6 +250,23 @@ static StaticSemaphore_t xQueueListMutex = { { 0 }, .u = { 0 } };
  */
 static Link_t xQueueListHead = { 0 };
 
+#if ( posixconfigMQ_DESCRIPTOR_CACHE_SIZE > 0 )
+
+/**
+ * @brief Queues recently used for sending or receiving.
+ *
+ * Read without xQueueListMutex; only written with xQueueListMutex held. A
+ * queue is in the cache only while it is in the queue list, so a descriptor
+ * found here is valid.
+ */
+    static QueueListElement_t * volatile pxDescriptorCache[ posixconfigMQ_DESCRIPTOR_CACHE_SIZE ] = { 0 };
+
+/**
+ * @brief Index of the next entry of pxDescriptorCache to replace.
+ */
+    static size_t xNextDescriptorCacheEntry = 0;
+#endif
+
 /*-----------------------------------------------------------*/
 
 static int prvCalculateTickTimeout( long lMessageQueueFlags,
@@ -206,63 +324,125 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
                                             size_t xNameLength )
 {
     BaseType_t xStatus = pdTRUE;
-
-    /* Allocate space for a new queue element. */
-    *ppxMessageQueue = pvPortMalloc( sizeof( QueueListElement_t ) );
-
-    /* Check that memory allocation succeeded. */
-    if( *ppxMessageQueue == NULL )
+    QueueListElement_t * pxMessageQueue = NULL;
+    size_t xHeaderSize = mqALIGN_SIZE( sizeof( QueueListElement_t ) );
+    size_t xMessageCount = ( size_t ) pxAttr->mq_maxmsg;
+    size_t xSlotSize = mqALIGN_SIZE( pxAttr->mq_msgsize );
+    size_t xBitmapSize = ( xMessageCount + 7U ) / 8U;
+    size_t xSlot = 0;
+    char * pcSlot = NULL;
+
+    /* Check that the size of the queue fits in a size_t. */
+    if( ( xSlotSize < ( size_t ) pxAttr->mq_msgsize ) ||
+        ( xSlotSize > ( ( SIZE_MAX - xHeaderSize - xBitmapSize ) / xMessageCount ) ) )
     {
         xStatus = pdFALSE;
     }
 
+    /* Allocate space for a new queue element followed by its message slots
+     * and the bitmap of loaned slots. */
+    if( xStatus == pdTRUE )
+    {
+        pxMessageQueue = pvPortMalloc( xHeaderSize + ( xMessageCount * xSlotSize ) + xBitmapSize );
+
+        /* Check that memory allocation succeeded. */
+        if( pxMessageQueue == NULL )
+        {
+            xStatus = pdFALSE;
+        }
+        else
+        {
+            pxMessageQueue->pcMessageSlab = ( char * ) pxMessageQueue + xHeaderSize;
+            pxMessageQueue->pucLoanedSlots = ( uint8_t * ) pxMessageQueue->pcMessageSlab + ( xMessageCount * xSlotSize );
+            ( void ) memset( pxMessageQueue->pucLoanedSlots, 0x00, xBitmapSize );
+            pxMessageQueue->xSlotSize = xSlotSize;
+            pxMessageQueue->xFreeSlots = NULL;
+            pxMessageQueue->pcName = NULL;
+        }
+    }
+
     /* Create the FreeRTOS queue. */
     if( xStatus == pdTRUE )
     {
-        ( *ppxMessageQueue )->xQueue =
+        pxMessageQueue->xQueue =
             xQueueCreate( pxAttr->mq_maxmsg, sizeof( QueueElement_t ) );
 
         /* Check that queue creation succeeded. */
-        if( ( *ppxMessageQueue )->xQueue == NULL )
+        if( pxMessageQueue->xQueue == NULL )
         {
-            vPortFree( *ppxMessageQueue );
             xStatus = pdFALSE;
         }
     }
 
+    /* Create the queue of free message slots, and put every slot in it. */
+    if( xStatus == pdTRUE )
+    {
+        pxMessageQueue->xFreeSlots =
+            xQueueCreate( pxAttr->mq_maxmsg, sizeof( char * ) );
+
+        /* Check that queue creation succeeded. */
+        if( pxMessageQueue->xFreeSlots == NULL )
+        {
+            xStatus = pdFALSE;
+        }
+        else
+        {
+            for( xSlot = 0; xSlot < xMessageCount; xSlot++ )
+            {
+                pcSlot = pxMessageQueue->pcMessageSlab + ( xSlot * xSlotSize );
+                ( void ) xQueueSend( pxMessageQueue->xFreeSlots, &pcSlot, 0 );
+            }
+        }
+    }
+
     if( xStatus == pdTRUE )
     {
         /* Allocate space for the queue name plus null-terminator. */
-        ( *ppxMessageQueue )->pcName = pvPortMalloc( xNameLength + 1 );
+        pxMessageQueue->pcName = pvPortMalloc( xNameLength + 1 );
 
         /* Check that memory was successfully allocated for queue name. */
-        if( ( *ppxMessageQueue )->pcName == NULL )
+        if( pxMessageQueue->pcName == NULL )
         {
-            vQueueDelete( ( *ppxMessageQueue )->xQueue );
-            vPortFree( *ppxMessageQueue );
             xStatus = pdFALSE;
         }
         else
         {
             /* Copy queue name. Copying xNameLength+1 will cause strncpy to add
              * the null-terminator. */
-            ( void ) strncpy( ( *ppxMessageQueue )->pcName, pcName, xNameLength + 1 );
+            ( void ) strncpy( pxMessageQueue->pcName, pcName, xNameLength + 1 );
         }
     }
 
     if( xStatus == pdTRUE )
     {
         /* Copy attributes. */
-        ( *ppxMessageQueue )->xAttr = *pxAttr;
+        pxMessageQueue->xAttr = *pxAttr;
 
         /* A newly-created queue will have 1 open descriptor for it. */
-        ( *ppxMessageQueue )->xOpenDescriptors = 1;
+        pxMessageQueue->xOpenDescriptors = 1;
 
         /* A newly-created queue will not be pending unlink. */
-        ( *ppxMessageQueue )->xPendingUnlink = pdFALSE;
+        pxMessageQueue->xPendingUnlink = pdFALSE;
 
         /* Add the new queue to the list. */
-        listADD( &xQueueListHead, &( *ppxMessageQueue )->xLink );
+        listADD( &xQueueListHead, &pxMessageQueue->xLink );
+
+        *ppxMessageQueue = pxMessageQueue;
+    }
+    else if( pxMessageQueue != NULL )
+    {
+        /* Free whatever was created before the failure. */
+        if( pxMessageQueue->xFreeSlots != NULL )
+        {
+            vQueueDelete( pxMessageQueue->xFreeSlots );
+        }
+
+        if( pxMessageQueue->xQueue != NULL )
+        {
+            vQueueDelete( pxMessageQueue->xQueue );
+        }
+
+        vPortFree( pxMessageQueue );
     }
 
     return xStatus;
@@ -272,19 +452,10 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
 
 static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQueue )
 {
-    QueueElement_t xQueueElement = { 0 };
-
-    /* Free all data in the queue. It's assumed that no more data will be added
-     * to the queue, so xQueueReceive does not block. */
-    while( xQueueReceive( pxMessageQueue->xQueue,
-                          ( void * ) &xQueueElement,
-                          0 ) == pdTRUE )
-    {
-        vPortFree( xQueueElement.pcData );
-    }
-
-    /* Free memory used by this message queue. */
+    /* Messages are stored in the message slots, which are freed with the
+     * queue element. */
     vQueueDelete( pxMessageQueue->xQueue );
+    vQueueDelete( pxMessageQueue->xFreeSlots );
     vPortFree( ( void * ) pxMessageQueue->pcName );
     vPortFree( ( void * ) pxMessageQueue );
 }
@@ -332,6 +503,217 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
 
 /*-----------------------------------------------------------*/
 
+static QueueListElement_t * prvLookupDescriptor( mqd_t xMessageQueueDescriptor )
+{
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    #if ( posixconfigMQ_DESCRIPTOR_CACHE_SIZE > 0 )
+        size_t xEntry = 0;
+
+        /* Descriptors are compared with the cached pointers without being
+         * dereferenced, so a bad descriptor is never accessed. */
+        if( xMessageQueueDescriptor != NULL )
+        {
+            for( xEntry = 0; xEntry < posixconfigMQ_DESCRIPTOR_CACHE_SIZE; xEntry++ )
+            {
+                if( ( mqd_t ) pxDescriptorCache[ xEntry ] == xMessageQueueDescriptor )
+                {
+                    pxMessageQueue = ( QueueListElement_t * ) xMessageQueueDescriptor;
+                    break;
+                }
+            }
+        }
+    #endif /* if ( posixconfigMQ_DESCRIPTOR_CACHE_SIZE > 0 ) */
+
+    if( pxMessageQueue == NULL )
+    {
+        /* Lock the mutex that guards access to the queue list. This call will
+         * never fail because it blocks forever. */
+        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
+
+        if( prvFindQueueInList( &pxMessageQueue, NULL, xMessageQueueDescriptor ) == pdTRUE )
+        {
+            #if ( posixconfigMQ_DESCRIPTOR_CACHE_SIZE > 0 )
+                /* Replace the oldest cache entry. */
+                pxDescriptorCache[ xNextDescriptorCacheEntry ] = pxMessageQueue;
+                xNextDescriptorCacheEntry = ( xNextDescriptorCacheEntry + 1 ) % posixconfigMQ_DESCRIPTOR_CACHE_SIZE;
+            #endif
+        }
+        else
+        {
+            pxMessageQueue = NULL;
+        }
+
+        /* Release the mutex protecting the queue list. */
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
+    }
+
+    return pxMessageQueue;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvForgetDescriptor( const QueueListElement_t * const pxMessageQueue )
+{
+    #if ( posixconfigMQ_DESCRIPTOR_CACHE_SIZE > 0 )
+        size_t xEntry = 0;
+
+        for( xEntry = 0; xEntry < posixconfigMQ_DESCRIPTOR_CACHE_SIZE; xEntry++ )
+        {
+            if( pxDescriptorCache[ xEntry ] == pxMessageQueue )
+            {
+                pxDescriptorCache[ xEntry ] = NULL;
+            }
+        }
+    #else
+        ( void ) pxMessageQueue;
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                    const char * const pcSlot )
+{
+    BaseType_t xStatus = pdFALSE;
+    uintptr_t xSlab = ( uintptr_t ) pxMessageQueue->pcMessageSlab;
+    uintptr_t xSlot = ( uintptr_t ) pcSlot;
+    size_t xSlabSize = ( size_t ) pxMessageQueue->xAttr.mq_maxmsg * pxMessageQueue->xSlotSize;
+
+    if( ( xSlot >= xSlab ) &&
+        ( ( xSlot - xSlab ) < xSlabSize ) &&
+        ( ( ( xSlot - xSlab ) % pxMessageQueue->xSlotSize ) == 0U ) )
+    {
+        xStatus = pdTRUE;
+    }
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvLoanMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                const char * const pcSlot )
+{
+    size_t xSlot = ( size_t ) ( pcSlot - pxMessageQueue->pcMessageSlab ) / pxMessageQueue->xSlotSize;
+
+    /* Other slots in the same byte may be loaned or reclaimed concurrently. */
+    taskENTER_CRITICAL();
+    {
+        pxMessageQueue->pucLoanedSlots[ xSlot / 8U ] |= ( uint8_t ) ( 1U << ( xSlot % 8U ) );
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReclaimMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                                         const char * const pcSlot )
+{
+    BaseType_t xStatus = pdFALSE;
+    size_t xSlot = 0;
+    uint8_t ucMask = 0;
+
+    if( prvIsMessageSlot( pxMessageQueue, pcSlot ) == pdTRUE )
+    {
+        xSlot = ( size_t ) ( pcSlot - pxMessageQueue->pcMessageSlab ) / pxMessageQueue->xSlotSize;
+        ucMask = ( uint8_t ) ( 1U << ( xSlot % 8U ) );
+
+        /* Test and clear the loan together, so that only one of two racing
+         * callers gets the slot back. */
+        taskENTER_CRITICAL();
+        {
+            if( ( pxMessageQueue->pucLoanedSlots[ xSlot / 8U ] & ucMask ) != 0U )
+            {
+                pxMessageQueue->pucLoanedSlots[ xSlot / 8U ] &= ( uint8_t ) ~ucMask;
+                xStatus = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvTakeMessageSlot( const QueueListElement_t * const pxMessageQueue,
+                               const struct timespec * const pxAbsoluteTimeout,
+                               char ** ppcSlot )
+{
+    int iStatus = 0;
+    TickType_t xTimeoutTicks = 0;
+
+    /* Convert abstime to a tick timeout. */
+    iStatus = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
+                                       pxAbsoluteTimeout,
+                                       &xTimeoutTicks );
+
+    if( iStatus == 0 )
+    {
+        /* A free slot means there is room for the message in the FreeRTOS
+         * queue, so only this call blocks on a full mq. */
+        if( xQueueReceive( pxMessageQueue->xFreeSlots,
+                           ppcSlot,
+                           xTimeoutTicks ) == pdFALSE )
+        {
+            /* If no slot is free, set the appropriate errno. */
+            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
+            {
+                /* Set errno to EAGAIN for nonblocking mq. */
+                iStatus = EAGAIN;
+            }
+            else
+            {
+                /* Otherwise, set errno to ETIMEDOUT. */
+                iStatus = ETIMEDOUT;
+            }
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvReceiveMessage( const QueueListElement_t * const pxMessageQueue,
+                              const struct timespec * const pxAbsoluteTimeout,
+                              QueueElement_t * pxReceiveData )
+{
+    int iStatus = 0;
+    TickType_t xTimeoutTicks = 0;
+
+    /* Convert abstime to a tick timeout. */
+    iStatus = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
+                                       pxAbsoluteTimeout,
+                                       &xTimeoutTicks );
+
+    if( iStatus == 0 )
+    {
+        /* Receive data from the FreeRTOS queue. */
+        if( xQueueReceive( pxMessageQueue->xQueue,
+                           pxReceiveData,
+                           xTimeoutTicks ) == pdFALSE )
+        {
+            /* If queue receive fails, set the appropriate errno. */
+            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
+            {
+                /* Set errno to EAGAIN for nonblocking mq. */
+                iStatus = EAGAIN;
+            }
+            else
+            {
+                /* Otherwise, set errno to ETIMEDOUT. */
+                iStatus = ETIMEDOUT;
+            }
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 static void prvInitializeQueueList( void )
 {
     /* Keep track of whether the queue list has been initialized. */
@@ -425,6 +807,7 @@ int mq_close( mqd_t mqdes )
             if( pxMessageQueue->xPendingUnlink == pdTRUE )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                prvForgetDescriptor( pxMessageQueue );
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
@@ -635,20 +1018,17 @@ ssize_t mq_timedreceive( mqd_t mqdes,
                          const struct timespec * abstime )
 {
     ssize_t xStatus = 0;
-    int iCalculateTimeoutReturn = 0;
-    TickType_t xTimeoutTicks = 0;
-    QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
+    int iReceiveReturn = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
     QueueElement_t xReceiveData = { 0 };
 
     /* Silence warnings about unused parameters. */
     ( void ) msg_prio;
 
-    /* Lock the mutex that guards access to the queue list. This call will
-     * never fail because it blocks forever. */
-    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
-
     /* Find the mq referenced by mqdes. */
-    if( prvFindQueueInList( NULL, NULL, mqdes ) == pdFALSE )
+    pxMessageQueue = prvLookupDescriptor( mqdes );
+
+    if( pxMessageQueue == NULL )
     {
         /* Queue not found; bad descriptor. */
         errno = EBADF;
@@ -668,40 +1048,11 @@ ssize_t mq_timedreceive( mqd_t mqdes,
 
     if( xStatus == 0 )
     {
-        /* Convert abstime to a tick timeout. */
-        iCalculateTimeoutReturn = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
-                                                           abstime,
-                                                           &xTimeoutTicks );
-
-        if( iCalculateTimeoutReturn != 0 )
-        {
-            errno = iCalculateTimeoutReturn;
-            xStatus = -1;
-        }
-    }
-
-    /* Release the mutex protecting the queue list. */
-    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
+        iReceiveReturn = prvReceiveMessage( pxMessageQueue, abstime, &xReceiveData );
 
-    if( xStatus == 0 )
-    {
-        /* Receive data from the FreeRTOS queue. */
-        if( xQueueReceive( pxMessageQueue->xQueue,
-                           &xReceiveData,
-                           xTimeoutTicks ) == pdFALSE )
+        if( iReceiveReturn != 0 )
         {
-            /* If queue receive fails, set the appropriate errno. */
-            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
-            {
-                /* Set errno to EAGAIN for nonblocking mq. */
-                errno = EAGAIN;
-            }
-            else
-            {
-                /* Otherwise, set errno to ETIMEDOUT. */
-                errno = ETIMEDOUT;
-            }
-
+            errno = iReceiveReturn;
             xStatus = -1;
         }
     }
@@ -711,9 +1062,10 @@ ssize_t mq_timedreceive( mqd_t mqdes,
         /* Get the length of data for return value. */
         xStatus = ( ssize_t ) xReceiveData.xDataSize;
 
-        /* Copy received data into given buffer, then free it. */
+        /* Copy received data into given buffer, then free its message slot.
+         * There is room for the slot because it was taken from xFreeSlots. */
         ( void ) memcpy( msg_ptr, xReceiveData.pcData, xReceiveData.xDataSize );
-        vPortFree( xReceiveData.pcData );
+        ( void ) xQueueSend( pxMessageQueue->xFreeSlots, &xReceiveData.pcData, 0 );
     }
 
     return xStatus;
@@ -727,20 +1079,17 @@ int mq_timedsend( mqd_t mqdes,
                   unsigned int msg_prio,
                   const struct timespec * abstime )
 {
-    int iStatus = 0, iCalculateTimeoutReturn = 0;
-    TickType_t xTimeoutTicks = 0;
-    QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
+    int iStatus = 0, iTakeSlotReturn = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
     QueueElement_t xSendData = { 0 };
 
     /* Silence warnings about unused parameters. */
     ( void ) msg_prio;
 
-    /* Lock the mutex that guards access to the queue list. This call will
-     * never fail because it blocks forever. */
-    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &xQueueListMutex, portMAX_DELAY );
-
     /* Find the mq referenced by mqdes. */
-    if( prvFindQueueInList( NULL, NULL, mqdes ) == pdFALSE )
+    pxMessageQueue = prvLookupDescriptor( mqdes );
+
+    if( pxMessageQueue == NULL )
     {
         /* Queue not found; bad descriptor. */
         errno = EBADF;
@@ -758,67 +1107,205 @@ int mq_timedsend( mqd_t mqdes,
         }
     }
 
+    /* Take a message slot, waiting for one if the mq is full. */
     if( iStatus == 0 )
     {
-        /* Convert abstime to a tick timeout. */
-        iCalculateTimeoutReturn = prvCalculateTickTimeout( pxMessageQueue->xAttr.mq_flags,
-                                                           abstime,
-                                                           &xTimeoutTicks );
+        iTakeSlotReturn = prvTakeMessageSlot( pxMessageQueue, abstime, &xSendData.pcData );
 
-        if( iCalculateTimeoutReturn != 0 )
+        if( iTakeSlotReturn != 0 )
         {
-            errno = iCalculateTimeoutReturn;
+            errno = iTakeSlotReturn;
             iStatus = -1;
         }
     }
 
-    /* Release the mutex protecting the queue list. */
-    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
-
-    /* Allocate memory for the message. */
     if( iStatus == 0 )
     {
+        /* Copy the data to send. */
         xSendData.xDataSize = msg_len;
-        xSendData.pcData = pvPortMalloc( msg_len );
+        ( void ) memcpy( xSendData.pcData, msg_ptr, msg_len );
 
-        /* Check that memory allocation succeeded. */
-        if( xSendData.pcData == NULL )
+        /* Send data to the FreeRTOS queue. This does not block, because the
+         * queue has room for every message slot. */
+        ( void ) xQueueSend( pxMessageQueue->xQueue, &xSendData, 0 );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+char * mq_loan( mqd_t mqdes,
+                const struct timespec * abstime )
+{
+    char * pcSlot = NULL;
+    int iTakeSlotReturn = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    /* Find the mq referenced by mqdes. */
+    pxMessageQueue = prvLookupDescriptor( mqdes );
+
+    if( pxMessageQueue == NULL )
+    {
+        /* Queue not found; bad descriptor. */
+        errno = EBADF;
+    }
+    else
+    {
+        iTakeSlotReturn = prvTakeMessageSlot( pxMessageQueue, abstime, &pcSlot );
+
+        if( iTakeSlotReturn != 0 )
+        {
+            errno = iTakeSlotReturn;
+            pcSlot = NULL;
+        }
+        else
+        {
+            prvLoanMessageSlot( pxMessageQueue, pcSlot );
+        }
+    }
+
+    return pcSlot;
+}
+
+/*-----------------------------------------------------------*/
+
+int mq_send_loan( mqd_t mqdes,
+                  char * msg_ptr,
+                  size_t msg_len,
+                  unsigned msg_prio )
+{
+    int iStatus = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
+    QueueElement_t xSendData = { 0 };
+
+    /* Silence warnings about unused parameters. */
+    ( void ) msg_prio;
+
+    /* Find the mq referenced by mqdes. */
+    pxMessageQueue = prvLookupDescriptor( mqdes );
+
+    if( pxMessageQueue == NULL )
+    {
+        /* Queue not found; bad descriptor. */
+        errno = EBADF;
+        iStatus = -1;
+    }
+
+    /* Verify that mq_msgsize is large enough. This is checked first so that
+     * the slot stays on loan if the send fails. */
+    if( iStatus == 0 )
+    {
+        if( msg_len > ( size_t ) pxMessageQueue->xAttr.mq_msgsize )
         {
             /* msg_len too large. */
             errno = EMSGSIZE;
             iStatus = -1;
         }
-        else
+    }
+
+    /* Check that msg_ptr is a message slot of this mq currently on loan. */
+    if( iStatus == 0 )
+    {
+        if( prvReclaimMessageSlot( pxMessageQueue, msg_ptr ) == pdFALSE )
         {
-            /* Copy the data to send. */
-            ( void ) memcpy( xSendData.pcData, msg_ptr, msg_len );
+            errno = EINVAL;
+            iStatus = -1;
         }
     }
 
     if( iStatus == 0 )
     {
-        /* Send data to the FreeRTOS queue. */
-        if( xQueueSend( pxMessageQueue->xQueue,
-                        &xSendData,
-                        xTimeoutTicks ) == pdFALSE )
+        /* Queue the message slot itself. This does not block, because the
+         * queue has room for every message slot. */
+        xSendData.pcData = msg_ptr;
+        xSendData.xDataSize = msg_len;
+        ( void ) xQueueSend( pxMessageQueue->xQueue, &xSendData, 0 );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ssize_t mq_receive_loan( mqd_t mqdes,
+                         char ** msg_ptr,
+                         unsigned * msg_prio,
+                         const struct timespec * abstime )
+{
+    ssize_t xStatus = 0;
+    int iReceiveReturn = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
+    QueueElement_t xReceiveData = { 0 };
+
+    /* Silence warnings about unused parameters. */
+    ( void ) msg_prio;
+
+    /* Find the mq referenced by mqdes. */
+    pxMessageQueue = prvLookupDescriptor( mqdes );
+
+    if( pxMessageQueue == NULL )
+    {
+        /* Queue not found; bad descriptor. */
+        errno = EBADF;
+        xStatus = -1;
+    }
+
+    if( xStatus == 0 )
+    {
+        iReceiveReturn = prvReceiveMessage( pxMessageQueue, abstime, &xReceiveData );
+
+        if( iReceiveReturn != 0 )
         {
-            /* If queue send fails, set the appropriate errno. */
-            if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
-            {
-                /* Set errno to EAGAIN for nonblocking mq. */
-                errno = EAGAIN;
-            }
-            else
-            {
-                /* Otherwise, set errno to ETIMEDOUT. */
-                errno = ETIMEDOUT;
-            }
+            errno = iReceiveReturn;
+            xStatus = -1;
+        }
+    }
+
+    if( xStatus == 0 )
+    {
+        /* Hand the message slot to the caller, who returns it with mq_return. */
+        prvLoanMessageSlot( pxMessageQueue, xReceiveData.pcData );
+        *msg_ptr = xReceiveData.pcData;
+        xStatus = ( ssize_t ) xReceiveData.xDataSize;
+    }
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int mq_return( mqd_t mqdes,
+               char * msg_ptr )
+{
+    int iStatus = 0;
+    QueueListElement_t * pxMessageQueue = NULL;
+
+    /* Find the mq referenced by mqdes. */
+    pxMessageQueue = prvLookupDescriptor( mqdes );
 
-            /* Free the allocated queue data. */
-            vPortFree( xSendData.pcData );
+    if( pxMessageQueue == NULL )
+    {
+        /* Queue not found; bad descriptor. */
+        errno = EBADF;
+        iStatus = -1;
+    }
 
+    if( iStatus == 0 )
+    {
+        /* Check that msg_ptr is a message slot of this mq currently on loan,
+         * which rejects a slot that was already sent or returned. */
+        if( prvReclaimMessageSlot( pxMessageQueue, msg_ptr ) == pdFALSE )
+        {
+            errno = EINVAL;
             iStatus = -1;
         }
+        else
+        {
+            /* This does not block, because xFreeSlots has room for every
+             * message slot. */
+            ( void ) xQueueSend( pxMessageQueue->xFreeSlots, &msg_ptr, 0 );
+        }
     }
 
     return iStatus;
@@ -858,6 +1345,7 @@ int mq_unlink( const char * name )
             if( pxMessageQueue->xOpenDescriptors == 0 )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                prvForgetDescriptor( pxMessageQueue );
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
@@ -93,6 +93,9 @@ TEST_GROUP_RUNNER( Full_POSIX_MQUEUE )
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive );
     /*RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_invalidParams ); */
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_nonblock );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_loan_send_receive );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_loan_nonblock );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_return_twice );
 }
 
 /*-----------------------------------------------------------*/
@@ -550,3 +553,226 @@ TEST( Full_POSIX_MQUEUE, mq_send_receive_nonblock )
 }
 
 /*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_loan_send_receive )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char * pcMessage = NULL;
+    char * pcReceivedMessage = NULL;
+    char pcBuffer[ posixtestMQ_SMALL_MESSAGE_SIZE ] = { 0 };
+
+    if( TEST_PROTECT() )
+    {
+        /* Create queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        /* Write a message in a loaned buffer and send it. */
+        pcMessage = mq_loan( xMqId, NULL );
+        TEST_ASSERT_NOT_NULL( pcMessage );
+        ( void ) memcpy( pcMessage, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE );
+
+        iStatus = mq_send_loan( xMqId, pcMessage, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* The message is received in the buffer it was written in. */
+        iStatus = ( int ) mq_receive_loan( xMqId, &pcReceivedMessage, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_PTR( pcMessage, pcReceivedMessage );
+        TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcReceivedMessage );
+
+        iStatus = mq_return( xMqId, pcReceivedMessage );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* A message sent with mq_send can be received with mq_receive_loan,
+         * and the other way around. */
+        iStatus = mq_send( xMqId, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = ( int ) mq_receive_loan( xMqId, &pcReceivedMessage, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcReceivedMessage );
+
+        iStatus = mq_send_loan( xMqId, pcReceivedMessage, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = ( int ) mq_receive( xMqId, pcBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_STRING( posixtestMQ_SMALL_MESSAGE, pcBuffer );
+
+        /* Only buffers of the queue can be sent or returned. */
+        pcMessage = mq_loan( xMqId, NULL );
+        TEST_ASSERT_NOT_NULL( pcMessage );
+
+        iStatus = mq_send_loan( xMqId, pcBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        iStatus = mq_send_loan( xMqId, pcMessage + 1, posixtestMQ_SMALL_MESSAGE_SIZE - 1, 0 );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        iStatus = mq_return( xMqId, pcBuffer );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* Attempt to send a message that's larger than mq_msgsize. */
+        iStatus = mq_send_loan( xMqId, pcMessage, posixtestMQ_SMALL_MESSAGE_SIZE + 1, 0 );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EMSGSIZE, errno );
+
+        /* A buffer can only be returned once. */
+        iStatus = mq_return( xMqId, pcMessage );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = mq_return( xMqId, pcMessage );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+    }
+
+    /* Close and unlink the message queue. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+
+    /* The descriptor is no longer valid. */
+    TEST_ASSERT_NULL( mq_loan( xMqId, NULL ) );
+    TEST_ASSERT_EQUAL_INT( EBADF, errno );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_loan_nonblock )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char * pcMessage = NULL;
+    char * pcLastMessage = NULL;
+    long lLoaned = 0;
+
+    if( TEST_PROTECT() )
+    {
+        /* Create nonblocking queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR | O_NONBLOCK,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        /* Nothing to receive from an empty queue. */
+        iStatus = ( int ) mq_receive_loan( xMqId, &pcMessage, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EAGAIN, errno );
+
+        /* Loaned buffers count against mq_maxmsg. */
+        do
+        {
+            pcMessage = mq_loan( xMqId, NULL );
+
+            if( pcMessage != NULL )
+            {
+                pcLastMessage = pcMessage;
+                lLoaned++;
+            }
+        } while( pcMessage != NULL );
+
+        TEST_ASSERT_EQUAL_INT( EAGAIN, errno );
+        TEST_ASSERT_EQUAL_INT( xDefaultQueueAttr.mq_maxmsg, lLoaned );
+
+        iStatus = mq_send( xMqId, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EAGAIN, errno );
+
+        /* Returning a buffer makes room for a message. */
+        iStatus = mq_return( xMqId, pcLastMessage );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = mq_send( xMqId, posixtestMQ_SMALL_MESSAGE, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    }
+
+    /* Clean up resources used by test. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_MQUEUE, mq_return_twice )
+{
+    int iStatus = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char * pcFirstMessage = NULL;
+    char * pcSecondMessage = NULL;
+    char * pcMessage = NULL;
+    long lLoaned = 0;
+
+    if( TEST_PROTECT() )
+    {
+        /* Create nonblocking queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR | O_NONBLOCK,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        pcFirstMessage = mq_loan( xMqId, NULL );
+        TEST_ASSERT_NOT_NULL( pcFirstMessage );
+
+        pcSecondMessage = mq_loan( xMqId, NULL );
+        TEST_ASSERT_NOT_NULL( pcSecondMessage );
+
+        /* Return the first buffer twice while the second is still on loan. */
+        iStatus = mq_return( xMqId, pcFirstMessage );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = mq_return( xMqId, pcFirstMessage );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* A returned buffer cannot be sent either. */
+        iStatus = mq_send_loan( xMqId, pcFirstMessage, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* The first buffer was only freed once, so every buffer but the
+         * second can be loaned, and each only once. */
+        do
+        {
+            pcMessage = mq_loan( xMqId, NULL );
+
+            if( pcMessage != NULL )
+            {
+                TEST_ASSERT_NOT_EQUAL( pcSecondMessage, pcMessage );
+                lLoaned++;
+            }
+        } while( pcMessage != NULL );
+
+        TEST_ASSERT_EQUAL_INT( EAGAIN, errno );
+        TEST_ASSERT_EQUAL_INT( xDefaultQueueAttr.mq_maxmsg - 1, lLoaned );
+
+        /* A received buffer can only be returned once as well. */
+        iStatus = mq_send_loan( xMqId, pcSecondMessage, posixtestMQ_SMALL_MESSAGE_SIZE, 0 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = ( int ) mq_receive_loan( xMqId, &pcMessage, NULL, NULL );
+        TEST_ASSERT_EQUAL_INT( posixtestMQ_SMALL_MESSAGE_SIZE, iStatus );
+        TEST_ASSERT_EQUAL_PTR( pcSecondMessage, pcMessage );
+
+        iStatus = mq_return( xMqId, pcMessage );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = mq_return( xMqId, pcMessage );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+    }
+
+    /* Clean up resources used by test. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+}
+
+/*-----------------------------------------------------------*/
@@ -46,6 +46,50 @@
 
 /**@} */
 
+/**
+ * @brief The number of servers whose TLS session is kept for resumption.
+ *
+ * Set to 0 to perform a full handshake on every connection.
+ */
+#ifndef tlsconfigSESSION_CACHE_ENTRIES
+    #define tlsconfigSESSION_CACHE_ENTRIES               ( 2 )
+#endif
+
+/**
+ * @brief The size of the buffer holding the server name of a cached session.
+ *
+ * Sessions of servers with a longer name are not cached.
+ */
+#ifndef tlsconfigSESSION_CACHE_SERVER_NAME_LENGTH
+    #define tlsconfigSESSION_CACHE_SERVER_NAME_LENGTH    ( 80 )
+#endif
+
+/**
+ * @brief The number of seconds after which a cached session is no longer offered.
+ *
+ * A shorter lifetime hint sent by the server with its session ticket takes precedence.
+ */
+#ifndef tlsconfigSESSION_LIFETIME_S
+    #define tlsconfigSESSION_LIFETIME_S                  ( 7200UL )
+#endif
+
+/**
+ * @brief Set to 1 to save sessions with TLS_PAL_SaveSession(), so that they survive a
+ * reset or a deep sleep.
+ */
+#ifndef tlsconfigENABLE_SESSION_PERSISTENCE
+    #define tlsconfigENABLE_SESSION_PERSISTENCE          ( 0 )
+#endif
+
+/**
+ * @brief The largest session ticket that is cached.
+ *
+ * Sessions with a longer ticket are not cached.
+ */
+#ifndef tlsconfigSESSION_MAX_TICKET_LENGTH
+    #define tlsconfigSESSION_MAX_TICKET_LENGTH           ( 512 )
+#endif
+
 /**
  * @brief Defines callback type for receiving bytes from the network.
  *
@@ -133,6 +177,19 @@ BaseType_t TLS_Recv( void * pvContext,
                      unsigned char * pucReadBuffer,
                      size_t xReadLength );
 
+/**
+ * @brief Gets the number of decrypted bytes that can be read without reading
+ * from the network.
+ *
+ * A socket may not be readable while the TLS context still holds the rest of
+ * a record, so callers waiting for the socket must check this first.
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ *
+ * @return Number of bytes buffered in the TLS context.
+ */
+size_t TLS_GetBytesAvailable( void * pvContext );
+
 /**
  * @brief Writes the requested number of bytes to the secure connection.
  *
@@ -153,4 +210,53 @@ BaseType_t TLS_Send( void * pvContext,
  */
 void TLS_Cleanup( void * pvContext );
 
+/**
+ * @brief Drops the session cached for a server, so that the next connection
+ * to it performs a full handshake.
+ *
+ * TLS_Connect() keeps the session of each server it connected to, keyed by
+ * the pcDestination passed to TLS_Init(), and offers it to the server on the
+ * next connection. Call this after changing the credentials or the trusted
+ * certificates used for that server.
+ *
+ * @param pcServerName Network name of the TLS server.
+ */
+void TLS_ForgetSession( const char * pcServerName );
+
+/**
+ * @brief Saves a serialized TLS session to non-volatile storage.
+ *
+ * Only called when tlsconfigENABLE_SESSION_PERSISTENCE is 1, in which case
+ * the port must implement it. The session includes the master secret of the
+ * connection, so it should be kept in storage that is not readable from
+ * outside the device.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ * @param[in] pucSession Serialized session, or NULL to erase the saved session.
+ * @param[in] xSessionLength Length in bytes of the serialized session, or 0.
+ *
+ * @return pdTRUE if the session was saved, pdFALSE otherwise.
+ */
+BaseType_t TLS_PAL_SaveSession( const char * pcServerName,
+                                const uint8_t * pucSession,
+                                size_t xSessionLength );
+
+/**
+ * @brief Loads a serialized TLS session saved by TLS_PAL_SaveSession().
+ *
+ * Only called when tlsconfigENABLE_SESSION_PERSISTENCE is 1, the first time
+ * the device connects to a server after a reset.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ * @param[out] pucSession Buffer to receive the serialized session.
+ * @param[in] xBufferLength Length in bytes of the buffer.
+ * @param[out] pxSessionLength Length in bytes of the serialized session.
+ *
+ * @return pdTRUE if a session was found for the server, pdFALSE otherwise.
+ */
+BaseType_t TLS_PAL_LoadSession( const char * pcServerName,
+                                uint8_t * pucSession,
+                                size_t xBufferLength,
+                                size_t * pxSessionLength );
+
 #endif /* ifndef __AWS__TLS__H__ */
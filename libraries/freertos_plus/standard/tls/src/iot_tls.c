@@ -34,6 +34,7 @@
 #include "aws_clientcredential_keys.h"
 #include "iot_default_root_certificates.h"
 #include "core_pki_utils.h"
+#include "platform/iot_metrics.h"
 
 /* mbedTLS includes. */
 #include "mbedtls/platform.h"
@@ -141,6 +142,51 @@ typedef struct TLSContext
 
 #define TLS_PRINT( X )    configPRINTF( X )
 
+#if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+
+/**
+ * @brief A session cached for resumption.
+ *
+ * An entry is free when its server name is empty.
+ */
+    typedef struct TLSSessionCacheEntry
+    {
+        char cServerName[ tlsconfigSESSION_CACHE_SERVER_NAME_LENGTH ];
+        TickType_t xCreated;
+        TickType_t xLastUsed;
+        mbedtls_ssl_session xSession;
+    } TLSSessionCacheEntry_t;
+
+/**
+ * @brief The session cache, shared by all TLS contexts.
+ *
+ * Sessions are small and only copied in and out of the cache, so the cache is
+ * protected by suspending the scheduler rather than by a mutex.
+ */
+    static TLSSessionCacheEntry_t xSessionCache[ tlsconfigSESSION_CACHE_ENTRIES ];
+
+    #define tlsSESSION_CACHE_LOCK()      vTaskSuspendAll()
+    #define tlsSESSION_CACHE_UNLOCK()    ( void ) xTaskResumeAll()
+
+    #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 ) || defined( FREERTOS_ENABLE_UNIT_TESTS )
+
+/**
+ * @brief Version of the serialized session format.
+ */
+        #define tlsSESSION_FORMAT_VERSION    ( 2U )
+
+/**
+ * @brief Length of a serialized session without its ticket.
+ *
+ * Version (1), age in seconds (4), ciphersuite (4), compression (1), session
+ * ID length (1) and session ID (32), master secret (48), verify result (4),
+ * max fragment length code (1), truncated HMAC (1), encrypt then MAC (1),
+ * ticket lifetime (4) and ticket length (2).
+ */
+        #define tlsSESSION_HEADER_LENGTH     ( 104U )
+    #endif
+#endif /* if ( tlsconfigSESSION_CACHE_ENTRIES > 0 ) */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -701,6 +747,733 @@ static int prvEntropyCallback( void * tlsContext,
     return ret;
 }
 
+/*-----------------------------------------------------------*/
+
+#if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+
+/**
+ * @brief Checks whether the session of a server can be cached.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ *
+ * @return pdTRUE if the name fits in a cache entry, pdFALSE otherwise.
+ */
+    static BaseType_t prvSessionCacheable( const char * pcServerName )
+    {
+        BaseType_t xCacheable = pdFALSE;
+
+        if( ( NULL != pcServerName ) &&
+            ( '\0' != pcServerName[ 0 ] ) &&
+            ( strlen( pcServerName ) < tlsconfigSESSION_CACHE_SERVER_NAME_LENGTH ) )
+        {
+            xCacheable = pdTRUE;
+        }
+
+        return xCacheable;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Finds the cache entry of a server. The cache must be locked.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ *
+ * @return The entry, or NULL if no session of the server is cached.
+ */
+    static TLSSessionCacheEntry_t * prvSessionCacheFind( const char * pcServerName )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+        size_t i = 0;
+
+        for( i = 0; i < tlsconfigSESSION_CACHE_ENTRIES; i++ )
+        {
+            if( ( '\0' != xSessionCache[ i ].cServerName[ 0 ] ) &&
+                ( 0 == strcmp( xSessionCache[ i ].cServerName, pcServerName ) ) )
+            {
+                pxEntry = &xSessionCache[ i ];
+                break;
+            }
+        }
+
+        return pxEntry;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Checks whether a cached session is too old to be offered. The cache
+ * must be locked.
+ *
+ * @param[in] pxEntry Cache entry.
+ * @param[in] xNow Current tick count.
+ *
+ * @return pdTRUE if the session expired, pdFALSE otherwise.
+ */
+    static BaseType_t prvSessionExpired( const TLSSessionCacheEntry_t * pxEntry,
+                                         TickType_t xNow )
+    {
+        uint32_t ulLifetime = tlsconfigSESSION_LIFETIME_S;
+
+        #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+            if( ( NULL != pxEntry->xSession.ticket ) &&
+                ( 0U != pxEntry->xSession.ticket_lifetime ) &&
+                ( pxEntry->xSession.ticket_lifetime < ulLifetime ) )
+            {
+                ulLifetime = pxEntry->xSession.ticket_lifetime;
+            }
+        #endif
+
+        return ( ( ( uint32_t ) ( xNow - pxEntry->xCreated ) / ( uint32_t ) configTICK_RATE_HZ ) >= ulLifetime ) ? pdTRUE : pdFALSE;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Checks whether two sessions are the same session.
+ *
+ * A resumed session keeps its master secret, but the server may have sent a
+ * new ticket for it.
+ *
+ * @param[in] pxA First session.
+ * @param[in] pxB Second session.
+ *
+ * @return pdTRUE if the sessions are the same, pdFALSE otherwise.
+ */
+    static BaseType_t prvSessionEqual( const mbedtls_ssl_session * pxA,
+                                       const mbedtls_ssl_session * pxB )
+    {
+        BaseType_t xEqual = pdFALSE;
+
+        if( 0 == memcmp( pxA->master, pxB->master, sizeof( pxA->master ) ) )
+        {
+            xEqual = pdTRUE;
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                if( pxA->ticket_len != pxB->ticket_len )
+                {
+                    xEqual = pdFALSE;
+                }
+                else if( ( NULL != pxA->ticket ) && ( NULL != pxB->ticket ) )
+                {
+                    xEqual = ( 0 == memcmp( pxA->ticket, pxB->ticket, pxA->ticket_len ) ) ? pdTRUE : pdFALSE;
+                }
+                else if( pxA->ticket != pxB->ticket )
+                {
+                    xEqual = pdFALSE;
+                }
+            #endif
+        }
+
+        return xEqual;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Moves a session into the cache entry of a server, replacing the
+ * session of the least recently used server if the cache is full.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ * @param[in,out] pxSession Session to cache. Receives the session it replaced,
+ * which the caller must free.
+ * @param[in] xCreated Tick count at which the session was established.
+ */
+    static void prvSessionCacheStore( const char * pcServerName,
+                                      mbedtls_ssl_session * pxSession,
+                                      TickType_t xCreated )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+        mbedtls_ssl_session xReplaced;
+        TickType_t xNow = 0;
+        size_t i = 0;
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            xNow = xTaskGetTickCount();
+            pxEntry = prvSessionCacheFind( pcServerName );
+
+            for( i = 0; ( NULL == pxEntry ) && ( i < tlsconfigSESSION_CACHE_ENTRIES ); i++ )
+            {
+                if( '\0' == xSessionCache[ i ].cServerName[ 0 ] )
+                {
+                    pxEntry = &xSessionCache[ i ];
+                }
+            }
+
+            if( NULL == pxEntry )
+            {
+                pxEntry = &xSessionCache[ 0 ];
+
+                for( i = 1; i < tlsconfigSESSION_CACHE_ENTRIES; i++ )
+                {
+                    if( ( xNow - xSessionCache[ i ].xLastUsed ) > ( xNow - pxEntry->xLastUsed ) )
+                    {
+                        pxEntry = &xSessionCache[ i ];
+                    }
+                }
+            }
+
+            xReplaced = pxEntry->xSession;
+            pxEntry->xSession = *pxSession;
+            *pxSession = xReplaced;
+
+            strcpy( pxEntry->cServerName, pcServerName );
+            pxEntry->xCreated = xCreated;
+            pxEntry->xLastUsed = xNow;
+        }
+        tlsSESSION_CACHE_UNLOCK();
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Removes the session of a server from the cache.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ * @param[out] pxSession Receives the removed session, which the caller must free.
+ */
+    static void prvSessionCacheRemove( const char * pcServerName,
+                                       mbedtls_ssl_session * pxSession )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            pxEntry = prvSessionCacheFind( pcServerName );
+
+            if( NULL != pxEntry )
+            {
+                *pxSession = pxEntry->xSession;
+                memset( pxEntry, 0, sizeof( TLSSessionCacheEntry_t ) );
+            }
+        }
+        tlsSESSION_CACHE_UNLOCK();
+    }
+
+/*-----------------------------------------------------------*/
+
+    #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 ) || defined( FREERTOS_ENABLE_UNIT_TESTS )
+
+/**
+ * @brief Writes a big-endian integer of the given length.
+ *
+ * @param[out] pucBuffer Output buffer.
+ * @param[in] ulValue Value to write.
+ * @param[in] xLength Number of bytes to write.
+ *
+ * @return The buffer past the written bytes.
+ */
+        static uint8_t * prvWriteInteger( uint8_t * pucBuffer,
+                                          uint32_t ulValue,
+                                          size_t xLength )
+        {
+            size_t i = 0;
+
+            for( i = 0; i < xLength; i++ )
+            {
+                pucBuffer[ i ] = ( uint8_t ) ( ulValue >> ( 8U * ( xLength - i - 1U ) ) );
+            }
+
+            return pucBuffer + xLength;
+        }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Reads a big-endian integer of the given length.
+ *
+ * @param[in,out] ppucBuffer Input buffer, advanced past the read bytes.
+ * @param[in] xLength Number of bytes to read.
+ *
+ * @return The value read.
+ */
+        static uint32_t prvReadInteger( const uint8_t ** ppucBuffer,
+                                        size_t xLength )
+        {
+            uint32_t ulValue = 0;
+            size_t i = 0;
+
+            for( i = 0; i < xLength; i++ )
+            {
+                ulValue = ( ulValue << 8U ) | ( *ppucBuffer )[ i ];
+            }
+
+            *ppucBuffer += xLength;
+
+            return ulValue;
+        }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Returns the length of a session serialized by prvSessionSerialize().
+ *
+ * @param[in] pxSession Session to serialize.
+ *
+ * @return Length in bytes of the serialized session.
+ */
+        static size_t prvSessionSerializedLength( const mbedtls_ssl_session * pxSession )
+        {
+            size_t xLength = tlsSESSION_HEADER_LENGTH;
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                if( NULL != pxSession->ticket )
+                {
+                    xLength += pxSession->ticket_len;
+                }
+            #else
+                ( void ) pxSession;
+            #endif
+
+            return xLength;
+        }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Serializes a session.
+ *
+ * The age is saved rather than the tick count at which the session was
+ * established, which has no meaning after a reset.
+ *
+ * @param[in] pxSession Session to serialize.
+ * @param[in] ulAge Age of the session in seconds.
+ * @param[out] pucBuffer Buffer of prvSessionSerializedLength() bytes.
+ */
+        static void prvSessionSerialize( const mbedtls_ssl_session * pxSession,
+                                         uint32_t ulAge,
+                                         uint8_t * pucBuffer )
+        {
+            uint8_t * pucNext = NULL;
+            size_t xTicketLength = prvSessionSerializedLength( pxSession ) - tlsSESSION_HEADER_LENGTH;
+            uint32_t ulValue = 0;
+
+            pucNext = prvWriteInteger( pucBuffer, tlsSESSION_FORMAT_VERSION, 1 );
+            pucNext = prvWriteInteger( pucNext, ulAge, 4 );
+            pucNext = prvWriteInteger( pucNext, ( uint32_t ) pxSession->ciphersuite, 4 );
+            pucNext = prvWriteInteger( pucNext, ( uint32_t ) pxSession->compression, 1 );
+            pucNext = prvWriteInteger( pucNext, ( uint32_t ) pxSession->id_len, 1 );
+            memcpy( pucNext, pxSession->id, sizeof( pxSession->id ) );
+            pucNext += sizeof( pxSession->id );
+            memcpy( pucNext, pxSession->master, sizeof( pxSession->master ) );
+            pucNext += sizeof( pxSession->master );
+            pucNext = prvWriteInteger( pucNext, pxSession->verify_result, 4 );
+
+            ulValue = 0;
+            #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+                ulValue = pxSession->mfl_code;
+            #endif
+            pucNext = prvWriteInteger( pucNext, ulValue, 1 );
+
+            ulValue = 0;
+            #if defined( MBEDTLS_SSL_TRUNCATED_HMAC )
+                ulValue = ( uint32_t ) pxSession->trunc_hmac;
+            #endif
+            pucNext = prvWriteInteger( pucNext, ulValue, 1 );
+
+            ulValue = 0;
+            #if defined( MBEDTLS_SSL_ENCRYPT_THEN_MAC )
+                ulValue = ( uint32_t ) pxSession->encrypt_then_mac;
+            #endif
+            pucNext = prvWriteInteger( pucNext, ulValue, 1 );
+
+            ulValue = 0;
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                ulValue = pxSession->ticket_lifetime;
+            #endif
+            pucNext = prvWriteInteger( pucNext, ulValue, 4 );
+            pucNext = prvWriteInteger( pucNext, ( uint32_t ) xTicketLength, 2 );
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                if( 0U != xTicketLength )
+                {
+                    memcpy( pucNext, pxSession->ticket, xTicketLength );
+                }
+            #endif
+        }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Parses a session serialized by prvSessionSerialize().
+ *
+ * @param[in] pucBuffer Serialized session.
+ * @param[in] xLength Length in bytes of the serialized session.
+ * @param[out] pxSession Session to fill in, which the caller must free.
+ * @param[out] pulAge Receives the age of the session in seconds.
+ *
+ * @return pdTRUE if the session was parsed, pdFALSE otherwise.
+ */
+        static BaseType_t prvSessionParse( const uint8_t * pucBuffer,
+                                           size_t xLength,
+                                           mbedtls_ssl_session * pxSession,
+                                           uint32_t * pulAge )
+        {
+            const uint8_t * pucNext = pucBuffer;
+            BaseType_t xResult = pdFALSE;
+            size_t xTicketLength = 0;
+            uint32_t ulValue = 0;
+
+            if( ( xLength >= tlsSESSION_HEADER_LENGTH ) &&
+                ( tlsSESSION_FORMAT_VERSION == prvReadInteger( &pucNext, 1 ) ) )
+            {
+                *pulAge = prvReadInteger( &pucNext, 4 );
+                pxSession->ciphersuite = ( int ) prvReadInteger( &pucNext, 4 );
+                pxSession->compression = ( int ) prvReadInteger( &pucNext, 1 );
+                pxSession->id_len = prvReadInteger( &pucNext, 1 );
+                memcpy( pxSession->id, pucNext, sizeof( pxSession->id ) );
+                pucNext += sizeof( pxSession->id );
+                memcpy( pxSession->master, pucNext, sizeof( pxSession->master ) );
+                pucNext += sizeof( pxSession->master );
+                pxSession->verify_result = prvReadInteger( &pucNext, 4 );
+
+                ulValue = prvReadInteger( &pucNext, 1 );
+                #if defined( MBEDTLS_SSL_MAX_FRAGMENT_LENGTH )
+                    pxSession->mfl_code = ( unsigned char ) ulValue;
+                #endif
+
+                ulValue = prvReadInteger( &pucNext, 1 );
+                #if defined( MBEDTLS_SSL_TRUNCATED_HMAC )
+                    pxSession->trunc_hmac = ( int ) ulValue;
+                #endif
+
+                ulValue = prvReadInteger( &pucNext, 1 );
+                #if defined( MBEDTLS_SSL_ENCRYPT_THEN_MAC )
+                    pxSession->encrypt_then_mac = ( int ) ulValue;
+                #endif
+
+                ulValue = prvReadInteger( &pucNext, 4 );
+                xTicketLength = prvReadInteger( &pucNext, 2 );
+
+                if( ( pxSession->id_len <= sizeof( pxSession->id ) ) &&
+                    ( ( tlsSESSION_HEADER_LENGTH + xTicketLength ) == xLength ) )
+                {
+                    xResult = pdTRUE;
+                }
+            }
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                if( ( pdTRUE == xResult ) && ( 0U != xTicketLength ) )
+                {
+                    pxSession->ticket = mbedtls_calloc( 1, xTicketLength );
+
+                    if( NULL != pxSession->ticket )
+                    {
+                        memcpy( pxSession->ticket, pucNext, xTicketLength );
+                        pxSession->ticket_len = xTicketLength;
+                        pxSession->ticket_lifetime = ulValue;
+                    }
+                    else
+                    {
+                        xResult = pdFALSE;
+                    }
+                }
+            #else
+
+                /* Without ticket support, the session ID alone may still be
+                 * enough to resume the session. */
+                ( void ) ulValue;
+            #endif /* if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C ) */
+
+            return xResult;
+        }
+    #endif /* if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 ) || defined( FREERTOS_ENABLE_UNIT_TESTS ) */
+
+/*-----------------------------------------------------------*/
+
+    #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 )
+
+/**
+ * @brief Serializes a session and saves it with TLS_PAL_SaveSession().
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ * @param[in] pxSession Session to save.
+ * @param[in] ulAge Age of the session in seconds.
+ */
+        static void prvSessionPersist( const char * pcServerName,
+                                       const mbedtls_ssl_session * pxSession,
+                                       uint32_t ulAge )
+        {
+            size_t xLength = prvSessionSerializedLength( pxSession );
+            uint8_t * pucBuffer = ( uint8_t * ) pvPortMalloc( xLength );
+
+            if( NULL != pucBuffer )
+            {
+                prvSessionSerialize( pxSession, ulAge, pucBuffer );
+
+                if( pdTRUE != TLS_PAL_SaveSession( pcServerName, pucBuffer, xLength ) )
+                {
+                    TLS_PRINT( ( "WARN: Failed to save the TLS session of %s.\r\n", pcServerName ) );
+                }
+
+                /* Do not leave the master secret on the heap. */
+                memset( pucBuffer, 0, xLength );
+                vPortFree( pucBuffer );
+            }
+        }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Loads the saved session of a server into the cache, if the cache
+ * does not hold a session of that server yet.
+ *
+ * @param[in] pcServerName Network name of the TLS server.
+ */
+        static void prvSessionLoad( const char * pcServerName )
+        {
+            mbedtls_ssl_session xSession;
+            uint8_t * pucBuffer = NULL;
+            size_t xBufferLength = tlsSESSION_HEADER_LENGTH + tlsconfigSESSION_MAX_TICKET_LENGTH;
+            size_t xLength = 0;
+            uint32_t ulAge = 0;
+            BaseType_t xCached = pdFALSE;
+
+            mbedtls_ssl_session_init( &xSession );
+
+            tlsSESSION_CACHE_LOCK();
+            {
+                xCached = ( NULL != prvSessionCacheFind( pcServerName ) ) ? pdTRUE : pdFALSE;
+            }
+            tlsSESSION_CACHE_UNLOCK();
+
+            if( pdFALSE == xCached )
+            {
+                pucBuffer = ( uint8_t * ) pvPortMalloc( xBufferLength );
+            }
+
+            if( NULL != pucBuffer )
+            {
+                if( ( pdTRUE == TLS_PAL_LoadSession( pcServerName, pucBuffer, xBufferLength, &xLength ) ) &&
+                    ( xLength <= xBufferLength ) &&
+                    ( pdTRUE == prvSessionParse( pucBuffer, xLength, &xSession, &ulAge ) ) )
+                {
+                    if( ulAge < tlsconfigSESSION_LIFETIME_S )
+                    {
+                        /* Date the session back by its age, so that it expires
+                         * when it would have without the reset. */
+                        prvSessionCacheStore( pcServerName,
+                                              &xSession,
+                                              xTaskGetTickCount() - ( ( TickType_t ) ulAge * ( TickType_t ) configTICK_RATE_HZ ) );
+                    }
+                    else
+                    {
+                        ( void ) TLS_PAL_SaveSession( pcServerName, NULL, 0 );
+                    }
+                }
+
+                memset( pucBuffer, 0, xBufferLength );
+                vPortFree( pucBuffer );
+            }
+
+            mbedtls_ssl_session_free( &xSession );
+        }
+    #endif /* if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Offers the cached session of the server to resume it.
+ *
+ * The session is copied out of the cache while the scheduler is suspended,
+ * and handed to mbedTLS, which allocates its own copy, after it is resumed.
+ *
+ * @param[in] pxCtx TLS context, set up but not connected yet.
+ *
+ * @return pdTRUE if a session was offered, pdFALSE otherwise.
+ */
+    static BaseType_t prvSessionRestore( TLSContext_t * pxCtx )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+        mbedtls_ssl_session xSession;
+        mbedtls_ssl_session xExpired;
+        unsigned char * pucTicket = NULL;
+        BaseType_t xFound = pdFALSE;
+        BaseType_t xOffered = pdFALSE;
+        BaseType_t xExpiredFound = pdFALSE;
+
+        mbedtls_ssl_session_init( &xSession );
+        mbedtls_ssl_session_init( &xExpired );
+
+        #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 )
+            prvSessionLoad( pxCtx->pcDestination );
+        #endif
+
+        #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+            /* The ticket is copied while the scheduler is suspended, when memory
+             * cannot be allocated, so allocate room for the largest one now. */
+            pucTicket = ( unsigned char * ) mbedtls_calloc( 1, tlsconfigSESSION_MAX_TICKET_LENGTH );
+        #endif
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            pxEntry = prvSessionCacheFind( pxCtx->pcDestination );
+
+            if( NULL == pxEntry )
+            {
+                /* Nothing to offer. */
+            }
+            else if( pdTRUE == prvSessionExpired( pxEntry, xTaskGetTickCount() ) )
+            {
+                xExpired = pxEntry->xSession;
+                memset( pxEntry, 0, sizeof( TLSSessionCacheEntry_t ) );
+                xExpiredFound = pdTRUE;
+            }
+            else
+            {
+                xSession = pxEntry->xSession;
+                xFound = pdTRUE;
+
+                #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                    xSession.ticket = NULL;
+                    xSession.ticket_len = 0;
+
+                    if( NULL == pxEntry->xSession.ticket )
+                    {
+                        /* The session is resumed by its ID. */
+                    }
+                    else if( NULL != pucTicket )
+                    {
+                        memcpy( pucTicket, pxEntry->xSession.ticket, pxEntry->xSession.ticket_len );
+                        xSession.ticket = pucTicket;
+                        xSession.ticket_len = pxEntry->xSession.ticket_len;
+                    }
+                    else
+                    {
+                        xFound = pdFALSE;
+                    }
+                #endif
+
+                if( pdTRUE == xFound )
+                {
+                    pxEntry->xLastUsed = xTaskGetTickCount();
+                }
+            }
+        }
+        tlsSESSION_CACHE_UNLOCK();
+
+        if( pdTRUE == xFound )
+        {
+            if( 0 == mbedtls_ssl_set_session( &pxCtx->xMbedSslCtx, &xSession ) )
+            {
+                xOffered = pdTRUE;
+            }
+            else
+            {
+                /* mbedTLS fails only when it cannot copy the ticket, and then
+                 * may leave the pointer to the copied ticket in the context. */
+                #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                    pxCtx->xMbedSslCtx.session_negotiate->ticket = NULL;
+                    pxCtx->xMbedSslCtx.session_negotiate->ticket_len = 0;
+                #endif
+            }
+        }
+
+        /* Do not leave the master secret or the ticket on the stack and heap. */
+        memset( &xSession, 0, sizeof( xSession ) );
+
+        if( NULL != pucTicket )
+        {
+            memset( pucTicket, 0, tlsconfigSESSION_MAX_TICKET_LENGTH );
+            mbedtls_free( pucTicket );
+        }
+
+        if( pdTRUE == xExpiredFound )
+        {
+            mbedtls_ssl_session_free( &xExpired );
+
+            #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 )
+                ( void ) TLS_PAL_SaveSession( pxCtx->pcDestination, NULL, 0 );
+            #endif
+        }
+
+        return xOffered;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Caches the session of a connection that completed its handshake.
+ *
+ * @param[in] pxCtx Connected TLS context.
+ */
+    static void prvSessionSave( TLSContext_t * pxCtx )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+        mbedtls_ssl_session xSession;
+        BaseType_t xResumed = pdFALSE;
+        BaseType_t xChanged = pdTRUE;
+        TickType_t xCreated = xTaskGetTickCount();
+        int lResult = 0;
+
+        #if defined( MBEDTLS_X509_CRT_PARSE_C )
+            mbedtls_x509_crt * pxPeerCert = pxCtx->xMbedSslCtx.session->peer_cert;
+
+            /* The server certificate was verified by this handshake and is not
+             * needed to resume the session, so do not copy it into the cache. */
+            pxCtx->xMbedSslCtx.session->peer_cert = NULL;
+        #endif
+
+        mbedtls_ssl_session_init( &xSession );
+        lResult = mbedtls_ssl_get_session( &pxCtx->xMbedSslCtx, &xSession );
+
+        #if defined( MBEDTLS_X509_CRT_PARSE_C )
+            pxCtx->xMbedSslCtx.session->peer_cert = pxPeerCert;
+        #endif
+
+        #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+            if( 0 != lResult )
+            {
+                /* mbedTLS fails only when it cannot copy the ticket, and then
+                 * may leave the pointer to the ticket of the connection in the copy. */
+                xSession.ticket = NULL;
+            }
+            else if( xSession.ticket_len > tlsconfigSESSION_MAX_TICKET_LENGTH )
+            {
+                /* prvSessionRestore() could not copy the ticket back out. */
+                lResult = -1;
+            }
+        #endif
+
+        if( 0 == lResult )
+        {
+            tlsSESSION_CACHE_LOCK();
+            {
+                pxEntry = prvSessionCacheFind( pxCtx->pcDestination );
+
+                if( ( NULL != pxEntry ) &&
+                    ( 0 == memcmp( pxEntry->xSession.master, xSession.master, sizeof( xSession.master ) ) ) )
+                {
+                    /* The session was resumed, so it keeps its age even if the
+                     * server sent a new ticket for it. */
+                    xResumed = pdTRUE;
+                    xCreated = pxEntry->xCreated;
+                    xChanged = ( pdTRUE == prvSessionEqual( &pxEntry->xSession, &xSession ) ) ? pdFALSE : pdTRUE;
+                }
+            }
+            tlsSESSION_CACHE_UNLOCK();
+
+            if( pdTRUE == xResumed )
+            {
+                IOT_METRICS_COUNT( IOT_METRICS_TLS_SESSIONS_RESUMED );
+            }
+
+            if( pdTRUE == xChanged )
+            {
+                #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 )
+                    prvSessionPersist( pxCtx->pcDestination,
+                                       &xSession,
+                                       ( uint32_t ) ( xTaskGetTickCount() - xCreated ) / ( uint32_t ) configTICK_RATE_HZ );
+                #endif
+                prvSessionCacheStore( pxCtx->pcDestination, &xSession, xCreated );
+            }
+        }
+
+        mbedtls_ssl_session_free( &xSession );
+    }
+#endif /* if ( tlsconfigSESSION_CACHE_ENTRIES > 0 ) */
+
 /*
  * Interface routines.
  */
@@ -798,6 +1571,11 @@ BaseType_t TLS_Connect( void * pvContext )
 {
     BaseType_t xResult = 0;
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    uint32_t ulStartUs = 0;
+
+    #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+        BaseType_t xSessionOffered = pdFALSE;
+    #endif
 
     /* Initialize mbedTLS structures. */
     mbedtls_ssl_init( &pxCtx->xMbedSslCtx );
@@ -924,6 +1702,15 @@ BaseType_t TLS_Connect( void * pvContext )
         xResult = mbedtls_ssl_set_hostname( &pxCtx->xMbedSslCtx, pxCtx->pcDestination );
     }
 
+    #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+        /* Offer the session of the last connection to this server, so that
+         * the server can skip the certificate exchange and key agreement. */
+        if( ( 0 == xResult ) && ( pdTRUE == prvSessionCacheable( pxCtx->pcDestination ) ) )
+        {
+            xSessionOffered = prvSessionRestore( pxCtx );
+        }
+    #endif
+
     /* Set the socket callbacks. */
     if( 0 == xResult )
     {
@@ -933,6 +1720,8 @@ BaseType_t TLS_Connect( void * pvContext )
                              prvNetworkRecv,
                              NULL );
 
+        ulStartUs = IOT_METRICS_TIMESTAMP();
+
         /* Negotiate. */
         while( 0 != ( xResult = mbedtls_ssl_handshake( &pxCtx->xMbedSslCtx ) ) )
         {
@@ -955,6 +1744,14 @@ BaseType_t TLS_Connect( void * pvContext )
     if( 0 == xResult )
     {
         pxCtx->xTLSHandshakeState = TLS_HANDSHAKE_SUCCESSFUL;
+        IOT_METRICS_RECORD_SINCE( IOT_METRICS_TLS_HANDSHAKE, ulStartUs );
+
+        #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+            if( pdTRUE == prvSessionCacheable( pxCtx->pcDestination ) )
+            {
+                prvSessionSave( pxCtx );
+            }
+        #endif
     }
     else if( xResult > 0 )
     {
@@ -963,6 +1760,19 @@ BaseType_t TLS_Connect( void * pvContext )
         xResult = TLS_ERROR_HANDSHAKE_FAILED;
     }
 
+    if( 0 != xResult )
+    {
+        IOT_METRICS_COUNT( IOT_METRICS_TLS_HANDSHAKE_FAILURES );
+    }
+
+    #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+        /* Do not offer the session again if the handshake resuming it failed. */
+        if( ( 0 != xResult ) && ( pdTRUE == xSessionOffered ) )
+        {
+            TLS_ForgetSession( pxCtx->pcDestination );
+        }
+    #endif
+
     /* Free up allocated memory. */
     mbedtls_x509_crt_free( &pxCtx->xMbedX509CA );
     mbedtls_x509_crt_free( &pxCtx->xMbedX509Cli );
@@ -979,6 +1789,7 @@ BaseType_t TLS_Recv( void * pvContext,
     BaseType_t xResult = 0;
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
     size_t xRead = 0;
+    uint32_t ulStartUs = IOT_METRICS_TIMESTAMP();
 
     if( ( NULL != pxCtx ) && ( TLS_HANDSHAKE_SUCCESSFUL == pxCtx->xTLSHandshakeState ) )
     {
@@ -1009,6 +1820,12 @@ BaseType_t TLS_Recv( void * pvContext,
     if( xResult >= 0 )
     {
         xResult = ( BaseType_t ) xRead;
+
+        /* A read that returned nothing only polled the socket. */
+        if( xRead > 0U )
+        {
+            IOT_METRICS_RECORD_SINCE( IOT_METRICS_TLS_RECEIVE, ulStartUs );
+        }
     }
     else
     {
@@ -1028,6 +1845,7 @@ BaseType_t TLS_Send( void * pvContext,
     BaseType_t xResult = 0;
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
     size_t xWritten = 0;
+    uint32_t ulStartUs = IOT_METRICS_TIMESTAMP();
 
     if( ( NULL != pxCtx ) && ( TLS_HANDSHAKE_SUCCESSFUL == pxCtx->xTLSHandshakeState ) )
     {
@@ -1066,6 +1884,11 @@ BaseType_t TLS_Send( void * pvContext,
     if( 0 <= xResult )
     {
         xResult = ( BaseType_t ) xWritten;
+
+        if( xWritten > 0U )
+        {
+            IOT_METRICS_RECORD_SINCE( IOT_METRICS_TLS_SEND, ulStartUs );
+        }
     }
 
     return xResult;
@@ -1073,6 +1896,21 @@ BaseType_t TLS_Send( void * pvContext,
 
 /*-----------------------------------------------------------*/
 
+size_t TLS_GetBytesAvailable( void * pvContext )
+{
+    TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    size_t xAvailable = 0;
+
+    if( ( NULL != pxCtx ) && ( TLS_HANDSHAKE_SUCCESSFUL == pxCtx->xTLSHandshakeState ) )
+    {
+        xAvailable = mbedtls_ssl_get_bytes_avail( &pxCtx->xMbedSslCtx );
+    }
+
+    return xAvailable;
+}
+
+/*-----------------------------------------------------------*/
+
 void TLS_Cleanup( void * pvContext )
 {
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
@@ -1085,3 +1923,32 @@ void TLS_Cleanup( void * pvContext )
         vPortFree( pxCtx );
     }
 }
+
+/*-----------------------------------------------------------*/
+
+void TLS_ForgetSession( const char * pcServerName )
+{
+    #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+        mbedtls_ssl_session xSession;
+
+        if( pdTRUE == prvSessionCacheable( pcServerName ) )
+        {
+            mbedtls_ssl_session_init( &xSession );
+            prvSessionCacheRemove( pcServerName, &xSession );
+            mbedtls_ssl_session_free( &xSession );
+
+            #if ( tlsconfigENABLE_SESSION_PERSISTENCE == 1 )
+                ( void ) TLS_PAL_SaveSession( pcServerName, NULL, 0 );
+            #endif
+        }
+    #else
+        ( void ) pcServerName;
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/* Provide access to private members for testing. */
+#ifdef FREERTOS_ENABLE_UNIT_TESTS
+    #include "iot_tls_test_access_define.h"
+#endif
@@ -26,6 +26,9 @@
 /* Standard includes. */
 #include <string.h>
 
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
 /* Test framework includes. */
 #include "unity_fixture.h"
 #include "aws_test_runner.h"
@@ -33,6 +36,11 @@
 /* Secure sockets includes */
 #include "iot_secure_sockets.h"
 
+/* TLS includes. */
+#include "iot_tls.h"
+#include "iot_tls_test_access_declare.h"
+#include "mbedtls/platform.h"
+
 /* Credential includes. */
 #include "aws_clientcredential.h"
 #include "aws_clientcredential_keys.h"
@@ -85,6 +93,12 @@ TEST_TEAR_DOWN( Full_TLS )
 TEST_GROUP_RUNNER( Full_TLS )
 {
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectDefault );
+    #if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+        RUN_TEST_CASE( Full_TLS, AFQP_TLS_SessionSerializer );
+        RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectResumeSession );
+        RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectExpiredSession );
+        RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectForgetFailedSession );
+    #endif
     #if ( pkcs11configIMPORT_PRIVATE_KEYS_SUPPORTED == 1 )
         #if ( pkcs11testEC_KEY_SUPPORT == 1 )
             RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectEC );
@@ -121,6 +135,46 @@ static void prvSecureSocketClose( Socket_t xSocket )
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * Connects to the MQTT broker endpoint and disconnects.
+ *
+ * Returns the result of SOCKETS_Connect().
+ */
+static BaseType_t prvConnectToBroker( void )
+{
+    const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+    uint16_t usAWSIoTPort = clientcredentialMQTT_BROKER_PORT;
+    SocketsSockaddr_t xMQTTServerAddress = { 0 };
+    Socket_t xSocket;
+    BaseType_t xResult;
+    BaseType_t xConnectResult = SOCKETS_SOCKET_ERROR;
+
+    xMQTTServerAddress.ulAddress = SOCKETS_GetHostByName( pcAWSIoTAddress );
+    xMQTTServerAddress.usPort = SOCKETS_htons( usAWSIoTPort );
+    xMQTTServerAddress.ucSocketDomain = SOCKETS_AF_INET;
+
+    xSocket = prvSecureSocketCreate();
+
+    if( TEST_PROTECT() )
+    {
+        xResult = SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_SERVER_NAME_INDICATION, pcAWSIoTAddress, 1u + strlen( pcAWSIoTAddress ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket set sock opt server name indication failed" );
+
+        xConnectResult = SOCKETS_Connect( xSocket, &xMQTTServerAddress, sizeof( xMQTTServerAddress ) );
+
+        if( SOCKETS_ERROR_NONE == xConnectResult )
+        {
+            xResult = SOCKETS_Shutdown( xSocket, SOCKETS_SHUT_RDWR );
+            TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket disconnect failed" );
+        }
+    }
+
+    prvSecureSocketClose( xSocket );
+
+    return xConnectResult;
+}
+/*-----------------------------------------------------------*/
+
 static void prvConnectWithProvisioning( ProvisioningParams_t * pxProvisioningParams,
                                         BaseType_t xConnectExpectedToSucceed )
 {
@@ -133,8 +187,10 @@ static void prvConnectWithProvisioning( ProvisioningParams_t * pxProvisioningPar
 
     if( TEST_PROTECT() )
     {
-        /* Provision the device with the supplied parameters. */
+        /* Provision the device with the supplied parameters. A session
+         * established with other credentials must not be resumed. */
         vAlternateKeyProvisioning( pxProvisioningParams );
+        TLS_ForgetSession( pcAWSIoTAddress );
 
         /* Create socket. */
         xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
@@ -196,6 +252,7 @@ static void prvConnectWithProvisioning( ProvisioningParams_t * pxProvisioningPar
          * device with default RSA certs so that subsequent tests
          * are not changed. */
         vDevModeKeyProvisioning();
+        TLS_ForgetSession( pcAWSIoTAddress );
     }
     else
     {
@@ -219,8 +276,10 @@ static void prvExpectFailAfterDataSentWithProvisioning( ProvisioningParams_t * p
 
     if( TEST_PROTECT() )
     {
-        /* Provision the device with the supplied parameters. */
+        /* Provision the device with the supplied parameters. A session
+         * established with other credentials must not be resumed. */
         vAlternateKeyProvisioning( pxProvisioningParams );
+        TLS_ForgetSession( pcAWSIoTAddress );
 
         /* Create socket. */
         xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
@@ -274,6 +333,7 @@ static void prvExpectFailAfterDataSentWithProvisioning( ProvisioningParams_t * p
      * device with default certs so that subsequent tests
      * are not changed. */
     vDevModeKeyProvisioning();
+    TLS_ForgetSession( pcAWSIoTAddress );
 }
 /*-----------------------------------------------------------*/
 
@@ -374,3 +434,137 @@ TEST( Full_TLS, AFQP_TLS_ConnectBYOCCredentials )
                                 );
 }
 /*-----------------------------------------------------------*/
+
+#if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+
+    TEST( Full_TLS, AFQP_TLS_SessionSerializer )
+    {
+        mbedtls_ssl_session xSession;
+        mbedtls_ssl_session xParsed;
+        uint8_t * pucBuffer = NULL;
+        size_t xLength = 0;
+        uint32_t ulAge = 0;
+
+        mbedtls_ssl_session_init( &xSession );
+        mbedtls_ssl_session_init( &xParsed );
+
+        if( TEST_PROTECT() )
+        {
+            xSession.ciphersuite = 0xC02F;
+            xSession.id_len = sizeof( xSession.id );
+            memset( xSession.id, 0x5A, sizeof( xSession.id ) );
+            memset( xSession.master, 0xA5, sizeof( xSession.master ) );
+            xSession.verify_result = 0x8;
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                xSession.ticket = mbedtls_calloc( 1, 64 );
+                TEST_ASSERT_NOT_NULL( xSession.ticket );
+                memset( xSession.ticket, 0x3C, 64 );
+                xSession.ticket_len = 64;
+                xSession.ticket_lifetime = 3600;
+            #endif
+
+            xLength = test_prvSessionSerializedLength( &xSession );
+            pucBuffer = ( uint8_t * ) pvPortMalloc( xLength );
+            TEST_ASSERT_NOT_NULL( pucBuffer );
+
+            test_prvSessionSerialize( &xSession, 42, pucBuffer );
+            TEST_ASSERT_EQUAL( pdTRUE, test_prvSessionParse( pucBuffer, xLength, &xParsed, &ulAge ) );
+
+            /* The age is restored with the session. */
+            TEST_ASSERT_EQUAL_UINT32( 42, ulAge );
+            TEST_ASSERT_EQUAL_INT( xSession.ciphersuite, xParsed.ciphersuite );
+            TEST_ASSERT_EQUAL( xSession.id_len, xParsed.id_len );
+            TEST_ASSERT_EQUAL_MEMORY( xSession.id, xParsed.id, sizeof( xSession.id ) );
+            TEST_ASSERT_EQUAL_MEMORY( xSession.master, xParsed.master, sizeof( xSession.master ) );
+            TEST_ASSERT_EQUAL_UINT32( xSession.verify_result, xParsed.verify_result );
+
+            #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                TEST_ASSERT_EQUAL( xSession.ticket_len, xParsed.ticket_len );
+                TEST_ASSERT_EQUAL_MEMORY( xSession.ticket, xParsed.ticket, xSession.ticket_len );
+                TEST_ASSERT_EQUAL_UINT32( xSession.ticket_lifetime, xParsed.ticket_lifetime );
+            #endif
+
+            /* A truncated session is rejected. */
+            mbedtls_ssl_session_free( &xParsed );
+            mbedtls_ssl_session_init( &xParsed );
+            TEST_ASSERT_EQUAL( pdFALSE, test_prvSessionParse( pucBuffer, xLength - 1U, &xParsed, &ulAge ) );
+        }
+
+        if( NULL != pucBuffer )
+        {
+            vPortFree( pucBuffer );
+        }
+
+        mbedtls_ssl_session_free( &xParsed );
+        mbedtls_ssl_session_free( &xSession );
+    }
+/*-----------------------------------------------------------*/
+
+    TEST( Full_TLS, AFQP_TLS_ConnectResumeSession )
+    {
+        const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+        mbedtls_ssl_session xFirst;
+        mbedtls_ssl_session xSecond;
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket connect failed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdTRUE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xFirst ), "Session was not cached" );
+
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket reconnect failed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdTRUE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xSecond ), "Session was not cached" );
+
+        /* A resumed session keeps the master secret of the first handshake. */
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE( xFirst.master, xSecond.master, sizeof( xFirst.master ), "Session was not resumed" );
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+        TEST_ASSERT_EQUAL_MESSAGE( pdFALSE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xSecond ), "Session was not forgotten" );
+    }
+/*-----------------------------------------------------------*/
+
+    TEST( Full_TLS, AFQP_TLS_ConnectExpiredSession )
+    {
+        const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+        mbedtls_ssl_session xFirst;
+        mbedtls_ssl_session xSecond;
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket connect failed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdTRUE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xFirst ), "Session was not cached" );
+
+        test_TLS_AgeCachedSession( pcAWSIoTAddress, tlsconfigSESSION_LIFETIME_S );
+
+        /* The expired session is not offered, so a new one is established. */
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket reconnect failed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdTRUE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xSecond ), "Session was not cached" );
+        TEST_ASSERT_NOT_EQUAL_MESSAGE( 0, memcmp( xFirst.master, xSecond.master, sizeof( xFirst.master ) ), "Expired session was resumed" );
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+    }
+/*-----------------------------------------------------------*/
+
+    TEST( Full_TLS, AFQP_TLS_ConnectForgetFailedSession )
+    {
+        const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+        mbedtls_ssl_session xSession;
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket connect failed" );
+
+        /* The handshake resuming a session with the wrong master secret fails. */
+        test_TLS_CorruptCachedSession( pcAWSIoTAddress );
+        TEST_ASSERT_LESS_THAN_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Corrupted session was resumed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdFALSE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xSession ), "Failed session was not forgotten" );
+
+        /* The next connection performs a full handshake. */
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, prvConnectToBroker(), "Socket reconnect failed" );
+        TEST_ASSERT_EQUAL_MESSAGE( pdTRUE, test_TLS_GetCachedSession( pcAWSIoTAddress, &xSession ), "Session was not cached" );
+
+        TLS_ForgetSession( pcAWSIoTAddress );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( tlsconfigSESSION_CACHE_ENTRIES > 0 ) */
@@ -0,0 +1,61 @@
+/*
+ * FreeRTOS TLS V1.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_tls_test_access_declare.h
+ * @brief Declarations of the functions that access private methods in iot_tls.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _IOT_TLS_TEST_ACCESS_DECLARE_H_
+#define _IOT_TLS_TEST_ACCESS_DECLARE_H_
+
+#include "FreeRTOS.h"
+#include "iot_tls.h"
+#include "mbedtls/ssl.h"
+
+#if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+    BaseType_t test_TLS_GetCachedSession( const char * pcServerName,
+                                          mbedtls_ssl_session * pxSession );
+
+    void test_TLS_AgeCachedSession( const char * pcServerName,
+                                    uint32_t ulSeconds );
+
+    void test_TLS_CorruptCachedSession( const char * pcServerName );
+
+    size_t test_prvSessionSerializedLength( const mbedtls_ssl_session * pxSession );
+
+    void test_prvSessionSerialize( const mbedtls_ssl_session * pxSession,
+                                   uint32_t ulAge,
+                                   uint8_t * pucBuffer );
+
+    BaseType_t test_prvSessionParse( const uint8_t * pucBuffer,
+                                     size_t xLength,
+                                     mbedtls_ssl_session * pxSession,
+                                     uint32_t * pulAge );
+#endif
+
+#endif /* ifndef _IOT_TLS_TEST_ACCESS_DECLARE_H_ */
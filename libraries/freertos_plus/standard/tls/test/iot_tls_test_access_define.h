@@ -0,0 +1,134 @@
+/*
+ * FreeRTOS TLS V1.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_tls_test_access_define.h
+ * @brief Function wrappers that access private methods in iot_tls.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _IOT_TLS_TEST_ACCESS_DEFINE_H_
+#define _IOT_TLS_TEST_ACCESS_DEFINE_H_
+
+#include "iot_tls_test_access_declare.h"
+
+/*-----------------------------------------------------------*/
+
+#if ( tlsconfigSESSION_CACHE_ENTRIES > 0 )
+
+/* Copies the cached session of a server without its ticket. */
+    BaseType_t test_TLS_GetCachedSession( const char * pcServerName,
+                                          mbedtls_ssl_session * pxSession )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            pxEntry = prvSessionCacheFind( pcServerName );
+
+            if( NULL != pxEntry )
+            {
+                *pxSession = pxEntry->xSession;
+
+                #if defined( MBEDTLS_SSL_SESSION_TICKETS ) && defined( MBEDTLS_SSL_CLI_C )
+                    pxSession->ticket = NULL;
+                    pxSession->ticket_len = 0;
+                #endif
+            }
+        }
+        tlsSESSION_CACHE_UNLOCK();
+
+        return ( NULL != pxEntry ) ? pdTRUE : pdFALSE;
+    }
+
+/*-----------------------------------------------------------*/
+
+/* Makes the cached session of a server older by the given number of seconds. */
+    void test_TLS_AgeCachedSession( const char * pcServerName,
+                                    uint32_t ulSeconds )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            pxEntry = prvSessionCacheFind( pcServerName );
+
+            if( NULL != pxEntry )
+            {
+                pxEntry->xCreated -= ( TickType_t ) ulSeconds * ( TickType_t ) configTICK_RATE_HZ;
+            }
+        }
+        tlsSESSION_CACHE_UNLOCK();
+    }
+
+/*-----------------------------------------------------------*/
+
+/* Changes the master secret of the cached session of a server, so that the
+ * handshake resuming it fails. */
+    void test_TLS_CorruptCachedSession( const char * pcServerName )
+    {
+        TLSSessionCacheEntry_t * pxEntry = NULL;
+
+        tlsSESSION_CACHE_LOCK();
+        {
+            pxEntry = prvSessionCacheFind( pcServerName );
+
+            if( NULL != pxEntry )
+            {
+                pxEntry->xSession.master[ 0 ] ^= 0xFFU;
+            }
+        }
+        tlsSESSION_CACHE_UNLOCK();
+    }
+
+/*-----------------------------------------------------------*/
+
+    size_t test_prvSessionSerializedLength( const mbedtls_ssl_session * pxSession )
+    {
+        return prvSessionSerializedLength( pxSession );
+    }
+
+/*-----------------------------------------------------------*/
+
+    void test_prvSessionSerialize( const mbedtls_ssl_session * pxSession,
+                                   uint32_t ulAge,
+                                   uint8_t * pucBuffer )
+    {
+        prvSessionSerialize( pxSession, ulAge, pucBuffer );
+    }
+
+/*-----------------------------------------------------------*/
+
+    BaseType_t test_prvSessionParse( const uint8_t * pucBuffer,
+                                     size_t xLength,
+                                     mbedtls_ssl_session * pxSession,
+                                     uint32_t * pulAge )
+    {
+        return prvSessionParse( pucBuffer, xLength, pxSession, pulAge );
+    }
+#endif /* if ( tlsconfigSESSION_CACHE_ENTRIES > 0 ) */
+
+#endif /* ifndef _IOT_TLS_TEST_ACCESS_DEFINE_H_ */
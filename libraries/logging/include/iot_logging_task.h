@@ -57,4 +57,25 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
 void vLoggingPrintf( const char * pcFormat,
                      ... );
 
+#if defined( configLOGGING_BINARY_MODE ) && ( configLOGGING_BINARY_MODE == 1 )
+    #include <stdarg.h>
+
+/**
+ * @brief Interface to log a message of IotLog_Generic() in binary mode.
+ *
+ * Writes the format string, the time and the arguments of the message to the
+ * ring of the logging task without formatting them.  The logging task adds the
+ * "[pcLevel][pcLibraryName][time] " prefix and a line ending when it outputs
+ * the message.  pcLevel and pcLibraryName may be NULL to leave them out.
+ * pcFormat, pcLevel and pcLibraryName are not copied, so must be string
+ * literals or otherwise remain valid; strings passed to %s are copied, up to
+ * their precision if they have one.
+ */
+    void vLoggingPrintfBinary( const char * pcLevel,
+                               const char * pcLibraryName,
+                               BaseType_t xIncludeTimestring,
+                               const char * pcFormat,
+                               va_list xArgs );
+#endif
+
 #endif /* AWS_LOGGING_TASK_H */
@@ -74,6 +74,26 @@
     #define IotLogging_Puts    puts
 #endif
 
+/**
+ * @def IOT_LOGGING_BINARY_MODE
+ * @brief Set to 1 to pass log messages unformatted to the FreeRTOS logging task.
+ *
+ * In binary mode, the logging library writes the format string, the time and
+ * the arguments of each message to the ring of the logging task, which formats
+ * and outputs them in the background. The calling task neither allocates memory
+ * nor formats the message. Requires configLOGGING_BINARY_MODE to be 1 in
+ * FreeRTOSConfig.h.
+ */
+#ifndef IOT_LOGGING_BINARY_MODE
+    #define IOT_LOGGING_BINARY_MODE    0
+#endif
+
+#if IOT_LOGGING_BINARY_MODE == 1
+    /* FreeRTOS logging task include. */
+    #include "FreeRTOS.h"
+    #include "iot_logging_task.h"
+#endif
+
 /*
  * Provide default values for undefined memory allocation functions based on
  * the usage of dynamic memory allocation.
@@ -208,6 +228,22 @@ void IotLog_Generic( int libraryLogSetting,
         return;
     }
 
+    /* In binary mode, hand the message to the logging task as it is. */
+    #if IOT_LOGGING_BINARY_MODE == 1
+        va_start( args, pFormat );
+
+        vLoggingPrintfBinary( ( ( ( pLogConfig == NULL ) || ( pLogConfig->hideLogLevel == false ) ) &&
+                                ( messageLevel <= IOT_LOG_DEBUG ) ) ? _pLogLevelStrings[ messageLevel ] : NULL,
+                              ( ( pLogConfig == NULL ) || ( pLogConfig->hideLibraryName == false ) ) ? pLibraryName : NULL,
+                              ( ( pLogConfig == NULL ) || ( pLogConfig->hideTimestring == false ) ) ? pdTRUE : pdFALSE,
+                              pFormat,
+                              args );
+
+        va_end( args );
+
+        return;
+    #endif
+
     if( ( pLogConfig == NULL ) || ( pLogConfig->hideLogLevel == false ) )
     {
         /* Add length of log level if requested. */
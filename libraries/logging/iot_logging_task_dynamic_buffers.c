@@ -34,6 +34,8 @@
 /* Standard includes. */
 #include <stdio.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 /* Sanity check all the definitions required by this file are set. */
@@ -49,6 +51,42 @@
     #error configLOGGING_INCLUDE_TIME_AND_TASK_NAME must be defined in FreeRTOSConfig.h to use this logging file.  Set configLOGGING_INCLUDE_TIME_AND_TASK_NAME to 1 to prepend a time stamp, message number and the name of the calling task to each logged message.  Otherwise set to 0.
 #endif
 
+/* Binary mode is off by default. Set configLOGGING_BINARY_MODE to 1 to have
+ * vLoggingPrintf() write the format string, a timestamp and the raw arguments
+ * of each message to a preallocated lock-free ring, and have the logging task
+ * format and output the messages in batches. */
+#ifndef configLOGGING_BINARY_MODE
+    #define configLOGGING_BINARY_MODE    0
+#endif
+
+#if ( configLOGGING_BINARY_MODE == 1 )
+
+/* The number of records in the ring. Messages logged while the ring is full
+ * are dropped and counted. Must be a power of 2. */
+    #ifndef configLOGGING_BINARY_RECORDS
+        #define configLOGGING_BINARY_RECORDS    32
+    #endif
+
+/* The number of bytes in a record for the arguments of a message, including
+ * copies of the strings passed to %s.  Messages with larger arguments are
+ * formatted by the calling task instead. */
+    #ifndef configLOGGING_BINARY_PAYLOAD_SIZE
+        #define configLOGGING_BINARY_PAYLOAD_SIZE    64
+    #endif
+
+/* The size of the buffer in which the logging task collects formatted
+ * messages before passing them to configPRINT_STRING() in one go. */
+    #ifndef configLOGGING_BINARY_BATCH_SIZE
+        #define configLOGGING_BINARY_BATCH_SIZE    ( 2 * configLOGGING_MAX_MESSAGE_LENGTH )
+    #endif
+
+    #if ( ( configLOGGING_BINARY_RECORDS & ( configLOGGING_BINARY_RECORDS - 1 ) ) != 0 )
+        #error configLOGGING_BINARY_RECORDS must be a power of 2.
+    #endif
+
+    #include "atomic.h"
+#endif /* if ( configLOGGING_BINARY_MODE == 1 ) */
+
 /* A block time of 0 just means don't block. */
 #define loggingDONT_BLOCK    0
 
@@ -70,6 +108,8 @@ static void prvLoggingTask( void * pvParameters );
 
 /*-----------------------------------------------------------*/
 
+#if ( configLOGGING_BINARY_MODE == 0 )
+
 /*
  * The queue used to pass pointers to log messages from the task that created
  * the message to the task that will performs the output.
@@ -251,3 +291,1130 @@ void vLoggingPrint( const char * pcMessage )
         }
     }
 }
+/*-----------------------------------------------------------*/
+
+#else /* if ( configLOGGING_BINARY_MODE == 0 ) */
+
+/* Flags of a record, which select the prefixes and suffix that the logging task
+ * adds around the formatted message. */
+#define loggingFLAG_TASK_NAME     ( ( uint8_t ) 0x01 ) /* Message number, time and task name of vLoggingPrintf(). */
+#define loggingFLAG_TIMESTRING    ( ( uint8_t ) 0x02 ) /* Time in milliseconds of IotLog_Generic(). */
+#define loggingFLAG_NEWLINE       ( ( uint8_t ) 0x04 ) /* Line ending of IotLog_Generic(). */
+
+/* The longest conversion specification the logging task rebuilds, including
+ * the values of '*' field widths and precisions. */
+#define loggingMAX_SPEC_LENGTH    32
+
+/* Reads the next argument of prvFormatArguments() from the payload into xValue,
+ * and formats it with the rebuilt conversion specification. */
+#define loggingFORMAT_ARGUMENT( xValue )                                                       \
+    if( ( size_t ) ( pucEnd - pucArgument ) >= sizeof( xValue ) )                              \
+    {                                                                                          \
+        ( void ) memcpy( &( xValue ), pucArgument, sizeof( xValue ) );                         \
+        pucArgument += sizeof( xValue );                                                       \
+        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, cSpec, ( xValue ) );    \
+    }
+
+/* How the argument of a printf() conversion is read from the variable argument
+ * list and stored in a record. */
+typedef enum
+{
+    eLoggingArgNone,       /* %%, or an unknown conversion, which is output as is. */
+    eLoggingArgInt,        /* int, and the char and short types promoted to int. */
+    eLoggingArgLong,       /* long. */
+    eLoggingArgLongLong,   /* long long. */
+    eLoggingArgSize,       /* size_t. */
+    eLoggingArgPtrdiff,    /* ptrdiff_t. */
+    eLoggingArgIntmax,     /* intmax_t. */
+    eLoggingArgDouble,     /* double, and the float type promoted to double. */
+    eLoggingArgLongDouble, /* long double. */
+    eLoggingArgPointer,    /* %p. */
+    eLoggingArgString,     /* %s, copied into the record. */
+    eLoggingArgCount       /* %n, read but never written. */
+} LoggingArgClass_t;
+
+/* A conversion specification of a format string. */
+typedef struct LoggingConversion
+{
+    size_t xLength;            /* Characters in the specification, including the '%'. */
+    UBaseType_t uxStars;       /* Number of int arguments for '*' widths and precisions. */
+    BaseType_t xStarPrecision; /* pdTRUE if the last '*' argument is the precision. */
+    int iPrecision;            /* The precision written in the specification, or -1. */
+    LoggingArgClass_t eClass;  /* The argument of the conversion. */
+} LoggingConversion_t;
+
+/* A log message in the ring.  The header and arguments are written by the
+ * task that logs the message, and formatted later by the logging task. */
+typedef struct LoggingRecord
+{
+    volatile uint32_t ulSequence;                         /* Ring position the record is free or published for, see prvClaimRecord(). */
+    const char * pcFormat;                                /* Format string of the message. */
+    char * pcText;                                        /* A message formatted by the calling task, freed after output. */
+    const char * pcLevel;                                 /* Log level string of IotLog_Generic(), or NULL. */
+    const char * pcLibraryName;                           /* Library name of IotLog_Generic(), or NULL. */
+    uint32_t ulMessageNumber;                             /* Message number printed with loggingFLAG_TASK_NAME. */
+    TickType_t xTickCount;                                /* Time at which the message was logged. */
+    uint8_t ucFlags;                                      /* loggingFLAG_ flags of the message. */
+    size_t xPayloadLength;                                /* Bytes used in ucPayload. */
+    char cTaskName[ configMAX_TASK_NAME_LEN ];            /* Name of the task that logged the message. */
+    uint8_t ucPayload[ configLOGGING_BINARY_PAYLOAD_SIZE ]; /* The arguments of the message. */
+} LoggingRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Parses the conversion specification that starts at the '%' pcSpec points to.
+ */
+static void prvParseConversion( const char * pcSpec,
+                                LoggingConversion_t * pxConversion );
+
+/*
+ * Returns the length of pcString, reading at most xMaxLength characters.  The
+ * C library of every toolchain does not have strnlen().
+ */
+static size_t prvStringLength( const char * pcString,
+                               size_t xMaxLength );
+
+/*
+ * Reads the arguments of pcFormat and copies them to the payload of pxRecord.
+ * Returns pdFAIL if they don't fit.
+ */
+static BaseType_t prvCaptureArguments( LoggingRecord_t * pxRecord,
+                                       const char * pcFormat,
+                                       va_list xArgs );
+
+/*
+ * Formats the prefix selected by the flags of pxRecord into pcBuffer, and
+ * returns its length.
+ */
+static size_t prvFormatPrefix( const LoggingRecord_t * pxRecord,
+                               char * pcBuffer,
+                               size_t xBufferSize );
+
+/*
+ * Formats the message of pxRecord from its format string and payload into
+ * pcBuffer, and returns its length.
+ */
+static size_t prvFormatArguments( const LoggingRecord_t * pxRecord,
+                                  char * pcBuffer,
+                                  size_t xBufferSize );
+
+/*
+ * Formats and outputs the published records in order, then reports the
+ * messages dropped since the last call.
+ */
+static void prvOutputRecords( void );
+
+/*
+ * Claims the next free record of the ring, or returns NULL if the ring is full.
+ */
+static LoggingRecord_t * prvClaimRecord( void );
+
+/*
+ * Makes a claimed record visible to the logging task, and wakes the logging
+ * task if it is waiting for messages.
+ */
+static void prvPublishRecord( LoggingRecord_t * pxRecord );
+
+/*
+ * Writes a message to the ring.  Called by vLoggingPrintf() and
+ * vLoggingPrintfBinary().
+ */
+static void prvWriteRecord( const char * pcLevel,
+                            const char * pcLibraryName,
+                            uint8_t ucFlags,
+                            const char * pcFormat,
+                            va_list xArgs );
+
+/*
+ * Appends a formatted message to the batch buffer of the logging task, first
+ * outputting the batch if the message does not fit.
+ */
+static void prvBatchAppend( const char * pcString );
+
+/*
+ * Outputs the messages collected in the batch buffer.
+ */
+static void prvBatchFlush( void );
+
+/*-----------------------------------------------------------*/
+
+/* The ring of log messages.  Any task writes to it; only the logging task
+ * reads from it. */
+static LoggingRecord_t xRecords[ configLOGGING_BINARY_RECORDS ];
+
+/* The next ring position to be claimed by a task logging a message. */
+static volatile uint32_t ulEnqueuePosition = 0;
+
+/* The next ring position to be output by the logging task. */
+static uint32_t ulDequeuePosition = 0;
+
+/* Number of messages logged so far, used for the message numbers. */
+static volatile uint32_t ulMessageNumber = 0;
+
+/* Number of messages dropped because the ring was full. */
+static volatile uint32_t ulDroppedMessages = 0;
+
+/* Number of dropped messages the logging task has reported. */
+static uint32_t ulReportedDrops = 0;
+
+/* 1 while the logging task waits for a notification that a record was published. */
+static volatile uint32_t ulLoggingTaskWaiting = 0;
+
+/* The logging task, created by xLoggingTaskInitialize(). */
+static TaskHandle_t xLoggingTask = NULL;
+
+/* The buffer into which the logging task formats each message. */
+static char cLoggingLine[ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+/* The buffer in which the logging task collects messages for output. */
+static char cLoggingBatch[ configLOGGING_BINARY_BATCH_SIZE ];
+
+/* Characters in cLoggingBatch. */
+static size_t xLoggingBatchLength = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
+                                   UBaseType_t uxPriority,
+                                   UBaseType_t uxQueueLength )
+{
+    BaseType_t xReturn = pdFAIL;
+    uint32_t ulRecord;
+
+    /* The ring has configLOGGING_BINARY_RECORDS records instead of a queue. */
+    ( void ) uxQueueLength;
+
+    /* Ensure the logging task has not been created already. */
+    if( xLoggingTask == NULL )
+    {
+        /* A record is free for the position it is initialized to. */
+        for( ulRecord = 0; ulRecord < configLOGGING_BINARY_RECORDS; ulRecord++ )
+        {
+            xRecords[ ulRecord ].ulSequence = ulRecord;
+        }
+
+        if( xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, &xLoggingTask ) == pdPASS )
+        {
+            xReturn = pdPASS;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoggingTask( void * pvParameters )
+{
+    /* Disable unused parameter warning. */
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        prvOutputRecords();
+
+        /* Block until a task publishes the next record.  The flag is set before
+         * checking the ring again, so a record published in between is either
+         * seen now or followed by a notification. */
+        ( void ) Atomic_CompareAndSwap_u32( &ulLoggingTaskWaiting, 1, 0 );
+
+        if( xRecords[ ulDequeuePosition & ( configLOGGING_BINARY_RECORDS - 1 ) ].ulSequence != ( ulDequeuePosition + 1 ) )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        }
+
+        ( void ) Atomic_CompareAndSwap_u32( &ulLoggingTaskWaiting, 0, 1 );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvOutputRecords( void )
+{
+    LoggingRecord_t * pxRecord = NULL;
+    uint32_t ulDrops = 0;
+    size_t xLength = 0;
+
+    /* Format and output all the published records in order. */
+    for( ; ; )
+    {
+        pxRecord = &xRecords[ ulDequeuePosition & ( configLOGGING_BINARY_RECORDS - 1 ) ];
+
+        if( pxRecord->ulSequence != ( ulDequeuePosition + 1 ) )
+        {
+            break;
+        }
+
+        if( pxRecord->pcText != NULL )
+        {
+            prvBatchAppend( pxRecord->pcText );
+            vPortFree( ( void * ) pxRecord->pcText );
+            pxRecord->pcText = NULL;
+        }
+        else if( pxRecord->pcFormat != NULL )
+        {
+            xLength = prvFormatPrefix( pxRecord, cLoggingLine, sizeof( cLoggingLine ) );
+            xLength += prvFormatArguments( pxRecord, cLoggingLine + xLength, sizeof( cLoggingLine ) - xLength );
+
+            if( ( pxRecord->ucFlags & loggingFLAG_NEWLINE ) != 0 )
+            {
+                ( void ) snprintf( cLoggingLine + xLength, sizeof( cLoggingLine ) - xLength, "\r\n" );
+            }
+
+            prvBatchAppend( cLoggingLine );
+        }
+        else
+        {
+            /* The calling task ran out of memory formatting the message. */
+        }
+
+        /* Hand the record back to the tasks logging messages once it has been
+         * read, one lap of the ring later. */
+        ( void ) Atomic_CompareAndSwap_u32( &pxRecord->ulSequence,
+                                            ulDequeuePosition + configLOGGING_BINARY_RECORDS,
+                                            ulDequeuePosition + 1 );
+        ulDequeuePosition++;
+    }
+
+    ulDrops = ulDroppedMessages;
+
+    if( ulDrops != ulReportedDrops )
+    {
+        ( void ) snprintf( cLoggingLine, sizeof( cLoggingLine ), "[Logging] %lu messages dropped\r\n",
+                           ( unsigned long ) ( ulDrops - ulReportedDrops ) );
+        prvBatchAppend( cLoggingLine );
+        ulReportedDrops = ulDrops;
+    }
+
+    prvBatchFlush();
+}
+/*-----------------------------------------------------------*/
+
+static void prvParseConversion( const char * pcSpec,
+                                LoggingConversion_t * pxConversion )
+{
+    const char * pc = pcSpec + 1;
+    char cLength = '\0';
+    BaseType_t xLongLong = pdFALSE;
+
+    pxConversion->uxStars = 0;
+    pxConversion->xStarPrecision = pdFALSE;
+    pxConversion->iPrecision = -1;
+
+    /* Flags. */
+    while( ( *pc == '-' ) || ( *pc == '+' ) || ( *pc == ' ' ) || ( *pc == '#' ) || ( *pc == '0' ) || ( *pc == '\'' ) )
+    {
+        pc++;
+    }
+
+    /* Field width, then precision. */
+    if( *pc == '*' )
+    {
+        pxConversion->uxStars++;
+        pc++;
+    }
+    else
+    {
+        while( ( *pc >= '0' ) && ( *pc <= '9' ) )
+        {
+            pc++;
+        }
+    }
+
+    if( *pc == '.' )
+    {
+        pc++;
+
+        if( *pc == '*' )
+        {
+            pxConversion->uxStars++;
+            pxConversion->xStarPrecision = pdTRUE;
+            pc++;
+        }
+        else
+        {
+            /* A '.' alone is a precision of 0. */
+            pxConversion->iPrecision = 0;
+
+            while( ( *pc >= '0' ) && ( *pc <= '9' ) )
+            {
+                pxConversion->iPrecision = ( pxConversion->iPrecision * 10 ) + ( *pc - '0' );
+                pc++;
+            }
+        }
+    }
+
+    /* Length modifier. */
+    if( ( *pc == 'h' ) || ( *pc == 'l' ) || ( *pc == 'j' ) || ( *pc == 'z' ) || ( *pc == 't' ) || ( *pc == 'L' ) )
+    {
+        cLength = *pc;
+        pc++;
+
+        if( ( ( cLength == 'h' ) || ( cLength == 'l' ) ) && ( *pc == cLength ) )
+        {
+            xLongLong = ( cLength == 'l' ) ? pdTRUE : pdFALSE;
+            pc++;
+        }
+    }
+
+    /* Conversion. */
+    switch( *pc )
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+
+            if( xLongLong == pdTRUE )
+            {
+                pxConversion->eClass = eLoggingArgLongLong;
+            }
+            else if( ( cLength == 'l' ) && ( *pc != 'c' ) )
+            {
+                pxConversion->eClass = eLoggingArgLong;
+            }
+            else if( cLength == 'j' )
+            {
+                pxConversion->eClass = eLoggingArgIntmax;
+            }
+            else if( cLength == 'z' )
+            {
+                pxConversion->eClass = eLoggingArgSize;
+            }
+            else if( cLength == 't' )
+            {
+                pxConversion->eClass = eLoggingArgPtrdiff;
+            }
+            else
+            {
+                pxConversion->eClass = eLoggingArgInt;
+            }
+
+            break;
+
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            pxConversion->eClass = ( cLength == 'L' ) ? eLoggingArgLongDouble : eLoggingArgDouble;
+            break;
+
+        case 's':
+            pxConversion->eClass = eLoggingArgString;
+            break;
+
+        case 'p':
+            pxConversion->eClass = eLoggingArgPointer;
+            break;
+
+        case 'n':
+            pxConversion->eClass = eLoggingArgCount;
+            break;
+
+        default:
+            pxConversion->eClass = eLoggingArgNone;
+            break;
+    }
+
+    /* Include the conversion character, unless the format string ended early. */
+    if( *pc != '\0' )
+    {
+        pc++;
+    }
+
+    pxConversion->xLength = ( size_t ) ( pc - pcSpec );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvStringLength( const char * pcString,
+                               size_t xMaxLength )
+{
+    size_t xLength = 0;
+
+    while( ( xLength < xMaxLength ) && ( pcString[ xLength ] != '\0' ) )
+    {
+        xLength++;
+    }
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCaptureArguments( LoggingRecord_t * pxRecord,
+                                       const char * pcFormat,
+                                       va_list xArgs )
+{
+    const char * pc = pcFormat;
+    const char * pcString = NULL;
+    const void * pvValue = NULL;
+    size_t xValueLength = 0;
+    UBaseType_t uxStar = 0;
+    LoggingConversion_t xConversion;
+    BaseType_t xReturn = pdPASS;
+    int iPrecision = -1;
+
+    /* Values of the argument classes, read from the variable argument list. */
+    int iValue;
+    long lValue;
+    long long llValue;
+    size_t xValue;
+    ptrdiff_t xDifference;
+    intmax_t xMaximum;
+    double dValue;
+    long double ldValue;
+    void * pvPointer;
+
+    pxRecord->xPayloadLength = 0;
+
+    while( ( *pc != '\0' ) && ( xReturn == pdPASS ) )
+    {
+        if( *pc != '%' )
+        {
+            pc++;
+        }
+        else
+        {
+            prvParseConversion( pc, &xConversion );
+            pc += xConversion.xLength;
+            iPrecision = xConversion.iPrecision;
+
+            /* Read the '*' width and precision, then the argument itself. The
+             * loop runs once more than there are stars. */
+            for( uxStar = 0; ( uxStar <= xConversion.uxStars ) && ( xReturn == pdPASS ); uxStar++ )
+            {
+                pvValue = NULL;
+
+                if( uxStar < xConversion.uxStars )
+                {
+                    iValue = va_arg( xArgs, int );
+                    pvValue = &iValue;
+                    xValueLength = sizeof( iValue );
+
+                    /* A negative precision is taken as if it were omitted. */
+                    if( ( xConversion.xStarPrecision == pdTRUE ) && ( ( uxStar + 1 ) == xConversion.uxStars ) )
+                    {
+                        iPrecision = ( iValue < 0 ) ? -1 : iValue;
+                    }
+                }
+                else
+                {
+                    switch( xConversion.eClass )
+                    {
+                        case eLoggingArgInt:
+                            iValue = va_arg( xArgs, int );
+                            pvValue = &iValue;
+                            xValueLength = sizeof( iValue );
+                            break;
+
+                        case eLoggingArgLong:
+                            lValue = va_arg( xArgs, long );
+                            pvValue = &lValue;
+                            xValueLength = sizeof( lValue );
+                            break;
+
+                        case eLoggingArgLongLong:
+                            llValue = va_arg( xArgs, long long );
+                            pvValue = &llValue;
+                            xValueLength = sizeof( llValue );
+                            break;
+
+                        case eLoggingArgSize:
+                            xValue = va_arg( xArgs, size_t );
+                            pvValue = &xValue;
+                            xValueLength = sizeof( xValue );
+                            break;
+
+                        case eLoggingArgPtrdiff:
+                            xDifference = va_arg( xArgs, ptrdiff_t );
+                            pvValue = &xDifference;
+                            xValueLength = sizeof( xDifference );
+                            break;
+
+                        case eLoggingArgIntmax:
+                            xMaximum = va_arg( xArgs, intmax_t );
+                            pvValue = &xMaximum;
+                            xValueLength = sizeof( xMaximum );
+                            break;
+
+                        case eLoggingArgDouble:
+                            dValue = va_arg( xArgs, double );
+                            pvValue = &dValue;
+                            xValueLength = sizeof( dValue );
+                            break;
+
+                        case eLoggingArgLongDouble:
+                            ldValue = va_arg( xArgs, long double );
+                            pvValue = &ldValue;
+                            xValueLength = sizeof( ldValue );
+                            break;
+
+                        case eLoggingArgPointer:
+                            pvPointer = va_arg( xArgs, void * );
+                            pvValue = &pvPointer;
+                            xValueLength = sizeof( pvPointer );
+                            break;
+
+                        case eLoggingArgString:
+
+                            /* The string may not outlive the call, so copy it, preceded by
+                             * its length and followed by a NULL.  Only the characters up to
+                             * the precision are read: %.*s is often given a buffer that is
+                             * not NULL terminated. */
+                            pcString = va_arg( xArgs, const char * );
+
+                            if( pcString == NULL )
+                            {
+                                pcString = "(null)";
+                            }
+
+                            xValueLength = sizeof( pxRecord->ucPayload ) - pxRecord->xPayloadLength;
+
+                            if( xValueLength < ( sizeof( xValue ) + 1 ) )
+                            {
+                                xReturn = pdFAIL;
+                            }
+                            else
+                            {
+                                /* Read one character more than fits, to find strings that don't. */
+                                xValueLength -= sizeof( xValue );
+
+                                if( ( iPrecision >= 0 ) && ( ( size_t ) iPrecision < xValueLength ) )
+                                {
+                                    xValueLength = ( size_t ) iPrecision;
+                                }
+
+                                xValue = prvStringLength( pcString, xValueLength );
+
+                                if( ( sizeof( xValue ) + xValue + 1 ) > ( sizeof( pxRecord->ucPayload ) - pxRecord->xPayloadLength ) )
+                                {
+                                    xReturn = pdFAIL;
+                                }
+                                else
+                                {
+                                    ( void ) memcpy( &pxRecord->ucPayload[ pxRecord->xPayloadLength ], &xValue, sizeof( xValue ) );
+                                    pxRecord->xPayloadLength += sizeof( xValue );
+                                    ( void ) memcpy( &pxRecord->ucPayload[ pxRecord->xPayloadLength ], pcString, xValue );
+                                    pxRecord->xPayloadLength += xValue;
+                                    pxRecord->ucPayload[ pxRecord->xPayloadLength ] = 0;
+                                    pxRecord->xPayloadLength++;
+                                }
+                            }
+
+                            break;
+
+                        case eLoggingArgCount:
+                            ( void ) va_arg( xArgs, void * );
+                            break;
+
+                        default:
+                            /* Nothing to read. */
+                            break;
+                    }
+                }
+
+                if( pvValue != NULL )
+                {
+                    if( xValueLength > ( sizeof( pxRecord->ucPayload ) - pxRecord->xPayloadLength ) )
+                    {
+                        xReturn = pdFAIL;
+                    }
+                    else
+                    {
+                        ( void ) memcpy( &pxRecord->ucPayload[ pxRecord->xPayloadLength ], pvValue, xValueLength );
+                        pxRecord->xPayloadLength += xValueLength;
+                    }
+                }
+            }
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFormatPrefix( const LoggingRecord_t * pxRecord,
+                               char * pcBuffer,
+                               size_t xBufferSize )
+{
+    size_t xLength = 0;
+    int iLength = 0;
+
+    pcBuffer[ 0 ] = '\0';
+
+    if( ( pxRecord->ucFlags & loggingFLAG_TASK_NAME ) != 0 )
+    {
+        iLength = snprintf( pcBuffer, xBufferSize, "%lu %lu [%s] ",
+                            ( unsigned long ) pxRecord->ulMessageNumber,
+                            ( unsigned long ) pxRecord->xTickCount,
+                            pxRecord->cTaskName );
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    /* The prefix IotLog_Generic() adds, followed by a space if not empty. */
+    if( ( xLength < xBufferSize ) && ( pxRecord->pcLevel != NULL ) )
+    {
+        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, "[%s]", pxRecord->pcLevel );
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    if( ( xLength < xBufferSize ) && ( pxRecord->pcLibraryName != NULL ) )
+    {
+        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, "[%s]", pxRecord->pcLibraryName );
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    if( ( xLength < xBufferSize ) && ( ( pxRecord->ucFlags & loggingFLAG_TIMESTRING ) != 0 ) )
+    {
+        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, "[%llu]",
+                            ( unsigned long long ) pxRecord->xTickCount * portTICK_PERIOD_MS );
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    if( ( xLength < xBufferSize ) &&
+        ( ( pxRecord->pcLevel != NULL ) || ( pxRecord->pcLibraryName != NULL ) || ( ( pxRecord->ucFlags & loggingFLAG_TIMESTRING ) != 0 ) ) )
+    {
+        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, " " );
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    /* Leave room for the terminating NULL if the prefix was truncated. */
+    if( xLength >= xBufferSize )
+    {
+        xLength = xBufferSize - 1;
+    }
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFormatArguments( const LoggingRecord_t * pxRecord,
+                                  char * pcBuffer,
+                                  size_t xBufferSize )
+{
+    const char * pc = pxRecord->pcFormat;
+    const uint8_t * pucArgument = pxRecord->ucPayload;
+    const uint8_t * pucEnd = pxRecord->ucPayload + pxRecord->xPayloadLength;
+    char cSpec[ loggingMAX_SPEC_LENGTH ];
+    size_t xLength = 0, xSpecLength = 0, xIndex = 0;
+    LoggingConversion_t xConversion;
+    int iLength = 0, iStar = 0;
+
+    /* Values of the argument classes, read from the payload. */
+    int iValue;
+    long lValue;
+    long long llValue;
+    size_t xValue;
+    ptrdiff_t xDifference;
+    intmax_t xMaximum;
+    double dValue;
+    long double ldValue;
+    void * pvPointer;
+
+    while( ( *pc != '\0' ) && ( ( xLength + 1 ) < xBufferSize ) )
+    {
+        if( *pc != '%' )
+        {
+            pcBuffer[ xLength ] = *pc;
+            xLength++;
+            pc++;
+        }
+        else
+        {
+            prvParseConversion( pc, &xConversion );
+
+            /* Rebuild the specification with the values of its '*' widths and
+             * precisions, which are stored ahead of the argument. A negative
+             * precision is taken as if the precision were omitted. */
+            xSpecLength = 0;
+
+            for( xIndex = 0; ( xIndex < xConversion.xLength ) && ( ( xSpecLength + 1 ) < sizeof( cSpec ) ); xIndex++ )
+            {
+                if( pc[ xIndex ] != '*' )
+                {
+                    cSpec[ xSpecLength ] = pc[ xIndex ];
+                    xSpecLength++;
+                }
+                else if( ( size_t ) ( pucEnd - pucArgument ) >= sizeof( iStar ) )
+                {
+                    ( void ) memcpy( &iStar, pucArgument, sizeof( iStar ) );
+                    pucArgument += sizeof( iStar );
+
+                    if( ( iStar < 0 ) && ( xIndex > 0 ) && ( pc[ xIndex - 1 ] == '.' ) )
+                    {
+                        xSpecLength--;
+                    }
+                    else
+                    {
+                        iLength = snprintf( &cSpec[ xSpecLength ], sizeof( cSpec ) - xSpecLength, "%d", iStar );
+
+                        if( iLength > 0 )
+                        {
+                            xSpecLength += ( size_t ) iLength;
+                        }
+                    }
+                }
+                else
+                {
+                    /* The payload ended early. */
+                }
+            }
+
+            cSpec[ ( xSpecLength < sizeof( cSpec ) ) ? xSpecLength : ( sizeof( cSpec ) - 1 ) ] = '\0';
+            pc += xConversion.xLength;
+            iLength = 0;
+
+            switch( xConversion.eClass )
+            {
+                case eLoggingArgInt:
+                    loggingFORMAT_ARGUMENT( iValue );
+                    break;
+
+                case eLoggingArgLong:
+                    loggingFORMAT_ARGUMENT( lValue );
+                    break;
+
+                case eLoggingArgLongLong:
+                    loggingFORMAT_ARGUMENT( llValue );
+                    break;
+
+                case eLoggingArgSize:
+                    loggingFORMAT_ARGUMENT( xValue );
+                    break;
+
+                case eLoggingArgPtrdiff:
+                    loggingFORMAT_ARGUMENT( xDifference );
+                    break;
+
+                case eLoggingArgIntmax:
+                    loggingFORMAT_ARGUMENT( xMaximum );
+                    break;
+
+                case eLoggingArgDouble:
+                    loggingFORMAT_ARGUMENT( dValue );
+                    break;
+
+                case eLoggingArgLongDouble:
+                    loggingFORMAT_ARGUMENT( ldValue );
+                    break;
+
+                case eLoggingArgPointer:
+                    loggingFORMAT_ARGUMENT( pvPointer );
+                    break;
+
+                case eLoggingArgString:
+
+                    /* The copy of the string follows its length, and is NULL terminated
+                     * so that the precision and width of cSpec apply as they would have. */
+                    if( ( size_t ) ( pucEnd - pucArgument ) >= sizeof( xValue ) )
+                    {
+                        ( void ) memcpy( &xValue, pucArgument, sizeof( xValue ) );
+                        pucArgument += sizeof( xValue );
+
+                        if( ( size_t ) ( pucEnd - pucArgument ) > xValue )
+                        {
+                            iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, cSpec, ( const char * ) pucArgument );
+                            pucArgument += xValue + 1;
+                        }
+                    }
+
+                    break;
+
+                case eLoggingArgCount:
+                    /* %n is not written to. */
+                    break;
+
+                default:
+
+                    /* Output %% as '%', and unknown conversions as they are. */
+                    if( ( xConversion.xLength == 2 ) && ( cSpec[ 1 ] == '%' ) )
+                    {
+                        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, "%%" );
+                    }
+                    else
+                    {
+                        iLength = snprintf( pcBuffer + xLength, xBufferSize - xLength, "%s", cSpec );
+                    }
+
+                    break;
+            }
+
+            if( iLength > 0 )
+            {
+                xLength += ( size_t ) iLength;
+
+                if( xLength >= xBufferSize )
+                {
+                    xLength = xBufferSize - 1;
+                }
+            }
+        }
+    }
+
+    pcBuffer[ xLength ] = '\0';
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static LoggingRecord_t * prvClaimRecord( void )
+{
+    LoggingRecord_t * pxRecord = NULL;
+    uint32_t ulPosition = ulEnqueuePosition;
+    int32_t lLag = 0;
+
+    /* A record is free when its sequence matches the position, and still holds
+     * a message when it lags behind. */
+    for( ; ; )
+    {
+        pxRecord = &xRecords[ ulPosition & ( configLOGGING_BINARY_RECORDS - 1 ) ];
+        lLag = ( int32_t ) ( pxRecord->ulSequence - ulPosition );
+
+        if( lLag == 0 )
+        {
+            if( Atomic_CompareAndSwap_u32( &ulEnqueuePosition, ulPosition + 1, ulPosition ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+            {
+                break;
+            }
+        }
+        else if( lLag < 0 )
+        {
+            /* The ring is full. */
+            pxRecord = NULL;
+            break;
+        }
+        else
+        {
+            /* Another task claimed the record. */
+        }
+
+        ulPosition = ulEnqueuePosition;
+    }
+
+    return pxRecord;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPublishRecord( LoggingRecord_t * pxRecord )
+{
+    uint32_t ulPosition = pxRecord->ulSequence;
+
+    ( void ) Atomic_CompareAndSwap_u32( &pxRecord->ulSequence, ulPosition + 1, ulPosition );
+
+    if( Atomic_CompareAndSwap_u32( &ulLoggingTaskWaiting, 0, 1 ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+    {
+        ( void ) xTaskNotifyGive( xLoggingTask );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteRecord( const char * pcLevel,
+                            const char * pcLibraryName,
+                            uint8_t ucFlags,
+                            const char * pcFormat,
+                            va_list xArgs )
+{
+    LoggingRecord_t * pxRecord = NULL;
+    size_t xLength = 0;
+    int32_t xLength2 = 0;
+    va_list xArgsCopy;
+
+    /* The logging task is created by xLoggingTaskInitialize().  Check
+     * xLoggingTaskInitialize() has been called. */
+    configASSERT( xLoggingTask );
+
+    pxRecord = prvClaimRecord();
+
+    if( pxRecord == NULL )
+    {
+        ( void ) Atomic_Increment_u32( &ulDroppedMessages );
+    }
+    else
+    {
+        pxRecord->pcFormat = pcFormat;
+        pxRecord->pcText = NULL;
+        pxRecord->pcLevel = pcLevel;
+        pxRecord->pcLibraryName = pcLibraryName;
+        pxRecord->xTickCount = xTaskGetTickCount();
+        pxRecord->ucFlags = ucFlags;
+
+        #if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+            {
+                if( strcmp( pcFormat, "\n" ) != 0 )
+                {
+                    pxRecord->ucFlags |= loggingFLAG_TASK_NAME;
+                    pxRecord->ulMessageNumber = Atomic_Increment_u32( &ulMessageNumber );
+
+                    /* Copy the task name, the task may be deleted before the
+                     * message is output. */
+                    if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+                    {
+                        ( void ) strncpy( pxRecord->cTaskName, pcTaskGetName( NULL ), sizeof( pxRecord->cTaskName ) - 1 );
+                        pxRecord->cTaskName[ sizeof( pxRecord->cTaskName ) - 1 ] = '\0';
+                    }
+                    else
+                    {
+                        ( void ) strncpy( pxRecord->cTaskName, "None", sizeof( pxRecord->cTaskName ) );
+                    }
+                }
+            }
+        #endif /* if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 ) */
+
+        va_copy( xArgsCopy, xArgs );
+
+        if( prvCaptureArguments( pxRecord, pcFormat, xArgsCopy ) == pdFAIL )
+        {
+            /* The arguments don't fit in the record, format the message now as
+             * it was done without binary mode. */
+            pxRecord->pcFormat = NULL;
+            pxRecord->pcText = pvPortMalloc( configLOGGING_MAX_MESSAGE_LENGTH );
+
+            if( pxRecord->pcText != NULL )
+            {
+                xLength = prvFormatPrefix( pxRecord, pxRecord->pcText, configLOGGING_MAX_MESSAGE_LENGTH );
+                xLength2 = vsnprintf( pxRecord->pcText + xLength, configLOGGING_MAX_MESSAGE_LENGTH - xLength, pcFormat, xArgs );
+
+                if( xLength2 < 0 )
+                {
+                    xLength2 = 0;
+                    pxRecord->pcText[ xLength ] = '\0';
+                }
+
+                xLength += ( size_t ) xLength2;
+
+                if( ( ( ucFlags & loggingFLAG_NEWLINE ) != 0 ) && ( xLength < configLOGGING_MAX_MESSAGE_LENGTH ) )
+                {
+                    ( void ) snprintf( pxRecord->pcText + xLength, configLOGGING_MAX_MESSAGE_LENGTH - xLength, "\r\n" );
+                }
+            }
+        }
+
+        va_end( xArgsCopy );
+
+        prvPublishRecord( pxRecord );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvBatchAppend( const char * pcString )
+{
+    size_t xLength = strlen( pcString );
+
+    if( ( xLoggingBatchLength + xLength ) >= sizeof( cLoggingBatch ) )
+    {
+        prvBatchFlush();
+    }
+
+    if( xLength >= sizeof( cLoggingBatch ) )
+    {
+        configPRINT_STRING( pcString );
+    }
+    else
+    {
+        ( void ) memcpy( &cLoggingBatch[ xLoggingBatchLength ], pcString, xLength + 1 );
+        xLoggingBatchLength += xLength;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvBatchFlush( void )
+{
+    if( xLoggingBatchLength > 0 )
+    {
+        configPRINT_STRING( cLoggingBatch );
+        xLoggingBatchLength = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list args;
+
+    va_start( args, pcFormat );
+    prvWriteRecord( NULL, NULL, 0, pcFormat, args );
+    va_end( args );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrintfBinary( const char * pcLevel,
+                           const char * pcLibraryName,
+                           BaseType_t xIncludeTimestring,
+                           const char * pcFormat,
+                           va_list xArgs )
+{
+    uint8_t ucFlags = loggingFLAG_NEWLINE;
+
+    if( xIncludeTimestring == pdTRUE )
+    {
+        ucFlags |= loggingFLAG_TIMESTRING;
+    }
+
+    prvWriteRecord( pcLevel, pcLibraryName, ucFlags, pcFormat, xArgs );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrint( const char * pcMessage )
+{
+    LoggingRecord_t * pxRecord = NULL;
+    size_t xLength = 0;
+
+    /* The logging task is created by xLoggingTaskInitialize().  Check
+     * xLoggingTaskInitialize() has been called. */
+    configASSERT( xLoggingTask );
+
+    pxRecord = prvClaimRecord();
+
+    if( pxRecord == NULL )
+    {
+        ( void ) Atomic_Increment_u32( &ulDroppedMessages );
+    }
+    else
+    {
+        /* The message is output as it is, so pass a copy of it. */
+        xLength = strlen( pcMessage ) + 1;
+        pxRecord->pcFormat = NULL;
+        pxRecord->pcText = pvPortMalloc( xLength );
+
+        if( pxRecord->pcText != NULL )
+        {
+            ( void ) memcpy( pxRecord->pcText, pcMessage, xLength );
+        }
+
+        prvPublishRecord( pxRecord );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Provide access to internal functions and variables if testing. */
+    #if defined( IOT_BUILD_TESTS ) && ( IOT_BUILD_TESTS == 1 )
+        #include "iot_test_access_logging_task.c"
+    #endif
+
+#endif /* if ( configLOGGING_BINARY_MODE == 0 ) */
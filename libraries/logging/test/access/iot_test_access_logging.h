@@ -0,0 +1,62 @@
+/*
+ * FreeRTOS Common V1.1.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_test_access_logging.h
+ * @brief Declares the functions that provide access to the internal functions
+ * and variables of the binary mode of the logging task.
+ */
+
+#ifndef IOT_TEST_ACCESS_LOGGING_H_
+#define IOT_TEST_ACCESS_LOGGING_H_
+
+/*------------------ iot_logging_task_dynamic_buffers.c -----------------*/
+
+/**
+ * @brief Captures the arguments of a message into a record, as the task that
+ * logs the message does, then formats the record as the logging task does.
+ *
+ * @return pdFAIL if the arguments don't fit in a record, in which case
+ * pcBuffer is empty.
+ */
+BaseType_t IotTestLogging_FormatMessage( char * pcBuffer,
+                                         size_t xBufferSize,
+                                         const char * pcFormat,
+                                         ... );
+
+/**
+ * @brief Test access function for #prvOutputRecords.
+ *
+ * Outputs the published records on the calling task.
+ */
+void IotTestLogging_OutputRecords( void );
+
+/**
+ * @brief Empties the ring and deletes the logging task handle, so that
+ * xLoggingTaskInitialize() may be called again.
+ */
+void IotTestLogging_Reset( void );
+
+#endif /* ifndef IOT_TEST_ACCESS_LOGGING_H_ */
@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS Common V1.1.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_test_access_logging_task.c
+ * @brief Provides access to the internal functions and variables of
+ * iot_logging_task_dynamic_buffers.c
+ *
+ * This file should only be included at the bottom of
+ * iot_logging_task_dynamic_buffers.c and never compiled by itself.
+ */
+
+#include "iot_test_access_logging.h"
+
+/*-----------------------------------------------------------*/
+
+BaseType_t IotTestLogging_FormatMessage( char * pcBuffer,
+                                         size_t xBufferSize,
+                                         const char * pcFormat,
+                                         ... )
+{
+    static LoggingRecord_t xRecord;
+    BaseType_t xReturn = pdFAIL;
+    va_list xArgs;
+
+    ( void ) memset( &xRecord, 0, sizeof( xRecord ) );
+    xRecord.pcFormat = pcFormat;
+    pcBuffer[ 0 ] = '\0';
+
+    va_start( xArgs, pcFormat );
+    xReturn = prvCaptureArguments( &xRecord, pcFormat, xArgs );
+    va_end( xArgs );
+
+    if( xReturn == pdPASS )
+    {
+        ( void ) prvFormatArguments( &xRecord, pcBuffer, xBufferSize );
+    }
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotTestLogging_OutputRecords( void )
+{
+    prvOutputRecords();
+}
+
+/*-----------------------------------------------------------*/
+
+void IotTestLogging_Reset( void )
+{
+    uint32_t ulRecord;
+
+    for( ulRecord = 0; ulRecord < configLOGGING_BINARY_RECORDS; ulRecord++ )
+    {
+        xRecords[ ulRecord ].ulSequence = ulRecord;
+    }
+
+    ulEnqueuePosition = 0;
+    ulDequeuePosition = 0;
+    ulDroppedMessages = 0;
+    ulReportedDrops = 0;
+    ulLoggingTaskWaiting = 0;
+    xLoggingBatchLength = 0;
+    xLoggingTask = NULL;
+}
+
+/*-----------------------------------------------------------*/
@@ -0,0 +1,269 @@
+/*
+ * FreeRTOS Common V1.1.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_task_dynamic_buffers_utest.c
+ * @brief Unit tests of the binary mode of the logging task.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "iot_logging_utest_config.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "mock_task.h"
+#include "mock_portable.h"
+
+/* Logging includes. */
+#include "iot_logging_task.h"
+#include "iot_test_access_logging.h"
+
+/* A buffer that is not NULL terminated, followed by characters that must not
+ * be read. */
+#define UNTERMINATED_LENGTH    ( 4 )
+#define UNTERMINATED_TAIL      ( 2 * configLOGGING_BINARY_PAYLOAD_SIZE )
+
+/* A string that does not fit in the payload of a record. */
+#define LONG_STRING                                     \
+    "0123456789abcdefghijklmnopqrstuvwxyz0123456789"    \
+    "abcdefghijklmnopqrstuvwxyz"
+
+/* The output of the logging task. */
+static char cOutput[ 512 ];
+static size_t xOutputLength = 0;
+
+/* Handle of the logging task returned by the mock of xTaskCreate(). */
+static TaskHandle_t xLoggingTaskHandle = ( TaskHandle_t ) 1;
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    cOutput[ 0 ] = '\0';
+    xOutputLength = 0;
+
+    IotTestLogging_Reset();
+
+    xTaskGetTickCount_IgnoreAndReturn( 0 );
+
+    xTaskCreate_ExpectAnyArgsAndReturn( pdPASS );
+    xTaskCreate_ReturnThruPtr_pxCreatedTask( &xLoggingTaskHandle );
+    TEST_ASSERT_EQUAL( pdPASS, xLoggingTaskInitialize( 1024, 1, 0 ) );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+void vLoggingUtestPrintString( const char * pcString )
+{
+    size_t xLength = strlen( pcString );
+
+    TEST_ASSERT_LESS_THAN( sizeof( cOutput ) - xOutputLength, xLength );
+
+    ( void ) memcpy( &cOutput[ xOutputLength ], pcString, xLength + 1 );
+    xOutputLength += xLength;
+}
+
+/* The logging task is not running, nothing to protect the atomics from. */
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+static void * malloc_cb( size_t xSize,
+                         int numCalls )
+{
+    ( void ) numCalls;
+
+    return malloc( xSize );
+}
+
+static void free_cb( void * pv,
+                     int numCalls )
+{
+    ( void ) numCalls;
+
+    free( pv );
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief %.*s and %.Ns read a buffer that is not NULL terminated only up to the
+ * precision.
+ */
+void test_PrecisionString_Unterminated( void )
+{
+    char cBuffer[ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+    struct
+    {
+        char cData[ UNTERMINATED_LENGTH ];
+        char cTail[ UNTERMINATED_TAIL ];
+    } xUnterminated;
+
+    ( void ) memcpy( xUnterminated.cData, "abcd", UNTERMINATED_LENGTH );
+    ( void ) memset( xUnterminated.cTail, 'X', sizeof( xUnterminated.cTail ) );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "[%.*s]",
+                                                             UNTERMINATED_LENGTH, xUnterminated.cData ) );
+    TEST_ASSERT_EQUAL_STRING( "[abcd]", cBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "[%.*s]",
+                                                             2, xUnterminated.cData ) );
+    TEST_ASSERT_EQUAL_STRING( "[ab]", cBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "[%.3s]",
+                                                             xUnterminated.cData ) );
+    TEST_ASSERT_EQUAL_STRING( "[abc]", cBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "[%*.*s]",
+                                                             6, UNTERMINATED_LENGTH, xUnterminated.cData ) );
+    TEST_ASSERT_EQUAL_STRING( "[  abcd]", cBuffer );
+}
+
+/**
+ * @brief A negative precision is taken as if it were omitted.
+ */
+void test_PrecisionString_Negative( void )
+{
+    char cBuffer[ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "[%.*s]", -1, "hello" ) );
+    TEST_ASSERT_EQUAL_STRING( "[hello]", cBuffer );
+}
+
+/**
+ * @brief Strings, integers and pointers in one message are replayed in order.
+ */
+void test_MixedConversions( void )
+{
+    char cBuffer[ configLOGGING_MAX_MESSAGE_LENGTH ];
+    char cExpected[ configLOGGING_MAX_MESSAGE_LENGTH ];
+    const char cTopic[] = { 't', 'o', 'p', 'i', 'c' };
+    void * pvPointer = &cBuffer;
+
+    ( void ) snprintf( cExpected, sizeof( cExpected ), "%s %d %p %.*s %-4s|%u",
+                       "id", -42, pvPointer, ( int ) sizeof( cTopic ), cTopic, "x", 7U );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "%s %d %p %.*s %-4s|%u",
+                                                             "id", -42, pvPointer, ( int ) sizeof( cTopic ), cTopic, "x", 7U ) );
+    TEST_ASSERT_EQUAL_STRING( cExpected, cBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "%s=%s", NULL, "" ) );
+    TEST_ASSERT_EQUAL_STRING( "(null)=", cBuffer );
+}
+
+/**
+ * @brief A string that does not fit in a record is not captured, unless its
+ * precision makes it fit.
+ */
+void test_StringLongerThanRecord( void )
+{
+    char cBuffer[ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+    TEST_ASSERT_EQUAL( pdFAIL, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "%s", LONG_STRING ) );
+    TEST_ASSERT_EQUAL_STRING( "", cBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, IotTestLogging_FormatMessage( cBuffer, sizeof( cBuffer ), "%.5s", LONG_STRING ) );
+    TEST_ASSERT_EQUAL_STRING( "01234", cBuffer );
+}
+
+/**
+ * @brief A message whose arguments don't fit in a record is formatted by the
+ * calling task, and both paths truncate to the maximum message length.
+ */
+void test_MessageTruncated( void )
+{
+    char cExpected[ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+    pvPortMalloc_Stub( malloc_cb );
+    vPortFree_Stub( free_cb );
+
+    vLoggingPrintf( "%s", LONG_STRING LONG_STRING );
+    IotTestLogging_OutputRecords();
+
+    /* The message is cut to configLOGGING_MAX_MESSAGE_LENGTH - 1 characters. */
+    ( void ) memcpy( cExpected, LONG_STRING LONG_STRING, configLOGGING_MAX_MESSAGE_LENGTH - 1 );
+    cExpected[ configLOGGING_MAX_MESSAGE_LENGTH - 1 ] = '\0';
+    TEST_ASSERT_EQUAL_STRING( cExpected, cOutput );
+
+    cOutput[ 0 ] = '\0';
+    xOutputLength = 0;
+
+    vLoggingPrintf( LONG_STRING LONG_STRING "%d", 1 );
+    IotTestLogging_OutputRecords();
+
+    TEST_ASSERT_EQUAL_STRING( cExpected, cOutput );
+}
+
+/**
+ * @brief Messages logged while the ring is full are dropped and reported.
+ */
+void test_RingFullDropsMessages( void )
+{
+    int i;
+
+    for( i = 0; i < configLOGGING_BINARY_RECORDS + 2; i++ )
+    {
+        vLoggingPrintf( "msg %d\n", i );
+    }
+
+    IotTestLogging_OutputRecords();
+
+    TEST_ASSERT_EQUAL_STRING( "msg 0\nmsg 1\nmsg 2\nmsg 3\n[Logging] 2 messages dropped\r\n", cOutput );
+
+    /* The records are free again. */
+    cOutput[ 0 ] = '\0';
+    xOutputLength = 0;
+
+    vLoggingPrintf( "msg %d\n", i );
+    IotTestLogging_OutputRecords();
+
+    TEST_ASSERT_EQUAL_STRING( "msg 6\n", cOutput );
+}
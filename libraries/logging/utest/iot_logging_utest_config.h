@@ -0,0 +1,49 @@
+/*
+ * FreeRTOS Common V1.1.3
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_logging_utest_config.h
+ * @brief Configuration of the logging task under test, included ahead of
+ * iot_logging_task_dynamic_buffers.c.
+ */
+
+#ifndef IOT_LOGGING_UTEST_CONFIG_H_
+#define IOT_LOGGING_UTEST_CONFIG_H_
+
+/* Test the binary mode, with a ring that is quick to fill. */
+#define configLOGGING_BINARY_MODE                  1
+#define configLOGGING_BINARY_RECORDS               4
+#define configLOGGING_BINARY_PAYLOAD_SIZE          64
+#define configLOGGING_MAX_MESSAGE_LENGTH           64
+#define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    0
+
+/* Build the test access functions. */
+#define IOT_BUILD_TESTS                            1
+
+/* The logging task outputs to the test. */
+void vLoggingUtestPrintString( const char * pcString );
+#define configPRINT_STRING( X )    vLoggingUtestPrintString( X )
+
+#endif /* ifndef IOT_LOGGING_UTEST_CONFIG_H_ */
@@ -0,0 +1,61 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file flash_api.h
+ * @brief Host version of the Realtek SDK header, to build the FTL in the
+ * benchmarks. iot_bench_ftl.c implements the functions over the flash
+ * simulator; addresses are offsets in the simulated flash.
+ */
+
+#ifndef FLASH_API_H_
+#define FLASH_API_H_
+
+/* Standard includes. */
+#include <stdint.h>
+
+/**
+ * @brief Flash object of the SDK. The simulator does not need one.
+ */
+typedef struct flash_s
+{
+    uint32_t unused; /**< @brief Not used. */
+} flash_t;
+
+/**
+ * @brief The flash functions ftl.c uses. Read and write return 1 on success.
+ */
+/**@{ */
+int flash_read_word( flash_t * obj,
+                     uint32_t address,
+                     uint32_t * data );
+int flash_write_word( flash_t * obj,
+                      uint32_t address,
+                      uint32_t data );
+void flash_erase_sector( flash_t * obj,
+                         uint32_t address );
+/**@} */
+
+#endif /* ifndef FLASH_API_H_ */
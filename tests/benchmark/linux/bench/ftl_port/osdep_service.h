@@ -0,0 +1,65 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file osdep_service.h
+ * @brief Host version of the Realtek SDK header, to build the FTL in the
+ * benchmarks.
+ */
+
+#ifndef OSDEP_SERVICE_H_
+#define OSDEP_SERVICE_H_
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/**
+ * @brief Allocate zeroed memory from the FreeRTOS heap.
+ */
+static inline uint8_t * rtw_zmalloc( uint32_t size )
+{
+    uint8_t * pMemory = pvPortMalloc( size );
+
+    if( pMemory != NULL )
+    {
+        ( void ) memset( pMemory, 0x00, size );
+    }
+
+    return pMemory;
+}
+
+/**
+ * @brief The benchmarks never call the FTL from an interrupt handler.
+ */
+static inline uint32_t __get_IPSR( void )
+{
+    return 0;
+}
+
+#endif /* ifndef OSDEP_SERVICE_H_ */
@@ -0,0 +1,282 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench.c
+ * @brief Measures scenarios and prints their results.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Whether the report is printed as comma separated values.
+ */
+static bool _csvOutput = false;
+
+/**
+ * @brief The number of scenarios that failed.
+ */
+static size_t _failedScenarios = 0;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Comparison function for sorting latency samples.
+ */
+static int _compareSamples( const void * pFirst,
+                            const void * pSecond )
+{
+    uint32_t first = *( ( const uint32_t * ) pFirst );
+    uint32_t second = *( ( const uint32_t * ) pSecond );
+
+    return ( first > second ) - ( first < second );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a percentile of sorted latency samples, using the nearest rank.
+ *
+ * @param[in] pSorted Sorted samples.
+ * @param[in] count Number of samples.
+ * @param[in] percentile Percentile to get, from 1 to 100.
+ *
+ * @return The latency at that percentile, or 0 without samples.
+ */
+static uint32_t _percentile( const uint32_t * pSorted,
+                             size_t count,
+                             uint32_t percentile )
+{
+    size_t rank = 0;
+    uint32_t value = 0;
+
+    if( count > 0U )
+    {
+        rank = ( ( count * percentile ) + 99U ) / 100U;
+
+        if( rank == 0U )
+        {
+            rank = 1U;
+        }
+
+        value = pSorted[ rank - 1U ];
+    }
+
+    return value;
+}
+
+/*-----------------------------------------------------------*/
+
+uint64_t IotBench_NowUs( void )
+{
+    struct timespec now = { 0 };
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( ( uint64_t ) now.tv_sec * 1000000ULL ) + ( ( uint64_t ) now.tv_nsec / 1000ULL );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_PrintHeader( bool csv )
+{
+    _csvOutput = csv;
+
+    if( _csvOutput == true )
+    {
+        printf( "scenario,operations,ops_per_s,mb_per_s,p50_us,p99_us,max_us,allocs_per_op,peak_heap_bytes,leaked_bytes\n" );
+    }
+    else
+    {
+        printf( "%-28s %9s %11s %8s %9s %9s %9s %10s %10s %8s\n",
+                "scenario", "ops", "ops/s", "MB/s", "p50 us", "p99 us", "max us",
+                "allocs/op", "peak heap", "leaked" );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_Start( IotBenchResult_t * pResult,
+                     const char * pName,
+                     size_t sampleCapacity )
+{
+    ( void ) memset( pResult, 0x00, sizeof( IotBenchResult_t ) );
+
+    pResult->pName = pName;
+
+    /* Samples are allocated with the C library, not the benchmark heap. */
+    pResult->pLatencyUs = malloc( sampleCapacity * sizeof( uint32_t ) );
+
+    if( pResult->pLatencyUs != NULL )
+    {
+        pResult->sampleCapacity = sampleCapacity;
+    }
+
+    IotBench_ResetHeapPeak();
+    IotBench_GetHeapStats( &( pResult->heapStart ) );
+    pResult->startUs = IotBench_NowUs();
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_Sample( IotBenchResult_t * pResult,
+                      uint32_t latencyUs,
+                      size_t bytes )
+{
+    vTaskSuspendAll();
+    {
+        if( pResult->sampleCount < pResult->sampleCapacity )
+        {
+            pResult->pLatencyUs[ pResult->sampleCount ] = latencyUs;
+            pResult->sampleCount++;
+        }
+
+        pResult->operations++;
+        pResult->bytes += bytes;
+    }
+    ( void ) xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_Fail( IotBenchResult_t * pResult,
+                    const char * pReason )
+{
+    vTaskSuspendAll();
+    {
+        if( pResult->pFailure == NULL )
+        {
+            pResult->pFailure = pReason;
+            _failedScenarios++;
+        }
+    }
+    ( void ) xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+size_t IotBench_FailedScenarios( void )
+{
+    return _failedScenarios;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_Stop( IotBenchResult_t * pResult )
+{
+    double seconds = 0.0;
+    double opsPerSecond = 0.0;
+    double megabytesPerSecond = 0.0;
+    double allocationsPerOperation = 0.0;
+    size_t peakBytes = 0;
+    long leakedBytes = 0;
+    uint32_t p50 = 0, p99 = 0, max = 0;
+
+    pResult->elapsedUs = IotBench_NowUs() - pResult->startUs;
+    IotBench_GetHeapStats( &( pResult->heapEnd ) );
+
+    if( pResult->sampleCount > 0U )
+    {
+        qsort( pResult->pLatencyUs, pResult->sampleCount, sizeof( uint32_t ), _compareSamples );
+        p50 = _percentile( pResult->pLatencyUs, pResult->sampleCount, 50U );
+        p99 = _percentile( pResult->pLatencyUs, pResult->sampleCount, 99U );
+        max = pResult->pLatencyUs[ pResult->sampleCount - 1U ];
+    }
+
+    if( pResult->elapsedUs > 0U )
+    {
+        seconds = ( double ) pResult->elapsedUs / 1000000.0;
+        opsPerSecond = ( double ) pResult->operations / seconds;
+        megabytesPerSecond = ( ( double ) pResult->bytes / ( 1024.0 * 1024.0 ) ) / seconds;
+    }
+
+    if( pResult->operations > 0U )
+    {
+        allocationsPerOperation = ( double ) ( pResult->heapEnd.allocations - pResult->heapStart.allocations ) /
+                                  ( double ) pResult->operations;
+    }
+
+    /* The peak is reported above what was allocated before the scenario. */
+    if( pResult->heapEnd.peakBytes > pResult->heapStart.currentBytes )
+    {
+        peakBytes = pResult->heapEnd.peakBytes - pResult->heapStart.currentBytes;
+    }
+
+    leakedBytes = ( long ) pResult->heapEnd.currentBytes - ( long ) pResult->heapStart.currentBytes;
+
+    if( pResult->pFailure != NULL )
+    {
+        if( _csvOutput == true )
+        {
+            printf( "%s,FAILED: %s\n", pResult->pName, pResult->pFailure );
+        }
+        else
+        {
+            printf( "%-28s FAILED: %s\n", pResult->pName, pResult->pFailure );
+        }
+    }
+    else if( _csvOutput == true )
+    {
+        printf( "%s,%zu,%.1f,%.2f,%u,%u,%u,%.2f,%zu,%ld\n",
+                pResult->pName, pResult->operations, opsPerSecond, megabytesPerSecond,
+                p50, p99, max, allocationsPerOperation, peakBytes, leakedBytes );
+    }
+    else
+    {
+        printf( "%-28s %9zu %11.1f %8.2f %9u %9u %9u %10.2f %10zu %8ld\n",
+                pResult->pName, pResult->operations, opsPerSecond, megabytesPerSecond,
+                p50, p99, max, allocationsPerOperation, peakBytes, leakedBytes );
+    }
+
+    ( void ) fflush( stdout );
+
+    free( pResult->pLatencyUs );
+    pResult->pLatencyUs = NULL;
+    pResult->sampleCapacity = 0;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_PrintNote( const char * pNote )
+{
+    if( _csvOutput == false )
+    {
+        printf( "%-28s %s\n", "", pNote );
+        ( void ) fflush( stdout );
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench.h
+ * @brief Measurement and reporting functions shared by the benchmark scenarios.
+ */
+
+#ifndef IOT_BENCH_H_
+#define IOT_BENCH_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Heap usage counted by the benchmark heap.
+ */
+typedef struct IotBenchHeapStats
+{
+    uint64_t allocations; /**< @brief Number of successful allocations since start up. */
+    size_t currentBytes;  /**< @brief Bytes currently allocated. */
+    size_t peakBytes;     /**< @brief Highest value of currentBytes since the last reset. */
+} IotBenchHeapStats_t;
+
+/**
+ * @brief The measurements of one scenario.
+ *
+ * Latency samples are kept in memory that is not taken from the benchmark
+ * heap, so that recording them does not show up in the allocation counts.
+ */
+typedef struct IotBenchResult
+{
+    const char * pName;            /**< @brief Scenario name. */
+    uint32_t * pLatencyUs;         /**< @brief Latency samples in microseconds. */
+    size_t sampleCapacity;         /**< @brief Maximum number of latency samples. */
+    size_t sampleCount;            /**< @brief Number of latency samples recorded. */
+    size_t operations;             /**< @brief Number of operations completed. */
+    size_t bytes;                  /**< @brief Payload bytes moved by the operations. */
+    uint64_t startUs;              /**< @brief Time at which the scenario started. */
+    uint64_t elapsedUs;            /**< @brief Duration of the scenario. */
+    IotBenchHeapStats_t heapStart; /**< @brief Heap counters when the scenario started. */
+    IotBenchHeapStats_t heapEnd;   /**< @brief Heap counters when the scenario stopped. */
+    const char * pFailure;         /**< @brief Why the scenario failed, or NULL. */
+} IotBenchResult_t;
+
+/**
+ * @brief Signature of a benchmark scenario.
+ *
+ * @param[in] iterations Number of operations to run.
+ */
+typedef void ( * IotBenchScenario_t )( size_t iterations );
+
+/**
+ * @brief Get a monotonic timestamp.
+ *
+ * @return Microseconds since an arbitrary point in the past.
+ */
+uint64_t IotBench_NowUs( void );
+
+/**
+ * @brief Read the benchmark heap counters.
+ *
+ * @param[out] pStats Current counters.
+ */
+void IotBench_GetHeapStats( IotBenchHeapStats_t * pStats );
+
+/**
+ * @brief Restart the heap peak from the bytes currently allocated.
+ */
+void IotBench_ResetHeapPeak( void );
+
+/**
+ * @brief Select the report format and print the report header.
+ *
+ * @param[in] csv Print comma separated values instead of a table.
+ */
+void IotBench_PrintHeader( bool csv );
+
+/**
+ * @brief Start measuring a scenario.
+ *
+ * @param[out] pResult Measurements to initialize.
+ * @param[in] pName Scenario name, printed in the report.
+ * @param[in] sampleCapacity Maximum number of latency samples to record.
+ */
+void IotBench_Start( IotBenchResult_t * pResult,
+                     const char * pName,
+                     size_t sampleCapacity );
+
+/**
+ * @brief Record a completed operation and its latency.
+ *
+ * Safe to call from several threads.
+ *
+ * @param[in] pResult Measurements of the running scenario.
+ * @param[in] latencyUs Latency of the operation in microseconds.
+ * @param[in] bytes Payload bytes moved by the operation.
+ */
+void IotBench_Sample( IotBenchResult_t * pResult,
+                      uint32_t latencyUs,
+                      size_t bytes );
+
+/**
+ * @brief Mark a scenario as failed. Its report shows the failure instead of
+ * numbers that cannot be compared.
+ *
+ * Safe to call from several threads. Only the first failure of a scenario is
+ * kept.
+ *
+ * @param[in] pResult Measurements of the running scenario.
+ * @param[in] pReason Short description of the failure.
+ */
+void IotBench_Fail( IotBenchResult_t * pResult,
+                    const char * pReason );
+
+/**
+ * @brief Get the number of scenarios marked as failed since the program
+ * started.
+ *
+ * @return The number of failed scenarios.
+ */
+size_t IotBench_FailedScenarios( void );
+
+/**
+ * @brief Stop measuring a scenario, print its report line and free its
+ * samples.
+ *
+ * @param[in] pResult Measurements of the running scenario.
+ */
+void IotBench_Stop( IotBenchResult_t * pResult );
+
+/**
+ * @brief Print a line of additional results under the report line of a
+ * scenario. Nothing is printed with comma separated values.
+ *
+ * @param[in] pNote Text to print.
+ */
+void IotBench_PrintNote( const char * pNote );
+
+/**
+ * @brief Save the simulated flash of the flash scenarios to a file, and
+ * start them from its contents.
+ *
+ * @param[in] pPath Path of the image file.
+ */
+void IotBench_SetFlashImage( const char * pPath );
+
+/**
+ * @brief The scenarios, one per file.
+ */
+/**@{ */
+void IotBench_MqttQos0( size_t iterations );
+void IotBench_MqttQos1( size_t iterations );
+void IotBench_MqttTopicMatchScan( size_t iterations );
+void IotBench_MqttTopicMatchTrie( size_t iterations );
+void IotBench_HttpsDownload( size_t iterations );
+void IotBench_TaskPoolSchedule( size_t iterations );
+void IotBench_TaskPoolScheduleDeferred( size_t iterations );
+void IotBench_JsonEncode( size_t iterations );
+void IotBench_JsonDecode( size_t iterations );
+void IotBench_CborEncode( size_t iterations );
+void IotBench_CborDecode( size_t iterations );
+void IotBench_OtaIngest( size_t iterations );
+void IotBench_FlashLogWriteThrough( size_t iterations );
+void IotBench_FlashLogCached( size_t iterations );
+void IotBench_FtlCounterGcInline( size_t iterations );
+void IotBench_FtlCounterGcIdle( size_t iterations );
+/**@} */
+
+#endif /* ifndef IOT_BENCH_H_ */
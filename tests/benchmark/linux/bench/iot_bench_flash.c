@@ -0,0 +1,372 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_flash.c
+ * @brief Benchmark of the sector cache of the FatFs flash disk.
+ *
+ * A data logger appends records to a file on a FatFs volume and syncs the
+ * file after each one. The scenarios replay the sector writes FatFs makes
+ * for this on a simulated NOR flash: the data sector holding the end of the
+ * file, the FAT sector when the file grows into a new sector, and the
+ * directory sector with the new file size, followed by CTRL_SYNC.
+ *
+ * The write-through scenario erases and programs every sector written, as
+ * the flash disk did before it had a cache. The latency of an operation is
+ * the time the flash would be busy, from the simulator, not wall time.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Flash disk includes. */
+#include "disk_if/inc/flash_cache.h"
+
+/* Benchmark includes. */
+#include "iot_bench.h"
+#include "iot_bench_flash_sim.h"
+
+/**
+ * @brief Geometry of the flash disk, as in flash_fatfs.c.
+ */
+#define IOT_BENCH_FLASH_SECTOR_SIZE      ( 4096U )
+#define IOT_BENCH_FLASH_SECTOR_COUNT     ( 128U )
+
+/**
+ * @brief Layout of the volume.
+ */
+#define IOT_BENCH_FLASH_BOOT_SECTOR      ( 0U )
+#define IOT_BENCH_FLASH_FAT_SECTOR       ( 1U )
+#define IOT_BENCH_FLASH_DIR_SECTOR       ( 2U )
+#define IOT_BENCH_FLASH_FIRST_DATA       ( 3U )
+#define IOT_BENCH_FLASH_DATA_SECTORS     ( IOT_BENCH_FLASH_SECTOR_COUNT - IOT_BENCH_FLASH_FIRST_DATA )
+
+/**
+ * @brief Size of a log record.
+ */
+#define IOT_BENCH_FLASH_RECORD_SIZE      ( 64U )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The flash disk of a scenario.
+ */
+typedef struct _flashBenchDisk
+{
+    IotBenchFlashSim_t sim;   /**< @brief Simulated flash under the disk. */
+    flash_cache_dev_t dev;    /**< @brief The simulator, as seen by the cache. */
+    flash_cache_t cache;      /**< @brief The sector cache. */
+    bool cached;              /**< @brief Write through the cache, or straight to flash. */
+} _flashBenchDisk_t;
+
+/**
+ * @brief File the simulated flash is saved to, or NULL.
+ */
+static const char * _pFlashImagePath = NULL;
+
+/**
+ * @brief Memory of the cache lines.
+ */
+static uint8_t _cacheBuffer[ FLASH_CACHE_LINES * IOT_BENCH_FLASH_SECTOR_SIZE ];
+
+/**
+ * @brief What the disk should contain, kept by the scenario.
+ */
+static uint8_t _volume[ IOT_BENCH_FLASH_SECTOR_COUNT ][ IOT_BENCH_FLASH_SECTOR_SIZE ];
+
+/**
+ * @brief A sector read back from the disk.
+ */
+static uint8_t _readBack[ IOT_BENCH_FLASH_SECTOR_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write sectors of _volume to the disk.
+ */
+static bool _diskWrite( _flashBenchDisk_t * pDisk,
+                        uint32_t sector,
+                        uint32_t count )
+{
+    bool status = true;
+    uint32_t i = 0, address = 0;
+
+    if( pDisk->cached == true )
+    {
+        status = ( flash_cache_write( &( pDisk->cache ), _volume[ sector ], sector, count ) == 0 );
+    }
+    else
+    {
+        for( i = 0; ( i < count ) && ( status == true ); i++ )
+        {
+            address = ( sector + i ) * IOT_BENCH_FLASH_SECTOR_SIZE;
+            status = ( IotBenchFlashSim_EraseSector( &( pDisk->sim ), address ) == 1 ) &&
+                     ( IotBenchFlashSim_Program( &( pDisk->sim ), address,
+                                                 IOT_BENCH_FLASH_SECTOR_SIZE, _volume[ sector + i ] ) == 1 );
+        }
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Make sure that all sectors written are in flash.
+ */
+static bool _diskSync( _flashBenchDisk_t * pDisk )
+{
+    bool status = true;
+
+    if( pDisk->cached == true )
+    {
+        status = ( flash_cache_sync( &( pDisk->cache ) ) == 0 );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Set a little endian value in _volume.
+ */
+static void _setValue( uint32_t sector,
+                       uint32_t offset,
+                       uint32_t value,
+                       uint32_t size )
+{
+    uint32_t i = 0;
+
+    for( i = 0; i < size; i++ )
+    {
+        _volume[ sector ][ offset + i ] = ( uint8_t ) ( value >> ( 8U * i ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the simulated flash and a volume holding an empty log file.
+ */
+static bool _diskCreate( _flashBenchDisk_t * pDisk,
+                         bool cached )
+{
+    bool status = true;
+
+    ( void ) memset( pDisk, 0x00, sizeof( _flashBenchDisk_t ) );
+    pDisk->cached = cached;
+
+    status = IotBenchFlashSim_Init( &( pDisk->sim ),
+                                    IOT_BENCH_FLASH_SECTOR_SIZE,
+                                    IOT_BENCH_FLASH_SECTOR_COUNT,
+                                    _pFlashImagePath );
+
+    if( status == true )
+    {
+        pDisk->dev.read = IotBenchFlashSim_Read;
+        pDisk->dev.write = IotBenchFlashSim_Program;
+        pDisk->dev.erase_sector = IotBenchFlashSim_EraseSector;
+        pDisk->dev.ctx = &( pDisk->sim );
+        pDisk->dev.base = 0;
+        pDisk->dev.sector_size = IOT_BENCH_FLASH_SECTOR_SIZE;
+        pDisk->dev.sector_count = IOT_BENCH_FLASH_SECTOR_COUNT;
+
+        status = ( flash_cache_init( &( pDisk->cache ), &( pDisk->dev ), _cacheBuffer ) == 0 );
+    }
+
+    if( status == true )
+    {
+        /* Data sectors keep what the flash holds; the file is written over it. */
+        ( void ) memcpy( _volume, pDisk->sim.pImage, sizeof( _volume ) );
+
+        /* Boot sector, a FAT with only the reserved entries, and a directory
+         * entry for the empty file. */
+        ( void ) memset( _volume[ IOT_BENCH_FLASH_BOOT_SECTOR ], 0x00, IOT_BENCH_FLASH_SECTOR_SIZE );
+        ( void ) memset( _volume[ IOT_BENCH_FLASH_FAT_SECTOR ], 0x00, IOT_BENCH_FLASH_SECTOR_SIZE );
+        ( void ) memset( _volume[ IOT_BENCH_FLASH_DIR_SECTOR ], 0x00, IOT_BENCH_FLASH_SECTOR_SIZE );
+        _setValue( IOT_BENCH_FLASH_BOOT_SECTOR, 510, 0xAA55U, 2 );
+        _setValue( IOT_BENCH_FLASH_FAT_SECTOR, 0, 0xFFFFFFF8U, 4 );
+        ( void ) memcpy( _volume[ IOT_BENCH_FLASH_DIR_SECTOR ], "LOG     TXT", 11 );
+
+        status = _diskWrite( pDisk, IOT_BENCH_FLASH_BOOT_SECTOR, 3 ) && _diskSync( pDisk );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that the flash holds _volume, free the disk and print its
+ * flash counters.
+ */
+static void _diskDestroy( _flashBenchDisk_t * pDisk,
+                          IotBenchResult_t * pResult,
+                          size_t records )
+{
+    uint32_t sector = 0, maxErases = 0;
+    char note[ 128 ];
+
+    for( sector = 0; ( sector < IOT_BENCH_FLASH_SECTOR_COUNT ) && ( pDisk->sim.pImage != NULL ); sector++ )
+    {
+        if( ( IotBenchFlashSim_Read( &( pDisk->sim ), sector * IOT_BENCH_FLASH_SECTOR_SIZE,
+                                     IOT_BENCH_FLASH_SECTOR_SIZE, _readBack ) != 1 ) ||
+            ( memcmp( _readBack, _volume[ sector ], IOT_BENCH_FLASH_SECTOR_SIZE ) != 0 ) )
+        {
+            IotBench_Fail( pResult, "flash does not hold what was written" );
+        }
+
+        if( pDisk->sim.pEraseCounts[ sector ] > maxErases )
+        {
+            maxErases = pDisk->sim.pEraseCounts[ sector ];
+        }
+    }
+
+    if( pDisk->sim.programmedOverZero == true )
+    {
+        IotBench_Fail( pResult, "programmed a sector without erasing it" );
+    }
+
+    IotBench_Stop( pResult );
+
+    ( void ) snprintf( note, sizeof( note ),
+                       "erases/op %.3f, programs/op %.3f, most erases of a sector %u",
+                       ( double ) pDisk->sim.erases / ( double ) records,
+                       ( double ) pDisk->sim.programs / ( double ) records,
+                       maxErases );
+    IotBench_PrintNote( note );
+
+    ( void ) IotBenchFlashSim_Cleanup( &( pDisk->sim ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Append records to the log file and sync after each one.
+ */
+static void _logAppend( const char * pName,
+                        size_t iterations,
+                        bool cached )
+{
+    IotBenchResult_t result;
+    _flashBenchDisk_t disk;
+    size_t record = 0;
+    uint32_t offset = 0, fileSize = 0, dataSector = 0, cluster = 0;
+    uint64_t busyUs = 0;
+    bool status = true;
+
+    IotBench_Start( &result, pName, iterations );
+
+    status = _diskCreate( &disk, cached );
+
+    if( status == false )
+    {
+        IotBench_Fail( &result, "could not create the flash disk" );
+    }
+    else
+    {
+        /* Erases and programs made to create the volume are not counted. */
+        disk.sim.erases = 0;
+        disk.sim.programs = 0;
+        ( void ) memset( disk.sim.pEraseCounts, 0x00, IOT_BENCH_FLASH_SECTOR_COUNT * sizeof( uint32_t ) );
+    }
+
+    for( record = 0; ( record < iterations ) && ( status == true ); record++ )
+    {
+        busyUs = disk.sim.busyUs;
+
+        /* The log wraps around when the data area is full. */
+        offset = fileSize % ( IOT_BENCH_FLASH_DATA_SECTORS * IOT_BENCH_FLASH_SECTOR_SIZE );
+        dataSector = IOT_BENCH_FLASH_FIRST_DATA + ( offset / IOT_BENCH_FLASH_SECTOR_SIZE );
+        offset %= IOT_BENCH_FLASH_SECTOR_SIZE;
+
+        ( void ) memset( &( _volume[ dataSector ][ offset ] ), ( int ) ( record & 0xFFU ), IOT_BENCH_FLASH_RECORD_SIZE );
+        fileSize += IOT_BENCH_FLASH_RECORD_SIZE;
+
+        /* Sync: the data sector, the FAT when the file grew into a new
+         * sector, then the size in the directory entry. */
+        status = _diskWrite( &disk, dataSector, 1 );
+
+        if( ( status == true ) && ( offset == 0U ) && ( fileSize <= ( IOT_BENCH_FLASH_DATA_SECTORS * IOT_BENCH_FLASH_SECTOR_SIZE ) ) )
+        {
+            /* One FAT16 entry per sector; the cluster numbers start at 2. */
+            cluster = dataSector - IOT_BENCH_FLASH_FIRST_DATA + 2U;
+
+            if( cluster > 2U )
+            {
+                _setValue( IOT_BENCH_FLASH_FAT_SECTOR, ( cluster - 1U ) * 2U, cluster, 2 );
+            }
+            else
+            {
+                _setValue( IOT_BENCH_FLASH_DIR_SECTOR, 26, cluster, 2 );
+            }
+
+            _setValue( IOT_BENCH_FLASH_FAT_SECTOR, cluster * 2U, 0xFFFFU, 2 );
+            status = _diskWrite( &disk, IOT_BENCH_FLASH_FAT_SECTOR, 1 );
+        }
+
+        if( status == true )
+        {
+            _setValue( IOT_BENCH_FLASH_DIR_SECTOR, 28, fileSize, 4 );
+            status = _diskWrite( &disk, IOT_BENCH_FLASH_DIR_SECTOR, 1 ) && _diskSync( &disk );
+        }
+
+        if( status == false )
+        {
+            IotBench_Fail( &result, "flash write or sync failed" );
+        }
+        else
+        {
+            IotBench_Sample( &result, ( uint32_t ) ( disk.sim.busyUs - busyUs ), IOT_BENCH_FLASH_RECORD_SIZE );
+        }
+    }
+
+    _diskDestroy( &disk, &result, ( iterations > 0U ) ? iterations : 1U );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_SetFlashImage( const char * pPath )
+{
+    _pFlashImagePath = pPath;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_FlashLogWriteThrough( size_t iterations )
+{
+    _logAppend( "flash_log_writethrough", iterations, false );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_FlashLogCached( size_t iterations )
+{
+    _logAppend( "flash_log_cached", iterations, true );
+}
+
+/*-----------------------------------------------------------*/
@@ -0,0 +1,207 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_flash_sim.c
+ * @brief A NOR flash simulator, in RAM and optionally saved to a file.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Benchmark include. */
+#include "iot_bench_flash_sim.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a range is inside the flash.
+ */
+static bool _inRange( const IotBenchFlashSim_t * pSim,
+                      uint32_t address,
+                      uint32_t length )
+{
+    uint64_t size = ( uint64_t ) pSim->sectorSize * pSim->sectorCount;
+
+    return ( ( uint64_t ) address + length ) <= size;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotBenchFlashSim_Init( IotBenchFlashSim_t * pSim,
+                            uint32_t sectorSize,
+                            uint32_t sectorCount,
+                            const char * pImagePath )
+{
+    bool status = true;
+    size_t size = ( size_t ) sectorSize * sectorCount;
+    FILE * pFile = NULL;
+
+    ( void ) memset( pSim, 0x00, sizeof( IotBenchFlashSim_t ) );
+    pSim->sectorSize = sectorSize;
+    pSim->sectorCount = sectorCount;
+    pSim->pImagePath = pImagePath;
+
+    /* The simulator allocates with the C library, not the benchmark heap. */
+    pSim->pImage = malloc( size );
+    pSim->pEraseCounts = calloc( sectorCount, sizeof( uint32_t ) );
+
+    if( ( pSim->pImage == NULL ) || ( pSim->pEraseCounts == NULL ) )
+    {
+        ( void ) IotBenchFlashSim_Cleanup( pSim );
+        status = false;
+    }
+    else
+    {
+        ( void ) memset( pSim->pImage, 0xFF, size );
+
+        /* A missing or short image file leaves the rest of the flash erased. */
+        if( pImagePath != NULL )
+        {
+            pFile = fopen( pImagePath, "rb" );
+
+            if( pFile != NULL )
+            {
+                ( void ) fread( pSim->pImage, 1, size, pFile );
+                ( void ) fclose( pFile );
+            }
+        }
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotBenchFlashSim_Cleanup( IotBenchFlashSim_t * pSim )
+{
+    bool status = true;
+    size_t size = ( size_t ) pSim->sectorSize * pSim->sectorCount;
+    FILE * pFile = NULL;
+
+    if( ( pSim->pImagePath != NULL ) && ( pSim->pImage != NULL ) )
+    {
+        pFile = fopen( pSim->pImagePath, "wb" );
+
+        if( ( pFile == NULL ) || ( fwrite( pSim->pImage, 1, size, pFile ) != size ) )
+        {
+            status = false;
+        }
+
+        if( ( pFile != NULL ) && ( fclose( pFile ) != 0 ) )
+        {
+            status = false;
+        }
+    }
+
+    free( pSim->pImage );
+    free( pSim->pEraseCounts );
+    pSim->pImage = NULL;
+    pSim->pEraseCounts = NULL;
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+int IotBenchFlashSim_Read( void * pContext,
+                           uint32_t address,
+                           uint32_t length,
+                           uint8_t * pData )
+{
+    IotBenchFlashSim_t * pSim = pContext;
+    int status = 0;
+
+    if( _inRange( pSim, address, length ) == true )
+    {
+        ( void ) memcpy( pData, pSim->pImage + address, length );
+        status = 1;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+int IotBenchFlashSim_Program( void * pContext,
+                              uint32_t address,
+                              uint32_t length,
+                              const uint8_t * pData )
+{
+    IotBenchFlashSim_t * pSim = pContext;
+    int status = 0;
+    uint32_t i = 0;
+    uint32_t firstPage = 0, lastPage = 0;
+
+    if( ( _inRange( pSim, address, length ) == true ) && ( length > 0U ) )
+    {
+        for( i = 0; i < length; i++ )
+        {
+            if( ( pSim->pImage[ address + i ] & pData[ i ] ) != pData[ i ] )
+            {
+                pSim->programmedOverZero = true;
+            }
+
+            /* Programming can only clear bits. */
+            pSim->pImage[ address + i ] &= pData[ i ];
+        }
+
+        firstPage = address / IOT_BENCH_FLASH_PAGE_SIZE;
+        lastPage = ( address + length - 1U ) / IOT_BENCH_FLASH_PAGE_SIZE;
+
+        pSim->programs++;
+        pSim->programmedPages += ( lastPage - firstPage ) + 1U;
+        pSim->busyUs += ( uint64_t ) ( ( lastPage - firstPage ) + 1U ) * IOT_BENCH_FLASH_PROGRAM_US;
+        status = 1;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+int IotBenchFlashSim_EraseSector( void * pContext,
+                                  uint32_t address )
+{
+    IotBenchFlashSim_t * pSim = pContext;
+    int status = 0;
+    uint32_t sector = address / pSim->sectorSize;
+
+    if( sector < pSim->sectorCount )
+    {
+        ( void ) memset( pSim->pImage + ( ( size_t ) sector * pSim->sectorSize ), 0xFF, pSim->sectorSize );
+
+        pSim->pEraseCounts[ sector ]++;
+        pSim->erases++;
+        pSim->busyUs += IOT_BENCH_FLASH_ERASE_US;
+        status = 1;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
@@ -0,0 +1,124 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_flash_sim.h
+ * @brief A NOR flash simulator, in RAM and optionally saved to a file.
+ *
+ * The simulator follows the rules of NOR flash: erasing sets a sector to
+ * 0xFF, and programming can only clear bits. It counts operations and adds
+ * up the time a typical SPI NOR flash would spend on them.
+ */
+
+#ifndef IOT_BENCH_FLASH_SIM_H_
+#define IOT_BENCH_FLASH_SIM_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Typical time to erase a 4 KB sector, in microseconds.
+ */
+#ifndef IOT_BENCH_FLASH_ERASE_US
+    #define IOT_BENCH_FLASH_ERASE_US    ( 45000U )
+#endif
+
+/**
+ * @brief Typical time to program a page, in microseconds.
+ */
+#ifndef IOT_BENCH_FLASH_PROGRAM_US
+    #define IOT_BENCH_FLASH_PROGRAM_US    ( 700U )
+#endif
+
+/**
+ * @brief Size of a program page.
+ */
+#ifndef IOT_BENCH_FLASH_PAGE_SIZE
+    #define IOT_BENCH_FLASH_PAGE_SIZE    ( 256U )
+#endif
+
+/**
+ * @brief A simulated flash device.
+ */
+typedef struct IotBenchFlashSim
+{
+    uint8_t * pImage;            /**< @brief Contents of the flash. */
+    uint32_t * pEraseCounts;     /**< @brief Number of erases of each sector. */
+    uint32_t sectorSize;         /**< @brief Size of an erase sector. */
+    uint32_t sectorCount;        /**< @brief Number of sectors. */
+    const char * pImagePath;     /**< @brief File the contents are loaded from and saved to, or NULL. */
+    uint64_t erases;             /**< @brief Sectors erased. */
+    uint64_t programs;           /**< @brief Calls to the program function. */
+    uint64_t programmedPages;    /**< @brief Pages programmed, counting partial pages. */
+    uint64_t busyUs;             /**< @brief Time the device spent erasing and programming. */
+    bool programmedOverZero;     /**< @brief A program tried to set a cleared bit. */
+} IotBenchFlashSim_t;
+
+/**
+ * @brief Create a simulated flash.
+ *
+ * @param[out] pSim The flash to initialize.
+ * @param[in] sectorSize Size of an erase sector.
+ * @param[in] sectorCount Number of sectors.
+ * @param[in] pImagePath File to load the contents from and save them to on
+ * cleanup, or NULL to start erased and keep the contents in RAM only.
+ *
+ * @return `true` if the flash was created.
+ */
+bool IotBenchFlashSim_Init( IotBenchFlashSim_t * pSim,
+                            uint32_t sectorSize,
+                            uint32_t sectorCount,
+                            const char * pImagePath );
+
+/**
+ * @brief Save the contents to the image file, if any, and free the flash.
+ *
+ * @param[in] pSim The flash.
+ *
+ * @return `false` if the image file could not be written.
+ */
+bool IotBenchFlashSim_Cleanup( IotBenchFlashSim_t * pSim );
+
+/**
+ * @brief Flash functions, with the signatures of the flash_cache_dev_t
+ * functions of the FatFs flash disk. pContext is the IotBenchFlashSim_t.
+ * They return 1 on success and 0 on failure.
+ */
+/**@{ */
+int IotBenchFlashSim_Read( void * pContext,
+                           uint32_t address,
+                           uint32_t length,
+                           uint8_t * pData );
+int IotBenchFlashSim_Program( void * pContext,
+                              uint32_t address,
+                              uint32_t length,
+                              const uint8_t * pData );
+int IotBenchFlashSim_EraseSector( void * pContext,
+                                  uint32_t address );
+/**@} */
+
+#endif /* ifndef IOT_BENCH_FLASH_SIM_H_ */
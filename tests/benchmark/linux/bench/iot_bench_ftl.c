@@ -0,0 +1,292 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_ftl.c
+ * @brief Benchmark of the garbage collection of the FTL key store.
+ *
+ * An application keeps a configuration block and counters in the FTL of the
+ * Realtek SDK, and saves one counter after every event. The FTL appends every
+ * save to a log of flash pages, and recycles the oldest page when it runs out
+ * of free ones. The scenarios run ftl.c on a simulated NOR flash, with the
+ * three pages of the SDK's default configuration.
+ *
+ * With inline collection, the save that fills a page recycles the oldest one
+ * before it returns. With collection in idle, the FTL compacts the oldest page
+ * a few entries at a time from the idle hook, which the scenario calls between
+ * saves. The latency of a save is the time the flash is busy during the call,
+ * from the simulator, not wall time.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FTL includes. */
+#include "platform_stdlib.h"
+#include "flash_api.h"
+#include "ftl_int.h"
+
+/* Benchmark includes. */
+#include "iot_bench.h"
+#include "iot_bench_flash_sim.h"
+
+/**
+ * @brief Geometry of the FTL. The pages start after the first sector, since
+ * the FTL takes a page address of 0 as not initialized.
+ */
+#define IOT_BENCH_FTL_PAGE_SIZE      ( 4096U )
+#define IOT_BENCH_FTL_PAGES          ( 3U )
+#define IOT_BENCH_FTL_BASE           IOT_BENCH_FTL_PAGE_SIZE
+
+/**
+ * @brief Layout of the data, in FTL offsets.
+ */
+#define IOT_BENCH_FTL_CONFIG_SIZE    ( 512U )
+#define IOT_BENCH_FTL_COUNTERS       ( 16U )
+#define IOT_BENCH_FTL_COUNTER_BASE   IOT_BENCH_FTL_CONFIG_SIZE
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Flash under the FTL, used by the functions of flash_api.h.
+ */
+static IotBenchFlashSim_t * _pFtlFlash = NULL;
+
+/**
+ * @brief What the FTL should contain, kept by the scenario.
+ */
+static uint8_t _config[ IOT_BENCH_FTL_CONFIG_SIZE ];
+static uint32_t _counters[ IOT_BENCH_FTL_COUNTERS ];
+
+/**
+ * @brief Data loaded back from the FTL.
+ */
+static uint8_t _configBack[ IOT_BENCH_FTL_CONFIG_SIZE ];
+static uint32_t _countersBack[ IOT_BENCH_FTL_COUNTERS ];
+
+/*-----------------------------------------------------------*/
+
+int flash_read_word( flash_t * obj,
+                     uint32_t address,
+                     uint32_t * data )
+{
+    ( void ) obj;
+
+    return IotBenchFlashSim_Read( _pFtlFlash, address, sizeof( uint32_t ), ( uint8_t * ) data );
+}
+
+/*-----------------------------------------------------------*/
+
+int flash_write_word( flash_t * obj,
+                      uint32_t address,
+                      uint32_t data )
+{
+    ( void ) obj;
+
+    return IotBenchFlashSim_Program( _pFtlFlash, address, sizeof( uint32_t ), ( const uint8_t * ) &data );
+}
+
+/*-----------------------------------------------------------*/
+
+void flash_erase_sector( flash_t * obj,
+                         uint32_t address )
+{
+    ( void ) obj;
+
+    ( void ) IotBenchFlashSim_EraseSector( _pFtlFlash, address );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the simulated flash and format the FTL on it.
+ */
+static bool _ftlCreate( IotBenchFlashSim_t * pSim,
+                        bool idle )
+{
+    bool status = true;
+    uint32_t i = 0;
+
+    status = IotBenchFlashSim_Init( pSim, IOT_BENCH_FTL_PAGE_SIZE, IOT_BENCH_FTL_PAGES + 1U, NULL );
+
+    if( status == true )
+    {
+        _pFtlFlash = pSim;
+
+        /* Free pages are erased ahead, so that the first save to each one
+         * does not erase it. */
+        status = ( ftl_init( IOT_BENCH_FTL_BASE, IOT_BENCH_FTL_PAGES ) == 0U ) &&
+                 ( ftl_ioctl( FTL_IOCTL_ERASE_INVALID_PAGE, 0, 0 ) == 0U );
+    }
+
+    if( status == true )
+    {
+        /* The thresholds are the defaults of ftl.c. */
+        if( idle == true )
+        {
+            ( void ) ftl_ioctl( FTL_IOCTL_ENABLE_GC_IN_IDLE, 1, IOT_BENCH_FTL_PAGE_SIZE / 8U );
+        }
+        else
+        {
+            ( void ) ftl_ioctl( FTL_IOCTL_DISABLE_GC_IN_IDLE, 0, 0 );
+        }
+
+        for( i = 0; i < IOT_BENCH_FTL_CONFIG_SIZE; i++ )
+        {
+            _config[ i ] = ( uint8_t ) ( i * 7U );
+        }
+
+        ( void ) memset( _counters, 0x00, sizeof( _counters ) );
+
+        status = ( ftl_save_to_storage( _config, 0, IOT_BENCH_FTL_CONFIG_SIZE ) == 0U ) &&
+                 ( ftl_save_to_storage( _counters, IOT_BENCH_FTL_COUNTER_BASE, sizeof( _counters ) ) == 0U );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Start the FTL again from flash, as after a reset, and check that it
+ * holds what was saved.
+ */
+static bool _ftlVerify( void )
+{
+    bool status = true;
+
+    ( void ) ftl_ioctl( FTL_IOCTL_DISABLE_GC_IN_IDLE, 0, 0 );
+
+    status = ( ftl_init( IOT_BENCH_FTL_BASE, IOT_BENCH_FTL_PAGES ) == 0U ) &&
+             ( ftl_load_from_storage( _configBack, 0, IOT_BENCH_FTL_CONFIG_SIZE ) == 0U ) &&
+             ( ftl_load_from_storage( _countersBack, IOT_BENCH_FTL_COUNTER_BASE, sizeof( _countersBack ) ) == 0U );
+
+    if( status == true )
+    {
+        status = ( memcmp( _configBack, _config, sizeof( _config ) ) == 0 ) &&
+                 ( memcmp( _countersBack, _counters, sizeof( _counters ) ) == 0 );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Save counters, one per operation.
+ */
+static void _counterSave( const char * pName,
+                          size_t iterations,
+                          bool idle )
+{
+    IotBenchResult_t result;
+    IotBenchFlashSim_t sim;
+    size_t operation = 0;
+    uint32_t counter = 0;
+    uint64_t busyUs = 0, idleBusyUs = 0;
+    bool status = true;
+    char note[ 128 ];
+
+    /* The FTL allocates its mapping table and lock once, before measuring. */
+    status = _ftlCreate( &sim, idle );
+
+    IotBench_Start( &result, pName, iterations );
+
+    if( status == false )
+    {
+        IotBench_Fail( &result, "could not create the FTL" );
+    }
+    else
+    {
+        /* Erases and programs made to create the FTL are not counted. */
+        sim.erases = 0;
+        sim.programs = 0;
+        ( void ) memset( sim.pEraseCounts, 0x00, ( IOT_BENCH_FTL_PAGES + 1U ) * sizeof( uint32_t ) );
+    }
+
+    for( operation = 0; ( operation < iterations ) && ( status == true ); operation++ )
+    {
+        counter = ( uint32_t ) ( operation % IOT_BENCH_FTL_COUNTERS );
+        _counters[ counter ]++;
+
+        busyUs = sim.busyUs;
+        status = ( ftl_save_to_storage( &( _counters[ counter ] ),
+                                        ( uint16_t ) ( IOT_BENCH_FTL_COUNTER_BASE + ( counter * sizeof( uint32_t ) ) ),
+                                        sizeof( uint32_t ) ) == 0U );
+
+        if( status == false )
+        {
+            IotBench_Fail( &result, "ftl_save_to_storage failed" );
+        }
+        else
+        {
+            IotBench_Sample( &result, ( uint32_t ) ( sim.busyUs - busyUs ), sizeof( uint32_t ) );
+
+            /* The application waits for its next event. */
+            busyUs = sim.busyUs;
+            ftl_garbage_collect_in_idle();
+            idleBusyUs += sim.busyUs - busyUs;
+        }
+    }
+
+    if( ( status == true ) && ( _ftlVerify() == false ) )
+    {
+        IotBench_Fail( &result, "FTL does not hold what was saved" );
+    }
+
+    if( sim.programmedOverZero == true )
+    {
+        IotBench_Fail( &result, "programmed a page without erasing it" );
+    }
+
+    IotBench_Stop( &result );
+
+    ( void ) snprintf( note, sizeof( note ),
+                       "erases/op %.4f, programs/op %.3f, idle busy us/op %.1f",
+                       ( double ) sim.erases / ( double ) ( ( iterations > 0U ) ? iterations : 1U ),
+                       ( double ) sim.programs / ( double ) ( ( iterations > 0U ) ? iterations : 1U ),
+                       ( double ) idleBusyUs / ( double ) ( ( iterations > 0U ) ? iterations : 1U ) );
+    IotBench_PrintNote( note );
+
+    _pFtlFlash = NULL;
+    ( void ) IotBenchFlashSim_Cleanup( &sim );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_FtlCounterGcInline( size_t iterations )
+{
+    _counterSave( "ftl_counter_gc_inline", iterations, false );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_FtlCounterGcIdle( size_t iterations )
+{
+    _counterSave( "ftl_counter_gc_idle", iterations, true );
+}
+
+/*-----------------------------------------------------------*/
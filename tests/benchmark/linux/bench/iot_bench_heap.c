@@ -0,0 +1,174 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_heap.c
+ * @brief A FreeRTOS heap that counts allocations for the benchmark report.
+ *
+ * The libraries allocate through pvPortMalloc and vPortFree, so this file
+ * replaces the heap_x.c implementation of the port. Memory comes from the C
+ * library; a header in front of each block records its size.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Header placed in front of every block, sized to keep the block
+ * aligned for any type.
+ */
+typedef union _heapHeader
+{
+    size_t size;          /**< @brief Size requested by the caller. */
+    long double aligned;  /**< @brief Alignment of the block that follows. */
+    void * pAligned;      /**< @brief Alignment of the block that follows. */
+    uint64_t alignedWord; /**< @brief Alignment of the block that follows. */
+} _heapHeader_t;
+
+/**
+ * @brief Counters reported by #IotBench_GetHeapStats.
+ */
+static IotBenchHeapStats_t _heapStats = { 0 };
+
+/**
+ * @brief Lowest free heap size, relative to configTOTAL_HEAP_SIZE.
+ */
+static size_t _minimumEverFreeBytes = configTOTAL_HEAP_SIZE;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    _heapHeader_t * pHeader = NULL;
+    void * pBlock = NULL;
+
+    pHeader = malloc( sizeof( _heapHeader_t ) + xWantedSize );
+
+    if( pHeader != NULL )
+    {
+        pHeader->size = xWantedSize;
+        pBlock = pHeader + 1;
+
+        vTaskSuspendAll();
+        {
+            _heapStats.allocations++;
+            _heapStats.currentBytes += xWantedSize;
+
+            if( _heapStats.currentBytes > _heapStats.peakBytes )
+            {
+                _heapStats.peakBytes = _heapStats.currentBytes;
+            }
+
+            if( ( configTOTAL_HEAP_SIZE - _heapStats.currentBytes ) < _minimumEverFreeBytes )
+            {
+                _minimumEverFreeBytes = configTOTAL_HEAP_SIZE - _heapStats.currentBytes;
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+        if( pBlock == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+
+            vApplicationMallocFailedHook();
+        }
+    #endif
+
+    return pBlock;
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    _heapHeader_t * pHeader = NULL;
+
+    if( pv != NULL )
+    {
+        pHeader = ( ( _heapHeader_t * ) pv ) - 1;
+
+        vTaskSuspendAll();
+        {
+            _heapStats.currentBytes -= pHeader->size;
+        }
+        ( void ) xTaskResumeAll();
+
+        free( pHeader );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return configTOTAL_HEAP_SIZE - _heapStats.currentBytes;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return _minimumEverFreeBytes;
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* Nothing to initialize; blocks come from the C library. */
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_GetHeapStats( IotBenchHeapStats_t * pStats )
+{
+    vTaskSuspendAll();
+    {
+        *pStats = _heapStats;
+    }
+    ( void ) xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_ResetHeapPeak( void )
+{
+    vTaskSuspendAll();
+    {
+        _heapStats.peakBytes = _heapStats.currentBytes;
+    }
+    ( void ) xTaskResumeAll();
+}
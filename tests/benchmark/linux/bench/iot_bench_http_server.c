@@ -0,0 +1,279 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_http_server.c
+ * @brief A minimal HTTP server for the benchmarks.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "iot_bench_loopback.h"
+#include "iot_bench_servers.h"
+
+/**
+ * @brief Maximum number of open connections.
+ */
+#ifndef IOT_BENCH_HTTP_MAX_CONNECTIONS
+    #define IOT_BENCH_HTTP_MAX_CONNECTIONS    ( 4 )
+#endif
+
+/**
+ * @brief Maximum size of a request head. Longer requests close the connection.
+ */
+#ifndef IOT_BENCH_HTTP_MAX_REQUEST_SIZE
+    #define IOT_BENCH_HTTP_MAX_REQUEST_SIZE    ( 1024 )
+#endif
+
+/**
+ * @brief Size of the block repeated to make response bodies.
+ */
+#define _BODY_BLOCK_SIZE    ( 4096 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief An open connection.
+ */
+typedef struct _httpConnection
+{
+    void * pConnection;                                 /**< @brief Server end of the connection; NULL if unused. */
+    size_t requestLength;                               /**< @brief Bytes of the request head received. */
+    char request[ IOT_BENCH_HTTP_MAX_REQUEST_SIZE + 1 ]; /**< @brief The request head, NULL-terminated. */
+} _httpConnection_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Open connections, protected by suspending the scheduler.
+ */
+static _httpConnection_t _connections[ IOT_BENCH_HTTP_MAX_CONNECTIONS ];
+
+/**
+ * @brief The block repeated to make response bodies.
+ */
+static uint8_t _bodyBlock[ _BODY_BLOCK_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Answer a complete request head.
+ *
+ * @return `false` if the connection must be closed.
+ */
+static bool _respond( _httpConnection_t * pHttpConnection )
+{
+    char header[ 160 ] = { 0 };
+    int headerLength = 0;
+    unsigned long bodyLength = 0;
+    size_t bodySent = 0, chunk = 0;
+    bool keepAlive = true;
+    const char * pStatus = "200 OK";
+
+    if( sscanf( pHttpConnection->request, "GET /%lu ", &bodyLength ) != 1 )
+    {
+        pStatus = "404 Not Found";
+        bodyLength = 0;
+    }
+
+    if( ( strstr( pHttpConnection->request, "Connection: close" ) != NULL ) ||
+        ( strstr( pHttpConnection->request, "connection: close" ) != NULL ) )
+    {
+        keepAlive = false;
+    }
+
+    headerLength = snprintf( header,
+                             sizeof( header ),
+                             "HTTP/1.1 %s\r\n"
+                             "Content-Length: %lu\r\n"
+                             "Content-Type: application/octet-stream\r\n"
+                             "Connection: %s\r\n\r\n",
+                             pStatus,
+                             bodyLength,
+                             keepAlive ? "keep-alive" : "close" );
+
+    if( IotBenchLoopback.send( pHttpConnection->pConnection,
+                               ( const uint8_t * ) header,
+                               ( size_t ) headerLength ) != ( size_t ) headerLength )
+    {
+        keepAlive = false;
+    }
+
+    while( ( keepAlive == true ) && ( bodySent < bodyLength ) )
+    {
+        chunk = bodyLength - bodySent;
+
+        if( chunk > _BODY_BLOCK_SIZE )
+        {
+            chunk = _BODY_BLOCK_SIZE;
+        }
+
+        if( IotBenchLoopback.send( pHttpConnection->pConnection, _bodyBlock, chunk ) != chunk )
+        {
+            keepAlive = false;
+        }
+
+        bodySent += chunk;
+    }
+
+    return keepAlive;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive callback of the connections. Reads what is available and
+ * answers every complete request head.
+ */
+static void _httpReceiveCallback( void * pConnection,
+                                  void * pContext )
+{
+    _httpConnection_t * pHttpConnection = pContext;
+    size_t bytesReceived = 0, headLength = 0;
+    char * pEnd = NULL;
+    bool status = true;
+
+    if( pHttpConnection->requestLength >= IOT_BENCH_HTTP_MAX_REQUEST_SIZE )
+    {
+        status = false;
+    }
+    else
+    {
+        bytesReceived = IotBenchLoopback.receiveUpto( pConnection,
+                                                      ( uint8_t * ) pHttpConnection->request + pHttpConnection->requestLength,
+                                                      IOT_BENCH_HTTP_MAX_REQUEST_SIZE - pHttpConnection->requestLength );
+
+        /* Nothing to receive means the client closed the connection. */
+        if( bytesReceived == 0U )
+        {
+            status = false;
+        }
+
+        pHttpConnection->requestLength += bytesReceived;
+        pHttpConnection->request[ pHttpConnection->requestLength ] = '\0';
+    }
+
+    while( status == true )
+    {
+        pEnd = strstr( pHttpConnection->request, "\r\n\r\n" );
+
+        if( pEnd == NULL )
+        {
+            break;
+        }
+
+        headLength = ( size_t ) ( pEnd - pHttpConnection->request ) + 4U;
+        status = _respond( pHttpConnection );
+
+        /* Keep pipelined requests. */
+        ( void ) memmove( pHttpConnection->request,
+                          pHttpConnection->request + headLength,
+                          pHttpConnection->requestLength - headLength + 1U );
+        pHttpConnection->requestLength -= headLength;
+    }
+
+    if( status == false )
+    {
+        vTaskSuspendAll();
+        pHttpConnection->pConnection = NULL;
+        ( void ) xTaskResumeAll();
+
+        ( void ) IotBenchLoopback.close( pConnection );
+        ( void ) IotBenchLoopback.destroy( pConnection );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Accept callback of the server port.
+ */
+static bool _httpAccept( void * pServerConnection,
+                         void * pContext )
+{
+    _httpConnection_t * pHttpConnection = NULL;
+    size_t i = 0;
+
+    ( void ) pContext;
+
+    vTaskSuspendAll();
+    {
+        for( i = 0; i < IOT_BENCH_HTTP_MAX_CONNECTIONS; i++ )
+        {
+            if( _connections[ i ].pConnection == NULL )
+            {
+                pHttpConnection = &( _connections[ i ] );
+                pHttpConnection->pConnection = pServerConnection;
+                pHttpConnection->requestLength = 0;
+                break;
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    if( pHttpConnection == NULL )
+    {
+        return false;
+    }
+
+    if( IotBenchLoopback.setReceiveCallback( pServerConnection,
+                                             _httpReceiveCallback,
+                                             pHttpConnection ) != IOT_NETWORK_SUCCESS )
+    {
+        pHttpConnection->pConnection = NULL;
+
+        return false;
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotBenchHttpServer_Start( uint16_t port )
+{
+    size_t i = 0;
+
+    for( i = 0; i < _BODY_BLOCK_SIZE; i++ )
+    {
+        _bodyBlock[ i ] = ( uint8_t ) ( 'a' + ( i % 26U ) );
+    }
+
+    return IotBenchLoopback_Listen( port, _httpAccept, NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBenchHttpServer_Stop( uint16_t port )
+{
+    IotBenchLoopback_StopListening( port );
+}
@@ -0,0 +1,194 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_https.c
+ * @brief HTTPS download scenario.
+ *
+ * Downloads a body of a fixed size per request over one persistent
+ * connection to the loopback HTTP server. The connection does not use TLS,
+ * so the scenario measures the HTTP client itself.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* SDK include. */
+#include "iot_config.h"
+
+/* HTTPS Client include. */
+#include "iot_https_client.h"
+
+/* Benchmark includes. */
+#include "iot_bench.h"
+#include "iot_bench_loopback.h"
+#include "iot_bench_servers.h"
+
+/**
+ * @brief Size of each downloaded body.
+ */
+#ifndef IOT_BENCH_HTTPS_BODY_SIZE
+    #define IOT_BENCH_HTTPS_BODY_SIZE    ( 16384 )
+#endif
+
+/**
+ * @brief Size of the connection, request and response user buffers.
+ */
+#ifndef IOT_BENCH_HTTPS_USER_BUFFER_SIZE
+    #define IOT_BENCH_HTTPS_USER_BUFFER_SIZE    ( 1024 )
+#endif
+
+/**
+ * @brief Timeout of a request.
+ */
+#ifndef IOT_BENCH_HTTPS_TIMEOUT_MS
+    #define IOT_BENCH_HTTPS_TIMEOUT_MS    ( 5000 )
+#endif
+
+/**
+ * @brief Host name sent in the requests.
+ */
+#define _HOST    "localhost"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Buffers given to the HTTPS Client library.
+ */
+/**@{ */
+static uint8_t _connectionBuffer[ IOT_BENCH_HTTPS_USER_BUFFER_SIZE ];
+static uint8_t _requestBuffer[ IOT_BENCH_HTTPS_USER_BUFFER_SIZE ];
+static uint8_t _responseBuffer[ IOT_BENCH_HTTPS_USER_BUFFER_SIZE ];
+static uint8_t _bodyBuffer[ IOT_BENCH_HTTPS_BODY_SIZE ];
+/**@} */
+
+/*-----------------------------------------------------------*/
+
+void IotBench_HttpsDownload( size_t iterations )
+{
+    IotBenchResult_t result = { 0 };
+    IotHttpsConnectionHandle_t connection = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsRequestHandle_t request = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    IotHttpsResponseHandle_t response = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    IotHttpsConnectionInfo_t connectionInfo = IOT_HTTPS_CONNECTION_INFO_INITIALIZER;
+    IotHttpsRequestInfo_t requestInfo = IOT_HTTPS_REQUEST_INFO_INITIALIZER;
+    IotHttpsResponseInfo_t responseInfo = IOT_HTTPS_RESPONSE_INFO_INITIALIZER;
+    IotHttpsSyncInfo_t requestSyncInfo = IOT_HTTPS_SYNC_INFO_INITIALIZER;
+    IotHttpsSyncInfo_t responseSyncInfo = IOT_HTTPS_SYNC_INFO_INITIALIZER;
+    char path[ 16 ] = { 0 };
+    const char * pSetupFailure = NULL;
+    bool connected = false;
+    uint16_t status = 0;
+    uint64_t startUs = 0;
+    size_t i = 0;
+
+    ( void ) snprintf( path, sizeof( path ), "/%u", ( unsigned ) IOT_BENCH_HTTPS_BODY_SIZE );
+
+    connectionInfo.pAddress = _HOST;
+    connectionInfo.addressLen = sizeof( _HOST ) - 1;
+    connectionInfo.port = IOT_BENCH_HTTP_PORT;
+    connectionInfo.flags = IOT_HTTPS_IS_NON_TLS_FLAG;
+    connectionInfo.timeout = IOT_BENCH_HTTPS_TIMEOUT_MS;
+    connectionInfo.userBuffer.pBuffer = _connectionBuffer;
+    connectionInfo.userBuffer.bufferLen = sizeof( _connectionBuffer );
+    connectionInfo.pNetworkInterface = &IotBenchLoopback;
+
+    requestInfo.pPath = path;
+    requestInfo.pathLen = ( uint32_t ) strlen( path );
+    requestInfo.method = IOT_HTTPS_METHOD_GET;
+    requestInfo.pHost = _HOST;
+    requestInfo.hostLen = sizeof( _HOST ) - 1;
+    requestInfo.isNonPersistent = false;
+    requestInfo.userBuffer.pBuffer = _requestBuffer;
+    requestInfo.userBuffer.bufferLen = sizeof( _requestBuffer );
+    requestInfo.isAsync = false;
+    requestInfo.u.pSyncInfo = &requestSyncInfo;
+
+    responseSyncInfo.pBody = _bodyBuffer;
+    responseSyncInfo.bodyLen = sizeof( _bodyBuffer );
+    responseInfo.userBuffer.pBuffer = _responseBuffer;
+    responseInfo.userBuffer.bufferLen = sizeof( _responseBuffer );
+    responseInfo.pSyncInfo = &responseSyncInfo;
+
+    /* The connection is set up before measuring. */
+    if( IotBenchHttpServer_Start( IOT_BENCH_HTTP_PORT ) == false )
+    {
+        pSetupFailure = "server did not start";
+    }
+    else if( IotHttpsClient_Connect( &connection, &connectionInfo ) != IOT_HTTPS_OK )
+    {
+        pSetupFailure = "connect failed";
+    }
+    else
+    {
+        connected = true;
+    }
+
+    IotBench_Start( &result, "https_download_16k", iterations );
+
+    if( pSetupFailure != NULL )
+    {
+        IotBench_Fail( &result, pSetupFailure );
+    }
+
+    for( i = 0; ( i < iterations ) && ( result.pFailure == NULL ); i++ )
+    {
+        startUs = IotBench_NowUs();
+
+        if( IotHttpsClient_InitializeRequest( &request, &requestInfo ) != IOT_HTTPS_OK )
+        {
+            IotBench_Fail( &result, "request not initialized" );
+        }
+        else if( IotHttpsClient_SendSync( connection,
+                                          request,
+                                          &response,
+                                          &responseInfo,
+                                          IOT_BENCH_HTTPS_TIMEOUT_MS ) != IOT_HTTPS_OK )
+        {
+            IotBench_Fail( &result, "request failed" );
+        }
+        else if( ( IotHttpsClient_ReadResponseStatus( response, &status ) != IOT_HTTPS_OK ) ||
+                 ( status != IOT_HTTPS_STATUS_OK ) )
+        {
+            IotBench_Fail( &result, "unexpected status" );
+        }
+        else
+        {
+            IotBench_Sample( &result,
+                             ( uint32_t ) ( IotBench_NowUs() - startUs ),
+                             IOT_BENCH_HTTPS_BODY_SIZE );
+        }
+    }
+
+    IotBench_Stop( &result );
+
+    if( connected == true )
+    {
+        ( void ) IotHttpsClient_Disconnect( connection );
+    }
+
+    IotBenchHttpServer_Stop( IOT_BENCH_HTTP_PORT );
+}
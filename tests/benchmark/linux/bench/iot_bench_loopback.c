@@ -0,0 +1,738 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_loopback.c
+ * @brief Implements the loopback network stack of the benchmarks.
+ *
+ * A connection is a pair of endpoints. Each endpoint owns a ring buffer of the
+ * bytes sent to it by its peer, and runs a receive task while a receive
+ * callback is set, following iot_network_freertos.c.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "event_groups.h"
+#include "semphr.h"
+#include "task.h"
+
+/* Loopback include. */
+#include "iot_bench_loopback.h"
+
+/**
+ * @brief Bytes buffered by each endpoint of a connection.
+ */
+#ifndef IOT_BENCH_LOOPBACK_BUFFER_SIZE
+    #define IOT_BENCH_LOOPBACK_BUFFER_SIZE    ( 65536 )
+#endif
+
+/**
+ * @brief Number of ports that can listen at the same time.
+ */
+#ifndef IOT_BENCH_LOOPBACK_MAX_LISTENERS
+    #define IOT_BENCH_LOOPBACK_MAX_LISTENERS    ( 4 )
+#endif
+
+/**
+ * @brief Stack size and priority of the receive tasks.
+ */
+#ifndef IOT_BENCH_LOOPBACK_TASK_STACK_SIZE
+    #define IOT_BENCH_LOOPBACK_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 2 )
+#endif
+#ifndef IOT_BENCH_LOOPBACK_TASK_PRIORITY
+    #define IOT_BENCH_LOOPBACK_TASK_PRIORITY    ( tskIDLE_PRIORITY + 5 )
+#endif
+
+/**
+ * @brief The event group bit set when an endpoint is closed.
+ */
+#define _FLAG_SHUTDOWN                ( 1 )
+
+/**
+ * @brief The event group bit set when an endpoint's receive task exits.
+ */
+#define _FLAG_RECEIVE_TASK_EXITED     ( 2 )
+
+/**
+ * @brief The event group bit set when the endpoint is destroyed from its
+ * receive task.
+ */
+#define _FLAG_CONNECTION_DESTROYED    ( 4 )
+
+/**
+ * @brief The event group bit set when bytes are added to an endpoint.
+ */
+#define _FLAG_DATA                    ( 8 )
+
+/**
+ * @brief The event group bit set when bytes are removed from an endpoint.
+ */
+#define _FLAG_SPACE                   ( 16 )
+
+/**
+ * @brief The event group bit set when the peer of an endpoint is closed.
+ */
+#define _FLAG_PEER_CLOSED             ( 32 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief One end of a loopback connection.
+ */
+typedef struct _loopbackEndpoint
+{
+    struct _loopbackEndpoint * pPeer;            /**< @brief The other end of the connection. */
+    struct _loopbackPair * pPair;                /**< @brief The allocation holding both ends. */
+    StaticSemaphore_t bufferMutex;               /**< @brief Protects the buffer. */
+    StaticEventGroup_t connectionFlags;          /**< @brief Synchronizes senders, receivers and the receive task. */
+    TaskHandle_t receiveTask;                    /**< @brief Handle of the receive task, if any. */
+    IotNetworkReceiveCallback_t receiveCallback; /**< @brief Network receive callback, if any. */
+    void * pReceiveContext;                      /**< @brief The context for the receive callback. */
+    size_t bufferHead;                           /**< @brief Index of the first buffered byte. */
+    size_t bufferedBytes;                        /**< @brief Number of buffered bytes. */
+    uint8_t buffer[ IOT_BENCH_LOOPBACK_BUFFER_SIZE ]; /**< @brief Bytes sent by the peer. */
+} _loopbackEndpoint_t;
+
+/**
+ * @brief Both ends of a loopback connection, freed when both are destroyed.
+ */
+typedef struct _loopbackPair
+{
+    _loopbackEndpoint_t client;  /**< @brief The end returned by create. */
+    _loopbackEndpoint_t server;  /**< @brief The end passed to the accept callback. */
+    UBaseType_t referenceCount;  /**< @brief Number of ends not destroyed. */
+} _loopbackPair_t;
+
+/**
+ * @brief A port accepting connections.
+ */
+typedef struct _loopbackListener
+{
+    uint16_t port;                           /**< @brief Listening port; 0 if the entry is free. */
+    IotBenchAcceptCallback_t acceptCallback; /**< @brief Called for new connections. */
+    void * pContext;                         /**< @brief Passed to the accept callback. */
+} _loopbackListener_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Listening ports, protected by suspending the scheduler.
+ */
+static _loopbackListener_t _listeners[ IOT_BENCH_LOOPBACK_MAX_LISTENERS ] = { { 0 } };
+
+/*-----------------------------------------------------------*/
+
+static IotNetworkError_t _loopbackCreate( void * pConnectionInfo,
+                                          void * pCredentialInfo,
+                                          void ** pConnection );
+static IotNetworkError_t _loopbackSetReceiveCallback( void * pConnection,
+                                                      IotNetworkReceiveCallback_t receiveCallback,
+                                                      void * pContext );
+static size_t _loopbackSend( void * pConnection,
+                             const uint8_t * pMessage,
+                             size_t messageLength );
+static size_t _loopbackReceive( void * pConnection,
+                                uint8_t * pBuffer,
+                                size_t bytesRequested );
+static size_t _loopbackReceiveUpto( void * pConnection,
+                                    uint8_t * pBuffer,
+                                    size_t bufferSize );
+static IotNetworkError_t _loopbackClose( void * pConnection );
+static IotNetworkError_t _loopbackDestroy( void * pConnection );
+static size_t _loopbackSendv( void * pConnection,
+                              const IotNetworkSegment_t * pSegments,
+                              size_t segmentCount );
+
+/*-----------------------------------------------------------*/
+
+const IotNetworkInterface_t IotBenchLoopback =
+{
+    .create             = _loopbackCreate,
+    .setReceiveCallback = _loopbackSetReceiveCallback,
+    .send               = _loopbackSend,
+    .receive            = _loopbackReceive,
+    .receiveUpto        = _loopbackReceiveUpto,
+    .close              = _loopbackClose,
+    .destroy            = _loopbackDestroy,
+    .sendv              = _loopbackSendv
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialize one end of a connection.
+ *
+ * @param[in] pEndpoint The end to initialize.
+ * @param[in] pPeer The other end.
+ * @param[in] pPair The allocation holding both ends.
+ */
+static void _initEndpoint( _loopbackEndpoint_t * pEndpoint,
+                           _loopbackEndpoint_t * pPeer,
+                           _loopbackPair_t * pPair )
+{
+    pEndpoint->pPeer = pPeer;
+    pEndpoint->pPair = pPair;
+    pEndpoint->receiveTask = NULL;
+    pEndpoint->receiveCallback = NULL;
+    pEndpoint->pReceiveContext = NULL;
+    pEndpoint->bufferHead = 0;
+    pEndpoint->bufferedBytes = 0;
+
+    ( void ) xSemaphoreCreateMutexStatic( &( pEndpoint->bufferMutex ) );
+    ( void ) xEventGroupCreateStatic( &( pEndpoint->connectionFlags ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the flags of an endpoint.
+ */
+static EventBits_t _getFlags( _loopbackEndpoint_t * pEndpoint )
+{
+    return xEventGroupGetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the number of bytes buffered by an endpoint.
+ */
+static size_t _bufferedBytes( _loopbackEndpoint_t * pEndpoint )
+{
+    size_t bufferedBytes = 0;
+
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ), portMAX_DELAY );
+    bufferedBytes = pEndpoint->bufferedBytes;
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ) );
+
+    return bufferedBytes;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy bytes into the buffer of an endpoint, without waiting for space.
+ *
+ * @return The number of bytes copied.
+ */
+static size_t _putBytes( _loopbackEndpoint_t * pEndpoint,
+                         const uint8_t * pData,
+                         size_t dataLength )
+{
+    size_t copied = 0, chunk = 0, tail = 0;
+
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ), portMAX_DELAY );
+
+    while( ( copied < dataLength ) && ( pEndpoint->bufferedBytes < IOT_BENCH_LOOPBACK_BUFFER_SIZE ) )
+    {
+        tail = ( pEndpoint->bufferHead + pEndpoint->bufferedBytes ) % IOT_BENCH_LOOPBACK_BUFFER_SIZE;
+        chunk = IOT_BENCH_LOOPBACK_BUFFER_SIZE - pEndpoint->bufferedBytes;
+
+        if( chunk > ( IOT_BENCH_LOOPBACK_BUFFER_SIZE - tail ) )
+        {
+            chunk = IOT_BENCH_LOOPBACK_BUFFER_SIZE - tail;
+        }
+
+        if( chunk > ( dataLength - copied ) )
+        {
+            chunk = dataLength - copied;
+        }
+
+        ( void ) memcpy( pEndpoint->buffer + tail, pData + copied, chunk );
+        pEndpoint->bufferedBytes += chunk;
+        copied += chunk;
+    }
+
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ) );
+
+    if( copied > 0U )
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                     _FLAG_DATA );
+    }
+
+    return copied;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy bytes out of the buffer of an endpoint, without waiting for
+ * data.
+ *
+ * @return The number of bytes copied.
+ */
+static size_t _takeBytes( _loopbackEndpoint_t * pEndpoint,
+                          uint8_t * pBuffer,
+                          size_t bufferSize )
+{
+    size_t copied = 0, chunk = 0;
+
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ), portMAX_DELAY );
+
+    while( ( copied < bufferSize ) && ( pEndpoint->bufferedBytes > 0U ) )
+    {
+        chunk = IOT_BENCH_LOOPBACK_BUFFER_SIZE - pEndpoint->bufferHead;
+
+        if( chunk > pEndpoint->bufferedBytes )
+        {
+            chunk = pEndpoint->bufferedBytes;
+        }
+
+        if( chunk > ( bufferSize - copied ) )
+        {
+            chunk = bufferSize - copied;
+        }
+
+        ( void ) memcpy( pBuffer + copied, pEndpoint->buffer + pEndpoint->bufferHead, chunk );
+        pEndpoint->bufferHead = ( pEndpoint->bufferHead + chunk ) % IOT_BENCH_LOOPBACK_BUFFER_SIZE;
+        pEndpoint->bufferedBytes -= chunk;
+        copied += chunk;
+    }
+
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pEndpoint->bufferMutex ) );
+
+    if( copied > 0U )
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                     _FLAG_SPACE );
+    }
+
+    return copied;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Drop a reference to a connection, freeing it with the last one.
+ */
+static void _releasePair( _loopbackPair_t * pPair )
+{
+    UBaseType_t referenceCount = 0;
+
+    vTaskSuspendAll();
+    {
+        pPair->referenceCount--;
+        referenceCount = pPair->referenceCount;
+    }
+    ( void ) xTaskResumeAll();
+
+    if( referenceCount == 0U )
+    {
+        free( pPair );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Task routine that invokes the receive callback of an endpoint while
+ * it has buffered bytes.
+ *
+ * The callback is invoked again as long as it consumes bytes, then the task
+ * waits for the peer to send more. The task exits when the endpoint is
+ * closed or the peer is closed and all bytes were consumed.
+ *
+ * @param[in] pArgument The endpoint.
+ */
+static void _receiveTask( void * pArgument )
+{
+    _loopbackEndpoint_t * pEndpoint = pArgument;
+    EventBits_t connectionFlags = 0;
+    size_t before = 0, after = 0;
+    bool destroyConnection = false;
+
+    while( destroyConnection == false )
+    {
+        connectionFlags = xEventGroupWaitBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                               _FLAG_DATA | _FLAG_SHUTDOWN | _FLAG_PEER_CLOSED,
+                                               pdFALSE,
+                                               pdFALSE,
+                                               portMAX_DELAY );
+        ( void ) xEventGroupClearBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                       _FLAG_DATA );
+
+        if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+        {
+            break;
+        }
+
+        after = _bufferedBytes( pEndpoint );
+
+        do
+        {
+            before = after;
+
+            if( before == 0U )
+            {
+                break;
+            }
+
+            pEndpoint->receiveCallback( pEndpoint, pEndpoint->pReceiveContext );
+
+            if( ( _getFlags( pEndpoint ) & _FLAG_CONNECTION_DESTROYED ) == _FLAG_CONNECTION_DESTROYED )
+            {
+                destroyConnection = true;
+            }
+            else
+            {
+                after = _bufferedBytes( pEndpoint );
+            }
+        } while( ( destroyConnection == false ) &&
+                 ( after < before ) &&
+                 ( ( _getFlags( pEndpoint ) & _FLAG_SHUTDOWN ) == 0 ) );
+
+        /* Nothing more will arrive once the peer is closed. Like a socket
+         * that polls readable at end of stream, the callback is invoked once
+         * more with nothing to receive, so that it can clean up. */
+        if( ( destroyConnection == false ) &&
+            ( ( connectionFlags & _FLAG_PEER_CLOSED ) == _FLAG_PEER_CLOSED ) &&
+            ( after == before ) )
+        {
+            if( ( after == 0U ) && ( ( _getFlags( pEndpoint ) & _FLAG_SHUTDOWN ) == 0 ) )
+            {
+                pEndpoint->receiveCallback( pEndpoint, pEndpoint->pReceiveContext );
+
+                if( ( _getFlags( pEndpoint ) & _FLAG_CONNECTION_DESTROYED ) == _FLAG_CONNECTION_DESTROYED )
+                {
+                    destroyConnection = true;
+                }
+            }
+
+            break;
+        }
+    }
+
+    if( destroyConnection == true )
+    {
+        _releasePair( pEndpoint->pPair );
+    }
+    else
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                     _FLAG_RECEIVE_TASK_EXITED );
+    }
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+static IotNetworkError_t _loopbackCreate( void * pConnectionInfo,
+                                          void * pCredentialInfo,
+                                          void ** pConnection )
+{
+    const IotNetworkServerInfo_t * pServerInfo = pConnectionInfo;
+    _loopbackListener_t listener = { 0 };
+    _loopbackPair_t * pPair = NULL;
+    size_t i = 0;
+
+    ( void ) pCredentialInfo;
+
+    vTaskSuspendAll();
+    {
+        for( i = 0; i < IOT_BENCH_LOOPBACK_MAX_LISTENERS; i++ )
+        {
+            if( _listeners[ i ].port == pServerInfo->port )
+            {
+                listener = _listeners[ i ];
+                break;
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    if( listener.port == 0U )
+    {
+        return IOT_NETWORK_FAILURE;
+    }
+
+    /* Buffers of a socket are not on the device heap, so the connection is
+     * not counted in the heap statistics of the benchmarks. */
+    pPair = malloc( sizeof( _loopbackPair_t ) );
+
+    if( pPair == NULL )
+    {
+        return IOT_NETWORK_NO_MEMORY;
+    }
+
+    _initEndpoint( &( pPair->client ), &( pPair->server ), pPair );
+    _initEndpoint( &( pPair->server ), &( pPair->client ), pPair );
+    pPair->referenceCount = 2;
+
+    if( listener.acceptCallback( &( pPair->server ), listener.pContext ) == false )
+    {
+        free( pPair );
+
+        return IOT_NETWORK_FAILURE;
+    }
+
+    *pConnection = &( pPair->client );
+
+    return IOT_NETWORK_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotNetworkError_t _loopbackSetReceiveCallback( void * pConnection,
+                                                      IotNetworkReceiveCallback_t receiveCallback,
+                                                      void * pContext )
+{
+    _loopbackEndpoint_t * pEndpoint = pConnection;
+
+    /* Only one receive task is created per endpoint. */
+    configASSERT( pEndpoint->receiveTask == NULL );
+
+    pEndpoint->receiveCallback = receiveCallback;
+    pEndpoint->pReceiveContext = pContext;
+
+    if( xTaskCreate( _receiveTask,
+                     "LoopbackRecv",
+                     IOT_BENCH_LOOPBACK_TASK_STACK_SIZE,
+                     pEndpoint,
+                     IOT_BENCH_LOOPBACK_TASK_PRIORITY,
+                     &( pEndpoint->receiveTask ) ) != pdPASS )
+    {
+        pEndpoint->receiveTask = NULL;
+
+        return IOT_NETWORK_SYSTEM_ERROR;
+    }
+
+    return IOT_NETWORK_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _loopbackSend( void * pConnection,
+                             const uint8_t * pMessage,
+                             size_t messageLength )
+{
+    _loopbackEndpoint_t * pPeer = ( ( _loopbackEndpoint_t * ) pConnection )->pPeer;
+    size_t bytesSent = 0, copied = 0;
+
+    while( bytesSent < messageLength )
+    {
+        /* Clear before checking for space, so that space made after the check
+         * is not missed. */
+        ( void ) xEventGroupClearBits( ( EventGroupHandle_t ) &( pPeer->connectionFlags ),
+                                       _FLAG_SPACE );
+
+        if( ( _getFlags( pPeer ) & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+        {
+            break;
+        }
+
+        copied = _putBytes( pPeer, pMessage + bytesSent, messageLength - bytesSent );
+        bytesSent += copied;
+
+        if( ( copied == 0U ) && ( bytesSent < messageLength ) )
+        {
+            ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pPeer->connectionFlags ),
+                                          _FLAG_SPACE | _FLAG_SHUTDOWN,
+                                          pdFALSE,
+                                          pdFALSE,
+                                          portMAX_DELAY );
+        }
+    }
+
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _loopbackReceive( void * pConnection,
+                                uint8_t * pBuffer,
+                                size_t bytesRequested )
+{
+    _loopbackEndpoint_t * pEndpoint = pConnection;
+    size_t bytesReceived = 0;
+
+    while( bytesReceived < bytesRequested )
+    {
+        ( void ) xEventGroupClearBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                       _FLAG_DATA );
+
+        bytesReceived += _takeBytes( pEndpoint,
+                                     pBuffer + bytesReceived,
+                                     bytesRequested - bytesReceived );
+
+        if( bytesReceived < bytesRequested )
+        {
+            if( ( _getFlags( pEndpoint ) & ( _FLAG_SHUTDOWN | _FLAG_PEER_CLOSED ) ) != 0 )
+            {
+                /* Take what the peer sent before closing. */
+                bytesReceived += _takeBytes( pEndpoint,
+                                             pBuffer + bytesReceived,
+                                             bytesRequested - bytesReceived );
+                break;
+            }
+
+            ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                          _FLAG_DATA | _FLAG_SHUTDOWN | _FLAG_PEER_CLOSED,
+                                          pdFALSE,
+                                          pdFALSE,
+                                          portMAX_DELAY );
+        }
+    }
+
+    return bytesReceived;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _loopbackReceiveUpto( void * pConnection,
+                                    uint8_t * pBuffer,
+                                    size_t bufferSize )
+{
+    return _takeBytes( pConnection, pBuffer, bufferSize );
+}
+
+/*-----------------------------------------------------------*/
+
+static IotNetworkError_t _loopbackClose( void * pConnection )
+{
+    _loopbackEndpoint_t * pEndpoint = pConnection;
+
+    ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                 _FLAG_SHUTDOWN );
+    ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->pPeer->connectionFlags ),
+                                 _FLAG_PEER_CLOSED );
+
+    return IOT_NETWORK_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotNetworkError_t _loopbackDestroy( void * pConnection )
+{
+    _loopbackEndpoint_t * pEndpoint = pConnection;
+
+    /* Check if this function is being called from the receive task. */
+    if( xTaskGetCurrentTaskHandle() == pEndpoint->receiveTask )
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                     _FLAG_CONNECTION_DESTROYED );
+    }
+    else
+    {
+        /* If a receive task was created, wait for it to exit. */
+        if( pEndpoint->receiveTask != NULL )
+        {
+            ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pEndpoint->connectionFlags ),
+                                          _FLAG_RECEIVE_TASK_EXITED,
+                                          pdTRUE,
+                                          pdTRUE,
+                                          portMAX_DELAY );
+        }
+
+        _releasePair( pEndpoint->pPair );
+    }
+
+    return IOT_NETWORK_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _loopbackSendv( void * pConnection,
+                              const IotNetworkSegment_t * pSegments,
+                              size_t segmentCount )
+{
+    size_t bytesSent = 0, segmentSent = 0, i = 0;
+
+    for( i = 0; i < segmentCount; i++ )
+    {
+        segmentSent = _loopbackSend( pConnection,
+                                     pSegments[ i ].pData,
+                                     pSegments[ i ].dataLength );
+        bytesSent += segmentSent;
+
+        if( segmentSent != pSegments[ i ].dataLength )
+        {
+            break;
+        }
+    }
+
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotBenchLoopback_Listen( uint16_t port,
+                              IotBenchAcceptCallback_t acceptCallback,
+                              void * pContext )
+{
+    bool status = false;
+    size_t i = 0, freeIndex = IOT_BENCH_LOOPBACK_MAX_LISTENERS;
+
+    vTaskSuspendAll();
+    {
+        for( i = 0; i < IOT_BENCH_LOOPBACK_MAX_LISTENERS; i++ )
+        {
+            if( _listeners[ i ].port == port )
+            {
+                freeIndex = IOT_BENCH_LOOPBACK_MAX_LISTENERS;
+                break;
+            }
+            else if( ( _listeners[ i ].port == 0U ) && ( freeIndex == IOT_BENCH_LOOPBACK_MAX_LISTENERS ) )
+            {
+                freeIndex = i;
+            }
+        }
+
+        if( ( port != 0U ) && ( freeIndex < IOT_BENCH_LOOPBACK_MAX_LISTENERS ) )
+        {
+            _listeners[ freeIndex ].port = port;
+            _listeners[ freeIndex ].acceptCallback = acceptCallback;
+            _listeners[ freeIndex ].pContext = pContext;
+            status = true;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBenchLoopback_StopListening( uint16_t port )
+{
+    size_t i = 0;
+
+    vTaskSuspendAll();
+    {
+        for( i = 0; i < IOT_BENCH_LOOPBACK_MAX_LISTENERS; i++ )
+        {
+            if( _listeners[ i ].port == port )
+            {
+                _listeners[ i ].port = 0;
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+}
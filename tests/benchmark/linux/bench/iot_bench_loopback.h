@@ -0,0 +1,85 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_loopback.h
+ * @brief An in-process network stack connecting the libraries to the
+ * benchmark servers.
+ */
+
+#ifndef IOT_BENCH_LOOPBACK_H_
+#define IOT_BENCH_LOOPBACK_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Platform network include. */
+#include "platform/iot_network.h"
+
+/**
+ * @brief Function called when a client connects to a listening port.
+ *
+ * @param[in] pServerConnection The server end of the new connection. It is
+ * used with #IotBenchLoopback like any other connection and must be closed
+ * and destroyed by the server.
+ * @param[in] pContext The context passed to #IotBenchLoopback_Listen.
+ *
+ * @return `true` to accept the connection; `false` to refuse it.
+ */
+typedef bool ( * IotBenchAcceptCallback_t )( void * pServerConnection,
+                                             void * pContext );
+
+/**
+ * @brief The network interface of the loopback stack.
+ *
+ * #IotNetworkInterface_t.create takes an #IotNetworkServerInfo_t; only its
+ * port is used. Credentials are ignored.
+ */
+extern const IotNetworkInterface_t IotBenchLoopback;
+
+/**
+ * @brief Accept loopback connections on a port.
+ *
+ * @param[in] port The port clients connect to.
+ * @param[in] acceptCallback Called in the connecting thread for every new
+ * connection.
+ * @param[in] pContext Passed to `acceptCallback`.
+ *
+ * @return `true` if the port was free; `false` otherwise.
+ */
+bool IotBenchLoopback_Listen( uint16_t port,
+                              IotBenchAcceptCallback_t acceptCallback,
+                              void * pContext );
+
+/**
+ * @brief Stop accepting connections on a port. Existing connections are not
+ * affected.
+ *
+ * @param[in] port A port passed to #IotBenchLoopback_Listen.
+ */
+void IotBenchLoopback_StopListening( uint16_t port );
+
+#endif /* ifndef IOT_BENCH_LOOPBACK_H_ */
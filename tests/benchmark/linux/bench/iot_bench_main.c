@@ -0,0 +1,260 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_main.c
+ * @brief Entry point of the benchmarks.
+ *
+ * Usage: iot_bench [--csv] [--iterations N] [--flash-image FILE] [filter]
+ *
+ * Runs every scenario whose name contains the filter, or all of them, in a
+ * FreeRTOS task and prints one report line per scenario.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* SDK includes. */
+#include "iot_config.h"
+#include "iot_init.h"
+#include "iot_mqtt.h"
+#include "iot_https_client.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/**
+ * @brief Stack size and priority of the task that runs the scenarios.
+ */
+#define IOT_BENCH_MAIN_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 4 )
+#define IOT_BENCH_MAIN_TASK_PRIORITY      ( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A scenario and the number of operations it runs by default.
+ */
+typedef struct _benchScenario
+{
+    const char * pName;           /**< @brief Name printed in the report, matched by the filter. */
+    IotBenchScenario_t function;  /**< @brief Function that runs and reports the scenario. */
+    size_t defaultIterations;     /**< @brief Number of operations without --iterations. */
+} _benchScenario_t;
+
+/**
+ * @brief All scenarios, in the order they run.
+ */
+static const _benchScenario_t _scenarios[] =
+{
+    { "mqtt_pubsub_qos0",           IotBench_MqttQos0,                 10000 },
+    { "mqtt_pubsub_qos1",           IotBench_MqttQos1,                 10000 },
+    { "mqtt_topic_match_scan",      IotBench_MqttTopicMatchScan,       20000 },
+    { "mqtt_topic_match_trie",      IotBench_MqttTopicMatchTrie,       20000 },
+    { "https_download_16k",         IotBench_HttpsDownload,            1000  },
+    { "taskpool_schedule",          IotBench_TaskPoolSchedule,         20000 },
+    { "taskpool_schedule_deferred", IotBench_TaskPoolScheduleDeferred, 2000  },
+    { "json_encode",                IotBench_JsonEncode,               20000 },
+    { "json_decode",                IotBench_JsonDecode,               20000 },
+    { "cbor_encode",                IotBench_CborEncode,               20000 },
+    { "cbor_decode",                IotBench_CborDecode,               20000 },
+    { "ota_ingest",                 IotBench_OtaIngest,                8192  },
+    { "flash_log_writethrough",     IotBench_FlashLogWriteThrough,     2000  },
+    { "flash_log_cached",           IotBench_FlashLogCached,           2000  },
+    { "ftl_counter_gc_inline",      IotBench_FtlCounterGcInline,       5000  },
+    { "ftl_counter_gc_idle",        IotBench_FtlCounterGcIdle,         5000  }
+};
+
+/**
+ * @brief Options parsed from the command line.
+ */
+static struct
+{
+    bool csv;            /**< @brief Print comma separated values. */
+    size_t iterations;   /**< @brief Operations per scenario, or 0 for the defaults. */
+    const char * pFilter; /**< @brief Only run the scenarios whose name contains this, or NULL. */
+} _options = { 0 };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Task that initializes the libraries and runs the scenarios.
+ */
+static void _benchTask( void * pArgument )
+{
+    int status = EXIT_FAILURE;
+    size_t i = 0;
+
+    ( void ) pArgument;
+
+    if( IotSdk_Init() == false )
+    {
+        printf( "Failed to initialize the SDK.\n" );
+    }
+    else if( IotMqtt_Init() != IOT_MQTT_SUCCESS )
+    {
+        printf( "Failed to initialize MQTT.\n" );
+        IotSdk_Cleanup();
+    }
+    else if( IotHttpsClient_Init() != IOT_HTTPS_OK )
+    {
+        printf( "Failed to initialize HTTPS.\n" );
+        IotMqtt_Cleanup();
+        IotSdk_Cleanup();
+    }
+    else
+    {
+        IotBench_PrintHeader( _options.csv );
+
+        for( i = 0; i < ( sizeof( _scenarios ) / sizeof( _scenarios[ 0 ] ) ); i++ )
+        {
+            if( ( _options.pFilter == NULL ) || ( strstr( _scenarios[ i ].pName, _options.pFilter ) != NULL ) )
+            {
+                _scenarios[ i ].function( ( _options.iterations > 0U ) ?
+                                          _options.iterations : _scenarios[ i ].defaultIterations );
+            }
+        }
+
+        IotHttpsClient_Cleanup();
+        IotMqtt_Cleanup();
+        IotSdk_Cleanup();
+
+        /* A failed scenario fails the run, so that scripts comparing
+         * results do not compare its numbers. */
+        status = ( IotBench_FailedScenarios() == 0U ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* The scheduler of the POSIX port does not return, so exit from here. */
+    exit( status );
+}
+
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    int status = EXIT_SUCCESS;
+    int i = 0;
+
+    for( i = 1; ( i < argc ) && ( status == EXIT_SUCCESS ); i++ )
+    {
+        if( strcmp( argv[ i ], "--csv" ) == 0 )
+        {
+            _options.csv = true;
+        }
+        else if( ( strcmp( argv[ i ], "--iterations" ) == 0 ) && ( ( i + 1 ) < argc ) )
+        {
+            i++;
+            _options.iterations = ( size_t ) strtoul( argv[ i ], NULL, 10 );
+        }
+        else if( ( strcmp( argv[ i ], "--flash-image" ) == 0 ) && ( ( i + 1 ) < argc ) )
+        {
+            i++;
+            IotBench_SetFlashImage( argv[ i ] );
+        }
+        else if( ( argv[ i ][ 0 ] != '-' ) && ( _options.pFilter == NULL ) )
+        {
+            _options.pFilter = argv[ i ];
+        }
+        else
+        {
+            fprintf( stderr, "Usage: %s [--csv] [--iterations N] [--flash-image FILE] [filter]\n", argv[ 0 ] );
+            status = EXIT_FAILURE;
+        }
+    }
+
+    if( status == EXIT_SUCCESS )
+    {
+        if( xTaskCreate( _benchTask,
+                         "Bench",
+                         IOT_BENCH_MAIN_TASK_STACK_SIZE,
+                         NULL,
+                         IOT_BENCH_MAIN_TASK_PRIORITY,
+                         NULL ) != pdPASS )
+        {
+            fprintf( stderr, "Failed to create the benchmark task.\n" );
+            status = EXIT_FAILURE;
+        }
+        else
+        {
+            vTaskStartScheduler();
+
+            /* Only reached if the scheduler could not start. */
+            status = EXIT_FAILURE;
+        }
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook( void )
+{
+    fprintf( stderr, "Out of memory.\n" );
+    abort();
+}
+
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    uint32_t ulLine )
+{
+    fprintf( stderr, "Assertion failed in %s:%u.\n", pcFile, ( unsigned ) ulLine );
+    abort();
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    uint32_t * pulIdleTaskStackSize )
+{
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/*-----------------------------------------------------------*/
+
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     uint32_t * pulTimerTaskStackSize )
+{
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
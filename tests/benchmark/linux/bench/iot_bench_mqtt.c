@@ -0,0 +1,267 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_mqtt.c
+ * @brief MQTT publish and subscribe scenarios.
+ *
+ * The client subscribes to a topic and publishes to it through the loopback
+ * broker. Latency is measured from the call to IotMqtt_Publish to the
+ * delivery of the message back to the subscription callback. A window of
+ * messages in flight keeps the client and the broker from filling each
+ * other's buffers.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* SDK include. */
+#include "iot_config.h"
+
+/* MQTT include. */
+#include "iot_mqtt.h"
+
+/* Platform include. */
+#include "platform/iot_threads.h"
+
+/* Benchmark includes. */
+#include "iot_bench.h"
+#include "iot_bench_loopback.h"
+#include "iot_bench_servers.h"
+
+/**
+ * @brief Size of the published payloads.
+ */
+#ifndef IOT_BENCH_MQTT_PAYLOAD_SIZE
+    #define IOT_BENCH_MQTT_PAYLOAD_SIZE    ( 64 )
+#endif
+
+/**
+ * @brief Maximum number of messages published but not yet delivered back.
+ */
+#ifndef IOT_BENCH_MQTT_WINDOW
+    #define IOT_BENCH_MQTT_WINDOW    ( 8 )
+#endif
+
+/**
+ * @brief Timeout for MQTT operations and deliveries.
+ */
+#ifndef IOT_BENCH_MQTT_TIMEOUT_MS
+    #define IOT_BENCH_MQTT_TIMEOUT_MS    ( 5000 )
+#endif
+
+/**
+ * @brief The topic published and subscribed to.
+ */
+#define _TOPIC           "bench/topic"
+#define _TOPIC_LENGTH    ( ( uint16_t ) ( sizeof( _TOPIC ) - 1 ) )
+
+/**
+ * @brief The client identifier.
+ */
+#define _CLIENT_IDENTIFIER    "iot-bench"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief State shared with the subscription callback.
+ */
+typedef struct _mqttBenchContext
+{
+    IotBenchResult_t result; /**< @brief Measurements of the scenario. */
+    IotSemaphore_t window;   /**< @brief Counts the messages that may be published. */
+    uint64_t * pPublishUs;   /**< @brief Time at which each message was published. */
+    size_t iterations;       /**< @brief Number of messages to publish. */
+} _mqttBenchContext_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Subscription callback. Records the latency of the message, whose
+ * index is in the first bytes of the payload.
+ */
+static void _messageReceived( void * pCallbackContext,
+                              IotMqttCallbackParam_t * pCallbackParam )
+{
+    _mqttBenchContext_t * pContext = pCallbackContext;
+    const uint8_t * pPayload = pCallbackParam->u.message.info.pPayload;
+    uint64_t now = IotBench_NowUs();
+    uint32_t index = 0;
+
+    if( pCallbackParam->u.message.info.payloadLength >= sizeof( index ) )
+    {
+        ( void ) memcpy( &index, pPayload, sizeof( index ) );
+
+        if( index < pContext->iterations )
+        {
+            IotBench_Sample( &( pContext->result ),
+                             ( uint32_t ) ( now - pContext->pPublishUs[ index ] ),
+                             pCallbackParam->u.message.info.payloadLength );
+            IotSemaphore_Post( &( pContext->window ) );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Publish messages to a subscribed topic and wait for them to come
+ * back.
+ *
+ * @param[in] pName Scenario name.
+ * @param[in] qos QoS of the subscription and of the messages.
+ * @param[in] iterations Number of messages.
+ */
+static void _runPublishSubscribe( const char * pName,
+                                  IotMqttQos_t qos,
+                                  size_t iterations )
+{
+    _mqttBenchContext_t context = { 0 };
+    IotNetworkServerInfo_t serverInfo = { .pHostName = "localhost", .port = IOT_BENCH_MQTT_PORT };
+    IotMqttNetworkInfo_t networkInfo = IOT_MQTT_NETWORK_INFO_INITIALIZER;
+    IotMqttConnectInfo_t connectInfo = IOT_MQTT_CONNECT_INFO_INITIALIZER;
+    IotMqttSubscription_t subscription = IOT_MQTT_SUBSCRIPTION_INITIALIZER;
+    IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+    IotMqttConnection_t mqttConnection = IOT_MQTT_CONNECTION_INITIALIZER;
+    uint8_t payload[ IOT_BENCH_MQTT_PAYLOAD_SIZE ] = { 0 };
+    bool connected = false, windowCreated = false;
+    const char * pSetupFailure = NULL;
+    uint32_t index = 0;
+    size_t i = 0;
+
+    networkInfo.createNetworkConnection = true;
+    networkInfo.u.setup.pNetworkServerInfo = &serverInfo;
+    networkInfo.u.setup.pNetworkCredentialInfo = NULL;
+    networkInfo.pNetworkInterface = &IotBenchLoopback;
+
+    connectInfo.cleanSession = true;
+    connectInfo.keepAliveSeconds = 0;
+    connectInfo.pClientIdentifier = _CLIENT_IDENTIFIER;
+    connectInfo.clientIdentifierLength = ( uint16_t ) ( sizeof( _CLIENT_IDENTIFIER ) - 1 );
+
+    subscription.qos = qos;
+    subscription.pTopicFilter = _TOPIC;
+    subscription.topicFilterLength = _TOPIC_LENGTH;
+    subscription.callback.pCallbackContext = &context;
+    subscription.callback.function = _messageReceived;
+
+    publishInfo.qos = qos;
+    publishInfo.pTopicName = _TOPIC;
+    publishInfo.topicNameLength = _TOPIC_LENGTH;
+    publishInfo.pPayload = payload;
+    publishInfo.payloadLength = sizeof( payload );
+
+    context.iterations = iterations;
+    context.pPublishUs = calloc( iterations, sizeof( uint64_t ) );
+    windowCreated = IotSemaphore_Create( &( context.window ), IOT_BENCH_MQTT_WINDOW, IOT_BENCH_MQTT_WINDOW );
+
+    /* The connection and the subscription are set up before measuring. */
+    if( ( windowCreated == false ) || ( context.pPublishUs == NULL ) )
+    {
+        pSetupFailure = "out of memory";
+    }
+    else if( IotBenchMqttBroker_Start( IOT_BENCH_MQTT_PORT ) == false )
+    {
+        pSetupFailure = "broker did not start";
+    }
+    else if( IotMqtt_Connect( &networkInfo, &connectInfo, IOT_BENCH_MQTT_TIMEOUT_MS, &mqttConnection ) != IOT_MQTT_SUCCESS )
+    {
+        pSetupFailure = "CONNECT failed";
+    }
+    else
+    {
+        connected = true;
+
+        if( IotMqtt_TimedSubscribe( mqttConnection, &subscription, 1, 0, IOT_BENCH_MQTT_TIMEOUT_MS ) != IOT_MQTT_SUCCESS )
+        {
+            pSetupFailure = "SUBSCRIBE failed";
+        }
+    }
+
+    IotBench_Start( &( context.result ), pName, iterations );
+
+    if( pSetupFailure != NULL )
+    {
+        IotBench_Fail( &( context.result ), pSetupFailure );
+    }
+
+    for( i = 0; ( i < iterations ) && ( context.result.pFailure == NULL ); i++ )
+    {
+        if( IotSemaphore_TimedWait( &( context.window ), IOT_BENCH_MQTT_TIMEOUT_MS ) == false )
+        {
+            IotBench_Fail( &( context.result ), "message not delivered" );
+            break;
+        }
+
+        index = ( uint32_t ) i;
+        ( void ) memcpy( payload, &index, sizeof( index ) );
+        context.pPublishUs[ i ] = IotBench_NowUs();
+
+        if( IotMqtt_Publish( mqttConnection, &publishInfo, 0, NULL, NULL ) != IOT_MQTT_SUCCESS )
+        {
+            IotBench_Fail( &( context.result ), "PUBLISH failed" );
+        }
+    }
+
+    /* Wait for the last messages of the window. */
+    for( i = 0; ( i < IOT_BENCH_MQTT_WINDOW ) && ( context.result.pFailure == NULL ); i++ )
+    {
+        if( IotSemaphore_TimedWait( &( context.window ), IOT_BENCH_MQTT_TIMEOUT_MS ) == false )
+        {
+            IotBench_Fail( &( context.result ), "message not delivered" );
+        }
+    }
+
+    IotBench_Stop( &( context.result ) );
+
+    if( connected == true )
+    {
+        IotMqtt_Disconnect( mqttConnection, 0 );
+    }
+
+    IotBenchMqttBroker_Stop( IOT_BENCH_MQTT_PORT );
+
+    if( windowCreated == true )
+    {
+        IotSemaphore_Destroy( &( context.window ) );
+    }
+
+    free( context.pPublishUs );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_MqttQos0( size_t iterations )
+{
+    _runPublishSubscribe( "mqtt_pubsub_qos0", IOT_MQTT_QOS_0, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_MqttQos1( size_t iterations )
+{
+    _runPublishSubscribe( "mqtt_pubsub_qos1", IOT_MQTT_QOS_1, iterations );
+}
@@ -0,0 +1,689 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_mqtt_broker.c
+ * @brief A minimal MQTT broker for the benchmarks.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+/* Benchmark includes. */
+#include "iot_bench_loopback.h"
+#include "iot_bench_servers.h"
+
+/**
+ * @brief Maximum number of connected clients.
+ */
+#ifndef IOT_BENCH_BROKER_MAX_CLIENTS
+    #define IOT_BENCH_BROKER_MAX_CLIENTS    ( 8 )
+#endif
+
+/**
+ * @brief Maximum number of subscriptions of a client.
+ */
+#ifndef IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS
+    #define IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS    ( 8 )
+#endif
+
+/**
+ * @brief Maximum length of a topic filter.
+ */
+#ifndef IOT_BENCH_BROKER_MAX_FILTER_LENGTH
+    #define IOT_BENCH_BROKER_MAX_FILTER_LENGTH    ( 128 )
+#endif
+
+/**
+ * @brief Maximum size of a packet, without its fixed header. Larger packets
+ * close the connection.
+ */
+#ifndef IOT_BENCH_BROKER_MAX_PACKET_SIZE
+    #define IOT_BENCH_BROKER_MAX_PACKET_SIZE    ( 8192 )
+#endif
+
+/**
+ * @brief MQTT control packet types, in the high nibble of the first byte.
+ */
+/**@{ */
+#define _CONNECT        ( 0x10 )
+#define _CONNACK        ( 0x20 )
+#define _PUBLISH        ( 0x30 )
+#define _PUBACK         ( 0x40 )
+#define _SUBSCRIBE      ( 0x80 )
+#define _SUBACK         ( 0x90 )
+#define _UNSUBSCRIBE    ( 0xa0 )
+#define _UNSUBACK       ( 0xb0 )
+#define _PINGREQ        ( 0xc0 )
+#define _PINGRESP       ( 0xd0 )
+#define _DISCONNECT     ( 0xe0 )
+/**@} */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A subscription of a client.
+ */
+typedef struct _brokerSubscription
+{
+    uint16_t filterLength;                                /**< @brief Length of the filter; 0 if unused. */
+    uint8_t qos;                                          /**< @brief Granted QoS. */
+    char filter[ IOT_BENCH_BROKER_MAX_FILTER_LENGTH ];    /**< @brief Topic filter. */
+} _brokerSubscription_t;
+
+/**
+ * @brief A connected client.
+ */
+typedef struct _brokerClient
+{
+    void * pConnection;                                                  /**< @brief Server end of the connection; NULL if unused. */
+    uint16_t nextPacketIdentifier;                                       /**< @brief Identifier of the next QoS 1 PUBLISH to the client. */
+    _brokerSubscription_t subscriptions[ IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS ]; /**< @brief Subscriptions of the client. */
+    uint8_t packet[ IOT_BENCH_BROKER_MAX_PACKET_SIZE ];                  /**< @brief Body of the packet being processed. */
+} _brokerClient_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Connected clients.
+ */
+static _brokerClient_t _clients[ IOT_BENCH_BROKER_MAX_CLIENTS ];
+
+/**
+ * @brief Protects #_clients and serializes forwarding, so that packets sent
+ * to a client are not interleaved.
+ */
+static StaticSemaphore_t _brokerMutex;
+
+/**
+ * @brief Whether #_brokerMutex was created.
+ */
+static bool _brokerMutexCreated = false;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Lock the broker.
+ */
+static void _lock( void )
+{
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &_brokerMutex, portMAX_DELAY );
+}
+
+/**
+ * @brief Unlock the broker.
+ */
+static void _unlock( void )
+{
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &_brokerMutex );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check if a topic name matches a topic filter with `+` and `#`
+ * wildcards.
+ */
+static bool _topicMatches( const char * pTopic,
+                           size_t topicLength,
+                           const char * pFilter,
+                           size_t filterLength )
+{
+    size_t topicIndex = 0, filterIndex = 0;
+    bool match = false;
+
+    while( filterIndex < filterLength )
+    {
+        if( pFilter[ filterIndex ] == '#' )
+        {
+            /* Matches the rest of the topic, including its parent level. */
+            match = true;
+            break;
+        }
+        else if( pFilter[ filterIndex ] == '+' )
+        {
+            while( ( topicIndex < topicLength ) && ( pTopic[ topicIndex ] != '/' ) )
+            {
+                topicIndex++;
+            }
+
+            filterIndex++;
+        }
+        else if( ( topicIndex < topicLength ) && ( pTopic[ topicIndex ] == pFilter[ filterIndex ] ) )
+        {
+            topicIndex++;
+            filterIndex++;
+        }
+        else if( ( topicIndex == topicLength ) &&
+                 ( filterLength - filterIndex == 2U ) &&
+                 ( pFilter[ filterIndex ] == '/' ) &&
+                 ( pFilter[ filterIndex + 1U ] == '#' ) )
+        {
+            /* "a/#" matches "a". */
+            match = true;
+            break;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( ( filterIndex == filterLength ) && ( topicIndex == topicLength ) )
+    {
+        match = true;
+    }
+
+    return match;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a packet made of a fixed header byte, a body header and a
+ * payload.
+ *
+ * @return `true` if all bytes were sent.
+ */
+static bool _sendPacket( void * pConnection,
+                         uint8_t packetType,
+                         const uint8_t * pHeader,
+                         size_t headerLength,
+                         const uint8_t * pPayload,
+                         size_t payloadLength )
+{
+    uint8_t fixedHeader[ 5 ] = { 0 };
+    size_t fixedHeaderLength = 1, remainingLength = headerLength + payloadLength;
+    IotNetworkSegment_t segments[ 3 ] = { { 0 } };
+
+    fixedHeader[ 0 ] = packetType;
+
+    do
+    {
+        fixedHeader[ fixedHeaderLength ] = ( uint8_t ) ( remainingLength & 0x7fU );
+        remainingLength >>= 7;
+
+        if( remainingLength > 0U )
+        {
+            fixedHeader[ fixedHeaderLength ] |= 0x80U;
+        }
+
+        fixedHeaderLength++;
+    } while( remainingLength > 0U );
+
+    segments[ 0 ].pData = fixedHeader;
+    segments[ 0 ].dataLength = fixedHeaderLength;
+    segments[ 1 ].pData = pHeader;
+    segments[ 1 ].dataLength = headerLength;
+    segments[ 2 ].pData = pPayload;
+    segments[ 2 ].dataLength = payloadLength;
+
+    return IotBenchLoopback.sendv( pConnection, segments, 3 ) ==
+           ( fixedHeaderLength + headerLength + payloadLength );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Forward a PUBLISH to the clients subscribed to its topic.
+ *
+ * Must be called with the broker locked.
+ */
+static void _forwardPublish( const uint8_t * pTopic,
+                             uint16_t topicLength,
+                             uint8_t qos,
+                             bool retain,
+                             const uint8_t * pPayload,
+                             size_t payloadLength )
+{
+    /* Static because the broker is locked; it is too large for a task stack. */
+    static uint8_t header[ 2 + IOT_BENCH_BROKER_MAX_PACKET_SIZE + 2 ];
+    size_t headerLength = 0, i = 0, j = 0;
+    uint8_t deliveryQos = 0;
+    bool subscribed = false;
+    _brokerClient_t * pClient = NULL;
+
+    header[ 0 ] = ( uint8_t ) ( topicLength >> 8 );
+    header[ 1 ] = ( uint8_t ) ( topicLength & 0xffU );
+    ( void ) memcpy( header + 2, pTopic, topicLength );
+
+    for( i = 0; i < IOT_BENCH_BROKER_MAX_CLIENTS; i++ )
+    {
+        pClient = &( _clients[ i ] );
+        subscribed = false;
+        deliveryQos = 0;
+
+        if( pClient->pConnection == NULL )
+        {
+            continue;
+        }
+
+        /* Overlapping subscriptions deliver once, at the highest QoS. */
+        for( j = 0; j < IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS; j++ )
+        {
+            if( ( pClient->subscriptions[ j ].filterLength > 0U ) &&
+                ( _topicMatches( ( const char * ) pTopic,
+                                 topicLength,
+                                 pClient->subscriptions[ j ].filter,
+                                 pClient->subscriptions[ j ].filterLength ) == true ) )
+            {
+                subscribed = true;
+
+                if( pClient->subscriptions[ j ].qos > deliveryQos )
+                {
+                    deliveryQos = pClient->subscriptions[ j ].qos;
+                }
+            }
+        }
+
+        if( subscribed == false )
+        {
+            continue;
+        }
+
+        if( deliveryQos > qos )
+        {
+            deliveryQos = qos;
+        }
+
+        headerLength = 2U + topicLength;
+
+        if( deliveryQos > 0U )
+        {
+            pClient->nextPacketIdentifier++;
+
+            if( pClient->nextPacketIdentifier == 0U )
+            {
+                pClient->nextPacketIdentifier = 1;
+            }
+
+            header[ headerLength ] = ( uint8_t ) ( pClient->nextPacketIdentifier >> 8 );
+            header[ headerLength + 1U ] = ( uint8_t ) ( pClient->nextPacketIdentifier & 0xffU );
+            headerLength += 2U;
+        }
+
+        ( void ) _sendPacket( pClient->pConnection,
+                              ( uint8_t ) ( _PUBLISH | ( deliveryQos << 1 ) | ( retain ? 1U : 0U ) ),
+                              header,
+                              headerLength,
+                              pPayload,
+                              payloadLength );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Process a PUBLISH from a client.
+ *
+ * @return `false` if the packet is malformed.
+ */
+static bool _processPublish( _brokerClient_t * pClient,
+                             uint8_t firstByte,
+                             size_t packetLength )
+{
+    const uint8_t * pPacket = pClient->packet;
+    uint8_t qos = ( firstByte >> 1 ) & 0x03U;
+    uint16_t topicLength = 0;
+    size_t payloadOffset = 0;
+    uint8_t puback[ 2 ] = { 0 };
+
+    if( ( packetLength < 2U ) || ( qos > 1U ) )
+    {
+        return false;
+    }
+
+    topicLength = ( uint16_t ) ( ( pPacket[ 0 ] << 8 ) | pPacket[ 1 ] );
+    payloadOffset = 2U + topicLength + ( ( qos > 0U ) ? 2U : 0U );
+
+    if( payloadOffset > packetLength )
+    {
+        return false;
+    }
+
+    _lock();
+
+    if( qos > 0U )
+    {
+        puback[ 0 ] = pPacket[ 2U + topicLength ];
+        puback[ 1 ] = pPacket[ 3U + topicLength ];
+        ( void ) _sendPacket( pClient->pConnection, _PUBACK, puback, sizeof( puback ), NULL, 0 );
+    }
+
+    _forwardPublish( pPacket + 2,
+                     topicLength,
+                     qos,
+                     ( firstByte & 0x01U ) != 0U,
+                     pPacket + payloadOffset,
+                     packetLength - payloadOffset );
+
+    _unlock();
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Process a SUBSCRIBE or UNSUBSCRIBE from a client.
+ *
+ * @return `false` if the packet is malformed.
+ */
+static bool _processSubscriptions( _brokerClient_t * pClient,
+                                   bool subscribe,
+                                   size_t packetLength )
+{
+    const uint8_t * pPacket = pClient->packet;
+    uint8_t returnCodes[ 2 + IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS ] = { 0 };
+    size_t offset = 2, returnCodeCount = 0, i = 0, freeIndex = 0;
+    uint16_t filterLength = 0;
+    uint8_t qos = 0;
+    _brokerSubscription_t * pSubscription = NULL;
+
+    if( packetLength < 2U )
+    {
+        return false;
+    }
+
+    /* The acknowledgement starts with the packet identifier. */
+    returnCodes[ 0 ] = pPacket[ 0 ];
+    returnCodes[ 1 ] = pPacket[ 1 ];
+
+    _lock();
+
+    while( offset + 2U <= packetLength )
+    {
+        filterLength = ( uint16_t ) ( ( pPacket[ offset ] << 8 ) | pPacket[ offset + 1U ] );
+        offset += 2U;
+
+        if( offset + filterLength + ( subscribe ? 1U : 0U ) > packetLength )
+        {
+            break;
+        }
+
+        qos = subscribe ? pPacket[ offset + filterLength ] : 0U;
+        freeIndex = IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS;
+        pSubscription = NULL;
+
+        for( i = 0; i < IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS; i++ )
+        {
+            if( ( pClient->subscriptions[ i ].filterLength == filterLength ) &&
+                ( memcmp( pClient->subscriptions[ i ].filter, pPacket + offset, filterLength ) == 0 ) )
+            {
+                pSubscription = &( pClient->subscriptions[ i ] );
+                break;
+            }
+            else if( ( pClient->subscriptions[ i ].filterLength == 0U ) &&
+                     ( freeIndex == IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS ) )
+            {
+                freeIndex = i;
+            }
+        }
+
+        if( subscribe == true )
+        {
+            if( ( pSubscription == NULL ) && ( freeIndex < IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS ) &&
+                ( filterLength > 0U ) && ( filterLength <= IOT_BENCH_BROKER_MAX_FILTER_LENGTH ) )
+            {
+                pSubscription = &( pClient->subscriptions[ freeIndex ] );
+                ( void ) memcpy( pSubscription->filter, pPacket + offset, filterLength );
+                pSubscription->filterLength = filterLength;
+            }
+
+            if( returnCodeCount < IOT_BENCH_BROKER_MAX_SUBSCRIPTIONS )
+            {
+                if( pSubscription != NULL )
+                {
+                    /* QoS 2 is granted as QoS 1. */
+                    pSubscription->qos = ( qos > 1U ) ? 1U : qos;
+                    returnCodes[ 2 + returnCodeCount ] = pSubscription->qos;
+                }
+                else
+                {
+                    returnCodes[ 2 + returnCodeCount ] = 0x80;
+                }
+
+                returnCodeCount++;
+            }
+
+            offset += filterLength + 1U;
+        }
+        else
+        {
+            if( pSubscription != NULL )
+            {
+                pSubscription->filterLength = 0;
+            }
+
+            offset += filterLength;
+        }
+    }
+
+    if( subscribe == true )
+    {
+        ( void ) _sendPacket( pClient->pConnection, _SUBACK, returnCodes, 2U + returnCodeCount, NULL, 0 );
+    }
+    else
+    {
+        ( void ) _sendPacket( pClient->pConnection, _UNSUBACK, returnCodes, 2, NULL, 0 );
+    }
+
+    _unlock();
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Stop forwarding to a client.
+ *
+ * @param[in] pClient The client.
+ * @param[in] pConnection Its connection, in case the entry was reused.
+ */
+static void _removeClient( _brokerClient_t * pClient,
+                           void * pConnection )
+{
+    _lock();
+
+    if( pClient->pConnection == pConnection )
+    {
+        pClient->pConnection = NULL;
+    }
+
+    _unlock();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive callback of the client connections. Reads and processes one
+ * packet.
+ */
+static void _brokerReceiveCallback( void * pConnection,
+                                    void * pContext )
+{
+    _brokerClient_t * pClient = pContext;
+    uint8_t firstByte = 0, lengthByte = 0, connack[ 2 ] = { 0 };
+    size_t packetLength = 0, shift = 0;
+    bool status = true;
+
+    if( IotBenchLoopback.receive( pConnection, &firstByte, 1 ) != 1U )
+    {
+        status = false;
+    }
+
+    /* Decode the remaining length. */
+    while( status == true )
+    {
+        if( ( shift > 21U ) || ( IotBenchLoopback.receive( pConnection, &lengthByte, 1 ) != 1U ) )
+        {
+            status = false;
+            break;
+        }
+
+        packetLength |= ( size_t ) ( lengthByte & 0x7fU ) << shift;
+        shift += 7U;
+
+        if( ( lengthByte & 0x80U ) == 0U )
+        {
+            break;
+        }
+    }
+
+    if( ( status == true ) && ( packetLength > IOT_BENCH_BROKER_MAX_PACKET_SIZE ) )
+    {
+        status = false;
+    }
+
+    if( ( status == true ) && ( packetLength > 0U ) &&
+        ( IotBenchLoopback.receive( pConnection, pClient->packet, packetLength ) != packetLength ) )
+    {
+        status = false;
+    }
+
+    if( status == true )
+    {
+        switch( firstByte & 0xf0U )
+        {
+            case _CONNECT:
+                /* Accept any client, without a session present. */
+                ( void ) _sendPacket( pConnection, _CONNACK, connack, sizeof( connack ), NULL, 0 );
+                break;
+
+            case _PUBLISH:
+                status = _processPublish( pClient, firstByte, packetLength );
+                break;
+
+            case _PUBACK:
+                /* Nothing is retransmitted, so acknowledgements are ignored. */
+                break;
+
+            case _SUBSCRIBE:
+                status = _processSubscriptions( pClient, true, packetLength );
+                break;
+
+            case _UNSUBSCRIBE:
+                status = _processSubscriptions( pClient, false, packetLength );
+                break;
+
+            case _PINGREQ:
+                _lock();
+                ( void ) _sendPacket( pConnection, _PINGRESP, NULL, 0, NULL, 0 );
+                _unlock();
+                break;
+
+            default:
+                /* DISCONNECT, or a packet a broker does not accept. */
+                status = false;
+                break;
+        }
+    }
+
+    if( status == false )
+    {
+        /* Wait for the client to close its end after a DISCONNECT; close
+         * right away after an error. */
+        _removeClient( pClient, pConnection );
+
+        if( ( firstByte & 0xf0U ) != _DISCONNECT )
+        {
+            ( void ) IotBenchLoopback.close( pConnection );
+            ( void ) IotBenchLoopback.destroy( pConnection );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Accept callback of the broker port.
+ */
+static bool _brokerAccept( void * pServerConnection,
+                           void * pContext )
+{
+    _brokerClient_t * pClient = NULL;
+    size_t i = 0;
+
+    ( void ) pContext;
+
+    _lock();
+
+    for( i = 0; i < IOT_BENCH_BROKER_MAX_CLIENTS; i++ )
+    {
+        if( _clients[ i ].pConnection == NULL )
+        {
+            pClient = &( _clients[ i ] );
+            ( void ) memset( pClient->subscriptions, 0x00, sizeof( pClient->subscriptions ) );
+            pClient->nextPacketIdentifier = 0;
+            pClient->pConnection = pServerConnection;
+            break;
+        }
+    }
+
+    _unlock();
+
+    if( pClient == NULL )
+    {
+        return false;
+    }
+
+    if( IotBenchLoopback.setReceiveCallback( pServerConnection,
+                                             _brokerReceiveCallback,
+                                             pClient ) != IOT_NETWORK_SUCCESS )
+    {
+        _lock();
+        pClient->pConnection = NULL;
+        _unlock();
+
+        return false;
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------*/
+
+bool IotBenchMqttBroker_Start( uint16_t port )
+{
+    if( _brokerMutexCreated == false )
+    {
+        ( void ) xSemaphoreCreateMutexStatic( &_brokerMutex );
+        _brokerMutexCreated = true;
+    }
+
+    return IotBenchLoopback_Listen( port, _brokerAccept, NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBenchMqttBroker_Stop( uint16_t port )
+{
+    IotBenchLoopback_StopListening( port );
+}
@@ -0,0 +1,352 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_ota.c
+ * @brief OTA block ingest scenario.
+ *
+ * Blocks of a file are fed to the OTA agent as they arrive from the MQTT
+ * stream, CBOR encoded, and written to RAM by the platform layer of this
+ * file. Each operation is one block: its decode, validation, write and the
+ * bookkeeping of the agent, up to closing the file after its last block.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* OTA includes. */
+#include "aws_iot_ota_agent.h"
+#include "aws_iot_ota_agent_internal.h"
+#include "aws_iot_ota_pal.h"
+#include "aws_ota_agent_test_access_declare.h"
+#include "aws_application_version.h"
+
+/* CBOR includes. */
+#include "cbor.h"
+#include "aws_iot_ota_cbor_internal.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/**
+ * @brief Number of blocks of the file received by the scenario.
+ */
+#ifndef IOT_BENCH_OTA_FILE_BLOCKS
+    #define IOT_BENCH_OTA_FILE_BLOCKS    ( 64U )
+#endif
+
+/**
+ * @brief Space for the CBOR map around the payload of a block.
+ */
+#define IOT_BENCH_OTA_MESSAGE_OVERHEAD    ( 64U )
+
+/**
+ * @brief Size of the file received by the scenario.
+ */
+#define IOT_BENCH_OTA_FILE_SIZE           ( IOT_BENCH_OTA_FILE_BLOCKS * OTA_FILE_BLOCK_SIZE )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief An encoded block of the stream.
+ */
+typedef struct _otaBenchMessage
+{
+    uint8_t * pData; /**< @brief CBOR encoded GetStream response. */
+    size_t size;     /**< @brief Size of the encoded response. */
+} _otaBenchMessage_t;
+
+/**
+ * @brief Firmware version of the application, used by the OTA agent.
+ */
+const AppVersion32_t xAppFirmwareVersion =
+{
+    .u.x.ucMajor = APP_VERSION_MAJOR,
+    .u.x.ucMinor = APP_VERSION_MINOR,
+    .u.x.usBuild = APP_VERSION_BUILD,
+};
+
+/**
+ * @brief The file image written by the platform layer.
+ */
+static uint8_t _image[ IOT_BENCH_OTA_FILE_SIZE ];
+
+/**
+ * @brief Buffer a block is received in. Decoding overwrites it with the
+ * payload of the block.
+ */
+static uint8_t _receiveBuffer[ OTA_FILE_BLOCK_SIZE + IOT_BENCH_OTA_MESSAGE_OVERHEAD ];
+
+/**
+ * @brief Context of the file being received.
+ */
+static OTA_FileContext_t _fileContext;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encode the GetStream response that carries a block of the file.
+ *
+ * @param[in] blockIndex Index of the block in the file.
+ * @param[out] pMessage Encoded response, in memory not taken from the
+ * benchmark heap.
+ *
+ * @return `true` if the response was encoded.
+ */
+static bool _encodeBlock( uint32_t blockIndex,
+                          _otaBenchMessage_t * pMessage )
+{
+    CborEncoder encoder, map;
+    CborError error = CborNoError;
+    uint8_t payload[ OTA_FILE_BLOCK_SIZE ];
+    size_t capacity = OTA_FILE_BLOCK_SIZE + IOT_BENCH_OTA_MESSAGE_OVERHEAD;
+
+    /* The content of a block only depends on its index. */
+    ( void ) memset( payload, ( int ) ( blockIndex & 0xFFU ), sizeof( payload ) );
+
+    pMessage->pData = malloc( capacity );
+
+    if( pMessage->pData == NULL )
+    {
+        error = CborErrorOutOfMemory;
+    }
+    else
+    {
+        cbor_encoder_init( &encoder, pMessage->pData, capacity, 0 );
+
+        error |= cbor_encoder_create_map( &encoder, &map, 4 );
+        error |= cbor_encode_text_stringz( &map, OTA_CBOR_FILEID_KEY );
+        error |= cbor_encode_int( &map, 0 );
+        error |= cbor_encode_text_stringz( &map, OTA_CBOR_BLOCKID_KEY );
+        error |= cbor_encode_int( &map, ( int64_t ) blockIndex );
+        error |= cbor_encode_text_stringz( &map, OTA_CBOR_BLOCKSIZE_KEY );
+        error |= cbor_encode_int( &map, ( int64_t ) OTA_FILE_BLOCK_SIZE );
+        error |= cbor_encode_text_stringz( &map, OTA_CBOR_BLOCKPAYLOAD_KEY );
+        error |= cbor_encode_byte_string( &map, payload, sizeof( payload ) );
+        error |= cbor_encoder_close_container_checked( &encoder, &map );
+
+        pMessage->size = cbor_encoder_get_buffer_size( &encoder, pMessage->pData );
+    }
+
+    return error == CborNoError;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Prepare the file context for a new download of the file.
+ *
+ * @return `true` if the file was created.
+ */
+static bool _startFile( void )
+{
+    bool status = true;
+    size_t bitmapSize = ( IOT_BENCH_OTA_FILE_BLOCKS + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
+
+    ( void ) memset( &_fileContext, 0x00, sizeof( _fileContext ) );
+
+    /* Like the agent, allocate the bitmap that it frees after the last block. */
+    _fileContext.pucRxBlockBitmap = pvPortMalloc( bitmapSize );
+    _fileContext.ulFileSize = IOT_BENCH_OTA_FILE_SIZE;
+    _fileContext.ulBlocksRemaining = IOT_BENCH_OTA_FILE_BLOCKS;
+
+    if( _fileContext.pucRxBlockBitmap == NULL )
+    {
+        status = false;
+    }
+    else
+    {
+        ( void ) memset( _fileContext.pucRxBlockBitmap, OTA_ERASED_BLOCKS_VAL, bitmapSize );
+        status = ( prvPAL_CreateFileForRx( &_fileContext ) == kOTA_Err_None );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_OtaIngest( size_t iterations )
+{
+    static _otaBenchMessage_t messages[ IOT_BENCH_OTA_FILE_BLOCKS ];
+    static const OTA_PAL_Callbacks_t palCallbacks = { 0 };
+    IotBenchResult_t result;
+    IngestResult_t ingestResult = eIngest_Result_Uninitialized;
+    OTA_Err_t closeResult = kOTA_Err_None;
+    const char * pSetupFailure = NULL;
+    uint32_t blockIndex = 0;
+    uint64_t startUs = 0;
+    size_t i = 0;
+
+    /* Without callbacks of its own, the agent uses the platform layer of this file. */
+    TEST_OTA_prvSetPALCallbacks( &palCallbacks );
+    TEST_OTA_prvSetDataInterfaceMQTT();
+
+    for( i = 0; i < IOT_BENCH_OTA_FILE_BLOCKS; i++ )
+    {
+        if( _encodeBlock( ( uint32_t ) i, &( messages[ i ] ) ) == false )
+        {
+            pSetupFailure = "block encoding failed";
+            break;
+        }
+    }
+
+    IotBench_Start( &result, "ota_ingest", iterations );
+
+    if( pSetupFailure != NULL )
+    {
+        IotBench_Fail( &result, pSetupFailure );
+    }
+
+    for( i = 0; ( i < iterations ) && ( result.pFailure == NULL ); i++ )
+    {
+        blockIndex = ( uint32_t ) ( i % IOT_BENCH_OTA_FILE_BLOCKS );
+
+        if( ( blockIndex == 0U ) && ( _startFile() == false ) )
+        {
+            IotBench_Fail( &result, "file creation failed" );
+            break;
+        }
+
+        startUs = IotBench_NowUs();
+
+        /* Like the MQTT callback of the agent, copy the message to a data buffer. */
+        ( void ) memcpy( _receiveBuffer, messages[ blockIndex ].pData, messages[ blockIndex ].size );
+        ingestResult = TEST_OTA_prvIngestDataBlock( &_fileContext,
+                                                    _receiveBuffer,
+                                                    ( uint32_t ) messages[ blockIndex ].size,
+                                                    &closeResult );
+        IotBench_Sample( &result, ( uint32_t ) ( IotBench_NowUs() - startUs ), OTA_FILE_BLOCK_SIZE );
+
+        if( ( ingestResult != eIngest_Result_Accepted_Continue ) &&
+            ( ingestResult != eIngest_Result_FileComplete ) )
+        {
+            IotBench_Fail( &result, "block rejected" );
+        }
+    }
+
+    /* Abandon a file that was not received completely. */
+    if( _fileContext.pucRxBlockBitmap != NULL )
+    {
+        ( void ) prvPAL_Abort( &_fileContext );
+        vPortFree( _fileContext.pucRxBlockBitmap );
+        _fileContext.pucRxBlockBitmap = NULL;
+    }
+
+    IotBench_Stop( &result );
+
+    for( i = 0; i < IOT_BENCH_OTA_FILE_BLOCKS; i++ )
+    {
+        free( messages[ i ].pData );
+        messages[ i ].pData = NULL;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* The platform layer of the OTA agent, receiving the file in RAM. */
+
+OTA_Err_t prvPAL_Abort( OTA_FileContext_t * const C )
+{
+    C->pucFile = NULL;
+
+    return kOTA_Err_None;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_CreateFileForRx( OTA_FileContext_t * const C )
+{
+    OTA_Err_t status = kOTA_Err_RxFileTooLarge;
+
+    if( C->ulFileSize <= sizeof( _image ) )
+    {
+        C->pucFile = _image;
+        status = kOTA_Err_None;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_CloseFile( OTA_FileContext_t * const C )
+{
+    /* The signature is not checked; the scenario measures the agent. */
+    C->pucFile = NULL;
+
+    return kOTA_Err_None;
+}
+
+/*-----------------------------------------------------------*/
+
+int16_t prvPAL_WriteBlock( OTA_FileContext_t * const C,
+                           uint32_t ulOffset,
+                           uint8_t * const pcData,
+                           uint32_t ulBlockSize )
+{
+    int16_t written = -1;
+
+    if( ( C->pucFile == _image ) && ( ulOffset + ulBlockSize <= sizeof( _image ) ) )
+    {
+        ( void ) memcpy( &( _image[ ulOffset ] ), pcData, ulBlockSize );
+        written = ( int16_t ) ulBlockSize;
+    }
+
+    return written;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_ActivateNewImage( void )
+{
+    return kOTA_Err_None;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_ResetDevice( void )
+{
+    return kOTA_Err_None;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_SetPlatformImageState( OTA_ImageState_t eState )
+{
+    ( void ) eState;
+
+    return kOTA_Err_None;
+}
+
+/*-----------------------------------------------------------*/
+
+OTA_PAL_ImageState_t prvPAL_GetPlatformImageState( void )
+{
+    return eOTA_PAL_ImageState_Valid;
+}
@@ -0,0 +1,344 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_serializer.c
+ * @brief JSON and CBOR encode and decode scenarios.
+ *
+ * Each operation encodes or decodes one document shaped like a Device
+ * Defender metrics report, through the serializer interfaces used by the
+ * libraries.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* SDK include. */
+#include "iot_config.h"
+
+/* Serializer include. */
+#include "iot_serializer.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/**
+ * @brief Number of connections in the document.
+ */
+#ifndef IOT_BENCH_SERIALIZER_CONNECTIONS
+    #define IOT_BENCH_SERIALIZER_CONNECTIONS    ( 8 )
+#endif
+
+/**
+ * @brief Size of the buffer holding an encoded document.
+ */
+#define _DOCUMENT_BUFFER_SIZE    ( 128 + ( IOT_BENCH_SERIALIZER_CONNECTIONS * 48 ) )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remote addresses of the connections in the document.
+ */
+static char _remoteAddresses[ IOT_BENCH_SERIALIZER_CONNECTIONS ][ 24 ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encode a document.
+ *
+ * @param[in] pEncoder The encoder to use.
+ * @param[out] pBuffer Where to encode the document.
+ * @param[in] bufferSize Size of `pBuffer`.
+ * @param[in] reportId Value of `report_id`.
+ *
+ * @return The size of the document; 0 on error.
+ */
+static size_t _encodeDocument( IotSerializerEncodeInterface_t * pEncoder,
+                               uint8_t * pBuffer,
+                               size_t bufferSize,
+                               int64_t reportId )
+{
+    IotSerializerEncoderObject_t root = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_STREAM;
+    IotSerializerEncoderObject_t document = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerEncoderObject_t header = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerEncoderObject_t metrics = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerEncoderObject_t tcpConnections = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerEncoderObject_t established = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerEncoderObject_t connections = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_ARRAY;
+    IotSerializerEncoderObject_t connection = IOT_SERIALIZER_ENCODER_CONTAINER_INITIALIZER_MAP;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+    size_t encodedSize = 0, i = 0;
+
+    error = pEncoder->init( &root, pBuffer, bufferSize );
+
+    /* The buffer is sized for the document, so errors are only accumulated
+     * and checked once at the end. */
+    if( error == IOT_SERIALIZER_SUCCESS )
+    {
+        error |= pEncoder->openContainer( &root, &document, 2 );
+
+        error |= pEncoder->openContainerWithKey( &document, "header", &header, 2 );
+        error |= pEncoder->appendKeyValue( &header, "report_id", IotSerializer_ScalarSignedInt( reportId ) );
+        error |= pEncoder->appendKeyValue( &header, "version", IotSerializer_ScalarTextString( "1.0" ) );
+        error |= pEncoder->closeContainer( &document, &header );
+
+        error |= pEncoder->openContainerWithKey( &document, "metrics", &metrics, 1 );
+        error |= pEncoder->openContainerWithKey( &metrics, "tcp_connections", &tcpConnections, 1 );
+        error |= pEncoder->openContainerWithKey( &tcpConnections, "established_connections", &established, 2 );
+        error |= pEncoder->openContainerWithKey( &established, "connections", &connections, IOT_BENCH_SERIALIZER_CONNECTIONS );
+
+        for( i = 0; i < IOT_BENCH_SERIALIZER_CONNECTIONS; i++ )
+        {
+            error |= pEncoder->openContainer( &connections, &connection, 1 );
+            error |= pEncoder->appendKeyValue( &connection, "remote_addr", IotSerializer_ScalarTextString( _remoteAddresses[ i ] ) );
+            error |= pEncoder->closeContainer( &connections, &connection );
+        }
+
+        error |= pEncoder->closeContainer( &established, &connections );
+        error |= pEncoder->appendKeyValue( &established, "total", IotSerializer_ScalarSignedInt( IOT_BENCH_SERIALIZER_CONNECTIONS ) );
+        error |= pEncoder->closeContainer( &tcpConnections, &established );
+        error |= pEncoder->closeContainer( &metrics, &tcpConnections );
+        error |= pEncoder->closeContainer( &document, &metrics );
+
+        error |= pEncoder->closeContainer( &root, &document );
+
+        if( error == IOT_SERIALIZER_SUCCESS )
+        {
+            encodedSize = pEncoder->getEncodedSize( &root, pBuffer );
+        }
+
+        pEncoder->destroy( &root );
+    }
+
+    return encodedSize;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Decode a document and check its contents.
+ *
+ * @param[in] pDecoder The decoder to use.
+ * @param[in] pBuffer The encoded document.
+ * @param[in] documentSize Size of the document.
+ * @param[in] reportId Expected value of `report_id`.
+ *
+ * @return `true` if the document has the expected contents.
+ */
+static bool _decodeDocument( IotSerializerDecodeInterface_t * pDecoder,
+                             const uint8_t * pBuffer,
+                             size_t documentSize,
+                             int64_t reportId )
+{
+    IotSerializerDecoderObject_t document = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t header = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t metrics = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t tcpConnections = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t established = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t connections = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t connection = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderObject_t value = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    IotSerializerDecoderIterator_t iterator = IOT_SERIALIZER_DECODER_ITERATOR_INITIALIZER;
+    bool status = false;
+    size_t count = 0;
+
+    if( pDecoder->init( &document, pBuffer, documentSize ) != IOT_SERIALIZER_SUCCESS )
+    {
+        return false;
+    }
+
+    if( ( pDecoder->find( &document, "header", &header ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( pDecoder->find( &header, "report_id", &value ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( value.type == IOT_SERIALIZER_SCALAR_SIGNED_INT ) &&
+        ( value.u.value.u.signedInt == reportId ) &&
+        ( pDecoder->find( &document, "metrics", &metrics ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( pDecoder->find( &metrics, "tcp_connections", &tcpConnections ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( pDecoder->find( &tcpConnections, "established_connections", &established ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( pDecoder->find( &established, "connections", &connections ) == IOT_SERIALIZER_SUCCESS ) &&
+        ( connections.type == IOT_SERIALIZER_CONTAINER_ARRAY ) &&
+        ( pDecoder->stepIn( &connections, &iterator ) == IOT_SERIALIZER_SUCCESS ) )
+    {
+        status = true;
+
+        while( ( status == true ) && ( pDecoder->isEndOfContainer( iterator ) == false ) )
+        {
+            /* Without a buffer in the value, the CBOR decoder points strings
+             * into the document instead of copying them. */
+            value.u.value.u.string.pString = NULL;
+            value.u.value.u.string.length = 0;
+
+            status = ( pDecoder->get( iterator, &connection ) == IOT_SERIALIZER_SUCCESS ) &&
+                     ( pDecoder->find( &connection, "remote_addr", &value ) == IOT_SERIALIZER_SUCCESS ) &&
+                     ( value.type == IOT_SERIALIZER_SCALAR_TEXT_STRING ) &&
+                     ( count < IOT_BENCH_SERIALIZER_CONNECTIONS ) &&
+                     ( value.u.value.u.string.length == strlen( _remoteAddresses[ count ] ) );
+
+            pDecoder->destroy( &connection );
+            count++;
+
+            if( ( status == true ) && ( pDecoder->next( iterator ) != IOT_SERIALIZER_SUCCESS ) )
+            {
+                status = false;
+            }
+        }
+
+        ( void ) pDecoder->stepOut( iterator, &connections );
+    }
+
+    pDecoder->destroy( &connections );
+    pDecoder->destroy( &established );
+    pDecoder->destroy( &tcpConnections );
+    pDecoder->destroy( &metrics );
+    pDecoder->destroy( &header );
+    pDecoder->destroy( &document );
+
+    return ( status == true ) && ( count == IOT_BENCH_SERIALIZER_CONNECTIONS );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Fill in the remote addresses of the document.
+ */
+static void _initDocument( void )
+{
+    size_t i = 0;
+
+    for( i = 0; i < IOT_BENCH_SERIALIZER_CONNECTIONS; i++ )
+    {
+        ( void ) snprintf( _remoteAddresses[ i ],
+                           sizeof( _remoteAddresses[ i ] ),
+                           "192.168.%u.%u:%u",
+                           ( unsigned ) ( i / 250U ),
+                           ( unsigned ) ( ( i % 250U ) + 2U ),
+                           ( unsigned ) ( 8000U + i ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encode documents.
+ */
+static void _runEncode( const char * pName,
+                        IotSerializerEncodeInterface_t * pEncoder,
+                        size_t iterations )
+{
+    static uint8_t buffer[ _DOCUMENT_BUFFER_SIZE ];
+    IotBenchResult_t result = { 0 };
+    uint64_t startUs = 0;
+    size_t encodedSize = 0, i = 0;
+
+    _initDocument();
+
+    IotBench_Start( &result, pName, iterations );
+
+    for( i = 0; i < iterations; i++ )
+    {
+        startUs = IotBench_NowUs();
+        encodedSize = _encodeDocument( pEncoder, buffer, sizeof( buffer ), ( int64_t ) i );
+
+        if( encodedSize == 0U )
+        {
+            IotBench_Fail( &result, "encode failed" );
+            break;
+        }
+
+        IotBench_Sample( &result, ( uint32_t ) ( IotBench_NowUs() - startUs ), encodedSize );
+    }
+
+    IotBench_Stop( &result );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Decode a document encoded before measuring.
+ */
+static void _runDecode( const char * pName,
+                        IotSerializerEncodeInterface_t * pEncoder,
+                        IotSerializerDecodeInterface_t * pDecoder,
+                        size_t iterations )
+{
+    static uint8_t buffer[ _DOCUMENT_BUFFER_SIZE ];
+    IotBenchResult_t result = { 0 };
+    uint64_t startUs = 0;
+    size_t encodedSize = 0, i = 0;
+
+    _initDocument();
+    encodedSize = _encodeDocument( pEncoder, buffer, sizeof( buffer ), 1 );
+
+    IotBench_Start( &result, pName, iterations );
+
+    if( encodedSize == 0U )
+    {
+        IotBench_Fail( &result, "encode failed" );
+    }
+
+    for( i = 0; ( i < iterations ) && ( result.pFailure == NULL ); i++ )
+    {
+        startUs = IotBench_NowUs();
+
+        if( _decodeDocument( pDecoder, buffer, encodedSize, 1 ) == false )
+        {
+            IotBench_Fail( &result, "decode failed" );
+        }
+        else
+        {
+            IotBench_Sample( &result, ( uint32_t ) ( IotBench_NowUs() - startUs ), encodedSize );
+        }
+    }
+
+    IotBench_Stop( &result );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_JsonEncode( size_t iterations )
+{
+    _runEncode( "json_encode", &_IotSerializerJsonEncoder, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_JsonDecode( size_t iterations )
+{
+    _runDecode( "json_decode", &_IotSerializerJsonEncoder, &_IotSerializerJsonDecoder, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_CborEncode( size_t iterations )
+{
+    _runEncode( "cbor_encode", &_IotSerializerCborEncoder, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_CborDecode( size_t iterations )
+{
+    _runDecode( "cbor_decode", &_IotSerializerCborEncoder, &_IotSerializerCborDecoder, iterations );
+}
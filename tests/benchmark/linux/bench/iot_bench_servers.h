@@ -0,0 +1,88 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_servers.h
+ * @brief Minimal servers that the benchmark scenarios connect to over the
+ * loopback network stack.
+ */
+
+#ifndef IOT_BENCH_SERVERS_H_
+#define IOT_BENCH_SERVERS_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Loopback ports of the servers.
+ */
+/**@{ */
+#define IOT_BENCH_MQTT_PORT    ( 1883 )
+#define IOT_BENCH_HTTP_PORT    ( 80 )
+/**@} */
+
+/**
+ * @brief Start an MQTT 3.1.1 broker on a loopback port.
+ *
+ * The broker accepts any CONNECT, grants every SUBSCRIBE at the requested
+ * QoS (at most 1), and forwards each PUBLISH to the matching subscriptions
+ * of all connected clients. It keeps no session state across connections and
+ * does not retransmit.
+ *
+ * @param[in] port Loopback port to listen on.
+ *
+ * @return `true` if the broker is listening; `false` otherwise.
+ */
+bool IotBenchMqttBroker_Start( uint16_t port );
+
+/**
+ * @brief Stop accepting MQTT connections. Connected clients are served until
+ * they disconnect.
+ *
+ * @param[in] port The port passed to #IotBenchMqttBroker_Start.
+ */
+void IotBenchMqttBroker_Stop( uint16_t port );
+
+/**
+ * @brief Start an HTTP/1.1 server on a loopback port.
+ *
+ * The server answers `GET /<n>` with a body of `n` bytes, keeping the
+ * connection open unless the request says `Connection: close`.
+ *
+ * @param[in] port Loopback port to listen on.
+ *
+ * @return `true` if the server is listening; `false` otherwise.
+ */
+bool IotBenchHttpServer_Start( uint16_t port );
+
+/**
+ * @brief Stop accepting HTTP connections.
+ *
+ * @param[in] port The port passed to #IotBenchHttpServer_Start.
+ */
+void IotBenchHttpServer_Stop( uint16_t port );
+
+#endif /* ifndef IOT_BENCH_SERVERS_H_ */
@@ -0,0 +1,210 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_taskpool.c
+ * @brief Task pool scheduling scenarios.
+ *
+ * Jobs are scheduled on the system task pool in batches. Latency is measured
+ * from the call to schedule the job to the start of its routine; for
+ * deferred jobs it is the delay past the requested deferral.
+ */
+
+/* SDK include. */
+#include "iot_config.h"
+
+/* Task pool include. */
+#include "iot_taskpool.h"
+
+/* Platform include. */
+#include "platform/iot_threads.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/**
+ * @brief Number of jobs scheduled before waiting for them.
+ */
+#ifndef IOT_BENCH_TASKPOOL_BATCH_SIZE
+    #define IOT_BENCH_TASKPOOL_BATCH_SIZE    ( 32 )
+#endif
+
+/**
+ * @brief Deferral of the deferred jobs.
+ */
+#ifndef IOT_BENCH_TASKPOOL_DEFERRAL_MS
+    #define IOT_BENCH_TASKPOOL_DEFERRAL_MS    ( 1 )
+#endif
+
+/**
+ * @brief Timeout for a batch of jobs to run.
+ */
+#ifndef IOT_BENCH_TASKPOOL_TIMEOUT_MS
+    #define IOT_BENCH_TASKPOOL_TIMEOUT_MS    ( 5000 )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A job of a batch.
+ */
+typedef struct _taskPoolBenchJob
+{
+    IotTaskPoolJobStorage_t storage; /**< @brief Storage of the job. */
+    IotTaskPoolJob_t job;            /**< @brief The job. */
+    uint64_t dueUs;                  /**< @brief Time at which the job should run. */
+} _taskPoolBenchJob_t;
+
+/**
+ * @brief State shared with the job routine.
+ */
+typedef struct _taskPoolBenchContext
+{
+    IotBenchResult_t result;                                 /**< @brief Measurements of the scenario. */
+    IotSemaphore_t done;                                     /**< @brief Posted by every job. */
+    _taskPoolBenchJob_t jobs[ IOT_BENCH_TASKPOOL_BATCH_SIZE ]; /**< @brief The jobs of a batch. */
+} _taskPoolBenchContext_t;
+
+/**
+ * @brief The scenario state. Too large for the stack of the main task.
+ */
+static _taskPoolBenchContext_t _context;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Job routine. Records how late the job started.
+ */
+static void _jobRoutine( IotTaskPool_t taskPool,
+                         IotTaskPoolJob_t job,
+                         void * pUserContext )
+{
+    _taskPoolBenchJob_t * pJob = pUserContext;
+    uint64_t now = IotBench_NowUs();
+
+    ( void ) taskPool;
+    ( void ) job;
+
+    IotBench_Sample( &( _context.result ),
+                     ( now > pJob->dueUs ) ? ( uint32_t ) ( now - pJob->dueUs ) : 0U,
+                     0 );
+    IotSemaphore_Post( &( _context.done ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Schedule jobs in batches and wait for them to run.
+ *
+ * @param[in] pName Scenario name.
+ * @param[in] deferralMs Deferral of the jobs; 0 to schedule them immediately.
+ * @param[in] iterations Number of jobs.
+ */
+static void _runSchedule( const char * pName,
+                          uint32_t deferralMs,
+                          size_t iterations )
+{
+    IotTaskPool_t taskPool = IotTaskPool_GetSystemTaskPool();
+    IotTaskPoolError_t status = IOT_TASKPOOL_SUCCESS;
+    _taskPoolBenchJob_t * pJob = NULL;
+    size_t scheduled = 0, batch = 0, i = 0;
+    bool semaphoreCreated = false;
+
+    semaphoreCreated = IotSemaphore_Create( &( _context.done ), 0, IOT_BENCH_TASKPOOL_BATCH_SIZE );
+
+    IotBench_Start( &( _context.result ), pName, iterations );
+
+    if( semaphoreCreated == false )
+    {
+        IotBench_Fail( &( _context.result ), "out of memory" );
+    }
+
+    while( ( scheduled < iterations ) && ( _context.result.pFailure == NULL ) )
+    {
+        batch = iterations - scheduled;
+
+        if( batch > IOT_BENCH_TASKPOOL_BATCH_SIZE )
+        {
+            batch = IOT_BENCH_TASKPOOL_BATCH_SIZE;
+        }
+
+        for( i = 0; i < batch; i++ )
+        {
+            pJob = &( _context.jobs[ i ] );
+            ( void ) IotTaskPool_CreateJob( _jobRoutine, pJob, &( pJob->storage ), &( pJob->job ) );
+            pJob->dueUs = IotBench_NowUs() + ( ( uint64_t ) deferralMs * 1000U );
+
+            if( deferralMs == 0U )
+            {
+                status = IotTaskPool_Schedule( taskPool, pJob->job, 0 );
+            }
+            else
+            {
+                status = IotTaskPool_ScheduleDeferred( taskPool, pJob->job, deferralMs );
+            }
+
+            if( status != IOT_TASKPOOL_SUCCESS )
+            {
+                IotBench_Fail( &( _context.result ), "schedule failed" );
+                break;
+            }
+        }
+
+        /* Wait for the jobs that were scheduled. */
+        batch = i;
+
+        for( i = 0; i < batch; i++ )
+        {
+            if( IotSemaphore_TimedWait( &( _context.done ), IOT_BENCH_TASKPOOL_TIMEOUT_MS ) == false )
+            {
+                IotBench_Fail( &( _context.result ), "job did not run" );
+                break;
+            }
+        }
+
+        scheduled += batch;
+    }
+
+    IotBench_Stop( &( _context.result ) );
+
+    if( semaphoreCreated == true )
+    {
+        IotSemaphore_Destroy( &( _context.done ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_TaskPoolSchedule( size_t iterations )
+{
+    _runSchedule( "taskpool_schedule", 0, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_TaskPoolScheduleDeferred( size_t iterations )
+{
+    _runSchedule( "taskpool_schedule_deferred", IOT_BENCH_TASKPOOL_DEFERRAL_MS, iterations );
+}
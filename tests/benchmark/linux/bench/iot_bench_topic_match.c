@@ -0,0 +1,216 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_bench_topic_match.c
+ * @brief MQTT topic matching scenarios.
+ *
+ * Each operation finds the subscriptions matching one topic name among
+ * #IOT_BENCH_TOPIC_FILTERS topic filters, by scanning every filter as the MQTT
+ * library does without the topic-filter trie, or by walking the trie.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* SDK include. */
+#include "iot_config.h"
+
+/* MQTT internal include. */
+#include "private/iot_mqtt_internal.h"
+
+/* Benchmark include. */
+#include "iot_bench.h"
+
+/**
+ * @brief Number of subscribed topic filters.
+ */
+#ifndef IOT_BENCH_TOPIC_FILTERS
+    #define IOT_BENCH_TOPIC_FILTERS    ( 1000 )
+#endif
+
+/**
+ * @brief Number of topic filters, rounded up to whole subscription arrays of
+ * a connection, which is what the scan goes through at a time.
+ */
+#define _FILTER_COUNT                                                     \
+    ( ( ( IOT_BENCH_TOPIC_FILTERS + MAX_NO_OF_MQTT_SUBSCRIPTIONS - 1 ) / \
+        MAX_NO_OF_MQTT_SUBSCRIPTIONS ) * MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+
+/**
+ * @brief Nodes of the trie: every topic filter uses 3 nodes that are not
+ * shared, plus the root and the shared first level.
+ */
+#define _NODE_COUNT       ( ( _FILTER_COUNT * 3 ) + 2 )
+
+#define _FILTER_FORMAT    "bench/%lu/+/state"   /**< @brief Format of each topic filter. */
+#define _TOPIC_FORMAT     "bench/%lu/dev/state" /**< @brief Format of each topic name. */
+#define _MAX_LENGTH       ( 32 )                /**< @brief Maximum length of topic filters and names. */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The subscriptions, their topic filters and the trie over them. They
+ * are not allocated, so that the heap columns only show matching.
+ */
+static _mqttSubscription_t _subscriptions[ _FILTER_COUNT ];
+static char _topicFilters[ _FILTER_COUNT ][ _MAX_LENGTH ];
+static _mqttTopicTrieNode_t _nodes[ _NODE_COUNT ];
+static _mqttTopicTrie_t _trie = { 0 };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Subscribe the topic filters and index them in the trie.
+ *
+ * @return `true` if every topic filter fits in the trie.
+ */
+static bool _initSubscriptions( void )
+{
+    bool status = true;
+    size_t i = 0;
+
+    ( void ) memset( _subscriptions, 0x00, sizeof( _subscriptions ) );
+    ( void ) memset( _nodes, 0x00, sizeof( _nodes ) );
+
+    _trie.pNodes = _nodes;
+    _trie.nodeCount = _NODE_COUNT;
+    _trie.pSubscriptionArray = _subscriptions;
+
+    for( i = 0; ( i < _FILTER_COUNT ) && ( status == true ); i++ )
+    {
+        _subscriptions[ i ].pTopicFilter = _topicFilters[ i ];
+        _subscriptions[ i ].topicFilterLength = ( uint16_t ) snprintf( _topicFilters[ i ],
+                                                                       _MAX_LENGTH,
+                                                                       _FILTER_FORMAT,
+                                                                       ( unsigned long ) i );
+        status = IotMqtt_TopicTrieInsert( &_trie, ( uint16_t ) i );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Count the subscriptions matching a topic name by scanning them.
+ *
+ * The subscriptions belong to no connection, so #IotMqtt_FindFirstMatch
+ * compares every topic filter in turn.
+ */
+static size_t _scanMatch( _topicMatchParams_t * pMatch )
+{
+    size_t base = 0, matchCount = 0;
+    int8_t index = 0;
+
+    for( base = 0; base < _FILTER_COUNT; base += MAX_NO_OF_MQTT_SUBSCRIPTIONS )
+    {
+        index = IotMqtt_FindFirstMatch( &( _subscriptions[ base ] ), 0, pMatch );
+
+        while( index != -1 )
+        {
+            matchCount++;
+            index = ( index + 1 < MAX_NO_OF_MQTT_SUBSCRIPTIONS ) ?
+                    IotMqtt_FindFirstMatch( &( _subscriptions[ base ] ), ( int8_t ) ( index + 1 ), pMatch ) : -1;
+        }
+    }
+
+    return matchCount;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Match topic names, each against exactly one topic filter.
+ */
+static void _runMatch( const char * pName,
+                       bool useTrie,
+                       size_t iterations )
+{
+    IotBenchResult_t result = { 0 };
+    _topicMatchParams_t topicMatchParams = { 0 };
+    uint32_t matches[ IOT_MQTT_TOPIC_TRIE_BITMAP_WORDS( _FILTER_COUNT ) ] = { 0 };
+    char topicName[ _MAX_LENGTH ] = { 0 };
+    uint64_t startUs = 0;
+    size_t i = 0, matchCount = 0;
+    bool ready = _initSubscriptions();
+
+    IotBench_Start( &result, pName, iterations );
+
+    if( ready == false )
+    {
+        IotBench_Fail( &result, "trie full" );
+    }
+
+    for( i = 0; ( i < iterations ) && ( result.pFailure == NULL ); i++ )
+    {
+        topicMatchParams.pTopicName = topicName;
+        topicMatchParams.topicNameLength = ( uint16_t ) snprintf( topicName,
+                                                                  _MAX_LENGTH,
+                                                                  _TOPIC_FORMAT,
+                                                                  ( unsigned long ) ( i % _FILTER_COUNT ) );
+
+        startUs = IotBench_NowUs();
+
+        if( useTrie == true )
+        {
+            ( void ) memset( matches, 0x00, sizeof( matches ) );
+            matchCount = IotMqtt_TopicTrieMatch( &_trie,
+                                                 topicMatchParams.pTopicName,
+                                                 topicMatchParams.topicNameLength,
+                                                 matches );
+        }
+        else
+        {
+            matchCount = _scanMatch( &topicMatchParams );
+        }
+
+        if( matchCount != 1U )
+        {
+            IotBench_Fail( &result, "wrong number of matches" );
+        }
+        else
+        {
+            IotBench_Sample( &result, ( uint32_t ) ( IotBench_NowUs() - startUs ), 0 );
+        }
+    }
+
+    IotBench_Stop( &result );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_MqttTopicMatchScan( size_t iterations )
+{
+    _runMatch( "mqtt_topic_match_scan", false, iterations );
+}
+
+/*-----------------------------------------------------------*/
+
+void IotBench_MqttTopicMatchTrie( size_t iterations )
+{
+    _runMatch( "mqtt_topic_match_trie", true, iterations );
+}
@@ -0,0 +1,56 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* This file contains configuration settings for the benchmarks. */
+
+#ifndef IOT_CONFIG_H_
+#define IOT_CONFIG_H_
+
+/* Standard include. */
+#include <stdbool.h>
+
+/* How long the MQTT library will wait for PINGRESPs or PUBACKs. */
+#define IOT_MQTT_RESPONSE_WAIT_MS            ( 5000 )
+
+/* The benchmarks connect to local stand-ins, not to AWS IoT. */
+#define AWS_IOT_MQTT_ENABLE_METRICS          ( 0 )
+
+/* Logs would be measured with the libraries, so only errors are printed. */
+#define IOT_LOG_LEVEL_GLOBAL                 IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_PLATFORM               IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_NETWORK                IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_TASKPOOL               IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_MQTT                   IOT_LOG_ERROR
+#define IOT_LOG_LEVEL_HTTPS                  IOT_LOG_ERROR
+
+/* Platform thread stack size and priority. The stack size is in words and
+ * must hold at least PTHREAD_STACK_MIN bytes. */
+#define IOT_THREAD_DEFAULT_STACK_SIZE        ( 8192 )
+#define IOT_THREAD_DEFAULT_PRIORITY          ( 5 )
+
+/* Include the common configuration file for FreeRTOS. */
+#include "iot_config_common.h"
+
+#endif /* ifndef IOT_CONFIG_H_ */
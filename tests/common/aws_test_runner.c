@@ -100,6 +100,7 @@ static void RunTests( void )
     #if ( testrunnerFULL_SHADOWv4_ENABLED == 1 )
         RUN_TEST_GROUP( Shadow_Unit_Parser );
         RUN_TEST_GROUP( Shadow_Unit_API );
+        RUN_TEST_GROUP( Shadow_Unit_State );
         RUN_TEST_GROUP( Shadow_System );
     #endif /* if ( testrunnerFULL_SHADOWv4_ENABLED == 1 ) */
 
@@ -186,6 +187,10 @@ static void RunTests( void )
         RUN_TEST_GROUP( UTIL_Platform_Threads );
     #endif
 
+    #if ( testrunnerUTIL_PLATFORM_METRICS_ENABLED == 1 )
+        RUN_TEST_GROUP( UTIL_Platform_Metrics );
+    #endif
+
     #if ( testrunnerFULL_BLE_ENABLED == 1 )
         RUN_TEST_GROUP( Full_BLE );
     #endif
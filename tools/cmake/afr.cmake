@@ -84,6 +84,9 @@ if (AFR_ENABLE_UNIT_TESTS)
      add_compile_definitions(AMAZON_FREERTOS_ENABLE_MOCKING)
 endif()
 
+# Provide an option to build the host benchmarks instead of a board image.
+option(AFR_ENABLE_BENCHMARKS "Build the Linux benchmarks of the C SDK." OFF)
+
 # Provide an option to enable tests. Also set an helper variable to use in generator expression.
 option(AFR_ENABLE_TESTS "Build tests for FreeRTOS. Requires recompiling whole library." OFF)
 if(AFR_ENABLE_TESTS)
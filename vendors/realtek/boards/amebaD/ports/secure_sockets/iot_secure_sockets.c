@@ -47,6 +47,14 @@
 
 /*-----------------------------------------------------------*/
 
+/*
+ * The size of the buffer SOCKETS_Sendv() gathers consecutive small buffers in,
+ * so that they are sent as one TLS record. It is allocated on the stack.
+ */
+#ifndef socketsconfigSENDV_TLS_RECORD_BYTES
+    #define socketsconfigSENDV_TLS_RECORD_BYTES    ( 128 )
+#endif
+
 #define SS_STATUS_CONNECTED     (1)
 #define SS_STATUS_SECURED       (2)
 
@@ -481,6 +489,134 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxIov,
+                       size_t xIovCount,
+                       uint32_t ulFlags )
+{
+    ss_ctx_t *   ctx;
+    size_t       i;
+    size_t       xEnd    = 0;
+    size_t       xLength = 0;
+    const void * pvData  = NULL;
+    uint8_t      ucRecord[ socketsconfigSENDV_TLS_RECORD_BYTES ];
+    int32_t      lSent   = 0;
+    int32_t      lRet    = 0;
+
+    if( SOCKETS_INVALID_SOCKET == xSocket )
+    {
+        return SOCKETS_SOCKET_ERROR;
+    }
+
+    if( ( NULL == pxIov ) || ( 0 == xIovCount ) )
+    {
+        return SOCKETS_EINVAL;
+    }
+
+    ctx = ( ss_ctx_t * )xSocket;
+
+    if( 0 > ctx->ip_socket )
+    {
+        return SOCKETS_SOCKET_ERROR;
+    }
+
+    /* Check the buffers before sending anything, and find the end of the last
+     * one holding data, so that it is the segment sent without MSG_MORE. */
+    for( i = 0; i < xIovCount; i++ )
+    {
+        if( 0 != pxIov[ i ].xLength )
+        {
+            if( NULL == pxIov[ i ].pvBase )
+            {
+                return SOCKETS_EINVAL;
+            }
+
+            xEnd = i + 1;
+        }
+    }
+
+    i = 0;
+
+    while( i < xEnd )
+    {
+        if( ctx->enforce_tls )
+        {
+            /* Gather consecutive small buffers, such as an MQTT fixed header
+             * and topic, into one TLS record rather than a record each. */
+            xLength = 0;
+
+            while( ( i < xEnd ) &&
+                   ( pxIov[ i ].xLength <= ( sizeof( ucRecord ) - xLength ) ) )
+            {
+                if( 0 != pxIov[ i ].xLength )
+                {
+                    memcpy( &ucRecord[ xLength ], pxIov[ i ].pvBase, pxIov[ i ].xLength );
+                    xLength += pxIov[ i ].xLength;
+                }
+
+                i++;
+            }
+
+            if( 0 != xLength )
+            {
+                pvData = ucRecord;
+            }
+            else
+            {
+                /* Too large to gather; it goes through the TLS pipe as is. */
+                pvData  = pxIov[ i ].pvBase;
+                xLength = pxIov[ i ].xLength;
+                i++;
+            }
+
+            ctx->send_flag = ulFlags;
+            lRet           = TLS_Send( ctx->tls_ctx, pvData, xLength );
+        }
+        else
+        {
+            pvData  = pxIov[ i ].pvBase;
+            xLength = pxIov[ i ].xLength;
+
+            /* Hold back the segment until the last buffer with data has been
+             * queued. */
+            ctx->send_flag = ulFlags | ( ( i + 1 < xEnd ) ? MSG_MORE : 0 );
+            i++;
+
+            if( 0 == xLength )
+            {
+                continue;
+            }
+
+            lRet = prvNetworkSend( ( void * ) ctx, pvData, xLength );
+        }
+
+        if( lRet < 0 )
+        {
+            /* Report the error only if nothing was sent, otherwise the caller
+             * sees a short write. */
+            if( 0 == lSent )
+            {
+                lSent = lRet;
+            }
+
+            break;
+        }
+
+        lSent += lRet;
+
+        if( ( size_t )lRet != xLength )
+        {
+            break;
+        }
+    }
+
+    ctx->send_flag = ulFlags;
+
+    return lSent;
+}
+
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_Shutdown( Socket_t xSocket,
                           uint32_t ulHow )
 {
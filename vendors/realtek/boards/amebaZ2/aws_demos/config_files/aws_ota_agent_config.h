@@ -85,6 +85,34 @@
  */
 #define otaconfigMAX_NUM_BLOCKS_REQUEST         128U
 
+/**
+ * @brief The maximum number of data block requests kept in flight.
+ *
+ *  The agent sends the next data request before the blocks of the previous one are all received,
+ *  so the link does not idle for a round trip between requests. The number of blocks in flight
+ *  adapts to the round trip time and to block loss, up to this many requests of
+ *  otaconfigMAX_NUM_BLOCKS_REQUEST blocks. Set to 1 to wait for each request to complete before
+ *  sending the next one. Over HTTP a single request is in flight and this has no effect.
+ *
+ */
+#define otaconfigMAX_REQUESTS_IN_FLIGHT         2U
+
+/**
+ * @brief Resume an interrupted file download after a reset.
+ *
+ *  Set this to 1 to save the received block bitmap and the signature hash state every
+ *  otaconfigCHECKPOINT_INTERVAL_BLOCKS blocks, so that a reset during a download only costs the
+ *  blocks received since the last checkpoint. On this board the checkpoint is kept in the FTL,
+ *  which is only available when CONFIG_FTL_ENABLED is defined by the SDK.
+ *
+ */
+#define otaconfigRESUME_DOWNLOAD                0U
+
+/**
+ * @brief The number of blocks received between two download checkpoints.
+ */
+#define otaconfigCHECKPOINT_INTERVAL_BLOCKS     32U
+
 /**
  * @brief The maximum number of requests allowed to send without a response before we abort.
  *
@@ -112,6 +140,22 @@
  */
 #define otaconfigAllowDowngrade              0U
 
+/**
+ * @brief Verify the file signature while the file is being received.
+ *
+ * Set this to 1 to hash each block of the file as it is received, so that closing the file
+ * only finalizes the signature check instead of reading the whole image back from flash.
+ */
+#define otaconfigSTREAMING_SIGNATURE_VERIFICATION    1U
+
+/**
+ * @brief The number of out of order blocks held in RAM for streaming signature verification.
+ *
+ * Blocks received ahead of the next block to hash are kept until the blocks before them arrive.
+ * If a block arrives further ahead, the signature of the whole file is checked on close instead.
+ */
+#define otaconfigSTREAMING_REORDER_BLOCKS            4U
+
 /**
  * @brief The protocol selected for OTA control operations.
 
@@ -53,6 +53,11 @@
  */
 #define socketsconfigDEFAULT_MAX_NUM_SECURE_SOCKETS     4
 
-#define socketsconfigRECEIVE_CALLBACK_TASK_STACK_DEPTH	1024u
+/**
+ * @brief Stack depth of the task calling the receive callbacks of all the sockets.
+ *
+ * The network receive callbacks of MQTT and HTTPS connections run in this task.
+ */
+#define socketsconfigRECEIVE_CALLBACK_TASK_STACK_DEPTH	2048u
 
 #endif /* _AWS_SECURE_SOCKETS_CONFIG_H_ */
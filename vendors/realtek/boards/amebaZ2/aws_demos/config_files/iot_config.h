@@ -50,6 +50,10 @@
  * MQTT 3.1.1. Enable the serializer overrides of the MQTT library. */
 //#define IOT_MQTT_ENABLE_SERIALIZER_OVERRIDES    ( 1 )
 
+/* Receive on all network connections in the Secure Sockets receive callback
+ * task instead of a task per connection. */
+#define IOT_NETWORK_SHARED_RECEIVE_TASK    ( 1 )
+
 /* Include the common configuration file for FreeRTOS. */
 #include "iot_config_common.h"
 
@@ -49,5 +49,6 @@
 #define testrunnerFULL_MEMORYLEAK_ENABLED          0
 #define testrunnerFULL_TLS_ENABLED                 0
 #define testrunnerFULL_HTTPS_CLIENT_ENABLED        0
+#define testrunnerUTIL_PLATFORM_METRICS_ENABLED    1
 
 #endif /* AWS_TEST_RUNNER_CONFIG_H */
@@ -27,7 +27,35 @@
 /* Platform thread priority. */
 #define IOT_THREAD_DEFAULT_PRIORITY      5
 
+/* Receive on all network connections in the Secure Sockets receive callback
+ * task instead of a task per connection. */
+#define IOT_NETWORK_SHARED_RECEIVE_TASK    ( 1 )
+
+/* Coalesce outgoing MQTT packets and bound the QoS 1 PUBLISH messages in
+ * flight, so that the MQTT_Unit_API tests cover the transmit queue and the
+ * in-flight window. */
+#define IOT_MQTT_ENABLE_TRANSMIT_COALESCING    ( 1 )
+#define IOT_MQTT_MAX_INFLIGHT_PUBLISHES        ( 4 )
+
+/* Schedule task pool jobs through the lock-free work queues, so that the
+ * Common_Unit_Task_Pool tests cover them. The amebaD tests keep covering the
+ * dispatch queue. */
+#define IOT_TASKPOOL_ENABLE_WORK_STEALING    ( 1 )
+
+/* Keep deferred task pool jobs in the timer wheel, so that the Common_Unit_Task_Pool
+ * tests cover it. The amebaD tests keep covering the sorted timer list. */
+#define IOT_TASKPOOL_ENABLE_TIMER_WHEEL    ( 1 )
+
+/* Record the latency histograms, so that the UTIL_Platform_Metrics tests run.
+ * Latencies are measured with the SDK microsecond timer instead of the
+ * millisecond clock. */
+#define IOT_METRICS_ENABLE_HISTOGRAMS    ( 1 )
+#define IotMetrics_GetTimestampUs()      us_ticker_read()
+
 /* Include the common configuration file for FreeRTOS. */
 #include "iot_config_common.h"
 
+/* SDK microsecond timer, declared in us_ticker_api.h. */
+extern uint32_t us_ticker_read( void );
+
 #endif /* ifndef IOT_CONFIG_H_ */
@@ -38,6 +38,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <device_lock.h>
 #include "ota_8710c.h"
 #include "platform_stdlib.h"
+#if ( otaconfigRESUME_DOWNLOAD == 1U ) && defined(CONFIG_FTL_ENABLED)
+#include <ftl_int.h>
+#endif
 
 //================================================================================
 
@@ -54,6 +57,11 @@ static flash_t flash_ota;
 
 #define AWS_OTA_IMAGE_STATE_FLASH_OFFSET			0x00003000 // Flash reserved section 0x0000_3000 - 0x0000_4000-1
 
+/* The download checkpoint is kept in the last kilobyte of the FTL logical space. It starts with the
+ * image signature of the first block, which is only written to the image when it is activated. */
+#define AWS_OTA_CHECKPOINT_FTL_OFFSET				0x0C00
+#define AWS_OTA_CHECKPOINT_FTL_SIZE					0x03F0
+
 #define AWS_OTA_IMAGE_STATE_FLAG_IMG_NEW			0xffffffffU /* 11111111b A new image that hasn't yet been run. */
 #define AWS_OTA_IMAGE_STATE_FLAG_PENDING_COMMIT		0xfffffffeU /* 11111110b Image is pending commit and is ready for self test. */
 #define AWS_OTA_IMAGE_STATE_FLAG_IMG_VALID			0xfffffffcU /* 11111100b The image was accepted as valid by the self test code. */
@@ -71,6 +79,8 @@ uint32_t gNewImgLen=0;
 unsigned char sig_backup[32];
 static uint32_t aws_ota_imgsz = 0;
 static bool_t aws_ota_target_hdr_get = false;
+static bool_t wait_target_img = true;
+static uint32_t img_sign = 0;
 
 
 #if OTA_DEBUG && OTA_MEMDUMP
@@ -179,10 +189,139 @@ bool_t prvPAL_CreateFileForRx_amebaZ2(OTA_FileContext_t *C)
 	{
 		aws_ota_imgsz = 0;
 		aws_ota_target_hdr_get = false;
+#ifndef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+		/* Only the image is signed, not the signature appended to the file (see gNewImgLen). */
+		C->ulSignedSize = C->ulFileSize - (C->ulFileSize%1024);
+#endif
 	}
 	return ( C->lFileHandle > SPI_FLASH_BASE ) ? pdTRUE : pdFALSE;
 }
 
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+#if defined(CONFIG_FTL_ENABLED)
+/* Write a byte array to the FTL. Every FTL write takes a new cell, so only the words that changed are written. */
+static OTA_Err_t prvCheckpointWrite_amebaZ2(uint16_t usOffset, const uint8_t *pucData, uint32_t ulSize)
+{
+	uint32_t ulOld, ulNew, i;
+
+	for(i = 0; i < ulSize; i += 4){
+		ulNew = 0xFFFFFFFFU;
+		memcpy(&ulNew, &pucData[i], ((ulSize - i) < 4) ? (ulSize - i) : 4);
+		if((ftl_load_from_storage(&ulOld, usOffset + i, 4) != 0) || (ulOld != ulNew)){
+			if(ftl_save_to_storage(&ulNew, usOffset + i, 4) != 0){
+				OTA_PRINT("[%s] FTL write failed @ 0x%x\n", __FUNCTION__, usOffset + i);
+				return kOTA_Err_CheckpointFailed;
+			}
+		}
+	}
+	return kOTA_Err_None;
+}
+
+OTA_Err_t prvPAL_SaveCheckpoint_amebaZ2(OTA_FileContext_t *C, const uint8_t *pucData, uint32_t ulSize)
+{
+	uint32_t ulErased = 0;
+
+	if(pucData == NULL){
+		/* Clearing the first word of the checkpoint is enough for the agent to ignore it. */
+		return prvCheckpointWrite_amebaZ2(AWS_OTA_CHECKPOINT_FTL_OFFSET + AWS_OTA_IMAGE_SIGNATURE_LEN, (const uint8_t *)&ulErased, 4);
+	}
+	if(ulSize > (AWS_OTA_CHECKPOINT_FTL_SIZE - AWS_OTA_IMAGE_SIGNATURE_LEN)){
+		OTA_PRINT("[%s] Checkpoint of %d bytes is too large\n", __FUNCTION__, ulSize);
+		return kOTA_Err_CheckpointFailed;
+	}
+	/* The signature must be saved before a checkpoint tells the first block was written. */
+	if(wait_target_img == false){
+		if(prvCheckpointWrite_amebaZ2(AWS_OTA_CHECKPOINT_FTL_OFFSET, sig_backup, AWS_OTA_IMAGE_SIGNATURE_LEN) != kOTA_Err_None)
+			return kOTA_Err_CheckpointFailed;
+	}
+	return prvCheckpointWrite_amebaZ2(AWS_OTA_CHECKPOINT_FTL_OFFSET + AWS_OTA_IMAGE_SIGNATURE_LEN, pucData, ulSize);
+}
+
+OTA_Err_t prvPAL_LoadCheckpoint_amebaZ2(OTA_FileContext_t *C, uint8_t *pucData, uint32_t ulSize)
+{
+	uint32_t ulWord, i;
+
+	if(ulSize > (AWS_OTA_CHECKPOINT_FTL_SIZE - AWS_OTA_IMAGE_SIGNATURE_LEN))
+		ulSize = AWS_OTA_CHECKPOINT_FTL_SIZE - AWS_OTA_IMAGE_SIGNATURE_LEN;
+
+	for(i = 0; i < ulSize; i += 4){
+		/* Words never written read as erased, the agent checks what it gets. */
+		if(ftl_load_from_storage(&ulWord, AWS_OTA_CHECKPOINT_FTL_OFFSET + AWS_OTA_IMAGE_SIGNATURE_LEN + i, 4) != 0){
+			if(i == 0)
+				return kOTA_Err_CheckpointFailed;
+			ulWord = 0xFFFFFFFFU;
+		}
+		memcpy(&pucData[i], &ulWord, ((ulSize - i) < 4) ? (ulSize - i) : 4);
+	}
+	return kOTA_Err_None;
+}
+
+static bool_t prvCheckpointLoadSignature_amebaZ2(void)
+{
+	return (ftl_load_from_storage(sig_backup, AWS_OTA_CHECKPOINT_FTL_OFFSET, AWS_OTA_IMAGE_SIGNATURE_LEN) == 0) ? pdTRUE : pdFALSE;
+}
+#else
+OTA_Err_t prvPAL_SaveCheckpoint_amebaZ2(OTA_FileContext_t *C, const uint8_t *pucData, uint32_t ulSize)
+{
+	/* Without the FTL there is nowhere to keep the checkpoint. */
+	return kOTA_Err_CheckpointFailed;
+}
+
+OTA_Err_t prvPAL_LoadCheckpoint_amebaZ2(OTA_FileContext_t *C, uint8_t *pucData, uint32_t ulSize)
+{
+	return kOTA_Err_CheckpointFailed;
+}
+
+static bool_t prvCheckpointLoadSignature_amebaZ2(void)
+{
+	return pdFALSE;
+}
+#endif /* defined(CONFIG_FTL_ENABLED) */
+
+/* Reopen the upgrade region of an interrupted download, without erasing it again, and restore the
+ * state prvPAL_WriteBlock_amebaZ2() keeps about the blocks already written. */
+OTA_Err_t prvPAL_ResumeFileForRx_amebaZ2(OTA_FileContext_t *C)
+{
+	uint32_t ulBlock, ulNumBlocks, ulOffset;
+
+	C->lFileHandle = sys_update_ota_prepare_addr() + SPI_FLASH_BASE;
+	if (C->lFileHandle <= SPI_FLASH_BASE)
+		return kOTA_Err_RxFileCreateFailed;
+
+	OTA_LOG_L1("Resume download to address 0x%x\r\n", C->lFileHandle);
+
+	gNewImgLen = C->ulFileSize - (C->ulFileSize%1024);
+#ifndef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+	C->ulSignedSize = gNewImgLen;
+#endif
+	aws_ota_target_hdr_get = true;
+	wait_target_img = true;
+	img_sign = 0;
+	aws_ota_imgsz = 0;
+
+	if((C->pucRxBlockBitmap[0] & 1U) == 0U){
+		/* The first block was written. Its signature isn't, so get it back from the checkpoint. */
+		if(prvCheckpointLoadSignature_amebaZ2() == pdTRUE){
+			wait_target_img = false;
+			img_sign = AWS_OTA_IMAGE_SIGNATURE_LEN;
+		}
+		else{
+			C->pucRxBlockBitmap[0] |= 1U;
+			C->ulBlocksRemaining++;
+		}
+	}
+
+	/* Count the image bytes already written as prvPAL_WriteBlock_amebaZ2() does. */
+	ulNumBlocks = (C->ulFileSize + OTA_FILE_BLOCK_SIZE - 1) / OTA_FILE_BLOCK_SIZE;
+	for(ulBlock = 0; ulBlock < ulNumBlocks; ulBlock++){
+		ulOffset = ulBlock * OTA_FILE_BLOCK_SIZE;
+		if(((C->pucRxBlockBitmap[ulBlock / 8] & (1U << (ulBlock % 8))) == 0U) && (ulOffset < gNewImgLen))
+			aws_ota_imgsz += ((gNewImgLen - ulOffset) < OTA_FILE_BLOCK_SIZE) ? (gNewImgLen - ulOffset) : OTA_FILE_BLOCK_SIZE;
+	}
+	return kOTA_Err_None;
+}
+#endif /* otaconfigRESUME_DOWNLOAD == 1U */
+
 /* Read the specified signer certificate from the filesystem into a local buffer. The
  * allocated memory becomes the property of the caller who is responsible for freeing it.
  */
@@ -278,18 +417,30 @@ OTA_Err_t prvPAL_CheckFileSignature_amebaZ2(OTA_FileContext_t * const C)
     int32_t lSignerCertSize;
     void *pvSigVerifyContext;
     uint8_t *pucSignerCert = NULL;
+    bool_t bReadBack = false;
 
     mbedtls_platform_set_calloc_free(calloc_freertos, vPortFree);
 
     while(true)
     {
+        if (C->pvSigVerifyContext != NULL)
+        {
+            /* The OTA agent already hashed the image as it was received, take over its context. */
+            pvSigVerifyContext = C->pvSigVerifyContext;
+            C->pvSigVerifyContext = NULL;
+        }
         /* Verify an ECDSA-SHA256 signature. */
-        if (CRYPTO_SignatureVerificationStart( &pvSigVerifyContext, cryptoASYMMETRIC_ALGORITHM_ECDSA,
+        else if (CRYPTO_SignatureVerificationStart( &pvSigVerifyContext, cryptoASYMMETRIC_ALGORITHM_ECDSA,
                                               cryptoHASH_ALGORITHM_SHA256) == pdFALSE)
         {
             eResult = kOTA_Err_SignatureCheckFailed;
             break;
         }
+        else
+        {
+            /* Read the image back from flash to hash it. */
+            bReadBack = true;
+        }
 
         OTA_LOG_L1( "[%s] Started %s signature verification, file: %s\r\n", OTA_METHOD_NAME,
                    cOTA_JSON_FileSignatureKey, (const char*)C->pucCertFilepath);
@@ -300,11 +451,14 @@ OTA_Err_t prvPAL_CheckFileSignature_amebaZ2(OTA_FileContext_t * const C)
             break;
         }
 
-        eResult = prvSignatureVerificationUpdate_amebaZ2(C, pvSigVerifyContext);
-        if(eResult != kOTA_Err_None)
+        if (bReadBack == true)
         {
-            break;
-		}
+            eResult = prvSignatureVerificationUpdate_amebaZ2(C, pvSigVerifyContext);
+            if(eResult != kOTA_Err_None)
+            {
+                break;
+            }
+        }
         if ( CRYPTO_SignatureVerificationFinal(pvSigVerifyContext, (char*)pucSignerCert, lSignerCertSize,
                                                     C->pxSignature->ucData, C->pxSignature->usSize ) == pdFALSE )
         {
@@ -362,11 +516,33 @@ OTA_Err_t prvPAL_CloseFile_amebaZ2(OTA_FileContext_t *C)
     return eResult;
 }
 
-int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t* pacData, uint32_t iBlockSize)
+/* Writes file data to flash, with the flash lock held by the caller.
+ *
+ * With otaconfigSTREAMING_SIGNATURE_VERIFICATION the agent hashes each block as it is
+ * received, and the image is no longer read back from flash to check its signature. The
+ * written data is read back and compared here instead, so that the signature check covers
+ * what is in flash: a block that did not write correctly fails, and is not hashed. */
+static int prvFlashWrite_amebaZ2(uint32_t address, uint32_t len, uint8_t *pData)
 {
-    static bool_t wait_target_img = true;
-    static uint32_t img_sign = 0;
+	int ret = flash_stream_write(&flash_ota, address, len, pData);
+#if ( otaconfigSTREAMING_SIGNATURE_VERIFICATION == 1U )
+	uint8_t readBack[64];
+	uint32_t i, rlen;
+
+	for(i = 0; (ret >= 0) && (i < len); i += rlen){
+		rlen = ((len - i) > sizeof(readBack)) ? sizeof(readBack) : (len - i);
+		if((flash_stream_read(&flash_ota, address + i, rlen, readBack) < 0) ||
+		   (memcmp(readBack, pData + i, rlen) != 0)){
+			OTA_PRINT("[%s] Read back mismatch @ 0x%x\n", __FUNCTION__, address + i);
+			ret = -1;
+		}
+	}
+#endif
+	return ret;
+}
 
+int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t* pacData, uint32_t iBlockSize)
+{
 	uint32_t address = C->lFileHandle - SPI_FLASH_BASE;
     uint32_t NewImg2Len = 0;
     uint32_t NewImg2BlkSize = 0;
@@ -377,7 +553,7 @@ int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t
 		OTA_PRINT("[OTA_TEST] Write %d bytes @ 0x%x\n", iBlockSize, address+iOffset);
 		device_mutex_lock(RT_DEV_LOCK_FLASH);
 		flash_erase_sector(&flash_ota, C->lFileHandle - SPI_FLASH_BASE);
-		if(flash_stream_write(&flash_ota, address+iOffset, iBlockSize, pacData) < 0){
+		if(prvFlashWrite_amebaZ2(address+iOffset, iBlockSize, pacData) < 0){
 			OTA_PRINT("[%s] Write sector failed\n", __FUNCTION__);
 			device_mutex_unlock(RT_DEV_LOCK_FLASH);
 			return -1;
@@ -467,7 +643,7 @@ int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t
 
 		device_mutex_lock(RT_DEV_LOCK_FLASH);
 		OTA_PRINT("[OTA] FIRST Write %d bytes @ 0x%x\n", byte_to_write, address);
-		if(flash_stream_write(&flash_ota, address+AWS_OTA_IMAGE_SIGNATURE_LEN, byte_to_write, pacData) < 0){
+		if(prvFlashWrite_amebaZ2(address+AWS_OTA_IMAGE_SIGNATURE_LEN, byte_to_write, pacData) < 0){
 			OTA_PRINT("[%s] Write sector failed\n", __FUNCTION__);
 			device_mutex_unlock(RT_DEV_LOCK_FLASH);
 			return -1;
@@ -493,7 +669,7 @@ int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t
 
 	device_mutex_lock(RT_DEV_LOCK_FLASH);
 	OTA_PRINT("[OTA] Write %d bytes @ 0x%x (0x%x)\n", WriteLen, address + offset, (address + offset));
-	if(flash_stream_write(&flash_ota, address + offset, WriteLen, pacData) < 0){
+	if(prvFlashWrite_amebaZ2(address + offset, WriteLen, pacData) < 0){
 		OTA_PRINT("[%s] Write sector failed\n", __FUNCTION__);
 		device_mutex_unlock(RT_DEV_LOCK_FLASH);
 		return -1;
@@ -105,6 +105,9 @@ int16_t prvPAL_WriteBlock_amebaZ2(OTA_FileContext_t *C, int32_t iOffset, uint8_t
 OTA_Err_t prvPAL_ActivateNewImage_amebaZ2(void);
 OTA_Err_t prvPAL_SetPlatformImageState_amebaZ2 (OTA_ImageState_t eState);
 OTA_PAL_ImageState_t prvPAL_GetPlatformImageState_amebaZ2( void );
+OTA_Err_t prvPAL_SaveCheckpoint_amebaZ2(OTA_FileContext_t *C, const uint8_t *pucData, uint32_t ulSize);
+OTA_Err_t prvPAL_LoadCheckpoint_amebaZ2(OTA_FileContext_t *C, uint8_t *pucData, uint32_t ulSize);
+OTA_Err_t prvPAL_ResumeFileForRx_amebaZ2(OTA_FileContext_t *C);
 #else
 #error "This platform is not supported!"
 #endif
@@ -185,6 +188,33 @@ OTA_PAL_ImageState_t prvPAL_GetPlatformImageState( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( otaconfigRESUME_DOWNLOAD == 1U )
+OTA_Err_t prvPAL_SaveCheckpoint( OTA_FileContext_t * const C,
+                                 const uint8_t * pucData,
+                                 uint32_t ulSize )
+{
+    DEFINE_OTA_METHOD_NAME( "prvPAL_SaveCheckpoint" );
+	return prvPAL_SaveCheckpoint_amebaZ2(C, pucData, ulSize);
+}
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_LoadCheckpoint( OTA_FileContext_t * const C,
+                                 uint8_t * const pucData,
+                                 uint32_t ulSize )
+{
+    DEFINE_OTA_METHOD_NAME( "prvPAL_LoadCheckpoint" );
+	return prvPAL_LoadCheckpoint_amebaZ2(C, pucData, ulSize);
+}
+/*-----------------------------------------------------------*/
+
+OTA_Err_t prvPAL_ResumeFileForRx( OTA_FileContext_t * const C )
+{
+    DEFINE_OTA_METHOD_NAME( "prvPAL_ResumeFileForRx" );
+	return prvPAL_ResumeFileForRx_amebaZ2(C);
+}
+/*-----------------------------------------------------------*/
+#endif
+
 /* Provide access to private members for testing. */
 #ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
     #include "aws_ota_pal_test_access_define.h"
@@ -41,12 +41,37 @@
 #include "iot_tls.h"
 #include "FreeRTOSConfig.h"
 #include "task.h"
+#include "semphr.h"
 #include <stdbool.h>
 
 #undef _SECURE_SOCKETS_WRAPPER_NOT_REDEFINE
 
 /*-----------------------------------------------------------*/
 
+/*
+ * The priority of the task calling the socket receive callbacks.
+ */
+#ifndef socketsconfigRECEIVE_CALLBACK_TASK_PRIORITY
+    #define socketsconfigRECEIVE_CALLBACK_TASK_PRIORITY    ( 1 )
+#endif
+
+/*
+ * The maximum time the receive callback task waits before it picks up the
+ * sockets registered while it was waiting, when it can't be woken through the
+ * loopback interface.
+ */
+#ifndef socketsconfigRECEIVE_CALLBACK_POLL_MS
+    #define socketsconfigRECEIVE_CALLBACK_POLL_MS          ( 100 )
+#endif
+
+/*
+ * The size of the buffer SOCKETS_Sendv() gathers consecutive small buffers in,
+ * so that they are sent as one TLS record. It is allocated on the stack.
+ */
+#ifndef socketsconfigSENDV_TLS_RECORD_BYTES
+    #define socketsconfigSENDV_TLS_RECORD_BYTES            ( 128 )
+#endif
+
 #define SS_STATUS_CONNECTED     (1)
 #define SS_STATUS_SECURED       (2)
 
@@ -70,8 +95,10 @@ typedef struct _ss_ctx_t
     int     send_flag;
     int     recv_flag;
 
-    TaskHandle_t    rx_handle;
     void            (*rx_callback)( Socket_t pxSocket );
+    struct _ss_ctx_t    *rx_next;
+    bool            rx_ready;
+    bool            rx_pending;
 
     bool    enforce_tls;
     void    *tls_ctx;
@@ -93,6 +120,22 @@ typedef struct _ss_ctx_t
 /*static int8_t sockets_allocated = SUPPORTED_DESCRIPTORS; */
 static int8_t sockets_allocated = socketsconfigDEFAULT_MAX_NUM_SECURE_SOCKETS;
 
+/*
+ * Sockets with a receive callback, the task that calls the callbacks and the
+ * socket whose callback is running.
+ */
+static ss_ctx_t             *rx_sockets = NULL;
+static SemaphoreHandle_t    rx_mutex    = NULL;
+static TaskHandle_t         rx_task     = NULL;
+static ss_ctx_t             *rx_active  = NULL;
+
+/*
+ * UDP socket bound to the loopback address that wakes the receive callback
+ * task from select, and its address.
+ */
+static int                  rx_wake_socket = -1;
+static struct sockaddr_in   rx_wake_addr;
+
 
 /*-----------------------------------------------------------*/
 
@@ -180,83 +223,370 @@ static BaseType_t prvNetworkRecv( void * pvContext,
 
 /*-----------------------------------------------------------*/
 
+static void prvRxWakeInit( void );
+static void prvRxWake( void );
+
+/*
+ * @brief Reactor task serving the receive callbacks of all the sockets.
+ *
+ * A single task waits on every socket with a receive callback and calls the
+ * callbacks of the ones that are ready, so a callback costs a list entry
+ * instead of a task stack. A registration wakes the task through the
+ * loopback socket, so the task blocks until a socket is ready. Without a
+ * loopback interface, registrations are picked up within
+ * socketsconfigRECEIVE_CALLBACK_POLL_MS instead. The task blocks on its
+ * notification while no socket is registered.
+ *
+ * The callbacks run without rx_mutex, so a slow callback does not block other
+ * tasks registering, configuring or closing their sockets. The socket of a
+ * running callback is rx_active, and prvRxSelectClear() waits for it in other
+ * tasks, so a callback is still not running once its socket is unregistered.
+ *
+ * A TLS socket is dispatched again without waiting while its TLS context holds
+ * decrypted data, but only as long as its callback reads some of it. Otherwise
+ * the socket waits until it is readable again, instead of spinning.
+ */
 static void vTaskRxSelect( void * param )
 {
-    ss_ctx_t *  ctx = ( ss_ctx_t * )param;
-    int         s   = ctx->ip_socket;
+    ss_ctx_t *      ctx;
+    void            (*rx_callback)( Socket_t pxSocket );
+    size_t          available;
+    size_t          remaining;
+    int             max_fd;
+    int             wake_fd;
+    bool            pending;
+    bool            retry;
+    struct timeval  tv;
+    struct timeval  *ptv;
+    uint8_t         drain[ 4 ];
 
     fd_set      read_fds;
-    fd_set      write_fds;
     fd_set      err_fds;
 
-    FD_ZERO (&read_fds);
-    FD_ZERO (&write_fds);
-    FD_ZERO (&err_fds);
-
-    FD_SET  (s, &read_fds);
-    FD_SET  (s, &err_fds);
+    ( void ) param;
 
-    ctx->state = SST_RX_READY;
+    xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+    prvRxWakeInit();
+    xSemaphoreGiveRecursive( rx_mutex );
 
     while( 1 )
     {
-        if (ctx->state == SST_RX_CLOSING)
+        FD_ZERO (&read_fds);
+        FD_ZERO (&err_fds);
+        max_fd  = -1;
+        pending = false;
+
+        xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+
+        wake_fd = ( rx_sockets != NULL ) ? rx_wake_socket : -1;
+
+        if( wake_fd >= 0 )
         {
-            ctx->rx_handle = NULL;
-            ctx->state = SST_RX_CLOSED;
-            vTaskDelete( NULL );
+            FD_SET  (wake_fd, &read_fds);
+            max_fd = wake_fd;
         }
 
-        if( lwip_select( s + 1, &read_fds, &write_fds, &err_fds, NULL ) == -1 )
+        for( ctx = rx_sockets; ctx != NULL; ctx = ctx->rx_next )
         {
-            /*TaskHandle_t rx_handle = ctx->rx_handle; */
+            FD_SET  (ctx->ip_socket, &read_fds);
+            FD_SET  (ctx->ip_socket, &err_fds);
 
-            /*ctx->rx_handle   = NULL; */
-            /*ctx->rx_callback = NULL; */
+            if( ctx->ip_socket > max_fd )
+            {
+                max_fd = ctx->ip_socket;
+            }
+
+            pending |= ctx->rx_pending;
+        }
+
+        xSemaphoreGiveRecursive( rx_mutex );
+
+        if( max_fd < 0 )
+        {
+            /* Nothing to wait on until a socket is registered. */
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+            continue;
+        }
+
+        /* Do not wait if a TLS context still holds data for a callback, and
+         * only wait until the next registration if nothing can wake the task. */
+        tv.tv_sec  = pending ? 0 : ( socketsconfigRECEIVE_CALLBACK_POLL_MS / 1000 );
+        tv.tv_usec = pending ? 0 : ( ( socketsconfigRECEIVE_CALLBACK_POLL_MS % 1000 ) * 1000 );
+        ptv        = ( pending || ( wake_fd < 0 ) ) ? &tv : NULL;
+
+        if( lwip_select( max_fd + 1, &read_fds, NULL, &err_fds, ptv ) < 0 )
+        {
+            /* A socket was closed while it was waited on. Rebuild the set, but
+             * do not spin if the error persists. */
+            FD_ZERO (&read_fds);
+            FD_ZERO (&err_fds);
+
+            if( !pending )
+            {
+                vTaskDelay( pdMS_TO_TICKS( socketsconfigRECEIVE_CALLBACK_POLL_MS ) );
+                continue;
+            }
+        }
+
+        xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
 
-            /*vTaskDelete( rx_handle ); */
-            ctx->rx_handle = NULL;
-            vTaskDelete( NULL );
+        /* The wake socket is closed if waking fails, and its descriptor may
+         * have been reused since. */
+        if( ( wake_fd >= 0 ) && ( wake_fd == rx_wake_socket ) && FD_ISSET( wake_fd, &read_fds ) )
+        {
+            while( lwip_recv( wake_fd, drain, sizeof( drain ), MSG_DONTWAIT ) > 0 )
+            {
+            }
         }
 
-        if( FD_ISSET( s, &read_fds ) )
+        for( ctx = rx_sockets; ctx != NULL; ctx = ctx->rx_next )
         {
-            configASSERT( ctx->rx_callback );
-            ctx->rx_callback( ( Socket_t )ctx );
-            /*vTaskDelay( 10 ); // delay a little bit to yield time for RX */
+            ctx->rx_ready = ctx->rx_pending ||
+                            FD_ISSET( ctx->ip_socket, &read_fds ) ||
+                            FD_ISSET( ctx->ip_socket, &err_fds );
+        }
+
+        /* A callback may register or unregister sockets, so look for the next
+         * ready socket from the head of the list after each call. */
+        do
+        {
+            for( ctx = rx_sockets; ctx != NULL; ctx = ctx->rx_next )
+            {
+                if( ctx->rx_ready )
+                {
+                    break;
+                }
+            }
+
+            if( ctx != NULL )
+            {
+                ctx->rx_ready = false;
+                rx_callback   = ctx->rx_callback;
+
+                /* Whether the socket only has data left in its TLS context. */
+                retry     = ctx->rx_pending &&
+                            !FD_ISSET( ctx->ip_socket, &read_fds ) &&
+                            !FD_ISSET( ctx->ip_socket, &err_fds );
+                available = retry ? TLS_GetBytesAvailable( ctx->tls_ctx ) : 0;
+
+                /* prvRxSelectClear() clears rx_active if the callback
+                 * unregisters or closes the socket, which may be freed before
+                 * the callback returns. */
+                rx_active = ctx;
+                xSemaphoreGiveRecursive( rx_mutex );
+
+                rx_callback( ( Socket_t )ctx );
+
+                xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+
+                /* Dispatch the socket again at once while data is left in its
+                 * TLS context, unless the callback read none of it. */
+                if( rx_active == ctx )
+                {
+                    if( ( ctx->rx_callback != NULL ) && ctx->enforce_tls )
+                    {
+                        remaining       = TLS_GetBytesAvailable( ctx->tls_ctx );
+                        ctx->rx_pending = ( remaining > 0 ) && ( !retry || ( remaining < available ) );
+                    }
+                    else
+                    {
+                        ctx->rx_pending = false;
+                    }
+                }
+
+                rx_active = NULL;
+            }
+        } while( ctx != NULL );
+
+        xSemaphoreGiveRecursive( rx_mutex );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Open the socket that wakes the receive callback task from select.
+ *
+ * lwIP can't wait on a socket and a task notification at once, so the task
+ * also waits on a UDP socket bound to the loopback address, to which
+ * prvRxWake() sends a datagram. Called by the task with rx_mutex held. If the
+ * socket can't be opened, the task polls instead.
+ */
+static void prvRxWakeInit( void )
+{
+    socklen_t   len = sizeof( rx_wake_addr );
+    int         s   = lwip_socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+
+    if( s < 0 )
+    {
+        return;
+    }
+
+    memset( &rx_wake_addr, 0, sizeof( rx_wake_addr ) );
+    rx_wake_addr.sin_family      = AF_INET;
+    rx_wake_addr.sin_port        = 0;
+    rx_wake_addr.sin_addr.s_addr = PP_HTONL( INADDR_LOOPBACK );
+
+    if( ( lwip_bind( s, ( struct sockaddr * )&rx_wake_addr, sizeof( rx_wake_addr ) ) == 0 ) &&
+        ( lwip_getsockname( s, ( struct sockaddr * )&rx_wake_addr, &len ) == 0 ) )
+    {
+        rx_wake_socket = s;
+    }
+    else
+    {
+        lwip_close( s );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Wake the receive callback task from select. Called with rx_mutex held.
+ *
+ * The loopback socket can be bound without a loopback interface, in which case
+ * sending fails. The socket is then closed and the task polls instead.
+ */
+static void prvRxWake( void )
+{
+    uint8_t wake = 0;
+
+    if( rx_wake_socket >= 0 )
+    {
+        if( lwip_sendto( rx_wake_socket, &wake, sizeof( wake ), 0,
+                         ( struct sockaddr * )&rx_wake_addr, sizeof( rx_wake_addr ) ) < 0 )
+        {
+            lwip_close( rx_wake_socket );
+            rx_wake_socket = -1;
         }
     }
 }
 
 /*-----------------------------------------------------------*/
 
-static void prvRxSelectSet( ss_ctx_t * ctx,
-                            const void * pvOptionValue )
+/*
+ * @brief Create the receive callback mutex once.
+ */
+static BaseType_t prvRxSelectInit( void )
 {
-    BaseType_t xReturned;
-    TaskHandle_t xHandle = NULL;
+    static StaticSemaphore_t xMutexBuffer;
+
+    if( rx_mutex == NULL )
+    {
+        vTaskSuspendAll();
+        {
+            if( rx_mutex == NULL )
+            {
+                rx_mutex = xSemaphoreCreateRecursiveMutexStatic( &xMutexBuffer );
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+    return ( rx_mutex != NULL ) ? pdPASS : pdFAIL;
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Register a socket with the reactor task, creating the task for the
+ *        first socket.
+ */
+static int32_t prvRxSelectSet( ss_ctx_t * ctx,
+                               const void * pvOptionValue )
+{
+    BaseType_t xReturned = pdPASS;
     configSTACK_DEPTH_TYPE xStackDepth = socketsconfigRECEIVE_CALLBACK_TASK_STACK_DEPTH;
 
-    ctx->rx_callback = (void (*)(Socket_t))pvOptionValue;
+    if( prvRxSelectInit() != pdPASS )
+    {
+        return SOCKETS_ENOMEM;
+    }
+
+    xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+
+    if( rx_task == NULL )
+    {
+        xReturned = xTaskCreate( vTaskRxSelect,   /* pvTaskCode */
+                                 "rxs",           /* pcName */
+                                 xStackDepth,     /* usStackDepth */
+                                 NULL,            /* pvParameters */
+                                 socketsconfigRECEIVE_CALLBACK_TASK_PRIORITY, /* uxPriority */
+                                 &rx_task );      /* pxCreatedTask */
+    }
+
+    if( xReturned == pdPASS )
+    {
+        if( ctx->rx_callback == NULL )
+        {
+            ctx->rx_next = rx_sockets;
+            rx_sockets   = ctx;
+        }
 
-    xReturned = xTaskCreate( vTaskRxSelect,   /* pvTaskCode */
-                               "rxs",         /* pcName */
-                               xStackDepth,   /* usStackDepth */
-                               ctx,           /* pvParameters */
-                               1,             /* uxPriority */
-                               &xHandle );    /* pxCreatedTask */
+        ctx->rx_callback = (void (*)(Socket_t))pvOptionValue;
+        ( void ) xTaskNotifyGive( rx_task );
+        prvRxWake();
+    }
 
-    configASSERT( xReturned == pdPASS );
-    configASSERT( xHandle != NULL );
+    xSemaphoreGiveRecursive( rx_mutex );
 
-    ctx->rx_handle   = xHandle;
+    return ( xReturned == pdPASS ) ? SOCKETS_ERROR_NONE : SOCKETS_ENOMEM;
 }
 
 /*-----------------------------------------------------------*/
 
+/*
+ * @brief Unregister a socket from the reactor task.
+ *
+ * Once this returns, the callback of the socket is not running and will not be
+ * called again, unless this is called from the callback itself. The task is
+ * woken so that it stops waiting on the socket, which may be closed next.
+ */
 static void prvRxSelectClear( ss_ctx_t * ctx )
 {
-    /* TODO */
+    ss_ctx_t ** ppxLink;
+
+    if( rx_mutex == NULL )
+    {
+        return;
+    }
+
+    xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+
+    for( ppxLink = &rx_sockets; *ppxLink != NULL; ppxLink = &( *ppxLink )->rx_next )
+    {
+        if( *ppxLink == ctx )
+        {
+            *ppxLink         = ctx->rx_next;
+            ctx->rx_next     = NULL;
+            ctx->rx_callback = NULL;
+            ctx->rx_ready    = false;
+            ctx->rx_pending  = false;
+            prvRxWake();
+            break;
+        }
+    }
+
+    if( rx_active == ctx )
+    {
+        if( xTaskGetCurrentTaskHandle() == rx_task )
+        {
+            /* The callback is unregistering its own socket, which it may free
+             * next. The task must not touch the socket once it returns. */
+            rx_active = NULL;
+        }
+        else
+        {
+            /* Wait for the callback running in the task. */
+            while( rx_active == ctx )
+            {
+                xSemaphoreGiveRecursive( rx_mutex );
+                vTaskDelay( 1 );
+                xSemaphoreTakeRecursive( rx_mutex, portMAX_DELAY );
+            }
+        }
+    }
+
+    xSemaphoreGiveRecursive( rx_mutex );
 }
 
 /*-----------------------------------------------------------*/
@@ -481,6 +811,134 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_Sendv( Socket_t xSocket,
+                       const SocketsIovec_t * pxIov,
+                       size_t xIovCount,
+                       uint32_t ulFlags )
+{
+    ss_ctx_t *   ctx;
+    size_t       i;
+    size_t       xEnd    = 0;
+    size_t       xLength = 0;
+    const void * pvData  = NULL;
+    uint8_t      ucRecord[ socketsconfigSENDV_TLS_RECORD_BYTES ];
+    int32_t      lSent   = 0;
+    int32_t      lRet    = 0;
+
+    if( SOCKETS_INVALID_SOCKET == xSocket )
+    {
+        return SOCKETS_SOCKET_ERROR;
+    }
+
+    if( ( NULL == pxIov ) || ( 0 == xIovCount ) )
+    {
+        return SOCKETS_EINVAL;
+    }
+
+    ctx = ( ss_ctx_t * )xSocket;
+
+    if( 0 > ctx->ip_socket )
+    {
+        return SOCKETS_SOCKET_ERROR;
+    }
+
+    /* Check the buffers before sending anything, and find the end of the last
+     * one holding data, so that it is the segment sent without MSG_MORE. */
+    for( i = 0; i < xIovCount; i++ )
+    {
+        if( 0 != pxIov[ i ].xLength )
+        {
+            if( NULL == pxIov[ i ].pvBase )
+            {
+                return SOCKETS_EINVAL;
+            }
+
+            xEnd = i + 1;
+        }
+    }
+
+    i = 0;
+
+    while( i < xEnd )
+    {
+        if( ctx->enforce_tls )
+        {
+            /* Gather consecutive small buffers, such as an MQTT fixed header
+             * and topic, into one TLS record rather than a record each. */
+            xLength = 0;
+
+            while( ( i < xEnd ) &&
+                   ( pxIov[ i ].xLength <= ( sizeof( ucRecord ) - xLength ) ) )
+            {
+                if( 0 != pxIov[ i ].xLength )
+                {
+                    memcpy( &ucRecord[ xLength ], pxIov[ i ].pvBase, pxIov[ i ].xLength );
+                    xLength += pxIov[ i ].xLength;
+                }
+
+                i++;
+            }
+
+            if( 0 != xLength )
+            {
+                pvData = ucRecord;
+            }
+            else
+            {
+                /* Too large to gather; it goes through the TLS pipe as is. */
+                pvData  = pxIov[ i ].pvBase;
+                xLength = pxIov[ i ].xLength;
+                i++;
+            }
+
+            ctx->send_flag = ulFlags;
+            lRet           = TLS_Send( ctx->tls_ctx, pvData, xLength );
+        }
+        else
+        {
+            pvData  = pxIov[ i ].pvBase;
+            xLength = pxIov[ i ].xLength;
+
+            /* Hold back the segment until the last buffer with data has been
+             * queued. */
+            ctx->send_flag = ulFlags | ( ( i + 1 < xEnd ) ? MSG_MORE : 0 );
+            i++;
+
+            if( 0 == xLength )
+            {
+                continue;
+            }
+
+            lRet = prvNetworkSend( ( void * ) ctx, pvData, xLength );
+        }
+
+        if( lRet < 0 )
+        {
+            /* Report the error only if nothing was sent, otherwise the caller
+             * sees a short write. */
+            if( 0 == lSent )
+            {
+                lSent = lRet;
+            }
+
+            break;
+        }
+
+        lSent += lRet;
+
+        if( ( size_t )lRet != xLength )
+        {
+            break;
+        }
+    }
+
+    ctx->send_flag = ulFlags;
+
+    return lSent;
+}
+
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_Shutdown( Socket_t xSocket,
                           uint32_t ulHow )
 {
@@ -524,6 +982,9 @@ int32_t SOCKETS_Close( Socket_t xSocket )
 
     ctx = ( ss_ctx_t * )xSocket;
 
+    /* Stop the receive callback before the socket is freed. */
+    prvRxSelectClear( ctx );
+
     /* Clean-up application protocol array. */
     if( NULL != ctx->ppcAlpnProtocols )
     {
@@ -547,18 +1008,6 @@ int32_t SOCKETS_Close( Socket_t xSocket )
 
     if( 0 <= ctx->ip_socket )
     {
-        if( ctx->rx_handle != NULL )
-        {
-	        int   cnt = 0;
-	        ctx->state = SST_RX_CLOSING;
-
-	        while ((ctx->state != SST_RX_CLOSED) && (cnt<30))
-	        {
-	            cnt++;
-	            vTaskDelay( 10 );
-	        }
-        }
-
         lwip_close( ctx->ip_socket );
 
         sockets_allocated ++;
@@ -727,7 +1176,7 @@ int32_t SOCKETS_SetSockOpt( Socket_t xSocket,
             if( ( xOptionLength == sizeof( void * ) ) &&
                 ( pvOptionValue != NULL ) )
             {
-                prvRxSelectSet( ctx, pvOptionValue );
+                return prvRxSelectSet( ctx, pvOptionValue );
             }
             else
             {
@@ -191,6 +191,9 @@ a lot of data that needs to be copied, this should be set high. */
 /* ---------- UDP options ---------- */
 #define LWIP_UDP                1
 #define UDP_TTL                 255
+/* ---------- Loopback options ---------- */
+/* Lets a socket registration wake the secure sockets receive callback task from select. */
+#define LWIP_NETIF_LOOPBACK             1
 /* ---------- DNS options ---------- */
 #define LWIP_DNS                        1
 
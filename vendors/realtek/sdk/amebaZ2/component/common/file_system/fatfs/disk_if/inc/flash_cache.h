@@ -0,0 +1,95 @@
+#ifndef _FLASH_CACHE_H_
+#define _FLASH_CACHE_H_
+/*
+ *  Write-back sector cache between FatFs and NOR flash
+ *
+ *  FatFs rewrites the FAT and directory sectors on every file update, and a
+ *  NOR flash sector has to be erased before bits can go from 0 to 1. The
+ *  cache keeps the last written sectors in RAM and programs them on sync or
+ *  eviction. When flash is programmed, sectors whose new contents only clear
+ *  bits, which includes blank sectors, are not erased, and adjacent sectors
+ *  are programmed with one write.
+ *
+ *  The cache has no dependency on the flash driver: the device functions are
+ *  given at initialization, so it also runs over a flash simulator.
+ */
+#include <stdint.h>
+
+/* Number of sectors kept in RAM. Each takes one flash sector of RAM. */
+#ifndef FLASH_CACHE_LINES
+#define FLASH_CACHE_LINES	4
+#endif
+
+/* Bytes of flash compared at a time when checking whether to erase. */
+#ifndef FLASH_CACHE_CHECK_SIZE
+#define FLASH_CACHE_CHECK_SIZE	256
+#endif
+
+/* Flash device under the cache. Functions return 1 on success and 0 on
+ * failure, like flash_stream_read() and flash_stream_write(). */
+typedef struct flash_cache_dev {
+	int (*read)(void *ctx, uint32_t addr, uint32_t len, uint8_t *data);
+	int (*write)(void *ctx, uint32_t addr, uint32_t len, const uint8_t *data);
+	int (*erase_sector)(void *ctx, uint32_t addr);
+	void *ctx;		/* passed to the functions above */
+	uint32_t base;		/* flash address of sector 0 */
+	uint32_t sector_size;	/* bytes in a sector, which is also the erase unit */
+	uint32_t sector_count;	/* sectors on the disk */
+} flash_cache_dev_t;
+
+/* Counters of the flash operations the cache made or avoided. */
+typedef struct flash_cache_stats {
+	uint32_t read_hits;	/* sectors read from RAM */
+	uint32_t read_misses;	/* sectors read from flash */
+	uint32_t write_hits;	/* sector writes absorbed by a cached sector */
+	uint32_t writebacks;	/* sectors programmed */
+	uint32_t programs;	/* calls to the write function */
+	uint32_t erases;	/* sectors erased */
+	uint32_t erases_skipped;	/* sectors programmed without an erase */
+	uint32_t unchanged;	/* sectors not programmed because flash already held the data */
+} flash_cache_stats_t;
+
+typedef struct flash_cache_line {
+	uint32_t sector;	/* FLASH_CACHE_NO_SECTOR when the line is unused */
+	uint32_t last_use;	/* value of the use counter when last accessed */
+	uint8_t dirty;		/* 1 if the sector has to be programmed */
+	uint8_t *data;
+} flash_cache_line_t;
+
+typedef struct flash_cache {
+	const flash_cache_dev_t *dev;
+	flash_cache_line_t line[FLASH_CACHE_LINES];
+	uint32_t use_counter;
+	flash_cache_stats_t stats;
+} flash_cache_t;
+
+#define FLASH_CACHE_NO_SECTOR	0xFFFFFFFFUL
+
+/*
+ * Initialize a cache. buffer holds FLASH_CACHE_LINES sectors of
+ * dev->sector_size bytes, and dev must stay valid while the cache is used.
+ * Returns 0 on success, -1 on invalid parameters.
+ */
+int flash_cache_init(flash_cache_t *cache, const flash_cache_dev_t *dev, uint8_t *buffer);
+
+/*
+ * Read count sectors starting at sector. Cached sectors are copied from RAM,
+ * the others are read from flash without being cached.
+ * Returns 0 on success, -1 on error.
+ */
+int flash_cache_read(flash_cache_t *cache, uint8_t *buff, uint32_t sector, uint32_t count);
+
+/*
+ * Write count sectors starting at sector. A single sector is cached and
+ * programmed later; several sectors are programmed at once, in one write.
+ * Returns 0 on success, -1 on error.
+ */
+int flash_cache_write(flash_cache_t *cache, const uint8_t *buff, uint32_t sector, uint32_t count);
+
+/*
+ * Program all dirty sectors. Returns 0 on success, -1 on error, in which case
+ * the sectors that failed stay dirty.
+ */
+int flash_cache_sync(flash_cache_t *cache);
+
+#endif
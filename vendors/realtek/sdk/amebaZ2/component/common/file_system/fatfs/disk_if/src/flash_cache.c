@@ -0,0 +1,272 @@
+/*
+ *  Write-back sector cache between FatFs and NOR flash
+ *
+ *  A sector is programmed over its current contents without an erase when
+ *  the new data only clears bits, in which case only the bytes that changed
+ *  are programmed, and is not programmed at all when the contents do not
+ *  change. Lines are assigned so that sequential sectors land in adjacent
+ *  lines, which lets a run of dirty sectors be programmed with one write
+ *  from the cache buffer.
+ */
+#include <string.h>
+#include <disk_if/inc/flash_cache.h>
+
+/* Result of comparing new sector contents with flash. */
+#define FLASH_CACHE_SAME	0	/* nothing to program */
+#define FLASH_CACHE_PROGRAM	1	/* program without erasing */
+#define FLASH_CACHE_ERASE	2	/* erase, then program */
+
+static uint32_t flash_cache_addr(flash_cache_t *cache, uint32_t sector)
+{
+	return cache->dev->base + sector * cache->dev->sector_size;
+}
+
+static void flash_cache_touch(flash_cache_t *cache, flash_cache_line_t *line)
+{
+	line->last_use = ++cache->use_counter;
+}
+
+static int flash_cache_find(flash_cache_t *cache, uint32_t sector)
+{
+	int i;
+
+	for(i = 0; i < FLASH_CACHE_LINES; i++){
+		if(cache->line[i].sector == sector)
+			return i;
+	}
+	return -1;
+}
+
+/* Compare data with a sector in flash. Returns one of the FLASH_CACHE_SAME,
+ * FLASH_CACHE_PROGRAM, FLASH_CACHE_ERASE values, or -1 on read error. For
+ * FLASH_CACHE_PROGRAM, the bytes that differ are in [*first, *end). */
+static int flash_cache_check(flash_cache_t *cache, uint32_t sector, const uint8_t *data,
+		uint32_t *first, uint32_t *end)
+{
+	const flash_cache_dev_t *dev = cache->dev;
+	uint8_t current[FLASH_CACHE_CHECK_SIZE];
+	uint32_t offset, len, i;
+	int result = FLASH_CACHE_SAME;
+
+	for(offset = 0; offset < dev->sector_size; offset += len){
+		len = dev->sector_size - offset;
+		if(len > sizeof(current))
+			len = sizeof(current);
+
+		if(!dev->read(dev->ctx, flash_cache_addr(cache, sector) + offset, len, current))
+			return -1;
+
+		for(i = 0; i < len; i++){
+			if(current[i] == data[offset + i])
+				continue;
+			/* Programming can only clear bits. */
+			if((current[i] & data[offset + i]) != data[offset + i])
+				return FLASH_CACHE_ERASE;
+			if(result == FLASH_CACHE_SAME)
+				*first = offset + i;
+			*end = offset + i + 1;
+			result = FLASH_CACHE_PROGRAM;
+		}
+	}
+	return result;
+}
+
+/* Program the sectors [first, first + count) of a run from data. */
+static int flash_cache_write_run(flash_cache_t *cache, uint32_t first, uint32_t count, const uint8_t *data)
+{
+	const flash_cache_dev_t *dev = cache->dev;
+
+	if(!dev->write(dev->ctx, flash_cache_addr(cache, first), count * dev->sector_size, data))
+		return -1;
+	cache->stats.programs++;
+	cache->stats.writebacks += count;
+	return 0;
+}
+
+/* Program count adjacent sectors from data. Erased sectors are programmed
+ * in runs, with one write per run; a sector that does not need an erase
+ * only has the bytes that changed programmed. */
+static int flash_cache_program(flash_cache_t *cache, uint32_t sector, uint32_t count, const uint8_t *data)
+{
+	const flash_cache_dev_t *dev = cache->dev;
+	const uint8_t *sector_data;
+	uint32_t i, run_start = 0, run_len = 0, first = 0, end = 0;
+	int check;
+
+	for(i = 0; i < count; i++){
+		sector_data = data + i * dev->sector_size;
+		check = flash_cache_check(cache, sector + i, sector_data, &first, &end);
+		if(check < 0)
+			return -1;
+
+		if(check == FLASH_CACHE_ERASE){
+			if(!dev->erase_sector(dev->ctx, flash_cache_addr(cache, sector + i)))
+				return -1;
+			cache->stats.erases++;
+			if(run_len == 0)
+				run_start = i;
+			run_len++;
+			continue;
+		}
+
+		if(run_len > 0){
+			if(flash_cache_write_run(cache, sector + run_start, run_len, data + run_start * dev->sector_size) != 0)
+				return -1;
+			run_len = 0;
+		}
+
+		if(check == FLASH_CACHE_PROGRAM){
+			if(!dev->write(dev->ctx, flash_cache_addr(cache, sector + i) + first, end - first, sector_data + first))
+				return -1;
+			cache->stats.programs++;
+			cache->stats.writebacks++;
+			cache->stats.erases_skipped++;
+		}else{
+			cache->stats.unchanged++;
+		}
+	}
+
+	if(run_len > 0)
+		return flash_cache_write_run(cache, sector + run_start, run_len, data + run_start * dev->sector_size);
+	return 0;
+}
+
+/* Program the dirty line index together with the dirty lines next to it that
+ * hold the sectors next to its sector. */
+static int flash_cache_flush_run(flash_cache_t *cache, int index)
+{
+	int first = index, last = index, i;
+
+	while(first > 0 && cache->line[first - 1].dirty &&
+			cache->line[first - 1].sector + 1 == cache->line[first].sector)
+		first--;
+	while(last + 1 < FLASH_CACHE_LINES && cache->line[last + 1].dirty &&
+			cache->line[last].sector + 1 == cache->line[last + 1].sector)
+		last++;
+
+	if(flash_cache_program(cache, cache->line[first].sector, last - first + 1, cache->line[first].data) != 0)
+		return -1;
+
+	for(i = first; i <= last; i++)
+		cache->line[i].dirty = 0;
+	return 0;
+}
+
+/* Choose the line to hold sector. */
+static int flash_cache_victim(flash_cache_t *cache, uint32_t sector)
+{
+	int prev, i, victim = 0;
+
+	/* Keep sequential sectors in adjacent lines. */
+	if(sector > 0){
+		prev = flash_cache_find(cache, sector - 1);
+		if(prev >= 0 && prev + 1 < FLASH_CACHE_LINES && !cache->line[prev + 1].dirty)
+			return prev + 1;
+	}
+
+	/* Otherwise an unused line, or the least recently used one. */
+	for(i = 0; i < FLASH_CACHE_LINES; i++){
+		if(cache->line[i].sector == FLASH_CACHE_NO_SECTOR)
+			return i;
+		if(cache->line[i].last_use < cache->line[victim].last_use)
+			victim = i;
+	}
+	return victim;
+}
+
+int flash_cache_init(flash_cache_t *cache, const flash_cache_dev_t *dev, uint8_t *buffer)
+{
+	int i;
+
+	if(cache == NULL || dev == NULL || buffer == NULL || dev->sector_size == 0)
+		return -1;
+
+	memset(cache, 0, sizeof(flash_cache_t));
+	cache->dev = dev;
+	for(i = 0; i < FLASH_CACHE_LINES; i++){
+		cache->line[i].sector = FLASH_CACHE_NO_SECTOR;
+		cache->line[i].data = buffer + i * dev->sector_size;
+	}
+	return 0;
+}
+
+int flash_cache_read(flash_cache_t *cache, uint8_t *buff, uint32_t sector, uint32_t count)
+{
+	const flash_cache_dev_t *dev = cache->dev;
+	uint32_t i = 0, run;
+	int index;
+
+	if(sector >= dev->sector_count || count > dev->sector_count - sector)
+		return -1;
+
+	while(i < count){
+		index = flash_cache_find(cache, sector + i);
+		if(index >= 0){
+			memcpy(buff + i * dev->sector_size, cache->line[index].data, dev->sector_size);
+			flash_cache_touch(cache, &cache->line[index]);
+			cache->stats.read_hits++;
+			i++;
+			continue;
+		}
+
+		/* Read the sectors up to the next cached one at once. */
+		for(run = 1; i + run < count && flash_cache_find(cache, sector + i + run) < 0; run++);
+
+		if(!dev->read(dev->ctx, flash_cache_addr(cache, sector + i), run * dev->sector_size,
+				buff + i * dev->sector_size))
+			return -1;
+		cache->stats.read_misses += run;
+		i += run;
+	}
+	return 0;
+}
+
+int flash_cache_write(flash_cache_t *cache, const uint8_t *buff, uint32_t sector, uint32_t count)
+{
+	const flash_cache_dev_t *dev = cache->dev;
+	flash_cache_line_t *line;
+	uint32_t i;
+	int index;
+
+	if(sector >= dev->sector_count || count > dev->sector_count - sector)
+		return -1;
+
+	if(count > 1){
+		/* Cached copies of the sectors are overwritten by this write. */
+		for(i = 0; i < count; i++){
+			index = flash_cache_find(cache, sector + i);
+			if(index >= 0){
+				cache->line[index].sector = FLASH_CACHE_NO_SECTOR;
+				cache->line[index].dirty = 0;
+			}
+		}
+		return flash_cache_program(cache, sector, count, buff);
+	}
+
+	index = flash_cache_find(cache, sector);
+	if(index >= 0){
+		cache->stats.write_hits++;
+	}else{
+		index = flash_cache_victim(cache, sector);
+		if(cache->line[index].dirty && flash_cache_flush_run(cache, index) != 0)
+			return -1;
+		cache->line[index].sector = sector;
+	}
+
+	line = &cache->line[index];
+	memcpy(line->data, buff, dev->sector_size);
+	line->dirty = 1;
+	flash_cache_touch(cache, line);
+	return 0;
+}
+
+int flash_cache_sync(flash_cache_t *cache)
+{
+	int i, ret = 0;
+
+	for(i = 0; i < FLASH_CACHE_LINES; i++){
+		if(cache->line[i].dirty && flash_cache_flush_run(cache, i) != 0)
+			ret = -1;
+	}
+	return ret;
+}
@@ -10,6 +10,7 @@
 #include "stdint.h"
 #include "stdio.h"
 #include <disk_if/inc/flash_fatfs.h>
+#include <disk_if/inc/flash_cache.h>
 #include "device_lock.h"
 #include "platform_opts.h"
 #if defined(CONFIG_PLATFORM_8195BHP)
@@ -36,6 +37,43 @@
 
 flash_t		flash;
 
+static int flash_fatfs_read(void *ctx, uint32_t addr, uint32_t len, uint8_t *data){
+	char retry_cnt = 0;
+	int ret;
+	do{
+		ret = flash_stream_read((flash_t *)ctx, addr, len, data);
+	}while(!ret && ++retry_cnt < 3);
+	return ret;
+}
+
+static int flash_fatfs_write(void *ctx, uint32_t addr, uint32_t len, const uint8_t *data){
+	char retry_cnt = 0;
+	int ret;
+	do{
+		ret = flash_stream_write((flash_t *)ctx, addr, len, (uint8_t *) data);
+	}while(!ret && ++retry_cnt < 3);
+	return ret;
+}
+
+static int flash_fatfs_erase_sector(void *ctx, uint32_t addr){
+	flash_erase_sector((flash_t *)ctx, addr);
+	return 1;
+}
+
+static const flash_cache_dev_t flash_cache_dev = {
+	.read = flash_fatfs_read,
+	.write = flash_fatfs_write,
+	.erase_sector = flash_fatfs_erase_sector,
+	.ctx = &flash,
+	.base = FLASH_APP_BASE,
+	.sector_size = SECTOR_SIZE_FLASH,
+	.sector_count = FLASH_SECTOR_COUNT
+};
+
+/* FatFs sectors written since the last CTRL_SYNC, see flash_cache.h */
+static flash_cache_t flash_cache;
+static uint8_t flash_cache_buf[FLASH_CACHE_LINES * SECTOR_SIZE_FLASH];
+
 DRESULT interpret_flash_result(int out){
 	DRESULT res;
 	if(out)
@@ -58,25 +96,27 @@ DSTATUS FLASH_disk_initialize(void){
 	flash_init(&flash);
 #endif
 	res = RES_OK;
+	device_mutex_lock(RT_DEV_LOCK_FLASH);
+	/* Keep the sectors cached by an earlier mount */
+	if(flash_cache.dev == NULL)
+		res = interpret_flash_result(flash_cache_init(&flash_cache, &flash_cache_dev, flash_cache_buf) == 0);
+	device_mutex_unlock(RT_DEV_LOCK_FLASH);
 	return res;
 }
 
 DSTATUS FLASH_disk_deinitialize(void){
 	DRESULT res;
-	res = RES_OK;
+	device_mutex_lock(RT_DEV_LOCK_FLASH);
+	res = interpret_flash_result(flash_cache_sync(&flash_cache) == 0);
+	device_mutex_unlock(RT_DEV_LOCK_FLASH);
 	return res;
 }
 
 /* Read sector(s) --------------------------------------------*/
 DRESULT FLASH_disk_read(BYTE *buff, DWORD sector, UINT count){			
 	DRESULT res;
-	char retry_cnt = 0, i = 0;  
 	device_mutex_lock(RT_DEV_LOCK_FLASH);
-	do{
-		res = interpret_flash_result(flash_stream_read(&flash, FLASH_APP_BASE + sector*SECTOR_SIZE_FLASH, count*SECTOR_SIZE_FLASH, (uint8_t *) buff));
-		if(++retry_cnt>=3)
-			break;
-	}while(res != RES_OK);
+	res = interpret_flash_result(flash_cache_read(&flash_cache, (uint8_t *) buff, sector, count) == 0);
 	device_mutex_unlock(RT_DEV_LOCK_FLASH);
 	return res;
 }
@@ -85,22 +125,10 @@ DRESULT FLASH_disk_read(BYTE *buff, DWORD sector, UINT count){
 #if _USE_WRITE == 1	
 DRESULT FLASH_disk_write(BYTE const *buff, DWORD sector, UINT count){		
 	DRESULT res;
-	char retry_cnt = 0, i = 0;
-
+	/* Cached until CTRL_SYNC, or programmed at once for several sectors */
 	device_mutex_lock(RT_DEV_LOCK_FLASH);
-	do{
-		for(i=0;i<count;i++){			
-			uint32_t erase_addr = FLASH_APP_BASE + (sector + i)*SECTOR_SIZE_FLASH;
-
-			flash_erase_sector(&flash, erase_addr);
-			res = interpret_flash_result(flash_stream_write(&flash, FLASH_APP_BASE + (sector + i)*SECTOR_SIZE_FLASH, count*SECTOR_SIZE_FLASH, (uint8_t *) buff));		// Replace with Flash API
-		}
-		if(++retry_cnt>=3)
-			break;
-		
-	}while(res != RES_OK);
+	res = interpret_flash_result(flash_cache_write(&flash_cache, (const uint8_t *) buff, sector, count) == 0);
 	device_mutex_unlock(RT_DEV_LOCK_FLASH);
-
 	return res;
 }
 #endif
@@ -117,7 +145,9 @@ DRESULT FLASH_disk_ioctl (BYTE cmd, void* buff){
 		
 		/* Make sure that no pending write process in the physical drive */
 		case CTRL_SYNC:		/* Flush disk cache (for write functions) */
-			res = RES_OK;
+			device_mutex_lock(RT_DEV_LOCK_FLASH);
+			res = interpret_flash_result(flash_cache_sync(&flash_cache) == 0);
+			device_mutex_unlock(RT_DEV_LOCK_FLASH);
 			break;
 		case GET_SECTOR_COUNT:	/* Get media size (for only f_mkfs()) */
 			*(DWORD*)buff = FLASH_SECTOR_COUNT;
@@ -43,6 +43,7 @@
 
 #define FTL_USE_MAPPING_TABLE			1
 #define FTL_ONLY_GC_IN_IDLE				0
+#define FTL_IDLE_GC_BUDGET				8	// entries of the oldest page compacted per idle call
 #define FTL_APP_LOGICAL_ADDR_BASE		0
 
 
@@ -107,6 +108,14 @@ bool do_gc_in_idle = FALSE;
 uint8_t idle_gc_page_thres = 1;
 uint16_t idle_gc_cell_thres = PAGE_element / 2;
 
+// incremental compaction of the oldest page, see ftl_page_compact_step()
+#define FTL_COMPACT_NONE         0xFF
+uint8_t  g_compact_pageID = FTL_COMPACT_NONE;
+uint16_t g_compact_key_index;
+
+// number of entries of each page the mapping table points to
+uint16_t *ftl_page_live_count = NULL;
+
 extern uint32_t ftl_write(uint16_t logical_addr, uint32_t w_data);
 extern bool ftl_page_erase(struct Page_T *p);
 void ftl_mapping_table_init(void);
@@ -552,6 +561,12 @@ L_retry:
         return RecycleNum;
     }
 
+    // an incremental compaction was on this page, it is done
+    if (g_compact_pageID == Recycle_page)
+    {
+        g_compact_pageID = FTL_COMPACT_NONE;
+    }
+
 
     FTL_PRINTF(FTL_LEVEL_INFO, "[ftl] ftl_page_garbage_collect_Imp: Recycle_page:%d, RecycleNum:%d, retry_count:%d",
                       Recycle_page, RecycleNum, retry_count);
@@ -611,6 +626,164 @@ uint8_t ftl_page_garbage_collect(uint32_t page_thresh, uint32_t cell_thresh)
     return result;
 }
 
+// number of live entries in a page, or the most a page holds without mapping table
+uint16_t ftl_page_live_entries(uint8_t pageID)
+{
+    if ((FTL_USE_MAPPING_TABLE == 1) && (ftl_page_live_count != NULL))
+    {
+        return ftl_page_live_count[pageID];
+    }
+
+    return PAGE_element_data;
+}
+
+// Compact the oldest page by at most budget entries, from the newest one: live
+// entries are copied to the current page and the others dropped, as
+// ftl_page_garbage_collect_Imp() does. The page is erased by the call after
+// the one that copied its last entry, or at once if it has no live entry, so
+// a call never does both. Return 1 when a page was freed.
+// Called with ftl_sem held and g_doingGarbageCollection set.
+uint8_t ftl_page_compact_step(uint16_t budget)
+{
+    uint8_t result = 0;
+
+    if (g_compact_pageID == FTL_COMPACT_NONE)
+    {
+        if ((g_PAGE_num - g_free_page_count) < 2)
+        {
+            // only the current page is used
+            return 0;
+        }
+
+        g_compact_pageID = ftl_page_get_oldest();
+
+        if (ftl_get_page_end_position(g_pPage + g_compact_pageID, &g_compact_key_index))
+        {
+            g_compact_key_index = PAGE_element - 1;
+        }
+    }
+
+    if (ftl_page_live_entries(g_compact_pageID) == 0)
+    {
+        // nothing to copy
+        g_compact_key_index = INFO_size;
+    }
+
+    if (g_compact_key_index < 3)
+    {
+        if (ftl_page_erase(g_pPage + g_compact_pageID))
+        {
+            if (ftl_page_live_count != NULL)
+            {
+                ftl_page_live_count[g_compact_pageID] = 0;
+            }
+
+            FTL_PRINTF(FTL_LEVEL_INFO, "[ftl] ftl_page_compact_step: page %d free\n", g_compact_pageID);
+
+            g_compact_pageID = FTL_COMPACT_NONE;
+            result = 1;
+        }
+
+        g_free_page_count = ftl_get_free_page_count();
+        return result;
+    }
+
+    for (; (budget > 0) && (g_compact_key_index >= 3); --budget)
+    {
+        uint32_t key = ftl_page_read(g_pPage + g_compact_pageID, g_compact_key_index);
+
+        if (ftl_key_get_length(key) == 1)
+        {
+            uint16_t addr = key & 0xffff;
+
+            if (!ftl_page_can_addr_drop(addr, g_compact_pageID))
+            {
+                if ((g_free_page_count == 0) && ((g_free_cell_index + 1) >= PAGE_element))
+                {
+                    // no room left to copy to, the next page is this one
+                    break;
+                }
+
+                uint32_t rdata = ftl_page_read(g_pPage + g_compact_pageID, g_compact_key_index - 1);
+
+                if (ftl_write(addr, rdata) != FTL_WRITE_SUCCESS)
+                {
+                    break;
+                }
+            }
+        }
+
+        g_compact_key_index -= 2;
+    }
+
+    return result;
+}
+
+uint8_t ftl_page_compact(uint32_t page_thresh, uint16_t budget, uint32_t wait)
+{
+    uint8_t result = 0;
+
+    if (NULL != ftl_sem)
+    {
+        if (xSemaphoreTakeRecursive(ftl_sem, wait) != pdTRUE)
+        {
+            return 0;
+        }
+    }
+
+    if (g_doingGarbageCollection == 0)
+    {
+        g_doingGarbageCollection = 1;
+
+        if ((g_compact_pageID != FTL_COMPACT_NONE) || (g_free_page_count <= page_thresh))
+        {
+            result = ftl_page_compact_step(budget);
+        }
+
+        g_doingGarbageCollection = 0;
+    }
+
+    if (NULL != ftl_sem)
+    {
+        xSemaphoreGiveRecursive(ftl_sem);
+    }
+
+    return result;
+}
+
+// With gc in idle, writers leave garbage to the idle task. The live entries of
+// the oldest page must still fit in the current page when it has to be
+// recycled, so finish its compaction here once they would no longer fit after
+// a write of length cells. Called from ftl_write() with ftl_sem held.
+void ftl_page_compact_reserve(uint8_t length)
+{
+    if (g_free_page_count == 0)
+    {
+        uint8_t oldest = g_compact_pageID;
+
+        if (oldest == FTL_COMPACT_NONE)
+        {
+            // no free page, so the next one is the oldest
+            oldest = (g_cur_pageID + 1) % g_PAGE_num;
+        }
+
+        if ((g_free_cell_index + length + 1 + 2 * ftl_page_live_entries(oldest)) > PAGE_element)
+        {
+            FTL_PRINTF(FTL_LEVEL_INFO, "[ftl] ftl_page_compact_reserve: finish page %d\n", oldest);
+
+            g_doingGarbageCollection = 1;
+
+            // copy the remaining entries, then erase
+            if (ftl_page_compact_step(PAGE_element) == 0)
+            {
+                ftl_page_compact_step(PAGE_element);
+            }
+
+            g_doingGarbageCollection = 0;
+        }
+    }
+}
+
 void ftl_garbage_collect_in_idle(void)
 {
     if (g_pPage == NULL)
@@ -619,12 +792,12 @@ void ftl_garbage_collect_in_idle(void)
     }
     if (do_gc_in_idle)
     {
-        if (g_free_page_count <= idle_gc_page_thres)
+        // a compaction in progress goes on whatever the thresholds
+        if ((g_compact_pageID != FTL_COMPACT_NONE) ||
+            ((g_free_page_count <= idle_gc_page_thres) && (g_free_cell_index <= idle_gc_cell_thres)))
         {
-            if (g_free_cell_index <= idle_gc_cell_thres)
-            {
-                ftl_page_garbage_collect(idle_gc_page_thres, idle_gc_cell_thres);
-            }
+            // the idle task must not block, try again next time if ftl is busy
+            ftl_page_compact(idle_gc_page_thres, FTL_IDLE_GC_BUDGET, 0);
         }
     }
 }
@@ -827,6 +1000,17 @@ void write_mapping_table(uint16_t logical_addr, uint8_t pageID, uint16_t cell_in
     uint32_t byte_offset = bit_index % 8;
     uint32_t phy_addr_offset = (pageID * PAGE_element + cell_index) / 2;//8 bytes aligned
 
+    if (ftl_page_live_count != NULL)
+    {
+        uint16_t old_phy_addr = read_mapping_table(logical_addr);
+
+        if ((old_phy_addr != 0) && (ftl_page_live_count[old_phy_addr / PAGE_element] > 0))
+        {
+            --ftl_page_live_count[old_phy_addr / PAGE_element];
+        }
+        ++ftl_page_live_count[pageID];
+    }
+
     if (4 == byte_offset)
     {
         uint8_t phy_addr_offset_l = phy_addr_offset & 0x0f;
@@ -1156,6 +1340,11 @@ uint32_t ftl_write(uint16_t logical_addr, uint32_t w_data)
 
 L_retry:
 
+        if (do_gc_in_idle && !g_doingGarbageCollection)
+        {
+            ftl_page_compact_reserve(length);
+        }
+
         if ((g_free_cell_index + length) < PAGE_element)
         {
             FTL_ASSERT(WRITABLE_32BIT == ftl_page_read(g_pPage + g_cur_pageID, g_free_cell_index));
@@ -1218,7 +1407,7 @@ L_retry:
                     {
                         ret = FTL_WRITE_ERROR_NEED_GC;
                     }
-                    else
+                    else if (!do_gc_in_idle)
                     {
                         ftl_page_garbage_collect(0, PAGE_element / 2);
                     }
@@ -1298,6 +1487,11 @@ uint32_t ftl_ioctl(uint32_t cmd, uint32_t p1, uint32_t p2)
 
             //clear ftl_mapping_table
             memset(ftl_mapping_table, 0, MAPPING_TABLE_SIZE);
+            if (ftl_page_live_count != NULL)
+            {
+                memset(ftl_page_live_count, 0, g_PAGE_num * sizeof(uint16_t));
+            }
+            g_compact_pageID = FTL_COMPACT_NONE;
 
             // updata current page info
             g_cur_pageID = 0;
@@ -1486,6 +1680,7 @@ uint32_t ftl_init(uint32_t u32PageStartAddr, uint8_t pagenum)
 
     g_cur_pageID = cur_pageID;
     g_free_cell_index = free_cell_index;
+    g_compact_pageID = FTL_COMPACT_NONE;
 
 #if defined(WIN32) && (WIN32 == 1)
 #if defined(EXTRA_DEBUG) && (EXTRA_DEBUG == 1)
@@ -1537,6 +1732,16 @@ void ftl_mapping_table_init(void)
         //                                  MAPPING_TABLE_SIZE);//table is initialised as 0
 
 		ftl_mapping_table = rtw_zmalloc(MAPPING_TABLE_SIZE);
+		ftl_page_live_count = (uint16_t *)rtw_zmalloc(g_PAGE_num * sizeof(uint16_t));
+    }
+    else
+    {
+        // init again, drop what the table knew
+        memset(ftl_mapping_table, 0, MAPPING_TABLE_SIZE);
+        if (ftl_page_live_count != NULL)
+        {
+            memset(ftl_page_live_count, 0, g_PAGE_num * sizeof(uint16_t));
+        }
     }
 
     uint8_t pageID = g_cur_pageID;
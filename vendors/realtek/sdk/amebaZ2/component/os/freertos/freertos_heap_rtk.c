@@ -84,6 +84,14 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+#ifndef configUSE_TLSF_HEAP
+	#define configUSE_TLSF_HEAP 0
+#endif
+
+/* freertos_heap_tlsf.c provides the heap instead when configUSE_TLSF_HEAP is
+1. */
+#if( configUSE_TLSF_HEAP == 0 )
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -547,4 +555,6 @@ void *pvPortCalloc(size_t xWantedCnt, size_t xWantedSize)
 	}
 	return p;
 }
-#endif
\ No newline at end of file
+#endif
+
+#endif /* configUSE_TLSF_HEAP */
@@ -0,0 +1,830 @@
+/*
+ * FreeRTOS Kernel V10.2.0
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of pvPortMalloc() with the same interface as
+ * freertos_heap_rtk.c - the heap is defined across multiple non-contiguous
+ * regions with vPortDefineHeapRegions(), and adjacent free blocks are merged -
+ * that takes and releases memory in constant time, using two-level segregated
+ * fit (TLSF).
+ *
+ * Free blocks are kept in lists by size class.  The first level splits sizes
+ * by power of two, and the second level splits each power of two into
+ * heapSL_INDEX_COUNT ranges.  A bitmap of non-empty lists at each level gives
+ * the smallest class with a block large enough with two find-first-set
+ * operations, so pvPortMalloc() never walks a list, and blocks are served
+ * from the class above the request so that any block of the list fits.  Every
+ * block knows the block in front of it in memory, so vPortFree() merges with
+ * both neighbours without searching either.  The scheduler is suspended for a
+ * bounded time whatever the state of the heap.
+ *
+ * pvPortReAlloc() grows a block into the free block behind it, and shrinks a
+ * block by splitting off its end, before falling back to allocate, copy and
+ * free.
+ *
+ * Select this file instead of freertos_heap_rtk.c by setting
+ * configUSE_TLSF_HEAP to 1 in FreeRTOSConfig.h.  Usage is otherwise the same:
+ * vPortDefineHeapRegions() ***must*** be called before pvPortMalloc(), with the
+ * regions in address order and terminated by a NULL zero sized region.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#ifndef configUSE_TLSF_HEAP
+	#define configUSE_TLSF_HEAP 0
+#endif
+
+#if( configUSE_TLSF_HEAP == 1 )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* Largest block is ( 1 << configTLSF_HEAP_MAX_BLOCK_LOG2 ) - 1 bytes.  Larger
+regions are cut down to it.  Each step up costs heapSL_INDEX_COUNT list
+pointers of RAM. */
+#ifndef configTLSF_HEAP_MAX_BLOCK_LOG2
+	#define configTLSF_HEAP_MAX_BLOCK_LOG2	24
+#endif
+
+/* Number of second level lists per power of two, as a power of two.  Blocks
+served from a list are at most 1 / heapSL_INDEX_COUNT larger than needed. */
+#define heapSL_INDEX_COUNT_LOG2		4
+#define heapSL_INDEX_COUNT			( 1UL << heapSL_INDEX_COUNT_LOG2 )
+
+#if( portBYTE_ALIGNMENT == 32 )
+	#define heapALIGNMENT_LOG2		5
+#elif( portBYTE_ALIGNMENT == 16 )
+	#define heapALIGNMENT_LOG2		4
+#elif( portBYTE_ALIGNMENT == 8 )
+	#define heapALIGNMENT_LOG2		3
+#elif( portBYTE_ALIGNMENT == 4 )
+	#define heapALIGNMENT_LOG2		2
+#else
+	#error portBYTE_ALIGNMENT must be 4, 8, 16 or 32 to use this heap
+#endif
+
+/* Blocks below heapSMALL_BLOCK_SIZE all go in the first level list 0, in
+second level lists of portBYTE_ALIGNMENT bytes each. */
+#define heapFL_INDEX_SHIFT			( heapSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapSMALL_BLOCK_SIZE		( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapFL_INDEX_COUNT			( configTLSF_HEAP_MAX_BLOCK_LOG2 - heapFL_INDEX_SHIFT + 1 )
+#define heapMAXIMUM_BLOCK_SIZE		( ( ( size_t ) 1 << configTLSF_HEAP_MAX_BLOCK_LOG2 ) - portBYTE_ALIGNMENT )
+
+/* Set in xBlockSize of a free block.  Sizes are multiples of
+portBYTE_ALIGNMENT, so the bit is otherwise always clear. */
+#define heapBLOCK_FREE_BIT			( ( size_t ) 1 )
+
+#define heapBLOCK_SIZE( pxBlock )	( ( pxBlock )->xBlockSize & ~heapBLOCK_FREE_BIT )
+#define heapBLOCK_IS_FREE( pxBlock )	( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+#define heapNEXT_BLOCK( pxBlock )	( ( TlsfBlock_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+#if defined( __GNUC__ )
+	#define heapCLZ( x )			( ( uint32_t ) __builtin_clz( x ) )
+#elif defined( __ICCARM__ )
+	#include <intrinsics.h>
+	#define heapCLZ( x )			( ( uint32_t ) __CLZ( x ) )
+#endif
+
+/* Header of every block.  Only the first two members are kept for allocated
+blocks, the free list links are in the memory given to the application. */
+typedef struct A_TLSF_BLOCK
+{
+	struct A_TLSF_BLOCK *pxPrevPhysBlock;	/*<< The block just below in memory, or NULL for the first block of a region. */
+	size_t xBlockSize;						/*<< Size of the block including its header, with heapBLOCK_FREE_BIT set when free. */
+	struct A_TLSF_BLOCK *pxNextFreeBlock;	/*<< The next block in the same free list. */
+	struct A_TLSF_BLOCK *pxPrevFreeBlock;	/*<< The previous block in the same free list. */
+} TlsfBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Index of the most and least significant bit set in a non zero value.
+ */
+static uint32_t prvFls( uint32_t ulValue );
+static uint32_t prvFfs( uint32_t ulValue );
+
+/*
+ * Find the free list a block of xBlockSize bytes belongs to.
+ */
+static void prvMappingInsert( size_t xBlockSize, uint32_t *pulFl, uint32_t *pulSl );
+
+/*
+ * Find the first free list whose blocks are all at least xBlockSize bytes,
+ * and take a block from it.  Returns NULL if there is none.
+ */
+static TlsfBlock_t *prvTakeSuitableBlock( size_t xBlockSize );
+
+/*
+ * Add a block to, or remove a block from, the free list of its size.
+ */
+static void prvInsertFreeBlock( TlsfBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TlsfBlock_t *pxBlock );
+
+/*
+ * Mark a block free, merge it with the free blocks on either side and insert
+ * the result in the free lists.
+ */
+static void prvReleaseBlock( TlsfBlock_t *pxBlock );
+
+/*
+ * Cut a block down to xBlockSize bytes if the rest is large enough to make a
+ * block, and release the rest.
+ */
+static void prvTrimBlock( TlsfBlock_t *pxBlock, size_t xBlockSize );
+
+/*
+ * Size of the block needed for xWantedSize bytes of application data, or 0
+ * if it is too large.
+ */
+static size_t prvBlockSizeFor( size_t xWantedSize );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the header kept at the beginning of each allocated block, and
+the smallest block, which must hold the free list links. */
+static const size_t xHeapStructSize	= ( offsetof( TlsfBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+static const size_t xMinimumBlockSize = ( sizeof( TlsfBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Bitmap of the first level indexes that have a non-empty second level list,
+the bitmaps of non-empty second level lists, and the lists. */
+static uint32_t ulFlBitmap = 0;
+static uint32_t ulSlBitmap[ heapFL_INDEX_COUNT ];
+static TlsfBlock_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+
+/* Set once vPortDefineHeapRegions() has run. */
+static BaseType_t xHeapDefined = pdFALSE;
+
+/* Keeps track of the number of free bytes remaining and of free blocks. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfFreeBlocks = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+/*-----------------------------------------------------------*/
+
+#if defined( heapCLZ )
+
+	static uint32_t prvFls( uint32_t ulValue )
+	{
+		return 31UL - heapCLZ( ulValue );
+	}
+
+	static uint32_t prvFfs( uint32_t ulValue )
+	{
+		return 31UL - heapCLZ( ulValue & ( ~ulValue + 1UL ) );
+	}
+
+#else
+
+	static uint32_t prvFls( uint32_t ulValue )
+	{
+	uint32_t ulBit = 0;
+
+		while( ( ulValue >>= 1 ) != 0 )
+		{
+			ulBit++;
+		}
+
+		return ulBit;
+	}
+
+	static uint32_t prvFfs( uint32_t ulValue )
+	{
+		return prvFls( ulValue & ( ~ulValue + 1UL ) );
+	}
+
+#endif /* heapCLZ */
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xBlockSize, uint32_t *pulFl, uint32_t *pulSl )
+{
+uint32_t ulBit;
+
+	if( xBlockSize < heapSMALL_BLOCK_SIZE )
+	{
+		*pulFl = 0;
+		*pulSl = ( uint32_t ) ( xBlockSize >> heapALIGNMENT_LOG2 );
+	}
+	else
+	{
+		ulBit = prvFls( ( uint32_t ) xBlockSize );
+		*pulSl = ( uint32_t ) ( xBlockSize >> ( ulBit - heapSL_INDEX_COUNT_LOG2 ) ) - heapSL_INDEX_COUNT;
+		*pulFl = ulBit - heapFL_INDEX_SHIFT + 1UL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TlsfBlock_t *prvTakeSuitableBlock( size_t xBlockSize )
+{
+TlsfBlock_t *pxBlock = NULL;
+uint32_t ulFl, ulSl, ulSlMap, ulFlMap;
+
+	/* Round up to the next list boundary, so that every block of the list
+	found is large enough. */
+	if( xBlockSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xBlockSize += ( ( size_t ) 1 << ( prvFls( ( uint32_t ) xBlockSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+
+	if( xBlockSize <= heapMAXIMUM_BLOCK_SIZE )
+	{
+		prvMappingInsert( xBlockSize, &ulFl, &ulSl );
+
+		/* First a list of the same power of two, then the smallest one of a
+		higher power of two. */
+		ulSlMap = ulSlBitmap[ ulFl ] & ( ~0UL << ulSl );
+
+		if( ulSlMap == 0 )
+		{
+			ulFlMap = ( ulFl + 1UL < 32UL ) ? ( ulFlBitmap & ( ~0UL << ( ulFl + 1UL ) ) ) : 0;
+
+			if( ulFlMap != 0 )
+			{
+				ulFl = prvFfs( ulFlMap );
+				ulSlMap = ulSlBitmap[ ulFl ];
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ulSlMap != 0 )
+		{
+			ulSl = prvFfs( ulSlMap );
+			pxBlock = pxFreeLists[ ulFl ][ ulSl ];
+			prvRemoveFreeBlock( pxBlock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TlsfBlock_t *pxBlock )
+{
+uint32_t ulFl, ulSl;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &ulFl, &ulSl );
+
+	pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+	pxBlock->pxPrevFreeBlock = NULL;
+	pxBlock->pxNextFreeBlock = pxFreeLists[ ulFl ][ ulSl ];
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ ulFl ][ ulSl ] = pxBlock;
+	ulFlBitmap |= 1UL << ulFl;
+	ulSlBitmap[ ulFl ] |= 1UL << ulSl;
+
+	xNumberOfFreeBlocks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TlsfBlock_t *pxBlock )
+{
+uint32_t ulFl, ulSl;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &ulFl, &ulSl );
+
+	if( pxBlock->pxPrevFreeBlock != NULL )
+	{
+		pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		/* First of its list. */
+		pxFreeLists[ ulFl ][ ulSl ] = pxBlock->pxNextFreeBlock;
+
+		if( pxBlock->pxNextFreeBlock == NULL )
+		{
+			ulSlBitmap[ ulFl ] &= ~( 1UL << ulSl );
+
+			if( ulSlBitmap[ ulFl ] == 0 )
+			{
+				ulFlBitmap &= ~( 1UL << ulFl );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+
+	xNumberOfFreeBlocks--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseBlock( TlsfBlock_t *pxBlock )
+{
+TlsfBlock_t *pxNeighbour;
+
+	/* Merge with the block behind.  The end marker of a region is never
+	free. */
+	pxNeighbour = heapNEXT_BLOCK( pxBlock );
+
+	if( heapBLOCK_IS_FREE( pxNeighbour ) )
+	{
+		prvRemoveFreeBlock( pxNeighbour );
+		pxBlock->xBlockSize += pxNeighbour->xBlockSize;
+		heapNEXT_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Merge with the block in front. */
+	pxNeighbour = pxBlock->pxPrevPhysBlock;
+
+	if( ( pxNeighbour != NULL ) && heapBLOCK_IS_FREE( pxNeighbour ) )
+	{
+		prvRemoveFreeBlock( pxNeighbour );
+		pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+		pxBlock = pxNeighbour;
+		heapNEXT_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvInsertFreeBlock( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTrimBlock( TlsfBlock_t *pxBlock, size_t xBlockSize )
+{
+TlsfBlock_t *pxRemainder;
+
+	if( ( heapBLOCK_SIZE( pxBlock ) - xBlockSize ) >= xMinimumBlockSize )
+	{
+		pxRemainder = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+		pxRemainder->xBlockSize = heapBLOCK_SIZE( pxBlock ) - xBlockSize;
+		pxRemainder->pxPrevPhysBlock = pxBlock;
+		heapNEXT_BLOCK( pxRemainder )->pxPrevPhysBlock = pxRemainder;
+		pxBlock->xBlockSize = xBlockSize;
+
+		xFreeBytesRemaining += pxRemainder->xBlockSize;
+		prvReleaseBlock( pxRemainder );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBlockSizeFor( size_t xWantedSize )
+{
+size_t xBlockSize = 0;
+
+	if( ( xWantedSize > 0 ) && ( xWantedSize <= ( heapMAXIMUM_BLOCK_SIZE - xHeapStructSize ) ) )
+	{
+		/* The wanted size is increased so it can contain the header, and
+		rounded up so that blocks stay aligned. */
+		xBlockSize = ( xWantedSize + xHeapStructSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		if( xBlockSize < xMinimumBlockSize )
+		{
+			xBlockSize = xMinimumBlockSize;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TlsfBlock_t *pxBlock = NULL;
+void *pvReturn = NULL;
+size_t xBlockSize;
+
+	/* The heap must be initialised before the first call to
+	prvPortMalloc(). */
+	configASSERT( xHeapDefined );
+
+	xBlockSize = prvBlockSizeFor( xWantedSize );
+
+	vTaskSuspendAll();
+	{
+		if( ( xBlockSize > 0 ) && ( xBlockSize <= xFreeBytesRemaining ) )
+		{
+			pxBlock = prvTakeSuitableBlock( xBlockSize );
+
+			if( pxBlock != NULL )
+			{
+				xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock );
+
+				/* If the block is larger than required, the end goes back to
+				the free lists. */
+				prvTrimBlock( pxBlock, xBlockSize );
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xNumberOfSuccessfulAllocations++;
+
+				/* Return the memory space pointed to - jumping over the
+				header at its start. */
+				pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+TlsfBlock_t *pxBlock;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a header immediately before it.
+		The void cast is used to prevent byte alignment warnings from the
+		compiler. */
+		pxBlock = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+
+		/* Check the block is actually allocated. */
+		configASSERT( !heapBLOCK_IS_FREE( pxBlock ) );
+		configASSERT( heapBLOCK_SIZE( pxBlock ) >= xMinimumBlockSize );
+
+		if( !heapBLOCK_IS_FREE( pxBlock ) )
+		{
+			vTaskSuspendAll();
+			{
+				/* Add this block to the list of free blocks. */
+				xFreeBytesRemaining += heapBLOCK_SIZE( pxBlock );
+				xNumberOfSuccessfulFrees++;
+				traceFREE( pv, heapBLOCK_SIZE( pxBlock ) );
+				prvReleaseBlock( pxBlock );
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TlsfBlock_t *pxBlock;
+size_t xMaxSize = 0, xMinSize = 0;
+uint32_t ulFl, ulSl;
+
+	vTaskSuspendAll();
+	{
+		/* The largest free block is in the highest non-empty list, and the
+		smallest in the lowest one.  Only those two lists are walked. */
+		if( ulFlBitmap != 0 )
+		{
+			ulFl = prvFls( ulFlBitmap );
+			ulSl = prvFls( ulSlBitmap[ ulFl ] );
+
+			for( pxBlock = pxFreeLists[ ulFl ][ ulSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				if( heapBLOCK_SIZE( pxBlock ) > xMaxSize )
+				{
+					xMaxSize = heapBLOCK_SIZE( pxBlock );
+				}
+			}
+
+			ulFl = prvFfs( ulFlBitmap );
+			ulSl = prvFfs( ulSlBitmap[ ulFl ] );
+			xMinSize = heapBLOCK_SIZE( pxFreeLists[ ulFl ][ ulSl ] );
+
+			for( pxBlock = pxFreeLists[ ulFl ][ ulSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				if( heapBLOCK_SIZE( pxBlock ) < xMinSize )
+				{
+					xMinSize = heapBLOCK_SIZE( pxBlock );
+				}
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+		pxHeapStats->xNumberOfFreeBlocks = xNumberOfFreeBlocks;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+TlsfBlock_t *pxFirstBlock, *pxEndMarker;
+size_t xAddress, xEndAddress;
+size_t xTotalHeapSize = 0;
+BaseType_t xDefinedRegions = 0;
+const HeapRegion_t *pxHeapRegion;
+size_t xPreviousEnd = 0;
+
+	/* Can only call once! */
+	configASSERT( xHeapDefined == pdFALSE );
+
+	pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+	while( pxHeapRegion->xSizeInBytes > 0 )
+	{
+		/* Ensure the heap region starts and ends on a correctly aligned
+		boundary. */
+		xAddress = ( size_t ) pxHeapRegion->pucStartAddress;
+		xEndAddress = xAddress + pxHeapRegion->xSizeInBytes;
+		xAddress = ( xAddress + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xEndAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		/* Check blocks are passed in with increasing start addresses. */
+		configASSERT( xAddress >= xPreviousEnd );
+		xPreviousEnd = xEndAddress;
+
+		/* The end marker is an allocated block of just a header, so that the
+		last block of the region is never merged past the region. */
+		if( ( xEndAddress > xAddress ) && ( ( xEndAddress - xAddress ) >= ( xMinimumBlockSize + xHeapStructSize ) ) )
+		{
+			pxFirstBlock = ( TlsfBlock_t * ) xAddress;
+			pxFirstBlock->pxPrevPhysBlock = NULL;
+			pxFirstBlock->xBlockSize = xEndAddress - xAddress - xHeapStructSize;
+
+			/* Larger regions are cut down to the largest block. */
+			configASSERT( pxFirstBlock->xBlockSize <= heapMAXIMUM_BLOCK_SIZE );
+			if( pxFirstBlock->xBlockSize > heapMAXIMUM_BLOCK_SIZE )
+			{
+				pxFirstBlock->xBlockSize = heapMAXIMUM_BLOCK_SIZE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxEndMarker = heapNEXT_BLOCK( pxFirstBlock );
+			pxEndMarker->pxPrevPhysBlock = pxFirstBlock;
+			pxEndMarker->xBlockSize = 0;
+
+			xTotalHeapSize += pxFirstBlock->xBlockSize;
+			prvInsertFreeBlock( pxFirstBlock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Move onto the next HeapRegion_t structure. */
+		xDefinedRegions++;
+		pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+	}
+
+	xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+	xFreeBytesRemaining = xTotalHeapSize;
+
+	/* Check something was actually defined before it is accessed. */
+	configASSERT( xTotalHeapSize );
+
+	xHeapDefined = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void* pvPortReAlloc( void *pv,  size_t xWantedSize )
+{
+TlsfBlock_t *pxBlock, *pxNext;
+void *pvReturn = NULL;
+size_t xBlockSize, xOldSize;
+
+	if( pv == NULL )
+	{
+		pvReturn = pvPortMalloc( xWantedSize );
+	}
+	else if( xWantedSize == 0 )
+	{
+		vPortFree( pv );
+	}
+	else
+	{
+		pxBlock = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+		configASSERT( !heapBLOCK_IS_FREE( pxBlock ) );
+
+		xBlockSize = prvBlockSizeFor( xWantedSize );
+		xOldSize = heapBLOCK_SIZE( pxBlock );
+
+		vTaskSuspendAll();
+		{
+			if( xBlockSize == 0 )
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+			else if( xBlockSize <= xOldSize )
+			{
+				/* Shrink in place, giving the end back. */
+				prvTrimBlock( pxBlock, xBlockSize );
+				pvReturn = pv;
+			}
+			else
+			{
+				/* Grow in place if the block behind is free and large
+				enough. */
+				pxNext = heapNEXT_BLOCK( pxBlock );
+
+				if( heapBLOCK_IS_FREE( pxNext ) && ( ( xOldSize + heapBLOCK_SIZE( pxNext ) ) >= xBlockSize ) )
+				{
+					prvRemoveFreeBlock( pxNext );
+					xFreeBytesRemaining -= pxNext->xBlockSize;
+					pxBlock->xBlockSize += pxNext->xBlockSize;
+					heapNEXT_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+					prvTrimBlock( pxBlock, xBlockSize );
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					pvReturn = pv;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		if( ( pvReturn == NULL ) && ( xBlockSize != 0 ) )
+		{
+			/* Move the data to a new block.  The old one is kept if that
+			fails. */
+			pvReturn = pvPortMalloc( xWantedSize );
+
+			if( pvReturn != NULL )
+			{
+				memcpy( pvReturn, pv, xOldSize - xHeapStructSize );
+				vPortFree( pv );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortCalloc( size_t xWantedCnt, size_t xWantedSize )
+{
+void *p = NULL;
+
+	/* allocate 'xWantedCnt' objects of size 'xWantedSize' */
+	if( ( xWantedSize == 0 ) || ( xWantedCnt <= ( ( size_t ) -1 / xWantedSize ) ) )
+	{
+		p = pvPortMalloc( xWantedCnt * xWantedSize );
+	}
+
+	if( p != NULL )
+	{
+		/* zero the memory */
+		memset( p, 0, xWantedCnt * xWantedSize );
+	}
+
+	return p;
+}
+
+#endif /* configUSE_TLSF_HEAP */
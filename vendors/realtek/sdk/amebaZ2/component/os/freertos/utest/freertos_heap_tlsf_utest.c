@@ -0,0 +1,508 @@
+/*
+ * FreeRTOS Kernel V10.2.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ */
+
+/**
+ * @file freertos_heap_tlsf_utest.c
+ * @brief Unit tests of the TLSF heap: block split and merge, realloc in place,
+ * alignment, exhaustion and the heap statistics.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "unity.h"
+
+#include "freertos_heap_tlsf_utest_config.h"
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "mock_task.h"
+
+/* The heap is defined once for the whole suite, as vPortDefineHeapRegions()
+ * can only be called once. Every test gives back all it allocates, which
+ * tearDown() checks. */
+
+/* The size of the memory the heap regions are carved from. */
+#define TEST_HEAP_SIZE             ( 8192 )
+
+/* The first region, the largest. */
+#define TEST_REGION1_OFFSET        ( 0 )
+#define TEST_REGION1_SIZE          ( 4096 )
+
+/* The second region, smaller, so that allocations are served from it first.
+ * It starts TEST_REGION2_MISALIGNMENT bytes past an aligned address. */
+#define TEST_REGION2_OFFSET        ( 4160 )
+#define TEST_REGION2_SIZE          ( 1024 )
+#define TEST_REGION2_MISALIGNMENT  ( 3 )
+
+/* The header the heap keeps in front of an allocated block: the block in front
+ * of it in memory and its size. Mirrors xHeapStructSize. */
+#define TEST_HEADER_SIZE           ( ( sizeof( void * ) + sizeof( size_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The smallest block, which holds the header and the free list links. Mirrors
+ * xMinimumBlockSize. */
+#define TEST_MINIMUM_BLOCK_SIZE    ( ( ( 3 * sizeof( void * ) ) + sizeof( size_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The free block each region starts as. The end of a region holds a header
+ * that marks it, and the second region loses the bytes up to the next aligned
+ * address. */
+#define TEST_REGION1_BLOCK_SIZE    ( TEST_REGION1_SIZE - TEST_HEADER_SIZE )
+#define TEST_REGION2_BLOCK_SIZE    ( TEST_REGION2_SIZE - portBYTE_ALIGNMENT - TEST_HEADER_SIZE )
+#define TEST_TOTAL_FREE_SIZE       ( TEST_REGION1_BLOCK_SIZE + TEST_REGION2_BLOCK_SIZE )
+
+/* The number of free blocks of the heap when nothing is allocated. */
+#define TEST_REGIONS               ( 2 )
+
+/* The most allocations a test makes. */
+#define TEST_MAX_ALLOCATIONS       ( 128 )
+
+/* The heap is not part of the stock portable.h. */
+void * pvPortReAlloc( void * pv,
+                      size_t xWantedSize );
+void * pvPortCalloc( size_t xWantedCnt,
+                     size_t xWantedSize );
+
+/* The memory the heap regions are carved from, aligned to portBYTE_ALIGNMENT. */
+static uint64_t _heap[ TEST_HEAP_SIZE / sizeof( uint64_t ) ];
+
+/* The heap minimum ever free size right after the heap was defined. */
+static size_t _minimumEverFreeAtStart = 0;
+
+/* Depth of vTaskSuspendAll() calls not yet matched by xTaskResumeAll(). */
+static int _suspendDepth = 0;
+
+/* Number of calls of vApplicationMallocFailedHook() in the test. */
+static int _mallocFailures = 0;
+
+/* ==========================  CALLBACK FUNCTIONS =========================== */
+
+static void vTaskSuspendAll_cb( int numCalls )
+{
+    ( void ) numCalls;
+    _suspendDepth++;
+}
+
+static BaseType_t xTaskResumeAll_cb( int numCalls )
+{
+    ( void ) numCalls;
+    TEST_ASSERT_GREATER_THAN( 0, _suspendDepth );
+    _suspendDepth--;
+
+    return pdFALSE;
+}
+
+void vApplicationMallocFailedHook( void )
+{
+    _mallocFailures++;
+}
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    vTaskSuspendAll_Stub( vTaskSuspendAll_cb );
+    xTaskResumeAll_Stub( xTaskResumeAll_cb );
+    _suspendDepth = 0;
+    _mallocFailures = 0;
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+    HeapStats_t stats = { 0 };
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE( 0, _suspendDepth,
+                                   "vTaskSuspendAll and xTaskResumeAll are not balanced" );
+
+    /* Every block was freed and merged back into one free block per region. */
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( TEST_TOTAL_FREE_SIZE, stats.xAvailableHeapSpaceInBytes );
+    TEST_ASSERT_EQUAL( TEST_REGIONS, stats.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( TEST_REGION1_BLOCK_SIZE, stats.xSizeOfLargestFreeBlockInBytes );
+    TEST_ASSERT_EQUAL( TEST_REGION2_BLOCK_SIZE, stats.xSizeOfSmallestFreeBlockInBytes );
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+    uint8_t * pHeap = ( uint8_t * ) _heap;
+    const HeapRegion_t regions[] =
+    {
+        { pHeap + TEST_REGION1_OFFSET,                             TEST_REGION1_SIZE                             },
+        { pHeap + TEST_REGION2_OFFSET + TEST_REGION2_MISALIGNMENT, TEST_REGION2_SIZE - TEST_REGION2_MISALIGNMENT },
+        { NULL,                                                    0                                             }
+    };
+
+    vPortDefineHeapRegions( regions );
+    _minimumEverFreeAtStart = xPortGetMinimumEverFreeHeapSize();
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief The size of the block that holds xWantedSize bytes of application
+ * data. Mirrors prvBlockSizeFor().
+ */
+static size_t prvBlockSize( size_t xWantedSize )
+{
+    size_t xBlockSize = ( xWantedSize + TEST_HEADER_SIZE + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+    if( xBlockSize < TEST_MINIMUM_BLOCK_SIZE )
+    {
+        xBlockSize = TEST_MINIMUM_BLOCK_SIZE;
+    }
+
+    return xBlockSize;
+}
+
+/**
+ * @brief Check that a buffer holds the given byte.
+ */
+static void prvAssertFilled( const void * pBuffer,
+                             uint8_t value,
+                             size_t size )
+{
+    size_t i = 0;
+
+    for( i = 0; i < size; i++ )
+    {
+        TEST_ASSERT_EQUAL_HEX8( value, ( ( const uint8_t * ) pBuffer )[ i ] );
+    }
+}
+
+/* ========================================================================== */
+
+/**
+ * @brief Each region becomes one free block, aligned, with its end marker
+ * taken off.
+ */
+void test_DefineHeapRegions( void )
+{
+    uint8_t * pRegion2Start = ( uint8_t * ) _heap + TEST_REGION2_OFFSET + portBYTE_ALIGNMENT;
+    uint8_t * pBlock = NULL;
+
+    TEST_ASSERT_EQUAL( TEST_TOTAL_FREE_SIZE, _minimumEverFreeAtStart );
+    TEST_ASSERT_EQUAL( TEST_TOTAL_FREE_SIZE, xPortGetFreeHeapSize() );
+
+    /* The smallest region is used first; its start was aligned up. */
+    pBlock = pvPortMalloc( 1 );
+    TEST_ASSERT_EQUAL_PTR( pRegion2Start + TEST_HEADER_SIZE, pBlock );
+    vPortFree( pBlock );
+}
+
+/**
+ * @brief Every block is aligned to portBYTE_ALIGNMENT and takes the size asked
+ * for rounded up, plus the header.
+ */
+void test_Malloc_Alignment( void )
+{
+    uint8_t * pBlock = NULL;
+    size_t size = 0, freeBefore = 0;
+
+    for( size = 1; size <= ( 4 * portBYTE_ALIGNMENT ) + 1; size++ )
+    {
+        freeBefore = xPortGetFreeHeapSize();
+        pBlock = pvPortMalloc( size );
+
+        TEST_ASSERT_NOT_NULL( pBlock );
+        TEST_ASSERT_EQUAL( 0, ( ( uintptr_t ) pBlock ) & portBYTE_ALIGNMENT_MASK );
+        TEST_ASSERT_EQUAL( prvBlockSize( size ), freeBefore - xPortGetFreeHeapSize() );
+
+        /* The whole size asked for can be written. */
+        ( void ) memset( pBlock, 0xa5, size );
+        vPortFree( pBlock );
+        TEST_ASSERT_EQUAL( freeBefore, xPortGetFreeHeapSize() );
+    }
+
+    /* Nothing is allocated for 0 bytes. */
+    TEST_ASSERT_NULL( pvPortMalloc( 0 ) );
+    TEST_ASSERT_EQUAL( 1, _mallocFailures );
+}
+
+/**
+ * @brief Allocations split a free block into adjacent blocks, and freed blocks
+ * merge with the free blocks on either side.
+ */
+void test_Malloc_SplitAndMerge( void )
+{
+    uint8_t * pBlocks[ 3 ] = { NULL };
+    uint8_t * pMerged = NULL;
+    HeapStats_t stats = { 0 };
+    size_t blockSize = prvBlockSize( 40 );
+    size_t i = 0;
+
+    for( i = 0; i < 3U; i++ )
+    {
+        pBlocks[ i ] = pvPortMalloc( 40 );
+        TEST_ASSERT_NOT_NULL( pBlocks[ i ] );
+    }
+
+    /* The blocks are cut one after the other from the same free block. */
+    TEST_ASSERT_EQUAL_PTR( pBlocks[ 0 ] + blockSize, pBlocks[ 1 ] );
+    TEST_ASSERT_EQUAL_PTR( pBlocks[ 1 ] + blockSize, pBlocks[ 2 ] );
+
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( TEST_REGIONS, stats.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( TEST_REGION2_BLOCK_SIZE - ( 3 * blockSize ), stats.xSizeOfSmallestFreeBlockInBytes );
+
+    /* A block between two allocated blocks stays on its own. */
+    vPortFree( pBlocks[ 1 ] );
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( TEST_REGIONS + 1, stats.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( blockSize, stats.xSizeOfSmallestFreeBlockInBytes );
+
+    /* The block in front merges with it. */
+    vPortFree( pBlocks[ 0 ] );
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( TEST_REGIONS + 1, stats.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( 2 * blockSize, stats.xSizeOfSmallestFreeBlockInBytes );
+
+    /* The merged block serves a request for both. */
+    pMerged = pvPortMalloc( ( 2 * blockSize ) - TEST_HEADER_SIZE );
+    TEST_ASSERT_EQUAL_PTR( pBlocks[ 0 ], pMerged );
+    vPortFree( pMerged );
+
+    /* The last block merges with the blocks on both sides. */
+    vPortFree( pBlocks[ 2 ] );
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( TEST_REGIONS, stats.xNumberOfFreeBlocks );
+}
+
+/**
+ * @brief Shrinking a block gives its end back without moving it.
+ */
+void test_Realloc_ShrinkInPlace( void )
+{
+    uint8_t * pBlock = NULL;
+    uint8_t * pShrunk = NULL;
+    uint8_t * pNext = NULL;
+    size_t freeBefore = 0;
+
+    pBlock = pvPortMalloc( 400 );
+    TEST_ASSERT_NOT_NULL( pBlock );
+    ( void ) memset( pBlock, 0x5a, 400 );
+    freeBefore = xPortGetFreeHeapSize();
+
+    pShrunk = pvPortReAlloc( pBlock, 100 );
+    TEST_ASSERT_EQUAL_PTR( pBlock, pShrunk );
+    TEST_ASSERT_EQUAL( freeBefore + prvBlockSize( 400 ) - prvBlockSize( 100 ), xPortGetFreeHeapSize() );
+    prvAssertFilled( pShrunk, 0x5a, 100 );
+
+    /* The end given back is allocated next. */
+    pNext = pvPortMalloc( 100 );
+    TEST_ASSERT_EQUAL_PTR( pShrunk + prvBlockSize( 100 ), pNext );
+
+    /* Shrinking by less than a block keeps the block as it is. */
+    freeBefore = xPortGetFreeHeapSize();
+    TEST_ASSERT_EQUAL_PTR( pShrunk, pvPortReAlloc( pShrunk, 100 - portBYTE_ALIGNMENT ) );
+    TEST_ASSERT_EQUAL( freeBefore, xPortGetFreeHeapSize() );
+
+    vPortFree( pNext );
+    vPortFree( pShrunk );
+}
+
+/**
+ * @brief Growing a block takes the free block behind it without moving it, and
+ * moves the data only when the block behind is allocated.
+ */
+void test_Realloc_Grow( void )
+{
+    uint8_t * pBlock = NULL;
+    uint8_t * pNext = NULL;
+    uint8_t * pGrown = NULL;
+    size_t freeBefore = 0;
+
+    /* The block behind is free: grow in place. */
+    pBlock = pvPortMalloc( 100 );
+    pNext = pvPortMalloc( 100 );
+    TEST_ASSERT_NOT_NULL( pBlock );
+    TEST_ASSERT_EQUAL_PTR( pBlock + prvBlockSize( 100 ), pNext );
+    vPortFree( pNext );
+
+    ( void ) memset( pBlock, 0x3c, 100 );
+    freeBefore = xPortGetFreeHeapSize();
+
+    pGrown = pvPortReAlloc( pBlock, 300 );
+    TEST_ASSERT_EQUAL_PTR( pBlock, pGrown );
+    TEST_ASSERT_EQUAL( freeBefore - ( prvBlockSize( 300 ) - prvBlockSize( 100 ) ), xPortGetFreeHeapSize() );
+    TEST_ASSERT_TRUE( xPortGetMinimumEverFreeHeapSize() <= xPortGetFreeHeapSize() );
+    prvAssertFilled( pGrown, 0x3c, 100 );
+    vPortFree( pGrown );
+
+    /* The block behind is allocated: move. */
+    pBlock = pvPortMalloc( 100 );
+    pNext = pvPortMalloc( 100 );
+    TEST_ASSERT_EQUAL_PTR( pBlock + prvBlockSize( 100 ), pNext );
+    ( void ) memset( pBlock, 0x3c, 100 );
+    ( void ) memset( pNext, 0xc3, 100 );
+
+    pGrown = pvPortReAlloc( pBlock, 300 );
+    TEST_ASSERT_NOT_NULL( pGrown );
+    TEST_ASSERT_NOT_EQUAL( pBlock, pGrown );
+    prvAssertFilled( pGrown, 0x3c, 100 );
+    prvAssertFilled( pNext, 0xc3, 100 );
+
+    /* The old block was freed. */
+    TEST_ASSERT_EQUAL_PTR( pBlock, pvPortMalloc( 100 ) );
+
+    vPortFree( pBlock );
+    vPortFree( pNext );
+    vPortFree( pGrown );
+}
+
+/**
+ * @brief realloc of NULL allocates, realloc to 0 frees, and a failed realloc
+ * keeps the block.
+ */
+void test_Realloc_EdgeCases( void )
+{
+    uint8_t * pBlock = NULL;
+    HeapStats_t before = { 0 }, after = { 0 };
+
+    pBlock = pvPortReAlloc( NULL, 50 );
+    TEST_ASSERT_NOT_NULL( pBlock );
+    ( void ) memset( pBlock, 0x77, 50 );
+
+    /* There is no block this large; the data stays where it is. */
+    TEST_ASSERT_NULL( pvPortReAlloc( pBlock, TEST_HEAP_SIZE ) );
+    TEST_ASSERT_EQUAL( 1, _mallocFailures );
+    prvAssertFilled( pBlock, 0x77, 50 );
+
+    vPortGetHeapStats( &before );
+    TEST_ASSERT_NULL( pvPortReAlloc( pBlock, 0 ) );
+    vPortGetHeapStats( &after );
+    TEST_ASSERT_EQUAL( before.xNumberOfSuccessfulFrees + 1, after.xNumberOfSuccessfulFrees );
+}
+
+/**
+ * @brief calloc clears the memory, and fails without allocating when the size
+ * overflows.
+ */
+void test_Calloc( void )
+{
+    uint8_t * pBlock = NULL;
+
+    pBlock = pvPortMalloc( 100 );
+    TEST_ASSERT_NOT_NULL( pBlock );
+    ( void ) memset( pBlock, 0xff, 100 );
+    vPortFree( pBlock );
+
+    /* The same memory is allocated again, cleared. */
+    TEST_ASSERT_EQUAL_PTR( pBlock, pvPortCalloc( 4, 25 ) );
+    prvAssertFilled( pBlock, 0x00, 100 );
+    vPortFree( pBlock );
+
+    TEST_ASSERT_NULL( pvPortCalloc( SIZE_MAX / 2, 4 ) );
+    TEST_ASSERT_EQUAL( 0, _mallocFailures );
+}
+
+/**
+ * @brief Blocks are allocated until the heap is exhausted, then allocation
+ * fails and calls the malloc failed hook.
+ */
+void test_Malloc_Exhaustion( void )
+{
+    void * pBlocks[ TEST_MAX_ALLOCATIONS ] = { NULL };
+    HeapStats_t stats = { 0 };
+    size_t count = 0, i = 0;
+
+    for( count = 0; count < TEST_MAX_ALLOCATIONS; count++ )
+    {
+        pBlocks[ count ] = pvPortMalloc( 64 );
+
+        if( pBlocks[ count ] == NULL )
+        {
+            break;
+        }
+    }
+
+    TEST_ASSERT_TRUE( count < TEST_MAX_ALLOCATIONS );
+    TEST_ASSERT_TRUE( count >= ( TEST_TOTAL_FREE_SIZE / prvBlockSize( 64 ) ) - TEST_REGIONS );
+    TEST_ASSERT_EQUAL( 1, _mallocFailures );
+
+    /* What is left is too small for another block. */
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_TRUE( stats.xSizeOfLargestFreeBlockInBytes < prvBlockSize( 64 ) );
+    TEST_ASSERT_EQUAL( TEST_TOTAL_FREE_SIZE - ( count * prvBlockSize( 64 ) ), stats.xAvailableHeapSpaceInBytes );
+    TEST_ASSERT_TRUE( stats.xMinimumEverFreeBytesRemaining <= stats.xAvailableHeapSpaceInBytes );
+
+    /* Larger than the whole heap. */
+    TEST_ASSERT_NULL( pvPortMalloc( TEST_HEAP_SIZE ) );
+    TEST_ASSERT_NULL( pvPortMalloc( SIZE_MAX ) );
+    TEST_ASSERT_EQUAL( 3, _mallocFailures );
+
+    for( i = 0; i < count; i++ )
+    {
+        vPortFree( pBlocks[ i ] );
+    }
+}
+
+/**
+ * @brief The heap statistics follow allocations and frees.
+ */
+void test_HeapStats( void )
+{
+    uint8_t * pSmall = NULL;
+    uint8_t * pLarge = NULL;
+    HeapStats_t before = { 0 }, stats = { 0 };
+
+    vPortGetHeapStats( &before );
+    TEST_ASSERT_EQUAL( TEST_TOTAL_FREE_SIZE, before.xAvailableHeapSpaceInBytes );
+    TEST_ASSERT_EQUAL( TEST_REGIONS, before.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( TEST_REGION1_BLOCK_SIZE, before.xSizeOfLargestFreeBlockInBytes );
+    TEST_ASSERT_EQUAL( TEST_REGION2_BLOCK_SIZE, before.xSizeOfSmallestFreeBlockInBytes );
+
+    pSmall = pvPortMalloc( 100 );
+    pLarge = pvPortMalloc( 200 );
+    TEST_ASSERT_NOT_NULL( pSmall );
+    TEST_ASSERT_NOT_NULL( pLarge );
+    vPortFree( pSmall );
+
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( before.xAvailableHeapSpaceInBytes - prvBlockSize( 200 ), stats.xAvailableHeapSpaceInBytes );
+    TEST_ASSERT_EQUAL( TEST_REGIONS + 1, stats.xNumberOfFreeBlocks );
+    TEST_ASSERT_EQUAL( TEST_REGION1_BLOCK_SIZE, stats.xSizeOfLargestFreeBlockInBytes );
+    TEST_ASSERT_EQUAL( prvBlockSize( 100 ), stats.xSizeOfSmallestFreeBlockInBytes );
+    TEST_ASSERT_EQUAL( before.xNumberOfSuccessfulAllocations + 2, stats.xNumberOfSuccessfulAllocations );
+    TEST_ASSERT_EQUAL( before.xNumberOfSuccessfulFrees + 1, stats.xNumberOfSuccessfulFrees );
+    TEST_ASSERT_TRUE( stats.xMinimumEverFreeBytesRemaining <= ( before.xAvailableHeapSpaceInBytes - prvBlockSize( 100 ) - prvBlockSize( 200 ) ) );
+    TEST_ASSERT_EQUAL( stats.xMinimumEverFreeBytesRemaining, xPortGetMinimumEverFreeHeapSize() );
+    TEST_ASSERT_EQUAL( stats.xAvailableHeapSpaceInBytes, xPortGetFreeHeapSize() );
+
+    /* Failed allocations are not counted. */
+    TEST_ASSERT_NULL( pvPortMalloc( TEST_HEAP_SIZE ) );
+    vPortFree( pLarge );
+
+    vPortGetHeapStats( &stats );
+    TEST_ASSERT_EQUAL( before.xNumberOfSuccessfulAllocations + 2, stats.xNumberOfSuccessfulAllocations );
+    TEST_ASSERT_EQUAL( before.xNumberOfSuccessfulFrees + 2, stats.xNumberOfSuccessfulFrees );
+}
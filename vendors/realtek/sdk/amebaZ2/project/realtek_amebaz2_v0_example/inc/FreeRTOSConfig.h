@@ -80,6 +80,7 @@ extern uint32_t SystemCoreClock;
 #define configMAX_TASK_NAME_LEN					( 10 )
 #define configTOTAL_HEAP_SIZE						( ( size_t ) ( 160 * 1024 ) )
 #define configAPPLICATION_ALLOCATED_HEAP			0
+#define configUSE_TLSF_HEAP						0 // 1: freertos_heap_tlsf.c instead of freertos_heap_rtk.c
 
 /* Constants that build features in or out. */
 #define configUSE_MUTEXES							1